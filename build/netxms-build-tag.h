@@ -0,0 +1 @@
+../_gate_build/build/netxms-build-tag.h
\ No newline at end of file
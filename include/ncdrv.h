@@ -29,7 +29,7 @@
 /**
  * API version
  */
-#define NCDRV_API_VERSION           2
+#define NCDRV_API_VERSION           3
 
 /**
  * Notification channel configuration template
@@ -62,6 +62,15 @@ class NCDriverStorageManager
    virtual void clear(const TCHAR *key) = 0;
 };
 
+/**
+ * Notification message (used for batch sending)
+ */
+struct NCMessage
+{
+   const TCHAR *subject;
+   const TCHAR *body;
+};
+
 /**
  * Notification Channel Driver base class
  */
@@ -74,6 +83,26 @@ class NCDriver
    virtual ~NCDriver() { }
 
    virtual bool send(const TCHAR *recipient, const TCHAR *subject, const TCHAR *body) = 0;
+
+   /**
+    * Should return true if driver can aggregate multiple messages for same recipient in one delivery.
+    * If true, server will collect messages within batch window and pass them to sendBatch().
+    */
+   virtual bool isBatchSendSupported() const { return false; }
+
+   /**
+    * Send multiple messages to same recipient. Default implementation sends messages one by one.
+    */
+   virtual bool sendBatch(const TCHAR *recipient, const NCMessage *messages, int count)
+   {
+      bool success = true;
+      for(int i = 0; i < count; i++)
+      {
+         if (!send(recipient, messages[i].subject, messages[i].body))
+            success = false;
+      }
+      return success;
+   }
 };
 
 /**
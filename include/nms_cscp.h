@@ -179,9 +179,14 @@ typedef struct
    uint32_t dciId;
    uint32_t numRows;
    uint32_t dataType;
-   uint32_t padding;
+   uint32_t flags;
 } DCI_DATA_HEADER;
 
+/**
+ * DCI data header flags
+ */
+#define DCI_DATA_MORE_CHUNKS  0x0001
+
 /**
  * DCI data row structure
  */
@@ -679,6 +684,11 @@ typedef struct
 #define CMD_WEB_SERVICE_CUSTOM_REQUEST    0x01B8
 #define CMD_MERGE_FILES                   0x01B9
 #define CMD_FILEMGR_MERGE_FILES           0x01BA
+#define CMD_PROFILE_LIBRARY_SCRIPT        0x01BB
+#define CMD_GET_PERF_STATS                0x01BC
+#define CMD_SUBSCRIBE_LAST_VALUES         0x01BD
+#define CMD_UNSUBSCRIBE_LAST_VALUES       0x01BE
+#define CMD_LAST_VALUES_UPDATE            0x01BF
 
 #define CMD_RS_LIST_REPORTS               0x1100
 #define CMD_RS_GET_REPORT_DEFINITION      0x1101
@@ -1458,6 +1468,12 @@ typedef struct
 #define VID_WEB_SWC_ERROR_TEXT      ((uint32_t)765)
 #define VID_REQUEST_DATA            ((uint32_t)766)
 #define VID_ENABLE_FILE_UPLOAD_RESUMING ((uint32_t)767)
+#define VID_SAMPLING_INTERVAL       ((uint32_t)768)
+#define VID_INSTRUCTION_COUNT       ((uint32_t)769)
+#define VID_PROFILE_BY_INSTRUCTION  ((uint32_t)770)
+#define VID_DOWNSAMPLING_METHOD     ((uint32_t)771)
+#define VID_TARGET_POINT_COUNT      ((uint32_t)772)
+#define VID_ENABLE_CHUNKED_DATA     ((uint32_t)773)
 
 // Base variabe for single threshold in message
 #define VID_THRESHOLD_BASE          ((UINT32)0x00800000)
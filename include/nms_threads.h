@@ -1447,6 +1447,11 @@ class StringList;
  */
 struct ThreadPool;
 
+/**
+ * Latency histogram
+ */
+class LatencyHistogram;
+
 /**
  * Thread pool information
  */
@@ -1483,6 +1488,8 @@ void LIBNETXMS_EXPORTABLE ThreadPoolScheduleAbsoluteMs(ThreadPool *p, int64_t ru
 void LIBNETXMS_EXPORTABLE ThreadPoolScheduleRelative(ThreadPool *p, uint32_t delay, ThreadPoolWorkerFunction f, void *arg);
 void LIBNETXMS_EXPORTABLE ThreadPoolGetInfo(ThreadPool *p, ThreadPoolInfo *info);
 bool LIBNETXMS_EXPORTABLE ThreadPoolGetInfo(const TCHAR *name, ThreadPoolInfo *info);
+void LIBNETXMS_EXPORTABLE ThreadPoolGetLatencyHistograms(ThreadPool *p, LatencyHistogram *waitTime, LatencyHistogram *executionTime);
+bool LIBNETXMS_EXPORTABLE ThreadPoolGetLatencyHistograms(const TCHAR *name, LatencyHistogram *waitTime, LatencyHistogram *executionTime);
 int LIBNETXMS_EXPORTABLE ThreadPoolGetSerializedRequestCount(ThreadPool *p, const TCHAR *key);
 uint32_t LIBNETXMS_EXPORTABLE ThreadPoolGetSerializedRequestMaxWaitTime(ThreadPool *p, const TCHAR *key);
 StringList LIBNETXMS_EXPORTABLE *ThreadPoolGetAllPools();
@@ -673,6 +673,24 @@ template <class T> class ObjectMemoryPool
       }
    }
 
+   /**
+    * Drop all allocated elements except one region (object destructors will not be called)
+    */
+   void clear()
+   {
+      void *r = *((void **)m_currentRegion);
+      while(r != nullptr)
+      {
+         void *n = *((void **)r);
+         MemFree(r);
+         r = n;
+      }
+      *((void **)m_currentRegion) = nullptr;
+      m_firstDeleted = nullptr;
+      m_allocated = m_headerSize;
+      m_elements = 0;
+   }
+
    /**
     * Get region capacity
     */
@@ -781,6 +799,16 @@ template<typename T> class SynchronizedObjectMemoryPool : public ObjectMemoryPoo
          free(p);
       }
    }
+
+   /**
+    * Drop all allocated elements except one region (object destructors will not be called)
+    */
+   void clear()
+   {
+      lock();
+      ObjectMemoryPool<T>::clear();
+      unlock();
+   }
 };
 
 /**
@@ -2636,6 +2664,48 @@ template <class K, class V> class SynchronizedSharedHashMap final
 template <class K, class V> shared_ptr<V> SynchronizedSharedHashMap<K, V>::m_null = shared_ptr<V>();
 
 
+/**
+ * Latency histogram layout: values below 2^LATENCY_HISTOGRAM_LINEAR_BITS are counted exactly,
+ * larger values are counted in 2^LATENCY_HISTOGRAM_SUB_BUCKET_BITS sub-buckets per power of 2
+ * (relative error below 12.5%). Values above 2^LATENCY_HISTOGRAM_MAX_BITS go to last bucket.
+ */
+#define LATENCY_HISTOGRAM_LINEAR_BITS     4
+#define LATENCY_HISTOGRAM_SUB_BUCKET_BITS 3
+#define LATENCY_HISTOGRAM_MAX_BITS        32
+#define LATENCY_HISTOGRAM_BUCKETS         ((1 << LATENCY_HISTOGRAM_LINEAR_BITS) + (LATENCY_HISTOGRAM_MAX_BITS - LATENCY_HISTOGRAM_LINEAR_BITS) * (1 << LATENCY_HISTOGRAM_SUB_BUCKET_BITS))
+
+/**
+ * Lock-free log-linear latency histogram (HDR style). Values are usually in microseconds.
+ * Updates are atomic and can be done concurrently from multiple threads; readers should
+ * work on a copy (copy constructor takes snapshot of current counters).
+ */
+class LIBNETXMS_EXPORTABLE LatencyHistogram
+{
+private:
+   VolatileCounter m_buckets[LATENCY_HISTOGRAM_BUCKETS];
+   VolatileCounter64 m_count;
+   VolatileCounter m_max;
+
+public:
+   LatencyHistogram() { reset(); }
+   LatencyHistogram(const LatencyHistogram& src);
+
+   LatencyHistogram& operator=(const LatencyHistogram& src);
+
+   void update(uint64_t value);
+   void merge(const LatencyHistogram& src);
+   void reset();
+
+   uint64_t getCount() const { return static_cast<uint64_t>(m_count); }
+   uint32_t getMax() const { return static_cast<uint32_t>(m_max); }
+   uint64_t getPercentile(double percentile) const;
+   double getMean() const;
+
+   static int bucketIndex(uint64_t value);
+   static uint64_t bucketLowerBound(int index);
+   static uint64_t bucketUpperBound(int index);
+};
+
 /**
  * Ring buffer
  */
@@ -2856,6 +2926,7 @@ class LIBNETXMS_EXPORTABLE Table
    void createFromMessage(const NXCPMessage *msg);
    void destroy();
    bool parseXML(const char *xml);
+   bool decodeBinary(const BYTE *data, size_t size);
 
 public:
    Table();
@@ -2953,6 +3024,9 @@ class LIBNETXMS_EXPORTABLE Table
 
    static Table *createFromPackedXML(const char *packedXml);
    char *createPackedXML() const;
+
+   static Table *createFromPackedData(const char *packedData);
+   char *createPackedBinary() const;
 };
 
 #ifdef _WIN32
@@ -3379,6 +3453,47 @@ class LIBNETXMS_EXPORTABLE InetAddressList
    static InetAddressList *resolveHostName(const char *hostname);
 };
 
+/**
+ * Node of IP address prefix tree
+ */
+struct InetAddressPrefixTreeNode;
+
+/**
+ * Callback for IP address prefix tree enumeration
+ */
+typedef void (*InetAddressPrefixTreeCallback)(const InetAddress& prefix, void *value, void *context);
+
+/**
+ * Path compressed radix tree of IP address prefixes (subnets) with longest prefix match lookup.
+ * IPv4 and IPv6 prefixes are kept in separate trees. NULL values cannot be stored. This class is
+ * not thread safe.
+ */
+class LIBNETXMS_EXPORTABLE InetAddressPrefixTree
+{
+   DISABLE_COPY_CTOR(InetAddressPrefixTree)
+
+private:
+   InetAddressPrefixTreeNode *m_rootV4;
+   InetAddressPrefixTreeNode *m_rootV6;
+   size_t m_size;
+
+   InetAddressPrefixTreeNode **getRoot(const InetAddress& addr, BYTE *key, int *maxBits) const;
+
+public:
+   InetAddressPrefixTree();
+   ~InetAddressPrefixTree();
+
+   void *put(const InetAddress& prefix, void *value);
+   void *remove(const InetAddress& prefix);
+   void *get(const InetAddress& prefix) const;
+   void *findLongestMatch(const InetAddress& addr) const;
+   void findOverlapping(const InetAddress& prefix, InetAddressPrefixTreeCallback callback, void *context) const;
+   void forEach(InetAddressPrefixTreeCallback callback, void *context) const;
+   void clear();
+
+   size_t size() const { return m_size; }
+};
+
 /**
  * Network connection
  */
@@ -3876,6 +3991,7 @@ void LIBNETXMS_EXPORTABLE QSort(void *base, size_t nmemb, size_t size, int (*com
 #endif
 
 int64_t LIBNETXMS_EXPORTABLE GetCurrentTimeMs();
+uint64_t LIBNETXMS_EXPORTABLE GetMonotonicClockTimeNs();
 
 UINT64 LIBNETXMS_EXPORTABLE FileSizeW(const WCHAR *pszFileName);
 UINT64 LIBNETXMS_EXPORTABLE FileSizeA(const char *pszFileName);
@@ -1022,6 +1022,18 @@ enum AggregationFunction
    DCI_AGG_SUM = 4
 };
 
+/**
+ * Downsampling methods for historical DCI data requests
+ */
+enum DownsamplingMethod
+{
+   DCI_DOWNSAMPLING_NONE = 0,
+   DCI_DOWNSAMPLING_MIN = 1,
+   DCI_DOWNSAMPLING_MAX = 2,
+   DCI_DOWNSAMPLING_AVG = 3,
+   DCI_DOWNSAMPLING_LTTB = 4
+};
+
 /**
  * Threshold operations
  */
@@ -81,6 +81,15 @@ typedef db_result_t * DB_RESULT;
 struct db_unbuffered_result_t;
 typedef db_unbuffered_result_t * DB_UNBUFFERED_RESULT;
 
+struct db_bulk_load_t;
+typedef db_bulk_load_t * DB_BULK_LOAD;
+
+/**
+ * Number of buckets in connection pool acquire latency histogram
+ * (<1ms, <10ms, <100ms, <1s, <10s, >=10s)
+ */
+#define DBCP_ACQUIRE_HISTOGRAM_SIZE    6
+
 /**
  * Pool connection information
  */
@@ -94,6 +103,8 @@ struct PoolConnectionInfo
    uint32_t usageCount;
    char srcFile[128];
    int srcLine;
+   uint32_t acquireTime;   // Time (in milliseconds) spent waiting for this connection by current owner
+   uint64_t acquireHistogram[DBCP_ACQUIRE_HISTOGRAM_SIZE];  // Acquire latency histogram for owner's call site
 };
 
 /**
@@ -117,6 +128,7 @@ DB_DRIVER LIBNXDB_EXPORTABLE DBLoadDriver(const TCHAR *module, const TCHAR *init
 void LIBNXDB_EXPORTABLE DBUnloadDriver(DB_DRIVER driver);
 const char LIBNXDB_EXPORTABLE *DBGetDriverName(DB_DRIVER driver);
 void LIBNXDB_EXPORTABLE DBSetDefaultPrefetchLimit(DB_DRIVER driver, int limit);
+void LIBNXDB_EXPORTABLE DBEnableUTF8Queries(DB_DRIVER driver, bool enabled);
 void LIBNXDB_EXPORTABLE DBEnableQueryTrace(bool enabled);
 bool LIBNXDB_EXPORTABLE DBIsQueryTraceEnabled();
 
@@ -155,10 +167,14 @@ DB_UNBUFFERED_RESULT LIBNXDB_EXPORTABLE DBSelectPreparedUnbufferedEx(DB_STATEMEN
 
 bool LIBNXDB_EXPORTABLE DBQuery(DB_HANDLE hConn, const TCHAR *szQuery);
 bool LIBNXDB_EXPORTABLE DBQueryEx(DB_HANDLE hConn, const TCHAR *szQuery, TCHAR *errorText);
+bool LIBNXDB_EXPORTABLE DBQueryUTF8(DB_HANDLE hConn, const char *query);
+bool LIBNXDB_EXPORTABLE DBQueryUTF8Ex(DB_HANDLE hConn, const char *query, TCHAR *errorText);
 
 DB_RESULT LIBNXDB_EXPORTABLE DBSelect(DB_HANDLE hConn, const TCHAR *szQuery);
 DB_RESULT LIBNXDB_EXPORTABLE DBSelectFormatted(DB_HANDLE hConn, const TCHAR *szQuery, ...);
 DB_RESULT LIBNXDB_EXPORTABLE DBSelectEx(DB_HANDLE hConn, const TCHAR *szQuery, TCHAR *errorText);
+DB_RESULT LIBNXDB_EXPORTABLE DBSelectUTF8(DB_HANDLE hConn, const char *query);
+DB_RESULT LIBNXDB_EXPORTABLE DBSelectUTF8Ex(DB_HANDLE hConn, const char *query, TCHAR *errorText);
 int LIBNXDB_EXPORTABLE DBGetColumnCount(DB_RESULT hResult);
 bool LIBNXDB_EXPORTABLE DBGetColumnName(DB_RESULT hResult, int column, TCHAR *buffer, int bufSize);
 bool LIBNXDB_EXPORTABLE DBGetColumnNameA(DB_RESULT hResult, int column, char *buffer, int bufSize);
@@ -184,6 +200,8 @@ uuid LIBNXDB_EXPORTABLE DBGetFieldGUID(DB_RESULT hResult, int iRow, int iColumn)
 
 DB_UNBUFFERED_RESULT LIBNXDB_EXPORTABLE DBSelectUnbuffered(DB_HANDLE hConn, const TCHAR *szQuery);
 DB_UNBUFFERED_RESULT LIBNXDB_EXPORTABLE DBSelectUnbufferedEx(DB_HANDLE hConn, const TCHAR *szQuery, TCHAR *errorText);
+DB_UNBUFFERED_RESULT LIBNXDB_EXPORTABLE DBSelectUnbufferedUTF8(DB_HANDLE hConn, const char *query);
+DB_UNBUFFERED_RESULT LIBNXDB_EXPORTABLE DBSelectUnbufferedUTF8Ex(DB_HANDLE hConn, const char *query, TCHAR *errorText);
 bool LIBNXDB_EXPORTABLE DBFetch(DB_UNBUFFERED_RESULT hResult);
 int LIBNXDB_EXPORTABLE DBGetColumnCount(DB_UNBUFFERED_RESULT hResult);
 bool LIBNXDB_EXPORTABLE DBGetColumnName(DB_UNBUFFERED_RESULT hResult, int column, TCHAR *buffer, int bufSize);
@@ -206,6 +224,12 @@ bool LIBNXDB_EXPORTABLE DBBegin(DB_HANDLE hConn);
 bool LIBNXDB_EXPORTABLE DBCommit(DB_HANDLE hConn);
 bool LIBNXDB_EXPORTABLE DBRollback(DB_HANDLE hConn);
 
+bool LIBNXDB_EXPORTABLE DBIsBulkLoadSupported(DB_HANDLE hConn);
+DB_BULK_LOAD LIBNXDB_EXPORTABLE DBBulkLoadBegin(DB_HANDLE hConn, const TCHAR *table, const TCHAR *columns, int numColumns);
+bool LIBNXDB_EXPORTABLE DBBulkLoadAddRow(DB_BULK_LOAD hLoad, const TCHAR **values);
+bool LIBNXDB_EXPORTABLE DBBulkLoadEnd(DB_BULK_LOAD hLoad);
+void LIBNXDB_EXPORTABLE DBBulkLoadCancel(DB_BULK_LOAD hLoad);
+
 StringList LIBNXDB_EXPORTABLE *DBGetTableList(DB_HANDLE hdb);
 int LIBNXDB_EXPORTABLE DBIsTableExist(DB_HANDLE conn, const TCHAR *table);
 
@@ -223,11 +247,12 @@ StringBuffer LIBNXDB_EXPORTABLE DBPrepareStringA(DB_DRIVER drv, const char *str,
 #endif
 StringBuffer LIBNXDB_EXPORTABLE DBPrepareStringUTF8(DB_HANDLE conn, const char *str, int maxSize = -1);
 StringBuffer LIBNXDB_EXPORTABLE DBPrepareStringUTF8(DB_DRIVER drv, const char *str, int maxSize = -1);
+char LIBNXDB_EXPORTABLE *DBPrepareStringAsUTF8(DB_HANDLE conn, const TCHAR *str);
 
 bool LIBNXDB_EXPORTABLE DBConnectionPoolStartup(DB_DRIVER driver, const TCHAR *server, const TCHAR *dbName,
 																const TCHAR *login, const TCHAR *password, const TCHAR *schema,
 																int basePoolSize, int maxPoolSize, int cooldownTime,
-																int connTTL);
+																int connTTL, bool threadAffinity = false);
 void LIBNXDB_EXPORTABLE DBConnectionPoolShutdown();
 void LIBNXDB_EXPORTABLE DBConnectionPoolReset();
 DB_HANDLE LIBNXDB_EXPORTABLE __DBConnectionPoolAcquireConnection(const char *srcFile, int srcLine);
@@ -260,5 +285,6 @@ bool LIBNXDB_EXPORTABLE DBDropIndex(DB_HANDLE hdb, const TCHAR *table, const TCH
 DB_HANDLE LIBNXDB_EXPORTABLE DBOpenInMemoryDatabase();
 void LIBNXDB_EXPORTABLE DBCloseInMemoryDatabase(DB_HANDLE hdb);
 bool LIBNXDB_EXPORTABLE DBCacheTable(DB_HANDLE cacheDB, DB_HANDLE sourceDB, const TCHAR *table, const TCHAR *indexColumn, const TCHAR *columns, const TCHAR * const *intColumns = NULL);
+bool LIBNXDB_EXPORTABLE DBCacheTable(DB_HANDLE cacheDB, Mutex *cacheLock, DB_HANDLE sourceDB, const TCHAR *table, const TCHAR *indexColumn, const TCHAR *columns, const TCHAR * const *intColumns = NULL);
 
 #endif   /* _nxsrvapi_h_ */
@@ -174,6 +174,7 @@
 #define EVENT_POLICY_VALIDATION_ERROR               117
 #define EVENT_TUNNEL_SETUP_ERROR                    118
 #define EVENT_DUPLICATE_MAC_ADDRESS                 119
+#define EVENT_EVENTS_SUPPRESSED                     120
 
 #define EVENT_SNMP_UNMATCHED_TRAP                   500
 #define EVENT_SNMP_COLD_START                       501
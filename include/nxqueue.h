@@ -63,6 +63,7 @@ class LIBNETXMS_EXPORTABLE Queue
    int m_readers;
 	bool m_shutdownFlag;
 	bool m_owner;
+   LatencyHistogram *m_waitTimeHistogram;
 
 	void commonInit();
 #ifdef _WIN32
@@ -74,6 +75,8 @@ class LIBNETXMS_EXPORTABLE Queue
 #endif
 
    void *getInternal();
+   void putInternal(void *element);
+   void setTimestamp(QueueBuffer *buffer, size_t pos);
 
 protected:
    void (*m_destructor)(void*, Queue*);
@@ -84,14 +87,21 @@ class LIBNETXMS_EXPORTABLE Queue
    virtual ~Queue();
 
    void put(void *object);
+   void putAll(void **objects, size_t count);
 	void insert(void *object);
 	void setShutdownMode();
 	void setOwner(bool owner) { m_owner = owner; }
    void *get();
    void *getOrBlock(uint32_t timeout = INFINITE);
+   size_t getAll(void **buffer, size_t maxCount);
    size_t size() const { return m_size; }
    size_t allocated() const { return m_blockSize * m_blockCount; }
+   uint64_t getMemoryUsage() const;
    void clear();
+
+   void enableWaitTimeHistogram();
+   const LatencyHistogram *getWaitTimeHistogram() const { return m_waitTimeHistogram; }
+
 	void *find(const void *key, QueueComparator comparator, void *(*transform)(void*) = nullptr);
 	bool remove(const void *key, QueueComparator comparator);
 	void forEach(QueueEnumerationCallback callback, void *context);
@@ -115,6 +125,7 @@ template<typename T> class ObjectQueue : public Queue
 
    T *get() { return (T*)Queue::get(); }
    T *getOrBlock(uint32_t timeout = INFINITE) { return (T*)Queue::getOrBlock(timeout); }
+   size_t getAll(T **buffer, size_t maxCount) { return Queue::getAll(reinterpret_cast<void**>(buffer), maxCount); }
    template<typename K> T *find(const K *key, bool (*comparator)(const K *, const T *), T *(*transform)(T*) = NULL) { return (T*)Queue::find(key, (QueueComparator)comparator, (void *(*)(void*))transform); }
    template<typename K> bool remove(const K *key, bool (*comparator)(const K *, const T *)) { return Queue::remove(key, (QueueComparator)comparator); }
    template<typename C> void forEach(EnumerationCallbackResult (*callback)(const T *, C *), C *context) { Queue::forEach((QueueEnumerationCallback)callback, (void *)context); }
@@ -172,4 +183,83 @@ template<typename T> class SharedObjectQueue : public Queue
    void insert(shared_ptr<T> object) { Queue::insert(new(m_pool.allocate()) shared_ptr<T>(object)); }
 };
 
+/**
+ * Ring buffer slot for MPSC queue
+ */
+struct MPSCQueueSlot;
+
+/**
+ * Bounded lock-free multi-producer single-consumer queue. Producers place elements into fixed size
+ * ring buffer without locking. If ring buffer is full, elements are placed into mutex protected
+ * overflow queue, so producers never block and elements are never lost. Order of elements put by
+ * same producer is preserved. Only one thread can read from queue at any given time. NULL pointers
+ * cannot be placed into the queue.
+ */
+class LIBNETXMS_EXPORTABLE MPSCQueue
+{
+   DISABLE_COPY_CTOR(MPSCQueue)
+
+private:
+   MPSCQueueSlot *m_ring;
+   size_t m_capacity;
+   size_t m_mask;
+   char m_padding1[64];
+   atomic<uint64_t> m_tail;   // Next position to be claimed by producer
+   char m_padding2[64];
+   atomic<uint64_t> m_head;   // Next position to be read by consumer
+   atomic<int64_t> m_overflowSize;
+   atomic<uint64_t> m_overflowCount;
+   atomic<bool> m_consumerWaiting;
+   Queue m_overflow;
+   Condition m_wakeupCondition;
+   bool m_owner;
+
+   bool putToRing(void *element);
+   bool putAllToRing(void **elements, size_t count);
+   void putInternal(void *element);
+   void wakeupConsumer();
+
+protected:
+   void (*m_destructor)(void*, MPSCQueue*);
+
+public:
+   MPSCQueue(size_t capacity = 65536, Ownership owner = Ownership::False);
+   virtual ~MPSCQueue();
+
+   void put(void *element);
+   void putAll(void **elements, size_t count);
+   void *get();
+   void *getOrBlock(uint32_t timeout = INFINITE);
+   size_t getAll(void **buffer, size_t maxCount);
+   size_t getAllOrBlock(void **buffer, size_t maxCount, uint32_t timeout = INFINITE);
+   void clear();
+   void setOwner(bool owner) { m_owner = owner; }
+
+   size_t size() const;
+   size_t capacity() const { return m_capacity; }
+   uint64_t getOverflowCount() const { return m_overflowCount.load(std::memory_order_relaxed); }
+   uint64_t getMemoryUsage() const;
+};
+
+/**
+ * Object MPSC queue
+ */
+template<typename T> class ObjectMPSCQueue : public MPSCQueue
+{
+   DISABLE_COPY_CTOR(ObjectMPSCQueue)
+
+private:
+   static void destructor(void *object, MPSCQueue *queue) { delete static_cast<T*>(object); }
+
+public:
+   ObjectMPSCQueue(size_t capacity = 65536, Ownership owner = Ownership::False) : MPSCQueue(capacity, owner) { m_destructor = destructor; }
+   virtual ~ObjectMPSCQueue() { }
+
+   T *get() { return static_cast<T*>(MPSCQueue::get()); }
+   T *getOrBlock(uint32_t timeout = INFINITE) { return static_cast<T*>(MPSCQueue::getOrBlock(timeout)); }
+   size_t getAll(T **buffer, size_t maxCount) { return MPSCQueue::getAll(reinterpret_cast<void**>(buffer), maxCount); }
+   size_t getAllOrBlock(T **buffer, size_t maxCount, uint32_t timeout = INFINITE) { return MPSCQueue::getAllOrBlock(reinterpret_cast<void**>(buffer), maxCount, timeout); }
+   void putAll(T **elements, size_t count) { MPSCQueue::putAll(reinterpret_cast<void**>(elements), count); }
+};
+
 #endif    /* _nxqueue_h_ */
@@ -478,7 +478,8 @@ template <class T> class NXSL_Handle
 #define NXSL_SHORT_STRING_LENGTH  32
 
 /**
- * Variable or constant value
+ * Variable or constant value. Members are ordered by size to avoid padding,
+ * as values are allocated in large numbers from VM memory pools.
  */
 class LIBNXSL_EXPORTABLE NXSL_Value
 {
@@ -486,15 +487,6 @@ class LIBNXSL_EXPORTABLE NXSL_Value
    friend class ObjectMemoryPool<NXSL_Value>;
 
 protected:
-   uint32_t m_length;
-   TCHAR m_stringValue[NXSL_SHORT_STRING_LENGTH];
-   TCHAR *m_stringPtr;
-#ifdef UNICODE
-	char *m_mbString;	// value as MB string; NULL until first request
-#endif
-	char *m_name;
-   BYTE m_dataType;
-   BYTE m_stringIsValid;
    union
    {
       int32_t int32;
@@ -507,6 +499,15 @@ class LIBNXSL_EXPORTABLE NXSL_Value
 		NXSL_Handle<NXSL_Array> *arrayHandle;
       NXSL_Handle<NXSL_HashMap> *hashMapHandle;
    } m_value;
+   TCHAR *m_stringPtr;
+#ifdef UNICODE
+	char *m_mbString;	// value as MB string; NULL until first request
+#endif
+	char *m_name;
+   uint32_t m_length;
+   TCHAR m_stringValue[NXSL_SHORT_STRING_LENGTH];
+   BYTE m_dataType;
+   BYTE m_stringIsValid;
 
    template<typename T> T getValueAsIntegerType()
    {
@@ -636,48 +637,50 @@ template class LIBNXSL_EXPORTABLE ObjectMemoryPool<NXSL_Identifier>;
 #endif
 
 /**
- * Value management functionality
+ * Value management functionality. Value and identifier pools with default region capacity
+ * are taken from per-thread cache and returned to it when value manager is destroyed, so
+ * short-lived VMs do not have to allocate new pool regions on each run.
  */
 class LIBNXSL_EXPORTABLE NXSL_ValueManager
 {
 protected:
-   ObjectMemoryPool<NXSL_Value> m_values;
-   ObjectMemoryPool<NXSL_Identifier> m_identifiers;
+   ObjectMemoryPool<NXSL_Value> *m_values;
+   ObjectMemoryPool<NXSL_Identifier> *m_identifiers;
 
 public:
-   NXSL_ValueManager() : m_values(256), m_identifiers(64) { }
-   NXSL_ValueManager(size_t valuesRegCapacity, size_t identifiersRegCapacity) : m_values(valuesRegCapacity), m_identifiers(identifiersRegCapacity) { }
-   virtual ~NXSL_ValueManager() { }
-
-   NXSL_Value *createValue() { return new(m_values.allocate()) NXSL_Value(); }
-   NXSL_Value *createValue(const NXSL_Value *src) { return new(m_values.allocate()) NXSL_Value(src); }
-   NXSL_Value *createValue(NXSL_Object *object) { return new(m_values.allocate()) NXSL_Value(object); }
-   NXSL_Value *createValue(NXSL_Array *array) { return new(m_values.allocate()) NXSL_Value(array); }
-   NXSL_Value *createValue(NXSL_Iterator *iterator) { return new(m_values.allocate()) NXSL_Value(iterator); }
-   NXSL_Value *createValue(NXSL_HashMap *hashMap) { return new(m_values.allocate()) NXSL_Value(hashMap); }
-   NXSL_Value *createValue(int32_t n) { return new(m_values.allocate()) NXSL_Value(n); }
-   NXSL_Value *createValue(uint32_t n) { return new(m_values.allocate()) NXSL_Value(n); }
-   NXSL_Value *createValue(int64_t n) { return new(m_values.allocate()) NXSL_Value(n); }
-   NXSL_Value *createValue(uint64_t n) { return new(m_values.allocate()) NXSL_Value(n); }
-   NXSL_Value *createValue(double d) { return new(m_values.allocate()) NXSL_Value(d); }
-   NXSL_Value *createValue(bool b) { return new(m_values.allocate()) NXSL_Value(b); }
-   NXSL_Value *createValue(const TCHAR *s) { return new(m_values.allocate()) NXSL_Value(s); }
-   NXSL_Value *createValue(const TCHAR *s, size_t l) { return new(m_values.allocate()) NXSL_Value(s, l); }
+   NXSL_ValueManager();
+   NXSL_ValueManager(size_t valuesRegCapacity, size_t identifiersRegCapacity);
+   virtual ~NXSL_ValueManager();
+
+   NXSL_Value *createValue() { return new(m_values->allocate()) NXSL_Value(); }
+   NXSL_Value *createValue(const NXSL_Value *src) { return new(m_values->allocate()) NXSL_Value(src); }
+   NXSL_Value *createValue(NXSL_Object *object) { return new(m_values->allocate()) NXSL_Value(object); }
+   NXSL_Value *createValue(NXSL_Array *array) { return new(m_values->allocate()) NXSL_Value(array); }
+   NXSL_Value *createValue(NXSL_Iterator *iterator) { return new(m_values->allocate()) NXSL_Value(iterator); }
+   NXSL_Value *createValue(NXSL_HashMap *hashMap) { return new(m_values->allocate()) NXSL_Value(hashMap); }
+   NXSL_Value *createValue(int32_t n) { return new(m_values->allocate()) NXSL_Value(n); }
+   NXSL_Value *createValue(uint32_t n) { return new(m_values->allocate()) NXSL_Value(n); }
+   NXSL_Value *createValue(int64_t n) { return new(m_values->allocate()) NXSL_Value(n); }
+   NXSL_Value *createValue(uint64_t n) { return new(m_values->allocate()) NXSL_Value(n); }
+   NXSL_Value *createValue(double d) { return new(m_values->allocate()) NXSL_Value(d); }
+   NXSL_Value *createValue(bool b) { return new(m_values->allocate()) NXSL_Value(b); }
+   NXSL_Value *createValue(const TCHAR *s) { return new(m_values->allocate()) NXSL_Value(s); }
+   NXSL_Value *createValue(const TCHAR *s, size_t l) { return new(m_values->allocate()) NXSL_Value(s, l); }
 #ifdef UNICODE
-   NXSL_Value *createValue(const char *s) { return new(m_values.allocate()) NXSL_Value(s); }
+   NXSL_Value *createValue(const char *s) { return new(m_values->allocate()) NXSL_Value(s); }
 #endif
-   void destroyValue(NXSL_Value *v) { m_values.destroy(v); }
+   void destroyValue(NXSL_Value *v) { m_values->destroy(v); }
 
-   NXSL_Identifier *createIdentifier() { return new(m_identifiers.allocate()) NXSL_Identifier(); }
-   NXSL_Identifier *createIdentifier(const char *s) { return new(m_identifiers.allocate()) NXSL_Identifier(s); }
+   NXSL_Identifier *createIdentifier() { return new(m_identifiers->allocate()) NXSL_Identifier(); }
+   NXSL_Identifier *createIdentifier(const char *s) { return new(m_identifiers->allocate()) NXSL_Identifier(s); }
 #ifdef UNICODE
-   NXSL_Identifier *createIdentifier(const WCHAR *s) { return new(m_identifiers.allocate()) NXSL_Identifier(s); }
+   NXSL_Identifier *createIdentifier(const WCHAR *s) { return new(m_identifiers->allocate()) NXSL_Identifier(s); }
 #endif
-   NXSL_Identifier *createIdentifier(const identifier_t& s) { return new(m_identifiers.allocate()) NXSL_Identifier(s); }
-   NXSL_Identifier *createIdentifier(const NXSL_Identifier& src) { return new(m_identifiers.allocate()) NXSL_Identifier(src); }
-   void destroyIdentifier(NXSL_Identifier *i) { m_identifiers.destroy(i); }
+   NXSL_Identifier *createIdentifier(const identifier_t& s) { return new(m_identifiers->allocate()) NXSL_Identifier(s); }
+   NXSL_Identifier *createIdentifier(const NXSL_Identifier& src) { return new(m_identifiers->allocate()) NXSL_Identifier(src); }
+   void destroyIdentifier(NXSL_Identifier *i) { m_identifiers->destroy(i); }
 
-   virtual uint64_t getMemoryUsage() const { return m_values.getMemoryUsage() + m_identifiers.getMemoryUsage(); }
+   virtual uint64_t getMemoryUsage() const { return m_values->getMemoryUsage() + m_identifiers->getMemoryUsage(); }
 };
 
 /**
@@ -898,7 +901,7 @@ enum class NXSL_VariableSystemType
 class LIBNXSL_EXPORTABLE NXSL_VariableSystem : public NXSL_RuntimeObject
 {
 protected:
-   MemoryPool m_pool;
+   MemoryPool *m_pool;
    NXSL_VariablePtr *m_variables;
    NXSL_VariableSystemType m_type;
    int m_restorePointCount;
@@ -1109,6 +1112,92 @@ class LIBNXSL_EXPORTABLE NXSL_LocalStorage : public NXSL_Storage
    virtual NXSL_Value *read(const TCHAR *name, NXSL_ValueManager *vm) override;
 };
 
+/**
+ * Execution profile entry (aggregated by source line or by single instruction)
+ */
+struct NXSL_ProfileEntry
+{
+   const TCHAR *module;    // Module name or nullptr for main script
+   int32_t line;           // Source line
+   uint32_t addr;          // Instruction address or INVALID_ADDRESS for source line aggregate
+   const char *mnemonic;   // Instruction mnemonic or nullptr for source line aggregate
+   uint64_t executions;    // Number of executed instructions
+   uint64_t samples;       // Number of timed instructions
+   uint64_t sampledTime;   // Total execution time of timed instructions (nanoseconds)
+
+   /**
+    * Get estimated total execution time in nanoseconds
+    */
+   uint64_t getEstimatedTime() const
+   {
+      return (samples > 0) ? static_cast<uint64_t>(static_cast<double>(sampledTime) * executions / samples) : 0;
+   }
+};
+
+#ifdef _WIN32
+template class LIBNXSL_EXPORTABLE StructArray<NXSL_ProfileEntry>;
+#endif
+
+/**
+ * NXSL execution profiler. Counts every executed instruction and measures execution time
+ * of every N-th instruction, where N is sampling interval. Time spent in external functions
+ * and methods is accounted to the instruction that made the call.
+ */
+class LIBNXSL_EXPORTABLE NXSL_Profiler
+{
+   friend class NXSL_VM;
+
+private:
+   uint32_t m_sampleInterval;
+   uint32_t m_countdown;
+   uint32_t m_size;
+   uint64_t *m_executions;
+   uint64_t *m_samples;
+   uint64_t *m_sampledTime;
+   uint64_t m_runTime;
+   uint32_t m_runCount;
+
+   void prepare(uint32_t codeSize);
+
+   /**
+    * Check if next instruction should be timed
+    */
+   bool startSample()
+   {
+      if (--m_countdown > 0)
+         return false;
+      m_countdown = m_sampleInterval;
+      return true;
+   }
+
+   void addExecution(uint32_t addr)
+   {
+      if (addr < m_size)
+         m_executions[addr]++;
+   }
+
+   void addSample(uint32_t addr, uint64_t elapsedTime)
+   {
+      if (addr < m_size)
+      {
+         m_executions[addr]++;
+         m_samples[addr]++;
+         m_sampledTime[addr] += elapsedTime;
+      }
+   }
+
+public:
+   NXSL_Profiler(uint32_t sampleInterval = 1);
+   ~NXSL_Profiler();
+
+   void reset();
+
+   uint32_t getSampleInterval() const { return m_sampleInterval; }
+   uint64_t getRunTime() const { return m_runTime; }
+   uint32_t getRunCount() const { return m_runCount; }
+   uint64_t getTotalExecutions() const;
+};
+
 #ifdef _WIN32
 template class LIBNXSL_EXPORTABLE ObjectArray<NXSL_Module>;
 #endif
@@ -1151,6 +1240,7 @@ class LIBNXSL_EXPORTABLE NXSL_VM : public NXSL_ValueManager
    ObjectArray<NXSL_Module> m_modules;
 
    NXSL_SecurityContext *m_securityContext;
+   NXSL_Profiler *m_profiler;
 
    NXSL_Value *m_pRetValue;
    int m_errorCode;
@@ -1158,6 +1248,7 @@ class LIBNXSL_EXPORTABLE NXSL_VM : public NXSL_ValueManager
    TCHAR *m_errorText;
 
    void execute();
+   void executeProfiled();
    bool unwind();
    void callFunction(int nArgCount);
    bool callExternalFunction(const NXSL_ExtFunction *function, int stackItems);
@@ -1224,6 +1315,12 @@ class LIBNXSL_EXPORTABLE NXSL_VM : public NXSL_ValueManager
    void setSecurityContext(NXSL_SecurityContext *context);
    bool validateAccess(int accessType, const void *object) { return (m_securityContext != nullptr) ? m_securityContext->validateAccess(accessType, object) : false; }
 
+   void enableProfiling(uint32_t sampleInterval = 1);
+   void disableProfiling();
+   bool isProfilingEnabled() const { return m_profiler != nullptr; }
+   const NXSL_Profiler *getProfiler() const { return m_profiler; }
+   StructArray<NXSL_ProfileEntry> *getProfile(bool byInstruction = false) const;
+
 	void *getUserData() { return m_userData; }
 	void setUserData(void *data) { m_userData = data; }
 };
@@ -714,6 +714,80 @@ class LIBNXSNMP_EXPORTABLE SNMP_PDU
    }
 };
 
+/**
+ * SNMP request priority
+ */
+enum SNMP_RequestPriority
+{
+   SNMP_REQUEST_PRIORITY_NORMAL = 0,   // Polls, discovery, table walks
+   SNMP_REQUEST_PRIORITY_HIGH = 1      // Data collection
+};
+
+/**
+ * SNMP request scheduler statistics
+ */
+struct SNMP_RequestSchedulerStatistics
+{
+   uint64_t requests;         // Total number of completed requests
+   uint64_t timeouts;         // Number of requests completed with timeout
+   uint64_t queueTimeouts;    // Number of requests not sent because of timeout in scheduler queue
+   uint32_t inFlight;         // Number of requests currently in flight
+   uint32_t queueSize;        // Number of requests currently waiting in scheduler queue
+   uint32_t lastResponseTime;       // Last response time (milliseconds)
+   uint32_t averageResponseTime;    // Exponential moving average of response time (milliseconds)
+   uint32_t averageWaitTime;        // Exponential moving average of time spent in queue (milliseconds)
+};
+
+struct SNMP_RequestSchedulerWaiter;
+
+/**
+ * SNMP request scheduler. Single scheduler is shared by all transports connected to same device
+ * and limits number of concurrent requests and request rate for that device. Requests with
+ * higher priority are granted before any waiting requests with lower priority.
+ */
+class LIBNXSNMP_EXPORTABLE SNMP_RequestScheduler
+{
+private:
+   Mutex m_mutex;
+   uint32_t m_maxInFlight;    // 0 = unlimited
+   uint32_t m_rateLimit;      // Requests per second, 0 = unlimited
+   uint32_t m_inFlight;
+   int64_t m_tokens;          // Available tokens for rate limiter (1/1000 of request)
+   int64_t m_lastRefillTime;
+   SNMP_RequestSchedulerWaiter *m_head[2];
+   SNMP_RequestSchedulerWaiter *m_tail[2];
+   uint32_t m_queueSize;
+   uint64_t m_requests;
+   uint64_t m_timeouts;
+   uint64_t m_queueTimeouts;
+   uint32_t m_lastResponseTime;
+   uint32_t m_averageResponseTime;  // Fixed point with 4 bits for fraction
+   uint32_t m_averageWaitTime;      // Fixed point with 4 bits for fraction
+
+   void refillTokens(int64_t now);
+   bool canGrant() const;
+   void grantWaiters();
+   void removeWaiter(SNMP_RequestSchedulerWaiter *waiter);
+   void updateWaitTime(uint32_t waitTime);
+
+public:
+   SNMP_RequestScheduler(uint32_t maxInFlight = 0, uint32_t rateLimit = 0);
+   ~SNMP_RequestScheduler();
+
+   void setLimits(uint32_t maxInFlight, uint32_t rateLimit);
+   uint32_t getMaxInFlight() const { return m_maxInFlight; }
+   uint32_t getRateLimit() const { return m_rateLimit; }
+
+   bool acquire(SNMP_RequestPriority priority, uint32_t timeout);
+   void release(uint32_t rcode, uint32_t responseTime);
+
+   void getStatistics(SNMP_RequestSchedulerStatistics *statistics);
+};
+
+#ifdef _WIN32
+template class LIBNXSNMP_EXPORTABLE shared_ptr<SNMP_RequestScheduler>;
+#endif
+
 /**
  * Generic SNMP transport
  */
@@ -727,8 +801,11 @@ class LIBNXSNMP_EXPORTABLE SNMP_Transport
 	bool m_updatePeerOnRecv;
 	bool m_reliable;
 	SNMP_Version m_snmpVersion;
+	shared_ptr<SNMP_RequestScheduler> m_scheduler;
+	SNMP_RequestPriority m_priority;
 
 	uint32_t doEngineIdDiscovery(SNMP_PDU *originalRequest, uint32_t timeout, int numRetries);
+	uint32_t doRequestInternal(SNMP_PDU *request, SNMP_PDU **response, uint32_t timeout, int numRetries, bool engineIdDiscoveryOnly);
 
 public:
    SNMP_Transport();
@@ -757,6 +834,12 @@ class LIBNXSNMP_EXPORTABLE SNMP_Transport
 
 	void setSnmpVersion(SNMP_Version version) { m_snmpVersion = version; }
 	SNMP_Version getSnmpVersion() const { return m_snmpVersion; }
+
+	void setScheduler(const shared_ptr<SNMP_RequestScheduler>& scheduler) { m_scheduler = scheduler; }
+	const shared_ptr<SNMP_RequestScheduler>& getScheduler() const { return m_scheduler; }
+
+	void setPriority(SNMP_RequestPriority priority) { m_priority = priority; }
+	SNMP_RequestPriority getPriority() const { return m_priority; }
 };
 
 /**
@@ -73,6 +73,7 @@
 import org.netxms.client.constants.AuthenticationType;
 import org.netxms.client.constants.DataOrigin;
 import org.netxms.client.constants.DataType;
+import org.netxms.client.constants.DownsamplingMethod;
 import org.netxms.client.constants.HistoricalDataType;
 import org.netxms.client.constants.NodePollType;
 import org.netxms.client.constants.ObjectStatus;
@@ -259,6 +260,7 @@
    private static final int CLIENT_CHALLENGE_SIZE = 256;
    private static final int MAX_DCI_DATA_ROWS = 200000;
    private static final int MAX_DCI_STRING_VALUE_LENGTH = 256;
+   private static final int DCI_DATA_MORE_CHUNKS = 0x0001;
    private static final int RECEIVED_FILE_TTL = 300000; // 300 seconds
    private static final int FILE_BUFFER_SIZE = 32768; // 32KB
 
@@ -629,6 +631,9 @@ public void run()
                   case NXCPCodes.CMD_THRESHOLD_UPDATE:
                      processThresholdChange(msg);
                      break;
+                  case NXCPCodes.CMD_LAST_VALUES_UPDATE:
+                     processLastValuesUpdate(msg);
+                     break;
                   case NXCPCodes.CMD_TCP_PROXY_DATA:
                      processTcpProxyData((int)msg.getMessageId(), msg.getBinaryData());
                      break;
@@ -1091,6 +1096,17 @@ public void processThresholdChange(NXCPMessage msg)
                msg.getFieldAsInt64(NXCPCodes.VID_OBJECT_ID), new ThresholdStateChange(msg)));
       }
 
+      /**
+       * Process incremental last values update for object subscribed with subscribeToLastValues
+       *
+       * @param msg notification message
+       */
+      private void processLastValuesUpdate(NXCPMessage msg)
+      {
+         long objectId = msg.getFieldAsInt64(NXCPCodes.VID_OBJECT_ID);
+         sendNotification(new SessionNotification(SessionNotification.LAST_VALUES_UPDATED, objectId, parseLastValues(objectId, msg)));
+      }
+
       /**
        * Process server notification on alarm category configuration change
        *
@@ -4932,15 +4948,25 @@ public DciValue[] getLastValues(final long nodeId, boolean objectTooltipOnly, bo
       sendMessage(msg);
 
       final NXCPMessage response = waitForRCC(msg.getMessageId());
+      return parseLastValues(nodeId, response);
+   }
 
-      int count = response.getFieldAsInt32(NXCPCodes.VID_NUM_ITEMS);
+   /**
+    * Parse DCI values from CMD_GET_LAST_VALUES response or CMD_LAST_VALUES_UPDATE notification
+    *
+    * @param nodeId owning object ID
+    * @param msg message to parse
+    * @return list of DCI values
+    */
+   private static DciValue[] parseLastValues(long nodeId, NXCPMessage msg)
+   {
+      int count = msg.getFieldAsInt32(NXCPCodes.VID_NUM_ITEMS);
       DciValue[] list = new DciValue[count];
       long base = NXCPCodes.VID_DCI_VALUES_BASE;
       for(int i = 0; i < count; i++, base += 50)
       {
-         list[i] = DciValue.createFromMessage(nodeId, response, base);
+         list[i] = DciValue.createFromMessage(nodeId, msg, base);
       }
-
       return list;
    }
 
@@ -4956,6 +4982,67 @@ public DciValue[] getLastValues(final long nodeId) throws IOException, NXCExcept
    {
       return getLastValues(nodeId, false, false, false);
    }
+
+   /**
+    * Subscribe to incremental updates of last DCI values for given object. Method returns current values
+    * (same as getLastValues). After that server will send only DCIs with changed value or status, which
+    * will be delivered to session listeners as notifications with code
+    * SessionNotification.LAST_VALUES_UPDATED, object ID as sub code, and array of DciValue objects as
+    * notification object. Repeated call for same object replaces existing subscription.
+    *
+    * @param objectId              ID of the object to get DCI values for
+    * @param objectTooltipOnly     if set to true, only DCIs with DCF_SHOW_ON_OBJECT_TOOLTIP flag set are returned
+    * @param overviewOnly          if set to true, only DCIs with DCF_SHOW_IN_OBJECT_OVERVIEW flag set are returned
+    * @param includeNoValueObjects if set to true, objects with no value (like instance discovery DCIs) will be returned as well
+    * @param dciFilter             list of DCI IDs to subscribe to (null or empty to subscribe to all DCIs of the object)
+    * @return List of current DCI values
+    * @throws IOException  if socket I/O error occurs
+    * @throws NXCException if NetXMS server returns an error or operation was timed out
+    */
+   public DciValue[] subscribeToLastValues(final long objectId, boolean objectTooltipOnly, boolean overviewOnly,
+         boolean includeNoValueObjects, long[] dciFilter) throws IOException, NXCException
+   {
+      final NXCPMessage msg = newMessage(NXCPCodes.CMD_SUBSCRIBE_LAST_VALUES);
+      msg.setFieldInt32(NXCPCodes.VID_OBJECT_ID, (int)objectId);
+      msg.setField(NXCPCodes.VID_OBJECT_TOOLTIP_ONLY, objectTooltipOnly);
+      msg.setField(NXCPCodes.VID_OVERVIEW_ONLY, overviewOnly);
+      msg.setField(NXCPCodes.VID_INCLUDE_NOVALUE_OBJECTS, includeNoValueObjects);
+      if ((dciFilter != null) && (dciFilter.length > 0))
+         msg.setField(NXCPCodes.VID_ITEM_LIST, dciFilter);
+      sendMessage(msg);
+
+      final NXCPMessage response = waitForRCC(msg.getMessageId());
+      return parseLastValues(objectId, response);
+   }
+
+   /**
+    * Subscribe to incremental updates of last values for all DCIs of given object.
+    *
+    * @param objectId ID of the object to get DCI values for
+    * @return List of current DCI values
+    * @throws IOException  if socket I/O error occurs
+    * @throws NXCException if NetXMS server returns an error or operation was timed out
+    * @see #subscribeToLastValues(long, boolean, boolean, boolean, long[])
+    */
+   public DciValue[] subscribeToLastValues(final long objectId) throws IOException, NXCException
+   {
+      return subscribeToLastValues(objectId, false, false, false, null);
+   }
+
+   /**
+    * Cancel subscription to incremental updates of last DCI values.
+    *
+    * @param objectId ID of the object to cancel subscription for (0 to cancel all subscriptions of this session)
+    * @throws IOException  if socket I/O error occurs
+    * @throws NXCException if NetXMS server returns an error or operation was timed out
+    */
+   public void unsubscribeFromLastValues(final long objectId) throws IOException, NXCException
+   {
+      final NXCPMessage msg = newMessage(NXCPCodes.CMD_UNSUBSCRIBE_LAST_VALUES);
+      msg.setFieldInt32(NXCPCodes.VID_OBJECT_ID, (int)objectId);
+      sendMessage(msg);
+      waitForRCC(msg.getMessageId());
+   }
    
    /**
     * Get tooltip last values for all objects 
@@ -5284,24 +5371,38 @@ public int parseDataRows(final byte[] input, DciData data)
       return rows;
    }
 
+   /**
+    * Check if raw message CMD_DCI_DATA is followed by more data chunks.
+    *
+    * @param input Raw data
+    * @return true if more data chunks will follow
+    */
+   private static boolean hasMoreDataChunks(final byte[] input)
+   {
+      // Flags are stored as big endian 32 bit integer at offset 12
+      return (input.length >= 16) && ((input[15] & DCI_DATA_MORE_CHUNKS) != 0);
+   }
+
    /**
     * Get collected DCI data from server. Please note that you should specify
     * either row count limit or time from/to limit.
     *
-    * @param nodeId     Node ID
-    * @param dciId      DCI ID
-    * @param instance   instance value (for table DCI only)
-    * @param dataColumn name of column to retrieve data from (for table DCI only)
-    * @param from       Start of time range or null for no limit
-    * @param to         End of time range or null for no limit
-    * @param maxRows    Maximum number of rows to retrieve or 0 for no limit
-    * @param valueType  TODO
+    * @param nodeId             Node ID
+    * @param dciId              DCI ID
+    * @param instance           instance value (for table DCI only)
+    * @param dataColumn         name of column to retrieve data from (for table DCI only)
+    * @param from               Start of time range or null for no limit
+    * @param to                 End of time range or null for no limit
+    * @param maxRows            Maximum number of rows to retrieve or 0 for no limit
+    * @param valueType          TODO
+    * @param downsamplingMethod downsampling method
+    * @param targetPointCount   number of points to downsample data to (ignored if downsampling method is NONE)
     * @return DCI data set
     * @throws IOException  if socket I/O error occurs
     * @throws NXCException if NetXMS server returns an error or operation was timed out
     */
    private DciData getCollectedDataInternal(long nodeId, long dciId, String instance, String dataColumn, Date from, Date to,
-         int maxRows, HistoricalDataType valueType) throws IOException, NXCException
+         int maxRows, HistoricalDataType valueType, DownsamplingMethod downsamplingMethod, int targetPointCount) throws IOException, NXCException
    {
       NXCPMessage msg;
       if (instance != null) // table DCI
@@ -5317,6 +5418,9 @@ private DciData getCollectedDataInternal(long nodeId, long dciId, String instanc
       msg.setFieldInt32(NXCPCodes.VID_OBJECT_ID, (int)nodeId);
       msg.setFieldInt32(NXCPCodes.VID_DCI_ID, (int)dciId);
       msg.setFieldInt16(NXCPCodes.VID_HISTORICAL_DATA_TYPE, valueType.getValue());
+      msg.setFieldInt16(NXCPCodes.VID_DOWNSAMPLING_METHOD, downsamplingMethod.getValue());
+      msg.setFieldInt32(NXCPCodes.VID_TARGET_POINT_COUNT, targetPointCount);
+      msg.setField(NXCPCodes.VID_ENABLE_CHUNKED_DATA, true);
 
       DciData data = new DciData(nodeId, dciId);
 
@@ -5334,11 +5438,20 @@ private DciData getCollectedDataInternal(long nodeId, long dciId, String instanc
 
          waitForRCC(msg.getMessageId());
 
-         NXCPMessage response = waitForMessage(NXCPCodes.CMD_DCI_DATA, msg.getMessageId());
-         if (!response.isBinaryMessage())
-            throw new NXCException(RCC.INTERNAL_ERROR);
+         // Server may send data in multiple chunks
+         rowsReceived = 0;
+         boolean moreChunks;
+         do
+         {
+            NXCPMessage response = waitForMessage(NXCPCodes.CMD_DCI_DATA, msg.getMessageId());
+            if (!response.isBinaryMessage())
+               throw new NXCException(RCC.INTERNAL_ERROR);
+
+            byte[] chunk = response.getBinaryData();
+            rowsReceived += parseDataRows(chunk, data);
+            moreChunks = hasMoreDataChunks(chunk);
+         } while(moreChunks);
 
-         rowsReceived = parseDataRows(response.getBinaryData(), data);
          if (((rowsRemaining == 0) || (rowsRemaining > MAX_DCI_DATA_ROWS)) && (rowsReceived == MAX_DCI_DATA_ROWS))
          {
             // adjust boundaries for next request
@@ -5380,7 +5493,28 @@ private DciData getCollectedDataInternal(long nodeId, long dciId, String instanc
    public DciData getCollectedData(long nodeId, long dciId, Date from, Date to, int maxRows, HistoricalDataType valueType)
          throws IOException, NXCException
    {
-      return getCollectedDataInternal(nodeId, dciId, null, null, from, to, maxRows, valueType);
+      return getCollectedDataInternal(nodeId, dciId, null, null, from, to, maxRows, valueType, DownsamplingMethod.NONE, 0);
+   }
+
+   /**
+    * Get collected DCI data from server downsampled to given number of points. Downsampling requires
+    * start of time range to be set and is only applied to numeric processed values; otherwise data is
+    * returned as is.
+    *
+    * @param nodeId             Node ID
+    * @param dciId              DCI ID
+    * @param from               Start of time range
+    * @param to                 End of time range or null for current time
+    * @param downsamplingMethod downsampling method
+    * @param targetPointCount   number of points to downsample data to
+    * @return DCI data set
+    * @throws IOException  if socket I/O error occurs
+    * @throws NXCException if NetXMS server returns an error or operation was timed out
+    */
+   public DciData getCollectedData(long nodeId, long dciId, Date from, Date to, DownsamplingMethod downsamplingMethod, int targetPointCount)
+         throws IOException, NXCException
+   {
+      return getCollectedDataInternal(nodeId, dciId, null, null, from, to, 0, HistoricalDataType.PROCESSED, downsamplingMethod, targetPointCount);
    }
 
    /**
@@ -5403,7 +5537,7 @@ public DciData getCollectedTableData(long nodeId, long dciId, String instance, S
    {
       if (instance == null || dataColumn == null)
          throw new NXCException(RCC.INVALID_ARGUMENT);
-      return getCollectedDataInternal(nodeId, dciId, instance, dataColumn, from, to, maxRows, HistoricalDataType.PROCESSED);
+      return getCollectedDataInternal(nodeId, dciId, instance, dataColumn, from, to, maxRows, HistoricalDataType.PROCESSED, DownsamplingMethod.NONE, 0);
    }
 
    /**
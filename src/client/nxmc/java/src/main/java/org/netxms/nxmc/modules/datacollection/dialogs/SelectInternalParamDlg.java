@@ -119,6 +119,14 @@ private void fillMetricList()
 		   list.add(new AgentParameter("PollTime.Topology.Min", "Poll time (topology): min", DataType.UINT64)); //$NON-NLS-1$
          list.add(new AgentParameter("ReceivedSNMPTraps", "Total SNMP traps received from this node", DataType.UINT64)); //$NON-NLS-1$
          list.add(new AgentParameter("ReceivedSyslogMessages", "Total syslog messages received from this node", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("SNMP.Queue.Size", "SNMP: number of requests waiting in scheduler queue", DataType.UINT32)); //$NON-NLS-1$
+         list.add(new AgentParameter("SNMP.Queue.Timeouts", "SNMP: number of requests timed out in scheduler queue", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("SNMP.Queue.WaitTime.Average", "SNMP: average time spent in scheduler queue", DataType.UINT32)); //$NON-NLS-1$
+         list.add(new AgentParameter("SNMP.Requests.InFlight", "SNMP: number of requests in flight", DataType.UINT32)); //$NON-NLS-1$
+         list.add(new AgentParameter("SNMP.Requests.Timeouts", "SNMP: number of timed out requests", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("SNMP.Requests.Total", "SNMP: total number of requests", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("SNMP.ResponseTime.Average", "SNMP: average response time", DataType.UINT32)); //$NON-NLS-1$
+         list.add(new AgentParameter("SNMP.ResponseTime.Last", "SNMP: last response time", DataType.UINT32)); //$NON-NLS-1$
          list.add(new AgentParameter("ZoneProxy.Assignments", "Zone proxy: number of assignments", DataType.UINT32)); //$NON-NLS-1$
          list.add(new AgentParameter("ZoneProxy.State", "Zone proxy: state", DataType.INT32)); //$NON-NLS-1$
          list.add(new AgentParameter("ZoneProxy.ZoneUIN", "Zone proxy: UIN of parent zone", DataType.UINT32)); //$NON-NLS-1$
@@ -150,17 +158,17 @@ private void fillMetricList()
          list.add(new AgentParameter("Server.ClientSessions.Web", "Client sessions: web clients", DataType.UINT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.ClientSessions.Web(*)", "Client sessions for user {instance}: web clients", DataType.UINT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.DataCollectionItems", "Number of data collection items in the system", DataType.UINT32)); //$NON-NLS-1$
-         list.add(new AgentParameter("Server.DB.Queries.Failed", "Failed DB queries", DataType.COUNTER64)); //$NON-NLS-1$
-         list.add(new AgentParameter("Server.DB.Queries.LongRunning", "Long running DB queries", DataType.COUNTER64)); //$NON-NLS-1$
-         list.add(new AgentParameter("Server.DB.Queries.NonSelect", "Non-SELECT DB queries", DataType.COUNTER64)); //$NON-NLS-1$
-         list.add(new AgentParameter("Server.DB.Queries.Select", "SELECT DB queries", DataType.COUNTER64)); //$NON-NLS-1$
-         list.add(new AgentParameter("Server.DB.Queries.Total", "Total DB queries", DataType.COUNTER64)); //$NON-NLS-1$
-         list.add(new AgentParameter("Server.DBWriter.Requests.IData", "DB writer requests (DCI data)", DataType.COUNTER64)); //$NON-NLS-1$
-         list.add(new AgentParameter("Server.DBWriter.Requests.Other", "DB writer requests (other queries)", DataType.COUNTER64)); //$NON-NLS-1$
-         list.add(new AgentParameter("Server.DBWriter.Requests.RawData", "DB writer requests (raw DCI data)", DataType.COUNTER64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.DB.Queries.Failed", "Failed DB queries", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.DB.Queries.LongRunning", "Long running DB queries", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.DB.Queries.NonSelect", "Non-SELECT DB queries", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.DB.Queries.Select", "SELECT DB queries", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.DB.Queries.Total", "Total DB queries", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.DBWriter.Requests.IData", "DB writer requests (DCI data)", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.DBWriter.Requests.Other", "DB writer requests (other queries)", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.DBWriter.Requests.RawData", "DB writer requests (raw DCI data)", DataType.UINT64)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.EventProcessor.AverageWaitTime(*)", "Event processor {instance}: average event wait time", DataType.UINT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.EventProcessor.Bindings(*)", "Event processor {instance}: active bindings", DataType.UINT32)); //$NON-NLS-1$
-         list.add(new AgentParameter("Server.EventProcessor.ProcessedEvents(*)", "Event processor {instance}: total number of processed events", DataType.COUNTER64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.EventProcessor.ProcessedEvents(*)", "Event processor {instance}: total number of processed events", DataType.UINT64)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.EventProcessor.QueueSize(*)", "Event processor {instance}: queue size", DataType.UINT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.Heap.Active", "Active server heap memory", DataType.UINT64)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.Heap.Allocated", "Allocated server heap memory", DataType.UINT64)); //$NON-NLS-1$
@@ -176,9 +184,9 @@ private void fillMetricList()
          list.add(new AgentParameter("Server.QueueSize.Current(*)", "Server queue {instance}: current size", DataType.INT64)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.QueueSize.Max(*)", "Server queue {instance}: max size", DataType.INT64)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.QueueSize.Min(*)", "Server queue {instance}: min size", DataType.INT64)); //$NON-NLS-1$
-         list.add(new AgentParameter("Server.ReceivedSNMPTraps", "SNMP traps received since server start", DataType.COUNTER64)); //$NON-NLS-1$
-         list.add(new AgentParameter("Server.ReceivedSyslogMessages", "Syslog messages received since server start", DataType.COUNTER64)); //$NON-NLS-1$
-         list.add(new AgentParameter("Server.ReceivedWindowsEvents", "Windows events received since server start", DataType.COUNTER64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.ReceivedSNMPTraps", "SNMP traps received since server start", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.ReceivedSyslogMessages", "Syslog messages received since server start", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.ReceivedWindowsEvents", "Windows events received since server start", DataType.UINT64)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.SyncerRunTime.Average", "Syncer run time: average", DataType.UINT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.SyncerRunTime.Last", "Syncer run time: last", DataType.UINT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.SyncerRunTime.Max", "Syncer run time: max", DataType.UINT32)); //$NON-NLS-1$
@@ -194,7 +202,7 @@ private void fillMetricList()
          list.add(new AgentParameter("Server.ThreadPool.MinSize(*)", "Thread pool {instance}: minimum size", DataType.INT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.ThreadPool.ScheduledRequests(*)", "Thread pool {instance}: scheduled requests", DataType.INT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.ThreadPool.Usage(*)", "Thread pool {instance}: usage", DataType.INT32)); //$NON-NLS-1$
-         list.add(new AgentParameter("Server.TotalEventsProcessed", "Total events processed", DataType.COUNTER64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.TotalEventsProcessed", "Total events processed", DataType.UINT64)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.Uptime", "Server uptime", DataType.UINT32)); //$NON-NLS-1$
 		}
 
@@ -591,15 +591,21 @@ extern "C" DWORD __EXPORT DrvQuery(MARIADB_CONN *pConn, WCHAR *pwszQuery, WCHAR
 	return rc;
 }
 
+/**
+ * Perform non-SELECT query (query in UTF-8)
+ */
+extern "C" DWORD __EXPORT DrvQueryUTF8(MARIADB_CONN *pConn, const char *query, WCHAR *errorText)
+{
+   return DrvQueryInternal(pConn, query, errorText);
+}
+
 /**
  * Perform SELECT query - actual implementation
  */
-static MARIADB_RESULT *DrvSelectInternal(MARIADB_CONN *pConn, WCHAR *pwszQuery, DWORD *pdwError, WCHAR *errorText)
+static MARIADB_RESULT *DrvSelectInternal(MARIADB_CONN *pConn, const char *pszQueryUTF8, DWORD *pdwError, WCHAR *errorText)
 {
    MARIADB_RESULT *result = nullptr;
 
-   char localBuffer[1024];
-   char *pszQueryUTF8 = WideStringToUTF8(pwszQuery, localBuffer, 1024);
 	MutexLock(pConn->mutexQueryLock);
 	if (mysql_query(pConn->pMySQL, pszQueryUTF8) == 0)
 	{
@@ -630,7 +636,6 @@ static MARIADB_RESULT *DrvSelectInternal(MARIADB_CONN *pConn, WCHAR *pwszQuery,
 	}
 
 	MutexUnlock(pConn->mutexQueryLock);
-	FreeConvertedString(pszQueryUTF8, localBuffer);
 	return result;
 }
 
@@ -638,6 +643,23 @@ static MARIADB_RESULT *DrvSelectInternal(MARIADB_CONN *pConn, WCHAR *pwszQuery,
  * Perform SELECT query - public entry point
  */
 extern "C" DBDRV_RESULT __EXPORT DrvSelect(MARIADB_CONN *conn, WCHAR *query, DWORD *errorCode, WCHAR *errorText)
+{
+   if (conn == nullptr)
+   {
+      *errorCode = DBERR_INVALID_HANDLE;
+      return nullptr;
+   }
+   char localBuffer[1024];
+   char *queryUTF8 = WideStringToUTF8(query, localBuffer, 1024);
+   DBDRV_RESULT result = DrvSelectInternal(conn, queryUTF8, errorCode, errorText);
+   FreeConvertedString(queryUTF8, localBuffer);
+   return result;
+}
+
+/**
+ * Perform SELECT query (query in UTF-8)
+ */
+extern "C" DBDRV_RESULT __EXPORT DrvSelectUTF8(MARIADB_CONN *conn, const char *query, DWORD *errorCode, WCHAR *errorText)
 {
    if (conn == nullptr)
    {
@@ -951,9 +973,9 @@ extern "C" void __EXPORT DrvFreeResult(MARIADB_RESULT *hResult)
 }
 
 /**
- * Perform unbuffered SELECT query
+ * Perform unbuffered SELECT query (query in UTF-8)
  */
-extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(MARIADB_CONN *pConn, WCHAR *pwszQuery, DWORD *pdwError, WCHAR *errorText)
+extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbufferedUTF8(MARIADB_CONN *pConn, const char *pszQueryUTF8, DWORD *pdwError, WCHAR *errorText)
 {
 	if (pConn == NULL)
 	{
@@ -963,8 +985,6 @@ extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(MARIADB_CONN *pC
 
    MARIADB_UNBUFFERED_RESULT *pResult = NULL;
 
-   char localBuffer[1024];
-	char *pszQueryUTF8 = WideStringToUTF8(pwszQuery, localBuffer, 1024);
 	MutexLock(pConn->mutexQueryLock);
 	if (mysql_query(pConn->pMySQL, pszQueryUTF8) == 0)
 	{
@@ -1013,11 +1033,22 @@ extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(MARIADB_CONN *pC
 	{
 		MutexUnlock(pConn->mutexQueryLock);
 	}
-	FreeConvertedString(pszQueryUTF8, localBuffer);
 
 	return pResult;
 }
 
+/**
+ * Perform unbuffered SELECT query
+ */
+extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(MARIADB_CONN *pConn, WCHAR *pwszQuery, DWORD *pdwError, WCHAR *errorText)
+{
+   char localBuffer[1024];
+   char *queryUTF8 = WideStringToUTF8(pwszQuery, localBuffer, 1024);
+   DBDRV_UNBUFFERED_RESULT result = DrvSelectUnbufferedUTF8(pConn, queryUTF8, pdwError, errorText);
+   FreeConvertedString(queryUTF8, localBuffer);
+   return result;
+}
+
 /**
  * Perform unbuffered SELECT query using prepared statement
  */
@@ -1346,10 +1377,11 @@ extern "C" int __EXPORT DrvIsTableExist(MARIADB_CONN *conn, const WCHAR *name)
    if (conn == nullptr)
       return DBIsTableExist_Failure;
 
-   WCHAR query[256], lname[256];
+   WCHAR lname[256];
    wcsncpy(lname, name, 256);
    wcslwr(lname);
-   swprintf(query, 256, L"SHOW TABLES LIKE '%ls'", lname);
+   char query[256];
+   snprintf(query, 256, "SHOW TABLES LIKE '%ls'", lname);
    DWORD error;
    WCHAR errorText[DBDRV_MAX_ERROR_TEXT];
    int rc = DBIsTableExist_Failure;
@@ -516,15 +516,21 @@ extern "C" DWORD __EXPORT DrvQuery(MYSQL_CONN *pConn, WCHAR *pwszQuery, WCHAR *e
 	return rc;
 }
 
+/**
+ * Perform non-SELECT query (query in UTF-8)
+ */
+extern "C" DWORD __EXPORT DrvQueryUTF8(MYSQL_CONN *pConn, const char *query, WCHAR *errorText)
+{
+   return DrvQueryInternal(pConn, query, errorText);
+}
+
 /**
  * Perform SELECT query - actual implementation
  */
-static MYSQL_RESULT *DrvSelectInternal(MYSQL_CONN *pConn, WCHAR *pwszQuery, DWORD *pdwError, WCHAR *errorText)
+static MYSQL_RESULT *DrvSelectInternal(MYSQL_CONN *pConn, const char *pszQueryUTF8, DWORD *pdwError, WCHAR *errorText)
 {
    MYSQL_RESULT *result = nullptr;
 
-   char localBuffer[1024];
-	char *pszQueryUTF8 = WideStringToUTF8(pwszQuery, localBuffer, 1024);
 	MutexLock(pConn->mutexQueryLock);
 	if (mysql_query(pConn->pMySQL, pszQueryUTF8) == 0)
 	{
@@ -555,7 +561,6 @@ static MYSQL_RESULT *DrvSelectInternal(MYSQL_CONN *pConn, WCHAR *pwszQuery, DWOR
 	}
 
 	MutexUnlock(pConn->mutexQueryLock);
-	FreeConvertedString(pszQueryUTF8, localBuffer);
 	return result;
 }
 
@@ -569,6 +574,23 @@ extern "C" DBDRV_RESULT __EXPORT DrvSelect(MYSQL_CONN *conn, WCHAR *query, DWORD
 		*errorCode = DBERR_INVALID_HANDLE;
 		return nullptr;
 	}
+   char localBuffer[1024];
+   char *queryUTF8 = WideStringToUTF8(query, localBuffer, 1024);
+   DBDRV_RESULT result = DrvSelectInternal(conn, queryUTF8, errorCode, errorText);
+   FreeConvertedString(queryUTF8, localBuffer);
+   return result;
+}
+
+/**
+ * Perform SELECT query (query in UTF-8)
+ */
+extern "C" DBDRV_RESULT __EXPORT DrvSelectUTF8(MYSQL_CONN *conn, const char *query, DWORD *errorCode, WCHAR *errorText)
+{
+   if (conn == nullptr)
+   {
+      *errorCode = DBERR_INVALID_HANDLE;
+      return nullptr;
+   }
    return DrvSelectInternal(conn, query, errorCode, errorText);
 }
 
@@ -882,9 +904,9 @@ extern "C" void __EXPORT DrvFreeResult(MYSQL_RESULT *hResult)
 }
 
 /**
- * Perform unbuffered SELECT query
+ * Perform unbuffered SELECT query (query in UTF-8)
  */
-extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(MYSQL_CONN *pConn, WCHAR *pwszQuery, DWORD *pdwError, WCHAR *errorText)
+extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbufferedUTF8(MYSQL_CONN *pConn, const char *pszQueryUTF8, DWORD *pdwError, WCHAR *errorText)
 {
 	if (pConn == NULL)
 	{
@@ -894,8 +916,6 @@ extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(MYSQL_CONN *pCon
 
    MYSQL_UNBUFFERED_RESULT *pResult = NULL;
 
-   char localBuffer[1024];
-	char *pszQueryUTF8 = WideStringToUTF8(pwszQuery, localBuffer, 1024);
 	MutexLock(pConn->mutexQueryLock);
 	if (mysql_query(pConn->pMySQL, pszQueryUTF8) == 0)
 	{
@@ -945,11 +965,22 @@ extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(MYSQL_CONN *pCon
 	{
 		MutexUnlock(pConn->mutexQueryLock);
 	}
-	FreeConvertedString(pszQueryUTF8, localBuffer);
 
 	return pResult;
 }
 
+/**
+ * Perform unbuffered SELECT query
+ */
+extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(MYSQL_CONN *pConn, WCHAR *pwszQuery, DWORD *pdwError, WCHAR *errorText)
+{
+   char localBuffer[1024];
+   char *queryUTF8 = WideStringToUTF8(pwszQuery, localBuffer, 1024);
+   DBDRV_UNBUFFERED_RESULT result = DrvSelectUnbufferedUTF8(pConn, queryUTF8, pdwError, errorText);
+   FreeConvertedString(queryUTF8, localBuffer);
+   return result;
+}
+
 /**
  * Perform unbuffered SELECT query using prepared statement
  */
@@ -1276,10 +1307,11 @@ extern "C" int __EXPORT DrvIsTableExist(MYSQL_CONN *conn, const WCHAR *name)
    if (conn == nullptr)
       return DBIsTableExist_Failure;
 
-   WCHAR query[256], lname[256];
+   WCHAR lname[256];
    wcsncpy(lname, name, 256);
    wcslwr(lname);
-   swprintf(query, 256, L"SHOW TABLES LIKE '%ls'", lname);
+   char query[256];
+   snprintf(query, 256, "SHOW TABLES LIKE '%ls'", lname);
    DWORD error;
    WCHAR errorText[DBDRV_MAX_ERROR_TEXT];
    int rc = DBIsTableExist_Failure;
@@ -638,16 +638,14 @@ static bool UnsafeDrvQuery(PG_CONN *pConn, const char *szQuery, WCHAR *errorText
 }
 
 /**
- * Perform non-SELECT query
+ * Perform non-SELECT query (query in UTF-8)
  */
-extern "C" DWORD __EXPORT DrvQuery(PG_CONN *pConn, WCHAR *pwszQuery, WCHAR *errorText)
+extern "C" DWORD __EXPORT DrvQueryUTF8(PG_CONN *pConn, const char *query, WCHAR *errorText)
 {
 	DWORD dwRet;
 
-	char localBuffer[1024];
-   char *pszQueryUTF8 = WideStringToUTF8(pwszQuery, localBuffer, 1024);
 	MutexLock(pConn->mutexQueryLock);
-	if (UnsafeDrvQuery(pConn, pszQueryUTF8, errorText))
+	if (UnsafeDrvQuery(pConn, query, errorText))
    {
       dwRet = DBERR_SUCCESS;
    }
@@ -656,11 +654,22 @@ extern "C" DWORD __EXPORT DrvQuery(PG_CONN *pConn, WCHAR *pwszQuery, WCHAR *erro
       dwRet = (PQstatus(pConn->handle) == CONNECTION_BAD) ? DBERR_CONNECTION_LOST : DBERR_OTHER_ERROR;
    }
 	MutexUnlock(pConn->mutexQueryLock);
-   FreeConvertedString(pszQueryUTF8, localBuffer);
 
 	return dwRet;
 }
 
+/**
+ * Perform non-SELECT query
+ */
+extern "C" DWORD __EXPORT DrvQuery(PG_CONN *pConn, WCHAR *pwszQuery, WCHAR *errorText)
+{
+	char localBuffer[1024];
+   char *pszQueryUTF8 = WideStringToUTF8(pwszQuery, localBuffer, 1024);
+   DWORD dwRet = DrvQueryUTF8(pConn, pszQueryUTF8, errorText);
+   FreeConvertedString(pszQueryUTF8, localBuffer);
+	return dwRet;
+}
+
 /**
  * Perform SELECT query - internal implementation
  */
@@ -708,14 +717,12 @@ static DBDRV_RESULT UnsafeDrvSelect(PG_CONN *conn, const char *query, WCHAR *err
 }
 
 /**
- * Perform SELECT query
+ * Perform SELECT query (query in UTF-8)
  */
-extern "C" DBDRV_RESULT __EXPORT DrvSelect(PG_CONN *pConn, WCHAR *query, DWORD *pdwError, WCHAR *errorText)
+extern "C" DBDRV_RESULT __EXPORT DrvSelectUTF8(PG_CONN *pConn, const char *query, DWORD *pdwError, WCHAR *errorText)
 {
-   char localBuffer[1024];
-   char *queryUTF8 = WideStringToUTF8(query, localBuffer, 1024);
 	MutexLock(pConn->mutexQueryLock);
-	DBDRV_RESULT pResult = UnsafeDrvSelect(pConn, queryUTF8, errorText);
+	DBDRV_RESULT pResult = UnsafeDrvSelect(pConn, query, errorText);
    if (pResult != nullptr)
    {
       *pdwError = DBERR_SUCCESS;
@@ -725,6 +732,17 @@ extern "C" DBDRV_RESULT __EXPORT DrvSelect(PG_CONN *pConn, WCHAR *query, DWORD *
       *pdwError = (PQstatus(pConn->handle) == CONNECTION_BAD) ? DBERR_CONNECTION_LOST : DBERR_OTHER_ERROR;
    }
 	MutexUnlock(pConn->mutexQueryLock);
+   return pResult;
+}
+
+/**
+ * Perform SELECT query
+ */
+extern "C" DBDRV_RESULT __EXPORT DrvSelect(PG_CONN *pConn, WCHAR *query, DWORD *pdwError, WCHAR *errorText)
+{
+   char localBuffer[1024];
+   char *queryUTF8 = WideStringToUTF8(query, localBuffer, 1024);
+   DBDRV_RESULT pResult = DrvSelectUTF8(pConn, queryUTF8, pdwError, errorText);
    FreeConvertedString(queryUTF8, localBuffer);
    return pResult;
 }
@@ -883,9 +901,9 @@ extern "C" void __EXPORT DrvFreeResult(DBDRV_RESULT result)
 }
 
 /**
- * Perform unbuffered SELECT query
+ * Perform unbuffered SELECT query (query in UTF-8)
  */
-extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(PG_CONN *pConn, WCHAR *pwszQuery, DWORD *pdwError, WCHAR *errorText)
+extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbufferedUTF8(PG_CONN *pConn, const char *queryUTF8, DWORD *pdwError, WCHAR *errorText)
 {
 	if (pConn == NULL)
 		return NULL;
@@ -900,8 +918,6 @@ extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(PG_CONN *pConn,
 	bool success = false;
 	bool retry;
 	int retryCount = 60;
-	char localBuffer[1024];
-   char *queryUTF8 = WideStringToUTF8(pwszQuery, localBuffer, 1024);
    do
    {
       retry = false;
@@ -975,7 +991,6 @@ extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(PG_CONN *pConn,
       }
    }
    while(retry);
-   FreeConvertedString(queryUTF8, localBuffer);
 
    if (!success)
    {
@@ -985,6 +1000,18 @@ extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(PG_CONN *pConn,
    return (DBDRV_UNBUFFERED_RESULT)result;
 }
 
+/**
+ * Perform unbuffered SELECT query
+ */
+extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(PG_CONN *pConn, WCHAR *pwszQuery, DWORD *pdwError, WCHAR *errorText)
+{
+	char localBuffer[1024];
+   char *queryUTF8 = WideStringToUTF8(pwszQuery, localBuffer, 1024);
+   DBDRV_UNBUFFERED_RESULT result = DrvSelectUnbufferedUTF8(pConn, queryUTF8, pdwError, errorText);
+   FreeConvertedString(queryUTF8, localBuffer);
+   return result;
+}
+
 /**
  * Perform unbuffered SELECT query using prepared statement
  */
@@ -1329,6 +1356,189 @@ extern "C" int __EXPORT DrvIsTableExist(PG_CONN *pConn, const WCHAR *name)
    return rc;
 }
 
+/**
+ * Size of buffered data which will cause bulk load data to be sent to server
+ */
+#define BULK_LOAD_FLUSH_THRESHOLD   65536
+
+/**
+ * Set error text from libpq error message
+ */
+static void SetCopyErrorText(PG_CONN *pConn, PGresult *result, WCHAR *errorText)
+{
+   if (errorText == nullptr)
+      return;
+
+   const char *sqlState = (result != nullptr) ? PQresultErrorField(result, PG_DIAG_SQLSTATE) : nullptr;
+   utf8_to_wchar(CHECK_NULL_EX_A(sqlState), -1, errorText, DBDRV_MAX_ERROR_TEXT);
+   int len = (int)wcslen(errorText);
+   if (len > 0)
+   {
+      errorText[len] = L' ';
+      len++;
+   }
+   utf8_to_wchar(PQerrorMessage(pConn->handle), -1, &errorText[len], DBDRV_MAX_ERROR_TEXT - len);
+   errorText[DBDRV_MAX_ERROR_TEXT - 1] = 0;
+   RemoveTrailingCRLFW(errorText);
+}
+
+/**
+ * Start bulk load using COPY FROM STDIN. Connection remains locked until bulk load is completed.
+ */
+extern "C" DBDRV_BULK_LOAD __EXPORT DrvBulkLoadBegin(PG_CONN *pConn, const WCHAR *table, const WCHAR *columns, int numColumns, DWORD *errorCode, WCHAR *errorText)
+{
+   if (pConn == nullptr)
+   {
+      *errorCode = DBERR_INVALID_HANDLE;
+      return nullptr;
+   }
+
+   char query[1024];
+   snprintf(query, 1024, "COPY %ls (%ls) FROM STDIN", table, columns);
+
+   MutexLock(pConn->mutexQueryLock);
+   PGresult *result = PQexec(pConn->handle, query);
+   if (PQresultStatus(result) != PGRES_COPY_IN)
+   {
+      SetCopyErrorText(pConn, result, errorText);
+      PQclear(result);
+      *errorCode = (PQstatus(pConn->handle) == CONNECTION_BAD) ? DBERR_CONNECTION_LOST : DBERR_OTHER_ERROR;
+      MutexUnlock(pConn->mutexQueryLock);
+      return nullptr;
+   }
+   PQclear(result);
+
+   PG_BULK_LOAD *hLoad = MemAllocStruct<PG_BULK_LOAD>();
+   hLoad->connection = pConn;
+   hLoad->numColumns = numColumns;
+   hLoad->allocated = BULK_LOAD_FLUSH_THRESHOLD + 4096;
+   hLoad->buffer = MemAllocArrayNoInit<char>(hLoad->allocated);
+   hLoad->size = 0;
+   *errorCode = DBERR_SUCCESS;
+   return hLoad;
+}
+
+/**
+ * Send buffered bulk load data to server
+ */
+static bool FlushBulkLoadBuffer(PG_BULK_LOAD *hLoad, WCHAR *errorText)
+{
+   if (hLoad->size == 0)
+      return true;
+
+   if (PQputCopyData(hLoad->connection->handle, hLoad->buffer, static_cast<int>(hLoad->size)) != 1)
+   {
+      SetCopyErrorText(hLoad->connection, nullptr, errorText);
+      return false;
+   }
+   hLoad->size = 0;
+   return true;
+}
+
+/**
+ * Add row to bulk load. Values are encoded in COPY text format.
+ */
+extern "C" DWORD __EXPORT DrvBulkLoadAddRow(PG_BULK_LOAD *hLoad, const WCHAR **values, WCHAR *errorText)
+{
+   for(int i = 0; i < hLoad->numColumns; i++)
+   {
+      const WCHAR *value = values[i];
+      if (value == nullptr)
+      {
+         if (hLoad->allocated - hLoad->size < 4)
+         {
+            hLoad->allocated += 4096;
+            hLoad->buffer = MemRealloc(hLoad->buffer, hLoad->allocated);
+         }
+         memcpy(&hLoad->buffer[hLoad->size], "\\N\t", 3);
+         hLoad->size += 3;
+         continue;
+      }
+
+      char localBuffer[1024];
+      char *utf8Value = WideStringToUTF8(value, localBuffer, 1024);
+      size_t len = strlen(utf8Value);
+      if (hLoad->allocated - hLoad->size < len * 2 + 2)
+      {
+         hLoad->allocated += std::max(len * 2 + 2, static_cast<size_t>(4096));
+         hLoad->buffer = MemRealloc(hLoad->buffer, hLoad->allocated);
+      }
+
+      char *out = &hLoad->buffer[hLoad->size];
+      for(const char *p = utf8Value; *p != 0; p++)
+      {
+         switch(*p)
+         {
+            case '\\':
+               *out++ = '\\';
+               *out++ = '\\';
+               break;
+            case '\t':
+               *out++ = '\\';
+               *out++ = 't';
+               break;
+            case '\n':
+               *out++ = '\\';
+               *out++ = 'n';
+               break;
+            case '\r':
+               *out++ = '\\';
+               *out++ = 'r';
+               break;
+            default:
+               *out++ = *p;
+               break;
+         }
+      }
+      *out++ = '\t';
+      hLoad->size = out - hLoad->buffer;
+      FreeConvertedString(utf8Value, localBuffer);
+   }
+
+   // Replace last column separator with row separator
+   if (hLoad->numColumns > 0)
+      hLoad->buffer[hLoad->size - 1] = '\n';
+
+   if ((hLoad->size >= BULK_LOAD_FLUSH_THRESHOLD) && !FlushBulkLoadBuffer(hLoad, errorText))
+      return (PQstatus(hLoad->connection->handle) == CONNECTION_BAD) ? DBERR_CONNECTION_LOST : DBERR_OTHER_ERROR;
+   return DBERR_SUCCESS;
+}
+
+/**
+ * Complete or cancel bulk load. Bulk load handle is destroyed and connection is unlocked.
+ */
+extern "C" DWORD __EXPORT DrvBulkLoadEnd(PG_BULK_LOAD *hLoad, bool commit, WCHAR *errorText)
+{
+   PG_CONN *pConn = hLoad->connection;
+   bool success = commit ? FlushBulkLoadBuffer(hLoad, errorText) : false;
+   if (PQputCopyEnd(pConn->handle, success ? nullptr : "bulk load cancelled") == 1)
+   {
+      PGresult *result;
+      bool first = true;
+      while((result = PQgetResult(pConn->handle)) != nullptr)
+      {
+         if (first && success && (PQresultStatus(result) != PGRES_COMMAND_OK))
+         {
+            SetCopyErrorText(pConn, result, errorText);
+            success = false;
+         }
+         first = false;
+         PQclear(result);
+      }
+   }
+   else if (success)
+   {
+      SetCopyErrorText(pConn, nullptr, errorText);
+      success = false;
+   }
+
+   DWORD rc = success ? DBERR_SUCCESS : ((PQstatus(pConn->handle) == CONNECTION_BAD) ? DBERR_CONNECTION_LOST : DBERR_OTHER_ERROR);
+   MutexUnlock(pConn->mutexQueryLock);
+   MemFree(hLoad->buffer);
+   MemFree(hLoad);
+   return rc;
+}
+
 #ifdef _WIN32
 
 /**
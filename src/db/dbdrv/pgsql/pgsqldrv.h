@@ -79,4 +79,16 @@ typedef struct
    int currRow;
 } PG_UNBUFFERED_RESULT;
 
+/**
+ * Bulk load (COPY FROM STDIN) operation
+ */
+typedef struct
+{
+   PG_CONN *connection;
+   int numColumns;
+   char *buffer;
+   size_t size;
+   size_t allocated;
+} PG_BULK_LOAD;
+
 #endif   /* _pgsqldrv_h_ */
@@ -343,6 +343,14 @@ extern "C" DWORD __EXPORT DrvQuery(SQLITE_CONN *conn, WCHAR *query, WCHAR *error
    return rc;
 }
 
+/**
+ * Perform non-SELECT query (query in UTF-8)
+ */
+extern "C" DWORD __EXPORT DrvQueryUTF8(SQLITE_CONN *conn, const char *query, WCHAR *errorText)
+{
+   return DrvQueryInternal(conn, query, errorText);
+}
+
 /**
  * SELECT callback
  */
@@ -411,10 +419,8 @@ extern "C" void __EXPORT DrvFreeResult(SQLITE_RESULT *hResult)
 /**
  * Perform SELECT query - actual implementation
  */
-static SQLITE_RESULT *DrvSelectInternal(SQLITE_CONN *conn, const WCHAR *query, uint32_t *errorCode, WCHAR *errorText)
+static SQLITE_RESULT *DrvSelectInternal(SQLITE_CONN *conn, const char *queryUTF8, uint32_t *errorCode, WCHAR *errorText)
 {
-   char *queryUTF8 = UTF8StringFromWideString(query);
-
    SQLITE_RESULT *result = MemAllocStruct<SQLITE_RESULT>();
 
 	MutexLock(conn->mutexQueryLock);
@@ -434,7 +440,6 @@ static SQLITE_RESULT *DrvSelectInternal(SQLITE_CONN *conn, const WCHAR *query, u
    }
    MutexUnlock(conn->mutexQueryLock);
 
-	MemFree(queryUTF8);
    *errorCode = (result != NULL) ? DBERR_SUCCESS : DBERR_OTHER_ERROR;
    return result;
 }
@@ -443,6 +448,17 @@ static SQLITE_RESULT *DrvSelectInternal(SQLITE_CONN *conn, const WCHAR *query, u
  * Perform SELECT query - public entry point
  */
 extern "C" DBDRV_RESULT __EXPORT DrvSelect(SQLITE_CONN *conn, WCHAR *query, uint32_t *errorCode, WCHAR *errorText)
+{
+   char *queryUTF8 = UTF8StringFromWideString(query);
+   SQLITE_RESULT *result = DrvSelectInternal(conn, queryUTF8, errorCode, errorText);
+   MemFree(queryUTF8);
+   return result;
+}
+
+/**
+ * Perform SELECT query (query in UTF-8)
+ */
+extern "C" DBDRV_RESULT __EXPORT DrvSelectUTF8(SQLITE_CONN *conn, const char *query, uint32_t *errorCode, WCHAR *errorText)
 {
    return DrvSelectInternal(conn, query, errorCode, errorText);
 }
@@ -591,14 +607,13 @@ extern "C" const char __EXPORT *DrvGetColumnName(SQLITE_RESULT *hResult, int col
 }
 
 /**
- * Perform unbuffered SELECT query
+ * Perform unbuffered SELECT query (query in UTF-8)
  */
-extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(SQLITE_CONN *hConn, WCHAR *pwszQuery, DWORD *pdwError, WCHAR *errorText)
+extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbufferedUTF8(SQLITE_CONN *hConn, const char *pszQueryUTF8, DWORD *pdwError, WCHAR *errorText)
 {
    SQLITE_UNBUFFERED_RESULT *result;
    sqlite3_stmt *stmt;
 
-   char *pszQueryUTF8 = UTF8StringFromWideString(pwszQuery);
    MutexLock(hConn->mutexQueryLock);
 retry:
    int rc = sqlite3_prepare(hConn->pdb, pszQueryUTF8, -1, &stmt, nullptr);
@@ -624,7 +639,17 @@ extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(SQLITE_CONN *hCo
       result = nullptr;
 		*pdwError = DBERR_OTHER_ERROR;
    }
-   MemFree(pszQueryUTF8);
+   return result;
+}
+
+/**
+ * Perform unbuffered SELECT query
+ */
+extern "C" DBDRV_UNBUFFERED_RESULT __EXPORT DrvSelectUnbuffered(SQLITE_CONN *hConn, WCHAR *pwszQuery, DWORD *pdwError, WCHAR *errorText)
+{
+   char *queryUTF8 = UTF8StringFromWideString(pwszQuery);
+   DBDRV_UNBUFFERED_RESULT result = DrvSelectUnbufferedUTF8(hConn, queryUTF8, pdwError, errorText);
+   MemFree(queryUTF8);
    return result;
 }
 
@@ -797,14 +822,8 @@ extern "C" int __EXPORT DrvIsTableExist(SQLITE_CONN *conn, const WCHAR *name)
    if (conn == nullptr)
       return DBIsTableExist_Failure;
 
-   WCHAR query[256];
-#if HAVE_SWPRINTF
-   swprintf(query, 256, L"SELECT count(*) FROM sqlite_master WHERE type='table' AND upper(name)=upper('%ls')", name);
-#else
-   wcscpy(query, L"SELECT count(*) FROM sqlite_master WHERE type='table' AND upper(name)=upper('");
-   wcscat(query, name);
-   wcscat(query, L"')");
-#endif
+   char query[256];
+   snprintf(query, 256, "SELECT count(*) FROM sqlite_master WHERE type='table' AND upper(name)=upper('%ls')", name);
    uint32_t error;
    int rc = DBIsTableExist_Failure;
    SQLITE_RESULT *hResult = DrvSelectInternal(conn, query, &error, nullptr);
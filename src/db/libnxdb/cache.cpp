@@ -57,22 +57,11 @@ void LIBNXDB_EXPORTABLE DBCloseInMemoryDatabase(DB_HANDLE hdb)
 }
 
 /**
- * Cache table
+ * Create table in cache database and prepare insert statement for it using column list from source query result
  */
-bool LIBNXDB_EXPORTABLE DBCacheTable(DB_HANDLE cacheDB, DB_HANDLE sourceDB, const TCHAR *table, const TCHAR *indexColumn,
-         const TCHAR *columns, const TCHAR * const *intColumns)
+template<typename R> static DB_STATEMENT PrepareCacheTable(DB_HANDLE cacheDB, R hResult, const TCHAR *table, const TCHAR *indexColumn,
+         const TCHAR * const *intColumns, int *numColumns)
 {
-   TCHAR query[1024];
-   _sntprintf(query, 1024, _T("SELECT %s FROM %s"), columns, table);
-
-   TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
-   DB_UNBUFFERED_RESULT hResult = DBSelectUnbufferedEx(sourceDB, query, errorText);
-   if (hResult == nullptr)
-   {
-      nxlog_debug_tag(DEBUG_TAG, 4, _T("Cannot read table %s for caching: %s"), table, errorText);
-      return false;
-   }
-
    StringBuffer createStatement = _T("CREATE TABLE ");
    createStatement.append(table);
    createStatement.append(_T(" ("));
@@ -81,15 +70,14 @@ bool LIBNXDB_EXPORTABLE DBCacheTable(DB_HANDLE cacheDB, DB_HANDLE sourceDB, cons
    insertStatement.append(table);
    insertStatement.append(_T(" ("));
 
-   int numColumns = DBGetColumnCount(hResult);
-   for(int i = 0; i < numColumns; i++)
+   *numColumns = DBGetColumnCount(hResult);
+   for(int i = 0; i < *numColumns; i++)
    {
       TCHAR name[256];
       if (!DBGetColumnName(hResult, i, name, 256))
       {
-         DBFreeResult(hResult);
          nxlog_debug_tag(DEBUG_TAG, 4, _T("Cannot get name of column %d of table %s"), i, table);
-         return false;
+         return nullptr;
       }
       if (i > 0)
       {
@@ -123,24 +111,47 @@ bool LIBNXDB_EXPORTABLE DBCacheTable(DB_HANDLE cacheDB, DB_HANDLE sourceDB, cons
       createStatement.append(_T(')'));
    }
 
+   TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
    if (!DBQueryEx(cacheDB, createStatement, errorText))
    {
-      DBFreeResult(hResult);
       nxlog_debug_tag(DEBUG_TAG, 4, _T("Cannot create table %s in cache database: %s"), table, errorText);
-      return false;
+      return nullptr;
    }
 
    insertStatement.append(_T(") VALUES ("));
-   for(int i = 0; i < numColumns; i++)
+   for(int i = 0; i < *numColumns; i++)
       insertStatement.append(_T("?,"));
    insertStatement.shrink();
    insertStatement.append(_T(')'));
 
    DB_STATEMENT hInsertStmt = DBPrepareEx(cacheDB, insertStatement, true, errorText);
+   if (hInsertStmt == nullptr)
+      nxlog_debug_tag(DEBUG_TAG, 4, _T("Cannot prepare insert statement for table %s in cache database: %s"), table, errorText);
+   return hInsertStmt;
+}
+
+/**
+ * Cache table
+ */
+bool LIBNXDB_EXPORTABLE DBCacheTable(DB_HANDLE cacheDB, DB_HANDLE sourceDB, const TCHAR *table, const TCHAR *indexColumn,
+         const TCHAR *columns, const TCHAR * const *intColumns)
+{
+   TCHAR query[1024];
+   _sntprintf(query, 1024, _T("SELECT %s FROM %s"), columns, table);
+
+   TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
+   DB_UNBUFFERED_RESULT hResult = DBSelectUnbufferedEx(sourceDB, query, errorText);
+   if (hResult == nullptr)
+   {
+      nxlog_debug_tag(DEBUG_TAG, 4, _T("Cannot read table %s for caching: %s"), table, errorText);
+      return false;
+   }
+
+   int numColumns;
+   DB_STATEMENT hInsertStmt = PrepareCacheTable(cacheDB, hResult, table, indexColumn, intColumns, &numColumns);
    if (hInsertStmt == nullptr)
    {
       DBFreeResult(hResult);
-      nxlog_debug_tag(DEBUG_TAG, 4, _T("Cannot prepare insert statement for table %s in cache database: %s"), table, errorText);
       return false;
    }
 
@@ -165,3 +176,90 @@ bool LIBNXDB_EXPORTABLE DBCacheTable(DB_HANDLE cacheDB, DB_HANDLE sourceDB, cons
    DBFreeResult(hResult);
    return true;
 }
+
+/**
+ * Number of rows read from source table before they are inserted into cache database
+ */
+#define CACHE_INSERT_CHUNK_SIZE  1024
+
+/**
+ * Cache table from one of several concurrently used source connections. Source table is read using
+ * unbuffered query in chunks of rows, and cache lock is held only while inserting each chunk into
+ * cache database, so neither full source table is kept in memory nor other threads are blocked for
+ * the duration of entire read.
+ */
+bool LIBNXDB_EXPORTABLE DBCacheTable(DB_HANDLE cacheDB, Mutex *cacheLock, DB_HANDLE sourceDB, const TCHAR *table, const TCHAR *indexColumn,
+         const TCHAR *columns, const TCHAR * const *intColumns)
+{
+   TCHAR query[1024];
+   _sntprintf(query, 1024, _T("SELECT %s FROM %s"), columns, table);
+
+   TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
+   DB_UNBUFFERED_RESULT hResult = DBSelectUnbufferedEx(sourceDB, query, errorText);
+   if (hResult == nullptr)
+   {
+      nxlog_debug_tag(DEBUG_TAG, 4, _T("Cannot read table %s for caching: %s"), table, errorText);
+      return false;
+   }
+
+   int numColumns;
+   cacheLock->lock();
+   DB_STATEMENT hInsertStmt = PrepareCacheTable(cacheDB, hResult, table, indexColumn, intColumns, &numColumns);
+   cacheLock->unlock();
+   if (hInsertStmt == nullptr)
+   {
+      DBFreeResult(hResult);
+      return false;
+   }
+
+   TCHAR **chunk = MemAllocArrayNoInit<TCHAR*>(CACHE_INSERT_CHUNK_SIZE * numColumns);
+   bool success = true;
+   bool hasMoreRows = true;
+   while(success && hasMoreRows)
+   {
+      int numRows = 0;
+      while((numRows < CACHE_INSERT_CHUNK_SIZE) && (hasMoreRows = DBFetch(hResult)))
+      {
+         TCHAR **values = &chunk[numRows * numColumns];
+         for(int i = 0; i < numColumns; i++)
+            values[i] = DBGetField(hResult, i, nullptr, 0);
+         numRows++;
+      }
+      if (numRows == 0)
+         break;
+
+      cacheLock->lock();
+      DBBegin(cacheDB);
+      int row;
+      for(row = 0; row < numRows; row++)
+      {
+         // Statement takes ownership of bound values
+         TCHAR **values = &chunk[row * numColumns];
+         for(int i = 0; i < numColumns; i++)
+            DBBind(hInsertStmt, i + 1, DB_SQLTYPE_VARCHAR, values[i], DB_BIND_DYNAMIC);
+         if (!DBExecuteEx(hInsertStmt, errorText))
+         {
+            nxlog_debug_tag(DEBUG_TAG, 4, _T("Cannot execute insert statement for table %s in cache database: %s"), table, errorText);
+            success = false;
+            break;
+         }
+      }
+      if (success)
+         DBCommit(cacheDB);
+      else
+         DBRollback(cacheDB);
+      cacheLock->unlock();
+
+      // Free values that were not bound because of failure
+      for(int i = (row + 1) * numColumns; i < numRows * numColumns; i++)
+         MemFree(chunk[i]);
+   }
+   MemFree(chunk);
+
+   cacheLock->lock();
+   DBFreeStatement(hInsertStmt);
+   cacheLock->unlock();
+
+   DBFreeResult(hResult);
+   return success;
+}
@@ -23,6 +23,46 @@
 
 #include "libnxdb.h"
 
+#define DEBUG_TAG _T("db.cpool")
+
+/**
+ * Size of call site statistics table
+ */
+#define MAX_CALL_SITES     1024
+
+/**
+ * Acquire call site statistics
+ */
+struct CallSite
+{
+   const char *file;
+   int line;
+   uint64_t histogram[DBCP_ACQUIRE_HISTOGRAM_SIZE];
+};
+
+/**
+ * Pooled connection
+ */
+struct PoolConnection
+{
+   PoolConnectionInfo info;
+   PoolConnection *prev;   // Previous element in free list
+   PoolConnection *next;   // Next element in free list
+   int slot;
+   uint32_t serial;
+   CallSite *callSite;
+};
+
+/**
+ * Thread waiting for connection
+ */
+struct PoolWaiter
+{
+   CONDITION wakeup;
+   PoolConnection *connection;
+   PoolWaiter *next;
+};
+
 static bool s_initialized = false;
 static DB_DRIVER m_driver;
 static TCHAR m_server[256];
@@ -35,45 +75,166 @@ static int m_basePoolSize;
 static int m_maxPoolSize;
 static int m_cooldownTime;
 static int m_connectionTTL;
+static bool m_threadAffinity;
 
 static MUTEX m_poolAccessMutex = INVALID_MUTEX_HANDLE;
-static ObjectArray<PoolConnectionInfo> m_connections;
+static PoolConnection **m_slots = nullptr;
+static int m_slotCount = 0;
+static int m_poolSize = 0;    // Number of connections, including ones being established
+static int m_freeCount = 0;
+static PoolConnection *m_freeListHead = nullptr;   // Most recently released connection
+static PoolConnection *m_freeListTail = nullptr;   // Least recently released connection
+static PoolWaiter *m_waitersHead = nullptr;
+static PoolWaiter *m_waitersTail = nullptr;
+static uint32_t m_serial = 0;
+static CallSite m_callSites[MAX_CALL_SITES];
 static THREAD m_maintThread = INVALID_THREAD_HANDLE;
 static CONDITION m_condShutdown = INVALID_CONDITION_HANDLE;
-static CONDITION m_condRelease = INVALID_CONDITION_HANDLE;
 
-#define DEBUG_TAG _T("db.cpool")
+#if HAVE_THREAD_LOCAL_STORAGE
+static thread_local int s_affineSlot = -1;
+static thread_local uint32_t s_affineSerial = 0;
+#endif
+
+/**
+ * Remove connection from free list. Pool lock must be held.
+ */
+static inline void FreeListRemove(PoolConnection *conn)
+{
+   if (conn->prev != nullptr)
+      conn->prev->next = conn->next;
+   else
+      m_freeListHead = conn->next;
+   if (conn->next != nullptr)
+      conn->next->prev = conn->prev;
+   else
+      m_freeListTail = conn->prev;
+   conn->prev = nullptr;
+   conn->next = nullptr;
+   conn->info.inUse = true;
+   m_freeCount--;
+}
+
+/**
+ * Put connection at the head of free list. Pool lock must be held.
+ */
+static inline void FreeListPush(PoolConnection *conn)
+{
+   conn->prev = nullptr;
+   conn->next = m_freeListHead;
+   if (m_freeListHead != nullptr)
+      m_freeListHead->prev = conn;
+   else
+      m_freeListTail = conn;
+   m_freeListHead = conn;
+   conn->info.inUse = false;
+   m_freeCount++;
+}
+
+/**
+ * Return connection to the pool - either hand it over to first waiting thread or put it into free list. Pool lock must be held.
+ */
+static void ReturnConnection(PoolConnection *conn)
+{
+   if (m_waitersHead != nullptr)
+   {
+      PoolWaiter *waiter = m_waitersHead;
+      m_waitersHead = waiter->next;
+      if (m_waitersHead == nullptr)
+         m_waitersTail = nullptr;
+      waiter->connection = conn;
+      ConditionSet(waiter->wakeup);  // should be called under lock because waiter may destroy condition as soon as it sees connection
+   }
+   else
+   {
+      FreeListPush(conn);
+   }
+}
+
+/**
+ * Create new pool connection object and reserve slot for it. Pool lock must be held.
+ */
+static PoolConnection *CreatePoolConnection()
+{
+   int slot;
+   for(slot = 0; slot < m_slotCount; slot++)
+      if (m_slots[slot] == nullptr)
+         break;
+   if (slot == m_slotCount)
+      return nullptr;
+
+   PoolConnection *conn = MemAllocStruct<PoolConnection>();
+   conn->slot = slot;
+   conn->serial = ++m_serial;
+   conn->info.inUse = true;
+   m_slots[slot] = conn;
+   m_poolSize++;
+   return conn;
+}
+
+/**
+ * Remove connection from pool. Pool lock must be held. Connection object should be destroyed by caller.
+ */
+static void DetachConnection(PoolConnection *conn)
+{
+   m_slots[conn->slot] = nullptr;
+   m_poolSize--;
+
+   // Reserve new connection for first waiting thread so it keeps its place in the queue.
+   // Reserved connection is not open yet (handle is null) and should be opened by waiter.
+   if (m_waitersHead != nullptr)
+   {
+      PoolWaiter *waiter = m_waitersHead;
+      m_waitersHead = waiter->next;
+      if (m_waitersHead == nullptr)
+         m_waitersTail = nullptr;
+      waiter->connection = CreatePoolConnection();
+      ConditionSet(waiter->wakeup);
+   }
+}
+
+/**
+ * Open database connection for pool connection object. Should be called without pool lock.
+ */
+static bool OpenConnection(PoolConnection *conn)
+{
+   TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
+   conn->info.handle = DBConnect(m_driver, m_server, m_dbName, m_login, m_password, m_schema, errorText);
+   if (conn->info.handle == nullptr)
+   {
+      nxlog_debug_tag(DEBUG_TAG, 3, _T("Cannot create DB connection (%s)"), errorText);
+      return false;
+   }
+
+   conn->info.handle->m_poolConnection = conn;
+   conn->info.resetOnRelease = false;
+   conn->info.connectTime = time(nullptr);
+   conn->info.lastAccessTime = conn->info.connectTime;
+   conn->info.usageCount = 0;
+   nxlog_debug_tag(DEBUG_TAG, 3, _T("Connection %p created"), conn);
+   return true;
+}
 
 /**
  * Create connections on pool initialization
  */
 static bool DBConnectionPoolPopulate()
 {
-	TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
 	bool success = false;
 
 	MutexLock(m_poolAccessMutex);
 	for(int i = 0; i < m_basePoolSize; i++)
 	{
-      PoolConnectionInfo *conn = new PoolConnectionInfo;
-      conn->handle = DBConnect(m_driver, m_server, m_dbName, m_login, m_password, m_schema, errorText);
-      if (conn->handle != NULL)
+      PoolConnection *conn = CreatePoolConnection();
+      if (OpenConnection(conn))
       {
-         conn->inUse = false;
-         conn->resetOnRelease = false;
-         conn->connectTime = time(NULL);
-         conn->lastAccessTime = conn->connectTime;
-         conn->usageCount = 0;
-         conn->srcFile[0] = 0;
-         conn->srcLine = 0;
-         m_connections.add(conn);
-         nxlog_debug_tag(DEBUG_TAG, 3, _T("Connection %p created"), conn);
+         FreeListPush(conn);
          success = true;
       }
       else
       {
-         nxlog_debug_tag(DEBUG_TAG, 3, _T("Cannot create DB connection %d (%s)"), i, errorText);
-         delete conn;
+         DetachConnection(conn);
+         MemFree(conn);
       }
 	}
 	MutexUnlock(m_poolAccessMutex);
@@ -85,39 +246,49 @@ static bool DBConnectionPoolPopulate()
  */
 static void DBConnectionPoolShrink()
 {
+   ObjectArray<PoolConnection> closeList(16, 16, Ownership::False);
+
 	MutexLock(m_poolAccessMutex);
 
-   time_t now = time(NULL);
-   for(int i = m_basePoolSize; i < m_connections.size(); i++)
+   // Free list is ordered by release time, so least recently used connections are at the tail
+   time_t now = time(nullptr);
+   PoolConnection *conn = m_freeListTail;
+   while((conn != nullptr) && (m_poolSize > m_basePoolSize) && (now - conn->info.lastAccessTime > m_cooldownTime))
 	{
-      PoolConnectionInfo *conn = m_connections.get(i);
-		if (!conn->inUse && (now - conn->lastAccessTime > m_cooldownTime))
-		{
-			DBDisconnect(conn->handle);
-	      nxlog_debug_tag(DEBUG_TAG, 3, _T("Connection %p terminated"), conn);
-         m_connections.remove(i);
-         i--;
-		}
+      PoolConnection *prev = conn->prev;
+      FreeListRemove(conn);
+      DetachConnection(conn);
+      closeList.add(conn);
+      conn = prev;
 	}
 
 	MutexUnlock(m_poolAccessMutex);
+
+   for(int i = 0; i < closeList.size(); i++)
+   {
+      conn = closeList.get(i);
+      DBDisconnect(conn->info.handle);
+      nxlog_debug_tag(DEBUG_TAG, 3, _T("Connection %p terminated"), conn);
+      MemFree(conn);
+   }
 }
 
 /*
- * Reset connection
+ * Reset connection. Should be called without pool lock on connection marked as used.
  */
-static bool ResetConnection(PoolConnectionInfo *conn)
+static bool ResetConnection(PoolConnection *conn)
 {
-	time_t now = time(NULL);
-	DBDisconnect(conn->handle);
+	time_t now = time(nullptr);
+	DBDisconnect(conn->info.handle);
 
 	TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
-	conn->handle = DBConnect(m_driver, m_server, m_dbName, m_login, m_password, m_schema, errorText);
-	if (conn->handle != NULL)
+	conn->info.handle = DBConnect(m_driver, m_server, m_dbName, m_login, m_password, m_schema, errorText);
+	if (conn->info.handle != nullptr)
    {
-		conn->connectTime = now;
-		conn->lastAccessTime = now;
-		conn->usageCount = 0;
+	   conn->info.handle->m_poolConnection = conn;
+		conn->info.connectTime = now;
+		conn->info.lastAccessTime = now;
+		conn->info.usageCount = 0;
 
 		nxlog_debug_tag(DEBUG_TAG, 3, _T("Connection %p reconnected"), conn);
 	}
@@ -125,16 +296,36 @@ static bool ResetConnection(PoolConnectionInfo *conn)
    {
 		nxlog_debug_tag(DEBUG_TAG, 3, _T("Connection %p reconnect failure (%s)"), conn, errorText);
 	}
-   conn->resetOnRelease = false;
-   return conn->handle != NULL;
+   conn->info.resetOnRelease = false;
+   return conn->info.handle != nullptr;
+}
+
+/**
+ * Reset given connections and return them to the pool
+ */
+static void ResetConnections(const ObjectArray<PoolConnection>& connections)
+{
+   for(int i = 0; i < connections.size(); i++)
+   {
+      PoolConnection *conn = connections.get(i);
+      bool success = ResetConnection(conn);
+      MutexLock(m_poolAccessMutex);
+      if (success)
+         ReturnConnection(conn);
+      else
+         DetachConnection(conn);
+      MutexUnlock(m_poolAccessMutex);
+      if (!success)
+         MemFree(conn);
+   }
 }
 
 /**
  * Callback for sorting reset list
  */
-static int ResetListSortCallback(const PoolConnectionInfo **e1, const PoolConnectionInfo **e2)
+static int ResetListSortCallback(const PoolConnection **e1, const PoolConnection **e2)
 {
-   return (*e1)->usageCount > (*e2)->usageCount ? -1 : ((*e1)->usageCount == (*e2)->usageCount ? 0 : 1);
+   return (*e1)->info.usageCount > (*e2)->info.usageCount ? -1 : ((*e1)->info.usageCount == (*e2)->info.usageCount ? 0 : 1);
 }
 
 /**
@@ -142,26 +333,18 @@ static int ResetListSortCallback(const PoolConnectionInfo **e1, const PoolConnec
  */
 static void ResetExpiredConnections()
 {
-   time_t now = time(NULL);
+   time_t now = time(nullptr);
 
    MutexLock(m_poolAccessMutex);
 
-	int i, availCount = 0;
-   ObjectArray<PoolConnectionInfo> reconnList(m_connections.size(), 16, Ownership::False);
-	for(i = 0; i < m_connections.size(); i++)
+   ObjectArray<PoolConnection> reconnList(m_freeCount + 1, 16, Ownership::False);
+   for(PoolConnection *conn = m_freeListHead; conn != nullptr; conn = conn->next)
 	{
-		PoolConnectionInfo *conn = m_connections.get(i);
-		if (!conn->inUse)
-      {
-         availCount++;
-         if (now - conn->connectTime > m_connectionTTL)
-         {
-            reconnList.add(conn);
-         }
-      }
+      if (now - conn->info.connectTime > m_connectionTTL)
+         reconnList.add(conn);
 	}
-	
-   int count = std::min(availCount / 2 + 1, reconnList.size()); // reset no more than 50% of available connections
+
+   int count = std::min(m_freeCount / 2 + 1, reconnList.size()); // reset no more than 50% of available connections
    if (count < reconnList.size())
    {
       reconnList.sort(ResetListSortCallback);
@@ -169,26 +352,11 @@ static void ResetExpiredConnections()
          reconnList.remove(count);
    }
 
-   for(i = 0; i < count; i++)
-      reconnList.get(i)->inUse = true;
+   for(int i = 0; i < count; i++)
+      FreeListRemove(reconnList.get(i));
    MutexUnlock(m_poolAccessMutex);
 
-   // do reconnects
-   for(i = 0; i < count; i++)
-	{
-   	PoolConnectionInfo *conn = reconnList.get(i);
-   	bool success = ResetConnection(conn);
-   	MutexLock(m_poolAccessMutex);
-		if (success)
-		{
-			conn->inUse = false;
-		}
-		else
-		{
-			m_connections.remove(conn);
-		}
-		MutexUnlock(m_poolAccessMutex);
-	}
+   ResetConnections(reconnList);
 }
 
 /**
@@ -218,7 +386,7 @@ static THREAD_RESULT THREAD_CALL MaintenanceThread(void *arg)
 bool LIBNXDB_EXPORTABLE DBConnectionPoolStartup(DB_DRIVER driver, const TCHAR *server, const TCHAR *dbName,
 																const TCHAR *login, const TCHAR *password, const TCHAR *schema,
 																int basePoolSize, int maxPoolSize, int cooldownTime,
-																int connTTL)
+																int connTTL, bool threadAffinity)
 {
    if (s_initialized)
       return true;   // already initialized
@@ -234,25 +402,31 @@ bool LIBNXDB_EXPORTABLE DBConnectionPoolStartup(DB_DRIVER driver, const TCHAR *s
 	m_maxPoolSize = maxPoolSize;
 	m_cooldownTime = cooldownTime;
    m_connectionTTL = connTTL;
-
-	m_poolAccessMutex = MutexCreate();
-   m_connections.setOwner(Ownership::True);
-   m_condShutdown = ConditionCreate(TRUE);
-   m_condRelease = ConditionCreate(FALSE);
+   m_threadAffinity = threadAffinity;
+
+	m_poolAccessMutex = MutexCreateFast();
+	m_slotCount = std::max(basePoolSize, maxPoolSize);
+	m_slots = MemAllocArray<PoolConnection*>(m_slotCount);
+	m_poolSize = 0;
+	m_freeCount = 0;
+	m_freeListHead = m_freeListTail = nullptr;
+	m_waitersHead = m_waitersTail = nullptr;
+	memset(m_callSites, 0, sizeof(m_callSites));
+   m_condShutdown = ConditionCreate(true);
 
 	if (!DBConnectionPoolPopulate())
 	{
 	   // cannot open at least one connection
 	   ConditionDestroy(m_condShutdown);
-	   ConditionDestroy(m_condRelease);
 	   MutexDestroy(m_poolAccessMutex);
+	   MemFreeAndNull(m_slots);
 	   return false;
 	}
 
-   m_maintThread = ThreadCreateEx(MaintenanceThread, 0, NULL);
+   m_maintThread = ThreadCreateEx(MaintenanceThread, 0, nullptr);
 
    s_initialized = true;
-	nxlog_debug_tag(DEBUG_TAG, 1, _T("Database Connection Pool initialized"));
+	nxlog_debug_tag(DEBUG_TAG, 1, _T("Database Connection Pool initialized (thread affinity %s)"), m_threadAffinity ? _T("enabled") : _T("disabled"));
 
 	return true;
 }
@@ -269,15 +443,23 @@ void LIBNXDB_EXPORTABLE DBConnectionPoolShutdown()
    ThreadJoin(m_maintThread);
 
    ConditionDestroy(m_condShutdown);
-   ConditionDestroy(m_condRelease);
 	MutexDestroy(m_poolAccessMutex);
 
-   for(int i = 0; i < m_connections.size(); i++)
+   for(int i = 0; i < m_slotCount; i++)
 	{
-      DBDisconnect(m_connections.get(i)->handle);
+      PoolConnection *conn = m_slots[i];
+      if (conn == nullptr)
+         continue;
+      if (conn->info.handle != nullptr)
+         DBDisconnect(conn->info.handle);
+      MemFree(conn);
 	}
 
-   m_connections.clear();
+   MemFreeAndNull(m_slots);
+   m_slotCount = 0;
+   m_poolSize = 0;
+   m_freeCount = 0;
+   m_freeListHead = m_freeListTail = nullptr;
 
    s_initialized = false;
 	nxlog_debug_tag(DEBUG_TAG, 1, _T("Database Connection Pool terminated"));
@@ -288,32 +470,131 @@ void LIBNXDB_EXPORTABLE DBConnectionPoolShutdown()
  */
 void LIBNXDB_EXPORTABLE DBConnectionPoolReset()
 {
+   ObjectArray<PoolConnection> closeList(16, 16, Ownership::False);
+   ObjectArray<PoolConnection> resetList(16, 16, Ownership::False);
+
    MutexLock(m_poolAccessMutex);
 
-   for(int i = 0; i < m_connections.size(); i++)
+   for(int i = 0; i < m_slotCount; i++)
    {
-      PoolConnectionInfo *conn = m_connections.get(i);
-      if (conn->inUse)
+      PoolConnection *conn = m_slots[i];
+      if (conn == nullptr)
+         continue;
+
+      if (conn->info.inUse)
       {
-         conn->resetOnRelease = true;
+         conn->info.resetOnRelease = true;
       }
-      else if (m_connections.size() > m_basePoolSize)
+      else if (m_poolSize > m_basePoolSize)
       {
-         DBDisconnect(conn->handle);
-         m_connections.remove(i);
-         i--;
+         FreeListRemove(conn);
+         DetachConnection(conn);
+         closeList.add(conn);
       }
       else
       {
-         if (!ResetConnection(conn))
-         {
-            m_connections.remove(i);
-            i--;
-         }
+         FreeListRemove(conn);
+         resetList.add(conn);
       }
    }
 
    MutexUnlock(m_poolAccessMutex);
+
+   for(int i = 0; i < closeList.size(); i++)
+   {
+      PoolConnection *conn = closeList.get(i);
+      DBDisconnect(conn->info.handle);
+      nxlog_debug_tag(DEBUG_TAG, 3, _T("Connection %p terminated"), conn);
+      MemFree(conn);
+   }
+
+   ResetConnections(resetList);
+}
+
+/**
+ * Find or create call site statistics entry. Pool lock must be held.
+ */
+static CallSite *GetCallSite(const char *srcFile, int srcLine)
+{
+   // Source file name is always a literal (__FILE__), so pointer itself identifies call site together with line number
+   uint32_t hash = (static_cast<uint32_t>(reinterpret_cast<uintptr_t>(srcFile) >> 3) ^ (static_cast<uint32_t>(srcLine) * 2654435761U)) % MAX_CALL_SITES;
+   for(int i = 0; i < MAX_CALL_SITES; i++)
+   {
+      CallSite *site = &m_callSites[hash];
+      if ((site->file == srcFile) && (site->line == srcLine))
+         return site;
+      if (site->file == nullptr)
+      {
+         site->file = srcFile;
+         site->line = srcLine;
+         return site;
+      }
+      hash = (hash + 1) % MAX_CALL_SITES;
+   }
+   return nullptr;
+}
+
+/**
+ * Mark connection as acquired and update call site statistics. Pool lock must be held.
+ */
+static void OnConnectionAcquired(PoolConnection *conn, const char *srcFile, int srcLine, uint64_t startTime)
+{
+   uint64_t elapsed = (GetMonotonicClockTimeNs() - startTime) / 1000;  // microseconds
+   int bucket;
+   if (elapsed < 1000)
+      bucket = 0;
+   else if (elapsed < 10000)
+      bucket = 1;
+   else if (elapsed < 100000)
+      bucket = 2;
+   else if (elapsed < 1000000)
+      bucket = 3;
+   else if (elapsed < 10000000)
+      bucket = 4;
+   else
+      bucket = 5;
+
+   conn->callSite = GetCallSite(srcFile, srcLine);
+   if (conn->callSite != nullptr)
+      conn->callSite->histogram[bucket]++;
+
+   conn->info.inUse = true;
+   conn->info.lastAccessTime = time(nullptr);
+   conn->info.usageCount++;
+   conn->info.acquireTime = static_cast<uint32_t>(elapsed / 1000);
+   strlcpy(conn->info.srcFile, srcFile, 128);
+   conn->info.srcLine = srcLine;
+}
+
+/**
+ * Wait for connection to be released by other thread. Pool lock must be held. Waiting threads are served
+ * in FIFO order - connection released to the pool or pool slot freed by detached connection is handed over
+ * directly to the first waiter. In latter case returned connection is not open yet (handle is null).
+ */
+static PoolConnection *WaitForConnection(const char *srcFile, int srcLine)
+{
+   PoolWaiter waiter;
+   waiter.wakeup = ConditionCreate(false);
+   waiter.connection = nullptr;
+   waiter.next = nullptr;
+   if (m_waitersTail != nullptr)
+      m_waitersTail->next = &waiter;
+   else
+      m_waitersHead = &waiter;
+   m_waitersTail = &waiter;
+
+   nxlog_debug_tag(DEBUG_TAG, 1, _T("Database connection pool exhausted (call from %hs:%d)"), srcFile, srcLine);
+   while(waiter.connection == nullptr)
+   {
+      MutexUnlock(m_poolAccessMutex);
+      bool signalled = ConditionWait(waiter.wakeup, 10000);
+      MutexLock(m_poolAccessMutex);
+      if (!signalled && (waiter.connection == nullptr))
+         nxlog_debug_tag(DEBUG_TAG, 5, _T("Still waiting for database connection (call from %hs:%d)"), srcFile, srcLine);
+   }
+
+   ConditionDestroy(waiter.wakeup);
+   return waiter.connection;
 }
 
 /**
@@ -322,68 +603,52 @@ void LIBNXDB_EXPORTABLE DBConnectionPoolReset()
  */
 DB_HANDLE LIBNXDB_EXPORTABLE __DBConnectionPoolAcquireConnection(const char *srcFile, int srcLine)
 {
-retry:
+   uint64_t startTime = GetMonotonicClockTimeNs();
+
 	MutexLock(m_poolAccessMutex);
 
-	DB_HANDLE handle = NULL;
+	PoolConnection *conn = nullptr;
 
-	// find less used connection
-   UINT32 count = 0xFFFFFFFF;
-	int index = -1;
-   for(int i = 0; (i < m_connections.size()) && (count > 0); i++)
+#if HAVE_THREAD_LOCAL_STORAGE
+	// Prefer connection last used by this thread
+	if (m_threadAffinity && (s_affineSlot >= 0) && (s_affineSlot < m_slotCount))
 	{
-      PoolConnectionInfo *conn = m_connections.get(i);
-      if (!conn->inUse && (conn->usageCount < count))
-      {
-         count = conn->usageCount;
-         index = i;
-		}
+	   PoolConnection *c = m_slots[s_affineSlot];
+	   if ((c != nullptr) && (c->serial == s_affineSerial) && !c->info.inUse)
+	   {
+	      FreeListRemove(c);
+	      conn = c;
+	   }
 	}
+#endif
 
-	if (index > -1)
+	if ((conn == nullptr) && (m_freeListHead != nullptr))
 	{
-		PoolConnectionInfo *conn = m_connections.get(index);
-		handle = conn->handle;
-		conn->inUse = true;
-		conn->lastAccessTime = time(NULL);
-		conn->usageCount++;
-		strncpy(conn->srcFile, srcFile, 128);
-		conn->srcLine = srcLine;
+	   conn = m_freeListHead;
+	   FreeListRemove(conn);
 	}
-   else if (m_connections.size() < m_maxPoolSize)
+
+	if (conn == nullptr)
 	{
-	   TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
-      PoolConnectionInfo *conn = new PoolConnectionInfo;
-      conn->handle = DBConnect(m_driver, m_server, m_dbName, m_login, m_password, m_schema, errorText);
-      if (conn->handle != NULL)
-      {
-         conn->inUse = true;
-         conn->resetOnRelease = false;
-         conn->connectTime = time(NULL);
-         conn->lastAccessTime = conn->connectTime;
-         conn->usageCount = 0;
-         strncpy(conn->srcFile, srcFile, 128);
-         conn->srcLine = srcLine;
-         m_connections.add(conn);
-         handle = conn->handle;
-         nxlog_debug_tag(DEBUG_TAG, 3, _T("Connection %p created"), conn);
-      }
-      else
-      {
-         nxlog_debug_tag(DEBUG_TAG, 3, _T("Cannot create additional DB connection (%s)"), errorText);
-         delete conn;
-      }
+	   conn = (m_poolSize < m_maxPoolSize) ? CreatePoolConnection() : WaitForConnection(srcFile, srcLine);
+
+	   // Open reserved connection. Slot is kept while retrying, so calling thread does not lose its turn.
+	   if (conn->info.handle == nullptr)
+	   {
+	      MutexUnlock(m_poolAccessMutex);
+	      while(!OpenConnection(conn))
+	      {
+	         nxlog_debug_tag(DEBUG_TAG, 5, _T("Retry open database connection (call from %hs:%d)"), srcFile, srcLine);
+	         ThreadSleepMs(1000);
+	      }
+	      MutexLock(m_poolAccessMutex);
+	   }
 	}
 
-	MutexUnlock(m_poolAccessMutex);
+	OnConnectionAcquired(conn, srcFile, srcLine, startTime);
+	DB_HANDLE handle = conn->info.handle;
 
-	if (handle == NULL)
-	{
-   	nxlog_debug_tag(DEBUG_TAG, 1, _T("Database connection pool exhausted (call from %hs:%d)"), srcFile, srcLine);
-      ConditionWait(m_condRelease, 10000);
-      nxlog_debug_tag(DEBUG_TAG, 5, _T("Retry acquire connection (call from %hs:%d)"), srcFile, srcLine);
-      goto retry;
-	}
+	MutexUnlock(m_poolAccessMutex);
 
    nxlog_debug_tag(DEBUG_TAG, 7, _T("Handle %p acquired (call from %hs:%d)"), handle, srcFile, srcLine);
 	return handle;
@@ -394,42 +659,47 @@ DB_HANDLE LIBNXDB_EXPORTABLE __DBConnectionPoolAcquireConnection(const char *src
  */
 void LIBNXDB_EXPORTABLE DBConnectionPoolReleaseConnection(DB_HANDLE handle)
 {
+   PoolConnection *conn = handle->m_poolConnection;
+   if (conn == nullptr)
+   {
+      nxlog_debug_tag(DEBUG_TAG, 3, _T("Attempt to release handle %p not owned by connection pool"), handle);
+      return;
+   }
+
 	MutexLock(m_poolAccessMutex);
 
-   for(int i = 0; i < m_connections.size(); i++)
-	{
-      PoolConnectionInfo *conn = m_connections.get(i);
-      if (conn->handle == handle)
-		{
-         conn->srcFile[0] = 0;
-         conn->srcLine = 0;
-         if (conn->resetOnRelease)
-         {
-            MutexUnlock(m_poolAccessMutex);
-            bool success = ResetConnection(conn);
-            MutexLock(m_poolAccessMutex);
-            if (success)
-            {
-               conn->inUse = false;
-            }
-            else
-            {
-               m_connections.remove(i);
-            }
-         }
-         else
-         {
-            conn->inUse = false;
-            conn->lastAccessTime = time(NULL);
-         }
-			break;
-		}
-	}
+   conn->info.srcFile[0] = 0;
+   conn->info.srcLine = 0;
+   conn->info.lastAccessTime = time(nullptr);
+   conn->callSite = nullptr;
+
+#if HAVE_THREAD_LOCAL_STORAGE
+   if (m_threadAffinity)
+   {
+      s_affineSlot = conn->slot;
+      s_affineSerial = conn->serial;
+   }
+#endif
+
+   bool success = true;
+   if (conn->info.resetOnRelease)
+   {
+      MutexUnlock(m_poolAccessMutex);
+      success = ResetConnection(conn);
+      MutexLock(m_poolAccessMutex);
+   }
+
+   if (success)
+      ReturnConnection(conn);
+   else
+      DetachConnection(conn);
 
 	MutexUnlock(m_poolAccessMutex);
 
+	if (!success)
+	   MemFree(conn);
+
    nxlog_debug_tag(DEBUG_TAG, 7, _T("Handle %p released"), handle);
-   ConditionPulse(m_condRelease);
 }
 
 /**
@@ -438,7 +708,7 @@ void LIBNXDB_EXPORTABLE DBConnectionPoolReleaseConnection(DB_HANDLE handle)
 int LIBNXDB_EXPORTABLE DBConnectionPoolGetSize()
 {
 	MutexLock(m_poolAccessMutex);
-   int size = m_connections.size();
+   int size = m_poolSize;
 	MutexUnlock(m_poolAccessMutex);
    return size;
 }
@@ -448,30 +718,32 @@ int LIBNXDB_EXPORTABLE DBConnectionPoolGetSize()
  */
 int LIBNXDB_EXPORTABLE DBConnectionPoolGetAcquiredCount()
 {
-   int count = 0;
 	MutexLock(m_poolAccessMutex);
-   for(int i = 0; i < m_connections.size(); i++)
-      if (m_connections.get(i)->inUse)
-         count++;
+   int count = m_poolSize - m_freeCount;
 	MutexUnlock(m_poolAccessMutex);
    return count;
 }
 
 /**
- * Get copy of active DB connections.
+ * Get copy of active DB connections. Acquire latency histogram in each element
+ * is for call site which currently holds the connection.
  * Returned list must be deleted by the caller.
  */
 ObjectArray<PoolConnectionInfo> LIBNXDB_EXPORTABLE *DBConnectionPoolGetConnectionList()
 {
    ObjectArray<PoolConnectionInfo> *list = new ObjectArray<PoolConnectionInfo>(32, 32, Ownership::True);
    MutexLock(m_poolAccessMutex);
-   for(int i = 0; i < m_connections.size(); i++)
+   for(int i = 0; i < m_slotCount; i++)
    {
-      PoolConnectionInfo *curr = m_connections.get(i);
-      if (curr->inUse)
+      PoolConnection *curr = m_slots[i];
+      if ((curr != nullptr) && curr->info.inUse && (curr->info.handle != nullptr))
       {
          PoolConnectionInfo *ci = new PoolConnectionInfo;
-         memcpy(ci, curr, sizeof(PoolConnectionInfo));
+         memcpy(ci, &curr->info, sizeof(PoolConnectionInfo));
+         if (curr->callSite != nullptr)
+            memcpy(ci->acquireHistogram, curr->callSite->histogram, sizeof(ci->acquireHistogram));
+         else
+            memset(ci->acquireHistogram, 0, sizeof(ci->acquireHistogram));
          list->add(ci);
       }
    }
@@ -163,6 +163,9 @@ DB_DRIVER LIBNXDB_EXPORTABLE DBLoadDriver(const TCHAR *module, const TCHAR *init
    driver->m_fpDrvQuery = (DWORD (*)(DBDRV_CONNECTION, const WCHAR *, WCHAR *))DLGetSymbolAddrEx(driver->m_handle, "DrvQuery");
    driver->m_fpDrvSelect = (DBDRV_RESULT (*)(DBDRV_CONNECTION, const WCHAR *, DWORD *, WCHAR *))DLGetSymbolAddrEx(driver->m_handle, "DrvSelect");
    driver->m_fpDrvSelectUnbuffered = (DBDRV_UNBUFFERED_RESULT (*)(DBDRV_CONNECTION, const WCHAR *, DWORD *, WCHAR *))DLGetSymbolAddrEx(driver->m_handle, "DrvSelectUnbuffered");
+   driver->m_fpDrvQueryUTF8 = (DWORD (*)(DBDRV_CONNECTION, const char *, WCHAR *))DLGetSymbolAddrEx(driver->m_handle, "DrvQueryUTF8", false); // optional entry point
+   driver->m_fpDrvSelectUTF8 = (DBDRV_RESULT (*)(DBDRV_CONNECTION, const char *, DWORD *, WCHAR *))DLGetSymbolAddrEx(driver->m_handle, "DrvSelectUTF8", false); // optional entry point
+   driver->m_fpDrvSelectUnbufferedUTF8 = (DBDRV_UNBUFFERED_RESULT (*)(DBDRV_CONNECTION, const char *, DWORD *, WCHAR *))DLGetSymbolAddrEx(driver->m_handle, "DrvSelectUnbufferedUTF8", false); // optional entry point
 	driver->m_fpDrvSelectPrepared = (DBDRV_RESULT (*)(DBDRV_CONNECTION, DBDRV_STATEMENT, DWORD *, WCHAR *))DLGetSymbolAddrEx(driver->m_handle, "DrvSelectPrepared");
    driver->m_fpDrvSelectPreparedUnbuffered = (DBDRV_UNBUFFERED_RESULT (*)(DBDRV_CONNECTION, DBDRV_STATEMENT, DWORD *, WCHAR *))DLGetSymbolAddrEx(driver->m_handle, "DrvSelectPreparedUnbuffered");
    driver->m_fpDrvFetch = (bool (*)(DBDRV_UNBUFFERED_RESULT))DLGetSymbolAddrEx(driver->m_handle, "DrvFetch");
@@ -186,6 +189,9 @@ DB_DRIVER LIBNXDB_EXPORTABLE DBLoadDriver(const TCHAR *module, const TCHAR *init
    driver->m_fpDrvPrepareStringA = (char* (*)(const char *))DLGetSymbolAddrEx(driver->m_handle, "DrvPrepareStringA");
    driver->m_fpDrvPrepareStringW = (WCHAR* (*)(const WCHAR *))DLGetSymbolAddrEx(driver->m_handle, "DrvPrepareStringW");
    driver->m_fpDrvIsTableExist = (int (*)(DBDRV_CONNECTION, const WCHAR *))DLGetSymbolAddrEx(driver->m_handle, "DrvIsTableExist");
+   driver->m_fpDrvBulkLoadBegin = (DBDRV_BULK_LOAD (*)(DBDRV_CONNECTION, const WCHAR *, const WCHAR *, int, DWORD *, WCHAR *))DLGetSymbolAddrEx(driver->m_handle, "DrvBulkLoadBegin", false); // optional entry point
+   driver->m_fpDrvBulkLoadAddRow = (DWORD (*)(DBDRV_BULK_LOAD, const WCHAR **, WCHAR *))DLGetSymbolAddrEx(driver->m_handle, "DrvBulkLoadAddRow", false); // optional entry point
+   driver->m_fpDrvBulkLoadEnd = (DWORD (*)(DBDRV_BULK_LOAD, bool, WCHAR *))DLGetSymbolAddrEx(driver->m_handle, "DrvBulkLoadEnd", false); // optional entry point
    if ((fpDrvInit == NULL) || (driver->m_fpDrvConnect == NULL) || (driver->m_fpDrvDisconnect == NULL) ||
 	    (driver->m_fpDrvPrepare == NULL) || (driver->m_fpDrvBind == NULL) || (driver->m_fpDrvFreeStatement == NULL) ||
        (driver->m_fpDrvQuery == NULL) || (driver->m_fpDrvSelect == NULL) || (driver->m_fpDrvGetField == NULL) ||
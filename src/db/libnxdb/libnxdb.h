@@ -46,6 +46,7 @@ struct db_driver_t
 	int m_refCount;
 	int m_reconnect;
    int m_defaultPrefetchLimit;
+   bool m_utf8QueriesDisabled;
 	MUTEX m_mutexReconnect;
 	HMODULE m_handle;
 	void *m_context;
@@ -59,8 +60,11 @@ struct db_driver_t
 	void (* m_fpDrvBind)(DBDRV_STATEMENT, int, int, int, void *, int);
 	DWORD (* m_fpDrvExecute)(DBDRV_CONNECTION, DBDRV_STATEMENT, WCHAR *);
 	DWORD (* m_fpDrvQuery)(DBDRV_CONNECTION, const WCHAR *, WCHAR *);
+   DWORD (* m_fpDrvQueryUTF8)(DBDRV_CONNECTION, const char *, WCHAR *);
 	DBDRV_RESULT (* m_fpDrvSelect)(DBDRV_CONNECTION, const WCHAR *, DWORD *, WCHAR *);
+   DBDRV_RESULT (* m_fpDrvSelectUTF8)(DBDRV_CONNECTION, const char *, DWORD *, WCHAR *);
 	DBDRV_UNBUFFERED_RESULT (* m_fpDrvSelectUnbuffered)(DBDRV_CONNECTION, const WCHAR *, DWORD *, WCHAR *);
+   DBDRV_UNBUFFERED_RESULT (* m_fpDrvSelectUnbufferedUTF8)(DBDRV_CONNECTION, const char *, DWORD *, WCHAR *);
 	DBDRV_RESULT (* m_fpDrvSelectPrepared)(DBDRV_CONNECTION, DBDRV_STATEMENT, DWORD *, WCHAR *);
    DBDRV_UNBUFFERED_RESULT (* m_fpDrvSelectPreparedUnbuffered)(DBDRV_CONNECTION, DBDRV_STATEMENT, DWORD *, WCHAR *);
 	bool (* m_fpDrvFetch)(DBDRV_UNBUFFERED_RESULT);
@@ -85,6 +89,9 @@ struct db_driver_t
 	WCHAR* (* m_fpDrvPrepareStringW)(const WCHAR *);
 	char* (* m_fpDrvPrepareStringA)(const char *);
 	int (* m_fpDrvIsTableExist)(DBDRV_CONNECTION, const WCHAR *);
+   DBDRV_BULK_LOAD (* m_fpDrvBulkLoadBegin)(DBDRV_CONNECTION, const WCHAR *, const WCHAR *, int, DWORD *, WCHAR *);
+   DWORD (* m_fpDrvBulkLoadAddRow)(DBDRV_BULK_LOAD, const WCHAR **, WCHAR *);
+   DWORD (* m_fpDrvBulkLoadEnd)(DBDRV_BULK_LOAD, bool, WCHAR *);
 };
 
 /**
@@ -98,6 +105,8 @@ struct db_statement_t
 	TCHAR *m_query;
 };
 
+struct PoolConnection;
+
 /**
  * Database connection structure
  */
@@ -115,6 +124,7 @@ struct db_handle_t
    char *m_schema;
    ObjectArray<db_statement_t> *m_preparedStatements;
    MUTEX m_preparedStatementsLock;
+   PoolConnection *m_poolConnection;   // Connection pool entry if handle is owned by connection pool
 };
 
 /**
@@ -137,6 +147,20 @@ struct db_unbuffered_result_t
 	DBDRV_UNBUFFERED_RESULT m_data;
 };
 
+/**
+ * Bulk load operation
+ */
+struct db_bulk_load_t
+{
+   DB_HANDLE m_connection;
+   DBDRV_BULK_LOAD m_data;
+   TCHAR *m_table;
+   int m_numColumns;
+   uint32_t m_rows;
+   bool m_failed;
+   int64_t m_startTime;
+};
+
 /**
  * Global variables
  */
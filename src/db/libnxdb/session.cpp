@@ -235,6 +235,15 @@ void LIBNXDB_EXPORTABLE DBSetDefaultPrefetchLimit(DB_DRIVER driver, int limit)
    driver->m_defaultPrefetchLimit = limit;
 }
 
+/**
+ * Enable or disable use of driver's UTF-8 query entry points. When disabled, UTF-8 queries
+ * are converted to wide character strings and passed to generic entry points.
+ */
+void LIBNXDB_EXPORTABLE DBEnableUTF8Queries(DB_DRIVER driver, bool enabled)
+{
+   driver->m_utf8QueriesDisabled = !enabled;
+}
+
 /**
  * Set prefetch limit
  */
@@ -254,27 +263,110 @@ void LIBNXDB_EXPORTABLE DBSetSessionInitCallback(void (*cb)(DB_HANDLE))
 }
 
 /**
- * Perform a non-SELECT SQL query
+ * Query text for logging. Query passed in UTF-8 is converted only when it actually has to be logged.
  */
-bool LIBNXDB_EXPORTABLE DBQueryEx(DB_HANDLE hConn, const TCHAR *szQuery, TCHAR *errorText)
+class QueryText
+{
+private:
+   const TCHAR *m_text;
+   const char *m_utf8Text;
+   TCHAR *m_convertedText;
+
+public:
+   QueryText(const TCHAR *text, const char *utf8Text)
+   {
+      m_text = text;
+      m_utf8Text = utf8Text;
+      m_convertedText = nullptr;
+   }
+   ~QueryText()
+   {
+      MemFree(m_convertedText);
+   }
+
+   const TCHAR *get()
+   {
+      if (m_text == nullptr)
+         m_text = m_convertedText = TStringFromUTF8String(m_utf8Text);
+      return m_text;
+   }
+};
+
+/**
+ * Query in driver's format - either UTF-8 (if driver supports UTF-8 entry points) or wide character
+ */
+class DriverQuery
+{
+private:
+   const WCHAR *m_wideQuery;
+   WCHAR *m_convertedQuery;
+
+public:
+   DriverQuery(const TCHAR *query, const char *utf8Query, bool useUTF8)
+   {
+      m_convertedQuery = nullptr;
+      if (useUTF8)
+      {
+         m_wideQuery = nullptr;
+      }
+      else if (query != nullptr)
+      {
+#ifdef UNICODE
+         m_wideQuery = query;
+#else
+         m_wideQuery = m_convertedQuery = WideStringFromMBString(query);
+#endif
+      }
+      else
+      {
+         m_wideQuery = m_convertedQuery = WideStringFromUTF8String(utf8Query);
+      }
+   }
+   ~DriverQuery()
+   {
+      MemFree(m_convertedQuery);
+   }
+
+   const WCHAR *wide() const { return m_wideQuery; }
+
+   /**
+    * Get wide character version of query for event handler (will be converted from UTF-8 if needed)
+    */
+   const WCHAR *wideForEvent(const char *utf8Query)
+   {
+      if (m_wideQuery == nullptr)
+         m_wideQuery = m_convertedQuery = WideStringFromUTF8String(utf8Query);
+      return m_wideQuery;
+   }
+};
+
+/**
+ * Perform a non-SELECT SQL query - internal implementation. Query can be given either as TCHAR string or as UTF-8 string.
+ */
+static bool QueryInternal(DB_HANDLE hConn, const TCHAR *szQuery, const char *utf8Query, TCHAR *errorText)
 {
    DWORD dwResult;
 #ifdef UNICODE
-#define pwszQuery szQuery
 #define wcErrorText errorText
 #else
-   WCHAR *pwszQuery = WideStringFromMBString(szQuery);
 	WCHAR wcErrorText[DBDRV_MAX_ERROR_TEXT] = L"";
 #endif
+   bool useUTF8 = (utf8Query != nullptr) && (hConn->m_driver->m_fpDrvQueryUTF8 != nullptr) && !hConn->m_driver->m_utf8QueriesDisabled;
+   DriverQuery query(szQuery, utf8Query, useUTF8);
+   QueryText queryText(szQuery, utf8Query);
 
    MutexLock(hConn->m_mutexTransLock);
    int64_t ms = GetCurrentTimeMs();
 
-   dwResult = hConn->m_driver->m_fpDrvQuery(hConn->m_connection, pwszQuery, wcErrorText);
+   dwResult = useUTF8 ?
+            hConn->m_driver->m_fpDrvQueryUTF8(hConn->m_connection, utf8Query, wcErrorText) :
+            hConn->m_driver->m_fpDrvQuery(hConn->m_connection, query.wide(), wcErrorText);
    if ((dwResult == DBERR_CONNECTION_LOST) && hConn->m_reconnectEnabled)
    {
       DBReconnect(hConn);
-      dwResult = hConn->m_driver->m_fpDrvQuery(hConn->m_connection, pwszQuery, wcErrorText);
+      dwResult = useUTF8 ?
+               hConn->m_driver->m_fpDrvQueryUTF8(hConn->m_connection, utf8Query, wcErrorText) :
+               hConn->m_driver->m_fpDrvQuery(hConn->m_connection, query.wide(), wcErrorText);
    }
 
    s_perfNonSelectQueries++;
@@ -283,11 +375,11 @@ bool LIBNXDB_EXPORTABLE DBQueryEx(DB_HANDLE hConn, const TCHAR *szQuery, TCHAR *
    ms = GetCurrentTimeMs() - ms;
    if (s_queryTrace)
    {
-      nxlog_debug_tag(DEBUG_TAG_QUERY, 9, _T("%s sync query: \"%s\" [%d ms]"), (dwResult == DBERR_SUCCESS) ? _T("Successful") : _T("Failed"), szQuery, ms);
+      nxlog_debug_tag(DEBUG_TAG_QUERY, 9, _T("%s sync query: \"%s\" [%d ms]"), (dwResult == DBERR_SUCCESS) ? _T("Successful") : _T("Failed"), queryText.get(), ms);
    }
    if ((dwResult == DBERR_SUCCESS) && ((UINT32)ms > g_sqlQueryExecTimeThreshold))
    {
-      nxlog_debug_tag(DEBUG_TAG_QUERY, 3, _T("Long running query: \"%s\" [%d ms]"), szQuery, (int)ms);
+      nxlog_debug_tag(DEBUG_TAG_QUERY, 3, _T("Long running query: \"%s\" [%d ms]"), queryText.get(), (int)ms);
       s_perfLongRunningQueries++;
    }
    
@@ -301,41 +393,65 @@ bool LIBNXDB_EXPORTABLE DBQueryEx(DB_HANDLE hConn, const TCHAR *szQuery, TCHAR *
    if (dwResult != DBERR_SUCCESS)
 	{	
       s_perfFailedQueries++;
-      nxlog_write_tag(NXLOG_ERROR, DEBUG_TAG_DRIVER, _T("SQL query failed (Query = \"%s\"): %s"), szQuery, errorText);
+      nxlog_write_tag(NXLOG_ERROR, DEBUG_TAG_DRIVER, _T("SQL query failed (Query = \"%s\"): %s"), queryText.get(), errorText);
 		if (hConn->m_driver->m_fpEventHandler != NULL)
-			hConn->m_driver->m_fpEventHandler(DBEVENT_QUERY_FAILED, pwszQuery, wcErrorText, dwResult == DBERR_CONNECTION_LOST, hConn->m_driver->m_context);
+			hConn->m_driver->m_fpEventHandler(DBEVENT_QUERY_FAILED, query.wideForEvent(utf8Query), wcErrorText, dwResult == DBERR_CONNECTION_LOST, hConn->m_driver->m_context);
 	}
 
-#ifndef UNICODE
-   free(pwszQuery);
-#endif
-   
    return dwResult == DBERR_SUCCESS;
-#undef pwszQuery
 #undef wcErrorText
 }
 
+/**
+ * Perform a non-SELECT SQL query
+ */
+bool LIBNXDB_EXPORTABLE DBQueryEx(DB_HANDLE hConn, const TCHAR *szQuery, TCHAR *errorText)
+{
+   return QueryInternal(hConn, szQuery, nullptr, errorText);
+}
+
+/**
+ * Perform a non-SELECT SQL query
+ */
 bool LIBNXDB_EXPORTABLE DBQuery(DB_HANDLE hConn, const TCHAR *query)
 {
    TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
-	return DBQueryEx(hConn, query, errorText);
+	return QueryInternal(hConn, query, nullptr, errorText);
 }
 
 /**
- * Perform SELECT query
+ * Perform a non-SELECT SQL query given in UTF-8. Query is passed to driver without conversion if driver supports that.
  */
-DB_RESULT LIBNXDB_EXPORTABLE DBSelectEx(DB_HANDLE hConn, const TCHAR *szQuery, TCHAR *errorText)
+bool LIBNXDB_EXPORTABLE DBQueryUTF8Ex(DB_HANDLE hConn, const char *query, TCHAR *errorText)
+{
+   return QueryInternal(hConn, nullptr, query, errorText);
+}
+
+/**
+ * Perform a non-SELECT SQL query given in UTF-8
+ */
+bool LIBNXDB_EXPORTABLE DBQueryUTF8(DB_HANDLE hConn, const char *query)
+{
+   TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
+   return QueryInternal(hConn, nullptr, query, errorText);
+}
+
+/**
+ * Perform SELECT query - internal implementation. Query can be given either as TCHAR string or as UTF-8 string.
+ */
+static DB_RESULT SelectInternal(DB_HANDLE hConn, const TCHAR *szQuery, const char *utf8Query, TCHAR *errorText)
 {
    DBDRV_RESULT hResult;
 	DB_RESULT result = NULL;
    DWORD dwError = DBERR_OTHER_ERROR;
 #ifdef UNICODE
-#define pwszQuery szQuery
 #define wcErrorText errorText
 #else
-   WCHAR *pwszQuery = WideStringFromMBString(szQuery);
 	WCHAR wcErrorText[DBDRV_MAX_ERROR_TEXT] = L"";
 #endif
+   bool useUTF8 = (utf8Query != nullptr) && (hConn->m_driver->m_fpDrvSelectUTF8 != nullptr) && !hConn->m_driver->m_utf8QueriesDisabled;
+   DriverQuery query(szQuery, utf8Query, useUTF8);
+   QueryText queryText(szQuery, utf8Query);
    
    MutexLock(hConn->m_mutexTransLock);
    INT64 ms = GetCurrentTimeMs();
@@ -343,21 +459,25 @@ DB_RESULT LIBNXDB_EXPORTABLE DBSelectEx(DB_HANDLE hConn, const TCHAR *szQuery, T
    s_perfSelectQueries++;
    s_perfTotalQueries++;
 
-   hResult = hConn->m_driver->m_fpDrvSelect(hConn->m_connection, pwszQuery, &dwError, wcErrorText);
+   hResult = useUTF8 ?
+            hConn->m_driver->m_fpDrvSelectUTF8(hConn->m_connection, utf8Query, &dwError, wcErrorText) :
+            hConn->m_driver->m_fpDrvSelect(hConn->m_connection, query.wide(), &dwError, wcErrorText);
    if ((hResult == NULL) && (dwError == DBERR_CONNECTION_LOST) && hConn->m_reconnectEnabled)
    {
       DBReconnect(hConn);
-      hResult = hConn->m_driver->m_fpDrvSelect(hConn->m_connection, pwszQuery, &dwError, wcErrorText);
+      hResult = useUTF8 ?
+               hConn->m_driver->m_fpDrvSelectUTF8(hConn->m_connection, utf8Query, &dwError, wcErrorText) :
+               hConn->m_driver->m_fpDrvSelect(hConn->m_connection, query.wide(), &dwError, wcErrorText);
    }
 
    ms = GetCurrentTimeMs() - ms;
    if (s_queryTrace)
    {
-      nxlog_debug_tag(DEBUG_TAG_QUERY, 9, _T("%s sync query: \"%s\" [%d ms]"), (hResult != NULL) ? _T("Successful") : _T("Failed"), szQuery, (int)ms);
+      nxlog_debug_tag(DEBUG_TAG_QUERY, 9, _T("%s sync query: \"%s\" [%d ms]"), (hResult != NULL) ? _T("Successful") : _T("Failed"), queryText.get(), (int)ms);
    }
    if ((hResult != NULL) && ((UINT32)ms > g_sqlQueryExecTimeThreshold))
    {
-      nxlog_debug_tag(DEBUG_TAG_QUERY, 3, _T("Long running query: \"%s\" [%d ms]"), szQuery, (int)ms);
+      nxlog_debug_tag(DEBUG_TAG_QUERY, 3, _T("Long running query: \"%s\" [%d ms]"), queryText.get(), (int)ms);
       s_perfLongRunningQueries++;
    }
    MutexUnlock(hConn->m_mutexTransLock);
@@ -370,15 +490,11 @@ DB_RESULT LIBNXDB_EXPORTABLE DBSelectEx(DB_HANDLE hConn, const TCHAR *szQuery, T
 	if (hResult == NULL)
 	{
 	   s_perfFailedQueries++;
-      nxlog_write_tag(NXLOG_ERROR, DEBUG_TAG_DRIVER, _T("SQL query failed (Query = \"%s\"): %s"), szQuery, errorText);
+      nxlog_write_tag(NXLOG_ERROR, DEBUG_TAG_DRIVER, _T("SQL query failed (Query = \"%s\"): %s"), queryText.get(), errorText);
 		if (hConn->m_driver->m_fpEventHandler != NULL)
-			hConn->m_driver->m_fpEventHandler(DBEVENT_QUERY_FAILED, pwszQuery, wcErrorText, dwError == DBERR_CONNECTION_LOST, hConn->m_driver->m_context);
+			hConn->m_driver->m_fpEventHandler(DBEVENT_QUERY_FAILED, query.wideForEvent(utf8Query), wcErrorText, dwError == DBERR_CONNECTION_LOST, hConn->m_driver->m_context);
 	}
 
-#ifndef UNICODE
-   free(pwszQuery);
-#endif
-   
 	if (hResult != NULL)
 	{
 		result = MemAllocStruct<db_result_t>();
@@ -388,17 +504,41 @@ DB_RESULT LIBNXDB_EXPORTABLE DBSelectEx(DB_HANDLE hConn, const TCHAR *szQuery, T
 	}
 
    return result;
-#undef pwszQuery
 #undef wcErrorText
 }
 
+/**
+ * Perform SELECT query
+ */
+DB_RESULT LIBNXDB_EXPORTABLE DBSelectEx(DB_HANDLE hConn, const TCHAR *szQuery, TCHAR *errorText)
+{
+   return SelectInternal(hConn, szQuery, nullptr, errorText);
+}
+
 /**
  * Perform SELECT query
  */
 DB_RESULT LIBNXDB_EXPORTABLE DBSelect(DB_HANDLE hConn, const TCHAR *query)
 {
    TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
-	return DBSelectEx(hConn, query, errorText);
+	return SelectInternal(hConn, query, nullptr, errorText);
+}
+
+/**
+ * Perform SELECT query given in UTF-8. Query is passed to driver without conversion if driver supports that.
+ */
+DB_RESULT LIBNXDB_EXPORTABLE DBSelectUTF8Ex(DB_HANDLE hConn, const char *query, TCHAR *errorText)
+{
+   return SelectInternal(hConn, nullptr, query, errorText);
+}
+
+/**
+ * Perform SELECT query given in UTF-8
+ */
+DB_RESULT LIBNXDB_EXPORTABLE DBSelectUTF8(DB_HANDLE hConn, const char *query)
+{
+   TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
+   return SelectInternal(hConn, nullptr, query, errorText);
 }
 
 /**
@@ -646,25 +786,53 @@ TCHAR LIBNXDB_EXPORTABLE *DBGetFieldForXML(DB_RESULT hResult, int row, int col)
    return xmlString;
 }
 
+/**
+ * Convert wide character field value to ASCII
+ */
+#ifdef UNICODE_UCS4
+#define FieldValueToASCII ucs4_to_ASCII
+#else
+#define FieldValueToASCII ucs2_to_ASCII
+#endif
+
+/**
+ * Get field's value as narrow string for conversion to number. UTF-8 entry point is used if
+ * driver provides it, so that value is not converted to wide characters and back.
+ */
+static char *GetFieldForNumber(DB_RESULT hResult, int row, int column, char *buffer, size_t size)
+{
+   *buffer = 0;
+   if (hResult->m_driver->m_fpDrvGetFieldUTF8 != nullptr)
+      return hResult->m_driver->m_fpDrvGetFieldUTF8(hResult->m_data, row, column, buffer, (int)size);
+
+   WCHAR wbuffer[64];
+   *wbuffer = 0;
+   if (hResult->m_driver->m_fpDrvGetField(hResult->m_data, row, column, wbuffer, 64) == nullptr)
+      return nullptr;
+   FieldValueToASCII(wbuffer, -1, buffer, size);
+   buffer[size - 1] = 0;
+   return buffer;
+}
+
 /**
  * Get field's value as unsigned long
  */
 uint32_t LIBNXDB_EXPORTABLE DBGetFieldULong(DB_RESULT hResult, int row, int column)
 {
-   TCHAR buffer[256];
-   TCHAR *value = DBGetField(hResult, row, column, buffer, 256);
+   char buffer[64];
+   char *value = GetFieldForNumber(hResult, row, column, buffer, 64);
    if (value == nullptr)
       return 0;
-	Trim(value);
+	TrimA(value);
 	uint32_t u;
-	if (*value == _T('-'))
+	if (*value == '-')
 	{
-		int32_t i = _tcstol(value, nullptr, 10);
+		int32_t i = strtol(value, nullptr, 10);
 		memcpy(&u, &i, sizeof(int32_t));   // To prevent possible conversion
 	}
 	else
 	{
-		u = _tcstoul(value, nullptr, 10);
+		u = strtoul(value, nullptr, 10);
 	}
    return u;
 }
@@ -674,20 +842,20 @@ uint32_t LIBNXDB_EXPORTABLE DBGetFieldULong(DB_RESULT hResult, int row, int colu
  */
 uint64_t LIBNXDB_EXPORTABLE DBGetFieldUInt64(DB_RESULT hResult, int row, int column)
 {
-   TCHAR buffer[256];
-   TCHAR *value = DBGetField(hResult, row, column, buffer, 256);
+   char buffer[64];
+   char *value = GetFieldForNumber(hResult, row, column, buffer, 64);
    if (value == nullptr)
       return 0;
-   Trim(value);
+   TrimA(value);
    uint64_t u;
-   if (*value == _T('-'))
+   if (*value == '-')
 	{
-		int64_t i = _tcstoll(value, nullptr, 10);
+		int64_t i = strtoll(value, nullptr, 10);
 		memcpy(&u, &i, sizeof(int64_t));   // To prevent possible conversion
 	}
 	else
 	{
-		u = _tcstoull(value, nullptr, 10);
+		u = strtoull(value, nullptr, 10);
 	}
    return u;
 }
@@ -697,9 +865,9 @@ uint64_t LIBNXDB_EXPORTABLE DBGetFieldUInt64(DB_RESULT hResult, int row, int col
  */
 int32_t LIBNXDB_EXPORTABLE DBGetFieldLong(DB_RESULT hResult, int row, int column)
 {
-   TCHAR buffer[256];
-   TCHAR *value = DBGetField(hResult, row, column, buffer, 256);
-   return (value != nullptr) ? _tcstol(value, nullptr, 10) : 0;
+   char buffer[64];
+   char *value = GetFieldForNumber(hResult, row, column, buffer, 64);
+   return (value != nullptr) ? strtol(value, nullptr, 10) : 0;
 }
 
 /**
@@ -707,9 +875,9 @@ int32_t LIBNXDB_EXPORTABLE DBGetFieldLong(DB_RESULT hResult, int row, int column
  */
 int64_t LIBNXDB_EXPORTABLE DBGetFieldInt64(DB_RESULT hResult, int row, int column)
 {
-   TCHAR buffer[256];
-   TCHAR *value = DBGetField(hResult, row, column, buffer, 256);
-   return (value != nullptr) ? _tcstoll(value, nullptr, 10) : 0;
+   char buffer[64];
+   char *value = GetFieldForNumber(hResult, row, column, buffer, 64);
+   return (value != nullptr) ? strtoll(value, nullptr, 10) : 0;
 }
 
 /**
@@ -717,9 +885,9 @@ int64_t LIBNXDB_EXPORTABLE DBGetFieldInt64(DB_RESULT hResult, int row, int colum
  */
 double LIBNXDB_EXPORTABLE DBGetFieldDouble(DB_RESULT hResult, int row, int column)
 {
-   TCHAR buffer[256];
-   TCHAR *value = DBGetField(hResult, row, column, buffer, 256);
-   return (value != nullptr) ? _tcstod(value, nullptr) : 0;
+   char buffer[64];
+   char *value = GetFieldForNumber(hResult, row, column, buffer, 64);
+   return (value != nullptr) ? strtod(value, nullptr) : 0;
 }
 
 /**
@@ -841,20 +1009,21 @@ void LIBNXDB_EXPORTABLE DBFreeResult(DB_RESULT hResult)
 }
 
 /**
- * Unbuffered SELECT query
+ * Perform unbuffered SELECT query - internal implementation. Query can be given either as TCHAR string or as UTF-8 string.
  */
-DB_UNBUFFERED_RESULT LIBNXDB_EXPORTABLE DBSelectUnbufferedEx(DB_HANDLE hConn, const TCHAR *szQuery, TCHAR *errorText)
+static DB_UNBUFFERED_RESULT SelectUnbufferedInternal(DB_HANDLE hConn, const TCHAR *szQuery, const char *utf8Query, TCHAR *errorText)
 {
    DBDRV_UNBUFFERED_RESULT hResult;
 	DB_UNBUFFERED_RESULT result = NULL;
    DWORD dwError = DBERR_OTHER_ERROR;
 #ifdef UNICODE
-#define pwszQuery szQuery
 #define wcErrorText errorText
 #else
-   WCHAR *pwszQuery = WideStringFromMBString(szQuery);
 	WCHAR wcErrorText[DBDRV_MAX_ERROR_TEXT] = L"";
 #endif
+   bool useUTF8 = (utf8Query != nullptr) && (hConn->m_driver->m_fpDrvSelectUnbufferedUTF8 != nullptr) && !hConn->m_driver->m_utf8QueriesDisabled;
+   DriverQuery query(szQuery, utf8Query, useUTF8);
+   QueryText queryText(szQuery, utf8Query);
    
    MutexLock(hConn->m_mutexTransLock);
    INT64 ms = GetCurrentTimeMs();
@@ -862,21 +1031,25 @@ DB_UNBUFFERED_RESULT LIBNXDB_EXPORTABLE DBSelectUnbufferedEx(DB_HANDLE hConn, co
    s_perfSelectQueries++;
    s_perfTotalQueries++;
 
-   hResult = hConn->m_driver->m_fpDrvSelectUnbuffered(hConn->m_connection, pwszQuery, &dwError, wcErrorText);
+   hResult = useUTF8 ?
+            hConn->m_driver->m_fpDrvSelectUnbufferedUTF8(hConn->m_connection, utf8Query, &dwError, wcErrorText) :
+            hConn->m_driver->m_fpDrvSelectUnbuffered(hConn->m_connection, query.wide(), &dwError, wcErrorText);
    if ((hResult == NULL) && (dwError == DBERR_CONNECTION_LOST) && hConn->m_reconnectEnabled)
    {
       DBReconnect(hConn);
-      hResult = hConn->m_driver->m_fpDrvSelectUnbuffered(hConn->m_connection, pwszQuery, &dwError, wcErrorText);
+      hResult = useUTF8 ?
+               hConn->m_driver->m_fpDrvSelectUnbufferedUTF8(hConn->m_connection, utf8Query, &dwError, wcErrorText) :
+               hConn->m_driver->m_fpDrvSelectUnbuffered(hConn->m_connection, query.wide(), &dwError, wcErrorText);
    }
 
    ms = GetCurrentTimeMs() - ms;
    if (s_queryTrace)
    {
-      nxlog_debug_tag(DEBUG_TAG_QUERY, 9, _T("%s unbuffered query: \"%s\" [%d ms]"), (hResult != NULL) ? _T("Successful") : _T("Failed"), szQuery, (int)ms);
+      nxlog_debug_tag(DEBUG_TAG_QUERY, 9, _T("%s unbuffered query: \"%s\" [%d ms]"), (hResult != NULL) ? _T("Successful") : _T("Failed"), queryText.get(), (int)ms);
    }
    if ((hResult != NULL) && ((UINT32)ms > g_sqlQueryExecTimeThreshold))
    {
-      nxlog_debug_tag(DEBUG_TAG_QUERY, 3, _T("Long running query: \"%s\" [%d ms]"), szQuery, (int)ms);
+      nxlog_debug_tag(DEBUG_TAG_QUERY, 3, _T("Long running query: \"%s\" [%d ms]"), queryText.get(), (int)ms);
       s_perfLongRunningQueries++;
    }
    if (hResult == NULL)
@@ -889,15 +1062,11 @@ DB_UNBUFFERED_RESULT LIBNXDB_EXPORTABLE DBSelectUnbufferedEx(DB_HANDLE hConn, co
 		errorText[DBDRV_MAX_ERROR_TEXT - 1] = 0;
 #endif
 
-      nxlog_write_tag(NXLOG_ERROR, DEBUG_TAG_DRIVER, _T("SQL query failed (Query = \"%s\"): %s"), szQuery, errorText);
+      nxlog_write_tag(NXLOG_ERROR, DEBUG_TAG_DRIVER, _T("SQL query failed (Query = \"%s\"): %s"), queryText.get(), errorText);
 		if (hConn->m_driver->m_fpEventHandler != NULL)
-			hConn->m_driver->m_fpEventHandler(DBEVENT_QUERY_FAILED, pwszQuery, wcErrorText, dwError == DBERR_CONNECTION_LOST, hConn->m_driver->m_context);
+			hConn->m_driver->m_fpEventHandler(DBEVENT_QUERY_FAILED, query.wideForEvent(utf8Query), wcErrorText, dwError == DBERR_CONNECTION_LOST, hConn->m_driver->m_context);
    }
 
-#ifndef UNICODE
-   free(pwszQuery);
-#endif
-   
 	if (hResult != NULL)
 	{
 		result = MemAllocStruct<db_unbuffered_result_t>();
@@ -907,15 +1076,41 @@ DB_UNBUFFERED_RESULT LIBNXDB_EXPORTABLE DBSelectUnbufferedEx(DB_HANDLE hConn, co
 	}
 
    return result;
-#undef pwszQuery
 #undef wcErrorText
 }
 
+/**
+ * Perform unbuffered SELECT query
+ */
+DB_UNBUFFERED_RESULT LIBNXDB_EXPORTABLE DBSelectUnbufferedEx(DB_HANDLE hConn, const TCHAR *szQuery, TCHAR *errorText)
+{
+   return SelectUnbufferedInternal(hConn, szQuery, nullptr, errorText);
+}
+
+/**
+ * Perform unbuffered SELECT query
+ */
 DB_UNBUFFERED_RESULT LIBNXDB_EXPORTABLE DBSelectUnbuffered(DB_HANDLE hConn, const TCHAR *query)
 {
    TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
+	return SelectUnbufferedInternal(hConn, query, nullptr, errorText);
+}
+
+/**
+ * Perform unbuffered SELECT query given in UTF-8. Query is passed to driver without conversion if driver supports that.
+ */
+DB_UNBUFFERED_RESULT LIBNXDB_EXPORTABLE DBSelectUnbufferedUTF8Ex(DB_HANDLE hConn, const char *query, TCHAR *errorText)
+{
+   return SelectUnbufferedInternal(hConn, nullptr, query, errorText);
+}
 
-	return DBSelectUnbufferedEx(hConn, query, errorText);
+/**
+ * Perform unbuffered SELECT query given in UTF-8
+ */
+DB_UNBUFFERED_RESULT LIBNXDB_EXPORTABLE DBSelectUnbufferedUTF8(DB_HANDLE hConn, const char *query)
+{
+   TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
+   return SelectUnbufferedInternal(hConn, nullptr, query, errorText);
 }
 
 /**
@@ -1049,6 +1244,24 @@ char LIBNXDB_EXPORTABLE *DBGetFieldUTF8(DB_UNBUFFERED_RESULT hResult, int iColum
    }
 }
 
+/**
+ * Get field's value from unbuffered SELECT result as narrow string for conversion to number
+ */
+static char *GetFieldForNumber(DB_UNBUFFERED_RESULT hResult, int column, char *buffer, size_t size)
+{
+   *buffer = 0;
+   if (hResult->m_driver->m_fpDrvGetFieldUnbufferedUTF8 != nullptr)
+      return hResult->m_driver->m_fpDrvGetFieldUnbufferedUTF8(hResult->m_data, column, buffer, (int)size);
+
+   WCHAR wbuffer[64];
+   *wbuffer = 0;
+   if (hResult->m_driver->m_fpDrvGetFieldUnbuffered(hResult->m_data, column, wbuffer, 64) == nullptr)
+      return nullptr;
+   FieldValueToASCII(wbuffer, -1, buffer, size);
+   buffer[size - 1] = 0;
+   return buffer;
+}
+
 /**
  * Get field's value as unsigned long from unbuffered SELECT result
  */
@@ -1056,19 +1269,19 @@ UINT32 LIBNXDB_EXPORTABLE DBGetFieldULong(DB_UNBUFFERED_RESULT hResult, int iCol
 {
    INT32 iVal;
    UINT32 dwVal;
-   TCHAR szBuffer[64];
+   char szBuffer[64];
 
-   if (DBGetField(hResult, iColumn, szBuffer, 64) == NULL)
+   if (GetFieldForNumber(hResult, iColumn, szBuffer, 64) == NULL)
       return 0;
-	Trim(szBuffer);
-	if (szBuffer[0] == _T('-'))
+	TrimA(szBuffer);
+	if (szBuffer[0] == '-')
 	{
-		iVal = _tcstol(szBuffer, NULL, 10);
+		iVal = strtol(szBuffer, NULL, 10);
 		memcpy(&dwVal, &iVal, sizeof(INT32));   // To prevent possible conversion
 	}
 	else
 	{
-		dwVal = _tcstoul(szBuffer, NULL, 10);
+		dwVal = strtoul(szBuffer, NULL, 10);
 	}
    return dwVal;
 }
@@ -1080,19 +1293,19 @@ UINT64 LIBNXDB_EXPORTABLE DBGetFieldUInt64(DB_UNBUFFERED_RESULT hResult, int iCo
 {
    INT64 iVal;
    UINT64 qwVal;
-   TCHAR szBuffer[64];
+   char szBuffer[64];
 
-   if (DBGetField(hResult, iColumn, szBuffer, 64) == NULL)
+   if (GetFieldForNumber(hResult, iColumn, szBuffer, 64) == NULL)
       return 0;
-	Trim(szBuffer);
-	if (szBuffer[0] == _T('-'))
+	TrimA(szBuffer);
+	if (szBuffer[0] == '-')
 	{
-		iVal = _tcstoll(szBuffer, NULL, 10);
+		iVal = strtoll(szBuffer, NULL, 10);
 		memcpy(&qwVal, &iVal, sizeof(INT64));   // To prevent possible conversion
 	}
 	else
 	{
-		qwVal = _tcstoull(szBuffer, NULL, 10);
+		qwVal = strtoull(szBuffer, NULL, 10);
 	}
    return qwVal;
 }
@@ -1102,8 +1315,8 @@ UINT64 LIBNXDB_EXPORTABLE DBGetFieldUInt64(DB_UNBUFFERED_RESULT hResult, int iCo
  */
 INT32 LIBNXDB_EXPORTABLE DBGetFieldLong(DB_UNBUFFERED_RESULT hResult, int iColumn)
 {
-   TCHAR szBuffer[64];
-   return DBGetField(hResult, iColumn, szBuffer, 64) == NULL ? 0 : _tcstol(szBuffer, NULL, 10);
+   char szBuffer[64];
+   return GetFieldForNumber(hResult, iColumn, szBuffer, 64) == NULL ? 0 : strtol(szBuffer, NULL, 10);
 }
 
 /**
@@ -1111,8 +1324,8 @@ INT32 LIBNXDB_EXPORTABLE DBGetFieldLong(DB_UNBUFFERED_RESULT hResult, int iColum
  */
 INT64 LIBNXDB_EXPORTABLE DBGetFieldInt64(DB_UNBUFFERED_RESULT hResult, int iColumn)
 {
-   TCHAR szBuffer[64];
-   return DBGetField(hResult, iColumn, szBuffer, 64) == NULL ? 0 : _tcstoll(szBuffer, NULL, 10);
+   char szBuffer[64];
+   return GetFieldForNumber(hResult, iColumn, szBuffer, 64) == NULL ? 0 : strtoll(szBuffer, NULL, 10);
 }
 
 /**
@@ -1120,8 +1333,8 @@ INT64 LIBNXDB_EXPORTABLE DBGetFieldInt64(DB_UNBUFFERED_RESULT hResult, int iColu
  */
 double LIBNXDB_EXPORTABLE DBGetFieldDouble(DB_UNBUFFERED_RESULT hResult, int iColumn)
 {
-   TCHAR szBuffer[64];
-   return DBGetField(hResult, iColumn, szBuffer, 64) == NULL ? 0 : _tcstod(szBuffer, NULL);
+   char szBuffer[64];
+   return GetFieldForNumber(hResult, iColumn, szBuffer, 64) == NULL ? 0 : strtod(szBuffer, NULL);
 }
 
 /**
@@ -1837,6 +2050,162 @@ bool LIBNXDB_EXPORTABLE DBRollback(DB_HANDLE hConn)
    return bRet;
 }
 
+/**
+ * Check if bulk load is supported by driver for given connection
+ */
+bool LIBNXDB_EXPORTABLE DBIsBulkLoadSupported(DB_HANDLE hConn)
+{
+   return (hConn->m_driver->m_fpDrvBulkLoadBegin != nullptr) && (hConn->m_driver->m_fpDrvBulkLoadAddRow != nullptr) &&
+          (hConn->m_driver->m_fpDrvBulkLoadEnd != nullptr);
+}
+
+/**
+ * Start bulk load into given table. Columns should be given as comma separated list. Connection cannot be used
+ * for anything else until bulk load is completed by call to DBBulkLoadEnd or DBBulkLoadCancel. Returns nullptr
+ * if bulk load is not supported by driver or cannot be started - caller is expected to fall back to regular
+ * INSERT statements in that case.
+ */
+DB_BULK_LOAD LIBNXDB_EXPORTABLE DBBulkLoadBegin(DB_HANDLE hConn, const TCHAR *table, const TCHAR *columns, int numColumns)
+{
+   if (!DBIsBulkLoadSupported(hConn))
+      return nullptr;
+
+#ifdef UNICODE
+#define wcTable table
+#define wcColumns columns
+#else
+   WCHAR *wcTable = WideStringFromMBString(table);
+   WCHAR *wcColumns = WideStringFromMBString(columns);
+#endif
+   WCHAR errorText[DBDRV_MAX_ERROR_TEXT] = L"";
+   DWORD errorCode = DBERR_OTHER_ERROR;
+
+   MutexLock(hConn->m_mutexTransLock);
+   DBDRV_BULK_LOAD data = hConn->m_driver->m_fpDrvBulkLoadBegin(hConn->m_connection, wcTable, wcColumns, numColumns, &errorCode, errorText);
+   if ((data == nullptr) && (errorCode == DBERR_CONNECTION_LOST) && hConn->m_reconnectEnabled && (hConn->m_transactionLevel == 0))
+   {
+      DBReconnect(hConn);
+      data = hConn->m_driver->m_fpDrvBulkLoadBegin(hConn->m_connection, wcTable, wcColumns, numColumns, &errorCode, errorText);
+   }
+
+#ifndef UNICODE
+   MemFree(wcTable);
+   MemFree(wcColumns);
+#else
+#undef wcTable
+#undef wcColumns
+#endif
+
+   if (data == nullptr)
+   {
+      MutexUnlock(hConn->m_mutexTransLock);
+      s_perfNonSelectQueries++;
+      s_perfTotalQueries++;
+      s_perfFailedQueries++;
+      nxlog_debug_tag(DEBUG_TAG_DRIVER, 4, _T("Cannot start bulk load into table %s: %ls"), table, errorText);
+      return nullptr;
+   }
+
+   // Transaction lock is held until bulk load is completed
+   DB_BULK_LOAD hLoad = MemAllocStruct<db_bulk_load_t>();
+   hLoad->m_connection = hConn;
+   hLoad->m_data = data;
+   hLoad->m_table = MemCopyString(table);
+   hLoad->m_numColumns = numColumns;
+   hLoad->m_rows = 0;
+   hLoad->m_failed = false;
+   hLoad->m_startTime = GetCurrentTimeMs();
+   return hLoad;
+}
+
+/**
+ * Add row to bulk load. Array of values should contain exactly one element per column, nullptr elements
+ * represent NULL values. Returns false on failure; bulk load should be cancelled in that case.
+ */
+bool LIBNXDB_EXPORTABLE DBBulkLoadAddRow(DB_BULK_LOAD hLoad, const TCHAR **values)
+{
+   if (hLoad->m_failed)
+      return false;
+
+   WCHAR errorText[DBDRV_MAX_ERROR_TEXT] = L"";
+#ifdef UNICODE
+   DWORD rc = hLoad->m_connection->m_driver->m_fpDrvBulkLoadAddRow(hLoad->m_data, values, errorText);
+#else
+   WCHAR *wcValues[64];
+   WCHAR **wv = (hLoad->m_numColumns <= 64) ? wcValues : MemAllocArrayNoInit<WCHAR*>(hLoad->m_numColumns);
+   for(int i = 0; i < hLoad->m_numColumns; i++)
+      wv[i] = (values[i] != nullptr) ? WideStringFromMBString(values[i]) : nullptr;
+   DWORD rc = hLoad->m_connection->m_driver->m_fpDrvBulkLoadAddRow(hLoad->m_data, const_cast<const WCHAR**>(wv), errorText);
+   for(int i = 0; i < hLoad->m_numColumns; i++)
+      MemFree(wv[i]);
+   if (wv != wcValues)
+      MemFree(wv);
+#endif
+
+   if (rc != DBERR_SUCCESS)
+   {
+      hLoad->m_failed = true;
+      nxlog_debug_tag(DEBUG_TAG_DRIVER, 4, _T("Bulk load into table %s failed: %ls"), hLoad->m_table, errorText);
+      return false;
+   }
+   hLoad->m_rows++;
+   return true;
+}
+
+/**
+ * Complete bulk load operation (internal implementation)
+ */
+static bool BulkLoadEnd(DB_BULK_LOAD hLoad, bool commit)
+{
+   DB_HANDLE hConn = hLoad->m_connection;
+   WCHAR errorText[DBDRV_MAX_ERROR_TEXT] = L"";
+   bool success = (hConn->m_driver->m_fpDrvBulkLoadEnd(hLoad->m_data, commit && !hLoad->m_failed, errorText) == DBERR_SUCCESS) && commit && !hLoad->m_failed;
+   MutexUnlock(hConn->m_mutexTransLock);
+
+   s_perfNonSelectQueries++;
+   s_perfTotalQueries++;
+
+   int64_t ms = GetCurrentTimeMs() - hLoad->m_startTime;
+   if (s_queryTrace)
+   {
+      nxlog_debug_tag(DEBUG_TAG_QUERY, 9, _T("%s bulk load into table %s (%u rows) [") INT64_FMT _T(" ms]"),
+               success ? _T("Successful") : (commit ? _T("Failed") : _T("Cancelled")), hLoad->m_table, hLoad->m_rows, ms);
+   }
+   if (success && (static_cast<uint32_t>(ms) > g_sqlQueryExecTimeThreshold))
+   {
+      nxlog_debug_tag(DEBUG_TAG_QUERY, 3, _T("Long running bulk load into table %s (%u rows) [") INT64_FMT _T(" ms]"), hLoad->m_table, hLoad->m_rows, ms);
+      s_perfLongRunningQueries++;
+   }
+   if (commit && !success)
+   {
+      s_perfFailedQueries++;
+      if (!hLoad->m_failed)
+         nxlog_debug_tag(DEBUG_TAG_DRIVER, 4, _T("Bulk load into table %s failed: %ls"), hLoad->m_table, errorText);
+   }
+
+   MemFree(hLoad->m_table);
+   MemFree(hLoad);
+   return success;
+}
+
+/**
+ * Complete bulk load operation. Returns true if all rows were loaded successfully. Bulk load handle
+ * is destroyed by this call regardless of result. Within transaction, failed bulk load leaves transaction
+ * in failed state and it should be rolled back.
+ */
+bool LIBNXDB_EXPORTABLE DBBulkLoadEnd(DB_BULK_LOAD hLoad)
+{
+   return BulkLoadEnd(hLoad, true);
+}
+
+/**
+ * Cancel bulk load operation. None of the rows added so far will be stored. Bulk load handle is destroyed by this call.
+ */
+void LIBNXDB_EXPORTABLE DBBulkLoadCancel(DB_BULK_LOAD hLoad)
+{
+   BulkLoadEnd(hLoad, false);
+}
+
 /**
  * Prepare string for using in SQL statement
  */
@@ -1921,6 +2290,19 @@ StringBuffer LIBNXDB_EXPORTABLE DBPrepareStringUTF8(DB_DRIVER drv, const char *s
    return s;
 }
 
+/**
+ * Prepare string for using in SQL statement built as UTF-8 string (for DBQueryUTF8 and friends).
+ * Returned string is dynamically allocated and should be freed by caller with MemFree.
+ */
+char LIBNXDB_EXPORTABLE *DBPrepareStringAsUTF8(DB_HANDLE conn, const TCHAR *str)
+{
+   // Driver's multibyte version only escapes ASCII characters, so it is safe to use on UTF-8 strings
+   char *utf8str = UTF8StringFromTString(CHECK_NULL_EX(str));
+   char *out = conn->m_driver->m_fpDrvPrepareStringA(utf8str);
+   MemFree(utf8str);
+   return out;
+}
+
 /**
  * Check if given table exist
  */
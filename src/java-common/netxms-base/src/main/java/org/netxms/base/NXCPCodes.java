@@ -454,6 +454,14 @@
    public static final int CMD_2FA_GET_USER_BINDING_INFO = 0x01B5;
    public static final int CMD_2FA_MODIFY_USER_BINDING = 0x01B6;
    public static final int CMD_2FA_DELETE_USER_BINDING = 0x01B7;
+   public static final int CMD_WEB_SERVICE_CUSTOM_REQUEST = 0x01B8;
+   public static final int CMD_MERGE_FILES = 0x01B9;
+   public static final int CMD_FILEMGR_MERGE_FILES = 0x01BA;
+   public static final int CMD_PROFILE_LIBRARY_SCRIPT = 0x01BB;
+   public static final int CMD_GET_PERF_STATS = 0x01BC;
+   public static final int CMD_SUBSCRIBE_LAST_VALUES = 0x01BD;
+   public static final int CMD_UNSUBSCRIBE_LAST_VALUES = 0x01BE;
+   public static final int CMD_LAST_VALUES_UPDATE = 0x01BF;
 
 	// CMD_RS_ - Reporting Server related codes
 	public static final int CMD_RS_LIST_REPORTS = 0x1100;
@@ -1223,6 +1231,9 @@
    public static final long VID_HASH_CRC32 = 759;
    public static final long VID_HASH_MD5 = 760;
    public static final long VID_HASH_SHA256 = 761;
+   public static final long VID_DOWNSAMPLING_METHOD = 771;
+   public static final long VID_TARGET_POINT_COUNT = 772;
+   public static final long VID_ENABLE_CHUNKED_DATA = 773;
 
 	public static final long VID_ACL_USER_BASE = 0x00001000L;
 	public static final long VID_ACL_USER_LAST = 0x00001FFFL;
@@ -0,0 +1,204 @@
+/*
+ ** NetXMS - Network Management System
+ ** NetXMS Foundation Library
+ ** Copyright (C) 2003-2021 Raden Solutions
+ **
+ ** This program is free software; you can redistribute it and/or modify
+ ** it under the terms of the GNU Lesser General Public License as published
+ ** by the Free Software Foundation; either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public License
+ ** along with this program; if not, write to the Free Software
+ ** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ **
+ ** File: histogram.cpp
+ **
+ **/
+
+#include "libnetxms.h"
+#include <math.h>
+
+/**
+ * Number of sub-buckets per power of 2
+ */
+#define SUB_BUCKETS  (1 << LATENCY_HISTOGRAM_SUB_BUCKET_BITS)
+
+/**
+ * Number of linear buckets
+ */
+#define LINEAR_BUCKETS  (1 << LATENCY_HISTOGRAM_LINEAR_BITS)
+
+/**
+ * Get index of most significant bit set (value must be non-zero)
+ */
+static inline int HighestBit(uint64_t value)
+{
+   int bit = 0;
+   if (value >= _ULL(0x100000000)) { value >>= 32; bit += 32; }
+   if (value >= 0x10000) { value >>= 16; bit += 16; }
+   if (value >= 0x100) { value >>= 8; bit += 8; }
+   if (value >= 0x10) { value >>= 4; bit += 4; }
+   if (value >= 0x4) { value >>= 2; bit += 2; }
+   if (value >= 0x2) { bit += 1; }
+   return bit;
+}
+
+/**
+ * Copy constructor (takes snapshot of source histogram)
+ */
+LatencyHistogram::LatencyHistogram(const LatencyHistogram& src)
+{
+   for(int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+      m_buckets[i] = src.m_buckets[i];
+   m_count = src.m_count;
+   m_max = src.m_max;
+}
+
+/**
+ * Assignment operator (takes snapshot of source histogram)
+ */
+LatencyHistogram& LatencyHistogram::operator=(const LatencyHistogram& src)
+{
+   if (&src != this)
+   {
+      for(int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+         m_buckets[i] = src.m_buckets[i];
+      m_count = src.m_count;
+      m_max = src.m_max;
+   }
+   return *this;
+}
+
+/**
+ * Get bucket index for given value
+ */
+int LatencyHistogram::bucketIndex(uint64_t value)
+{
+   if (value < LINEAR_BUCKETS)
+      return static_cast<int>(value);
+   int msb = HighestBit(value);
+   if (msb >= LATENCY_HISTOGRAM_MAX_BITS)
+      return LATENCY_HISTOGRAM_BUCKETS - 1;
+   return LINEAR_BUCKETS + (msb - LATENCY_HISTOGRAM_LINEAR_BITS) * SUB_BUCKETS +
+            static_cast<int>((value >> (msb - LATENCY_HISTOGRAM_SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+}
+
+/**
+ * Get lowest value that falls into given bucket
+ */
+uint64_t LatencyHistogram::bucketLowerBound(int index)
+{
+   if (index < LINEAR_BUCKETS)
+      return index;
+   int msb = (index - LINEAR_BUCKETS) / SUB_BUCKETS + LATENCY_HISTOGRAM_LINEAR_BITS;
+   int subBucket = (index - LINEAR_BUCKETS) % SUB_BUCKETS;
+   return static_cast<uint64_t>(SUB_BUCKETS + subBucket) << (msb - LATENCY_HISTOGRAM_SUB_BUCKET_BITS);
+}
+
+/**
+ * Get highest value that falls into given bucket (except last bucket which is open-ended)
+ */
+uint64_t LatencyHistogram::bucketUpperBound(int index)
+{
+   if (index < LINEAR_BUCKETS)
+      return index;
+   int msb = (index - LINEAR_BUCKETS) / SUB_BUCKETS + LATENCY_HISTOGRAM_LINEAR_BITS;
+   return bucketLowerBound(index) + (_ULL(1) << (msb - LATENCY_HISTOGRAM_SUB_BUCKET_BITS)) - 1;
+}
+
+/**
+ * Add value to histogram
+ */
+void LatencyHistogram::update(uint64_t value)
+{
+   InterlockedIncrement(&m_buckets[bucketIndex(value)]);
+   InterlockedIncrement64(&m_count);
+
+   int32_t v = (value < 0x7FFFFFFF) ? static_cast<int32_t>(value) : 0x7FFFFFFF;
+   int32_t curr;
+   while((curr = m_max) < v)
+   {
+      if (InterlockedCompareExchange(&m_max, v, curr) == curr)
+         break;
+   }
+}
+
+/**
+ * Merge counters from another histogram into this one. This method is not atomic
+ * and intended for combining snapshots.
+ */
+void LatencyHistogram::merge(const LatencyHistogram& src)
+{
+   for(int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+      m_buckets[i] += src.m_buckets[i];
+   m_count += src.m_count;
+   if (src.m_max > m_max)
+      m_max = src.m_max;
+}
+
+/**
+ * Reset all counters
+ */
+void LatencyHistogram::reset()
+{
+   for(int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+      m_buckets[i] = 0;
+   m_count = 0;
+   m_max = 0;
+}
+
+/**
+ * Get value at given percentile (0..100). Returned value is upper bound of the bucket
+ * where requested percentile falls, but never higher than maximum recorded value.
+ */
+uint64_t LatencyHistogram::getPercentile(double percentile) const
+{
+   // Bucket counters and total count can be updated concurrently, so total is calculated from buckets
+   uint64_t total = 0;
+   for(int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+      total += static_cast<uint32_t>(m_buckets[i]);
+   if (total == 0)
+      return 0;
+
+   if (percentile < 0)
+      percentile = 0;
+   else if (percentile > 100)
+      percentile = 100;
+   uint64_t target = static_cast<uint64_t>(ceil(static_cast<double>(total) * percentile / 100.0));
+   if (target == 0)
+      target = 1;
+
+   uint64_t max = static_cast<uint32_t>(m_max);
+   uint64_t count = 0;
+   for(int i = 0; i < LATENCY_HISTOGRAM_BUCKETS - 1; i++)
+   {
+      count += static_cast<uint32_t>(m_buckets[i]);
+      if (count >= target)
+         return std::min(bucketUpperBound(i), max);
+   }
+   return max;
+}
+
+/**
+ * Get approximate mean value (calculated from bucket midpoints)
+ */
+double LatencyHistogram::getMean() const
+{
+   uint64_t total = 0;
+   double sum = 0;
+   for(int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+   {
+      uint32_t count = static_cast<uint32_t>(m_buckets[i]);
+      if (count == 0)
+         continue;
+      total += count;
+      sum += static_cast<double>(count) * (static_cast<double>(bucketLowerBound(i)) + static_cast<double>(bucketUpperBound(i))) / 2;
+   }
+   return (total > 0) ? sum / static_cast<double>(total) : 0;
+}
@@ -485,7 +485,12 @@ TCHAR LIBNETXMS_EXPORTABLE *NXCPMessageCodeName(uint16_t code, TCHAR *buffer)
       _T("CMD_2FA_DELETE_USER_BINDING"),
       _T("CMD_WEB_SERVICE_CUSTOM_REQUEST"),
       _T("CMD_MERGE_FILES"),
-      _T("CMD_FILEMGR_MERGE_FILES")
+      _T("CMD_FILEMGR_MERGE_FILES"),
+      _T("CMD_PROFILE_LIBRARY_SCRIPT"),
+      _T("CMD_GET_PERF_STATS"),
+      _T("CMD_SUBSCRIBE_LAST_VALUES"),
+      _T("CMD_UNSUBSCRIBE_LAST_VALUES"),
+      _T("CMD_LAST_VALUES_UPDATE")
    };
    static const TCHAR *reportingMessageNames[] =
    {
@@ -498,7 +503,7 @@ TCHAR LIBNETXMS_EXPORTABLE *NXCPMessageCodeName(uint16_t code, TCHAR *buffer)
       _T("CMD_RS_NOTIFY")
    };
 
-   if ((code >= CMD_LOGIN) && (code <= CMD_FILEMGR_MERGE_FILES))
+   if ((code >= CMD_LOGIN) && (code <= CMD_LAST_VALUES_UPDATE))
    {
       _tcscpy(buffer, messageNames[code - CMD_LOGIN]);
    }
@@ -0,0 +1,373 @@
+/*
+ ** NetXMS - Network Management System
+ ** NetXMS Foundation Library
+ ** Copyright (C) 2003-2021 Raden Solutions
+ **
+ ** This program is free software; you can redistribute it and/or modify
+ ** it under the terms of the GNU Lesser General Public License as published
+ ** by the Free Software Foundation; either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public License
+ ** along with this program; if not, write to the Free Software
+ ** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ **
+ ** File: prefixtree.cpp
+ **
+ **/
+
+#include "libnetxms.h"
+
+/**
+ * Tree node. Key contains prefix bits in network byte order, bits beyond prefix length are always zero.
+ * Nodes without value are branch nodes and always have both children.
+ */
+struct InetAddressPrefixTreeNode
+{
+   InetAddressPrefixTreeNode *child[2];
+   void *value;
+   int bits;
+   BYTE key[16];
+};
+
+/**
+ * Get bit at given position from key
+ */
+static inline int KeyBit(const BYTE *key, int bit)
+{
+   return (key[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+/**
+ * Get length of common prefix of two keys (limited by maxBits)
+ */
+static int CommonPrefixLength(const BYTE *key1, const BYTE *key2, int maxBits)
+{
+   int bits = 0;
+   for(int i = 0; bits < maxBits; i++, bits += 8)
+   {
+      BYTE diff = key1[i] ^ key2[i];
+      if (diff != 0)
+      {
+         while((diff & 0x80) == 0)
+         {
+            diff <<= 1;
+            bits++;
+         }
+         break;
+      }
+   }
+   return std::min(bits, maxBits);
+}
+
+/**
+ * Create new node
+ */
+static InetAddressPrefixTreeNode *CreateNode(const BYTE *key, int bits, void *value)
+{
+   auto node = MemAllocStruct<InetAddressPrefixTreeNode>();
+   int bytes = (bits + 7) / 8;
+   memcpy(node->key, key, bytes);
+   if ((bits & 7) != 0)
+      node->key[bytes - 1] &= static_cast<BYTE>(0xFF << (8 - (bits & 7)));
+   node->bits = bits;
+   node->value = value;
+   return node;
+}
+
+/**
+ * Destroy subtree
+ */
+static void DestroySubtree(InetAddressPrefixTreeNode *node)
+{
+   if (node == nullptr)
+      return;
+   DestroySubtree(node->child[0]);
+   DestroySubtree(node->child[1]);
+   MemFree(node);
+}
+
+/**
+ * Remove node at given link if it has no value and less than two children
+ */
+static void CompactNode(InetAddressPrefixTreeNode **link)
+{
+   InetAddressPrefixTreeNode *node = *link;
+   if ((node->value != nullptr) || ((node->child[0] != nullptr) && (node->child[1] != nullptr)))
+      return;
+   *link = (node->child[0] != nullptr) ? node->child[0] : node->child[1];
+   MemFree(node);
+}
+
+/**
+ * Call enumeration callback for all values in subtree
+ */
+static void EnumerateSubtree(const InetAddressPrefixTreeNode *node, int family, InetAddressPrefixTreeCallback callback, void *context)
+{
+   if (node == nullptr)
+      return;
+
+   if (node->value != nullptr)
+   {
+      InetAddress prefix;
+      if (family == AF_INET)
+      {
+         uint32_t addr;
+         memcpy(&addr, node->key, 4);
+         prefix = InetAddress(ntohl(addr));
+      }
+      else
+      {
+         prefix = InetAddress(node->key);
+      }
+      prefix.setMaskBits(node->bits);
+      callback(prefix, node->value, context);
+   }
+   EnumerateSubtree(node->child[0], family, callback, context);
+   EnumerateSubtree(node->child[1], family, callback, context);
+}
+
+/**
+ * Constructor
+ */
+InetAddressPrefixTree::InetAddressPrefixTree()
+{
+   m_rootV4 = nullptr;
+   m_rootV6 = nullptr;
+   m_size = 0;
+}
+
+/**
+ * Destructor
+ */
+InetAddressPrefixTree::~InetAddressPrefixTree()
+{
+   DestroySubtree(m_rootV4);
+   DestroySubtree(m_rootV6);
+}
+
+/**
+ * Get root for given address family and build search key. Returns NULL for unsupported address family.
+ */
+InetAddressPrefixTreeNode **InetAddressPrefixTree::getRoot(const InetAddress& addr, BYTE *key, int *maxBits) const
+{
+   if (addr.getFamily() == AF_INET)
+   {
+      uint32_t a = htonl(addr.getAddressV4());
+      memcpy(key, &a, 4);
+      memset(&key[4], 0, 12);
+      *maxBits = 32;
+      return const_cast<InetAddressPrefixTreeNode**>(&m_rootV4);
+   }
+   if (addr.getFamily() == AF_INET6)
+   {
+      memcpy(key, addr.getAddressV6(), 16);
+      *maxBits = 128;
+      return const_cast<InetAddressPrefixTreeNode**>(&m_rootV6);
+   }
+   return nullptr;
+}
+
+/**
+ * Add prefix to the tree. Prefix length is taken from address mask bits.
+ * Returns value previously associated with same prefix or NULL.
+ */
+void *InetAddressPrefixTree::put(const InetAddress& prefix, void *value)
+{
+   BYTE key[16];
+   int maxBits;
+   InetAddressPrefixTreeNode **link = getRoot(prefix, key, &maxBits);
+   int bits = prefix.getMaskBits();
+   if ((link == nullptr) || (value == nullptr) || (bits < 0) || (bits > maxBits))
+      return nullptr;
+
+   InetAddressPrefixTreeNode *node = *link;
+   while(node != nullptr)
+   {
+      int common = CommonPrefixLength(node->key, key, std::min(node->bits, bits));
+      if (common < node->bits)
+      {
+         InetAddressPrefixTreeNode *newNode = CreateNode(key, bits, value);
+         if (common == bits)
+         {
+            // New prefix contains current node
+            newNode->child[KeyBit(node->key, bits)] = node;
+            *link = newNode;
+         }
+         else
+         {
+            // Prefixes diverge, create branch node
+            InetAddressPrefixTreeNode *branch = CreateNode(key, common, nullptr);
+            branch->child[KeyBit(key, common)] = newNode;
+            branch->child[KeyBit(node->key, common)] = node;
+            *link = branch;
+         }
+         m_size++;
+         return nullptr;
+      }
+
+      if (node->bits == bits)
+      {
+         void *prevValue = node->value;
+         node->value = value;
+         if (prevValue == nullptr)
+            m_size++;
+         return prevValue;
+      }
+
+      link = &node->child[KeyBit(key, node->bits)];
+      node = *link;
+   }
+
+   *link = CreateNode(key, bits, value);
+   m_size++;
+   return nullptr;
+}
+
+/**
+ * Remove prefix from the tree. Returns value associated with removed prefix or NULL if prefix was not found.
+ */
+void *InetAddressPrefixTree::remove(const InetAddress& prefix)
+{
+   BYTE key[16];
+   int maxBits;
+   InetAddressPrefixTreeNode **link = getRoot(prefix, key, &maxBits);
+   int bits = prefix.getMaskBits();
+   if ((link == nullptr) || (bits < 0) || (bits > maxBits))
+      return nullptr;
+
+   InetAddressPrefixTreeNode **parentLink = nullptr;
+   InetAddressPrefixTreeNode *node = *link;
+   while((node != nullptr) && (node->bits < bits))
+   {
+      if (CommonPrefixLength(node->key, key, node->bits) < node->bits)
+         return nullptr;
+      parentLink = link;
+      link = &node->child[KeyBit(key, node->bits)];
+      node = *link;
+   }
+
+   if ((node == nullptr) || (node->bits != bits) || (node->value == nullptr) || (CommonPrefixLength(node->key, key, bits) < bits))
+      return nullptr;
+
+   void *value = node->value;
+   node->value = nullptr;
+   m_size--;
+
+   CompactNode(link);
+   if (parentLink != nullptr)
+      CompactNode(parentLink);
+   return value;
+}
+
+/**
+ * Get value associated with exactly given prefix
+ */
+void *InetAddressPrefixTree::get(const InetAddress& prefix) const
+{
+   BYTE key[16];
+   int maxBits;
+   InetAddressPrefixTreeNode **root = getRoot(prefix, key, &maxBits);
+   int bits = prefix.getMaskBits();
+   if ((root == nullptr) || (bits < 0) || (bits > maxBits))
+      return nullptr;
+
+   const InetAddressPrefixTreeNode *node = *root;
+   while((node != nullptr) && (node->bits <= bits))
+   {
+      if (CommonPrefixLength(node->key, key, node->bits) < node->bits)
+         break;
+      if (node->bits == bits)
+         return node->value;
+      node = node->child[KeyBit(key, node->bits)];
+   }
+   return nullptr;
+}
+
+/**
+ * Find value associated with longest prefix containing given address (address mask bits are ignored)
+ */
+void *InetAddressPrefixTree::findLongestMatch(const InetAddress& addr) const
+{
+   BYTE key[16];
+   int maxBits;
+   InetAddressPrefixTreeNode **root = getRoot(addr, key, &maxBits);
+   if (root == nullptr)
+      return nullptr;
+
+   void *value = nullptr;
+   const InetAddressPrefixTreeNode *node = *root;
+   while(node != nullptr)
+   {
+      if (CommonPrefixLength(node->key, key, node->bits) < node->bits)
+         break;
+      if (node->value != nullptr)
+         value = node->value;
+      if (node->bits == maxBits)
+         break;
+      node = node->child[KeyBit(key, node->bits)];
+   }
+   return value;
+}
+
+/**
+ * Enumerate all prefixes that contain given prefix or are contained within it
+ */
+void InetAddressPrefixTree::findOverlapping(const InetAddress& prefix, InetAddressPrefixTreeCallback callback, void *context) const
+{
+   BYTE key[16];
+   int maxBits;
+   InetAddressPrefixTreeNode **root = getRoot(prefix, key, &maxBits);
+   int bits = prefix.getMaskBits();
+   if ((root == nullptr) || (bits < 0) || (bits > maxBits))
+      return;
+
+   const InetAddressPrefixTreeNode *node = *root;
+   while(node != nullptr)
+   {
+      int common = CommonPrefixLength(node->key, key, std::min(node->bits, bits));
+      if (common == bits)
+      {
+         // All prefixes in this subtree are within given prefix
+         EnumerateSubtree(node, prefix.getFamily(), callback, context);
+         break;
+      }
+      if (common < node->bits)
+         break;
+
+      // Node prefix contains given prefix
+      if (node->value != nullptr)
+      {
+         InetAddress nodePrefix = prefix.getSubnetAddress();
+         nodePrefix.setMaskBits(node->bits);
+         callback(nodePrefix.getSubnetAddress(), node->value, context);
+      }
+      node = node->child[KeyBit(key, node->bits)];
+   }
+}
+
+/**
+ * Enumerate all prefixes in the tree
+ */
+void InetAddressPrefixTree::forEach(InetAddressPrefixTreeCallback callback, void *context) const
+{
+   EnumerateSubtree(m_rootV4, AF_INET, callback, context);
+   EnumerateSubtree(m_rootV6, AF_INET6, callback, context);
+}
+
+/**
+ * Remove all prefixes from the tree
+ */
+void InetAddressPrefixTree::clear()
+{
+   DestroySubtree(m_rootV4);
+   DestroySubtree(m_rootV6);
+   m_rootV4 = nullptr;
+   m_rootV6 = nullptr;
+   m_size = 0;
+}
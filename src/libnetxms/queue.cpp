@@ -29,12 +29,22 @@
 struct QueueBuffer
 {
    QueueBuffer *next;
+   uint64_t *timestamps;   // Enqueue timestamps in microseconds (only allocated when wait time histogram is enabled)
    size_t head;
    size_t tail;
    size_t count;
    void *elements[1];   // actual size determined by Queue class
 };
 
+/**
+ * Free queue buffer
+ */
+static inline void FreeQueueBuffer(QueueBuffer *buffer)
+{
+   MemFree(buffer->timestamps);
+   MemFree(buffer);
+}
+
 /**
  * Default object destructor
  */
@@ -94,6 +104,7 @@ void Queue::commonInit()
    m_tail = m_head;
 	m_shutdownFlag = false;
 	m_destructor = DefaultElementDestructor;
+   m_waitTimeHistogram = nullptr;
 }
 
 /**
@@ -116,11 +127,12 @@ Queue::~Queue()
       }
 
       auto next = buffer->next;
-      MemFree(buffer);
+      FreeQueueBuffer(buffer);
       buffer = next;
    }
 
    setShutdownMode();
+   delete m_waitTimeHistogram;
 
 #ifdef _WIN32
    DeleteCriticalSection(&m_lock);
@@ -131,11 +143,44 @@ Queue::~Queue()
 }
 
 /**
- * Put new element into queue
+ * Enable wait time (enqueue to dequeue) histogram for this queue. Elements already in queue are not counted.
  */
-void Queue::put(void *element)
+void Queue::enableWaitTimeHistogram()
 {
    lock();
+   if (m_waitTimeHistogram == nullptr)
+      m_waitTimeHistogram = new LatencyHistogram();
+   unlock();
+}
+
+/**
+ * Get estimated memory usage by queue buffers. Value is calculated from block count
+ * without locking queue or walking buffer chain.
+ */
+uint64_t Queue::getMemoryUsage() const
+{
+   size_t blockCount = m_blockCount;
+   uint64_t blockSize = sizeof(QueueBuffer) + (m_blockSize - 1) * sizeof(void*);
+   if (m_waitTimeHistogram != nullptr)
+      blockSize += m_blockSize * sizeof(uint64_t);
+   return sizeof(Queue) + blockCount * blockSize;
+}
+
+/**
+ * Set enqueue timestamp for element at given position. Current thread must own queue lock.
+ */
+void Queue::setTimestamp(QueueBuffer *buffer, size_t pos)
+{
+   if (buffer->timestamps == nullptr)
+      buffer->timestamps = MemAllocArray<uint64_t>(m_blockSize);
+   buffer->timestamps[pos] = GetMonotonicClockTimeNs() / 1000;
+}
+
+/**
+ * Put new element into queue. Current thread must own queue lock.
+ */
+void Queue::putInternal(void *element)
+{
    if (m_tail->count == m_blockSize)
    {
       // Allocate new buffer
@@ -143,11 +188,22 @@ void Queue::put(void *element)
       m_tail = m_tail->next;
       m_blockCount++;
    }
+   if (m_waitTimeHistogram != nullptr)
+      setTimestamp(m_tail, m_tail->tail);
    m_tail->elements[m_tail->tail++] = element;
    if (m_tail->tail == m_blockSize)
       m_tail->tail = 0;
    m_tail->count++;
    m_size++;
+}
+
+/**
+ * Put new element into queue
+ */
+void Queue::put(void *element)
+{
+   lock();
+   putInternal(element);
    if (m_readers > 0)
    {
 #ifdef _WIN32
@@ -159,6 +215,25 @@ void Queue::put(void *element)
    unlock();
 }
 
+/**
+ * Put multiple elements into queue with single lock
+ */
+void Queue::putAll(void **elements, size_t count)
+{
+   lock();
+   for(size_t i = 0; i < count; i++)
+      putInternal(elements[i]);
+   if (m_readers > 0)
+   {
+#ifdef _WIN32
+      WakeAllConditionVariable(&m_wakeupCondition);
+#else
+      pthread_cond_broadcast(&m_wakeupCondition);
+#endif
+   }
+   unlock();
+}
+
 /**
  * Insert new element into the beginning of a queue
  */
@@ -176,6 +251,8 @@ void Queue::insert(void *element)
    if (m_head->head == 0)
       m_head->head = m_blockSize;
    m_head->elements[--m_head->head] = element;
+   if (m_waitTimeHistogram != nullptr)
+      setTimestamp(m_head, m_head->head);
    m_head->count++;
    m_size++;
    if (m_readers > 0)
@@ -200,6 +277,11 @@ void *Queue::getInternal()
    void *element = NULL;
    while((m_size > 0) && (element == NULL))
    {
+      if ((m_head->timestamps != nullptr) && (m_head->timestamps[m_head->head] != 0) &&
+          (m_head->elements[m_head->head] != nullptr) && (m_head->elements[m_head->head] != INVALID_POINTER_VALUE))
+      {
+         m_waitTimeHistogram->update(GetMonotonicClockTimeNs() / 1000 - m_head->timestamps[m_head->head]);
+      }
       element = m_head->elements[m_head->head++];
       if (m_head->head == m_blockSize)
          m_head->head = 0;
@@ -209,7 +291,7 @@ void *Queue::getInternal()
       {
          auto tmp = m_head;
          m_head = m_head->next;
-         MemFree(tmp);
+         FreeQueueBuffer(tmp);
          m_blockCount--;
       }
    }
@@ -227,6 +309,26 @@ void *Queue::get()
    return element;
 }
 
+/**
+ * Get up to maxCount elements from queue with single lock. Returns number of elements retrieved.
+ */
+size_t Queue::getAll(void **buffer, size_t maxCount)
+{
+   size_t count = 0;
+   lock();
+   while(count < maxCount)
+   {
+      void *element = getInternal();
+      if (element == nullptr)
+         break;
+      buffer[count++] = element;
+      if (element == INVALID_POINTER_VALUE)
+         break;
+   }
+   unlock();
+   return count;
+}
+
 /**
  * Get object from queue or block with timeout if queue if empty
  */
@@ -307,7 +409,7 @@ void Queue::clear()
       else
       {
          auto next = buffer->next;
-         MemFree(buffer);
+         FreeQueueBuffer(buffer);
          buffer = next;
       }
    }
@@ -419,3 +521,303 @@ void Queue::forEach(QueueEnumerationCallback callback, void *context)
 stop_enumeration:
    unlock();
 }
+
+/**
+ * Ring buffer slot for MPSC queue. Sequence number indicates slot state: it is equal to
+ * position for free slot and to position + 1 for slot with published element.
+ */
+struct MPSCQueueSlot
+{
+   atomic<uint64_t> sequence;
+   void *element;
+};
+
+/**
+ * Default object destructor for MPSC queue
+ */
+static void DefaultMPSCQueueElementDestructor(void *element, MPSCQueue *queue)
+{
+   MemFree(element);
+}
+
+/**
+ * MPSC queue constructor. Capacity is rounded up to nearest power of 2.
+ */
+MPSCQueue::MPSCQueue(size_t capacity, Ownership owner) : m_overflow(256, Ownership::False), m_wakeupCondition(false)
+{
+   m_capacity = 2;
+   while(m_capacity < capacity)
+      m_capacity <<= 1;
+   m_mask = m_capacity - 1;
+   m_ring = MemAllocArrayNoInit<MPSCQueueSlot>(m_capacity);
+   for(size_t i = 0; i < m_capacity; i++)
+   {
+      new(&m_ring[i].sequence) atomic<uint64_t>(i);
+      m_ring[i].element = nullptr;
+   }
+   m_tail = 0;
+   m_head = 0;
+   m_overflowSize = 0;
+   m_overflowCount = 0;
+   m_consumerWaiting = false;
+   m_owner = (owner == Ownership::True);
+   m_destructor = DefaultMPSCQueueElementDestructor;
+}
+
+/**
+ * MPSC queue destructor. Should only be called when there are no active producers.
+ */
+MPSCQueue::~MPSCQueue()
+{
+   clear();
+   MemFree(m_ring);
+}
+
+/**
+ * Try to put element into ring buffer. Returns false if ring buffer is full.
+ */
+bool MPSCQueue::putToRing(void *element)
+{
+   uint64_t pos = m_tail.load(std::memory_order_relaxed);
+   while(true)
+   {
+      MPSCQueueSlot *slot = &m_ring[pos & m_mask];
+      int64_t diff = static_cast<int64_t>(slot->sequence.load(std::memory_order_acquire) - pos);
+      if (diff == 0)
+      {
+         if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+         {
+            slot->element = element;
+            slot->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+         }
+      }
+      else if (diff < 0)
+      {
+         return false;  // Slot still contains element from previous round
+      }
+      else
+      {
+         pos = m_tail.load(std::memory_order_relaxed);
+      }
+   }
+}
+
+/**
+ * Try to put all elements into ring buffer as continuous block. Because consumer releases
+ * slots in order, all slots in the block are free if last one is free.
+ */
+bool MPSCQueue::putAllToRing(void **elements, size_t count)
+{
+   uint64_t pos = m_tail.load(std::memory_order_relaxed);
+   while(true)
+   {
+      MPSCQueueSlot *last = &m_ring[(pos + count - 1) & m_mask];
+      int64_t diff = static_cast<int64_t>(last->sequence.load(std::memory_order_acquire) - (pos + count - 1));
+      if (diff == 0)
+      {
+         if (m_tail.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+            break;
+      }
+      else if (diff < 0)
+      {
+         return false;
+      }
+      else
+      {
+         pos = m_tail.load(std::memory_order_relaxed);
+      }
+   }
+
+   for(size_t i = 0; i < count; i++)
+   {
+      MPSCQueueSlot *slot = &m_ring[(pos + i) & m_mask];
+      slot->element = elements[i];
+      slot->sequence.store(pos + i + 1, std::memory_order_release);
+   }
+   return true;
+}
+
+/**
+ * Put element into ring buffer or into overflow queue. Once overflow queue is not empty, all new
+ * elements go there until consumer drains it, so order of elements from single producer is preserved.
+ */
+void MPSCQueue::putInternal(void *element)
+{
+   if ((m_overflowSize.load(std::memory_order_acquire) > 0) || !putToRing(element))
+   {
+      m_overflow.put(element);
+      m_overflowSize.fetch_add(1, std::memory_order_release);
+   }
+}
+
+/**
+ * Wake up consumer if it is waiting for new elements. Only first producer that observes
+ * waiting consumer sets wakeup condition.
+ */
+void MPSCQueue::wakeupConsumer()
+{
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+   if (m_consumerWaiting.load(std::memory_order_relaxed) && m_consumerWaiting.exchange(false, std::memory_order_relaxed))
+      m_wakeupCondition.set();
+}
+
+/**
+ * Put element into queue
+ */
+void MPSCQueue::put(void *element)
+{
+   putInternal(element);
+   wakeupConsumer();
+}
+
+/**
+ * Put multiple elements into queue. Elements are placed into ring buffer with single atomic
+ * operation if there is enough space, otherwise remaining elements are placed into overflow
+ * queue with single lock.
+ */
+void MPSCQueue::putAll(void **elements, size_t count)
+{
+   if (count == 0)
+      return;
+
+   size_t pos = 0;
+   if (m_overflowSize.load(std::memory_order_acquire) == 0)
+   {
+      if ((count <= m_capacity) && putAllToRing(elements, count))
+         pos = count;
+      else
+         while((pos < count) && putToRing(elements[pos]))
+            pos++;
+   }
+   if (pos < count)
+   {
+      m_overflow.putAll(&elements[pos], count - pos);
+      m_overflowSize.fetch_add(count - pos, std::memory_order_release);
+   }
+   wakeupConsumer();
+}
+
+/**
+ * Get up to maxCount elements from queue without blocking. Returns number of elements retrieved.
+ * Overflow queue is only read when all claimed ring buffer slots are consumed.
+ */
+size_t MPSCQueue::getAll(void **buffer, size_t maxCount)
+{
+   size_t count = 0;
+   uint64_t pos = m_head.load(std::memory_order_relaxed);
+   while(count < maxCount)
+   {
+      MPSCQueueSlot *slot = &m_ring[pos & m_mask];
+      if (slot->sequence.load(std::memory_order_acquire) != pos + 1)
+         break;   // Empty or producer has not completed write yet
+      buffer[count++] = slot->element;
+      slot->sequence.store(pos + m_capacity, std::memory_order_release);
+      pos++;
+   }
+   m_head.store(pos, std::memory_order_relaxed);
+
+   if ((count < maxCount) && (m_overflowSize.load(std::memory_order_acquire) > 0) && (pos == m_tail.load(std::memory_order_acquire)))
+   {
+      size_t overflowCount = m_overflow.getAll(&buffer[count], maxCount - count);
+      if (overflowCount > 0)
+      {
+         m_overflowSize.fetch_sub(overflowCount, std::memory_order_release);
+         m_overflowCount.store(m_overflowCount.load(std::memory_order_relaxed) + overflowCount, std::memory_order_relaxed);   // Only updated by consumer
+         count += overflowCount;
+      }
+   }
+   return count;
+}
+
+/**
+ * Get up to maxCount elements from queue, waiting for at least one element with given timeout.
+ * Returns number of elements retrieved (0 on timeout).
+ */
+size_t MPSCQueue::getAllOrBlock(void **buffer, size_t maxCount, uint32_t timeout)
+{
+   size_t count = getAll(buffer, maxCount);
+   if ((count > 0) || (timeout == 0))
+      return count;
+
+   uint64_t startTime = GetMonotonicClockTimeNs() / 1000000;
+   uint32_t waitTime = timeout;
+   while(true)
+   {
+      m_consumerWaiting.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      count = getAll(buffer, maxCount);
+      if (count > 0)
+         break;
+
+      m_wakeupCondition.wait(waitTime);
+      m_consumerWaiting.store(false, std::memory_order_relaxed);
+      count = getAll(buffer, maxCount);
+      if (count > 0)
+         break;
+
+      if (timeout != INFINITE)
+      {
+         uint64_t elapsed = GetMonotonicClockTimeNs() / 1000000 - startTime;
+         if (elapsed >= timeout)
+            break;
+         waitTime = timeout - static_cast<uint32_t>(elapsed);
+      }
+   }
+   m_consumerWaiting.store(false, std::memory_order_relaxed);
+   return count;
+}
+
+/**
+ * Get element from queue. Returns NULL if queue is empty.
+ */
+void *MPSCQueue::get()
+{
+   void *element;
+   return (getAll(&element, 1) > 0) ? element : nullptr;
+}
+
+/**
+ * Get element from queue or block with timeout if queue is empty
+ */
+void *MPSCQueue::getOrBlock(uint32_t timeout)
+{
+   void *element;
+   return (getAllOrBlock(&element, 1, timeout) > 0) ? element : nullptr;
+}
+
+/**
+ * Clear queue. Should only be called by consumer.
+ */
+void MPSCQueue::clear()
+{
+   void *elements[256];
+   size_t count;
+   while((count = getAll(elements, 256)) > 0)
+   {
+      if (!m_owner)
+         continue;
+      for(size_t i = 0; i < count; i++)
+         if (elements[i] != INVALID_POINTER_VALUE)
+            m_destructor(elements[i], this);
+   }
+}
+
+/**
+ * Get approximate number of elements in queue
+ */
+size_t MPSCQueue::size() const
+{
+   uint64_t head = m_head.load(std::memory_order_relaxed);
+   uint64_t tail = m_tail.load(std::memory_order_relaxed);
+   int64_t overflowSize = m_overflowSize.load(std::memory_order_relaxed);
+   return static_cast<size_t>(tail - head) + static_cast<size_t>((overflowSize > 0) ? overflowSize : 0);
+}
+
+/**
+ * Get estimated memory usage by queue ring buffer and overflow queue
+ */
+uint64_t MPSCQueue::getMemoryUsage() const
+{
+   return sizeof(MPSCQueue) + m_capacity * sizeof(MPSCQueueSlot) + m_overflow.getMemoryUsage() - sizeof(Queue);
+}
@@ -431,6 +431,432 @@ char *Table::createPackedXML() const
    return encodedBuffer;
 }
 
+/**
+ * Signature of packed binary table. Packed XML starts with most significant byte
+ * of uncompressed XML length, so it can never start with 0xFF.
+ */
+static const BYTE s_packedBinarySignature[4] = { 0xFF, 'N', 'X', 'T' };
+
+/**
+ * Packed binary table format version
+ */
+#define PACKED_BINARY_VERSION    1
+
+/**
+ * Size of packed binary table header (signature, version, uncompressed size)
+ */
+#define PACKED_BINARY_HEADER_SIZE   9
+
+/**
+ * Column encodings for packed binary table
+ */
+#define COLUMN_ENCODING_PLAIN       0
+#define COLUMN_ENCODING_DICTIONARY  1
+#define COLUMN_ENCODING_INTEGER     2
+
+/**
+ * Write unsigned variable length integer
+ */
+static void WriteVarUInt(ByteStream& out, uint64_t value)
+{
+   BYTE buffer[10];
+   int len = 0;
+   while(value >= 0x80)
+   {
+      buffer[len++] = static_cast<BYTE>(value | 0x80);
+      value >>= 7;
+   }
+   buffer[len++] = static_cast<BYTE>(value);
+   out.write(buffer, len);
+}
+
+/**
+ * Write signed variable length integer (zigzag encoded)
+ */
+static inline void WriteVarInt(ByteStream& out, int64_t value)
+{
+   WriteVarUInt(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+/**
+ * Read unsigned variable length integer
+ */
+static uint64_t ReadVarUInt(ByteStream& in, bool *error)
+{
+   uint64_t value = 0;
+   for(int shift = 0; shift < 64; shift += 7)
+   {
+      if (in.eos())
+         break;
+      BYTE b = in.readByte();
+      value |= static_cast<uint64_t>(b & 0x7F) << shift;
+      if (!(b & 0x80))
+         return value;
+   }
+   *error = true;
+   return 0;
+}
+
+/**
+ * Read signed variable length integer
+ */
+static inline int64_t ReadVarInt(ByteStream& in, bool *error)
+{
+   uint64_t v = ReadVarUInt(in, error);
+   return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+/**
+ * Write string as UTF-8 prepended with length + 1 (0 is used for null)
+ */
+static void WriteTableString(ByteStream& out, const TCHAR *s)
+{
+   if (s == nullptr)
+   {
+      out.write(static_cast<BYTE>(0));
+      return;
+   }
+
+   size_t slen = _tcslen(s);
+   char localBuffer[1024];
+   char *buffer = (slen < 256) ? localBuffer : MemAllocStringA(slen * 4 + 1);
+   size_t len = (slen > 0) ? tchar_to_utf8(s, slen, buffer, (slen < 256) ? 1024 : slen * 4 + 1) : 0;
+   WriteVarUInt(out, len + 1);
+   out.write(buffer, len);
+   if (buffer != localBuffer)
+      MemFree(buffer);
+}
+
+/**
+ * Read string written by WriteTableString
+ */
+static TCHAR *ReadTableString(ByteStream& in, bool *error)
+{
+   uint64_t len = ReadVarUInt(in, error);
+   if (*error || (len == 0))
+      return nullptr;
+   len--;
+   if (in.size() - in.pos() < len)
+   {
+      *error = true;
+      return nullptr;
+   }
+
+   TCHAR *s = MemAllocString(len + 1);
+   size_t chars = (len > 0) ? utf8_to_tchar(reinterpret_cast<const char*>(in.buffer() + in.pos()), len, s, len + 1) : 0;
+   s[chars] = 0;
+   in.seek(in.pos() + len);
+   return s;
+}
+
+/**
+ * Check if given string is canonical representation of integer that can be restored without loss
+ */
+static bool IsCanonicalInteger(const TCHAR *s)
+{
+   if ((s == nullptr) || (*s == 0))
+      return false;
+
+   const TCHAR *p = (*s == _T('-')) ? s + 1 : s;
+   if (*p == _T('0'))
+      return (p == s) && (p[1] == 0);  // "0" is canonical, "-0" and "01" are not
+
+   int digits = 0;
+   for(; *p != 0; p++, digits++)
+   {
+      if ((*p < _T('0')) || (*p > _T('9')) || (digits == 18))
+         return false;
+   }
+   return digits > 0;
+}
+
+/**
+ * Encode single table column. Integer columns are stored as deltas between rows, columns with
+ * many repeating values (and instance columns) as dictionary and row indexes.
+ */
+static void EncodeColumn(ByteStream& out, const ObjectArray<TableRow>& rows, int column, bool instanceColumn)
+{
+   bool integer = !rows.isEmpty();
+   for(int i = 0; (i < rows.size()) && integer; i++)
+      integer = IsCanonicalInteger(rows.get(i)->getValue(column));
+
+   if (integer)
+   {
+      out.write(static_cast<BYTE>(COLUMN_ENCODING_INTEGER));
+      int64_t prev = 0;
+      for(int i = 0; i < rows.size(); i++)
+      {
+         int64_t value = _tcstoll(rows.get(i)->getValue(column), nullptr, 10);
+         WriteVarInt(out, value - prev);
+         prev = value;
+      }
+   }
+   else
+   {
+      StringObjectMap<void> dictionary(Ownership::False, nullptr);
+      ObjectArray<const TCHAR> dictionaryElements(64, 64, Ownership::False);
+      IntegerArray<uint32_t> indexes(rows.size());
+      int dictionaryLimit = instanceColumn ? rows.size() : rows.size() / 2;
+      for(int i = 0; (i < rows.size()) && (dictionaryElements.size() <= dictionaryLimit); i++)
+      {
+         const TCHAR *value = rows.get(i)->getValue(column);
+         if (value == nullptr)
+         {
+            indexes.add(0);
+            continue;
+         }
+         uint32_t index = CAST_FROM_POINTER(dictionary.get(value), uint32_t);
+         if (index == 0)
+         {
+            dictionaryElements.add(value);
+            index = dictionaryElements.size();
+            dictionary.set(value, CAST_TO_POINTER(index, void*));
+         }
+         indexes.add(index);
+      }
+
+      if (dictionaryElements.size() <= dictionaryLimit)
+      {
+         out.write(static_cast<BYTE>(COLUMN_ENCODING_DICTIONARY));
+         WriteVarUInt(out, dictionaryElements.size());
+         for(int i = 0; i < dictionaryElements.size(); i++)
+            WriteTableString(out, dictionaryElements.get(i));
+         for(int i = 0; i < indexes.size(); i++)
+            WriteVarUInt(out, indexes.get(i));
+      }
+      else
+      {
+         out.write(static_cast<BYTE>(COLUMN_ENCODING_PLAIN));
+         for(int i = 0; i < rows.size(); i++)
+            WriteTableString(out, rows.get(i)->getValue(column));
+      }
+   }
+
+   bool hasStatus = false;
+   for(int i = 0; (i < rows.size()) && !hasStatus; i++)
+      hasStatus = (rows.get(i)->getStatus(column) != DEFAULT_STATUS);
+   out.write(static_cast<BYTE>(hasStatus ? 1 : 0));
+   if (hasStatus)
+   {
+      for(int i = 0; i < rows.size(); i++)
+         WriteVarInt(out, rows.get(i)->getStatus(column));
+   }
+}
+
+/**
+ * Create packed binary representation of the table. Table is stored column by column with
+ * schema header, typed columns, and dictionary encoded repeating strings, then compressed
+ * and base64 encoded, so it can be stored in the same text fields as packed XML.
+ */
+char *Table::createPackedBinary() const
+{
+   ByteStream out(4096);
+   out.setAllocationStep(16384);
+
+   out.write(static_cast<BYTE>(m_extendedFormat ? 1 : 0));
+   WriteVarInt(out, m_source);
+   WriteTableString(out, m_title);
+
+   WriteVarUInt(out, m_columns->size());
+   for(int i = 0; i < m_columns->size(); i++)
+   {
+      const TableColumnDefinition *c = m_columns->get(i);
+      WriteTableString(out, c->getName());
+      WriteTableString(out, c->getDisplayName());
+      WriteVarInt(out, c->getDataType());
+      out.write(static_cast<BYTE>(c->isInstanceColumn() ? 1 : 0));
+   }
+
+   WriteVarUInt(out, m_data->size());
+
+   bool hasObjectId = false, hasBaseRow = false;
+   for(int i = 0; i < m_data->size(); i++)
+   {
+      const TableRow *r = m_data->get(i);
+      if (r->getObjectId() != DEFAULT_OBJECT_ID)
+         hasObjectId = true;
+      if (r->getBaseRow() != -1)
+         hasBaseRow = true;
+   }
+   out.write(static_cast<BYTE>(hasObjectId ? 1 : 0));
+   if (hasObjectId)
+   {
+      for(int i = 0; i < m_data->size(); i++)
+         WriteVarUInt(out, m_data->get(i)->getObjectId());
+   }
+   out.write(static_cast<BYTE>(hasBaseRow ? 1 : 0));
+   if (hasBaseRow)
+   {
+      for(int i = 0; i < m_data->size(); i++)
+         WriteVarInt(out, m_data->get(i)->getBaseRow());
+   }
+
+   for(int i = 0; i < m_columns->size(); i++)
+      EncodeColumn(out, *m_data, i, m_columns->get(i)->isInstanceColumn());
+
+   uLongf buflen = compressBound(static_cast<uLong>(out.size()));
+   BYTE *buffer = MemAllocArrayNoInit<BYTE>(buflen + PACKED_BINARY_HEADER_SIZE);
+   if (compress(&buffer[PACKED_BINARY_HEADER_SIZE], &buflen, out.buffer(), static_cast<uLong>(out.size())) != Z_OK)
+   {
+      MemFree(buffer);
+      return nullptr;
+   }
+   memcpy(buffer, s_packedBinarySignature, 4);
+   buffer[4] = PACKED_BINARY_VERSION;
+   uint32_t size = htonl(static_cast<uint32_t>(out.size()));
+   memcpy(&buffer[5], &size, 4);
+
+   char *encodedBuffer = nullptr;
+   base64_encode_alloc(reinterpret_cast<char*>(buffer), buflen + PACKED_BINARY_HEADER_SIZE, &encodedBuffer);
+   MemFree(buffer);
+   return encodedBuffer;
+}
+
+/**
+ * Decode table from uncompressed packed binary data
+ */
+bool Table::decodeBinary(const BYTE *data, size_t size)
+{
+   ByteStream in(data, size);
+   bool error = false;
+
+   m_extendedFormat = (in.readByte() != 0);
+   m_source = static_cast<int>(ReadVarInt(in, &error));
+   MemFree(m_title);
+   m_title = ReadTableString(in, &error);
+
+   uint64_t numColumns = ReadVarUInt(in, &error);
+   if (error || (numColumns > size))
+      return false;
+   for(uint64_t i = 0; i < numColumns; i++)
+   {
+      TCHAR *name = ReadTableString(in, &error);
+      TCHAR *displayName = ReadTableString(in, &error);
+      int32_t dataType = static_cast<int32_t>(ReadVarInt(in, &error));
+      bool instance = (in.readByte() != 0);
+      if (!error)
+         addColumn(CHECK_NULL_EX(name), dataType, displayName, instance);
+      MemFree(name);
+      MemFree(displayName);
+      if (error)
+         return false;
+   }
+
+   uint64_t numRows = ReadVarUInt(in, &error);
+   if (error || (numRows > size))
+      return false;
+   for(uint64_t i = 0; i < numRows; i++)
+      addRow();
+
+   if (in.readByte() != 0)
+   {
+      for(int i = 0; i < m_data->size(); i++)
+         m_data->get(i)->setObjectId(static_cast<uint32_t>(ReadVarUInt(in, &error)));
+   }
+   if (in.readByte() != 0)
+   {
+      for(int i = 0; i < m_data->size(); i++)
+         m_data->get(i)->setBaseRow(static_cast<int>(ReadVarInt(in, &error)));
+   }
+
+   for(int col = 0; (col < m_columns->size()) && !error; col++)
+   {
+      BYTE encoding = in.readByte();
+      if (encoding == COLUMN_ENCODING_INTEGER)
+      {
+         int64_t value = 0;
+         for(int i = 0; i < m_data->size(); i++)
+         {
+            value += ReadVarInt(in, &error);
+            setAt(i, col, value);
+         }
+      }
+      else if (encoding == COLUMN_ENCODING_DICTIONARY)
+      {
+         uint64_t dictionarySize = ReadVarUInt(in, &error);
+         if (error || (dictionarySize > size))
+            return false;
+         ObjectArray<TCHAR> dictionary(static_cast<int>(dictionarySize) + 1, 16, Ownership::False);
+         for(uint64_t i = 0; (i < dictionarySize) && !error; i++)
+            dictionary.add(ReadTableString(in, &error));
+         for(int i = 0; (i < m_data->size()) && !error; i++)
+         {
+            uint64_t index = ReadVarUInt(in, &error);
+            if (index > dictionarySize)
+               error = true;
+            else if (index > 0)
+               setAt(i, col, dictionary.get(static_cast<int>(index - 1)));
+         }
+         for(int i = 0; i < dictionary.size(); i++)
+            MemFree(dictionary.get(i));
+      }
+      else if (encoding == COLUMN_ENCODING_PLAIN)
+      {
+         for(int i = 0; (i < m_data->size()) && !error; i++)
+            setPreallocatedAt(i, col, ReadTableString(in, &error));
+      }
+      else
+      {
+         error = true;
+      }
+
+      if (in.readByte() != 0)
+      {
+         for(int i = 0; i < m_data->size(); i++)
+            setStatusAt(i, col, static_cast<int>(ReadVarInt(in, &error)));
+      }
+   }
+
+   return !error;
+}
+
+/**
+ * Create table from packed data. Both packed binary and packed XML formats are accepted.
+ */
+Table *Table::createFromPackedData(const char *packedData)
+{
+   char *decodedData = nullptr;
+   size_t decodedSize = 0;
+   base64_decode_alloc(packedData, strlen(packedData), &decodedData, &decodedSize);
+   if (decodedData == nullptr)
+      return nullptr;
+
+   if ((decodedSize < PACKED_BINARY_HEADER_SIZE) || memcmp(decodedData, s_packedBinarySignature, 4))
+   {
+      MemFree(decodedData);
+      return createFromPackedXML(packedData);
+   }
+
+   if (decodedData[4] != PACKED_BINARY_VERSION)
+   {
+      MemFree(decodedData);
+      return nullptr;
+   }
+
+   uint32_t size;
+   memcpy(&size, &decodedData[5], 4);
+   size = ntohl(size);
+   BYTE *data = MemAllocArrayNoInit<BYTE>(std::max(size, 1u));
+   uLongf uncompSize = static_cast<uLongf>(size);
+   if (uncompress(data, &uncompSize, reinterpret_cast<BYTE*>(&decodedData[PACKED_BINARY_HEADER_SIZE]),
+            static_cast<uLong>(decodedSize - PACKED_BINARY_HEADER_SIZE)) != Z_OK)
+   {
+      MemFree(data);
+      MemFree(decodedData);
+      return nullptr;
+   }
+   MemFree(decodedData);
+
+   Table *table = new Table();
+   if (!table->decodeBinary(data, uncompSize))
+   {
+      delete table;
+      table = nullptr;
+   }
+   MemFree(data);
+   return table;
+}
+
 /**
  * Create table from NXCP message
  */
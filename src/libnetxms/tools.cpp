@@ -902,6 +902,31 @@ int64_t LIBNETXMS_EXPORTABLE GetCurrentTimeMs()
    return t;
 }
 
+/**
+ * Get value of monotonic clock in nanoseconds. Returned value is only meaningful
+ * as a difference between two calls (e.g. for measuring execution time).
+ */
+uint64_t LIBNETXMS_EXPORTABLE GetMonotonicClockTimeNs()
+{
+#if defined(_WIN32)
+   static LARGE_INTEGER frequency = { 0 };
+   if (frequency.QuadPart == 0)
+      QueryPerformanceFrequency(&frequency);
+   LARGE_INTEGER counter;
+   QueryPerformanceCounter(&counter);
+   return static_cast<uint64_t>(counter.QuadPart / frequency.QuadPart) * _ULL(1000000000) +
+            static_cast<uint64_t>(counter.QuadPart % frequency.QuadPart) * _ULL(1000000000) / frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return static_cast<uint64_t>(ts.tv_sec) * _ULL(1000000000) + static_cast<uint64_t>(ts.tv_nsec);
+#else
+   struct timeval tv;
+   gettimeofday(&tv, nullptr);
+   return static_cast<uint64_t>(tv.tv_sec) * _ULL(1000000000) + static_cast<uint64_t>(tv.tv_usec) * 1000;
+#endif
+}
+
 /**
  * Format timestamp as dd.mm.yy HH:MM:SS.
  * Provided buffer should be at least 21 characters long.
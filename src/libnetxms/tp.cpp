@@ -59,10 +59,18 @@ struct WorkRequest
 {
    ThreadPoolWorkerFunction func;
    void *arg;
-   int64_t queueTime;
+   int64_t queueTime;   // Monotonic timestamp in microseconds
    int64_t runTime;
 };
 
+/**
+ * Get monotonic timestamp in microseconds for work request timing
+ */
+static inline int64_t GetRequestTimestamp()
+{
+   return static_cast<int64_t>(GetMonotonicClockTimeNs() / 1000);
+}
+
 /**
  * Request queue for serialized execution
  */
@@ -106,6 +114,8 @@ struct ThreadPool
    uint64_t threadStopCount;
    VolatileCounter64 taskExecutionCount;
    SynchronizedObjectMemoryPool<WorkRequest> workRequestMemoryPool;
+   LatencyHistogram waitTimeHistogram;       // Time between request submission and execution start (microseconds)
+   LatencyHistogram executionTimeHistogram;  // Request execution time (microseconds)
 
    ThreadPool(const TCHAR *name, int minThreads, int maxThreads, int stackSize) :
          queue(64, Ownership::False), serializationQueues(Ownership::True), schedulerQueue(16, 16, Ownership::False)
@@ -155,6 +165,9 @@ static void JoinWorkerThread(void *arg)
    delete static_cast<WorkerThreadInfo*>(arg);
 }
 
+struct RequestSerializationData;
+static void ProcessSerializedRequests(RequestSerializationData *data);
+
 /**
  * Worker thread function
  */
@@ -200,7 +213,7 @@ static void WorkerThread(WorkerThreadInfo *threadInfo)
          rq = p->workRequestMemoryPool.create();
          rq->func = JoinWorkerThread;
          rq->arg = threadInfo;
-         rq->queueTime = GetCurrentTimeMs();
+         rq->queueTime = GetRequestTimestamp();
          InterlockedIncrement(&p->activeRequests);
          p->queue.put(rq);
          break;
@@ -209,12 +222,18 @@ static void WorkerThread(WorkerThreadInfo *threadInfo)
       if (rq->func == nullptr) // stop indicator
          break;
       
-      int64_t waitTime = GetCurrentTimeMs() - rq->queueTime;
+      int64_t startTime = GetRequestTimestamp();
+      int64_t waitTime = startTime - rq->queueTime;
+      p->waitTimeHistogram.update(waitTime);
       MutexLock(p->mutex);
-      UpdateExpMovingAverage(p->averageWaitTime, EMA_EXP_180, waitTime);
+      UpdateExpMovingAverage(p->averageWaitTime, EMA_EXP_180, waitTime / 1000);
       MutexUnlock(p->mutex);
 
       rq->func(rq->arg);
+
+      // Serialized requests are timed individually by serialization queue processor
+      if (rq->func != reinterpret_cast<ThreadPoolWorkerFunction>(ProcessSerializedRequests))
+         p->executionTimeHistogram.update(GetRequestTimestamp() - startTime);
       p->workRequestMemoryPool.destroy(rq);
       InterlockedDecrement(&p->activeRequests);
    }
@@ -333,7 +352,7 @@ static void MaintenanceThread(ThreadPool *p)
             p->schedulerQueue.remove(0);
             InterlockedIncrement(&p->activeRequests);
             InterlockedIncrement64(&p->taskExecutionCount);
-            rq->queueTime = now;
+            rq->queueTime = GetRequestTimestamp();
             p->queue.put(rq);
          }
       }
@@ -410,7 +429,7 @@ void LIBNETXMS_EXPORTABLE ThreadPoolDestroy(ThreadPool *p)
 
    WorkRequest rq;
    rq.func = nullptr;
-   rq.queueTime = GetCurrentTimeMs();
+   rq.queueTime = GetRequestTimestamp();
    MutexLock(p->mutex);
    int count = p->threads.size();
    for(int i = 0; i < count; i++)
@@ -436,7 +455,7 @@ void LIBNETXMS_EXPORTABLE ThreadPoolExecute(ThreadPool *p, ThreadPoolWorkerFunct
    WorkRequest *rq = p->workRequestMemoryPool.create();
    rq->func = f;
    rq->arg = arg;
-   rq->queueTime = GetCurrentTimeMs();
+   rq->queueTime = GetRequestTimestamp();
    p->queue.put(rq);
 }
 
@@ -474,9 +493,11 @@ static void ProcessSerializedRequests(RequestSerializationData *data)
          }
          MutexUnlock(data->pool->serializationLock);
       }
-      data->queue->updateMaxWaitTime(static_cast<uint32_t>(GetCurrentTimeMs() - rq->queueTime));
+      int64_t startTime = GetRequestTimestamp();
+      data->queue->updateMaxWaitTime(static_cast<uint32_t>((startTime - rq->queueTime) / 1000));
 
       rq->func(rq->arg);
+      data->pool->executionTimeHistogram.update(GetRequestTimestamp() - startTime);
       data->pool->workRequestMemoryPool.destroy(rq);
    }
    MemFree(data);
@@ -493,7 +514,7 @@ void LIBNETXMS_EXPORTABLE ThreadPoolExecuteSerialized(ThreadPool *p, const TCHAR
    WorkRequest *rq = p->workRequestMemoryPool.create();
    rq->func = f;
    rq->arg = arg;
-   rq->queueTime = GetCurrentTimeMs();
+   rq->queueTime = GetRequestTimestamp();
 
    MutexLock(p->serializationLock);
    SerializationQueue *q = p->serializationQueues.get(key);
@@ -540,7 +561,7 @@ void LIBNETXMS_EXPORTABLE ThreadPoolScheduleAbsoluteMs(ThreadPool *p, int64_t ru
    rq->func = f;
    rq->arg = arg;
    rq->runTime = runTime;
-   rq->queueTime = GetCurrentTimeMs();
+   rq->queueTime = GetRequestTimestamp();
 
    MutexLock(p->schedulerLock);
    p->schedulerQueue.add(rq);
@@ -616,6 +637,30 @@ bool LIBNETXMS_EXPORTABLE ThreadPoolGetInfo(const TCHAR *name, ThreadPoolInfo *i
    return p != NULL;
 }
 
+/**
+ * Get snapshot of pool latency histograms (wait time and execution time, in microseconds). Any of output arguments can be NULL.
+ */
+void LIBNETXMS_EXPORTABLE ThreadPoolGetLatencyHistograms(ThreadPool *p, LatencyHistogram *waitTime, LatencyHistogram *executionTime)
+{
+   if (waitTime != nullptr)
+      *waitTime = p->waitTimeHistogram;
+   if (executionTime != nullptr)
+      *executionTime = p->executionTimeHistogram;
+}
+
+/**
+ * Get snapshot of pool latency histograms by pool name
+ */
+bool LIBNETXMS_EXPORTABLE ThreadPoolGetLatencyHistograms(const TCHAR *name, LatencyHistogram *waitTime, LatencyHistogram *executionTime)
+{
+   s_registryLock.lock();
+   ThreadPool *p = s_registry.get(name);
+   if (p != nullptr)
+      ThreadPoolGetLatencyHistograms(p, waitTime, executionTime);
+   s_registryLock.unlock();
+   return p != nullptr;
+}
+
 /**
  * Get all thread pool names
  */
@@ -386,4 +386,14 @@ struct NXSL_ClassRegistry
 extern const TCHAR *g_szTypeNames[];
 
 
+//
+// Functions
+//
+
+const char *GetOpCodeMnemonic(int16_t opCode);
+
+MemoryPool *AcquireVariablePool();
+void ReleaseVariablePool(MemoryPool *pool);
+
+
 #endif
@@ -0,0 +1,187 @@
+/*
+** NetXMS - Network Management System
+** NetXMS Scripting Language Interpreter
+** Copyright (C) 2003-2021 Victor Kirhenshtein
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation; either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: pools.cpp
+**
+**/
+
+#include "libnxsl.h"
+
+/**
+ * Region capacity for value and identifier pools of VM
+ */
+#define VALUE_POOL_CAPACITY         256
+#define IDENTIFIER_POOL_CAPACITY    64
+
+/**
+ * Region size for variable system pools
+ */
+#define VARIABLE_POOL_REGION_SIZE   4096
+
+/**
+ * Per-thread pool caches are only possible if thread local objects can have destructors
+ */
+#if defined(_WIN32) || HAVE_THREAD_LOCAL_SPECIFIER
+#define WITH_POOL_CACHE 1
+#endif
+
+#if WITH_POOL_CACHE
+
+/**
+ * Cache for released memory pools. Pools are cleared before being placed into cache,
+ * so each cached pool holds only one memory region.
+ */
+template<typename P, int N> class PoolCache
+{
+private:
+   P *m_pools[N];
+   int m_count;
+
+public:
+   PoolCache()
+   {
+      m_count = 0;
+   }
+
+   ~PoolCache()
+   {
+      for(int i = 0; i < m_count; i++)
+         delete m_pools[i];
+   }
+
+   P *acquire()
+   {
+      return (m_count > 0) ? m_pools[--m_count] : nullptr;
+   }
+
+   bool release(P *pool)
+   {
+      if (m_count == N)
+         return false;
+      pool->clear();
+      m_pools[m_count++] = pool;
+      return true;
+   }
+};
+
+/**
+ * Pool caches for single thread
+ */
+struct ThreadPoolCache
+{
+   PoolCache<ObjectMemoryPool<NXSL_Value>, 2> values;
+   PoolCache<ObjectMemoryPool<NXSL_Identifier>, 2> identifiers;
+   PoolCache<MemoryPool, 8> variables;
+
+   ~ThreadPoolCache()
+   {
+      s_destroyed = true;
+   }
+
+   static thread_local bool s_destroyed;
+};
+
+/**
+ * Set to true when thread's cache is destroyed on thread exit (VMs can still be destroyed after that)
+ */
+thread_local bool ThreadPoolCache::s_destroyed = false;
+
+/**
+ * Pool cache for current thread
+ */
+static thread_local ThreadPoolCache s_poolCache;
+
+#endif /* WITH_POOL_CACHE */
+
+/**
+ * Create value manager with default pool sizes
+ */
+NXSL_ValueManager::NXSL_ValueManager()
+{
+#if WITH_POOL_CACHE
+   if (!ThreadPoolCache::s_destroyed)
+   {
+      m_values = s_poolCache.values.acquire();
+      m_identifiers = s_poolCache.identifiers.acquire();
+   }
+   else
+   {
+      m_values = nullptr;
+      m_identifiers = nullptr;
+   }
+   if (m_values == nullptr)
+      m_values = new ObjectMemoryPool<NXSL_Value>(VALUE_POOL_CAPACITY);
+   if (m_identifiers == nullptr)
+      m_identifiers = new ObjectMemoryPool<NXSL_Identifier>(IDENTIFIER_POOL_CAPACITY);
+#else
+   m_values = new ObjectMemoryPool<NXSL_Value>(VALUE_POOL_CAPACITY);
+   m_identifiers = new ObjectMemoryPool<NXSL_Identifier>(IDENTIFIER_POOL_CAPACITY);
+#endif
+}
+
+/**
+ * Create value manager with given pool region capacities
+ */
+NXSL_ValueManager::NXSL_ValueManager(size_t valuesRegCapacity, size_t identifiersRegCapacity)
+{
+   m_values = new ObjectMemoryPool<NXSL_Value>(valuesRegCapacity);
+   m_identifiers = new ObjectMemoryPool<NXSL_Identifier>(identifiersRegCapacity);
+}
+
+/**
+ * Destroy value manager. Destructors for values still remaining in pools will not be called.
+ */
+NXSL_ValueManager::~NXSL_ValueManager()
+{
+#if WITH_POOL_CACHE
+   if (ThreadPoolCache::s_destroyed || (m_values->getRegionCapacity() != VALUE_POOL_CAPACITY) || !s_poolCache.values.release(m_values))
+      delete m_values;
+   if (ThreadPoolCache::s_destroyed || (m_identifiers->getRegionCapacity() != IDENTIFIER_POOL_CAPACITY) || !s_poolCache.identifiers.release(m_identifiers))
+      delete m_identifiers;
+#else
+   delete m_values;
+   delete m_identifiers;
+#endif
+}
+
+/**
+ * Get memory pool for variable system
+ */
+MemoryPool *AcquireVariablePool()
+{
+#if WITH_POOL_CACHE
+   MemoryPool *pool = !ThreadPoolCache::s_destroyed ? s_poolCache.variables.acquire() : nullptr;
+   return (pool != nullptr) ? pool : new MemoryPool(VARIABLE_POOL_REGION_SIZE);
+#else
+   return new MemoryPool(VARIABLE_POOL_REGION_SIZE);
+#endif
+}
+
+/**
+ * Release memory pool used by variable system
+ */
+void ReleaseVariablePool(MemoryPool *pool)
+{
+#if WITH_POOL_CACHE
+   if (ThreadPoolCache::s_destroyed || !s_poolCache.variables.release(pool))
+      delete pool;
+#else
+   delete pool;
+#endif
+}
@@ -0,0 +1,207 @@
+/*
+** NetXMS - Network Management System
+** NetXMS Scripting Language Interpreter
+** Copyright (C) 2003-2021 Victor Kirhenshtein
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation; either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: profiler.cpp
+**
+**/
+
+#include "libnxsl.h"
+
+/**
+ * Profiler constructor
+ */
+NXSL_Profiler::NXSL_Profiler(uint32_t sampleInterval)
+{
+   m_sampleInterval = std::max(sampleInterval, static_cast<uint32_t>(1));
+   m_countdown = m_sampleInterval;
+   m_size = 0;
+   m_executions = nullptr;
+   m_samples = nullptr;
+   m_sampledTime = nullptr;
+   m_runTime = 0;
+   m_runCount = 0;
+}
+
+/**
+ * Profiler destructor
+ */
+NXSL_Profiler::~NXSL_Profiler()
+{
+   MemFree(m_executions);
+   MemFree(m_samples);
+   MemFree(m_sampledTime);
+}
+
+/**
+ * Prepare profiler for running code of given size. Already collected data is preserved.
+ */
+void NXSL_Profiler::prepare(uint32_t codeSize)
+{
+   if (codeSize <= m_size)
+      return;
+
+   m_executions = MemReallocArray(m_executions, codeSize);
+   m_samples = MemReallocArray(m_samples, codeSize);
+   m_sampledTime = MemReallocArray(m_sampledTime, codeSize);
+   memset(&m_executions[m_size], 0, (codeSize - m_size) * sizeof(uint64_t));
+   memset(&m_samples[m_size], 0, (codeSize - m_size) * sizeof(uint64_t));
+   memset(&m_sampledTime[m_size], 0, (codeSize - m_size) * sizeof(uint64_t));
+   m_size = codeSize;
+}
+
+/**
+ * Reset collected data
+ */
+void NXSL_Profiler::reset()
+{
+   if (m_size > 0)
+   {
+      memset(m_executions, 0, m_size * sizeof(uint64_t));
+      memset(m_samples, 0, m_size * sizeof(uint64_t));
+      memset(m_sampledTime, 0, m_size * sizeof(uint64_t));
+   }
+   m_countdown = m_sampleInterval;
+   m_runTime = 0;
+   m_runCount = 0;
+}
+
+/**
+ * Get total number of executed instructions
+ */
+uint64_t NXSL_Profiler::getTotalExecutions() const
+{
+   uint64_t total = 0;
+   for(uint32_t i = 0; i < m_size; i++)
+      total += m_executions[i];
+   return total;
+}
+
+/**
+ * Enable profiling for this VM. Previously collected profiling data will be discarded.
+ */
+void NXSL_VM::enableProfiling(uint32_t sampleInterval)
+{
+   delete m_profiler;
+   m_profiler = new NXSL_Profiler(sampleInterval);
+}
+
+/**
+ * Disable profiling for this VM and discard collected data
+ */
+void NXSL_VM::disableProfiling()
+{
+   delete_and_null(m_profiler);
+}
+
+/**
+ * Compare profile entries by module and source line
+ */
+static int CompareProfileEntriesByLocation(const void *e1, const void *e2)
+{
+   const NXSL_ProfileEntry *p1 = static_cast<const NXSL_ProfileEntry*>(e1);
+   const NXSL_ProfileEntry *p2 = static_cast<const NXSL_ProfileEntry*>(e2);
+   if (p1->module != p2->module)
+   {
+      if (p1->module == nullptr)
+         return -1;
+      if (p2->module == nullptr)
+         return 1;
+      int rc = _tcscmp(p1->module, p2->module);
+      if (rc != 0)
+         return rc;
+   }
+   return COMPARE_NUMBERS(p1->line, p2->line);
+}
+
+/**
+ * Compare profile entries by estimated execution time (descending)
+ */
+static int CompareProfileEntriesByTime(const void *e1, const void *e2)
+{
+   uint64_t t1 = static_cast<const NXSL_ProfileEntry*>(e1)->getEstimatedTime();
+   uint64_t t2 = static_cast<const NXSL_ProfileEntry*>(e2)->getEstimatedTime();
+   int rc = COMPARE_NUMBERS(t2, t1);
+   if (rc != 0)
+      return rc;
+   return COMPARE_NUMBERS(static_cast<const NXSL_ProfileEntry*>(e2)->executions, static_cast<const NXSL_ProfileEntry*>(e1)->executions);
+}
+
+/**
+ * Get collected profiling data, either for each executed instruction or aggregated by source line.
+ * Entries are sorted by estimated execution time in descending order. Module names in returned
+ * entries are valid only while VM exists. Returns nullptr if profiling is not enabled.
+ */
+StructArray<NXSL_ProfileEntry> *NXSL_VM::getProfile(bool byInstruction) const
+{
+   if (m_profiler == nullptr)
+      return nullptr;
+
+   auto profile = new StructArray<NXSL_ProfileEntry>(0, 256);
+   uint32_t size = std::min(m_profiler->m_size, static_cast<uint32_t>(m_instructionSet.size()));
+   int moduleIndex = -1;
+   for(uint32_t addr = 0; addr < size; addr++)
+   {
+      if (m_profiler->m_executions[addr] == 0)
+         continue;
+
+      // Modules are appended to the end of main script code in load order
+      while((moduleIndex < m_modules.size() - 1) && (addr >= m_modules.get(moduleIndex + 1)->m_codeStart))
+         moduleIndex++;
+
+      NXSL_Instruction *instr = m_instructionSet.get(addr);
+      NXSL_ProfileEntry *e = profile->addPlaceholder();
+      e->module = (moduleIndex >= 0) ? m_modules.get(moduleIndex)->m_name : nullptr;
+      e->line = instr->m_sourceLine;
+      e->addr = addr;
+      e->mnemonic = GetOpCodeMnemonic(instr->m_opCode);
+      e->executions = m_profiler->m_executions[addr];
+      e->samples = m_profiler->m_samples[addr];
+      e->sampledTime = m_profiler->m_sampledTime[addr];
+   }
+
+   if (!byInstruction)
+   {
+      profile->sort(CompareProfileEntriesByLocation);
+      int count = 0;
+      for(int i = 0; i < profile->size(); i++)
+      {
+         NXSL_ProfileEntry *e = profile->get(i);
+         NXSL_ProfileEntry *last = (count > 0) ? profile->get(count - 1) : nullptr;
+         if ((last != nullptr) && (CompareProfileEntriesByLocation(last, e) == 0))
+         {
+            last->executions += e->executions;
+            last->samples += e->samples;
+            last->sampledTime += e->sampledTime;
+         }
+         else
+         {
+            e->addr = INVALID_ADDRESS;
+            e->mnemonic = nullptr;
+            if (i != count)
+               profile->set(count, e);
+            count++;
+         }
+      }
+      while(profile->size() > count)
+         profile->remove(profile->size() - 1);
+   }
+
+   profile->sort(CompareProfileEntriesByTime);
+   return profile;
+}
@@ -61,6 +61,14 @@ static const char *s_nxslCommandMnemonic[] =
    "PUSH", "PUSH"
 };
 
+/**
+ * Get mnemonic for given opcode
+ */
+const char *GetOpCodeMnemonic(int16_t opCode)
+{
+   return ((opCode >= 0) && (opCode < static_cast<int16_t>(sizeof(s_nxslCommandMnemonic) / sizeof(const char*)))) ? s_nxslCommandMnemonic[opCode] : "???";
+}
+
 /**
  * Constructor
  */
@@ -647,7 +655,7 @@ EnumerationCallbackResult CopyConstantsCallback(const void *key, void *value, vo
  * Create compiled script object from code builder
  */
 NXSL_Program::NXSL_Program(NXSL_ProgramBuilder *builder) :
-         NXSL_ValueManager(builder->m_values.getElementCount(), builder->m_identifiers.getElementCount()),
+         NXSL_ValueManager(builder->m_values->getElementCount(), builder->m_identifiers->getElementCount()),
          m_instructionSet(builder->m_instructionSet.size(), 256),
          m_constants(this, Ownership::True),
          m_functions(builder->m_functions.getBuffer(), builder->m_functions.size()),
@@ -718,8 +726,8 @@ void NXSL_Program::serialize(ByteStream& s) const
    memset(&header, 0, sizeof(header));
    memcpy(header.magic, "NXSL", 4);
    header.version = NXSL_BIN_FORMAT_VERSION;
-   header.valueRegionSizeHint = htonl(static_cast<uint32_t>(m_values.getElementCount()));
-   header.identifierRegionSizeHint = htonl(static_cast<uint32_t>(m_identifiers.getElementCount()));
+   header.valueRegionSizeHint = htonl(static_cast<uint32_t>(m_values->getElementCount()));
+   header.identifierRegionSizeHint = htonl(static_cast<uint32_t>(m_identifiers->getElementCount()));
    s.write(&header, sizeof(header));
 
    // Serialize instructions
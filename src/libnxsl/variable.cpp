@@ -24,7 +24,7 @@
 #include "libnxsl.h"
 
 #undef uthash_malloc
-#define uthash_malloc(sz) m_pool.allocate(sz)
+#define uthash_malloc(sz) m_pool->allocate(sz)
 #undef uthash_free
 #define uthash_free(ptr,sz) do { } while(0)
 
@@ -85,8 +85,9 @@ struct NXSL_VariablePtr
 /**
  * Create new variable system
  */
-NXSL_VariableSystem::NXSL_VariableSystem(NXSL_VM *vm, NXSL_VariableSystemType type) : NXSL_RuntimeObject(vm), m_pool(4096)
+NXSL_VariableSystem::NXSL_VariableSystem(NXSL_VM *vm, NXSL_VariableSystemType type) : NXSL_RuntimeObject(vm)
 {
+   m_pool = AcquireVariablePool();
    m_variables = nullptr;
 	m_type = type;
 	m_restorePointCount = 0;
@@ -95,8 +96,9 @@ NXSL_VariableSystem::NXSL_VariableSystem(NXSL_VM *vm, NXSL_VariableSystemType ty
 /**
  * Clone existing variable system
  */
-NXSL_VariableSystem::NXSL_VariableSystem(NXSL_VM *vm, const NXSL_VariableSystem *src) : NXSL_RuntimeObject(vm), m_pool(4096)
+NXSL_VariableSystem::NXSL_VariableSystem(NXSL_VM *vm, const NXSL_VariableSystem *src) : NXSL_RuntimeObject(vm)
 {
+   m_pool = AcquireVariablePool();
    m_variables = nullptr;
    m_type = src->m_type;
    m_restorePointCount = 0;
@@ -116,6 +118,7 @@ NXSL_VariableSystem::~NXSL_VariableSystem()
    clear();
    for(int i = 0; i < m_restorePointCount; i++)
       m_vm->destroyIdentifier(m_restorePoints[i].identifier);
+   ReleaseVariablePool(m_pool);
 }
 
 /**
@@ -187,7 +190,7 @@ NXSL_Variable *NXSL_VariableSystem::find(const NXSL_Identifier& name)
  */
 NXSL_Variable *NXSL_VariableSystem::create(const NXSL_Identifier& name, NXSL_Value *value)
 {
-   NXSL_VariablePtr *var = static_cast<NXSL_VariablePtr*>(m_pool.allocate(sizeof(NXSL_VariablePtr)));
+   NXSL_VariablePtr *var = static_cast<NXSL_VariablePtr*>(m_pool->allocate(sizeof(NXSL_VariablePtr)));
    NXSL_Variable *v = new (&var->v) NXSL_Variable(m_vm, name, (value != nullptr) ? value : m_vm->createValue(), isConstant());
    HASH_ADD_KEYPTR(hh, m_variables, v->m_name.value, v->m_name.length, var);
    return v;
@@ -195,6 +195,7 @@ NXSL_VM::NXSL_VM(NXSL_Environment *env, NXSL_Storage *storage) : NXSL_ValueManag
    m_contextVariables = nullptr;
    m_context = nullptr;
    m_securityContext = nullptr;
+   m_profiler = nullptr;
    m_subLevel = 0;    // Level of current subroutine
    m_env = (env != nullptr) ? env : new NXSL_Environment;
    m_pRetValue = nullptr;
@@ -231,6 +232,7 @@ NXSL_VM::~NXSL_VM()
    delete m_contextVariables;
    destroyValue(m_context);
    delete m_securityContext;
+   delete m_profiler;
 
    delete m_localStorage;
 
@@ -268,6 +270,10 @@ bool NXSL_VM::load(const NXSL_Program *program)
    for(int i = 0; i < program->m_instructionSet.size(); i++)
       m_instructionSet.addPlaceholder()->copyFrom(program->m_instructionSet.get(i), this);
 
+   // Collected profiling data is not valid for new code
+   if (m_profiler != nullptr)
+      m_profiler->reset();
+
    // Copy function information
    m_functions.clear();
    for(int i = 0; i < program->m_functions.size(); i++)
@@ -378,13 +384,28 @@ bool NXSL_VM::run(const ObjectRefArray<NXSL_Value>& args, NXSL_VariableSystem **
 		}
 	}
 
+   uint64_t startTime = 0;
+   if (m_profiler != nullptr)
+   {
+      m_profiler->prepare(m_instructionSet.size());
+      startTime = GetMonotonicClockTimeNs();
+   }
+
    if (entryAddr != INVALID_ADDRESS)
    {
       m_cp = entryAddr;
       m_stopFlag = false;
 resume:
-      while((m_cp < static_cast<uint32_t>(m_instructionSet.size())) && !m_stopFlag)
-         execute();
+      if (m_profiler != nullptr)
+      {
+         while((m_cp < static_cast<uint32_t>(m_instructionSet.size())) && !m_stopFlag)
+            executeProfiled();
+      }
+      else
+      {
+         while((m_cp < static_cast<uint32_t>(m_instructionSet.size())) && !m_stopFlag)
+            execute();
+      }
       if (!m_stopFlag)
       {
          if (m_cp != INVALID_ADDRESS)
@@ -417,6 +438,12 @@ bool NXSL_VM::run(const ObjectRefArray<NXSL_Value>& args, NXSL_VariableSystem **
       error(NXSL_ERR_NO_MAIN);
    }
 
+   if (m_profiler != nullptr)
+   {
+      m_profiler->m_runTime += GetMonotonicClockTimeNs() - startTime;
+      m_profiler->m_runCount++;
+   }
+
    // Restore instructions replaced to direct variable pointers
    m_localVariables->restoreVariableReferences(&m_instructionSet);
    m_globalVariables->restoreVariableReferences(&m_instructionSet);
@@ -1915,6 +1942,25 @@ void NXSL_VM::execute()
       m_cp = dwNext;
 }
 
+/**
+ * Execute single instruction with profiling
+ */
+void NXSL_VM::executeProfiled()
+{
+   uint32_t addr = m_cp;
+   if (m_profiler->startSample())
+   {
+      uint64_t startTime = GetMonotonicClockTimeNs();
+      execute();
+      m_profiler->addSample(addr, GetMonotonicClockTimeNs() - startTime);
+   }
+   else
+   {
+      execute();
+      m_profiler->addExecution(addr);
+   }
+}
+
 /**
  * Set array element
  */
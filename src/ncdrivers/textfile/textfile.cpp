@@ -39,6 +39,8 @@ class TextFileDriver : public NCDriver
 public:
    TextFileDriver(const TCHAR *fileName);
    virtual bool send(const TCHAR *recipient, const TCHAR *subject, const TCHAR *body) override;
+   virtual bool isBatchSendSupported() const override { return true; }
+   virtual bool sendBatch(const TCHAR *recipient, const NCMessage *messages, int count) override;
 };
 
 /**
@@ -69,6 +71,30 @@ bool TextFileDriver::send(const TCHAR *recipient, const TCHAR *subject, const TC
    return success;
 }
 
+/**
+ * Driver batch send method (file is opened only once for all messages)
+ */
+bool TextFileDriver::sendBatch(const TCHAR *recipient, const NCMessage *messages, int count)
+{
+   FILE *f = _tfopen(m_fileName, _T("a"));
+   if (f == nullptr)
+   {
+      nxlog_debug_tag(DEBUG_TAG, 4, _T("Cannot open file %s (%s)"), m_fileName, _tcserror(errno));
+      return false;
+   }
+
+   bool success = true;
+   for(int i = 0; i < count; i++)
+   {
+      if (_fputts(messages[i].body, f) < 0)
+         success = false;
+      _fputts(_T("\n"), f);
+   }
+
+   fclose(f);
+   return success;
+}
+
 /**
  * Driver entry point
  */
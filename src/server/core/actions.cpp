@@ -38,6 +38,9 @@ Action::Action(const TCHAR *name)
    rcptAddr[0] = 0;
    data = NULL;
    channelName[0] = 0;
+   dataTemplate = nullptr;
+   rcptAddrTemplate = nullptr;
+   emailSubjectTemplate = nullptr;
 }
 
 /**
@@ -54,6 +57,9 @@ Action::Action(DB_RESULT hResult, int row)
    DBGetField(hResult, row, 6, emailSubject, MAX_EMAIL_SUBJECT_LEN);
    data = DBGetField(hResult, row, 7, NULL, 0);
    DBGetField(hResult, row, 8, channelName, MAX_OBJECT_NAME);
+   dataTemplate = nullptr;
+   rcptAddrTemplate = nullptr;
+   emailSubjectTemplate = nullptr;
 }
 
 /**
@@ -70,7 +76,9 @@ Action::Action(const Action *act)
    _tcsncpy(emailSubject, act->emailSubject, MAX_EMAIL_SUBJECT_LEN);
    data = MemCopyString(act->data);
    _tcsncpy(channelName, act->channelName, MAX_OBJECT_NAME);
-
+   dataTemplate = nullptr;
+   rcptAddrTemplate = nullptr;
+   emailSubjectTemplate = nullptr;
 }
 
 /**
@@ -79,6 +87,22 @@ Action::Action(const Action *act)
 Action::~Action()
 {
    free(data);
+   delete dataTemplate;
+   delete rcptAddrTemplate;
+   delete emailSubjectTemplate;
+}
+
+/**
+ * Compile templates for action data, recipient, and subject. Should be called before action is made available for execution.
+ */
+void Action::compileTemplates()
+{
+   delete dataTemplate;
+   dataTemplate = new TextTemplate(CHECK_NULL_EX(data));
+   delete rcptAddrTemplate;
+   rcptAddrTemplate = new TextTemplate(rcptAddr);
+   delete emailSubjectTemplate;
+   emailSubjectTemplate = new TextTemplate(emailSubject);
 }
 
 /**
@@ -159,6 +183,7 @@ bool LoadActions()
       for(int i = 0; i < count; i++)
       {
          Action *action = new Action(hResult, i);
+         action->compileTemplates();
          s_actions.set(action->id, action);
       }
 
@@ -431,13 +456,13 @@ bool ExecuteAction(uint32_t actionId, const Event *event, const Alarm *alarm)
          nxlog_debug_tag(DEBUG_TAG, 3, _T("Executing action %d (%s) of type %s"),
             actionId, action->name, actionType[action->type]);
 
-         StringBuffer expandedData = event->expandText(CHECK_NULL_EX(action->data), alarm);
+         StringBuffer expandedData = event->expandText(*action->dataTemplate, alarm);
          expandedData.trim();
 
-         StringBuffer expandedRcpt = event->expandText(action->rcptAddr, alarm);
+         StringBuffer expandedRcpt = event->expandText(*action->rcptAddrTemplate, alarm);
          expandedRcpt.trim();
 
-         String expandedSubject = event->expandText(action->emailSubject, alarm);
+         String expandedSubject = event->expandText(*action->emailSubjectTemplate, alarm);
 
          switch(action->type)
          {
@@ -558,6 +583,7 @@ uint32_t CreateAction(const TCHAR *name, uint32_t *id)
    Action *action = new Action(name);
    *id = action->id;
    action->saveToDatabase();
+   action->compileTemplates();
 
    s_actions.set(action->id, action);
    s_updateCode = NX_NOTIFY_ACTION_CREATED;
@@ -619,6 +645,7 @@ uint32_t ModifyActionFromMessage(const NXCPMessage *msg)
       _tcscpy(action->name, name);
 
       action->saveToDatabase();
+      action->compileTemplates();
 
       s_updateCode = NX_NOTIFY_ACTION_MODIFIED;
       EnumerateClientSessions(SendActionDBUpdate, action);
@@ -851,6 +878,7 @@ bool ImportAction(ConfigEntry *config, bool overwrite)
       _tcslcpy(action->channelName, config->getSubEntryValue(_T("channelName")), MAX_OBJECT_NAME);
    action->data = MemCopyString(config->getSubEntryValue(_T("data")));
    action->saveToDatabase();
+   action->compileTemplates();
    EnumerateClientSessions(SendActionDBUpdate, action.get());
    s_actions.set(action->id, action);
 
@@ -697,7 +697,7 @@ UINT32 AgentConnectionEx::processCollectedData(NXCPMessage *msg)
    }
 
    // Check that server is not overloaded with DCI data
-   INT64 queueSize = GetIDataWriterQueueSize();
+   INT64 queueSize = GetIDataWriterQueueSize() + GetTDataWriterQueueSize();
    if (queueSize > 250000)
    {
       debugPrintf(5, _T("AgentConnectionEx::processCollectedData: database writer queue is too large (%d) - cannot accept new data"), queueSize);
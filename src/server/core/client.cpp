@@ -45,6 +45,13 @@ static size_t s_freePos = 0;
 static ObjectArray<BackgroundSocketPollerHandle> s_pollers(8, 8, Ownership::True);
 static uint32_t s_maxClientSessionsPerPoller = std::min(256, SOCKET_POLLER_MAX_SOCKETS - 1);
 
+/**
+ * Sessions subscribed to last values updates (indexed by object ID)
+ */
+static HashMap<uint32_t, IntegerArray<session_id_t>> s_lastValuesSubscribers(Ownership::True);
+static RWLOCK s_lastValuesSubscribersLock = RWLockCreate();
+static VolatileCounter s_lastValuesSubscriptionCount = 0;
+
 /**
  * Register new session in list
  */
@@ -448,6 +455,86 @@ void NotifyClientsOnDCIUpdate(const NXCPMessage& msg, const NetObj& object)
    RWLockUnlock(s_sessionListLock);
 }
 
+/**
+ * Register last values subscription for given object
+ */
+void RegisterLastValuesSubscription(uint32_t objectId, session_id_t sessionId)
+{
+   RWLockWriteLock(s_lastValuesSubscribersLock);
+   IntegerArray<session_id_t> *sessions = s_lastValuesSubscribers.get(objectId);
+   if (sessions == nullptr)
+   {
+      sessions = new IntegerArray<session_id_t>(0, 8);
+      s_lastValuesSubscribers.set(objectId, sessions);
+   }
+   if (!sessions->contains(sessionId))
+   {
+      sessions->add(sessionId);
+      InterlockedIncrement(&s_lastValuesSubscriptionCount);
+   }
+   RWLockUnlock(s_lastValuesSubscribersLock);
+}
+
+/**
+ * Unregister last values subscription for given object
+ */
+void UnregisterLastValuesSubscription(uint32_t objectId, session_id_t sessionId)
+{
+   RWLockWriteLock(s_lastValuesSubscribersLock);
+   IntegerArray<session_id_t> *sessions = s_lastValuesSubscribers.get(objectId);
+   if (sessions != nullptr)
+   {
+      int index = sessions->indexOf(sessionId);
+      if (index != -1)
+      {
+         sessions->remove(index);
+         InterlockedDecrement(&s_lastValuesSubscriptionCount);
+         if (sessions->isEmpty())
+            s_lastValuesSubscribers.remove(objectId);
+      }
+   }
+   RWLockUnlock(s_lastValuesSubscribersLock);
+}
+
+/**
+ * Check if any session is subscribed to last values of given object
+ */
+bool HasLastValuesSubscription(uint32_t objectId)
+{
+   if (s_lastValuesSubscriptionCount == 0)
+      return false;
+
+   RWLockReadLock(s_lastValuesSubscribersLock);
+   bool subscribed = s_lastValuesSubscribers.contains(objectId);
+   RWLockUnlock(s_lastValuesSubscribersLock);
+   return subscribed;
+}
+
+/**
+ * Notify subscribed clients on change of DCI last value or status. Sessions only mark DCI as changed here,
+ * actual update messages are sent by each session at configured interval.
+ */
+void NotifyClientsOnLastValueChange(uint32_t objectId, uint32_t dciId)
+{
+   if (s_lastValuesSubscriptionCount == 0)
+      return;
+
+   RWLockReadLock(s_lastValuesSubscribersLock);
+   IntegerArray<session_id_t> *sessions = s_lastValuesSubscribers.get(objectId);
+   if (sessions != nullptr)
+   {
+      RWLockReadLock(s_sessionListLock);
+      for(int i = 0; i < sessions->size(); i++)
+      {
+         ClientSession *session = s_sessions.get(sessions->get(i));
+         if ((session != nullptr) && !session->isTerminated())
+            session->onLastValueChange(objectId, dciId);
+      }
+      RWLockUnlock(s_sessionListLock);
+   }
+   RWLockUnlock(s_lastValuesSubscribersLock);
+}
+
 /**
  * Notify clients on threshold change
  */
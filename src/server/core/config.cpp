@@ -600,6 +600,10 @@ static void OnConfigVariableChange(bool isCLOB, const TCHAR *name, const TCHAR *
       else
          g_flags &= ~AF_ENABLE_NXSL_CONTAINER_FUNCTIONS;
    }
+   else if (!_tcsncmp(name, _T("Events.RateLimit."), 17))
+   {
+      OnEventRateLimitConfigurationChange(name, value);
+   }
    else if (!_tcscmp(name, _T("Objects.Interfaces.Enable8021xStatusPoll")))
    {
       if (_tcstol(value, nullptr, 0))
@@ -626,6 +630,14 @@ static void OnConfigVariableChange(bool isCLOB, const TCHAR *name, const TCHAR *
    {
       g_pollsBetweenPrimaryIpUpdate = ConvertToUint32(value, 1);
    }
+   else if (!_tcscmp(name, _T("SNMP.RequestScheduler.MaxInFlight")))
+   {
+      g_snmpMaxRequestsInFlight = ConvertToUint32(value, 0);
+   }
+   else if (!_tcscmp(name, _T("SNMP.RequestScheduler.RateLimit")))
+   {
+      g_snmpRequestRateLimit = ConvertToUint32(value, 0);
+   }
    else if (!_tcscmp(name, _T("SNMP.Traps.AllowVarbindsConversion")))
    {
       if (_tcstol(value, nullptr, 0))
@@ -46,6 +46,7 @@ void RangeScanCallback(const InetAddress& addr, int32_t zoneUIN, const Node *pro
 void CheckRange(const InetAddressListElement& range, void(*callback)(const InetAddress&, int32_t, const Node *, uint32_t, ServerConsole *, void *), ServerConsole *console, void *context);
 void ShowSyncerStats(ServerConsole *console);
 void ShowAuthenticationTokens(ServerConsole *console);
+void BenchmarkTextTemplate(ServerConsole *console, const TCHAR *text, int iterations);
 
 /**
  * Format string to show value of global flag
@@ -68,17 +69,6 @@ bool NXCORE_EXPORTABLE IsCommand(const TCHAR *cmdTemplate, const TCHAR *str, int
    return i >= minChars;
 }
 
-/**
- * Show memory usage
- */
-static void ShowMemoryUsage(ServerConsole *console)
-{
-   console->printf(_T("Alarms ...................: %.02f MB\n"), static_cast<double>(GetAlarmMemoryUsage()) / 1048576);
-   console->printf(_T("Data collection cache ....: %.02f MB\n"), static_cast<double>(GetDCICacheMemoryUsage()) / 1048576);
-   console->printf(_T("Raw DCI data write cache .: %.02f MB\n"), static_cast<double>(GetRawDataWriterMemoryUsage()) / 1048576);
-   console->print(_T("\n"));
-}
-
 /**
  * Print ARP cache
  */
@@ -221,6 +211,29 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
          AddRecurrentScheduledTask(_T("Execute.Script"), szBuffer, pArg, nullptr, 0, 0, SYSTEM_ACCESS_FULL); //TODO: change to correct user
       }
    }
+   else if (IsCommand(_T("BENCHMARK"), szBuffer, 5))
+   {
+      pArg = ExtractWord(pArg, szBuffer);
+      if (IsCommand(_T("EXPAND"), szBuffer, 3))
+      {
+         pArg = ExtractWord(pArg, szBuffer);
+         int iterations = _tcstol(szBuffer, &eptr, 0);
+         while(_istspace(*pArg))
+            pArg++;
+         if ((*eptr == 0) && (iterations > 0) && (*pArg != 0))
+         {
+            BenchmarkTextTemplate(pCtx, pArg, iterations);
+         }
+         else
+         {
+            ConsoleWrite(pCtx, _T("Usage: BENCHMARK EXPAND <count> <text>\n"));
+         }
+      }
+      else
+      {
+         ConsoleWrite(pCtx, _T("Invalid subcommand\n"));
+      }
+   }
    else if (IsCommand(_T("CLEAR"), szBuffer, 5))
    {
       pArg = ExtractWord(pArg, szBuffer);
@@ -229,12 +242,18 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
          ExtractWord(pArg, szBuffer);
          ClearDBWriterData(pCtx, szBuffer);
       }
+      else if (IsCommand(_T("PERF"), szBuffer, 4))
+      {
+         ResetPerfStats();
+         ConsoleWrite(pCtx, _T("Profiler counters cleared\n"));
+      }
       else if (szBuffer[0] == 0)
       {
          ConsoleWrite(pCtx,
                   _T("Valid components:\n")
                   _T("   DBWriter Counters\n")
                   _T("   DBWriter DataQueue\n")
+                  _T("   Perf\n")
                   _T("\n"));
       }
       else
@@ -807,7 +826,11 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
          {
             PoolConnectionInfo *c = list->get(i);
             TCHAR accessTime[64];
-            ConsolePrintf(pCtx, _T("%p %s %hs:%d\n"), c->handle, FormatTimestamp(c->lastAccessTime, accessTime), c->srcFile, c->srcLine);
+            ConsolePrintf(pCtx, _T("%p %s %hs:%d (waited %u ms; call site history: ") UINT64_FMT _T(" <1ms, ") UINT64_FMT _T(" <10ms, ")
+                     UINT64_FMT _T(" <100ms, ") UINT64_FMT _T(" <1s, ") UINT64_FMT _T(" <10s, ") UINT64_FMT _T(" >=10s)\n"),
+                     c->handle, FormatTimestamp(c->lastAccessTime, accessTime), c->srcFile, c->srcLine, c->acquireTime,
+                     c->acquireHistogram[0], c->acquireHistogram[1], c->acquireHistogram[2], c->acquireHistogram[3],
+                     c->acquireHistogram[4], c->acquireHistogram[5]);
          }
          ConsolePrintf(pCtx, _T("%d database connections in use\n\n"), list->size());
          delete list;
@@ -825,6 +848,7 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
 
          ConsolePrintf(pCtx, _T("Background writer requests:\n"));
          ConsolePrintf(pCtx, _T("   DCI data ....... ") INT64_FMT _T("\n"), g_idataWriteRequests);
+         ConsolePrintf(pCtx, _T("   DCI table data . ") INT64_FMT _T("\n"), g_tdataWriteRequests);
          ConsolePrintf(pCtx, _T("   DCI raw data ... ") INT64_FMT _T("\n"), g_rawDataWriteRequests);
          ConsolePrintf(pCtx, _T("   Others ......... ") INT64_FMT _T("\n"), g_otherWriteRequests);
       }
@@ -860,6 +884,30 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
             ConsoleWrite(pCtx, _T("Parallel event processing is disabled\n"));
          }
          delete stats;
+
+         EventLogWriterStats writerStats;
+         GetEventLogWriterStats(&writerStats);
+         ConsolePrintf(pCtx, _T("\nEvent log writer:\n")
+                  _T("   Threads ........: %d\n")
+                  _T("   Queue size .....: %u (max %u)\n")
+                  _T("   Written events .: ") UINT64_FMT _T("\n")
+                  _T("   Dropped events .: ") UINT64_FMT _T("\n")
+                  _T("   Batches ........: ") UINT64_FMT _T("\n")
+                  _T("   Batch time .....: %u ms average, %u ms max\n"),
+                  writerStats.writerThreads, writerStats.queueSize, static_cast<uint32_t>(writerStats.maxQueueSize),
+                  writerStats.writtenEvents, writerStats.droppedEvents, writerStats.batches,
+                  (writerStats.batches > 0) ? static_cast<uint32_t>(writerStats.totalWriteTime / writerStats.batches) : 0,
+                  writerStats.maxBatchWriteTime);
+
+         EventRateLimiterStats limiterStats;
+         GetEventRateLimiterStats(&limiterStats);
+         ConsolePrintf(pCtx, _T("\nEvent rate limiter:\n")
+                  _T("   Limits .........: %u/s per source, %u/s per event code\n")
+                  _T("   Active buckets .: %u sources, %u event codes\n")
+                  _T("   Suppressed .....: ") UINT64_FMT _T(" by source, ") UINT64_FMT _T(" by event code\n")
+                  _T("   Summary events .: ") UINT64_FMT _T("\n"),
+                  limiterStats.sourceRate, limiterStats.eventCodeRate, limiterStats.sourceBuckets, limiterStats.eventCodeBuckets,
+                  limiterStats.suppressedBySource, limiterStats.suppressedByEventCode, limiterStats.summaryEvents);
       }
       else if (IsCommand(_T("FDB"), szBuffer, 3))
       {
@@ -1108,6 +1156,10 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
                ConsoleWrite(pCtx, _T("ERROR: Invalid index name\n\n"));
          }
       }
+      else if (IsCommand(_T("LATENCY"), szBuffer, 2))
+      {
+         ShowLatencyHistograms(pCtx);
+      }
       else if (IsCommand(_T("LLDP"), szBuffer, 4))
       {
          // Get argument
@@ -1175,6 +1227,10 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
       {
          ShowPredictionEngines(pCtx);
       }
+      else if (IsCommand(_T("PERF"), szBuffer, 3))
+      {
+         ShowPerfStats(pCtx);
+      }
       else if (IsCommand(_T("POLLERS"), szBuffer, 2))
       {
          ShowPollers(pCtx);
@@ -1186,6 +1242,7 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
          ShowQueueStats(pCtx, &g_templateUpdateQueue, _T("Template updater"));
          ShowQueueStats(pCtx, &g_dbWriterQueue, _T("Database writer"));
          ShowQueueStats(pCtx, GetIDataWriterQueueSize(), _T("Database writer (IData)"));
+         ShowQueueStats(pCtx, GetTDataWriterQueueSize(), _T("Database writer (TData)"));
          ShowQueueStats(pCtx, GetRawDataWriterQueueSize(), _T("Database writer (raw DCI values)"));
          ShowQueueStats(pCtx, GetEventProcessorQueueSize(), _T("Event processor"));
          ShowQueueStats(pCtx, GetEventLogWriterQueueSize(), _T("Event log writer"));
@@ -1496,6 +1553,45 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
       if (libraryLocked)
          scriptLibrary->unlock();
    }
+   else if (IsCommand(_T("PROFILE"), szBuffer, 4))
+   {
+      pArg = ExtractWord(pArg, szBuffer);
+      if (szBuffer[0] != 0)
+      {
+         NXSL_ServerEnv *env = new NXSL_ServerEnv();
+         env->setConsole(pCtx);
+         NXSL_VM *vm = GetServerScriptLibrary()->createVM(szBuffer, env);
+         if (vm != nullptr)
+         {
+            vm->enableProfiling();
+
+            NXSL_Value *argv[32];
+            int argc = 0;
+            while(argc < 32)
+            {
+               pArg = ExtractWord(pArg, szBuffer);
+               if (szBuffer[0] == 0)
+                  break;
+               argv[argc++] = vm->createValue(szBuffer);
+            }
+
+            if (vm->run(argc, argv))
+               ConsolePrintf(pCtx, _T("INFO: Script finished with return value %s\n\n"), vm->getResult()->getValueAsCString());
+            else
+               ConsolePrintf(pCtx, _T("ERROR: Script finished with error: %s\n\n"), vm->getErrorText());
+            PrintScriptProfile(pCtx, vm, false, 40);
+            delete vm;
+         }
+         else
+         {
+            ConsolePrintf(pCtx, _T("ERROR: Script \"%s\" not found in script library\n\n"), szBuffer);
+         }
+      }
+      else
+      {
+         ConsoleWrite(pCtx, _T("Usage: PROFILE <script> [<params>]\n"));
+      }
+   }
    else if (IsCommand(_T("TCPPING"), szBuffer, 4))
    {
       pArg = ExtractWord(pArg, szBuffer);
@@ -1642,6 +1738,7 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
             _T("Valid commands are:\n")
             _T("   at +<sec> <script> [<params>]     - Schedule one time script execution task\n")
             _T("   at <schedule> <script> [<params>] - Schedule repeated script execution task\n")
+            _T("   benchmark expand <count> <text>   - Benchmark macro expansion for given text template\n")
             _T("   clear                             - Show list of valid component names for clearing\n")
             _T("   clear <component>                 - Clear internal data or queue for given component\n")
             _T("   dbcp reset                        - Reset database connection pool\n")
@@ -1661,6 +1758,7 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
             _T("   logmark                           - Write marker ******* MARK ******* to server log file\n")
             _T("   ping <address>                    - Send ICMP echo request to given IP address\n")
             _T("   poll <type> <node>                - Initiate node poll\n")
+            _T("   profile <script> [<params>]       - Execute NXSL script from script library with profiling\n")
             _T("   raise <exception>                 - Raise exception\n")
             _T("   scan rangeStart rangeEnd [proxy <id>|zone <uin>] [discovery] \n")
             _T("                                     - Manual active discovery scan for given range. Without 'discovery' parameter prints results only\n")
@@ -1671,17 +1769,20 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
             _T("   show dbcp                         - Show active sessions in database connection pool\n")
             _T("   show dbstats                      - Show DB library statistics\n")
             _T("   show discovery queue              - Show content of network discovery queue\n")
-            _T("   show ep                           - Show event processing threads statistics\n")
+            _T("   show ep                           - Show event processing threads and rate limiter statistics\n")
             _T("   show fdb <node>                   - Show forwarding database for node\n")
             _T("   show flags                        - Show internal server flags\n")
             _T("   show heap details                 - Show detailed heap information\n")
             _T("   show heap summary                 - Show heap usage summary\n")
             _T("   show index <index>                - Show internal index\n")
+            _T("   show latency                      - Show latency histograms for thread pools, DB writers and event queues\n")
+            _T("   show memusage                     - Show memory usage by server subsystems and object classes\n")
             _T("   show modules                      - Show loaded server modules\n")
             _T("   show msgwq                        - Show message wait queues information\n")
             _T("   show ndd                          - Show loaded network device drivers\n")
             _T("   show objects [<filter>]           - Dump network objects to screen\n")
             _T("   show pe                           - Show registered prediction engines\n")
+            _T("   show perf                         - Show built-in profiler statistics for server hot paths\n")
             _T("   show pollers                      - Show poller threads state information\n")
             _T("   show queues                       - Show internal queues statistics\n")
             _T("   show routing-table <node>         - Show cached routing table for node\n")
@@ -243,6 +243,7 @@ void DataCollector(const shared_ptr<DCObject>& dcObject)
       return;
    }
 
+   PerfScopedTimer perfTimer(PerfHotPath::DATA_COLLECTION, target->getId());
    DbgPrintf(8, _T("DataCollector(): processing DC object %d \"%s\" owner=%d sourceNode=%d"),
              dcObject->getId(), dcObjectName.cstr(), (target != nullptr) ? (int)target->getId() : -1, dcObject->getSourceNode());
    uint32_t sourceNodeId = target->getEffectiveSourceNode(dcObject.get());
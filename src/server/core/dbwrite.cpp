@@ -48,6 +48,18 @@ struct DELAYED_IDATA_INSERT
    TCHAR transformedValue[MAX_RESULT_LENGTH];
 };
 
+/**
+ * Delayed request for tdata INSERT
+ */
+struct DELAYED_TDATA_INSERT
+{
+   time_t timestamp;
+   uint32_t nodeId;
+   uint32_t tableId;
+   DCObjectStorageClass storageClass;
+   char value[1];    /* actual size determined by packed value length */
+};
+
 /**
  * Delayed request for raw_dci_values UPDATE or DELETE
  */
@@ -69,7 +81,27 @@ struct IDataWriter
 {
    THREAD thread;
    ObjectQueue<DELAYED_IDATA_INSERT> *queue;
-   const TCHAR *storageClass;
+   const TCHAR *storageClass;    // Set if data is stored in separate table per storage class (TimescaleDB or partitioned tables)
+
+   /**
+    * Get name of destination table
+    */
+   void getTableName(TCHAR *buffer) const
+   {
+      if (storageClass != nullptr)
+         _sntprintf(buffer, 64, _T("idata_sc_%s"), storageClass);
+      else
+         _tcscpy(buffer, _T("idata"));
+   }
+};
+
+/**
+ * TData writer
+ */
+struct TDataWriter
+{
+   THREAD thread;
+   ObjectQueue<DELAYED_TDATA_INSERT> *queue;
 };
 
 /**
@@ -77,6 +109,11 @@ struct IDataWriter
  */
 #define MAX_IDATA_WRITERS  64
 
+/**
+ * Maximum possible number of TData writers
+ */
+#define MAX_TDATA_WRITERS  64
+
 /**
  * Configured number of IData writers
  */
@@ -87,6 +124,16 @@ static int s_idataWriterCount = 1;
  */
 static IDataWriter s_idataWriters[MAX_IDATA_WRITERS];
 
+/**
+ * Configured number of TData writers
+ */
+static int s_tdataWriterCount = 1;
+
+/**
+ * TData writers
+ */
+static TDataWriter s_tdataWriters[MAX_TDATA_WRITERS];
+
 /**
  * Custom destructor for writer queue
  */
@@ -111,6 +158,7 @@ static int s_batchSize = 0;
  * Performance counters
  */
 VolatileCounter64 g_idataWriteRequests = 0;
+VolatileCounter64 g_tdataWriteRequests = 0;
 uint64_t g_rawDataWriteRequests = 0;
 VolatileCounter64 g_otherWriteRequests = 0;
 
@@ -124,6 +172,14 @@ static Condition s_queueMonitorStopCondition(true);
 /**
  * Static data
  */
+/**
+ * Write time histograms (microseconds spent writing single request or batch)
+ */
+static LatencyHistogram s_idataWriteTime;
+static LatencyHistogram s_tdataWriteTime;
+static LatencyHistogram s_rawDataWriteTime;
+static LatencyHistogram s_otherWriteTime;
+
 static THREAD s_writerThread = INVALID_THREAD_HANDLE;
 static THREAD s_rawDataWriterThread = INVALID_THREAD_HANDLE;
 static THREAD s_queueMonitorThread = INVALID_THREAD_HANDLE;
@@ -235,7 +291,7 @@ void QueueIDataInsert(time_t timestamp, uint32_t nodeId, uint32_t dciId, const T
 	rq->dciId = dciId;
    _tcslcpy(rq->rawValue, rawValue, MAX_RESULT_LENGTH);
    _tcslcpy(rq->transformedValue, transformedValue, MAX_RESULT_LENGTH);
-   if ((g_flags & AF_SINGLE_TABLE_PERF_DATA) && (g_dbSyntax == DB_SYNTAX_TSDB))
+   if (((g_flags & AF_SINGLE_TABLE_PERF_DATA) && (g_dbSyntax == DB_SYNTAX_TSDB)) || (g_flags & AF_PARTITIONED_PERF_DATA))
    {
       s_idataWriters[static_cast<int>(storageClass)].queue->put(rq);
    }
@@ -251,6 +307,25 @@ void QueueIDataInsert(time_t timestamp, uint32_t nodeId, uint32_t dciId, const T
 	InterlockedIncrement64(&g_idataWriteRequests);
 }
 
+/**
+ * Queue INSERT request for tdata table. Value is expected to be packed table.
+ */
+void QueueTDataInsert(time_t timestamp, uint32_t nodeId, uint32_t tableId, DCObjectStorageClass storageClass, const char *value)
+{
+   if (s_queueMonitorDiscardFlag)
+      return;
+
+   size_t len = strlen(value);
+   DELAYED_TDATA_INSERT *rq = static_cast<DELAYED_TDATA_INSERT*>(MemAlloc(sizeof(DELAYED_TDATA_INSERT) + len));
+   rq->timestamp = timestamp;
+   rq->nodeId = nodeId;
+   rq->tableId = tableId;
+   rq->storageClass = storageClass;
+   memcpy(rq->value, value, len + 1);
+   s_tdataWriters[(s_tdataWriterCount > 1) ? nodeId % s_tdataWriterCount : 0].queue->put(rq);
+   InterlockedIncrement64(&g_tdataWriteRequests);
+}
+
 /**
  * Queue UPDATE request for raw_dci_values table
  */
@@ -305,6 +380,7 @@ static void DBWriteThread()
       if (rq == INVALID_POINTER_VALUE)   // End-of-job indicator
          break;
 
+      uint64_t startTime = GetMonotonicClockTimeNs();
       DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
 
 		if (rq->bindCount == 0)
@@ -327,7 +403,115 @@ static void DBWriteThread()
       MemFree(rq);
 
       DBConnectionPoolReleaseConnection(hdb);
+      uint64_t elapsedTime = (GetMonotonicClockTimeNs() - startTime) / 1000;
+      s_otherWriteTime.update(elapsedTime);
+      PerfRecord(PerfHotPath::DB_WRITER_BATCH, 0, elapsedTime);
+   }
+}
+
+/**
+ * Build INSERT query for tdata request
+ */
+static void BuildTDataInsertQuery(const DELAYED_TDATA_INSERT *rq, TCHAR *query)
+{
+   if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
+   {
+      if (g_dbSyntax == DB_SYNTAX_TSDB)
+      {
+         _sntprintf(query, 256, _T("INSERT INTO tdata_sc_%s (item_id,tdata_timestamp,tdata_value) VALUES (?,to_timestamp(?),?)"),
+                  DCObject::getStorageClassName(rq->storageClass));
+      }
+      else if (g_flags & AF_PARTITIONED_PERF_DATA)
+      {
+         _sntprintf(query, 256, _T("INSERT INTO tdata_sc_%s (item_id,tdata_timestamp,tdata_value) VALUES (?,?,?)"),
+                  DCObject::getStorageClassName(rq->storageClass));
+      }
+      else
+      {
+         _tcscpy(query, _T("INSERT INTO tdata (item_id,tdata_timestamp,tdata_value) VALUES (?,?,?)"));
+      }
+   }
+   else
+   {
+      _sntprintf(query, 256, _T("INSERT INTO tdata_%u (item_id,tdata_timestamp,tdata_value) VALUES (?,?,?)"), rq->nodeId);
+   }
+}
+
+/**
+ * Database "lazy" write thread for tdata INSERTs
+ */
+static THREAD_RESULT THREAD_CALL TDataWriteThread(void *arg)
+{
+   ThreadSetName("DBWriter/TData");
+   TDataWriter *writer = static_cast<TDataWriter*>(arg);
+   int maxRecords = ConfigReadInt(_T("DBWriter.MaxRecordsPerTransaction"), 1000);
+   while(true)
+   {
+      DELAYED_TDATA_INSERT *rq = writer->queue->getOrBlock();
+      if (rq == INVALID_POINTER_VALUE)   // End-of-job indicator
+         break;
+
+      uint64_t startTime = GetMonotonicClockTimeNs();
+      DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+      if (DBBegin(hdb))
+      {
+         // Consecutive requests usually go to same table, so statement is only re-prepared when target table changes
+         TCHAR currentQuery[256] = _T("");
+         DB_STATEMENT hStmt = nullptr;
+         int count = 0;
+         while(true)
+         {
+            TCHAR query[256];
+            BuildTDataInsertQuery(rq, query);
+            if (_tcscmp(query, currentQuery))
+            {
+               if (hStmt != nullptr)
+                  DBFreeStatement(hStmt);
+               hStmt = DBPrepare(hdb, query, true);
+               _tcscpy(currentQuery, query);
+            }
+
+            bool success;
+            if (hStmt != nullptr)
+            {
+               DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, rq->tableId);
+               DBBind(hStmt, 2, DB_SQLTYPE_INTEGER, static_cast<int64_t>(rq->timestamp));
+               DBBind(hStmt, 3, DB_SQLTYPE_TEXT, DB_CTYPE_UTF8_STRING, rq->value, DB_BIND_STATIC);
+               success = DBExecute(hStmt);
+            }
+            else
+            {
+               success = false;
+            }
+
+            MemFree(rq);
+
+            count++;
+            if (!success || (count > maxRecords))
+               break;
+
+            rq = writer->queue->getOrBlock(500);
+            if ((rq == nullptr) || (rq == INVALID_POINTER_VALUE))
+               break;
+         }
+         if (hStmt != nullptr)
+            DBFreeStatement(hStmt);
+         DBCommit(hdb);
+      }
+      else
+      {
+         MemFree(rq);
+      }
+      DBConnectionPoolReleaseConnection(hdb);
+      uint64_t elapsedTime = (GetMonotonicClockTimeNs() - startTime) / 1000;
+      s_tdataWriteTime.update(elapsedTime);
+      PerfRecord(PerfHotPath::DB_WRITER_BATCH, 0, elapsedTime);
+
+      if (rq == INVALID_POINTER_VALUE)   // End-of-job indicator
+         break;
    }
+
+   return THREAD_OK;
 }
 
 /**
@@ -355,6 +539,7 @@ static THREAD_RESULT THREAD_CALL IDataWriteThread(void *arg)
          idataLock = false;
       }
 
+      uint64_t startTime = GetMonotonicClockTimeNs();
       DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
 		if (DBBegin(hdb))
 		{
@@ -386,12 +571,14 @@ static THREAD_RESULT THREAD_CALL IDataWriteThread(void *arg)
 				}
 				else
 				{
-               TCHAR query[1024];
-               _sntprintf(query, 1024, _T("INSERT INTO idata_%d (item_id,idata_timestamp,idata_value,raw_value) VALUES (%d,%d,%s,%s)"),
-                          (int)rq->nodeId, (int)rq->dciId, (int)rq->timestamp,
-                          (const TCHAR *)DBPrepareString(hdb, rq->transformedValue),
-                          (const TCHAR *)DBPrepareString(hdb, rq->rawValue));
-               success = DBQuery(hdb, query);
+               char *transformedValue = DBPrepareStringAsUTF8(hdb, rq->transformedValue);
+               char *rawValue = DBPrepareStringAsUTF8(hdb, rq->rawValue);
+               char query[4096];
+               snprintf(query, 4096, "INSERT INTO idata_%d (item_id,idata_timestamp,idata_value,raw_value) VALUES (%d,%d,%s,%s)",
+                        (int)rq->nodeId, (int)rq->dciId, (int)rq->timestamp, transformedValue, rawValue);
+               MemFree(transformedValue);
+               MemFree(rawValue);
+               success = DBQueryUTF8(hdb, query);
 				}
 
 				MemFree(rq);
@@ -411,6 +598,9 @@ static THREAD_RESULT THREAD_CALL IDataWriteThread(void *arg)
 			MemFree(rq);
 		}
 		DBConnectionPoolReleaseConnection(hdb);
+		uint64_t elapsedTime = (GetMonotonicClockTimeNs() - startTime) / 1000;
+		s_idataWriteTime.update(elapsedTime);
+		PerfRecord(PerfHotPath::DB_WRITER_BATCH, 0, elapsedTime);
 
 		if (idataLock)
 		   RWLockUnlock(s_idataWriteLock);
@@ -431,7 +621,12 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_Generic(void *arg)
    IDataWriter *writer = static_cast<IDataWriter*>(arg);
    int maxRecords = ConfigReadInt(_T("DBWriter.MaxRecordsPerTransaction"), 1000);
 
-   TCHAR query[1024];
+   TCHAR table[64];
+   writer->getTableName(table);
+   char utf8table[64];
+   tchar_to_utf8(table, -1, utf8table, 64);
+
+   char query[4096];
    while(true)
    {
       DELAYED_IDATA_INSERT *rq = writer->queue->getOrBlock();
@@ -439,7 +634,7 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_Generic(void *arg)
          break;
 
       bool idataLock;
-      if (g_flags & AF_DBWRITER_HK_INTERLOCK)
+      if ((g_flags & AF_DBWRITER_HK_INTERLOCK) && (writer->storageClass == nullptr))
       {
          RWLockReadLock(s_idataWriteLock);
          idataLock = true;
@@ -449,17 +644,20 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_Generic(void *arg)
          idataLock = false;
       }
 
+      uint64_t startTime = GetMonotonicClockTimeNs();
       DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
       if (DBBegin(hdb))
       {
          int count = 0;
          while(true)
          {
-            _sntprintf(query, 1024, _T("INSERT INTO idata (item_id,idata_timestamp,idata_value,raw_value) VALUES (%d,%d,%s,%s)"),
-                       (int)rq->dciId, (int)rq->timestamp,
-                       (const TCHAR *)DBPrepareString(hdb, rq->transformedValue),
-                       (const TCHAR *)DBPrepareString(hdb, rq->rawValue));
-            bool success = DBQuery(hdb, query);
+            char *transformedValue = DBPrepareStringAsUTF8(hdb, rq->transformedValue);
+            char *rawValue = DBPrepareStringAsUTF8(hdb, rq->rawValue);
+            snprintf(query, 4096, "INSERT INTO %s (item_id,idata_timestamp,idata_value,raw_value) VALUES (%d,%d,%s,%s)",
+                     utf8table, (int)rq->dciId, (int)rq->timestamp, transformedValue, rawValue);
+            MemFree(transformedValue);
+            MemFree(rawValue);
+            bool success = DBQueryUTF8(hdb, query);
 
             MemFree(rq);
 
@@ -478,6 +676,9 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_Generic(void *arg)
          MemFree(rq);
       }
       DBConnectionPoolReleaseConnection(hdb);
+      uint64_t elapsedTime = (GetMonotonicClockTimeNs() - startTime) / 1000;
+      s_idataWriteTime.update(elapsedTime);
+      PerfRecord(PerfHotPath::DB_WRITER_BATCH, 0, elapsedTime);
 
       if (idataLock)
          RWLockUnlock(s_idataWriteLock);
@@ -490,26 +691,124 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_Generic(void *arg)
 }
 
 /**
- * Database "lazy" write thread for idata INSERTs - PostgreSQL version
+ * Write batch of idata records using bulk load (COPY on PostgreSQL). Returns false on failure,
+ * in which case transaction is rolled back and caller should write batch using INSERT statements.
  */
-static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_PostgreSQL(void *arg)
+static bool BulkLoadIData(DB_HANDLE hdb, const TCHAR *table, DELAYED_IDATA_INSERT **batch, int count, bool convertTimestamps)
 {
-   ThreadSetName("DBWriter/IData");
-   IDataWriter *writer = static_cast<IDataWriter*>(arg);
+   if (!DBBegin(hdb))
+      return false;
+
+   DB_BULK_LOAD hLoad = DBBulkLoadBegin(hdb, table, _T("item_id,idata_timestamp,idata_value,raw_value"), 4);
+   if (hLoad == nullptr)
+   {
+      DBRollback(hdb);
+      return false;
+   }
+
+   TCHAR dciId[16], timestamp[32];
+   const TCHAR *values[4] = { dciId, timestamp, nullptr, nullptr };
+   bool success = true;
+   for(int i = 0; (i < count) && success; i++)
+   {
+      DELAYED_IDATA_INSERT *rq = batch[i];
+      _sntprintf(dciId, 16, _T("%u"), rq->dciId);
+      if (convertTimestamps)
+      {
+         struct tm tmbuff;
+         _tcsftime(timestamp, 32, _T("%Y-%m-%d %H:%M:%S+00"), gmtime_r(&rq->timestamp, &tmbuff));
+      }
+      else
+      {
+         _sntprintf(timestamp, 32, _T("%u"), static_cast<unsigned int>(rq->timestamp));
+      }
+      values[2] = rq->transformedValue;
+      values[3] = rq->rawValue;
+      success = DBBulkLoadAddRow(hLoad, values);
+   }
 
-   bool convertTimestamps;
-   TCHAR queryBase[256];
-   if (writer->storageClass != nullptr)   // TimescaleDB
+   if (success)
    {
-      _sntprintf(queryBase, 256, _T("INSERT INTO idata_sc_%s (item_id,idata_timestamp,idata_value,raw_value) VALUES"), writer->storageClass);
-      convertTimestamps = true;
+      success = DBBulkLoadEnd(hLoad);
    }
    else
    {
-      _tcscpy(queryBase, _T("INSERT INTO idata (item_id,idata_timestamp,idata_value,raw_value) VALUES"));
-      convertTimestamps = false;
+      DBBulkLoadCancel(hLoad);
    }
 
+   if (success)
+   {
+      success = DBCommit(hdb);
+   }
+   else
+   {
+      DBRollback(hdb);
+   }
+   return success;
+}
+
+/**
+ * Write batch of idata records using multi-row INSERT statements
+ */
+static void InsertIData(DB_HANDLE hdb, const char *queryBase, DELAYED_IDATA_INSERT **batch, int count, bool convertTimestamps, int maxRecordsPerStmt)
+{
+   if (!DBBegin(hdb))
+      return;
+
+   size_t queryBaseLen = strlen(queryBase);
+   ByteStream query(65536);
+   query.setAllocationStep(65536);
+   query.write(queryBase, queryBaseLen);
+
+   char data[4096];
+   int countStmt = 0;
+   for(int i = 0; i < count; i++)
+   {
+      DELAYED_IDATA_INSERT *rq = batch[i];
+      char *transformedValue = DBPrepareStringAsUTF8(hdb, rq->transformedValue);
+      char *rawValue = DBPrepareStringAsUTF8(hdb, rq->rawValue);
+      int len = snprintf(data, 4096, convertTimestamps ? "%c(%u,to_timestamp(%u),%s,%s)" : "%c(%u,%u,%s,%s)",
+                 (countStmt > 0) ? ',' : ' ', rq->dciId, (unsigned int)rq->timestamp, transformedValue, rawValue);
+      MemFree(transformedValue);
+      MemFree(rawValue);
+      query.write(data, std::min(len, 4095));
+      countStmt++;
+
+      if (countStmt >= maxRecordsPerStmt)
+      {
+         countStmt = 0;
+         query.write(" ON CONFLICT DO NOTHING", 24);   // include terminating zero
+         if (!DBQueryUTF8(hdb, reinterpret_cast<const char*>(query.buffer())))
+            break;
+         query.clear();
+         query.write(queryBase, queryBaseLen);
+      }
+   }
+   if (countStmt > 0)
+   {
+      query.write(" ON CONFLICT DO NOTHING", 24);   // include terminating zero
+      DBQueryUTF8(hdb, reinterpret_cast<const char*>(query.buffer()));
+   }
+   DBCommit(hdb);
+}
+
+/**
+ * Database "lazy" write thread for idata INSERTs - PostgreSQL version. Data is written using
+ * COPY if supported by driver, with fallback to multi-row INSERT statements (for example, if
+ * batch contains records already present in database).
+ */
+static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_PostgreSQL(void *arg)
+{
+   ThreadSetName("DBWriter/IData");
+   IDataWriter *writer = static_cast<IDataWriter*>(arg);
+
+   TCHAR table[64];
+   writer->getTableName(table);
+   bool convertTimestamps = (g_dbSyntax == DB_SYNTAX_TSDB);
+   char utf8table[64], queryBase[256];
+   tchar_to_utf8(table, -1, utf8table, 64);
+   snprintf(queryBase, 256, "INSERT INTO %s (item_id,idata_timestamp,idata_value,raw_value) VALUES", utf8table);
+
    int maxRecordsPerTxn = ConfigReadInt(_T("DBWriter.MaxRecordsPerTransaction"), 1000);
    int maxRecordsPerStmt = ConfigReadInt(_T("DBWriter.MaxRecordsPerStatement"), 100);
    if (maxRecordsPerTxn < maxRecordsPerStmt)
@@ -517,19 +816,25 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_PostgreSQL(void *ar
    else if (maxRecordsPerTxn % maxRecordsPerStmt != 0)
       maxRecordsPerTxn = (maxRecordsPerTxn / maxRecordsPerStmt + 1) * maxRecordsPerStmt;
 
-   StringBuffer query;
-   query.setAllocationStep(65536);
-
-   TCHAR data[1024];
-
+   DELAYED_IDATA_INSERT **batch = MemAllocArrayNoInit<DELAYED_IDATA_INSERT*>(maxRecordsPerTxn);
    while(true)
    {
       DELAYED_IDATA_INSERT *rq = writer->queue->getOrBlock();
       if (rq == INVALID_POINTER_VALUE)   // End-of-job indicator
          break;
 
+      int count = 0;
+      batch[count++] = rq;
+      while(count < maxRecordsPerTxn)
+      {
+         rq = writer->queue->getOrBlock(500);
+         if ((rq == nullptr) || (rq == INVALID_POINTER_VALUE))
+            break;
+         batch[count++] = rq;
+      }
+
       bool idataLock;
-      if (writer->storageClass == nullptr)   // Lock is not needed for TimescaleDB
+      if (writer->storageClass == nullptr)   // Lock is not needed for TimescaleDB and partitioned tables
       {
          if (g_flags & AF_DBWRITER_HK_INTERLOCK)
          {
@@ -546,59 +851,29 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_PostgreSQL(void *ar
          idataLock = false;
       }
 
+      uint64_t startTime = GetMonotonicClockTimeNs();
       DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
-      if (DBBegin(hdb))
+      if (!DBIsBulkLoadSupported(hdb) || !BulkLoadIData(hdb, table, batch, count, convertTimestamps))
       {
-         query = queryBase;
-         int countTxn = 0, countStmt = 0;
-         while(true)
-         {
-            _sntprintf(data, 1024, convertTimestamps ? _T("%c(%u,to_timestamp(%u),%s,%s)") : _T("%c(%u,%u,%s,%s)"),
-                       (countStmt > 0) ? _T(',') : _T(' '),
-                       rq->dciId, (unsigned int)rq->timestamp,
-                       (const TCHAR *)DBPrepareString(hdb, rq->transformedValue),
-                       (const TCHAR *)DBPrepareString(hdb, rq->rawValue));
-            query.append(data);
-            MemFree(rq);
-
-            countTxn++;
-            countStmt++;
-
-            if (countStmt >= maxRecordsPerStmt)
-            {
-               countStmt = 0;
-               query.append(_T(" ON CONFLICT DO NOTHING"));
-               if (!DBQuery(hdb, query))
-                  break;
-               query = queryBase;
-            }
-
-            if (countTxn >= maxRecordsPerTxn)
-               break;
-
-            rq = writer->queue->getOrBlock(500);
-            if ((rq == nullptr) || (rq == INVALID_POINTER_VALUE))
-               break;
-         }
-         if (countStmt > 0)
-         {
-            query.append(_T(" ON CONFLICT DO NOTHING"));
-            DBQuery(hdb, query);
-         }
-         DBCommit(hdb);
-      }
-      else
-      {
-         MemFree(rq);
+         if (DBIsBulkLoadSupported(hdb))
+            nxlog_debug_tag(DEBUG_TAG, 6, _T("Bulk load into %s failed, falling back to INSERT for %d records"), table, count);
+         InsertIData(hdb, queryBase, batch, count, convertTimestamps, maxRecordsPerStmt);
       }
       DBConnectionPoolReleaseConnection(hdb);
+      uint64_t elapsedTime = (GetMonotonicClockTimeNs() - startTime) / 1000;
+      s_idataWriteTime.update(elapsedTime);
+      PerfRecord(PerfHotPath::DB_WRITER_BATCH, 0, elapsedTime);
 
       if (idataLock)
          RWLockUnlock(s_idataWriteLock);
 
+      for(int i = 0; i < count; i++)
+         MemFree(batch[i]);
+
       if (rq == INVALID_POINTER_VALUE)   // End-of-job indicator
          break;
    }
+   MemFree(batch);
 
    return THREAD_OK;
 }
@@ -611,6 +886,11 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_Oracle(void *arg)
    ThreadSetName("DBWriter/IData");
    IDataWriter *writer = static_cast<IDataWriter*>(arg);
    int maxRecords = ConfigReadInt(_T("DBWriter.MaxRecordsPerTransaction"), 1000);
+
+   TCHAR table[64], query[256];
+   writer->getTableName(table);
+   _sntprintf(query, 256, _T("INSERT INTO %s (item_id,idata_timestamp,idata_value,raw_value) VALUES (?,?,?,?)"), table);
+
    while(true)
    {
       DELAYED_IDATA_INSERT *rq = writer->queue->getOrBlock();
@@ -618,7 +898,7 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_Oracle(void *arg)
          break;
 
       bool idataLock;
-      if (g_flags & AF_DBWRITER_HK_INTERLOCK)
+      if ((g_flags & AF_DBWRITER_HK_INTERLOCK) && (writer->storageClass == nullptr))
       {
          RWLockReadLock(s_idataWriteLock);
          idataLock = true;
@@ -628,11 +908,12 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_Oracle(void *arg)
          idataLock = false;
       }
 
+      uint64_t startTime = GetMonotonicClockTimeNs();
       DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
       if (DBBegin(hdb))
       {
          int count = 0;
-         DB_STATEMENT hStmt = DBPrepare(hdb, _T("INSERT INTO idata (item_id,idata_timestamp,idata_value,raw_value) VALUES (?,?,?,?)"));
+         DB_STATEMENT hStmt = DBPrepare(hdb, query);
          if (hStmt != NULL)
          {
             while(true)
@@ -666,6 +947,9 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_Oracle(void *arg)
          MemFree(rq);
       }
       DBConnectionPoolReleaseConnection(hdb);
+      uint64_t elapsedTime = (GetMonotonicClockTimeNs() - startTime) / 1000;
+      s_idataWriteTime.update(elapsedTime);
+      PerfRecord(PerfHotPath::DB_WRITER_BATCH, 0, elapsedTime);
 
       if (idataLock)
          RWLockUnlock(s_idataWriteLock);
@@ -677,6 +961,96 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_Oracle(void *arg)
    return THREAD_OK;
 }
 
+/**
+ * Save raw DCI data updates using bulk load into temporary table followed by single UPDATE statement
+ * (PostgreSQL only). Processed records are removed from batch, deletion requests are left for regular
+ * processing. Returns false on failure.
+ */
+static bool BulkSaveRawData(DB_HANDLE hdb, DELAYED_RAW_DATA_UPDATE **batch, int maxRecords)
+{
+   DELAYED_RAW_DATA_UPDATE **chunk = MemAllocArrayNoInit<DELAYED_RAW_DATA_UPDATE*>(maxRecords);
+   TCHAR dciId[16], lastPollTime[32], cacheTimestamp[32];
+   const TCHAR *values[5] = { dciId, nullptr, nullptr, lastPollTime, cacheTimestamp };
+
+   bool success = true;
+   while(success)
+   {
+      int count = 0;
+      DELAYED_RAW_DATA_UPDATE *rq, *tmp;
+      HASH_ITER(hh, *batch, rq, tmp)
+      {
+         if (rq->deleteFlag)
+            continue;
+         chunk[count++] = rq;
+         if (count >= maxRecords)
+            break;
+      }
+      if (count == 0)
+         break;
+
+      if (!DBBegin(hdb))
+      {
+         success = false;
+         break;
+      }
+
+      // Staging table is created once per connection and kept for connection lifetime
+      // to avoid system catalog updates on every flush
+      success = DBQuery(hdb, _T("CREATE TEMPORARY TABLE IF NOT EXISTS raw_dci_values_bulk (LIKE raw_dci_values)")) &&
+               DBQuery(hdb, _T("TRUNCATE TABLE raw_dci_values_bulk"));
+      if (success)
+      {
+         DB_BULK_LOAD hLoad = DBBulkLoadBegin(hdb, _T("raw_dci_values_bulk"), _T("item_id,raw_value,transformed_value,last_poll_time,cache_timestamp"), 5);
+         if (hLoad != nullptr)
+         {
+            for(int i = 0; (i < count) && success; i++)
+            {
+               _sntprintf(dciId, 16, _T("%u"), chunk[i]->dciId);
+               _sntprintf(lastPollTime, 32, INT64_FMT, static_cast<int64_t>(chunk[i]->timestamp));
+               _sntprintf(cacheTimestamp, 32, INT64_FMT, static_cast<int64_t>(chunk[i]->cacheTimestamp));
+               values[1] = chunk[i]->rawValue;
+               values[2] = chunk[i]->transformedValue;
+               success = DBBulkLoadAddRow(hLoad, values);
+            }
+            if (success)
+               success = DBBulkLoadEnd(hLoad);
+            else
+               DBBulkLoadCancel(hLoad);
+         }
+         else
+         {
+            success = false;
+         }
+      }
+      if (success)
+      {
+         success = DBQuery(hdb, _T("UPDATE raw_dci_values SET raw_value=b.raw_value,transformed_value=b.transformed_value,last_poll_time=b.last_poll_time,cache_timestamp=b.cache_timestamp FROM raw_dci_values_bulk b WHERE raw_dci_values.item_id=b.item_id"));
+      }
+
+      if (success)
+      {
+         success = DBCommit(hdb);
+      }
+      else
+      {
+         DBRollback(hdb);
+      }
+
+      if (success)
+      {
+         for(int i = 0; i < count; i++)
+         {
+            HASH_DEL(*batch, chunk[i]);
+            MemFree(chunk[i]);
+         }
+         s_batchSize -= count;
+      }
+   }
+
+   MemFree(chunk);
+   return success;
+}
+
 /**
  * Save raw DCI data
  */
@@ -695,8 +1069,14 @@ static void SaveRawData(int maxRecords)
    }
 
    nxlog_debug_tag(DEBUG_TAG, 7, _T("%d records in raw data batch"), s_batchSize);
+   uint64_t startTime = GetMonotonicClockTimeNs();
    DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
-   if (DBBegin(hdb))
+   if (((g_dbSyntax == DB_SYNTAX_PGSQL) || (g_dbSyntax == DB_SYNTAX_TSDB)) && DBIsBulkLoadSupported(hdb))
+   {
+      if (!BulkSaveRawData(hdb, &batch, maxRecords))
+         nxlog_debug_tag(DEBUG_TAG, 6, _T("Bulk update of raw DCI values failed, falling back to UPDATE for %d records"), s_batchSize);
+   }
+   if ((batch != nullptr) && DBBegin(hdb))
    {
       DB_STATEMENT hStmt = DBPrepare(hdb, _T("UPDATE raw_dci_values SET raw_value=?,transformed_value=?,last_poll_time=?,cache_timestamp=? WHERE item_id=?"), true);
       if (hStmt != nullptr)
@@ -751,6 +1131,7 @@ static void SaveRawData(int maxRecords)
       DBCommit(hdb);
    }
    DBConnectionPoolReleaseConnection(hdb);
+   s_rawDataWriteTime.update((GetMonotonicClockTimeNs() - startTime) / 1000);
 
    // Clean remaining items if any
    DELAYED_RAW_DATA_UPDATE *rq, *tmp;
@@ -795,7 +1176,7 @@ static void QueueMonitorThread()
          break;
       }
 
-      int64_t currentQueueSize = GetIDataWriterQueueSize();
+      int64_t currentQueueSize = GetIDataWriterQueueSize() + GetTDataWriterQueueSize();
       if (currentQueueSize > maxQueueSize)
       {
          if (!s_queueMonitorDiscardFlag)
@@ -833,7 +1214,21 @@ void StartDBWriter()
    s_writerThread = ThreadCreateEx(DBWriteThread);
 	s_rawDataWriterThread = ThreadCreateEx(RawDataWriteThread);
 
-	if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
+	if (g_flags & AF_PARTITIONED_PERF_DATA)
+	{
+	   // Use separate writer for each storage class if performance data stored in partitioned tables
+      s_idataWriterCount = static_cast<int>(DCObjectStorageClass::OTHER) + 1;
+      for(int i = 0; i < s_idataWriterCount; i++)
+      {
+         s_idataWriters[i].storageClass = DCObject::getStorageClassName(static_cast<DCObjectStorageClass>(i));
+         s_idataWriters[i].queue = new ObjectQueue<DELAYED_IDATA_INSERT>(4096, Ownership::True, QueuedRequestDestructor);
+         s_idataWriters[i].thread = ThreadCreateEx(
+                  (g_dbSyntax == DB_SYNTAX_ORACLE) ? IDataWriteThreadSingleTable_Oracle :
+                     ((g_dbSyntax == DB_SYNTAX_PGSQL) ? IDataWriteThreadSingleTable_PostgreSQL : IDataWriteThreadSingleTable_Generic),
+                  0, &s_idataWriters[i]);
+      }
+	}
+	else if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
 	{
 	   // Always use single writer if performance data stored in single table
       switch(g_dbSyntax)
@@ -880,6 +1275,24 @@ void StartDBWriter()
       }
 	}
 
+   s_tdataWriterCount = ConfigReadInt(_T("DBWriter.TableDataQueues"), 1);
+   if (s_tdataWriterCount < 1)
+      s_tdataWriterCount = 1;
+   else if (s_tdataWriterCount > MAX_TDATA_WRITERS)
+      s_tdataWriterCount = MAX_TDATA_WRITERS;
+   nxlog_debug_tag(DEBUG_TAG, 1, _T("Using %d DCI table data write queues"), s_tdataWriterCount);
+   for(int i = 0; i < s_tdataWriterCount; i++)
+   {
+      s_tdataWriters[i].queue = new ObjectQueue<DELAYED_TDATA_INSERT>(1024, Ownership::True, QueuedRequestDestructor);
+      s_tdataWriters[i].thread = ThreadCreateEx(TDataWriteThread, 0, &s_tdataWriters[i]);
+   }
+
+   g_dbWriterQueue.enableWaitTimeHistogram();
+   for(int i = 0; i < s_idataWriterCount; i++)
+      s_idataWriters[i].queue->enableWaitTimeHistogram();
+   for(int i = 0; i < s_tdataWriterCount; i++)
+      s_tdataWriters[i].queue->enableWaitTimeHistogram();
+
 	if (ConfigReadULong(_T("DBWriter.MaxQueueSize"), 0) > 0)
 	   s_queueMonitorThread = ThreadCreateEx(QueueMonitorThread);
 }
@@ -904,6 +1317,12 @@ void StopDBWriter()
       ThreadJoin(s_idataWriters[i].thread);
       delete s_idataWriters[i].queue;
    }
+   for(int i = 0; i < s_tdataWriterCount; i++)
+   {
+      s_tdataWriters[i].queue->put(INVALID_POINTER_VALUE);
+      ThreadJoin(s_tdataWriters[i].thread);
+      delete s_tdataWriters[i].queue;
+   }
    ThreadJoin(s_rawDataWriterThread);
 
    nxlog_debug_tag(DEBUG_TAG, 1, _T("All background database writers stopped"));
@@ -943,6 +1362,17 @@ int64_t GetIDataWriterQueueSize()
    return size;
 }
 
+/**
+ * Get size of TData writer queue
+ */
+int64_t GetTDataWriterQueueSize()
+{
+   int64_t size = 0;
+   for(int i = 0; i < s_tdataWriterCount; i++)
+      size += s_tdataWriters[i].queue->size();
+   return size;
+}
+
 /**
  * Get size of raw data writer queue
  */
@@ -965,6 +1395,63 @@ uint64_t GetRawDataWriterMemoryUsage()
    return size;
 }
 
+/**
+ * Get snapshot of DB writer latency histograms (queue wait time and write time, in microseconds).
+ * Valid writer names are IData, TData, RawData, and Other. Queue wait time is not tracked for raw data writer.
+ * Any of output arguments can be NULL. Returns false if writer name is invalid.
+ */
+bool GetDBWriterLatencyHistograms(const TCHAR *writer, LatencyHistogram *waitTime, LatencyHistogram *writeTime)
+{
+   if (!_tcsicmp(writer, _T("IData")))
+   {
+      if (waitTime != nullptr)
+      {
+         waitTime->reset();
+         for(int i = 0; i < s_idataWriterCount; i++)
+            if (s_idataWriters[i].queue->getWaitTimeHistogram() != nullptr)
+               waitTime->merge(*s_idataWriters[i].queue->getWaitTimeHistogram());
+      }
+      if (writeTime != nullptr)
+         *writeTime = s_idataWriteTime;
+   }
+   else if (!_tcsicmp(writer, _T("TData")))
+   {
+      if (waitTime != nullptr)
+      {
+         waitTime->reset();
+         for(int i = 0; i < s_tdataWriterCount; i++)
+            if (s_tdataWriters[i].queue->getWaitTimeHistogram() != nullptr)
+               waitTime->merge(*s_tdataWriters[i].queue->getWaitTimeHistogram());
+      }
+      if (writeTime != nullptr)
+         *writeTime = s_tdataWriteTime;
+   }
+   else if (!_tcsicmp(writer, _T("RawData")))
+   {
+      if (waitTime != nullptr)
+         waitTime->reset();
+      if (writeTime != nullptr)
+         *writeTime = s_rawDataWriteTime;
+   }
+   else if (!_tcsicmp(writer, _T("Other")))
+   {
+      if (waitTime != nullptr)
+      {
+         if (g_dbWriterQueue.getWaitTimeHistogram() != nullptr)
+            *waitTime = *g_dbWriterQueue.getWaitTimeHistogram();
+         else
+            waitTime->reset();
+      }
+      if (writeTime != nullptr)
+         *writeTime = s_otherWriteTime;
+   }
+   else
+   {
+      return false;
+   }
+   return true;
+}
+
 /**
  * Clear DB writer data from debug console
  */
@@ -973,8 +1460,13 @@ void ClearDBWriterData(ServerConsole *console, const TCHAR *component)
    if (!_tcsicmp(component, _T("Counters")))
    {
       g_idataWriteRequests = 0;
+      g_tdataWriteRequests = 0;
       g_rawDataWriteRequests = 0;
       g_otherWriteRequests = 0;
+      s_idataWriteTime.reset();
+      s_tdataWriteTime.reset();
+      s_rawDataWriteTime.reset();
+      s_otherWriteTime.reset();
       console->print(_T("Database writer counters cleared\n"));
    }
    else if (!_tcsicmp(component, _T("DataQueue")))
@@ -983,6 +1475,10 @@ void ClearDBWriterData(ServerConsole *console, const TCHAR *component)
       {
          s_idataWriters[i].queue->clear();
       }
+      for(int i = 0; i < s_tdataWriterCount; i++)
+      {
+         s_tdataWriters[i].queue->clear();
+      }
       console->print(_T("Database writer data queue cleared\n"));
    }
    else
@@ -375,19 +375,68 @@ static int F_GetSumDCIValue(int argc, NXSL_Value **argv, NXSL_Value **ppResult,
 	return F_GetDCIValueStat(argc, argv, ppResult, vm, DCI_AGG_SUM);
 }
 
+/**
+ * Read DCI values from database and append them to given array. If timestamps are requested, query should
+ * return timestamp as second column and each element of resulting array will be array [timestamp, value].
+ */
+static bool ReadDCIValues(DB_HANDLE hdb, const TCHAR *query, uint32_t dciId, int32_t startTime, int32_t endTime, bool withTimestamps, NXSL_Array *result, NXSL_VM *vm)
+{
+   DB_STATEMENT hStmt = DBPrepare(hdb, query);
+   if (hStmt == nullptr)
+      return false;
+
+   DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, dciId);
+   DBBind(hStmt, 2, DB_SQLTYPE_INTEGER, startTime);
+   DBBind(hStmt, 3, DB_SQLTYPE_INTEGER, endTime);
+   DB_RESULT hResult = DBSelectPrepared(hStmt);
+   if (hResult != nullptr)
+   {
+      int count = DBGetNumRows(hResult);
+      for(int i = 0; i < count; i++)
+      {
+         TCHAR buffer[MAX_RESULT_LENGTH];
+         DBGetField(hResult, i, 0, buffer, MAX_RESULT_LENGTH);
+         if (withTimestamps)
+         {
+            NXSL_Array *element = new NXSL_Array(vm);
+            element->append(vm->createValue(DBGetFieldInt64(hResult, i, 1)));
+            element->append(vm->createValue(buffer));
+            result->append(vm->createValue(element));
+         }
+         else
+         {
+            result->append(vm->createValue(buffer));
+         }
+      }
+      DBFreeResult(hResult);
+   }
+   DBFreeStatement(hStmt);
+   return hResult != nullptr;
+}
+
 /**
  * Get all DCI values for period
- * Format: GetDCIValues(node, dciId, startTime, endTime)
+ * Format: GetDCIValues(node, dciId, startTime, endTime, step)
+ * Optional step (in seconds) allows server to return hourly or daily averages from rollup tables
+ * for part of the period where rollup data is available. Because raw values and rollup averages
+ * have different resolution, if step is given each element is returned as array [timestamp, value],
+ * where timestamp for rollup average is start of rollup period.
  * Returns NULL if DCI not found or array of DCI values (ordered from latest to earliest)
  */
 static int F_GetDCIValues(int argc, NXSL_Value **argv, NXSL_Value **ppResult, NXSL_VM *vm)
 {
+   if ((argc < 4) || (argc > 5))
+      return NXSL_ERR_INVALID_ARGUMENT_COUNT;
+
 	if (!argv[0]->isObject())
 		return NXSL_ERR_NOT_OBJECT;
 
 	if (!argv[1]->isInteger() || !argv[2]->isInteger() || !argv[3]->isInteger())
 		return NXSL_ERR_NOT_INTEGER;
 
+   if ((argc > 4) && !argv[4]->isInteger())
+      return NXSL_ERR_NOT_INTEGER;
+
 	NXSL_Object *object = argv[0]->getValueAsObject();
    if (!object->getClass()->instanceOf(_T("DataCollectionTarget")))
       return NXSL_ERR_BAD_CLASS;
@@ -396,6 +445,16 @@ static int F_GetDCIValues(int argc, NXSL_Value **argv, NXSL_Value **ppResult, NX
 	shared_ptr<DCObject> dci = node->getDCObjectById(argv[1]->getValueAsUInt32(), 0);
 	if ((dci != nullptr) && (dci->getType() == DCO_TYPE_ITEM))
 	{
+      int32_t startTime = argv[2]->getValueAsInt32();
+      int32_t endTime = argv[3]->getValueAsInt32();
+      bool withTimestamps = (argc > 4);
+
+      // Check if rollup data can be used for beginning of requested period
+      RollupResolution rollupResolution = RollupResolution::HOURLY;
+      bool useRollup = withTimestamps && (static_cast<DCItem*>(dci.get())->getDataType() != DCI_DT_STRING) &&
+               SelectDCIRollupResolution(argv[4]->getValueAsInt32(), startTime, &rollupResolution);
+      int32_t rawStartTime = useRollup ? std::max(startTime, static_cast<int32_t>(GetDCIRollupWatermark(rollupResolution))) : startTime;
+
 		DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
 
       TCHAR query[1024];
@@ -403,50 +462,45 @@ static int F_GetDCIValues(int argc, NXSL_Value **argv, NXSL_Value **ppResult, NX
       {
          if (g_dbSyntax == DB_SYNTAX_TSDB)
          {
-            _sntprintf(query, 256,
-                     _T("SELECT idata_value FROM idata_sc_%s WHERE item_id=? AND idata_timestamp BETWEEN to_timestamp(?) AND to_timestamp(?) ORDER BY idata_timestamp DESC"),
-                     DCObject::getStorageClassName(dci->getStorageClass()));
+            _sntprintf(query, 1024,
+                     _T("SELECT idata_value%s FROM idata_sc_%s WHERE item_id=? AND idata_timestamp BETWEEN to_timestamp(?) AND to_timestamp(?) ORDER BY idata_timestamp DESC"),
+                     withTimestamps ? _T(",date_part('epoch',idata_timestamp)::int") : _T(""), DCObject::getStorageClassName(dci->getStorageClass()));
+         }
+         else if (g_flags & AF_PARTITIONED_PERF_DATA)
+         {
+            _sntprintf(query, 1024, _T("SELECT idata_value%s FROM idata_sc_%s WHERE item_id=? AND idata_timestamp BETWEEN ? AND ? ORDER BY idata_timestamp DESC"),
+                     withTimestamps ? _T(",idata_timestamp") : _T(""), DCObject::getStorageClassName(dci->getStorageClass()));
          }
          else
          {
-            _tcscpy(query, _T("SELECT idata_value FROM idata WHERE item_id=? AND idata_timestamp BETWEEN ? AND ? ORDER BY idata_timestamp DESC"));
+            _sntprintf(query, 1024, _T("SELECT idata_value%s FROM idata WHERE item_id=? AND idata_timestamp BETWEEN ? AND ? ORDER BY idata_timestamp DESC"),
+                     withTimestamps ? _T(",idata_timestamp") : _T(""));
          }
       }
       else
       {
-         _sntprintf(query, 1024, _T("SELECT idata_value FROM idata_%u WHERE item_id=? AND idata_timestamp BETWEEN ? AND ? ORDER BY idata_timestamp DESC"), node->getId());
+         _sntprintf(query, 1024, _T("SELECT idata_value%s FROM idata_%u WHERE item_id=? AND idata_timestamp BETWEEN ? AND ? ORDER BY idata_timestamp DESC"),
+                  withTimestamps ? _T(",idata_timestamp") : _T(""), node->getId());
       }
 
-      DB_STATEMENT hStmt = DBPrepare(hdb, query);
-		if (hStmt != nullptr)
-		{
-			DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, argv[1]->getValueAsUInt32());
-			DBBind(hStmt, 2, DB_SQLTYPE_INTEGER, argv[2]->getValueAsInt32());
-			DBBind(hStmt, 3, DB_SQLTYPE_INTEGER, argv[3]->getValueAsInt32());
-			DB_RESULT hResult = DBSelectPrepared(hStmt);
-			if (hResult != nullptr)
-			{
-            NXSL_Array *result = new NXSL_Array(vm);
-            int count = DBGetNumRows(hResult);
-            for(int i = 0; i < count; i++)
-            {
-               TCHAR buffer[MAX_RESULT_LENGTH];
-               DBGetField(hResult, i, 0, buffer, MAX_RESULT_LENGTH);
-               result->set(i, vm->createValue(buffer));
-            }
-				*ppResult = vm->createValue(result);
-				DBFreeResult(hResult);
-			}
-			else
-			{
-				*ppResult = vm->createValue();	// Return NULL if prepared select failed
-			}
-			DBFreeStatement(hStmt);
-		}
-		else
-		{
-			*ppResult = vm->createValue();	// Return NULL if prepare failed
-		}
+      NXSL_Array *result = new NXSL_Array(vm);
+      bool success = ReadDCIValues(hdb, query, dci->getId(), rawStartTime, endTime, withTimestamps, result, vm);
+      if (success && useRollup)
+      {
+         _sntprintf(query, 1024, _T("SELECT avg_value,rollup_timestamp FROM %s WHERE item_id=? AND rollup_timestamp BETWEEN ? AND ? ORDER BY rollup_timestamp DESC"),
+                  GetDCIRollupTable(rollupResolution));
+         success = ReadDCIValues(hdb, query, dci->getId(), startTime, std::min(endTime, rawStartTime - 1), true, result, vm);
+      }
+
+      if (success)
+      {
+         *ppResult = vm->createValue(result);
+      }
+      else
+      {
+         delete result;
+         *ppResult = vm->createValue();	// Return NULL if select failed
+      }
 
 		DBConnectionPoolReleaseConnection(hdb);
 	}
@@ -583,7 +637,7 @@ static NXSL_ExtFunction m_nxslDCIFunctions[] =
    { "GetDCIObject", F_GetDCIObject, 2 },
    { "GetDCIRawValue", F_GetDCIRawValue, 2 },
    { "GetDCIValue", F_GetDCIValue, 2 },
-   { "GetDCIValues", F_GetDCIValues, 4 },
+   { "GetDCIValues", F_GetDCIValues, -1 },
    { "GetDCIValueByDescription", F_GetDCIValueByDescription, 2 },
    { "GetDCIValueByName", F_GetDCIValueByName, 2 },
 	{ "GetMaxDCIValue", F_GetMaxDCIValue, 4 },
@@ -0,0 +1,228 @@
+/*
+** NetXMS - Network Management System
+** Copyright (C) 2003-2021 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: dci_downsampling.cpp
+**
+**/
+
+#include "nxcore.h"
+
+/**
+ * Downsampler constructor
+ */
+DCIDataDownsampler::DCIDataDownsampler(DownsamplingMethod method, time_t timeFrom, time_t bucketSize)
+{
+   m_method = method;
+   m_timeFrom = timeFrom;
+   m_bucketSize = bucketSize;
+   m_bucket = 0;
+   m_count = 0;
+   m_timestamp = 0;
+   m_value = 0;
+   m_weight = 0;
+   m_hasSelected = false;
+   m_selected.timestamp = 0;
+   m_selected.value = 0;
+   m_current = new StructArray<DownsamplingPoint>(0, 256);
+   m_next = new StructArray<DownsamplingPoint>(0, 256);
+   m_currentBucket = 0;
+   m_nextBucket = 0;
+}
+
+/**
+ * Downsampler destructor
+ */
+DCIDataDownsampler::~DCIDataDownsampler()
+{
+   delete m_current;
+   delete m_next;
+}
+
+/**
+ * Add data point. Weight is only used for averaging and allows feeding pre-aggregated values (like rollup averages).
+ */
+void DCIDataDownsampler::add(time_t timestamp, double value, double weight)
+{
+   if (m_method == DCI_DOWNSAMPLING_LTTB)
+   {
+      addLTTB(timestamp, value);
+      return;
+   }
+
+   int64_t bucket = bucketIndex(timestamp);
+   if ((m_count > 0) && (bucket != m_bucket))
+      flushBucket();
+
+   if (m_count == 0)
+   {
+      m_bucket = bucket;
+      m_value = (m_method == DCI_DOWNSAMPLING_AVG) ? value * weight : value;
+      m_weight = weight;
+   }
+   else if (m_method == DCI_DOWNSAMPLING_MIN)
+   {
+      if (value < m_value)
+         m_value = value;
+   }
+   else if (m_method == DCI_DOWNSAMPLING_MAX)
+   {
+      if (value > m_value)
+         m_value = value;
+   }
+   else
+   {
+      m_value += value * weight;
+      m_weight += weight;
+   }
+   m_timestamp = timestamp;   // Bucket is marked with oldest timestamp, same as SQL aggregation
+   m_count++;
+}
+
+/**
+ * Send aggregated value for current bucket
+ */
+void DCIDataDownsampler::flushBucket()
+{
+   output(m_timestamp, ((m_method == DCI_DOWNSAMPLING_AVG) && (m_weight > 0)) ? m_value / m_weight : m_value);
+   m_count = 0;
+}
+
+/**
+ * Select point from bucket that forms largest triangle with last selected point and given point
+ */
+void DCIDataDownsampler::selectPoint(StructArray<DownsamplingPoint> *bucket, double cx, double cy)
+{
+   double ax = static_cast<double>(m_selected.timestamp - m_timeFrom);
+   double ay = m_selected.value;
+   double maxArea = -1;
+   DownsamplingPoint *selected = nullptr;
+   for(int i = 0; i < bucket->size(); i++)
+   {
+      DownsamplingPoint *p = bucket->get(i);
+      double area = fabs((ax - cx) * (p->value - ay) - (ax - static_cast<double>(p->timestamp - m_timeFrom)) * (cy - ay));
+      if (area > maxArea)
+      {
+         maxArea = area;
+         selected = p;
+      }
+   }
+   output(selected->timestamp, selected->value);
+   m_selected = *selected;
+}
+
+/**
+ * Add data point for LTTB downsampling. Selection from bucket is made when next bucket is complete,
+ * because LTTB uses average point of next bucket as third vertex of triangle.
+ */
+void DCIDataDownsampler::addLTTB(time_t timestamp, double value)
+{
+   DownsamplingPoint p;
+   p.timestamp = timestamp;
+   p.value = value;
+
+   // First point is always selected
+   if (!m_hasSelected)
+   {
+      output(timestamp, value);
+      m_selected = p;
+      m_hasSelected = true;
+      return;
+   }
+
+   int64_t bucket = bucketIndex(timestamp);
+   if (m_current->isEmpty())
+   {
+      m_currentBucket = bucket;
+      m_current->add(p);
+   }
+   else if (m_next->isEmpty() && (bucket == m_currentBucket))
+   {
+      m_current->add(p);
+   }
+   else if (m_next->isEmpty() || (bucket == m_nextBucket))
+   {
+      m_nextBucket = bucket;
+      m_next->add(p);
+   }
+   else
+   {
+      double cx = 0, cy = 0;
+      for(int i = 0; i < m_next->size(); i++)
+      {
+         DownsamplingPoint *n = m_next->get(i);
+         cx += static_cast<double>(n->timestamp - m_timeFrom);
+         cy += n->value;
+      }
+      selectPoint(m_current, cx / m_next->size(), cy / m_next->size());
+
+      StructArray<DownsamplingPoint> *tmp = m_current;
+      m_current = m_next;
+      m_currentBucket = m_nextBucket;
+      m_next = tmp;
+      m_next->clear();
+      m_nextBucket = bucket;
+      m_next->add(p);
+   }
+}
+
+/**
+ * Complete LTTB downsampling. Last point is always selected.
+ */
+void DCIDataDownsampler::finishLTTB()
+{
+   StructArray<DownsamplingPoint> *lastBucket = m_next->isEmpty() ? m_current : m_next;
+   if (lastBucket->isEmpty())
+      return;
+
+   DownsamplingPoint last = *lastBucket->get(lastBucket->size() - 1);
+   lastBucket->remove(lastBucket->size() - 1);
+
+   if (lastBucket == m_next)
+   {
+      double cx = 0, cy = 0;
+      int count = m_next->size();
+      for(int i = 0; i < count; i++)
+      {
+         DownsamplingPoint *n = m_next->get(i);
+         cx += static_cast<double>(n->timestamp - m_timeFrom);
+         cy += n->value;
+      }
+      if (count > 0)
+         selectPoint(m_current, cx / count, cy / count);
+      else
+         selectPoint(m_current, static_cast<double>(last.timestamp - m_timeFrom), last.value);
+      if (count > 0)
+         selectPoint(m_next, static_cast<double>(last.timestamp - m_timeFrom), last.value);
+   }
+   else if (!m_current->isEmpty())
+   {
+      selectPoint(m_current, static_cast<double>(last.timestamp - m_timeFrom), last.value);
+   }
+   output(last.timestamp, last.value);
+}
+
+/**
+ * Complete downsampling and send remaining points
+ */
+void DCIDataDownsampler::finish()
+{
+   if (m_method == DCI_DOWNSAMPLING_LTTB)
+      finishLTTB();
+   else if (m_count > 0)
+      flushBucket();
+}
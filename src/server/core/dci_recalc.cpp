@@ -59,6 +59,11 @@ ServerJobResult DCIRecalculationJob::run()
          _sntprintf(query, 256, _T("SELECT date_part('epoch',idata_timestamp)::int,raw_value FROM idata_sc_%s WHERE node_id=%d AND item_id=%d ORDER BY idata_timestamp"),
                   DCObject::getStorageClassName(m_dci->getStorageClass()), m_object->getId(), m_dci->getId());
       }
+      else if (g_flags & AF_PARTITIONED_PERF_DATA)
+      {
+         _sntprintf(query, 256, _T("SELECT idata_timestamp,raw_value FROM idata_sc_%s WHERE node_id=%d AND item_id=%d ORDER BY idata_timestamp"),
+                  DCObject::getStorageClassName(m_dci->getStorageClass()), m_object->getId(), m_dci->getId());
+      }
       else
       {
          _sntprintf(query, 256, _T("SELECT idata_timestamp,raw_value FROM idata WHERE node_id=%d AND item_id=%d ORDER BY idata_timestamp"),
@@ -91,6 +96,13 @@ ServerJobResult DCIRecalculationJob::run()
                      DCObject::getStorageClassName(m_dci->getStorageClass()));
             hStmt = DBPrepare(hdb, query);
          }
+         else if (g_flags & AF_PARTITIONED_PERF_DATA)
+         {
+            TCHAR query[256];
+            _sntprintf(query, 256, _T("UPDATE idata_sc_%s SET idata_value=? WHERE node_id=? AND item_id=? AND idata_timestamp=?"),
+                     DCObject::getStorageClassName(m_dci->getStorageClass()));
+            hStmt = DBPrepare(hdb, query);
+         }
          else
          {
             hStmt = DBPrepare(hdb, _T("UPDATE idata SET idata_value=? WHERE node_id=? AND item_id=? AND idata_timestamp=?"));
@@ -0,0 +1,690 @@
+/*
+** NetXMS - Network Management System
+** Copyright (C) 2003-2021 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: dci_snapshot.cpp
+**
+**/
+
+#include "nxcore.h"
+#include <nxstat.h>
+
+#if !defined(_WIN32) && HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
+#define DEBUG_TAG _T("obj.dc.cache")
+
+/*
+ * Snapshot file layout (all numbers in network byte order):
+ *
+ *    header (40 bytes):
+ *       signature         char[8]
+ *       format version    uint32
+ *       record count      uint32
+ *       server ID         uint64
+ *       creation time     int64
+ *       index offset      uint64
+ *    records:
+ *       DCI ID            uint32
+ *       owner ID          uint32
+ *       config hash       uint32
+ *       data type         byte
+ *       reserved          byte
+ *       value count       uint16
+ *       values (newest first):
+ *          timestamp      int64
+ *          value type     byte
+ *          value          none, int64, or string (as written by ByteStream::writeString)
+ *    index (sorted by DCI ID):
+ *       DCI ID            uint32
+ *       record offset     uint64
+ */
+
+/**
+ * Snapshot file signature
+ */
+static const char s_signature[8] = { 'N', 'X', 'D', 'C', 'I', 'C', 'S', 'F' };
+
+/**
+ * Snapshot file format version
+ */
+#define SNAPSHOT_FORMAT_VERSION  1
+
+/**
+ * Header and index entry sizes
+ */
+#define HEADER_SIZE        40
+#define INDEX_ENTRY_SIZE   12
+
+/**
+ * Encoded value types
+ */
+#define VALUE_EMPTY     0
+#define VALUE_INTEGER   1
+#define VALUE_STRING    2
+
+/**
+ * Index entry
+ */
+struct SnapshotIndexEntry
+{
+   uint32_t dciId;
+   uint64_t offset;
+};
+
+/**
+ * Compare index entries by DCI ID
+ */
+static int CompareIndexEntries(const void *e1, const void *e2)
+{
+   uint32_t id1 = static_cast<const SnapshotIndexEntry*>(e1)->dciId;
+   uint32_t id2 = static_cast<const SnapshotIndexEntry*>(e2)->dciId;
+   return (id1 < id2) ? -1 : ((id1 > id2) ? 1 : 0);
+}
+
+/**
+ * DCI cache snapshot writer
+ */
+class DCICacheSnapshotWriter
+{
+private:
+   FILE *m_file;
+   ByteStream m_buffer;
+   uint64_t m_offset;
+   StructArray<SnapshotIndexEntry> m_index;
+   bool m_failed;
+
+   void flush();
+
+public:
+   DCICacheSnapshotWriter(FILE *file) : m_buffer(65536), m_index(0, 65536)
+   {
+      m_file = file;
+      m_offset = HEADER_SIZE;
+      m_failed = false;
+      m_buffer.setAllocationStep(65536);
+   }
+
+   void addRecord(uint32_t dciId, uint32_t ownerId, int dataType, uint32_t configHash, ItemValue * const *values, uint32_t count);
+   bool finish();
+
+   int getRecordCount() const { return m_index.size(); }
+};
+
+/**
+ * Flush buffered records to file
+ */
+void DCICacheSnapshotWriter::flush()
+{
+   size_t size;
+   const BYTE *data = m_buffer.buffer(&size);
+   if ((size > 0) && !m_failed && (fwrite(data, 1, size, m_file) != size))
+      m_failed = true;
+   m_offset += size;
+   m_buffer.clear();
+}
+
+/**
+ * Check if string value can be stored as integer without loss (string must be exact decimal representation of integer)
+ */
+static bool IsCanonicalInteger(const TCHAR *s, int64_t *value)
+{
+   if ((*s == 0) || (_tcslen(s) > 20))
+      return false;
+
+   TCHAR *eptr;
+   *value = _tcstoll(s, &eptr, 10);
+   if (*eptr != 0)
+      return false;
+
+   TCHAR buffer[32];
+   _sntprintf(buffer, 32, INT64_FMT, *value);
+   return _tcscmp(buffer, s) == 0;
+}
+
+/**
+ * Add record for DCI
+ */
+void DCICacheSnapshotWriter::addRecord(uint32_t dciId, uint32_t ownerId, int dataType, uint32_t configHash, ItemValue * const *values, uint32_t count)
+{
+   if (count > 0xFFFF)
+      return;
+
+   SnapshotIndexEntry *e = m_index.addPlaceholder();
+   e->dciId = dciId;
+   e->offset = m_offset + m_buffer.size();
+
+   m_buffer.write(dciId);
+   m_buffer.write(ownerId);
+   m_buffer.write(configHash);
+   m_buffer.write(static_cast<BYTE>(dataType));
+   m_buffer.write(static_cast<BYTE>(0));
+   m_buffer.write(static_cast<uint16_t>(count));
+   for(uint32_t i = 0; i < count; i++)
+   {
+      m_buffer.write(static_cast<int64_t>(values[i]->getTimeStamp()));
+      const TCHAR *s = values[i]->getString();
+      int64_t n;
+      if (*s == 0)
+      {
+         m_buffer.write(static_cast<BYTE>(VALUE_EMPTY));
+      }
+      else if (IsCanonicalInteger(s, &n))
+      {
+         m_buffer.write(static_cast<BYTE>(VALUE_INTEGER));
+         m_buffer.write(n);
+      }
+      else
+      {
+         m_buffer.write(static_cast<BYTE>(VALUE_STRING));
+         m_buffer.writeString(s);
+      }
+   }
+
+   if (m_buffer.size() >= 1048576)
+      flush();
+}
+
+/**
+ * Write index and header. Returns true on success.
+ */
+bool DCICacheSnapshotWriter::finish()
+{
+   flush();
+
+   uint64_t indexOffset = m_offset;
+   m_index.sort(CompareIndexEntries);
+   for(int i = 0; i < m_index.size(); i++)
+   {
+      SnapshotIndexEntry *e = m_index.get(i);
+      m_buffer.write(e->dciId);
+      m_buffer.write(e->offset);
+      if (m_buffer.size() >= 1048576)
+         flush();
+   }
+   flush();
+
+   m_buffer.write(s_signature, 8);
+   m_buffer.write(static_cast<uint32_t>(SNAPSHOT_FORMAT_VERSION));
+   m_buffer.write(static_cast<uint32_t>(m_index.size()));
+   m_buffer.write(g_serverId);
+   m_buffer.write(static_cast<int64_t>(time(nullptr)));
+   m_buffer.write(indexOffset);
+   if (fseek(m_file, 0, SEEK_SET) != 0)
+      m_failed = true;
+   flush();
+
+   return !m_failed;
+}
+
+/**
+ * Add record to snapshot (called by DCItem::writeCacheSnapshot)
+ */
+void WriteDCICacheSnapshotRecord(DCICacheSnapshotWriter *writer, uint32_t dciId, uint32_t ownerId, int dataType, uint32_t configHash,
+         ItemValue * const *values, uint32_t count)
+{
+   writer->addRecord(dciId, ownerId, dataType, configHash, values, count);
+}
+
+/**
+ * Get snapshot file name
+ */
+static void GetSnapshotFileName(TCHAR *fileName)
+{
+   _tcslcpy(fileName, g_netxmsdDataDir, MAX_PATH);
+   _tcslcat(fileName, DFILE_DCI_CACHE, MAX_PATH);
+}
+
+/**
+ * Callback for writing DCI caches of data collection target
+ */
+static void WriteTargetCaches(NetObj *object, void *writer)
+{
+   static_cast<DataCollectionTarget*>(object)->writeDciCacheSnapshot(static_cast<DCICacheSnapshotWriter*>(writer));
+}
+
+/**
+ * Save DCI cache snapshot. Snapshot is written to temporary file first and then renamed.
+ */
+bool SaveDCICacheSnapshot()
+{
+   TCHAR fileName[MAX_PATH], tempFileName[MAX_PATH];
+   GetSnapshotFileName(fileName);
+   _sntprintf(tempFileName, MAX_PATH, _T("%s.tmp"), fileName);
+
+   FILE *file = _tfopen(tempFileName, _T("wb"));
+   if (file == nullptr)
+   {
+      nxlog_write_tag(NXLOG_WARNING, DEBUG_TAG, _T("Cannot create DCI cache snapshot file %s (%s)"), tempFileName, _tcserror(errno));
+      return false;
+   }
+
+   int64_t startTime = GetCurrentTimeMs();
+
+   // Reserve space for header
+   BYTE header[HEADER_SIZE];
+   memset(header, 0, HEADER_SIZE);
+   bool success = (fwrite(header, 1, HEADER_SIZE, file) == HEADER_SIZE);
+
+   DCICacheSnapshotWriter writer(file);
+   if (success)
+   {
+      g_idxNodeById.forEach(WriteTargetCaches, &writer);
+      g_idxClusterById.forEach(WriteTargetCaches, &writer);
+      g_idxMobileDeviceById.forEach(WriteTargetCaches, &writer);
+      g_idxAccessPointById.forEach(WriteTargetCaches, &writer);
+      g_idxChassisById.forEach(WriteTargetCaches, &writer);
+      g_idxSensorById.forEach(WriteTargetCaches, &writer);
+      success = writer.finish();
+   }
+   if (fclose(file) != 0)
+      success = false;
+
+   if (!success)
+   {
+      nxlog_write_tag(NXLOG_WARNING, DEBUG_TAG, _T("Error writing DCI cache snapshot file %s"), tempFileName);
+      _tremove(tempFileName);
+      return false;
+   }
+
+#ifdef _WIN32
+   _tremove(fileName);
+#endif
+   if (_trename(tempFileName, fileName) != 0)
+   {
+      nxlog_write_tag(NXLOG_WARNING, DEBUG_TAG, _T("Cannot rename DCI cache snapshot file %s to %s (%s)"), tempFileName, fileName, _tcserror(errno));
+      _tremove(tempFileName);
+      return false;
+   }
+
+   nxlog_debug_tag(DEBUG_TAG, 3, _T("DCI cache snapshot saved (%d records in ") INT64_FMT _T(" ms)"),
+            writer.getRecordCount(), GetCurrentTimeMs() - startTime);
+   return true;
+}
+
+/**
+ * Currently open snapshot
+ */
+static RWLock s_snapshotLock;
+static const BYTE *s_snapshotData = nullptr;
+static size_t s_snapshotSize = 0;
+static uint32_t s_recordCount = 0;
+static uint64_t s_indexOffset = 0;
+#ifdef _WIN32
+static HANDLE s_hSnapshotFile = INVALID_HANDLE_VALUE;
+static HANDLE s_hSnapshotMapping = nullptr;
+#endif
+static VolatileCounter s_restoredCount = 0;
+static VolatileCounter s_rejectedCount = 0;
+
+/**
+ * Read 16 bit integer from snapshot
+ */
+static inline uint16_t ReadUInt16(const BYTE *p)
+{
+   uint16_t v;
+   memcpy(&v, p, 2);
+   return ntohs(v);
+}
+
+/**
+ * Read 32 bit integer from snapshot
+ */
+static inline uint32_t ReadUInt32(const BYTE *p)
+{
+   uint32_t v;
+   memcpy(&v, p, 4);
+   return ntohl(v);
+}
+
+/**
+ * Read 64 bit integer from snapshot
+ */
+static inline uint64_t ReadUInt64(const BYTE *p)
+{
+   uint64_t v;
+   memcpy(&v, p, 8);
+   return ntohq(v);
+}
+
+/**
+ * Map snapshot file into memory
+ */
+static const BYTE *MapSnapshotFile(const TCHAR *fileName, size_t *size)
+{
+#ifdef _WIN32
+   s_hSnapshotFile = CreateFile(fileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (s_hSnapshotFile == INVALID_HANDLE_VALUE)
+      return nullptr;
+
+   LARGE_INTEGER fileSize;
+   if (!GetFileSizeEx(s_hSnapshotFile, &fileSize) || (fileSize.QuadPart == 0) ||
+       ((s_hSnapshotMapping = CreateFileMapping(s_hSnapshotFile, nullptr, PAGE_READONLY, 0, 0, nullptr)) == nullptr))
+   {
+      CloseHandle(s_hSnapshotFile);
+      s_hSnapshotFile = INVALID_HANDLE_VALUE;
+      return nullptr;
+   }
+
+   const BYTE *data = static_cast<const BYTE*>(MapViewOfFile(s_hSnapshotMapping, FILE_MAP_READ, 0, 0, 0));
+   if (data == nullptr)
+   {
+      CloseHandle(s_hSnapshotMapping);
+      s_hSnapshotMapping = nullptr;
+      CloseHandle(s_hSnapshotFile);
+      s_hSnapshotFile = INVALID_HANDLE_VALUE;
+      return nullptr;
+   }
+   *size = static_cast<size_t>(fileSize.QuadPart);
+   return data;
+#elif HAVE_MMAP
+   int fd = _topen(fileName, O_RDONLY);
+   if (fd == -1)
+      return nullptr;
+
+   NX_STAT_STRUCT st;
+   if ((NX_FSTAT(fd, &st) != 0) || (st.st_size == 0))
+   {
+      _close(fd);
+      return nullptr;
+   }
+
+   void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   _close(fd);
+   if (data == MAP_FAILED)
+      return nullptr;
+
+   *size = st.st_size;
+   return static_cast<const BYTE*>(data);
+#else
+   return LoadFile(fileName, size);
+#endif
+}
+
+/**
+ * Unmap snapshot file
+ */
+static void UnmapSnapshotFile(const BYTE *data, size_t size)
+{
+#ifdef _WIN32
+   UnmapViewOfFile(data);
+   CloseHandle(s_hSnapshotMapping);
+   s_hSnapshotMapping = nullptr;
+   CloseHandle(s_hSnapshotFile);
+   s_hSnapshotFile = INVALID_HANDLE_VALUE;
+#elif HAVE_MMAP
+   munmap(const_cast<BYTE*>(data), size);
+#else
+   MemFree(const_cast<BYTE*>(data));
+#endif
+}
+
+/**
+ * Open DCI cache snapshot for restoring DCI caches. Snapshot is rejected if it is
+ * corrupted or created by different server instance.
+ */
+void OpenDCICacheSnapshot()
+{
+   if (!ConfigReadBoolean(_T("DataCollection.CacheSnapshot.Enable"), true))
+      return;
+
+   TCHAR fileName[MAX_PATH];
+   GetSnapshotFileName(fileName);
+
+   size_t size;
+   const BYTE *data = MapSnapshotFile(fileName, &size);
+   if (data == nullptr)
+   {
+      nxlog_debug_tag(DEBUG_TAG, 2, _T("DCI cache snapshot file %s is not available"), fileName);
+      return;
+   }
+
+   const TCHAR *error = nullptr;
+   uint32_t recordCount = 0;
+   uint64_t indexOffset = 0;
+   if ((size < HEADER_SIZE) || memcmp(data, s_signature, 8))
+   {
+      error = _T("invalid file signature");
+   }
+   else if (ReadUInt32(data + 8) != SNAPSHOT_FORMAT_VERSION)
+   {
+      error = _T("unsupported format version");
+   }
+   else if (ReadUInt64(data + 16) != g_serverId)
+   {
+      error = _T("server ID mismatch");
+   }
+   else
+   {
+      recordCount = ReadUInt32(data + 12);
+      indexOffset = ReadUInt64(data + 32);
+      if ((indexOffset < HEADER_SIZE) || (indexOffset > size) || ((size - indexOffset) / INDEX_ENTRY_SIZE < recordCount))
+         error = _T("index is corrupted");
+   }
+
+   if (error != nullptr)
+   {
+      nxlog_write_tag(NXLOG_WARNING, DEBUG_TAG, _T("DCI cache snapshot file %s rejected (%s)"), fileName, error);
+      UnmapSnapshotFile(data, size);
+      return;
+   }
+
+   s_snapshotLock.writeLock();
+   s_snapshotData = data;
+   s_snapshotSize = size;
+   s_recordCount = recordCount;
+   s_indexOffset = indexOffset;
+   s_snapshotLock.unlock();
+
+   TCHAR timeText[64];
+   nxlog_write_tag(NXLOG_INFO, DEBUG_TAG, _T("Using DCI cache snapshot created at %s (%u records)"),
+            FormatTimestamp(static_cast<time_t>(ReadUInt64(data + 24)), timeText), recordCount);
+}
+
+/**
+ * Close DCI cache snapshot
+ */
+void CloseDCICacheSnapshot()
+{
+   s_snapshotLock.writeLock();
+   if (s_snapshotData != nullptr)
+   {
+      UnmapSnapshotFile(s_snapshotData, s_snapshotSize);
+      s_snapshotData = nullptr;
+      s_snapshotSize = 0;
+      s_recordCount = 0;
+      nxlog_write_tag(NXLOG_INFO, DEBUG_TAG, _T("DCI cache snapshot closed (%d caches restored, %d rejected as missing or stale)"),
+               static_cast<int>(s_restoredCount), static_cast<int>(s_rejectedCount));
+   }
+   s_snapshotLock.unlock();
+}
+
+/**
+ * Find record for given DCI in snapshot index. Snapshot lock must be held by caller.
+ */
+static const BYTE *FindRecord(uint32_t dciId)
+{
+   const BYTE *index = s_snapshotData + s_indexOffset;
+   uint32_t l = 0, r = s_recordCount;
+   while(l < r)
+   {
+      uint32_t m = l + (r - l) / 2;
+      uint32_t id = ReadUInt32(index + m * INDEX_ENTRY_SIZE);
+      if (id == dciId)
+      {
+         uint64_t offset = ReadUInt64(index + m * INDEX_ENTRY_SIZE + 4);
+         return ((offset >= HEADER_SIZE) && (offset + 16 <= s_indexOffset)) ? s_snapshotData + offset : nullptr;
+      }
+      if (id < dciId)
+         l = m + 1;
+      else
+         r = m;
+   }
+   return nullptr;
+}
+
+/**
+ * Decode values from snapshot record. Returns false if record is corrupted.
+ */
+static bool DecodeValues(const BYTE *curr, const BYTE *end, ItemValue **values, uint32_t count)
+{
+   for(uint32_t i = 0; i < count; i++)
+   {
+      if (end - curr < 9)
+         return false;
+
+      time_t timestamp = static_cast<time_t>(ReadUInt64(curr));
+      BYTE type = curr[8];
+      curr += 9;
+
+      TCHAR buffer[MAX_DB_STRING];
+      switch(type)
+      {
+         case VALUE_EMPTY:
+            buffer[0] = 0;
+            break;
+         case VALUE_INTEGER:
+            if (end - curr < 8)
+               return false;
+            _sntprintf(buffer, MAX_DB_STRING, INT64_FMT, static_cast<int64_t>(ReadUInt64(curr)));
+            curr += 8;
+            break;
+         case VALUE_STRING:
+            {
+               if (end - curr < 2)
+                  return false;
+               size_t len;
+               if (*curr & 0x80)
+               {
+                  if (end - curr < 4)
+                     return false;
+                  len = ReadUInt32(curr) & ~0x80000000;
+                  curr += 4;
+               }
+               else
+               {
+                  len = ReadUInt16(curr);
+                  curr += 2;
+               }
+               if (static_cast<size_t>(end - curr) < len)
+                  return false;
+               size_t chars = utf8_to_tchar(reinterpret_cast<const char*>(curr), len, buffer, MAX_DB_STRING - 1);
+               buffer[chars] = 0;
+               curr += len;
+            }
+            break;
+         default:
+            return false;
+      }
+
+      values[i] = new ItemValue(buffer, timestamp);
+   }
+   return true;
+}
+
+/**
+ * Restore DCI cache from snapshot. Record is accepted only if it matches current DCI configuration,
+ * contains enough values, and is not older than last collected value.
+ */
+bool RestoreDCICacheFromSnapshot(uint32_t dciId, uint32_t ownerId, int dataType, uint32_t configHash, time_t lastValueTimestamp,
+         ItemValue **values, uint32_t count)
+{
+   s_snapshotLock.readLock();
+   if (s_snapshotData == nullptr)
+   {
+      s_snapshotLock.unlock();
+      return false;
+   }
+
+   bool success = false;
+   const BYTE *record = FindRecord(dciId);
+   if ((record != nullptr) &&
+       (ReadUInt32(record + 4) == ownerId) &&
+       (ReadUInt32(record + 8) == configHash) &&
+       (record[12] == static_cast<BYTE>(dataType)) &&
+       (ReadUInt16(record + 14) >= count) &&
+       (static_cast<time_t>(ReadUInt64(record + 16)) >= lastValueTimestamp))
+   {
+      success = DecodeValues(record + 16, s_snapshotData + s_indexOffset, values, count);
+      if (!success)
+      {
+         for(uint32_t i = 0; i < count; i++)
+         {
+            delete values[i];
+            values[i] = nullptr;
+         }
+         nxlog_debug_tag(DEBUG_TAG, 4, _T("RestoreDCICacheFromSnapshot: record for DCI [%u] is corrupted"), dciId);
+      }
+   }
+   s_snapshotLock.unlock();
+
+   InterlockedIncrement(success ? &s_restoredCount : &s_rejectedCount);
+   return success;
+}
+
+/**
+ * Snapshot writer thread
+ */
+static THREAD s_writerThread = INVALID_THREAD_HANDLE;
+static bool s_writerEnabled = false;
+
+/**
+ * Periodic snapshot writer
+ */
+static void SnapshotWriterThread(uint32_t interval)
+{
+   ThreadSetName("DCICacheSnap");
+   nxlog_debug_tag(DEBUG_TAG, 2, _T("DCI cache snapshot writer thread started (interval %u seconds)"), interval);
+   while(!SleepAndCheckForShutdown(interval))
+   {
+      SaveDCICacheSnapshot();
+   }
+   nxlog_debug_tag(DEBUG_TAG, 2, _T("DCI cache snapshot writer thread stopped"));
+}
+
+/**
+ * Start periodic DCI cache snapshot writer
+ */
+void StartDCICacheSnapshotWriter()
+{
+   s_writerEnabled = ConfigReadBoolean(_T("DataCollection.CacheSnapshot.Enable"), true);
+   if (!s_writerEnabled)
+   {
+      nxlog_debug_tag(DEBUG_TAG, 1, _T("DCI cache snapshot is disabled"));
+      return;
+   }
+
+   uint32_t interval = ConfigReadULong(_T("DataCollection.CacheSnapshot.Interval"), 900);
+   if (interval > 0)
+      s_writerThread = ThreadCreateEx(SnapshotWriterThread, interval);
+}
+
+/**
+ * Stop periodic DCI cache snapshot writer and write final snapshot. Should be called after data collection is stopped.
+ */
+void StopDCICacheSnapshotWriter()
+{
+   if (!s_writerEnabled)
+      return;
+
+   ThreadJoin(s_writerThread);
+   s_writerThread = INVALID_THREAD_HANDLE;
+   CloseDCICacheSnapshot();
+   if (SaveDCICacheSnapshot())
+      nxlog_debug_tag(DEBUG_TAG, 1, _T("DCI cache snapshot saved"));
+}
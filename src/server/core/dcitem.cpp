@@ -32,12 +32,13 @@ static const TCHAR *s_paramNamesRearm[] = { _T("dciName"), _T("dciDescription"),
 /**
  * Create DCItem from another DCItem
  */
-DCItem::DCItem(const DCItem *src, bool shadowCopy) : DCObject(src, shadowCopy)
+DCItem::DCItem(const DCItem *src, bool shadowCopy) : DCObject(src, shadowCopy), m_thresholdAggregates(src->m_thresholdAggregates)
 {
    m_dataType = src->m_dataType;
    m_deltaCalculation = src->m_deltaCalculation;
 	m_sampleCount = src->m_sampleCount;
-   m_cacheSize = shadowCopy ? src->m_cacheSize : 0;
+   m_cacheSize = 0;
+   setCacheSize(shadowCopy ? src->m_cacheSize : 0);
    m_requiredCacheSize = shadowCopy ? src->m_requiredCacheSize : 0;
    if (m_cacheSize > 0)
    {
@@ -49,6 +50,8 @@ DCItem::DCItem(const DCItem *src, bool shadowCopy) : DCObject(src, shadowCopy)
    {
       m_ppValueCache = nullptr;
    }
+   if (!shadowCopy)
+      m_thresholdAggregates.invalidate();
    m_tPrevValueTimeStamp = shadowCopy ? src->m_tPrevValueTimeStamp : 0;
    m_bCacheLoaded = shadowCopy ? src->m_bCacheLoaded : false;
 	m_nBaseUnits = src->m_nBaseUnits;
@@ -143,19 +146,15 @@ DCItem::DCItem(DB_HANDLE hdb, DB_RESULT hResult, int row, const shared_ptr<DataC
    m_startTime = (useStartupDelay && (effectivePollingInterval > 0)) ? time(nullptr) + rand() % (effectivePollingInterval / 2) : 0;
 
    // Load last raw value from database
-	TCHAR szQuery[256];
-   _sntprintf(szQuery, 256, _T("SELECT raw_value,last_poll_time FROM raw_dci_values WHERE item_id=%d"), m_id);
-   DB_RESULT hTempResult = DBSelect(hdb, szQuery);
-   if (hTempResult != nullptr)
+   ObjectDataRows rawValue(hdb, StartupDataSet::RAW_DCI_VALUES,
+            _T("SELECT raw_value,last_poll_time,item_id FROM raw_dci_values ORDER BY item_id"),
+            _T("SELECT raw_value,last_poll_time FROM raw_dci_values WHERE item_id=?"), m_id);
+   if (rawValue.isValid() && (rawValue.getRowCount() > 0))
    {
-      if (DBGetNumRows(hTempResult) > 0)
-      {
-		   TCHAR szBuffer[MAX_DB_STRING];
-         m_prevRawValue = DBGetField(hTempResult, 0, 0, szBuffer, MAX_DB_STRING);
-         m_tPrevValueTimeStamp = DBGetFieldULong(hTempResult, 0, 1);
-         m_lastPoll = m_tPrevValueTimeStamp;
-      }
-      DBFreeResult(hTempResult);
+      TCHAR szBuffer[MAX_DB_STRING];
+      m_prevRawValue = DBGetField(rawValue.getResult(), rawValue.getFirstRow(), 0, szBuffer, MAX_DB_STRING);
+      m_tPrevValueTimeStamp = DBGetFieldULong(rawValue.getResult(), rawValue.getFirstRow(), 1);
+      m_lastPoll = m_tPrevValueTimeStamp;
    }
 
    loadAccessList(hdb);
@@ -244,6 +243,17 @@ DCItem::~DCItem()
    clearCache();
 }
 
+/**
+ * Set number of values in cache and update memory accounting
+ */
+void DCItem::setCacheSize(uint32_t size)
+{
+   int64_t delta = static_cast<int64_t>(size) - static_cast<int64_t>(m_cacheSize);
+   if (delta != 0)
+      UpdateMemoryUsage(MemoryCategory::DCI_CACHE, delta * static_cast<int64_t>(sizeof(ItemValue) + sizeof(ItemValue*)), delta);
+   m_cacheSize = size;
+}
+
 /**
  * Delete all thresholds
  */
@@ -263,42 +273,37 @@ void DCItem::clearCache()
       delete m_ppValueCache[i];
    MemFree(m_ppValueCache);
    m_ppValueCache = nullptr;
-   m_cacheSize = 0;
+   setCacheSize(0);
+   m_thresholdAggregates.invalidate();
 }
 
+/**
+ * Columns loaded from thresholds table
+ */
+#define DCI_THRESHOLD_COLUMNS \
+         _T("threshold_id,fire_value,rearm_value,check_function,") \
+         _T("check_operation,sample_count,script,event_code,current_state,") \
+         _T("rearm_event_code,repeat_interval,current_severity,") \
+         _T("last_event_timestamp,match_count,state_before_maint,last_checked_value")
+
 /**
  * Load data collection items thresholds from database
  */
 bool DCItem::loadThresholdsFromDB(DB_HANDLE hdb)
 {
-   bool result = false;
-
-	DB_STATEMENT hStmt = DBPrepare(hdb,
-	           _T("SELECT threshold_id,fire_value,rearm_value,check_function,")
-              _T("check_operation,sample_count,script,event_code,current_state,")
-              _T("rearm_event_code,repeat_interval,current_severity,")
-				  _T("last_event_timestamp,match_count,state_before_maint,")
-				  _T("last_checked_value FROM thresholds WHERE item_id=? ")
-              _T("ORDER BY sequence_number"));
-	if (hStmt != nullptr)
-	{
-		DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-		DB_RESULT hResult = DBSelectPrepared(hStmt);
-		if (hResult != nullptr)
-		{
-			int count = DBGetNumRows(hResult);
-			if (count > 0)
-			{
-				m_thresholds = new ObjectArray<Threshold>(count, 8, Ownership::True);
-				for(int i = 0; i < count; i++)
-					m_thresholds->add(new Threshold(hResult, i, this));
-			}
-			DBFreeResult(hResult);
-			result = true;
-		}
-		DBFreeStatement(hStmt);
-	}
-   return result;
+   ObjectDataRows thresholds(hdb, StartupDataSet::DCI_THRESHOLDS,
+            _T("SELECT ") DCI_THRESHOLD_COLUMNS _T(",item_id FROM thresholds ORDER BY item_id,sequence_number"),
+            _T("SELECT ") DCI_THRESHOLD_COLUMNS _T(" FROM thresholds WHERE item_id=? ORDER BY sequence_number"), m_id);
+   if (!thresholds.isValid())
+      return false;
+
+   if (thresholds.getRowCount() > 0)
+   {
+      m_thresholds = new ObjectArray<Threshold>(thresholds.getRowCount(), 8, Ownership::True);
+      for(int i = thresholds.getFirstRow(); i < thresholds.getEndRow(); i++)
+         m_thresholds->add(new Threshold(thresholds.getResult(), i, this));
+   }
+   return true;
 }
 
 /**
@@ -432,12 +437,16 @@ void DCItem::checkThresholds(ItemValue &value)
 
 	auto owner = m_owner.lock();
 
+	if (!m_thresholdAggregates.isValid(m_dataType, m_cacheSize))
+	   m_thresholdAggregates.rebuild(m_thresholds, m_ppValueCache, m_cacheSize, m_dataType);
+	m_thresholdAggregates.startCheck();
+
 	bool thresholdDeactivated = false;
    for(int i = 0; i < m_thresholds->size(); i++)
    {
 		Threshold *t = m_thresholds->get(i);
       ItemValue checkValue, thresholdValue;
-      ThresholdCheckResult result = t->check(value, m_ppValueCache, checkValue, thresholdValue, owner, this);
+      ThresholdCheckResult result = t->check(value, m_ppValueCache, checkValue, thresholdValue, owner, this, &m_thresholdAggregates);
       t->setLastCheckedValue(checkValue);
       switch(result)
       {
@@ -540,10 +549,14 @@ void DCItem::deleteFromDatabase()
    QueueSQLRequest(szQuery);
    _sntprintf(szQuery, sizeof(szQuery) / sizeof(TCHAR), _T("DELETE FROM thresholds WHERE item_id=%d"), m_id);
    QueueSQLRequest(szQuery);
+   _sntprintf(szQuery, sizeof(szQuery) / sizeof(TCHAR), _T("DELETE FROM dci_rollup_hourly WHERE item_id=%d"), m_id);
+   QueueSQLRequest(szQuery);
+   _sntprintf(szQuery, sizeof(szQuery) / sizeof(TCHAR), _T("DELETE FROM dci_rollup_daily WHERE item_id=%d"), m_id);
+   QueueSQLRequest(szQuery);
    QueueRawDciDataDelete(m_id);
 
    auto owner = m_owner.lock();
-   if ((owner != nullptr) && owner->isDataCollectionTarget() && g_dbSyntax != DB_SYNTAX_TSDB)
+   if ((owner != nullptr) && owner->isDataCollectionTarget() && (g_dbSyntax != DB_SYNTAX_TSDB) && !(g_flags & AF_PARTITIONED_PERF_DATA))
       static_cast<DataCollectionTarget*>(owner.get())->scheduleItemDataCleanup(m_id);
 }
 
@@ -755,6 +768,7 @@ bool DCItem::processNewValue(time_t tmTimeStamp, const TCHAR *originalValue, boo
 
    if ((m_cacheSize > 0) && (tmTimeStamp >= m_tPrevValueTimeStamp))
    {
+      m_thresholdAggregates.shift(m_ppValueCache, m_cacheSize, pValue);
       delete m_ppValueCache[m_cacheSize - 1];
       memmove(&m_ppValueCache[1], m_ppValueCache, sizeof(ItemValue *) * (m_cacheSize - 1));
       m_ppValueCache[0] = pValue;
@@ -769,11 +783,12 @@ bool DCItem::processNewValue(time_t tmTimeStamp, const TCHAR *originalValue, boo
       if (m_cacheSize != m_requiredCacheSize)
       {
          m_ppValueCache = MemReallocArray(m_ppValueCache, m_requiredCacheSize);
-         m_cacheSize = m_requiredCacheSize;
+         setCacheSize(m_requiredCacheSize);
       }
 
       m_ppValueCache[0] = pValue;
       m_bCacheLoaded = true;
+      m_thresholdAggregates.invalidate();
    }
    else
    {
@@ -793,6 +808,8 @@ void DCItem::processNewError(bool noInstance, time_t now)
    lock();
 
    m_dwErrorCount++;
+   if (m_dwErrorCount == 1)
+      NotifyClientsOnLastValueChange(m_ownerId, m_id);
 
 	for(int i = 0; i < getThresholdCount(); i++)
    {
@@ -996,7 +1013,10 @@ bool DCItem::transform(ItemValue &value, time_t nElapsedTime)
 
          // remove lock from DCI for script execution to avoid deadlocks
          unlock();
-         success = vm->run(1, &nxslValue);
+         {
+            PerfScopedTimer perfTimer(PerfHotPath::SCRIPT_EXECUTION, m_ownerId);
+            success = vm->run(1, &nxslValue);
+         }
          lock();
          if (success)
          {
@@ -1104,6 +1124,9 @@ void DCItem::changeBinding(UINT32 newId, shared_ptr<DataCollectionOwner> newOwne
  */
 void DCItem::updateCacheSizeInternal(bool allowLoad, uint32_t conditionId)
 {
+   // Thresholds may have been changed
+   m_thresholdAggregates.invalidate();
+
    auto owner = m_owner.lock();
 
    // Sanity check
@@ -1155,7 +1178,7 @@ void DCItem::updateCacheSizeInternal(bool allowLoad, uint32_t conditionId)
             delete m_ppValueCache[i];
 		}
 
-      m_cacheSize = m_requiredCacheSize;
+      setCacheSize(m_requiredCacheSize);
       if (m_cacheSize > 0)
       {
          m_ppValueCache = MemReallocArray(m_ppValueCache, m_cacheSize);
@@ -1168,10 +1191,15 @@ void DCItem::updateCacheSizeInternal(bool allowLoad, uint32_t conditionId)
    }
    else if (m_requiredCacheSize > m_cacheSize)
    {
-      // Load missing values from database
+      // Try DCI cache snapshot first, then load missing values from database
       // Skip caching for DCIs where estimated time to fill the cache is less then 5 minutes
       // to reduce load on database at server startup
-      if (allowLoad &&
+      if ((m_cacheSize == 0) && (m_ownerId != 0) && restoreCacheFromSnapshot())
+      {
+         nxlog_debug_tag(_T("obj.dc.cache"), 7, _T("DCItem::updateCacheSizeInternal(dci=\"%s\", node=%s [%d]): cache restored from snapshot"),
+                  m_name.cstr(), owner->getName(), owner->getId());
+      }
+      else if (allowLoad &&
           (m_ownerId != 0) &&
           (((m_requiredCacheSize - m_cacheSize) * getEffectivePollingInterval() > 300) ||
            (m_source == DS_PUSH_AGENT) ||
@@ -1187,7 +1215,7 @@ void DCItem::updateCacheSizeInternal(bool allowLoad, uint32_t conditionId)
          for(UINT32 i = m_cacheSize; i < m_requiredCacheSize; i++)
             m_ppValueCache[i] = new ItemValue(_T(""), 1);
          DbgPrintf(7, _T("Cache load skipped for parameter %s [%u]"), m_name.cstr(), m_id);
-         m_cacheSize = m_requiredCacheSize;
+         setCacheSize(m_requiredCacheSize);
          m_bCacheLoaded = true;
       }
    }
@@ -1206,15 +1234,22 @@ void DCItem::reloadCache(bool forceReload)
    }
    unlock();
 
+   // With partitioned tables read directly from storage class table instead of union view
+   TCHAR table[64];
+   if (g_flags & AF_PARTITIONED_PERF_DATA)
+      _sntprintf(table, 64, _T("idata_sc_%s"), getStorageClassName(getStorageClass()));
+   else
+      _tcscpy(table, _T("idata"));
+
    TCHAR szBuffer[MAX_DB_STRING];
    switch(g_dbSyntax)
    {
       case DB_SYNTAX_MSSQL:
          if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
          {
-            _sntprintf(szBuffer, MAX_DB_STRING, _T("SELECT TOP %d idata_value,idata_timestamp FROM idata ")
+            _sntprintf(szBuffer, MAX_DB_STRING, _T("SELECT TOP %d idata_value,idata_timestamp FROM %s ")
                               _T("WHERE item_id=%d ORDER BY idata_timestamp DESC"),
-                    m_requiredCacheSize, m_id);
+                    m_requiredCacheSize, table, m_id);
          }
          else
          {
@@ -1226,9 +1261,9 @@ void DCItem::reloadCache(bool forceReload)
       case DB_SYNTAX_ORACLE:
          if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
          {
-            _sntprintf(szBuffer, MAX_DB_STRING, _T("SELECT * FROM (SELECT idata_value,idata_timestamp FROM idata ")
+            _sntprintf(szBuffer, MAX_DB_STRING, _T("SELECT * FROM (SELECT idata_value,idata_timestamp FROM %s ")
                               _T("WHERE item_id=%d ORDER BY idata_timestamp DESC) WHERE ROWNUM <= %d"),
-                    m_id, m_requiredCacheSize);
+                    table, m_id, m_requiredCacheSize);
          }
          else
          {
@@ -1242,9 +1277,9 @@ void DCItem::reloadCache(bool forceReload)
       case DB_SYNTAX_SQLITE:
          if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
          {
-            _sntprintf(szBuffer, MAX_DB_STRING, _T("SELECT idata_value,idata_timestamp FROM idata ")
+            _sntprintf(szBuffer, MAX_DB_STRING, _T("SELECT idata_value,idata_timestamp FROM %s ")
                               _T("WHERE item_id=%u ORDER BY idata_timestamp DESC LIMIT %u"),
-                    m_id, m_requiredCacheSize);
+                    table, m_id, m_requiredCacheSize);
          }
          else
          {
@@ -1269,9 +1304,9 @@ void DCItem::reloadCache(bool forceReload)
       case DB_SYNTAX_DB2:
          if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
          {
-            _sntprintf(szBuffer, MAX_DB_STRING, _T("SELECT idata_value,idata_timestamp FROM idata ")
+            _sntprintf(szBuffer, MAX_DB_STRING, _T("SELECT idata_value,idata_timestamp FROM %s ")
                _T("WHERE item_id=%u ORDER BY idata_timestamp DESC FETCH FIRST %u ROWS ONLY"),
-               m_id, m_requiredCacheSize);
+               table, m_id, m_requiredCacheSize);
          }
          else
          {
@@ -1283,8 +1318,8 @@ void DCItem::reloadCache(bool forceReload)
       default:
          if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
          {
-            _sntprintf(szBuffer, MAX_DB_STRING, _T("SELECT idata_value,idata_timestamp FROM idata ")
-                              _T("WHERE item_id=%u ORDER BY idata_timestamp DESC"), m_id);
+            _sntprintf(szBuffer, MAX_DB_STRING, _T("SELECT idata_value,idata_timestamp FROM %s ")
+                              _T("WHERE item_id=%u ORDER BY idata_timestamp DESC"), table, m_id);
          }
          else
          {
@@ -1348,8 +1383,9 @@ void DCItem::reloadCache(bool forceReload)
             m_ppValueCache[i] = new ItemValue(_T(""), 1);
       }
 
-      m_cacheSize = m_requiredCacheSize;
+      setCacheSize(m_requiredCacheSize);
       m_bCacheLoaded = true;
+      m_thresholdAggregates.invalidate();
    }
    else if (hResult != nullptr)
    {
@@ -1360,6 +1396,50 @@ void DCItem::reloadCache(bool forceReload)
    DBConnectionPoolReleaseConnection(hdb);
 }
 
+/**
+ * Restore cache from DCI cache snapshot. Should be called when DCI is locked and cache is empty.
+ */
+bool DCItem::restoreCacheFromSnapshot()
+{
+   ItemValue **values = MemAllocArray<ItemValue*>(m_requiredCacheSize);
+   if (!RestoreDCICacheFromSnapshot(m_id, m_ownerId, m_dataType, getCacheConfigHash(), m_tPrevValueTimeStamp, values, m_requiredCacheSize))
+   {
+      MemFree(values);
+      return false;
+   }
+
+   MemFree(m_ppValueCache);
+   m_ppValueCache = values;
+   setCacheSize(m_requiredCacheSize);
+   m_bCacheLoaded = true;
+   m_thresholdAggregates.invalidate();
+   return true;
+}
+
+/**
+ * Get hash of DCI configuration elements affecting cached values. Cache snapshot
+ * record is considered stale if hash does not match.
+ */
+uint32_t DCItem::getCacheConfigHash() const
+{
+   BYTE data[2] = { m_dataType, m_deltaCalculation };
+   uint32_t hash = CalculateCRC32(data, 2, 0);
+   if (m_transformationScriptSource != nullptr)
+      hash = CalculateCRC32(reinterpret_cast<const BYTE*>(m_transformationScriptSource), _tcslen(m_transformationScriptSource) * sizeof(TCHAR), hash);
+   return hash;
+}
+
+/**
+ * Write cache content to DCI cache snapshot
+ */
+void DCItem::writeCacheSnapshot(DCICacheSnapshotWriter *writer)
+{
+   lock();
+   if (m_bCacheLoaded && (m_cacheSize > 0))
+      WriteDCICacheSnapshotRecord(writer, m_id, m_ownerId, m_dataType, getCacheConfigHash(), m_ppValueCache, m_cacheSize);
+   unlock();
+}
+
 /**
  * Get cache memory usage
  */
@@ -1577,22 +1657,29 @@ TCHAR *DCItem::getAggregateValue(AggregationFunction func, time_t periodStart, t
 
    if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
    {
+      // With partitioned tables read directly from storage class table instead of union view
+      TCHAR table[64];
+      if (g_flags & AF_PARTITIONED_PERF_DATA)
+         _sntprintf(table, 64, _T("idata_sc_%s"), getStorageClassName(getStorageClass()));
+      else
+         _tcscpy(table, _T("idata"));
+
       switch(g_dbSyntax)
       {
          case DB_SYNTAX_ORACLE:
             _sntprintf(query, 1024,
-                  _T("SELECT %s(coalesce(to_number(idata_value),0)) FROM idata WHERE item_id=? AND idata_timestamp BETWEEN ? AND ?"),
-                  functions[func]);
+                  _T("SELECT %s(coalesce(to_number(idata_value),0)) FROM %s WHERE item_id=? AND idata_timestamp BETWEEN ? AND ?"),
+                  functions[func], table);
             break;
          case DB_SYNTAX_MSSQL:
             _sntprintf(query, 1024,
-                  _T("SELECT %s(coalesce(cast(idata_value as float),0)) FROM idata WHERE item_id=? AND (idata_timestamp BETWEEN ? AND ?) AND isnumeric(idata_value)=1"),
-                  functions[func]);
+                  _T("SELECT %s(coalesce(cast(idata_value as float),0)) FROM %s WHERE item_id=? AND (idata_timestamp BETWEEN ? AND ?) AND isnumeric(idata_value)=1"),
+                  functions[func], table);
             break;
          case DB_SYNTAX_PGSQL:
             _sntprintf(query, 1024,
-                  _T("SELECT %s(idata_value::double precision) FROM idata WHERE item_id=? AND idata_timestamp BETWEEN ? AND ? AND idata_value~E'^\\\\d+(\\\\.\\\\d+)*$'"),
-                  functions[func]);
+                  _T("SELECT %s(idata_value::double precision) FROM %s WHERE item_id=? AND idata_timestamp BETWEEN ? AND ? AND idata_value~E'^\\\\d+(\\\\.\\\\d+)*$'"),
+                  functions[func], table);
             break;
          case DB_SYNTAX_TSDB:
             _sntprintf(query, 1024,
@@ -1601,18 +1688,18 @@ TCHAR *DCItem::getAggregateValue(AggregationFunction func, time_t periodStart, t
             break;
          case DB_SYNTAX_MYSQL:
             _sntprintf(query, 1024,
-                  _T("SELECT %s(coalesce(cast(idata_value as decimal(30,10)),0)) FROM idata WHERE item_id=? AND idata_timestamp BETWEEN ? AND ?"),
-                  functions[func]);
+                  _T("SELECT %s(coalesce(cast(idata_value as decimal(30,10)),0)) FROM %s WHERE item_id=? AND idata_timestamp BETWEEN ? AND ?"),
+                  functions[func], table);
             break;
          case DB_SYNTAX_SQLITE:
             _sntprintf(query, 1024,
-                  _T("SELECT %s(coalesce(cast(idata_value as double),0)) FROM idata WHERE item_id=? AND idata_timestamp BETWEEN ? AND ?"),
-                  functions[func]);
+                  _T("SELECT %s(coalesce(cast(idata_value as double),0)) FROM %s WHERE item_id=? AND idata_timestamp BETWEEN ? AND ?"),
+                  functions[func], table);
             break;
          default:
             _sntprintf(query, 1024,
-                  _T("SELECT %s(coalesce(idata_value,0)) FROM idata WHERE item_id=? AND idata_timestamp BETWEEN ? AND ?"),
-                  functions[func]);
+                  _T("SELECT %s(coalesce(idata_value,0)) FROM %s WHERE item_id=? AND idata_timestamp BETWEEN ? AND ?"),
+                  functions[func], table);
       }
    }
    else
@@ -1686,7 +1773,7 @@ bool DCItem::deleteAllData()
    TCHAR query[256];
    if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
    {
-      if (g_dbSyntax == DB_SYNTAX_TSDB)
+      if ((g_dbSyntax == DB_SYNTAX_TSDB) || (g_flags & AF_PARTITIONED_PERF_DATA))
          _sntprintf(query, 256, _T("DELETE FROM idata_sc_%s WHERE item_id=%u"), getStorageClassName(getStorageClass()), m_id);
       else
          _sntprintf(query, 256, _T("DELETE FROM idata WHERE item_id=%u"), m_id);
@@ -1696,6 +1783,16 @@ bool DCItem::deleteAllData()
       _sntprintf(query, 256, _T("DELETE FROM idata_%d WHERE item_id=%u"), m_ownerId, m_id);
    }
 	bool success = DBQuery(hdb, query);
+   if (success)
+   {
+      _sntprintf(query, 256, _T("DELETE FROM dci_rollup_hourly WHERE item_id=%u"), m_id);
+      success = DBQuery(hdb, query);
+   }
+   if (success)
+   {
+      _sntprintf(query, 256, _T("DELETE FROM dci_rollup_daily WHERE item_id=%u"), m_id);
+      success = DBQuery(hdb, query);
+   }
 	clearCache();
 	updateCacheSizeInternal(true);
    unlock();
@@ -1720,6 +1817,11 @@ bool DCItem::deleteEntry(time_t timestamp)
          _sntprintf(query, 256, _T("DELETE FROM idata_sc_%s WHERE item_id=%u AND idata_timestamp=to_timestamp(") UINT64_FMT _T(")"),
                   getStorageClassName(getStorageClass()), m_id, static_cast<uint64_t>(timestamp));
       }
+      else if (g_flags & AF_PARTITIONED_PERF_DATA)
+      {
+         _sntprintf(query, 256, _T("DELETE FROM idata_sc_%s WHERE item_id=%u AND idata_timestamp=") UINT64_FMT,
+                  getStorageClassName(getStorageClass()), m_id, static_cast<uint64_t>(timestamp));
+      }
       else
       {
          _sntprintf(query, 256, _T("DELETE FROM idata WHERE item_id=%d AND idata_timestamp=") UINT64_FMT, m_id, static_cast<uint64_t>(timestamp));
@@ -1745,7 +1847,7 @@ bool DCItem::deleteEntry(time_t timestamp)
       {
          delete m_ppValueCache[i];
          memmove(&m_ppValueCache[i], &m_ppValueCache[i + 1], sizeof(ItemValue *) * (m_cacheSize - (i + 1)));
-         m_cacheSize--;
+         setCacheSize(m_cacheSize - 1);
          updateCacheSizeInternal(true);
          break;
       }
@@ -247,8 +247,10 @@ BOOL Threshold::saveToDB(DB_HANDLE hdb, UINT32 dwIndex)
  *    THRESHOLD_REARMED - when item's value doesn't match the threshold condition while previous check do
  *    NO_ACTION - when there are no changes in item's value match to threshold's condition
  */
-ThresholdCheckResult Threshold::check(ItemValue &value, ItemValue **ppPrevValues, ItemValue &fvalue, ItemValue &tvalue, shared_ptr<NetObj> target, DCItem *dci)
+ThresholdCheckResult Threshold::check(ItemValue &value, ItemValue **ppPrevValues, ItemValue &fvalue, ItemValue &tvalue, shared_ptr<NetObj> target, DCItem *dci, ThresholdAggregates *aggregates)
 {
+   ThresholdWindow *window = nullptr;
+
    // check if there is enough cached data
    switch(m_function)
    {
@@ -259,6 +261,14 @@ ThresholdCheckResult Threshold::check(ItemValue &value, ItemValue **ppPrevValues
       case F_AVERAGE:
       case F_SUM:
       case F_DEVIATION:
+         if (aggregates != nullptr)
+            window = aggregates->find(m_sampleCount, m_dataType);
+         if (window != nullptr)
+         {
+            if (window->placeholders > 0)
+               return m_isReached ? ThresholdCheckResult::ALREADY_ACTIVE : ThresholdCheckResult::ALREADY_INACTIVE;
+            break;
+         }
          for(int i = 0; i < m_sampleCount - 1; i++)
             if (ppPrevValues[i]->getTimeStamp() == 1) // Timestamp 1 means placeholder value inserted by cache loader
                return m_isReached ? ThresholdCheckResult::ALREADY_ACTIVE : ThresholdCheckResult::ALREADY_INACTIVE;
@@ -278,13 +288,13 @@ ThresholdCheckResult Threshold::check(ItemValue &value, ItemValue **ppPrevValues
          fvalue = value;
          break;
       case F_AVERAGE:      // Check average value for last n polls
-         calculateAverageValue(&fvalue, value, ppPrevValues);
+         calculateAverageValue(&fvalue, value, ppPrevValues, window);
          break;
 		case F_SUM:
-         calculateSumValue(&fvalue, value, ppPrevValues);
+         calculateSumValue(&fvalue, value, ppPrevValues, window);
 			break;
       case F_DEVIATION:    // Check mean absolute deviation
-         calculateMDValue(&fvalue, value, ppPrevValues);
+         calculateMDValue(&fvalue, value, ppPrevValues, window);
          break;
       case F_DIFF:
          calculateDiff(&fvalue, value, ppPrevValues);
@@ -636,6 +646,157 @@ void Threshold::updateFromMessage(const NXCPMessage& msg, uint32_t baseId)
    m_expandValue = (NumChars(m_value, '%') > 0);
 }
 
+/**
+ * Get value as it is used in integer aggregates for given data type. Signed values are sign extended,
+ * so lower bits of wrapped 64 bit sum are equal to sum calculated in value's own type.
+ */
+static inline uint64_t IntegerAggregateValue(const ItemValue *value, int dataType)
+{
+   switch(dataType)
+   {
+      case DCI_DT_INT:
+         return static_cast<uint64_t>(static_cast<int64_t>(value->getInt32()));
+      case DCI_DT_UINT:
+      case DCI_DT_COUNTER32:
+         return value->getUInt32();
+      case DCI_DT_INT64:
+         return static_cast<uint64_t>(value->getInt64());
+      case DCI_DT_UINT64:
+      case DCI_DT_COUNTER64:
+         return value->getUInt64();
+      default:
+         return 0;
+   }
+}
+
+/**
+ * Check if running aggregates can be maintained for given data type
+ */
+static inline bool IsAggregatableDataType(int dataType)
+{
+   return (dataType == DCI_DT_INT) || (dataType == DCI_DT_UINT) || (dataType == DCI_DT_COUNTER32) ||
+          (dataType == DCI_DT_INT64) || (dataType == DCI_DT_UINT64) || (dataType == DCI_DT_COUNTER64) ||
+          (dataType == DCI_DT_FLOAT);
+}
+
+/**
+ * Rebuild aggregates for all sample windows used by given thresholds
+ */
+void ThresholdAggregates::rebuild(ObjectArray<Threshold> *thresholds, ItemValue **cache, uint32_t cacheSize, int dataType)
+{
+   m_windows.clear();
+   m_cacheSize = cacheSize;
+   m_dataType = dataType;
+   m_valid = true;
+
+   if ((thresholds == nullptr) || !IsAggregatableDataType(dataType))
+      return;
+
+   for(int i = 0; i < thresholds->size(); i++)
+   {
+      Threshold *t = thresholds->get(i);
+      int function = t->getFunction();
+      if ((function != F_AVERAGE) && (function != F_SUM) && (function != F_DEVIATION))
+         continue;
+
+      // Window should contain at least one cached value and should fit into cache
+      int sampleCount = t->getSampleCount();
+      if ((sampleCount < 2) || (static_cast<uint32_t>(sampleCount - 1) > cacheSize) || (find(sampleCount, dataType) != nullptr))
+         continue;
+
+      ThresholdWindow *w = m_windows.addPlaceholder();
+      memset(w, 0, sizeof(ThresholdWindow));
+      w->sampleCount = sampleCount;
+      for(int j = 0; j < sampleCount - 1; j++)
+      {
+         if (cache[j]->getTimeStamp() == 1)
+            w->placeholders++;
+         w->sum += IntegerAggregateValue(cache[j], dataType);
+      }
+   }
+}
+
+/**
+ * Update aggregates before new value is shifted into cache. Should be called while cache still holds
+ * previous values, so value leaving each window can be subtracted.
+ */
+void ThresholdAggregates::shift(ItemValue **cache, uint32_t cacheSize, const ItemValue *value)
+{
+   if (!m_valid || (cacheSize != m_cacheSize))
+   {
+      m_valid = false;
+      return;
+   }
+
+   uint64_t v = IntegerAggregateValue(value, m_dataType);
+   bool placeholder = (value->getTimeStamp() == 1);
+   for(int i = 0; i < m_windows.size(); i++)
+   {
+      ThresholdWindow *w = m_windows.get(i);
+      const ItemValue *leaving = cache[w->sampleCount - 2];
+      w->sum += v - IntegerAggregateValue(leaving, m_dataType);
+      if (placeholder)
+         w->placeholders++;
+      if (leaving->getTimeStamp() == 1)
+         w->placeholders--;
+   }
+}
+
+/**
+ * Reset results memorized during previous threshold check
+ */
+void ThresholdAggregates::startCheck()
+{
+   for(int i = 0; i < m_windows.size(); i++)
+   {
+      ThresholdWindow *w = m_windows.get(i);
+      w->sumReady = false;
+      w->deviationReady = false;
+   }
+}
+
+/**
+ * Find window for given sample count. Returns nullptr if aggregates are not available.
+ */
+ThresholdWindow *ThresholdAggregates::find(int sampleCount, int dataType)
+{
+   if (!m_valid || (dataType != m_dataType))
+      return nullptr;
+   for(int i = 0; i < m_windows.size(); i++)
+   {
+      ThresholdWindow *w = m_windows.get(i);
+      if (w->sampleCount == sampleCount)
+         return w;
+   }
+   return nullptr;
+}
+
+/**
+ * Get sum of values in window including last value, converted to given type
+ */
+template<typename T> static inline T WindowSum(ThresholdWindow *window, const ItemValue &lastValue, int dataType)
+{
+   return static_cast<T>(window->sum + IntegerAggregateValue(&lastValue, dataType));
+}
+
+/**
+ * Get sum of floating point values in window including last value. Values are added in the same
+ * order as by full recalculation, so result is identical. Sum is calculated once per check and
+ * shared by all thresholds using this window.
+ */
+static double WindowDoubleSum(ThresholdWindow *window, const ItemValue &lastValue, ItemValue **ppPrevValues)
+{
+   if (!window->sumReady)
+   {
+      double sum = lastValue.getDouble();
+      for(int i = 1; i < window->sampleCount; i++)
+         sum += ppPrevValues[i - 1]->getDouble();
+      window->doubleSum = sum;
+      window->sumReady = true;
+   }
+   return window->doubleSum;
+}
+
 /**
  * Calculate average value for parameter
  */
@@ -650,8 +811,32 @@ void Threshold::updateFromMessage(const NXCPMessage& msg, uint32_t baseId)
    *pResult = var / (vtype)m_sampleCount; \
 }
 
-void Threshold::calculateAverageValue(ItemValue *pResult, ItemValue &lastValue, ItemValue **ppPrevValues)
+void Threshold::calculateAverageValue(ItemValue *pResult, ItemValue &lastValue, ItemValue **ppPrevValues, ThresholdWindow *window)
 {
+   if (window != nullptr)
+   {
+      switch(m_dataType)
+      {
+         case DCI_DT_INT:
+            *pResult = WindowSum<INT32>(window, lastValue, m_dataType) / static_cast<INT32>(m_sampleCount);
+            return;
+         case DCI_DT_UINT:
+         case DCI_DT_COUNTER32:
+            *pResult = WindowSum<UINT32>(window, lastValue, m_dataType) / static_cast<UINT32>(m_sampleCount);
+            return;
+         case DCI_DT_INT64:
+            *pResult = WindowSum<INT64>(window, lastValue, m_dataType) / static_cast<INT64>(m_sampleCount);
+            return;
+         case DCI_DT_UINT64:
+         case DCI_DT_COUNTER64:
+            *pResult = WindowSum<UINT64>(window, lastValue, m_dataType) / static_cast<UINT64>(m_sampleCount);
+            return;
+         case DCI_DT_FLOAT:
+            *pResult = WindowDoubleSum(window, lastValue, ppPrevValues) / static_cast<double>(m_sampleCount);
+            return;
+      }
+   }
+
    switch(m_dataType)
    {
       case DCI_DT_INT:
@@ -696,8 +881,32 @@ void Threshold::calculateAverageValue(ItemValue *pResult, ItemValue &lastValue,
 /**
  * Calculate sum value for parameter
  */
-void Threshold::calculateSumValue(ItemValue *pResult, ItemValue &lastValue, ItemValue **ppPrevValues)
+void Threshold::calculateSumValue(ItemValue *pResult, ItemValue &lastValue, ItemValue **ppPrevValues, ThresholdWindow *window)
 {
+   if (window != nullptr)
+   {
+      switch(m_dataType)
+      {
+         case DCI_DT_INT:
+            *pResult = WindowSum<INT32>(window, lastValue, m_dataType);
+            return;
+         case DCI_DT_UINT:
+         case DCI_DT_COUNTER32:
+            *pResult = WindowSum<UINT32>(window, lastValue, m_dataType);
+            return;
+         case DCI_DT_INT64:
+            *pResult = WindowSum<INT64>(window, lastValue, m_dataType);
+            return;
+         case DCI_DT_UINT64:
+         case DCI_DT_COUNTER64:
+            *pResult = WindowSum<UINT64>(window, lastValue, m_dataType);
+            return;
+         case DCI_DT_FLOAT:
+            *pResult = WindowDoubleSum(window, lastValue, ppPrevValues);
+            return;
+      }
+   }
+
    switch(m_dataType)
    {
       case DCI_DT_INT:
@@ -745,13 +954,91 @@ void Threshold::calculateSumValue(ItemValue *pResult, ItemValue &lastValue, Item
    *pResult = dev / (vtype)m_sampleCount; \
 }
 
+/**
+ * Calculate mean absolute deviation for signed integer values in window. Mean is taken
+ * from running sum, deviation still requires pass over all values.
+ */
+template<typename T> static T WindowSignedDeviation(ThresholdWindow *window, const ItemValue &lastValue, ItemValue **ppPrevValues, int dataType)
+{
+   T mean = WindowSum<T>(window, lastValue, dataType) / static_cast<T>(window->sampleCount);
+   T diff = static_cast<T>(lastValue) - mean;
+   T dev = (diff < 0) ? -diff : diff;
+   for(int i = 1; i < window->sampleCount; i++)
+   {
+      diff = static_cast<T>(*ppPrevValues[i - 1]) - mean;
+      dev += (diff < 0) ? -diff : diff;
+   }
+   return dev / static_cast<T>(window->sampleCount);
+}
+
+/**
+ * Calculate mean deviation for unsigned integer values in window. Deviation of unsigned values is
+ * calculated without taking absolute value, so sum of deviations is equal to sum of values minus
+ * mean multiplied by number of samples (in modulo arithmetic of value type).
+ */
+template<typename T> static inline T WindowUnsignedDeviation(ThresholdWindow *window, const ItemValue &lastValue, int dataType)
+{
+   T count = static_cast<T>(window->sampleCount);
+   T sum = WindowSum<T>(window, lastValue, dataType);
+   T mean = sum / count;
+   return static_cast<T>(sum - mean * count) / count;
+}
+
 /**
  * Calculate mean absolute deviation for parameter
  */
-void Threshold::calculateMDValue(ItemValue *pResult, ItemValue &lastValue, ItemValue **ppPrevValues)
+void Threshold::calculateMDValue(ItemValue *pResult, ItemValue &lastValue, ItemValue **ppPrevValues, ThresholdWindow *window)
 {
    int i;
 
+   if (window != nullptr)
+   {
+      switch(m_dataType)
+      {
+         case DCI_DT_INT:
+            if (!window->deviationReady)
+               window->deviation = static_cast<uint64_t>(static_cast<int64_t>(WindowSignedDeviation<INT32>(window, lastValue, ppPrevValues, m_dataType)));
+            *pResult = static_cast<INT32>(window->deviation);
+            break;
+         case DCI_DT_INT64:
+            if (!window->deviationReady)
+               window->deviation = static_cast<uint64_t>(WindowSignedDeviation<INT64>(window, lastValue, ppPrevValues, m_dataType));
+            *pResult = static_cast<INT64>(window->deviation);
+            break;
+         case DCI_DT_FLOAT:
+            if (!window->deviationReady)
+            {
+               double mean = WindowDoubleSum(window, lastValue, ppPrevValues) / static_cast<double>(m_sampleCount);
+               double diff = lastValue.getDouble() - mean;
+               double dev = (diff < 0) ? -diff : diff;
+               for(i = 1; i < m_sampleCount; i++)
+               {
+                  diff = ppPrevValues[i - 1]->getDouble() - mean;
+                  dev += (diff < 0) ? -diff : diff;
+               }
+               window->doubleDeviation = dev / static_cast<double>(m_sampleCount);
+            }
+            *pResult = window->doubleDeviation;
+            break;
+         case DCI_DT_UINT:
+         case DCI_DT_COUNTER32:
+            *pResult = WindowUnsignedDeviation<UINT32>(window, lastValue, m_dataType);
+            break;
+         case DCI_DT_UINT64:
+         case DCI_DT_COUNTER64:
+            *pResult = WindowUnsignedDeviation<UINT64>(window, lastValue, m_dataType);
+            break;
+         default:
+            window = nullptr;
+            break;
+      }
+      if (window != nullptr)
+      {
+         window->deviationReady = true;
+         return;
+      }
+   }
+
    switch(m_dataType)
    {
       case DCI_DT_INT:
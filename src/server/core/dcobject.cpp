@@ -333,23 +333,15 @@ bool DCObject::loadAccessList(DB_HANDLE hdb)
 {
    m_accessList->clear();
 
-   DB_STATEMENT hStmt = DBPrepare(hdb, _T("SELECT user_id FROM dci_access WHERE dci_id=?"));
-   if (hStmt == nullptr)
+   ObjectDataRows accessList(hdb, StartupDataSet::DCI_ACCESS,
+            _T("SELECT user_id,dci_id FROM dci_access ORDER BY dci_id"),
+            _T("SELECT user_id FROM dci_access WHERE dci_id=?"), m_id);
+   if (!accessList.isValid())
       return false;
 
-   DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-   DB_RESULT hResult = DBSelectPrepared(hStmt);
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         m_accessList->add(DBGetFieldULong(hResult, i, 0));
-      }
-      DBFreeResult(hResult);
-   }
-   DBFreeStatement(hStmt);
-   return hResult != nullptr;
+   for(int i = accessList.getFirstRow(); i < accessList.getEndRow(); i++)
+      m_accessList->add(DBGetFieldULong(accessList.getResult(), i, 0));
+   return true;
 }
 
 /**
@@ -361,27 +353,19 @@ bool DCObject::loadCustomSchedules(DB_HANDLE hdb)
    if (m_pollingScheduleType != DC_POLLING_SCHEDULE_ADVANCED)
 		return true;
 
-   DB_STATEMENT hStmt = DBPrepare(hdb, _T("SELECT schedule FROM dci_schedules WHERE item_id=?"));
-   if (hStmt == nullptr)
+   ObjectDataRows schedules(hdb, StartupDataSet::DCI_SCHEDULES,
+            _T("SELECT schedule,item_id FROM dci_schedules ORDER BY item_id"),
+            _T("SELECT schedule FROM dci_schedules WHERE item_id=?"), m_id);
+   if (!schedules.isValid())
       return false;
 
-   DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-   DB_RESULT hResult = DBSelectPrepared(hStmt);
-   if (hResult != nullptr)
+   if (schedules.getRowCount() > 0)
    {
-      int count = DBGetNumRows(hResult);
-      if (count > 0)
-      {
-         m_schedules = new StringList();
-         for(int i = 0; i < count; i++)
-         {
-            m_schedules->addPreallocated(DBGetField(hResult, i, 0, nullptr, 0));
-         }
-      }
-      DBFreeResult(hResult);
+      m_schedules = new StringList();
+      for(int i = schedules.getFirstRow(); i < schedules.getEndRow(); i++)
+         m_schedules->addPreallocated(DBGetField(schedules.getResult(), i, 0, nullptr, 0));
    }
-   DBFreeStatement(hStmt);
-	return hResult != nullptr;
+   return true;
 }
 
 /**
@@ -539,6 +523,7 @@ void DCObject::setStatus(int status, bool generateEvent)
    if ((owner != nullptr) && (m_status != (BYTE)status))
    {
       NotifyClientsOnDCIStatusChange(*owner, getId(), status);
+      NotifyClientsOnLastValueChange(owner->getId(), getId());
       if (generateEvent && IsEventSource(owner->getObjectClass()))
       {
          static UINT32 eventCode[3] = { EVENT_DCI_ACTIVE, EVENT_DCI_DISABLED, EVENT_DCI_UNSUPPORTED };
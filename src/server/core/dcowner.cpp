@@ -123,7 +123,20 @@ static bool ProcessDeletedItems(DB_HANDLE hdb, const String& list)
    StringBuffer query = _T("DELETE FROM thresholds WHERE item_id IN (");
    query.append(list);
    query.append(_T(')'));
-   return DBQuery(hdb, query);
+   if (!DBQuery(hdb, query))
+      return false;
+
+   // Rollup tables can be large, so delete rollup data in background
+   query = _T("DELETE FROM dci_rollup_hourly WHERE item_id IN (");
+   query.append(list);
+   query.append(_T(')'));
+   QueueSQLRequest(query);
+
+   query = _T("DELETE FROM dci_rollup_daily WHERE item_id IN (");
+   query.append(list);
+   query.append(_T(')'));
+   QueueSQLRequest(query);
+   return true;
 }
 
 /**
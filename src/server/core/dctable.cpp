@@ -282,7 +282,7 @@ bool DCTable::deleteAllData()
    TCHAR query[256];
    if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
    {
-      if (g_dbSyntax == DB_SYNTAX_TSDB)
+      if ((g_dbSyntax == DB_SYNTAX_TSDB) || (g_flags & AF_PARTITIONED_PERF_DATA))
          _sntprintf(query, 256, _T("DELETE FROM tdata_sc_%s WHERE item_id=%u"), getStorageClassName(getStorageClass()), m_id);
       else
          _sntprintf(query, 256, _T("DELETE FROM tdata WHERE item_id=%u"), m_id);
@@ -314,6 +314,11 @@ bool DCTable::deleteEntry(time_t timestamp)
          _sntprintf(query, 256, _T("DELETE FROM tdata_sc_%s WHERE item_id=%u AND tdata_timestamp=to_timestamp(")  UINT64_FMT _T(")"),
                   getStorageClassName(getStorageClass()), m_id, static_cast<uint64_t>(timestamp));
       }
+      else if (g_flags & AF_PARTITIONED_PERF_DATA)
+      {
+         _sntprintf(query, 256, _T("DELETE FROM tdata_sc_%s WHERE item_id=%u AND tdata_timestamp=") UINT64_FMT,
+                  getStorageClassName(getStorageClass()), m_id, static_cast<uint64_t>(timestamp));
+      }
       else
       {
          _sntprintf(query, 256, _T("DELETE FROM tdata WHERE item_id=%u AND tdata_timestamp=") UINT64_FMT, m_id, static_cast<uint64_t>(timestamp));
@@ -371,6 +376,7 @@ bool DCTable::processNewValue(time_t timestamp, const shared_ptr<Table>& value,
 	uint32_t tableId = m_id;
 	uint32_t nodeId = owner->getId();
    bool save = (m_retentionType != DC_RETENTION_NONE);
+   DCObjectStorageClass storageClass = getStorageClass();
 
    unlock();
 
@@ -378,51 +384,12 @@ bool DCTable::processNewValue(time_t timestamp, const shared_ptr<Table>& value,
 	// Object is unlocked, so only local variables can be used
    if (save)
    {
-	   DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
-      if (!DBBegin(hdb))
-      {
-   	   DBConnectionPoolReleaseConnection(hdb);
-         return true;
-      }
-
-      bool success = false;
-
-	   DB_STATEMENT hStmt;
-	   if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
+	   char *packedValue = value->createPackedBinary();
+	   if (packedValue != nullptr)
 	   {
-	      if (g_dbSyntax == DB_SYNTAX_TSDB)
-	      {
-	         TCHAR query[256];
-	         _sntprintf(query, 256, _T("INSERT INTO tdata_sc_%s (item_id,tdata_timestamp,tdata_value) VALUES (?,to_timestamp(?),?)"),
-	                  getStorageClassName(getStorageClass()));
-            hStmt = DBPrepare(hdb, query);
-	      }
-	      else
-	      {
-	         hStmt = DBPrepare(hdb, _T("INSERT INTO tdata (item_id,tdata_timestamp,tdata_value) VALUES (?,?,?)"));
-	      }
+	      QueueTDataInsert(timestamp, nodeId, tableId, storageClass, packedValue);
+	      MemFree(packedValue);
 	   }
-	   else
-	   {
-	      TCHAR query[256];
-	      _sntprintf(query, 256, _T("INSERT INTO tdata_%u (item_id,tdata_timestamp,tdata_value) VALUES (?,?,?)"), nodeId);
-	      hStmt = DBPrepare(hdb, query);
-	   }
-	   if (hStmt != nullptr)
-	   {
-		   DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, tableId);
-		   DBBind(hStmt, 2, DB_SQLTYPE_INTEGER, (INT32)timestamp);
-		   DBBind(hStmt, 3, DB_SQLTYPE_TEXT, DB_CTYPE_UTF8_STRING, value->createPackedXML(), DB_BIND_DYNAMIC);
-	      success = DBExecute(hStmt);
-		   DBFreeStatement(hStmt);
-	   }
-
-      if (success)
-         DBCommit(hdb);
-      else
-         DBRollback(hdb);
-
-	   DBConnectionPoolReleaseConnection(hdb);
    }
    if ((g_offlineDataRelevanceTime <= 0) || (timestamp > (time(nullptr) - g_offlineDataRelevanceTime)))
       checkThresholds(value.get());
@@ -535,6 +502,8 @@ void DCTable::checkThresholds(Table *value)
 void DCTable::processNewError(bool noInstance, time_t now)
 {
 	m_dwErrorCount++;
+   if (m_dwErrorCount == 1)
+      NotifyClientsOnLastValueChange(m_ownerId, m_id);
 }
 
 /**
@@ -764,7 +733,7 @@ void DCTable::deleteFromDatabase()
    QueueSQLRequest(szQuery);
 
    auto owner = m_owner.lock();
-   if (owner->isDataCollectionTarget() && g_dbSyntax != DB_SYNTAX_TSDB)
+   if (owner->isDataCollectionTarget() && (g_dbSyntax != DB_SYNTAX_TSDB) && !(g_flags & AF_PARTITIONED_PERF_DATA))
       static_cast<DataCollectionTarget*>(owner.get())->scheduleTableDataCleanup(m_id);
 }
 
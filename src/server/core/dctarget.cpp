@@ -95,8 +95,8 @@ bool DataCollectionTarget::deleteFromDatabase(DB_HANDLE hdb)
 {
    bool success = executeQueryOnObject(hdb, _T("DELETE FROM dct_node_map WHERE node_id=?"));
 
-   // TSDB: to avoid heavy query on idata tables let collected data expire instead of deleting it immediately
-   if (success && ((g_dbSyntax != DB_SYNTAX_TSDB) || !(g_flags & AF_SINGLE_TABLE_PERF_DATA)))
+   // TSDB and partitioned tables: to avoid heavy query on idata tables let collected data expire instead of deleting it immediately
+   if (success && ((g_dbSyntax != DB_SYNTAX_TSDB) || !(g_flags & AF_SINGLE_TABLE_PERF_DATA)) && !(g_flags & AF_PARTITIONED_PERF_DATA))
    {
       TCHAR query[256];
       _sntprintf(query, 256, (g_flags & AF_SINGLE_TABLE_PERF_DATA) ? _T("DELETE FROM idata WHERE item_id IN (SELECT item_id FROM items WHERE node_id=%u)") : _T("DROP TABLE idata_%u"), m_id);
@@ -284,6 +284,22 @@ void DataCollectionTarget::updateDciCache()
 	unlockDciAccess();
 }
 
+/**
+ * Write caches of all DCI's to DCI cache snapshot
+ */
+void DataCollectionTarget::writeDciCacheSnapshot(DCICacheSnapshotWriter *writer)
+{
+   readLockDciAccess();
+   for(int i = 0; i < m_dcObjects->size(); i++)
+   {
+      if (m_dcObjects->get(i)->getType() == DCO_TYPE_ITEM)
+      {
+         static_cast<DCItem*>(m_dcObjects->get(i))->writeCacheSnapshot(writer);
+      }
+   }
+   unlockDciAccess();
+}
+
 /**
  * Calculate DCI cutoff time for cleaning expired DCI data using TSDB drop_chunks() function
  */
@@ -854,11 +870,63 @@ UINT32 DataCollectionTarget::getThresholdSummary(NXCPMessage *msg, UINT32 baseId
    return varId;
 }
 
+/**
+ * DCI state sent to last values subscribers (value timestamp is not included, so
+ * repeated collection of same value does not cause last values update)
+ */
+struct LastValueState
+{
+   SharedString value;
+   shared_ptr<Table> tableValue;
+   uint32_t errorCount;
+   bool activeThreshold;
+
+   LastValueState(DCObject *dco)
+   {
+      if (dco->getType() == DCO_TYPE_ITEM)
+      {
+         value = SharedString(static_cast<DCItem*>(dco)->getLastValue());
+         activeThreshold = static_cast<DCItem*>(dco)->hasActiveThreshold();
+      }
+      else
+      {
+         tableValue = static_cast<DCTable*>(dco)->getLastValue();
+         activeThreshold = false;
+      }
+      errorCount = dco->getErrorCount();
+   }
+
+   bool equals(const LastValueState& s) const
+   {
+      return (errorCount == s.errorCount) && (activeThreshold == s.activeThreshold) &&
+               !_tcscmp(value.cstr(), s.value.cstr()) && TablesEqual(tableValue.get(), s.tableValue.get());
+   }
+
+   static bool TablesEqual(const Table *t1, const Table *t2)
+   {
+      if (t1 == t2)
+         return true;
+      if ((t1 == nullptr) || (t2 == nullptr) || (t1->getNumColumns() != t2->getNumColumns()) || (t1->getNumRows() != t2->getNumRows()))
+         return false;
+      for(int c = 0; c < t1->getNumColumns(); c++)
+         if (_tcscmp(t1->getColumnName(c), t2->getColumnName(c)))
+            return false;
+      for(int r = 0; r < t1->getNumRows(); r++)
+         for(int c = 0; c < t1->getNumColumns(); c++)
+            if (_tcscmp(t1->getAsString(r, c, _T("")), t2->getAsString(r, c, _T(""))))
+               return false;
+      return true;
+   }
+};
+
 /**
  * Process new DCI value
  */
 bool DataCollectionTarget::processNewDCValue(const shared_ptr<DCObject>& dco, time_t currTime, const TCHAR *itemValue, const shared_ptr<Table>& tableValue)
 {
+   // Remember current state only if someone is subscribed to this object's last values
+   LastValueState *prevState = HasLastValuesSubscription(m_id) ? new LastValueState(dco.get()) : nullptr;
+
    bool updateStatus;
 	bool result = (dco->getType() == DCO_TYPE_ITEM) ?
 	         static_cast<DCItem&>(*dco).processNewValue(currTime, itemValue, &updateStatus) :
@@ -867,6 +935,9 @@ bool DataCollectionTarget::processNewDCValue(const shared_ptr<DCObject>& dco, ti
 	{
       calculateCompoundStatus(FALSE);
    }
+   if (result && (prevState != nullptr) && !prevState->equals(LastValueState(dco.get())))
+      NotifyClientsOnLastValueChange(m_id, dco->getId());
+   delete prevState;
    return result;
 }
 
@@ -1124,6 +1195,7 @@ NXSL_VM *DataCollectionTarget::runDataCollectionScript(const TCHAR *param, DataC
       {
          vm->setGlobalVariable("$targetObject", targetObject->createNXSLObject(vm));
       }
+      PerfScopedTimer perfTimer(PerfHotPath::SCRIPT_EXECUTION, m_id);
       if (!vm->run(args))
       {
          nxlog_debug(6, _T("DataCollectionTarget(%s)->runDataCollectionScript(%s): Script execution error: %s"), m_name, param, vm->getErrorText());
@@ -2136,6 +2208,7 @@ void DataCollectionTarget::statusPollWorkerEntry(PollerInfo *poller)
 void DataCollectionTarget::statusPollWorkerEntry(PollerInfo *poller, ClientSession *session, UINT32 rqId)
 {
    poller->startExecution();
+   PerfScopedTimer perfTimer(PerfHotPath::STATUS_POLL, m_id);
    statusPoll(poller, session, rqId);
    delete poller;
 }
@@ -2170,6 +2243,7 @@ void DataCollectionTarget::configurationPollWorkerEntry(PollerInfo *poller)
 void DataCollectionTarget::configurationPollWorkerEntry(PollerInfo *poller, ClientSession *session, UINT32 rqId)
 {
    poller->startExecution();
+   PerfScopedTimer perfTimer(PerfHotPath::CONFIGURATION_POLL, m_id);
    poller->startObjectTransaction();
    configurationPoll(poller, session, rqId);
    poller->endObjectTransaction();
@@ -2486,9 +2560,9 @@ bool DataCollectionTarget::updateInstances(DCObject *root, StringObjectMap<Insta
 }
 
 /**
- * Get last (current) DCI values.
+ * Get last (current) DCI values. If DCI filter is given, only DCIs from that set are included.
  */
-UINT32 DataCollectionTarget::getLastValues(NXCPMessage *msg, bool objectTooltipOnly, bool overviewOnly, bool includeNoValueObjects, UINT32 userId)
+UINT32 DataCollectionTarget::getLastValues(NXCPMessage *msg, bool objectTooltipOnly, bool overviewOnly, bool includeNoValueObjects, UINT32 userId, const HashSet<uint32_t> *dciFilter)
 {
    readLockDciAccess();
 
@@ -2496,7 +2570,8 @@ UINT32 DataCollectionTarget::getLastValues(NXCPMessage *msg, bool objectTooltipO
    for(int i = 0; i < m_dcObjects->size(); i++)
    {
       DCObject *object = m_dcObjects->get(i);
-      if ((object->hasValue() || includeNoValueObjects) &&
+      if (((dciFilter == nullptr) || dciFilter->contains(object->getId())) &&
+          (object->hasValue() || includeNoValueObjects) &&
           (!objectTooltipOnly || object->isShowOnObjectTooltip()) &&
           (!overviewOnly || object->isShowInObjectOverview()) &&
           object->hasAccess(userId))
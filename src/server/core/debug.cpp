@@ -190,6 +190,106 @@ DataCollectionError GetThreadPoolStat(ThreadPoolStat stat, const TCHAR *param, T
    return DCE_SUCCESS;
 }
 
+/**
+ * Show single latency histogram summary line (values converted to milliseconds)
+ */
+static void ShowLatencyHistogram(CONSOLE_CTX console, const TCHAR *name, const LatencyHistogram& h)
+{
+   ConsolePrintf(console, _T("%-36s %10u %10.3f %10.3f %10.3f %10.3f %10.3f\n"), name, static_cast<uint32_t>(h.getCount()),
+            static_cast<double>(h.getPercentile(50)) / 1000, static_cast<double>(h.getPercentile(90)) / 1000,
+            static_cast<double>(h.getPercentile(99)) / 1000, static_cast<double>(h.getPercentile(99.9)) / 1000,
+            static_cast<double>(h.getMax()) / 1000);
+}
+
+/**
+ * Show latency histograms for thread pools, database writers, and event processor queues
+ */
+void ShowLatencyHistograms(CONSOLE_CTX console)
+{
+   ConsolePrintf(console, _T("\x1b[1m%-36s %10s %10s %10s %10s %10s %10s\x1b[0m\n"),
+            _T("Source"), _T("Count"), _T("p50"), _T("p90"), _T("p99"), _T("p99.9"), _T("Max"));
+
+   TCHAR name[128];
+   LatencyHistogram waitTime, runTime;
+   StringList *pools = ThreadPoolGetAllPools();
+   pools->sort();
+   for(int i = 0; i < pools->size(); i++)
+   {
+      if (!ThreadPoolGetLatencyHistograms(pools->get(i), &waitTime, &runTime))
+         continue;
+      _sntprintf(name, 128, _T("ThreadPool/%s/Wait"), pools->get(i));
+      ShowLatencyHistogram(console, name, waitTime);
+      _sntprintf(name, 128, _T("ThreadPool/%s/Execution"), pools->get(i));
+      ShowLatencyHistogram(console, name, runTime);
+   }
+   delete pools;
+
+   static const TCHAR *writers[] = { _T("IData"), _T("TData"), _T("RawData"), _T("Other"), nullptr };
+   for(int i = 0; writers[i] != nullptr; i++)
+   {
+      GetDBWriterLatencyHistograms(writers[i], &waitTime, &runTime);
+      if (waitTime.getCount() > 0)
+      {
+         _sntprintf(name, 128, _T("DBWriter/%s/Wait"), writers[i]);
+         ShowLatencyHistogram(console, name, waitTime);
+      }
+      _sntprintf(name, 128, _T("DBWriter/%s/Write"), writers[i]);
+      ShowLatencyHistogram(console, name, runTime);
+   }
+
+   GetEventProcessorLatencyHistogram(0, &waitTime);
+   ShowLatencyHistogram(console, _T("EventProcessor/Main/Wait"), waitTime);
+   for(int i = 1; GetEventProcessorLatencyHistogram(i, &waitTime); i++)
+   {
+      _sntprintf(name, 128, _T("EventProcessor/EP-%d/Wait"), i);
+      ShowLatencyHistogram(console, name, waitTime);
+   }
+
+   ConsoleWrite(console, _T("\nAll times are in milliseconds\n\n"));
+}
+
+/**
+ * Get latency percentile for internal DCI. First parameter argument is thread pool or DB writer name,
+ * second is percentile (0..100). Returned value is in milliseconds.
+ */
+DataCollectionError GetLatencyPercentile(LatencySource source, const TCHAR *param, TCHAR *value)
+{
+   TCHAR name[64], percentileText[32];
+   if (!AgentGetParameterArg(param, 1, name, 64) ||
+       !AgentGetParameterArg(param, 2, percentileText, 32))
+      return DCE_NOT_SUPPORTED;
+
+   TCHAR *eptr;
+   double percentile = _tcstod(percentileText, &eptr);
+   if ((percentileText[0] == 0) || (*eptr != 0) || (percentile < 0) || (percentile > 100))
+      return DCE_NOT_SUPPORTED;
+
+   LatencyHistogram histogram;
+   bool found;
+   switch(source)
+   {
+      case LatencySource::THREAD_POOL_WAIT_TIME:
+         found = ThreadPoolGetLatencyHistograms(name, &histogram, nullptr);
+         break;
+      case LatencySource::THREAD_POOL_EXECUTION_TIME:
+         found = ThreadPoolGetLatencyHistograms(name, nullptr, &histogram);
+         break;
+      case LatencySource::DB_WRITER_WAIT_TIME:
+         found = GetDBWriterLatencyHistograms(name, &histogram, nullptr);
+         break;
+      case LatencySource::DB_WRITER_WRITE_TIME:
+         found = GetDBWriterLatencyHistograms(name, nullptr, &histogram);
+         break;
+      default:
+         return DCE_NOT_SUPPORTED;
+   }
+   if (!found)
+      return DCE_NO_SUCH_INSTANCE;
+
+   ret_double(value, static_cast<double>(histogram.getPercentile(percentile)) / 1000, 3);
+   return DCE_SUCCESS;
+}
+
 /**
  * Write process coredump
  */
@@ -43,6 +43,7 @@ EPRule::EPRule(uint32_t id) : m_actions(0, 16, Ownership::True)
    m_script = nullptr;
 	m_alarmTimeout = 0;
 	m_alarmTimeoutEvent = EVENT_ALARM_TIMEOUT;
+   compileTemplates();
 }
 
 /**
@@ -182,6 +183,8 @@ EPRule::EPRule(const ConfigEntry& config) : m_actions(0, 16, Ownership::True)
          }
       }
    }
+
+   compileTemplates();
 }
 
 /**
@@ -217,6 +220,7 @@ EPRule::EPRule(DB_RESULT hResult, int row) : m_actions(0, 16, Ownership::True)
 	m_alarmTimeoutEvent = DBGetFieldULong(hResult, row, 9);
 	m_rcaScriptName = DBGetField(hResult, row, 10, nullptr, 0);
    m_alarmImpact = DBGetField(hResult, row, 11, nullptr, 0);
+   compileTemplates();
 }
 
 /**
@@ -300,6 +304,8 @@ EPRule::EPRule(const NXCPMessage& msg) : m_actions(0, 16, Ownership::True)
    {
       m_script = nullptr;
    }
+
+   compileTemplates();
 }
 
 /**
@@ -310,12 +316,25 @@ EPRule::~EPRule()
    MemFree(m_alarmMessage);
    MemFree(m_alarmImpact);
    MemFree(m_alarmKey);
+   delete m_alarmMessageTemplate;
+   delete m_alarmImpactTemplate;
+   delete m_alarmKeyTemplate;
    MemFree(m_rcaScriptName);
    MemFree(m_comments);
    MemFree(m_scriptSource);
    delete m_script;
 }
 
+/**
+ * Compile alarm text templates
+ */
+void EPRule::compileTemplates()
+{
+   m_alarmMessageTemplate = new TextTemplate(m_alarmMessage);
+   m_alarmImpactTemplate = new TextTemplate(m_alarmImpact);
+   m_alarmKeyTemplate = new TextTemplate(m_alarmKey);
+}
+
 /**
  * Create rule ordering entry
  */
@@ -540,6 +559,7 @@ bool EPRule::matchScript(Event *event) const
 
    // Run script
    NXSL_VariableSystem *globals = nullptr;
+   PerfScopedTimer perfTimer(PerfHotPath::SCRIPT_EXECUTION, event->getSourceId());
    if (vm->run(args, &globals))
    {
       NXSL_Value *value = vm->getResult();
@@ -686,7 +706,7 @@ bool EPRule::processEvent(Event *event) const
 uint32_t EPRule::generateAlarm(Event *event) const
 {
    uint32_t alarmId = 0;
-   String key = event->expandText(m_alarmKey);
+   String key = event->expandText(*m_alarmKeyTemplate);
 
    // Terminate alarms with key == our ack_key
    if ((m_alarmSeverity == SEVERITY_RESOLVE) || (m_alarmSeverity == SEVERITY_TERMINATE))
@@ -722,8 +742,8 @@ uint32_t EPRule::generateAlarm(Event *event) const
 	         delete vm;
 	      }
 	   }
-	   String message = event->expandText(m_alarmMessage);
-	   String impact = event->expandText(m_alarmImpact);
+	   String message = event->expandText(*m_alarmMessageTemplate);
+	   String impact = event->expandText(*m_alarmImpactTemplate);
 
 	   alarmId = CreateNewAlarm(m_guid, m_comments, message, key, impact, ALARM_STATE_OUTSTANDING,
                      (m_alarmSeverity == SEVERITY_FROM_EVENT) ? event->getSeverity() : m_alarmSeverity,
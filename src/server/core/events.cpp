@@ -27,9 +27,9 @@
 #endif
 
 /**
- * Event processing queue
+ * Event processing queue (many producers - pollers, trap and syslog receivers, scripts; single consumer - event processor)
  */
-ObjectQueue<Event> g_eventQueue(4096, Ownership::True);
+ObjectMPSCQueue<Event> g_eventQueue(65536, Ownership::True);
 
 /**
  * Event processing policy
@@ -93,6 +93,7 @@ EventTemplate::EventTemplate(DB_RESULT hResult, int row)
    m_flags = DBGetFieldLong(hResult, row, 5);
    m_messageTemplate = DBGetField(hResult, row, 6, nullptr, 0);
    m_tags = DBGetField(hResult, row, 7, nullptr, 0);
+   m_compiledMessageTemplate = make_shared<TextTemplate>(m_messageTemplate);
 }
 
 /**
@@ -108,6 +109,7 @@ EventTemplate::EventTemplate(NXCPMessage *msg)
    m_messageTemplate = msg->getFieldAsString(VID_MESSAGE);
    m_description = msg->getFieldAsString(VID_DESCRIPTION);
    m_tags = msg->getFieldAsString(VID_TAGS);
+   m_compiledMessageTemplate = make_shared<TextTemplate>(m_messageTemplate);
 }
 
 /**
@@ -163,6 +165,7 @@ void EventTemplate::modifyFromMessage(NXCPMessage *msg)
    m_flags = msg->getFieldAsInt32(VID_FLAGS);
    MemFree(m_messageTemplate);
    m_messageTemplate = msg->getFieldAsString(VID_MESSAGE);
+   m_compiledMessageTemplate = make_shared<TextTemplate>(m_messageTemplate);
    MemFree(m_description);
    m_description = msg->getFieldAsString(VID_DESCRIPTION);
    MemFree(m_tags);
@@ -243,6 +246,7 @@ Event::Event()
 	m_queueTime = 0;
 	m_queueBinding = nullptr;
 	m_parameters.setOwner(Ownership::True);
+   UpdateMemoryUsage(MemoryCategory::EVENTS, sizeof(Event), 1);
 }
 
 /**
@@ -262,6 +266,7 @@ Event::Event(const Event *src) : m_lastAlarmKey(src->m_lastAlarmKey), m_lastAlar
    m_flags = src->m_flags;
    m_messageText = MemCopyString(src->m_messageText);
    m_messageTemplate = MemCopyString(src->m_messageTemplate);
+   m_compiledMessageTemplate = src->m_compiledMessageTemplate;
    m_timestamp = src->m_timestamp;
    m_originTimestamp = src->m_originTimestamp;
    m_tags.addAll(src->m_tags);
@@ -274,6 +279,7 @@ Event::Event(const Event *src) : m_lastAlarmKey(src->m_lastAlarmKey), m_lastAlar
       m_parameters.add(MemCopyString((TCHAR *)src->m_parameters.get(i)));
    }
    m_parameterNames.addAll(&src->m_parameterNames);
+   UpdateMemoryUsage(MemoryCategory::EVENTS, sizeof(Event), 1);
 }
 
 /**
@@ -547,6 +553,7 @@ Event::Event(const EventTemplate *eventTemplate, EventOrigin origin, time_t orig
  */
 void Event::init(const EventTemplate *eventTemplate, EventOrigin origin, time_t originTimestamp, uint32_t sourceId, uint32_t dciId)
 {
+   UpdateMemoryUsage(MemoryCategory::EVENTS, sizeof(Event), 1);
    m_origin = origin;
    _tcscpy(m_name, eventTemplate->getName());
    m_timestamp = time(nullptr);
@@ -562,6 +569,7 @@ void Event::init(const EventTemplate *eventTemplate, EventOrigin origin, time_t
    m_queueBinding = nullptr;
    m_messageText = nullptr;
    m_messageTemplate = MemCopyString(eventTemplate->getMessageTemplate());
+   m_compiledMessageTemplate = eventTemplate->getCompiledMessageTemplate();
 
    if ((eventTemplate->getTags() != nullptr) && (eventTemplate->getTags()[0] != 0))
       m_tags.splitAndAdd(eventTemplate->getTags(), _T(","));
@@ -606,6 +614,7 @@ Event::~Event()
    MemFree(m_messageText);
    MemFree(m_messageTemplate);
 	MemFree(m_customMessage);
+   UpdateMemoryUsage(MemoryCategory::EVENTS, -static_cast<int64_t>(sizeof(Event)), -1);
 }
 
 /**
@@ -618,7 +627,7 @@ void Event::expandMessageText()
 
    if (m_messageText != nullptr)
       MemFree(m_messageText);
-   m_messageText = MemCopyString(expandText(m_messageTemplate));
+   m_messageText = MemCopyString((m_compiledMessageTemplate != nullptr) ? expandText(*m_compiledMessageTemplate) : expandText(m_messageTemplate));
 }
 
 /**
@@ -629,6 +638,21 @@ StringBuffer Event::expandText(const TCHAR *textTemplate, const Alarm *alarm) co
    if (textTemplate == nullptr)
       return StringBuffer();
 
+   TextTemplate compiledTemplate(textTemplate);
+   return expandText(compiledTemplate, alarm);
+}
+
+/**
+ * Substitute % macros in given precompiled template with actual values
+ */
+StringBuffer Event::expandText(const TextTemplate& textTemplate, const Alarm *alarm) const
+{
+   if (textTemplate.isNull())
+      return StringBuffer();
+
+   if (textTemplate.isStatic())
+      return (textTemplate.size() > 0) ? StringBuffer(textTemplate.get(0)->text) : StringBuffer();
+
    shared_ptr<NetObj> object = FindObjectById(m_sourceId);
    if (object == nullptr)
    {
@@ -933,7 +957,7 @@ static bool AddEventTags(const TCHAR *tag, Event *event)
 /**
  * Post event to given event queue.
  *
- * @param queue event queue to post events to
+ * @param queue event queue to post events to (nullptr for system event queue)
  * @param eventCode Event code
  * @param sourceId Event source object ID
  * @param eventTag event's tag (can be nullptr)
@@ -961,6 +985,9 @@ static bool RealPostEvent(ObjectQueue<Event> *queue, uint64_t *eventId, uint32_t
          time_t originTimestamp, uint32_t sourceId, uint32_t dciId, const TCHAR *eventTag, const StringSet *eventTags,
          const StringMap *namedArgs, const char *format, const TCHAR **names, va_list args, NXSL_VM *vm)
 {
+   if (eventId != nullptr)
+      *eventId = 0;
+
    RWLockReadLock(s_eventTemplatesLock);
    shared_ptr<EventTemplate> eventTemplate = s_eventTemplates.getShared(eventCode);
    RWLockUnlock(s_eventTemplatesLock);
@@ -968,6 +995,12 @@ static bool RealPostEvent(ObjectQueue<Event> *queue, uint64_t *eventId, uint32_t
    bool success;
    if (eventTemplate != nullptr)
    {
+      // Check rate limits before creating event object, so excessive events from single
+      // source will not cause any significant load. Events posted by callers requesting
+      // event ID are not limited because caller may store or reference that ID.
+      if ((queue == nullptr) && (eventId == nullptr) && !CheckEventRateLimit(eventCode, sourceId))
+         return true;
+
       // Template found, create new event
       Event *event = (namedArgs != nullptr) ?
                new Event(eventTemplate.get(), origin, originTimestamp, sourceId, dciId, *namedArgs) :
@@ -993,7 +1026,11 @@ static bool RealPostEvent(ObjectQueue<Event> *queue, uint64_t *eventId, uint32_t
       }
 
       // Add new event to queue
-      queue->put(event);
+      event->setQueueTime(GetMonotonicClockTimeNs() / 1000);
+      if (queue != nullptr)
+         queue->put(event);
+      else
+         g_eventQueue.put(event);
 
       success = true;
    }
@@ -1033,7 +1070,7 @@ bool NXCORE_EXPORTABLE PostEvent(uint32_t eventCode, EventOrigin origin, time_t
 {
    va_list args;
    va_start(args, format);
-   bool success = RealPostEvent(&g_eventQueue, nullptr, eventCode, origin, originTimestamp, sourceId, 0, nullptr, nullptr, nullptr, format, nullptr, args, nullptr);
+   bool success = RealPostEvent(nullptr, nullptr, eventCode, origin, originTimestamp, sourceId, 0, nullptr, nullptr, nullptr, format, nullptr, args, nullptr);
    va_end(args);
    return success;
 }
@@ -1071,7 +1108,7 @@ bool NXCORE_EXPORTABLE PostEvent(uint32_t eventCode, EventOrigin origin, time_t
       _sntprintf(name, 64, _T("Parameter%d"), i + 1);
       pmap.set(name, parameters.get(i));
    }
-   return RealPostEvent(&g_eventQueue, nullptr, eventCode, origin, originTimestamp, sourceId, 0, nullptr, nullptr, &pmap, nullptr, nullptr, DUMMY_VA_LIST, nullptr);
+   return RealPostEvent(nullptr, nullptr, eventCode, origin, originTimestamp, sourceId, 0, nullptr, nullptr, &pmap, nullptr, nullptr, DUMMY_VA_LIST, nullptr);
 }
 
 /**
@@ -1100,7 +1137,7 @@ bool NXCORE_EXPORTABLE PostSystemEvent(uint32_t eventCode, uint32_t sourceId, co
 {
    va_list args;
    va_start(args, format);
-   bool success = RealPostEvent(&g_eventQueue, nullptr, eventCode, EventOrigin::SYSTEM, 0, sourceId, 0, nullptr, nullptr, nullptr, format, nullptr, args, nullptr);
+   bool success = RealPostEvent(nullptr, nullptr, eventCode, EventOrigin::SYSTEM, 0, sourceId, 0, nullptr, nullptr, nullptr, format, nullptr, args, nullptr);
    va_end(args);
    return success;
 }
@@ -1132,7 +1169,7 @@ bool NXCORE_EXPORTABLE PostDciEvent(uint32_t eventCode, uint32_t sourceId, uint3
 {
    va_list args;
    va_start(args, format);
-   bool success = RealPostEvent(&g_eventQueue, nullptr, eventCode, EventOrigin::SYSTEM, 0, sourceId, dciId, nullptr, nullptr, nullptr, format, nullptr, args, nullptr);
+   bool success = RealPostEvent(nullptr, nullptr, eventCode, EventOrigin::SYSTEM, 0, sourceId, dciId, nullptr, nullptr, nullptr, format, nullptr, args, nullptr);
    va_end(args);
    return success;
 }
@@ -1166,7 +1203,7 @@ UINT64 NXCORE_EXPORTABLE PostEvent2(uint32_t eventCode, EventOrigin origin, time
    va_list args;
    UINT64 eventId;
    va_start(args, format);
-   bool success = RealPostEvent(&g_eventQueue, &eventId, eventCode, origin, originTimestamp, sourceId, 0, nullptr, nullptr, nullptr, format, nullptr, args, nullptr);
+   bool success = RealPostEvent(nullptr, &eventId, eventCode, origin, originTimestamp, sourceId, 0, nullptr, nullptr, nullptr, format, nullptr, args, nullptr);
    va_end(args);
    return success ? eventId : 0;
 }
@@ -1198,7 +1235,7 @@ UINT64 NXCORE_EXPORTABLE PostSystemEvent2(uint32_t eventCode, uint32_t sourceId,
    va_list args;
    UINT64 eventId;
    va_start(args, format);
-   bool success = RealPostEvent(&g_eventQueue, &eventId, eventCode, EventOrigin::SYSTEM, 0, sourceId, 0, nullptr, nullptr, nullptr, format, nullptr, args, nullptr);
+   bool success = RealPostEvent(nullptr, &eventId, eventCode, EventOrigin::SYSTEM, 0, sourceId, 0, nullptr, nullptr, nullptr, format, nullptr, args, nullptr);
    va_end(args);
    return success ? eventId : 0;
 }
@@ -1231,7 +1268,7 @@ bool NXCORE_EXPORTABLE PostEventWithNames(uint32_t eventCode, EventOrigin origin
 {
    va_list args;
    va_start(args, names);
-   bool success = RealPostEvent(&g_eventQueue, nullptr, eventCode, origin, originTimestamp, sourceId, 0, nullptr, nullptr, nullptr, format, names, args, nullptr);
+   bool success = RealPostEvent(nullptr, nullptr, eventCode, origin, originTimestamp, sourceId, 0, nullptr, nullptr, nullptr, format, names, args, nullptr);
    va_end(args);
    return success;
 }
@@ -1247,7 +1284,7 @@ bool NXCORE_EXPORTABLE PostEventWithNames(uint32_t eventCode, EventOrigin origin
  */
 bool NXCORE_EXPORTABLE PostEventWithNames(uint32_t eventCode, EventOrigin origin, time_t originTimestamp, uint32_t sourceId, StringMap *parameters)
 {
-   return RealPostEvent(&g_eventQueue, nullptr, eventCode, origin, originTimestamp, sourceId, 0, nullptr, nullptr, parameters, nullptr, nullptr, DUMMY_VA_LIST, nullptr);
+   return RealPostEvent(nullptr, nullptr, eventCode, origin, originTimestamp, sourceId, 0, nullptr, nullptr, parameters, nullptr, nullptr, DUMMY_VA_LIST, nullptr);
 }
 
 /**
@@ -1275,7 +1312,7 @@ bool NXCORE_EXPORTABLE PostSystemEventWithNames(uint32_t eventCode, uint32_t sou
 {
    va_list args;
    va_start(args, names);
-   bool success = RealPostEvent(&g_eventQueue, nullptr, eventCode, EventOrigin::SYSTEM, 0, sourceId, 0, nullptr, nullptr, nullptr, format, names, args, nullptr);
+   bool success = RealPostEvent(nullptr, nullptr, eventCode, EventOrigin::SYSTEM, 0, sourceId, 0, nullptr, nullptr, nullptr, format, names, args, nullptr);
    va_end(args);
    return success;
 }
@@ -1289,7 +1326,7 @@ bool NXCORE_EXPORTABLE PostSystemEventWithNames(uint32_t eventCode, uint32_t sou
  */
 bool NXCORE_EXPORTABLE PostSystemEventWithNames(uint32_t eventCode, uint32_t sourceId, StringMap *parameters)
 {
-   return RealPostEvent(&g_eventQueue, nullptr, eventCode, EventOrigin::SYSTEM, 0, sourceId, 0, nullptr, nullptr, parameters, nullptr, nullptr, DUMMY_VA_LIST, nullptr);
+   return RealPostEvent(nullptr, nullptr, eventCode, EventOrigin::SYSTEM, 0, sourceId, 0, nullptr, nullptr, parameters, nullptr, nullptr, DUMMY_VA_LIST, nullptr);
 }
 
 /**
@@ -1318,7 +1355,7 @@ bool NXCORE_EXPORTABLE PostDciEventWithNames(uint32_t eventCode, uint32_t source
 {
    va_list args;
    va_start(args, names);
-   bool success = RealPostEvent(&g_eventQueue, nullptr, eventCode, EventOrigin::SYSTEM, 0, sourceId, dciId, nullptr, nullptr, nullptr, format, names, args, nullptr);
+   bool success = RealPostEvent(nullptr, nullptr, eventCode, EventOrigin::SYSTEM, 0, sourceId, dciId, nullptr, nullptr, nullptr, format, names, args, nullptr);
    va_end(args);
    return success;
 }
@@ -1333,7 +1370,7 @@ bool NXCORE_EXPORTABLE PostDciEventWithNames(uint32_t eventCode, uint32_t source
  */
 bool NXCORE_EXPORTABLE PostDciEventWithNames(uint32_t eventCode, uint32_t sourceId, uint32_t dciId, StringMap *parameters)
 {
-   return RealPostEvent(&g_eventQueue, nullptr, eventCode, EventOrigin::SYSTEM, 0, sourceId, dciId, nullptr, nullptr, parameters, nullptr, nullptr, DUMMY_VA_LIST, nullptr);
+   return RealPostEvent(nullptr, nullptr, eventCode, EventOrigin::SYSTEM, 0, sourceId, dciId, nullptr, nullptr, parameters, nullptr, nullptr, DUMMY_VA_LIST, nullptr);
 }
 
 /**
@@ -1364,7 +1401,7 @@ bool NXCORE_EXPORTABLE PostEventWithTagAndNames(uint32_t eventCode, EventOrigin
 {
    va_list args;
    va_start(args, names);
-   bool success = RealPostEvent(&g_eventQueue, nullptr, eventCode, origin, originTimestamp, sourceId, 0, userTag, nullptr, nullptr, format, names, args, nullptr);
+   bool success = RealPostEvent(nullptr, nullptr, eventCode, origin, originTimestamp, sourceId, 0, userTag, nullptr, nullptr, format, names, args, nullptr);
    va_end(args);
    return success;
 }
@@ -1382,7 +1419,7 @@ bool NXCORE_EXPORTABLE PostEventWithTagAndNames(uint32_t eventCode, EventOrigin
 bool NXCORE_EXPORTABLE PostEventWithTagAndNames(uint32_t eventCode, EventOrigin origin, time_t originTimestamp,
          uint32_t sourceId, const TCHAR *tag, StringMap *parameters)
 {
-   return RealPostEvent(&g_eventQueue, nullptr, eventCode, origin, originTimestamp, sourceId, 0, tag, nullptr, parameters, nullptr, nullptr, DUMMY_VA_LIST, nullptr);
+   return RealPostEvent(nullptr, nullptr, eventCode, origin, originTimestamp, sourceId, 0, tag, nullptr, parameters, nullptr, nullptr, DUMMY_VA_LIST, nullptr);
 }
 
 /**
@@ -1398,7 +1435,7 @@ bool NXCORE_EXPORTABLE PostEventWithTagAndNames(uint32_t eventCode, EventOrigin
 bool NXCORE_EXPORTABLE PostEventWithTagsAndNames(uint32_t eventCode, EventOrigin origin, time_t originTimestamp,
          uint32_t sourceId, const StringSet *tags, const StringMap *parameters)
 {
-   return RealPostEvent(&g_eventQueue, nullptr, eventCode, origin, originTimestamp, sourceId, 0, nullptr, tags, parameters, nullptr, nullptr, DUMMY_VA_LIST, nullptr);
+   return RealPostEvent(nullptr, nullptr, eventCode, origin, originTimestamp, sourceId, 0, nullptr, tags, parameters, nullptr, nullptr, DUMMY_VA_LIST, nullptr);
 }
 
 /**
@@ -1429,7 +1466,7 @@ bool NXCORE_EXPORTABLE PostEventWithTag(uint32_t eventCode, EventOrigin origin,
 {
    va_list args;
    va_start(args, format);
-   bool success = RealPostEvent(&g_eventQueue, nullptr, eventCode, origin, originTimestamp, sourceId, 0, userTag, nullptr, nullptr, format, nullptr, args, nullptr);
+   bool success = RealPostEvent(nullptr, nullptr, eventCode, origin, originTimestamp, sourceId, 0, userTag, nullptr, nullptr, format, nullptr, args, nullptr);
    va_end(args);
    return success;
 }
@@ -1454,7 +1491,7 @@ bool NXCORE_EXPORTABLE PostEventWithTag(uint32_t eventCode, EventOrigin origin,
       _sntprintf(name, 64, _T("Parameter%d"), i + 1);
       pmap.set(name, parameters.get(i));
    }
-   return RealPostEvent(&g_eventQueue, nullptr, eventCode, origin, originTimestamp, sourceId, 0, userTag, nullptr, &pmap, nullptr, nullptr, DUMMY_VA_LIST, nullptr);
+   return RealPostEvent(nullptr, nullptr, eventCode, origin, originTimestamp, sourceId, 0, userTag, nullptr, &pmap, nullptr, nullptr, DUMMY_VA_LIST, nullptr);
 }
 
 /**
@@ -1533,7 +1570,7 @@ bool NXCORE_EXPORTABLE PostSystemEventEx(ObjectQueue<Event> *queue, uint32_t eve
 bool NXCORE_EXPORTABLE TransformAndPostEvent(uint32_t eventCode, EventOrigin origin, time_t originTimestamp,
          uint32_t sourceId, const TCHAR *tag, StringMap *parameters, NXSL_VM *vm)
 {
-   return RealPostEvent(&g_eventQueue, nullptr, eventCode, origin, originTimestamp, sourceId, 0, tag, nullptr, parameters, nullptr, nullptr, DUMMY_VA_LIST, vm);
+   return RealPostEvent(nullptr, nullptr, eventCode, origin, originTimestamp, sourceId, 0, tag, nullptr, parameters, nullptr, nullptr, DUMMY_VA_LIST, vm);
 }
 
 /**
@@ -1546,7 +1583,7 @@ bool NXCORE_EXPORTABLE TransformAndPostEvent(uint32_t eventCode, EventOrigin ori
  */
 bool NXCORE_EXPORTABLE TransformAndPostSystemEvent(uint32_t eventCode, uint32_t sourceId, const TCHAR *tag, StringMap *parameters, NXSL_VM *vm)
 {
-   return RealPostEvent(&g_eventQueue, nullptr, eventCode, EventOrigin::SYSTEM, 0, sourceId, 0, tag, nullptr, parameters, nullptr, nullptr, DUMMY_VA_LIST, vm);
+   return RealPostEvent(nullptr, nullptr, eventCode, EventOrigin::SYSTEM, 0, sourceId, 0, tag, nullptr, parameters, nullptr, nullptr, DUMMY_VA_LIST, vm);
 }
 
 /**
@@ -1554,9 +1591,15 @@ bool NXCORE_EXPORTABLE TransformAndPostSystemEvent(uint32_t eventCode, uint32_t
  */
 void NXCORE_EXPORTABLE ResendEvents(ObjectQueue<Event> *queue)
 {
-   Event *e;
-   while ((e = queue->get()) != nullptr)
-      g_eventQueue.put(e);
+   Event *events[64];
+   size_t count;
+   while((count = queue->getAll(events, 64)) > 0)
+   {
+      int64_t now = GetMonotonicClockTimeNs() / 1000;
+      for(size_t i = 0; i < count; i++)
+         events[i]->setQueueTime(now);
+      g_eventQueue.putAll(events, count);
+   }
 }
 
 /**
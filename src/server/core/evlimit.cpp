@@ -0,0 +1,315 @@
+/*
+** NetXMS - Network Management System
+** Copyright (C) 2003-2021 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: evlimit.cpp
+**
+**/
+
+#include "nxcore.h"
+
+#define DEBUG_TAG _T("event.limit")
+
+/**
+ * Token bucket for event rate limiting. Tokens are counted in thousandths of event,
+ * so bucket with rate of N events per second gains N tokens every millisecond.
+ */
+struct EventTokenBucket
+{
+   int64_t tokens;
+   int64_t lastRefillTime;
+
+   EventTokenBucket(int64_t capacity, int64_t now)
+   {
+      tokens = capacity;
+      lastRefillTime = now;
+   }
+
+   /**
+    * Refill bucket and check if it is full (idle)
+    */
+   bool refill(int64_t now, uint32_t rate, int64_t capacity)
+   {
+      if (now > lastRefillTime)
+      {
+         tokens = std::min(tokens + (now - lastRefillTime) * rate, capacity);
+         lastRefillTime = now;
+      }
+      return tokens >= capacity;
+   }
+
+   /**
+    * Refill bucket and check if at least one token is available
+    */
+   bool hasToken(int64_t now, uint32_t rate, int64_t capacity)
+   {
+      refill(now, rate, capacity);
+      return tokens >= 1000;
+   }
+
+   /**
+    * Take one token from bucket (caller should check that token is available)
+    */
+   void consume()
+   {
+      tokens -= 1000;
+   }
+};
+
+/**
+ * Counter for suppressed events with same source and event code
+ */
+struct SuppressedEventCounter
+{
+   uint32_t sourceId;
+   uint32_t eventCode;
+   uint32_t count;
+};
+
+/**
+ * Rate limiter configuration (rates are in events per second, 0 means no limit)
+ */
+static uint32_t s_sourceRate = 0;
+static uint32_t s_eventCodeRate = 0;
+static uint32_t s_burstSize = 50;
+static uint32_t s_summaryInterval = 60;
+
+/**
+ * Token buckets
+ */
+static HashMap<uint32_t, EventTokenBucket> s_sourceBuckets(Ownership::True);
+static HashMap<uint32_t, EventTokenBucket> s_eventCodeBuckets(Ownership::True);
+static HashMap<uint64_t, SuppressedEventCounter> s_suppressedEvents(Ownership::True);
+static Mutex s_lock(true);
+
+/**
+ * Statistics
+ */
+static VolatileCounter64 s_suppressedBySource = 0;
+static VolatileCounter64 s_suppressedByEventCode = 0;
+static VolatileCounter64 s_summaryEvents = 0;
+
+/**
+ * Get bucket capacity (in thousandths of event)
+ */
+static inline int64_t BucketCapacity()
+{
+   return static_cast<int64_t>(std::max(s_burstSize, 1u)) * 1000;
+}
+
+/**
+ * Get token bucket for given key, creating new one if needed
+ */
+static EventTokenBucket *GetTokenBucket(HashMap<uint32_t, EventTokenBucket> *buckets, uint32_t key, int64_t now)
+{
+   EventTokenBucket *bucket = buckets->get(key);
+   if (bucket == nullptr)
+   {
+      bucket = new EventTokenBucket(BucketCapacity(), now);
+      buckets->set(key, bucket);
+   }
+   return bucket;
+}
+
+/**
+ * Check if given event code is exempt from rate limiting. These events mark state transitions
+ * that server logic or users rely on, and should never be suppressed.
+ */
+static inline bool IsExemptEventCode(uint32_t eventCode)
+{
+   switch(eventCode)
+   {
+      case EVENT_DB_CONNECTION_LOST:
+      case EVENT_DB_CONNECTION_RESTORED:
+      case EVENT_EVENT_STORM_DETECTED:
+      case EVENT_EVENT_STORM_ENDED:
+      case EVENT_EVENTS_SUPPRESSED:
+      case EVENT_MAINTENANCE_MODE_ENTERED:
+      case EVENT_MAINTENANCE_MODE_LEFT:
+      case EVENT_SERVER_STARTED:
+         return true;
+      default:
+         return false;
+   }
+}
+
+/**
+ * Check if event with given code from given source is within configured rate limits.
+ * Returns true if event should be posted and false if it should be suppressed. Suppressed
+ * events are counted and reported periodically by SYS_EVENTS_SUPPRESSED summary events.
+ */
+bool CheckEventRateLimit(uint32_t eventCode, uint32_t sourceId)
+{
+   if (((s_sourceRate == 0) && (s_eventCodeRate == 0)) || IsExemptEventCode(eventCode))
+      return true;
+
+   int64_t now = GetCurrentTimeMs();
+   int64_t capacity = BucketCapacity();
+   bool allowed = true;
+
+   s_lock.lock();
+
+   // Both buckets are checked before taking tokens, so that event rejected by one limit
+   // does not consume token from another one
+   EventTokenBucket *sourceBucket = (s_sourceRate != 0) ? GetTokenBucket(&s_sourceBuckets, sourceId, now) : nullptr;
+   EventTokenBucket *eventCodeBucket = (s_eventCodeRate != 0) ? GetTokenBucket(&s_eventCodeBuckets, eventCode, now) : nullptr;
+   if ((sourceBucket != nullptr) && !sourceBucket->hasToken(now, s_sourceRate, capacity))
+   {
+      InterlockedIncrement64(&s_suppressedBySource);
+      allowed = false;
+   }
+   else if ((eventCodeBucket != nullptr) && !eventCodeBucket->hasToken(now, s_eventCodeRate, capacity))
+   {
+      InterlockedIncrement64(&s_suppressedByEventCode);
+      allowed = false;
+   }
+   else
+   {
+      if (sourceBucket != nullptr)
+         sourceBucket->consume();
+      if (eventCodeBucket != nullptr)
+         eventCodeBucket->consume();
+   }
+
+   if (!allowed)
+   {
+      uint64_t key = (static_cast<uint64_t>(sourceId) << 32) | eventCode;
+      SuppressedEventCounter *counter = s_suppressedEvents.get(key);
+      if (counter == nullptr)
+      {
+         counter = new SuppressedEventCounter;
+         counter->sourceId = sourceId;
+         counter->eventCode = eventCode;
+         counter->count = 0;
+         s_suppressedEvents.set(key, counter);
+      }
+      counter->count++;
+   }
+   s_lock.unlock();
+
+   return allowed;
+}
+
+/**
+ * Remove idle buckets (ones that are completely refilled)
+ */
+static void RemoveIdleBuckets(HashMap<uint32_t, EventTokenBucket> *buckets, uint32_t rate, int64_t now, int64_t capacity)
+{
+   auto it = buckets->iterator();
+   while(it->hasNext())
+   {
+      EventTokenBucket *bucket = it->next();
+      if ((rate == 0) || bucket->refill(now, rate, capacity))
+         it->remove();
+   }
+   delete it;
+}
+
+/**
+ * Send summary events for suppressed events and cleanup idle token buckets
+ */
+static void SendSuppressedEventsSummary()
+{
+   s_lock.lock();
+   ObjectArray<SuppressedEventCounter> counters(s_suppressedEvents.size(), 16, Ownership::True);
+   auto it = s_suppressedEvents.iterator();
+   while(it->hasNext())
+   {
+      counters.add(it->next());
+      it->unlink();
+   }
+   delete it;
+
+   int64_t now = GetCurrentTimeMs();
+   int64_t capacity = BucketCapacity();
+   RemoveIdleBuckets(&s_sourceBuckets, s_sourceRate, now, capacity);
+   RemoveIdleBuckets(&s_eventCodeBuckets, s_eventCodeRate, now, capacity);
+   s_lock.unlock();
+
+   static const TCHAR *names[] = { _T("eventCode"), _T("eventName"), _T("count"), _T("period") };
+   for(int i = 0; i < counters.size(); i++)
+   {
+      SuppressedEventCounter *c = counters.get(i);
+      TCHAR eventName[MAX_EVENT_NAME];
+      if (!EventNameFromCode(c->eventCode, eventName))
+         _sntprintf(eventName, MAX_EVENT_NAME, _T("%u"), c->eventCode);
+      uint32_t sourceId = (FindObjectById(c->sourceId) != nullptr) ? c->sourceId : g_dwMgmtNode;
+      nxlog_debug_tag(DEBUG_TAG, 5, _T("%u events %s from object [%u] suppressed in last %u seconds"), c->count, eventName, c->sourceId, s_summaryInterval);
+      PostSystemEventWithNames(EVENT_EVENTS_SUPPRESSED, sourceId, "dsdd", names, c->eventCode, eventName, c->count, s_summaryInterval);
+      InterlockedIncrement64(&s_summaryEvents);
+   }
+
+   if (!IsShutdownInProgress())
+      ThreadPoolScheduleRelative(g_mainThreadPool, s_summaryInterval * 1000, SendSuppressedEventsSummary);
+}
+
+/**
+ * Initialize event rate limiter
+ */
+void InitEventRateLimiter()
+{
+   s_sourceRate = ConfigReadULong(_T("Events.RateLimit.PerSource"), 0);
+   s_eventCodeRate = ConfigReadULong(_T("Events.RateLimit.PerEventCode"), 0);
+   s_burstSize = ConfigReadULong(_T("Events.RateLimit.BurstSize"), 50);
+   s_summaryInterval = std::max(ConfigReadULong(_T("Events.RateLimit.SummaryInterval"), 60), 1u);
+   nxlog_debug_tag(DEBUG_TAG, 2, _T("Event rate limits: source=%u/s eventCode=%u/s burst=%u summaryInterval=%us"),
+            s_sourceRate, s_eventCodeRate, s_burstSize, s_summaryInterval);
+   ThreadPoolScheduleRelative(g_mainThreadPool, s_summaryInterval * 1000, SendSuppressedEventsSummary);
+}
+
+/**
+ * Handler for event rate limiter configuration changes (new summary interval is applied after current one ends)
+ */
+void OnEventRateLimitConfigurationChange(const TCHAR *name, const TCHAR *value)
+{
+   s_lock.lock();
+   if (!_tcscmp(name, _T("Events.RateLimit.PerSource")))
+   {
+      s_sourceRate = _tcstoul(value, nullptr, 0);
+   }
+   else if (!_tcscmp(name, _T("Events.RateLimit.PerEventCode")))
+   {
+      s_eventCodeRate = _tcstoul(value, nullptr, 0);
+   }
+   else if (!_tcscmp(name, _T("Events.RateLimit.BurstSize")))
+   {
+      s_burstSize = _tcstoul(value, nullptr, 0);
+   }
+   else if (!_tcscmp(name, _T("Events.RateLimit.SummaryInterval")))
+   {
+      s_summaryInterval = std::max(static_cast<uint32_t>(_tcstoul(value, nullptr, 0)), 1u);
+   }
+   s_lock.unlock();
+   nxlog_debug_tag(DEBUG_TAG, 2, _T("Event rate limits changed: source=%u/s eventCode=%u/s burst=%u summaryInterval=%us"),
+            s_sourceRate, s_eventCodeRate, s_burstSize, s_summaryInterval);
+}
+
+/**
+ * Get event rate limiter statistics
+ */
+void GetEventRateLimiterStats(EventRateLimiterStats *stats)
+{
+   stats->suppressedBySource = s_suppressedBySource;
+   stats->suppressedByEventCode = s_suppressedByEventCode;
+   stats->summaryEvents = s_summaryEvents;
+   s_lock.lock();
+   stats->sourceBuckets = static_cast<uint32_t>(s_sourceBuckets.size());
+   stats->eventCodeBuckets = static_cast<uint32_t>(s_eventCodeBuckets.size());
+   s_lock.unlock();
+   stats->sourceRate = s_sourceRate;
+   stats->eventCodeRate = s_eventCodeRate;
+}
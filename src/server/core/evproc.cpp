@@ -27,6 +27,8 @@
 
 #define MAX_DB_QUERY_FAILED_EVENTS     30
 
+#define EVENT_BATCH_SIZE               64
+
 /**
  * Number of processed events since start
  */
@@ -36,7 +38,8 @@ VolatileCounter64 g_totalEventsProcessed = 0;
  * Static data
  */
 static THREAD s_threadStormDetector = INVALID_THREAD_HANDLE;
-static THREAD s_threadLogger = INVALID_THREAD_HANDLE;
+static THREAD *s_loggerThreads = nullptr;
+static int s_loggerThreadCount = 0;
 static ObjectQueue<Event> s_loggerQueue(4096, Ownership::True);
 
 /**
@@ -98,6 +101,13 @@ static void EventStormDetector()
  */
 static time_t s_dbQueryFailedTimestamps[MAX_DB_QUERY_FAILED_EVENTS];
 static int s_dbQueryFailedTimestampPos = 0;
+static Mutex s_dbQueryFailedTimestampsLock(true);
+
+/**
+ * Event log writer statistics
+ */
+static EventLogWriterStats s_eventLogWriterStats;
+static Mutex s_eventLogWriterStatsLock(true);
 
 /**
  * Check that event can be written to database
@@ -110,6 +120,7 @@ static bool IsEventWriteAllowed(Event *event)
    {
       time_t now = time(nullptr);
       bool allow = false;
+      s_dbQueryFailedTimestampsLock.lock();
       for(int i = 0; i < MAX_DB_QUERY_FAILED_EVENTS; i++)
       {
          if (s_dbQueryFailedTimestamps[i] < now - 60)
@@ -121,131 +132,321 @@ static bool IsEventWriteAllowed(Event *event)
       s_dbQueryFailedTimestamps[s_dbQueryFailedTimestampPos++] = event->getTimestamp();
       if (s_dbQueryFailedTimestampPos == MAX_DB_QUERY_FAILED_EVENTS)
          s_dbQueryFailedTimestampPos = 0;
+      s_dbQueryFailedTimestampsLock.unlock();
       if (!allow)
+      {
          nxlog_debug_tag(DEBUG_TAG, 5, _T("EventLogger: event %s with ID ") UINT64_FMT _T(" dropped by rate limiter"), event->getName(), event->getId());
+         s_eventLogWriterStatsLock.lock();
+         s_eventLogWriterStats.droppedEvents++;
+         s_eventLogWriterStatsLock.unlock();
+      }
       return allow;
    }
    return true;
 }
 
 /**
- * Write event
+ * Serialize event to compact JSON (returned string should be freed by caller)
  */
-static inline void WriteEvent(DB_STATEMENT hStmt, Event *event)
+static char *EventToJson(Event *event)
 {
-   DBBind(hStmt, 1, DB_SQLTYPE_BIGINT, event->getId());
-   DBBind(hStmt, 2, DB_SQLTYPE_INTEGER, event->getCode());
-   DBBind(hStmt, 3, DB_SQLTYPE_INTEGER, static_cast<UINT32>(event->getTimestamp()));
-   DBBind(hStmt, 4, DB_SQLTYPE_INTEGER, static_cast<INT32>(event->getOrigin()));
-   DBBind(hStmt, 5, DB_SQLTYPE_INTEGER, static_cast<UINT32>(event->getOriginTimestamp()));
-   DBBind(hStmt, 6, DB_SQLTYPE_INTEGER, event->getSourceId());
-   DBBind(hStmt, 7, DB_SQLTYPE_INTEGER, event->getZoneUIN());
-   DBBind(hStmt, 8, DB_SQLTYPE_INTEGER, event->getDciId());
-   DBBind(hStmt, 9, DB_SQLTYPE_INTEGER, event->getSeverity());
-   DBBind(hStmt, 10, DB_SQLTYPE_VARCHAR, event->getMessage(), DB_BIND_STATIC, MAX_EVENT_MSG_LENGTH);
-   DBBind(hStmt, 11, DB_SQLTYPE_BIGINT, event->getRootId());
-   DBBind(hStmt, 12, DB_SQLTYPE_VARCHAR, event->getTagsAsList(), DB_BIND_TRANSIENT, 2000);
-   DBBind(hStmt, 13, DB_SQLTYPE_TEXT, event->toJson(), DB_BIND_DYNAMIC);
-   DBExecute(hStmt);
-   nxlog_debug_tag(DEBUG_TAG, 8, _T("EventLogger: DBExecute: id=%d,code=%d"), (int)event->getId(), (int)event->getCode());
+   json_t *json = event->toJson();
+   char *jsonText = json_dumps(json, JSON_COMPACT | JSON_EMBED);
+   json_decref(json);
+   return jsonText;
 }
 
 /**
- * Event logger
+ * Column list for event_log inserts
+ */
+#define EVENT_LOG_COLUMNS _T("event_id,event_code,event_timestamp,origin,origin_timestamp,event_source,zone_uin,dci_id,event_severity,event_message,root_event_id,event_tags,raw_data")
+
+/**
+ * Write batch of events using bulk load (COPY on PostgreSQL). Returns false on failure,
+ * in which case transaction is rolled back and caller should write batch using INSERT statements.
+ */
+static bool BulkLoadEvents(DB_HANDLE hdb, Event **batch, int count, bool convertTimestamps)
+{
+   if (!DBBegin(hdb))
+      return false;
+
+   DB_BULK_LOAD hLoad = DBBulkLoadBegin(hdb, _T("event_log"), EVENT_LOG_COLUMNS, 13);
+   if (hLoad == nullptr)
+   {
+      DBRollback(hdb);
+      return false;
+   }
+
+   TCHAR id[32], code[16], timestamp[32], origin[16], originTimestamp[16], source[16], zoneUIN[16], dciId[16], severity[16], rootId[32];
+   const TCHAR *values[13] = { id, code, timestamp, origin, originTimestamp, source, zoneUIN, dciId, severity, nullptr, rootId, nullptr, nullptr };
+   bool success = true;
+   for(int i = 0; (i < count) && success; i++)
+   {
+      Event *event = batch[i];
+      _sntprintf(id, 32, UINT64_FMT, event->getId());
+      _sntprintf(code, 16, _T("%u"), event->getCode());
+      time_t t = event->getTimestamp();
+      if (convertTimestamps)
+      {
+         struct tm tmbuff;
+         _tcsftime(timestamp, 32, _T("%Y-%m-%d %H:%M:%S+00"), gmtime_r(&t, &tmbuff));
+      }
+      else
+      {
+         _sntprintf(timestamp, 32, _T("%u"), static_cast<unsigned int>(t));
+      }
+      _sntprintf(origin, 16, _T("%d"), static_cast<int32_t>(event->getOrigin()));
+      _sntprintf(originTimestamp, 16, _T("%u"), static_cast<uint32_t>(event->getOriginTimestamp()));
+      _sntprintf(source, 16, _T("%u"), event->getSourceId());
+      _sntprintf(zoneUIN, 16, _T("%u"), event->getZoneUIN());
+      _sntprintf(dciId, 16, _T("%u"), event->getDciId());
+      _sntprintf(severity, 16, _T("%d"), event->getSeverity());
+      _sntprintf(rootId, 32, UINT64_FMT, event->getRootId());
+
+      StringBuffer message(event->getMessage());
+      if (message.length() > MAX_EVENT_MSG_LENGTH)
+         message.shrink(message.length() - MAX_EVENT_MSG_LENGTH);
+      StringBuffer tags(event->getTagsAsList());
+      if (tags.length() > 2000)
+         tags.shrink(tags.length() - 2000);
+      char *jsonText = EventToJson(event);
+      TCHAR *rawData = TStringFromUTF8String(CHECK_NULL_EX_A(jsonText));
+      MemFree(jsonText);
+
+      values[9] = message;
+      values[11] = tags;
+      values[12] = rawData;
+      success = DBBulkLoadAddRow(hLoad, values);
+      MemFree(rawData);
+   }
+
+   if (success)
+   {
+      success = DBBulkLoadEnd(hLoad);
+   }
+   else
+   {
+      DBBulkLoadCancel(hLoad);
+   }
+
+   if (success)
+   {
+      success = DBCommit(hdb);
+   }
+   else
+   {
+      DBRollback(hdb);
+   }
+   return success;
+}
+
+/**
+ * Write batch of events using multi-row INSERT statements in single transaction. Returns false on failure,
+ * in which case transaction is rolled back.
+ */
+static bool InsertEventsMultiRow(DB_HANDLE hdb, Event **batch, int count, bool convertTimestamps, int maxRecordsPerStmt)
+{
+   if (!DBBegin(hdb))
+      return false;
+
+   const TCHAR *queryBase = _T("INSERT INTO event_log (") EVENT_LOG_COLUMNS _T(") VALUES");
+   StringBuffer query(queryBase);
+   query.setAllocationStep(65536);
+
+   bool success = true;
+   int countStmt = 0;
+   for(int i = 0; (i < count) && success; i++)
+   {
+      Event *event = batch[i];
+      TCHAR data[256];
+      _sntprintf(data, 256, convertTimestamps ? _T("%c(") UINT64_FMT _T(",%u,to_timestamp(%u),%d,%u,%u,%u,%u,%d,") : _T("%c(") UINT64_FMT _T(",%u,%u,%d,%u,%u,%u,%u,%d,"),
+               (countStmt > 0) ? _T(',') : _T(' '), event->getId(), event->getCode(), static_cast<uint32_t>(event->getTimestamp()),
+               static_cast<int32_t>(event->getOrigin()), static_cast<uint32_t>(event->getOriginTimestamp()), event->getSourceId(),
+               event->getZoneUIN(), event->getDciId(), event->getSeverity());
+      query.append(data);
+      query.append(DBPrepareString(hdb, event->getMessage(), MAX_EVENT_MSG_LENGTH));
+      query.append(_T(','));
+      query.append(event->getRootId());
+      query.append(_T(','));
+      query.append(DBPrepareString(hdb, event->getTagsAsList(), 2000));
+      query.append(_T(','));
+      char *jsonText = EventToJson(event);
+      query.append(DBPrepareStringUTF8(hdb, jsonText));
+      MemFree(jsonText);
+      query.append(_T(')'));
+      countStmt++;
+
+      if (countStmt >= maxRecordsPerStmt)
+      {
+         success = DBQuery(hdb, query);
+         query = queryBase;
+         countStmt = 0;
+      }
+   }
+   if (success && (countStmt > 0))
+      success = DBQuery(hdb, query);
+
+   if (success)
+   {
+      success = DBCommit(hdb);
+   }
+   else
+   {
+      DBRollback(hdb);
+   }
+   return success;
+}
+
+/**
+ * Write batch of events one by one using prepared statement. Each event is written in separate
+ * implicit transaction, so failure to write one event will not affect others.
+ */
+static void InsertEventsPrepared(DB_HANDLE hdb, Event **batch, int count, bool convertTimestamps)
+{
+   DB_STATEMENT hStmt = DBPrepare(hdb,
+            convertTimestamps ?
+               _T("INSERT INTO event_log (") EVENT_LOG_COLUMNS _T(") VALUES (?,?,to_timestamp(?),?,?,?,?,?,?,?,?,?,?)") :
+               _T("INSERT INTO event_log (") EVENT_LOG_COLUMNS _T(") VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?)"), count > 1);
+   if (hStmt == nullptr)
+      return;
+
+   for(int i = 0; i < count; i++)
+   {
+      Event *event = batch[i];
+      DBBind(hStmt, 1, DB_SQLTYPE_BIGINT, event->getId());
+      DBBind(hStmt, 2, DB_SQLTYPE_INTEGER, event->getCode());
+      DBBind(hStmt, 3, DB_SQLTYPE_INTEGER, static_cast<uint32_t>(event->getTimestamp()));
+      DBBind(hStmt, 4, DB_SQLTYPE_INTEGER, static_cast<int32_t>(event->getOrigin()));
+      DBBind(hStmt, 5, DB_SQLTYPE_INTEGER, static_cast<uint32_t>(event->getOriginTimestamp()));
+      DBBind(hStmt, 6, DB_SQLTYPE_INTEGER, event->getSourceId());
+      DBBind(hStmt, 7, DB_SQLTYPE_INTEGER, event->getZoneUIN());
+      DBBind(hStmt, 8, DB_SQLTYPE_INTEGER, event->getDciId());
+      DBBind(hStmt, 9, DB_SQLTYPE_INTEGER, event->getSeverity());
+      DBBind(hStmt, 10, DB_SQLTYPE_VARCHAR, event->getMessage(), DB_BIND_STATIC, MAX_EVENT_MSG_LENGTH);
+      DBBind(hStmt, 11, DB_SQLTYPE_BIGINT, event->getRootId());
+      DBBind(hStmt, 12, DB_SQLTYPE_VARCHAR, event->getTagsAsList(), DB_BIND_TRANSIENT, 2000);
+      DBBind(hStmt, 13, DB_SQLTYPE_TEXT, DB_CTYPE_UTF8_STRING, EventToJson(event), DB_BIND_DYNAMIC);
+      DBExecute(hStmt);
+      nxlog_debug_tag(DEBUG_TAG, 8, _T("EventLogger: DBExecute: id=") UINT64_FMT _T(",code=%u"), event->getId(), event->getCode());
+   }
+   DBFreeStatement(hStmt);
+}
+
+/**
+ * Write batch of events to database
+ */
+static void WriteEventBatch(Event **batch, int count, int maxRecordsPerStmt)
+{
+   int64_t startTime = GetCurrentTimeMs();
+   bool convertTimestamps = (g_dbSyntax == DB_SYNTAX_TSDB);
+
+   DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+   bool success = false;
+   if ((count > 1) && DBIsBulkLoadSupported(hdb))
+   {
+      success = BulkLoadEvents(hdb, batch, count, convertTimestamps);
+      if (!success)
+         nxlog_debug_tag(DEBUG_TAG, 6, _T("EventLogger: bulk load failed, falling back to INSERT for %d events"), count);
+   }
+   if (!success && (count > 1))
+   {
+      // Multi-row VALUES clause is not supported by Oracle, DB2, and Informix
+      int syntax = DBGetSyntax(hdb);
+      if ((syntax == DB_SYNTAX_MYSQL) || (syntax == DB_SYNTAX_PGSQL) || (syntax == DB_SYNTAX_TSDB) ||
+          (syntax == DB_SYNTAX_SQLITE) || (syntax == DB_SYNTAX_MSSQL))
+      {
+         success = InsertEventsMultiRow(hdb, batch, count, convertTimestamps, maxRecordsPerStmt);
+         if (!success)
+            nxlog_debug_tag(DEBUG_TAG, 6, _T("EventLogger: multi-row INSERT failed, falling back to single row inserts for %d events"), count);
+      }
+   }
+   if (!success)
+      InsertEventsPrepared(hdb, batch, count, convertTimestamps);
+   DBConnectionPoolReleaseConnection(hdb);
+
+   uint32_t elapsedTime = static_cast<uint32_t>(GetCurrentTimeMs() - startTime);
+   s_eventLogWriterStatsLock.lock();
+   s_eventLogWriterStats.writtenEvents += count;
+   s_eventLogWriterStats.batches++;
+   s_eventLogWriterStats.totalWriteTime += elapsedTime;
+   if (elapsedTime > s_eventLogWriterStats.maxBatchWriteTime)
+      s_eventLogWriterStats.maxBatchWriteTime = elapsedTime;
+   s_eventLogWriterStatsLock.unlock();
+   nxlog_debug_tag(DEBUG_TAG, 7, _T("EventLogger: %d events written in %u ms"), count, elapsedTime);
+}
+
+/**
+ * Event logger. Multiple logger threads can be running in parallel, each writing batch of events
+ * currently available in the queue in single transaction.
  */
 static void EventLogger()
 {
    ThreadSetName("EventLogger");
 
-   while(true)
+   int maxRecordsPerTxn = ConfigReadInt(_T("DBWriter.MaxRecordsPerTransaction"), 1000);
+   int maxRecordsPerStmt = ConfigReadInt(_T("DBWriter.MaxRecordsPerStatement"), 100);
+   if (maxRecordsPerTxn < 1)
+      maxRecordsPerTxn = 1;
+   if (maxRecordsPerStmt < 1)
+      maxRecordsPerStmt = 1;
+
+   Event **batch = MemAllocArrayNoInit<Event*>(maxRecordsPerTxn);
+   bool shutdown = false;
+   while(!shutdown)
    {
       Event *event = s_loggerQueue.getOrBlock();
       if (event == INVALID_POINTER_VALUE)
          break;   // Shutdown indicator
 
-      if (!IsEventWriteAllowed(event))
+      uint64_t queueSize = s_loggerQueue.size();
+      s_eventLogWriterStatsLock.lock();
+      if (queueSize > s_eventLogWriterStats.maxQueueSize)
+         s_eventLogWriterStats.maxQueueSize = queueSize;
+      s_eventLogWriterStatsLock.unlock();
+
+      int count = 0;
+      while(true)
       {
-         delete event;
-         continue;
+         if (IsEventWriteAllowed(event))
+            batch[count++] = event;
+         else
+            delete event;
+
+         if (count == maxRecordsPerTxn)
+            break;
+
+         event = s_loggerQueue.get();
+         if (event == nullptr)
+            break;
+         if (event == INVALID_POINTER_VALUE)
+         {
+            shutdown = true;
+            break;
+         }
       }
 
-		DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
-		int syntaxId = DBGetSyntax(hdb);
-		if (syntaxId == DB_SYNTAX_SQLITE)
-		{ 
-         StringBuffer query = _T("INSERT INTO event_log (event_id,event_code,event_timestamp,event_source,zone_uin,origin,")
-                        _T("origin_timestamp,dci_id,event_severity,event_message,root_event_id,event_tags,raw_data) VALUES (");
-         query.append(event->getId());
-         query.append(_T(','));
-         query.append(event->getCode());
-         query.append(_T(','));
-         query.append((UINT32)event->getTimestamp());
-         query.append(_T(','));
-         query.append(event->getSourceId());
-         query.append(_T(','));
-         query.append(event->getZoneUIN());
-         query.append(_T(','));
-         query.append(static_cast<int32_t>(event->getOrigin()));
-         query.append(_T(','));
-         query.append(static_cast<uint32_t>(event->getOriginTimestamp()));
-         query.append(_T(','));
-         query.append(event->getDciId());
-         query.append(_T(','));
-         query.append(event->getSeverity());
-         query.append(_T(','));
-         query.append(DBPrepareString(hdb, event->getMessage(), MAX_EVENT_MSG_LENGTH));
-         query.append(_T(','));
-         query.append(event->getRootId());
-         query.append(_T(','));
-         query.append(DBPrepareString(hdb, event->getTagsAsList(), 2000));
-         query.append(_T(','));
-         json_t *json = event->toJson();
-         char *jsonText = json_dumps(json, JSON_INDENT(3) | JSON_EMBED);
-         query.append(DBPrepareStringUTF8(hdb, jsonText));
-         MemFree(jsonText);
-         json_decref(json);
-         query.append(_T(')'));
-
-         DBQuery(hdb, query);
-         nxlog_debug_tag(DEBUG_TAG, 8, _T("EventLogger: DBQuery: id=%d,code=%d"), (int)event->getId(), (int)event->getCode());
-			delete event;
-		}
-		else
-		{
-			DB_STATEMENT hStmt = DBPrepare(hdb,
-			         (g_dbSyntax == DB_SYNTAX_TSDB) ?
-                        _T("INSERT INTO event_log (event_id,event_code,event_timestamp,origin,")
-                        _T("origin_timestamp,event_source,zone_uin,dci_id,event_severity,event_message,root_event_id,event_tags,raw_data) ")
-                        _T("VALUES (?,?,to_timestamp(?),?,?,?,?,?,?,?,?,?,?)") :
-                        _T("INSERT INTO event_log (event_id,event_code,event_timestamp,origin,")
-                        _T("origin_timestamp,event_source,zone_uin,dci_id,event_severity,event_message,root_event_id,event_tags,raw_data) ")
-                        _T("VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?)"), true);
-			if (hStmt != nullptr)
-			{
-			   WriteEvent(hStmt, event);
-			   delete event;
-            event = s_loggerQueue.getOrBlock(500);
-			   while((event != nullptr) && (event != INVALID_POINTER_VALUE))
-				{
-				   if (IsEventWriteAllowed(event))
-				   {
-		            WriteEvent(hStmt, event);
-				   }
-					delete event;
-					event = s_loggerQueue.getOrBlock(500);
-				}
-				DBFreeStatement(hStmt);
-			}
-			else
-			{
-				delete event;
-			}
-		}
+      if (count > 0)
+      {
+         WriteEventBatch(batch, count, maxRecordsPerStmt);
+         for(int i = 0; i < count; i++)
+            delete batch[i];
+      }
+   }
+   MemFree(batch);
+}
 
-		DBConnectionPoolReleaseConnection(hdb);
-		if (event == INVALID_POINTER_VALUE)
-         break;   // Shutdown indicator (need second check if got it in inner loop)
-	}
+/**
+ * Stop all event log writer threads. Events already in the queue will be written before threads exit.
+ */
+static void StopEventLogWriters()
+{
+   for(int i = 0; i < s_loggerThreadCount; i++)
+      s_loggerQueue.put(INVALID_POINTER_VALUE);
+   for(int i = 0; i < s_loggerThreadCount; i++)
+      ThreadJoin(s_loggerThreads[i]);
+   MemFree(s_loggerThreads);
+   s_loggerThreads = nullptr;
+   s_loggerThreadCount = 0;
 }
 
 /**
@@ -277,6 +478,7 @@ static void ProcessEvent(Event *event, int processorId)
    {
       nxlog_debug_tag(DEBUG_TAG, 7, _T("Running event processor hook script"));
       vm->setGlobalVariable("$event", vm->createValue(new NXSL_Object(vm, &g_nxslEventClass, event, true)));
+      PerfScopedTimer perfTimer(PerfHotPath::SCRIPT_EXECUTION, sourceObject->getId());
       if (!vm->run())
       {
          if (event->getCode() != EVENT_SCRIPT_ERROR) // To avoid infinite loop
@@ -304,6 +506,7 @@ static void ProcessEvent(Event *event, int processorId)
    // Pass event through event processing policy if it is not correlated
    if (event->getRootId() == 0)
    {
+      PerfScopedTimer perfTimer(PerfHotPath::EVENT_PROCESSING, event->getSourceId());
       g_pEventPolicy->processEvent(event);
       nxlog_debug_tag(DEBUG_TAG, 7, _T("Event ") UINT64_FMT _T(" with code %d passed event processing policy"), event->getId(), event->getCode());
    }
@@ -323,6 +526,23 @@ static void ProcessEvent(Event *event, int processorId)
    InterlockedIncrement64(&g_totalEventsProcessed);
 }
 
+/**
+ * Wait time histogram for main event queue
+ */
+static LatencyHistogram s_eventQueueWaitTime;
+
+/**
+ * Destroy events left in processing batch after shutdown indicator
+ */
+static void DiscardEvents(Event **events, size_t count)
+{
+   for(size_t i = 0; i < count; i++)
+   {
+      if (events[i] != INVALID_POINTER_VALUE)
+         delete events[i];
+   }
+}
+
 /**
  * Event processing thread for serial processing
  */
@@ -332,25 +552,35 @@ static void SerialEventProcessor()
 
    nxlog_write_tag(NXLOG_INFO, DEBUG_TAG, _T("Parallel event processing disabled"));
 
-   while(true)
+   Event *events[EVENT_BATCH_SIZE];
+   bool shutdown = false;
+   while(!shutdown)
    {
-      Event *event = g_eventQueue.getOrBlock();
-      if (event == INVALID_POINTER_VALUE)
-         break;   // Shutdown indicator
-
-      if (g_flags & AF_EVENT_STORM_DETECTED)
+      size_t count = g_eventQueue.getAllOrBlock(events, EVENT_BATCH_SIZE);
+      for(size_t i = 0; i < count; i++)
       {
-         delete event;
-         InterlockedIncrement64(&g_totalEventsProcessed);
-         continue;
-      }
+         Event *event = events[i];
+         if (event == INVALID_POINTER_VALUE)
+         {
+            shutdown = true;   // Shutdown indicator
+            DiscardEvents(&events[i + 1], count - i - 1);
+            break;
+         }
 
-      ProcessEvent(event, 0);
+         s_eventQueueWaitTime.update(GetMonotonicClockTimeNs() / 1000 - event->getQueueTime());
+         if (g_flags & AF_EVENT_STORM_DETECTED)
+         {
+            delete event;
+            InterlockedIncrement64(&g_totalEventsProcessed);
+            continue;
+         }
+
+         ProcessEvent(event, 0);
+      }
    }
 
-   s_loggerQueue.put(INVALID_POINTER_VALUE);
+   StopEventLogWriters();
    ThreadJoin(s_threadStormDetector);
-   ThreadJoin(s_threadLogger);
    nxlog_debug_tag(DEBUG_TAG, 1, _T("Event processing thread stopped"));
 }
 
@@ -362,7 +592,7 @@ struct EventQueueBinding
    UT_hash_handle hh;
    size_t keyLength;
    char key[128];
-   ObjectQueue<Event> *queue;
+   ObjectMPSCQueue<Event> *queue;
    VolatileCounter usage;
    int processingThread;
 };
@@ -372,12 +602,13 @@ struct EventQueueBinding
  */
 struct EventProcessingThread
 {
-   ObjectQueue<Event> queue;
+   ObjectMPSCQueue<Event> queue;
    THREAD thread;
    uint64_t processedEvents;
    int64_t averageWaitTime;
    uint64_t maxWaitTime;
    uint32_t bindings;
+   LatencyHistogram waitTimeHistogram;
 
    EventProcessingThread() : queue(4096, Ownership::True)
    {
@@ -402,20 +633,36 @@ void EventProcessingThread::run(int id)
    snprintf(tname, 32, "EP-%d", id);
    ThreadSetName(tname);
 
+   Event *events[EVENT_BATCH_SIZE];
    while(true)
    {
-      Event *event = queue.getOrBlock();
-      if (event == INVALID_POINTER_VALUE)
-         break;   // Shutdown indicator
+      size_t count = queue.getAllOrBlock(events, EVENT_BATCH_SIZE);
+      for(size_t i = 0; i < count; i++)
+      {
+         Event *event = events[i];
+         if (event == INVALID_POINTER_VALUE)
+         {
+            // Shutdown indicator, release remaining events from current batch
+            for(size_t j = i + 1; j < count; j++)
+            {
+               if (events[j] != INVALID_POINTER_VALUE)
+                  InterlockedDecrement(&events[j]->getQueueBinding()->usage);
+            }
+            DiscardEvents(&events[i + 1], count - i - 1);
+            return;
+         }
 
-      int64_t waitTime = GetCurrentTimeMs() - event->getQueueTime();
-      UpdateExpMovingAverage(averageWaitTime, EMA_EXP_180, waitTime);
-      if (static_cast<uint32_t>(waitTime) > maxWaitTime)
-         maxWaitTime = static_cast<uint32_t>(waitTime);
-      EventQueueBinding *binding = event->getQueueBinding();
-      ProcessEvent(event, id);
-      InterlockedDecrement(&binding->usage);
-      processedEvents++;
+         int64_t waitTime = GetMonotonicClockTimeNs() / 1000 - event->getQueueTime();
+         waitTimeHistogram.update(waitTime);
+         waitTime /= 1000;
+         UpdateExpMovingAverage(averageWaitTime, EMA_EXP_180, waitTime);
+         if (static_cast<uint32_t>(waitTime) > maxWaitTime)
+            maxWaitTime = static_cast<uint32_t>(waitTime);
+         EventQueueBinding *binding = event->getQueueBinding();
+         ProcessEvent(event, id);
+         InterlockedDecrement(&binding->usage);
+         processedEvents++;
+      }
    }
 }
 
@@ -436,6 +683,7 @@ static void ParallelEventProcessor()
    TCHAR queueSelector[256];
    ConfigReadStr(_T("Events.Processor.QueueSelector"), queueSelector, 256, _T("%z"));
    nxlog_write_tag(NXLOG_INFO, DEBUG_TAG, _T("Parallel event processing enabled (queue selector \"%s\")"), queueSelector);
+   TextTemplate queueSelectorTemplate(queueSelector);
 
    EventQueueBinding *queueBindings = nullptr;
    ObjectMemoryPool<EventQueueBinding> memoryPool(1024);
@@ -446,17 +694,29 @@ static void ParallelEventProcessor()
    s_processingThreadCount = poolSize;
    int *weights = static_cast<int*>(MemAllocLocal(sizeof(int) * poolSize));
 
+   Event **pendingEvents = MemAllocArrayNoInit<Event*>(poolSize * EVENT_BATCH_SIZE);
+   size_t *pendingEventCount = MemAllocArray<size_t>(poolSize);
+
    time_t lastCleanupTime = time(nullptr);
 
+   Event *events[EVENT_BATCH_SIZE];
+   bool shutdown = false;
    while(true)
    {
-      Event *event = g_eventQueue.getOrBlock(10000);
-      if (event == INVALID_POINTER_VALUE)
-         break;   // Shutdown indicator
+      size_t count = g_eventQueue.getAllOrBlock(events, EVENT_BATCH_SIZE, 10000);
 
-      time_t now;
-      if (event != nullptr)
+      time_t now = 0;
+      for(size_t n = 0; n < count; n++)
       {
+         Event *event = events[n];
+         if (event == INVALID_POINTER_VALUE)
+         {
+            shutdown = true;   // Shutdown indicator
+            DiscardEvents(&events[n + 1], count - n - 1);
+            break;
+         }
+
+         s_eventQueueWaitTime.update(GetMonotonicClockTimeNs() / 1000 - event->getQueueTime());
          if (g_flags & AF_EVENT_STORM_DETECTED)
          {
             delete event;
@@ -466,7 +726,7 @@ static void ParallelEventProcessor()
 
          now = event->getTimestamp(); // Get current time from event, it should be (almost) current
 
-         StringBuffer key = event->expandText(queueSelector, nullptr);
+         StringBuffer key = event->expandText(queueSelectorTemplate, nullptr);
 #ifdef UNICODE
          char keyBytes[128];
          size_t keyLen = wchar_to_utf8(key.cstr(), key.length(), keyBytes, 128);
@@ -491,7 +751,7 @@ static void ParallelEventProcessor()
                else
                   weights[i] -= waitTime / 100 + 1;
 
-               uint32_t size = static_cast<uint32_t>(s_processingThreads[i].queue.size());
+               uint32_t size = static_cast<uint32_t>(s_processingThreads[i].queue.size() + pendingEventCount[i]);
                if (size == 0)
                   weights[i] += 2;
                else
@@ -538,17 +798,29 @@ static void ParallelEventProcessor()
          {
             InterlockedIncrement(&qb->usage);
          }
-         event->setQueueTime(GetCurrentTimeMs());
+         event->setQueueTime(GetMonotonicClockTimeNs() / 1000);
          event->setQueueBinding(qb);
-         qb->queue->put(event);
+         pendingEvents[qb->processingThread * EVENT_BATCH_SIZE + pendingEventCount[qb->processingThread]++] = event;
       }
-      else
+
+      // Pass collected events to processing threads
+      for(int i = 0; i < poolSize; i++)
       {
-         now = time(nullptr);
+         if (pendingEventCount[i] > 0)
+         {
+            s_processingThreads[i].queue.putAll(&pendingEvents[i * EVENT_BATCH_SIZE], pendingEventCount[i]);
+            pendingEventCount[i] = 0;
+         }
       }
 
+      if (shutdown)
+         break;
+
+      if (count == 0)
+         now = time(nullptr);
+
       // Remove outdated bindings
-      if ((event == nullptr) || (lastCleanupTime < now - 30))
+      if ((count == 0) || (lastCleanupTime < now - 30))
       {
          nxlog_debug_tag(DEBUG_TAG, 8, _T("Running event queues binding cleanup"));
 
@@ -580,10 +852,11 @@ static void ParallelEventProcessor()
    delete[] s_processingThreads;
    HASH_CLEAR(hh, queueBindings);
    MemFreeLocal(weights);
+   MemFree(pendingEvents);
+   MemFree(pendingEventCount);
 
-	s_loggerQueue.put(INVALID_POINTER_VALUE);
+   StopEventLogWriters();
 	ThreadJoin(s_threadStormDetector);
-	ThreadJoin(s_threadLogger);
    nxlog_debug_tag(DEBUG_TAG, 1, _T("Event processing thread stopped"));
 }
 
@@ -593,8 +866,17 @@ static void ParallelEventProcessor()
 THREAD StartEventProcessor()
 {
    memset(s_dbQueryFailedTimestamps, 0, sizeof(s_dbQueryFailedTimestamps));
-   s_threadLogger = ThreadCreateEx(EventLogger);
+   s_loggerThreadCount = ConfigReadInt(_T("Events.LogWriter.Threads"), 1);
+   if (s_loggerThreadCount < 1)
+      s_loggerThreadCount = 1;
+   else if (s_loggerThreadCount > 32)
+      s_loggerThreadCount = 32;
+   s_loggerThreads = MemAllocArrayNoInit<THREAD>(s_loggerThreadCount);
+   for(int i = 0; i < s_loggerThreadCount; i++)
+      s_loggerThreads[i] = ThreadCreateEx(EventLogger);
+   nxlog_debug_tag(DEBUG_TAG, 2, _T("%d event log writer threads started"), s_loggerThreadCount);
    s_threadStormDetector = ThreadCreateEx(EventStormDetector);
+   InitEventRateLimiter();
    return (ConfigReadInt(_T("Events.Processor.PoolSize"), 1) > 1) ? ThreadCreateEx(ParallelEventProcessor) : ThreadCreateEx(SerialEventProcessor);
 }
 
@@ -628,6 +910,24 @@ StructArray<EventProcessingThreadStats> *GetEventProcessingThreadStats()
    return stats;
 }
 
+/**
+ * Get snapshot of event processor queue wait time histogram (in microseconds). Queue 0 is main event queue,
+ * queues 1..N are queues of event processing threads (only exist when parallel processing is enabled).
+ * Returns false if given queue does not exist.
+ */
+bool GetEventProcessorLatencyHistogram(int queue, LatencyHistogram *waitTime)
+{
+   if (queue == 0)
+   {
+      *waitTime = s_eventQueueWaitTime;
+      return true;
+   }
+   if ((queue < 0) || (queue > s_processingThreadCount))
+      return false;
+   *waitTime = s_processingThreads[queue - 1].waitTimeHistogram;
+   return true;
+}
+
 /**
  * Compare event with ID
  */
@@ -653,6 +953,18 @@ Event *FindEventInLoggerQueue(uint64_t eventId)
    return s_loggerQueue.find(&eventId, CompareEvent, CopyEvent);
 }
 
+/**
+ * Get event log writer statistics
+ */
+void GetEventLogWriterStats(EventLogWriterStats *stats)
+{
+   s_eventLogWriterStatsLock.lock();
+   memcpy(stats, &s_eventLogWriterStats, sizeof(EventLogWriterStats));
+   s_eventLogWriterStatsLock.unlock();
+   stats->queueSize = static_cast<uint32_t>(s_loggerQueue.size());
+   stats->writerThreads = s_loggerThreadCount;
+}
+
 /**
  * Get size of event log writer queue
  */
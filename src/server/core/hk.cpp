@@ -41,22 +41,32 @@ static size_t s_throttlingHighWatermark = 250000;
 static size_t s_throttlingLowWatermark = 50000;
 
 /**
- * Throttle housekeeper if needed. Returns false if shutdown time has arrived and housekeeper process should be aborted.
+ * Throttle background database task (like housekeeper) if database writer queues are too long. Task is paused
+ * until queues drop below low watermark or shutdown flag is set. Given condition is used for waiting and should be
+ * set by task's stop function. Returns false if shutdown flag was set and task should be aborted.
  */
-bool ThrottleHousekeeper()
+bool ThrottleBackgroundDBTask(const TCHAR *name, CONDITION wakeupCondition, const bool *shutdown)
 {
-   size_t qsize = g_dbWriterQueue.size() + static_cast<size_t>(GetIDataWriterQueueSize() + GetRawDataWriterQueueSize());
+   size_t qsize = g_dbWriterQueue.size() + static_cast<size_t>(GetIDataWriterQueueSize() + GetTDataWriterQueueSize() + GetRawDataWriterQueueSize());
    if (qsize < s_throttlingHighWatermark)
       return true;
 
-   nxlog_debug_tag(DEBUG_TAG, 1, _T("Housekeeper paused (queue size %d, high watermark %d, low watermark %d)"), qsize, s_throttlingHighWatermark, s_throttlingLowWatermark);
-   while((qsize >= s_throttlingLowWatermark) && !s_shutdown)
+   nxlog_debug_tag(DEBUG_TAG, 1, _T("%s paused (queue size %d, high watermark %d, low watermark %d)"), name, qsize, s_throttlingHighWatermark, s_throttlingLowWatermark);
+   while((qsize >= s_throttlingLowWatermark) && !*shutdown)
    {
-      ConditionWait(s_wakeupCondition, 30000);
-      qsize = g_dbWriterQueue.size() + static_cast<size_t>(GetIDataWriterQueueSize() + GetRawDataWriterQueueSize());
+      ConditionWait(wakeupCondition, 30000);
+      qsize = g_dbWriterQueue.size() + static_cast<size_t>(GetIDataWriterQueueSize() + GetTDataWriterQueueSize() + GetRawDataWriterQueueSize());
    }
-   nxlog_debug_tag(DEBUG_TAG, 1, _T("Housekeeper resumed (queue size %d)"), qsize);
-   return !s_shutdown;
+   nxlog_debug_tag(DEBUG_TAG, 1, _T("%s resumed (queue size %d)"), name, qsize);
+   return !*shutdown;
+}
+
+/**
+ * Throttle housekeeper if needed. Returns false if shutdown time has arrived and housekeeper process should be aborted.
+ */
+bool ThrottleHousekeeper()
+{
+   return ThrottleBackgroundDBTask(_T("Housekeeper"), s_wakeupCondition, &s_shutdown);
 }
 
 /**
@@ -218,20 +228,27 @@ static void CalculateDciCutoffTimes(NetObj *object, CutoffTimes *data)
    static_cast<DataCollectionTarget*>(object)->calculateDciCutoffTimes(data->cutoffTimeIData, data->cutoffTimeTData);
 }
 
+/**
+ * Calculate cutoff times for all storage classes
+ */
+static void CalculateCutoffTimes(CutoffTimes *cutoffTimes)
+{
+   memset(cutoffTimes, 0, sizeof(CutoffTimes));
+   g_idxAccessPointById.forEach(CalculateDciCutoffTimes, cutoffTimes);
+   g_idxChassisById.forEach(CalculateDciCutoffTimes, cutoffTimes);
+   g_idxClusterById.forEach(CalculateDciCutoffTimes, cutoffTimes);
+   g_idxMobileDeviceById.forEach(CalculateDciCutoffTimes, cutoffTimes);
+   g_idxNodeById.forEach(CalculateDciCutoffTimes, cutoffTimes);
+   g_idxSensorById.forEach(CalculateDciCutoffTimes, cutoffTimes);
+}
+
 /**
  * Clean collected data in Timescale database
  */
 static void CleanTimescaleData(DB_HANDLE hdb)
 {
    CutoffTimes cutoffTimes;
-   memset(&cutoffTimes, 0, sizeof(cutoffTimes));
-
-   g_idxAccessPointById.forEach(CalculateDciCutoffTimes, &cutoffTimes);
-   g_idxChassisById.forEach(CalculateDciCutoffTimes, &cutoffTimes);
-   g_idxClusterById.forEach(CalculateDciCutoffTimes, &cutoffTimes);
-   g_idxMobileDeviceById.forEach(CalculateDciCutoffTimes, &cutoffTimes);
-   g_idxNodeById.forEach(CalculateDciCutoffTimes, &cutoffTimes);
-   g_idxSensorById.forEach(CalculateDciCutoffTimes, &cutoffTimes);
+   CalculateCutoffTimes(&cutoffTimes);
 
    // Always run on default storage class
    time_t defaultCutoffTime = time(NULL) - DCObject::m_defaultRetentionTime * 86400;
@@ -247,6 +264,315 @@ static void CleanTimescaleData(DB_HANDLE hdb)
    }
 }
 
+/**
+ * Data partitions are created for this number of days in advance
+ */
+#define DATA_PARTITION_ADVANCE_DAYS    7
+
+/**
+ * Data partition size (in seconds)
+ */
+#define DATA_PARTITION_INTERVAL        86400
+
+/**
+ * Name of catch-all partition. It holds rows above upper bound of last daily partition (for example,
+ * values with timestamps far in the future) so that inserts of such rows do not fail.
+ */
+#define DATA_PARTITION_CATCH_ALL       _T("pmax")
+
+/**
+ * Build data partition name. Partition is named after its upper bound (exclusive).
+ */
+static void BuildDataPartitionName(time_t upperBound, TCHAR *buffer)
+{
+   struct tm tmbuff;
+   _tcsftime(buffer, 16, _T("p%Y%m%d"), gmtime_r(&upperBound, &tmbuff));
+}
+
+/**
+ * Get upper bound of data partition from its name. Returns 0 if name is not a valid partition name.
+ */
+static time_t ParseDataPartitionName(const TCHAR *name)
+{
+   if (((name[0] != _T('p')) && (name[0] != _T('P'))) || (_tcslen(name) != 9))
+      return 0;
+
+   for(int i = 1; i < 9; i++)
+      if (!_istdigit(name[i]))
+         return 0;
+
+   uint32_t date = _tcstoul(&name[1], nullptr, 10);
+   struct tm t;
+   memset(&t, 0, sizeof(t));
+   t.tm_year = date / 10000 - 1900;
+   t.tm_mon = (date / 100) % 100 - 1;
+   t.tm_mday = date % 100;
+   return timegm(&t);
+}
+
+/**
+ * Compare partition upper bounds
+ */
+static int CompareDataPartitions(const void *p1, const void *p2)
+{
+   int64_t v1 = *static_cast<const int64_t*>(p1);
+   int64_t v2 = *static_cast<const int64_t*>(p2);
+   return (v1 < v2) ? -1 : ((v1 > v2) ? 1 : 0);
+}
+
+/**
+ * Get upper bounds of all partitions of given data table, sorted in ascending order. Catch-all
+ * partition is not included in the list, its presence is reported via hasCatchAll (if not null).
+ */
+static bool GetDataPartitions(DB_HANDLE hdb, const TCHAR *table, IntegerArray<int64_t> *partitions, bool *hasCatchAll = nullptr)
+{
+   TCHAR query[512];
+   switch(g_dbSyntax)
+   {
+      case DB_SYNTAX_MYSQL:
+         _sntprintf(query, 512, _T("SELECT partition_name FROM information_schema.partitions WHERE table_schema=DATABASE() AND table_name='%s' AND partition_name IS NOT NULL"), table);
+         break;
+      case DB_SYNTAX_ORACLE:
+         _sntprintf(query, 512, _T("SELECT partition_name FROM user_tab_partitions WHERE table_name=upper('%s')"), table);
+         break;
+      default:
+         _sntprintf(query, 512, _T("SELECT c.relname FROM pg_inherits i INNER JOIN pg_class c ON c.oid=i.inhrelid INNER JOIN pg_class p ON p.oid=i.inhparent WHERE p.relname='%s'"), table);
+         break;
+   }
+
+   DB_RESULT hResult = DBSelect(hdb, query);
+   if (hResult == nullptr)
+      return false;
+
+   if (hasCatchAll != nullptr)
+      *hasCatchAll = false;
+
+   size_t prefixLen = (g_dbSyntax == DB_SYNTAX_PGSQL) ? _tcslen(table) + 1 : 0;   // PostgreSQL partitions are separate tables named <table>_<partition>
+   int count = DBGetNumRows(hResult);
+   for(int i = 0; i < count; i++)
+   {
+      TCHAR name[256];
+      DBGetField(hResult, i, 0, name, 256);
+      if (_tcslen(name) <= prefixLen)
+         continue;
+      if (!_tcsicmp(&name[prefixLen], DATA_PARTITION_CATCH_ALL))
+      {
+         if (hasCatchAll != nullptr)
+            *hasCatchAll = true;
+         continue;
+      }
+      time_t upperBound = ParseDataPartitionName(&name[prefixLen]);
+      if (upperBound != 0)
+         partitions->add(upperBound);
+   }
+   DBFreeResult(hResult);
+
+   partitions->sort(CompareDataPartitions);
+   return true;
+}
+
+/**
+ * Create daily partition on PostgreSQL. If default (catch-all) partition already holds rows within
+ * new partition's range, PostgreSQL will refuse to create partition, so such rows are moved to
+ * new partition while default partition is detached.
+ */
+static bool CreatePostgreSQLDataPartition(DB_HANDLE hdb, const TCHAR *table, const TCHAR *timestampColumn, const TCHAR *name,
+         time_t lowerBound, time_t upperBound, bool hasCatchAll)
+{
+   TCHAR query[512];
+   _sntprintf(query, 512, _T("CREATE TABLE %s_%s PARTITION OF %s FOR VALUES FROM (") INT64_FMT _T(") TO (") INT64_FMT _T(")"),
+            table, name, table, static_cast<int64_t>(lowerBound), static_cast<int64_t>(upperBound));
+   if (!hasCatchAll)
+      return DBQuery(hdb, query);
+
+   TCHAR range[128];
+   _sntprintf(range, 128, _T("%s>=") INT64_FMT _T(" AND %s<") INT64_FMT, timestampColumn, static_cast<int64_t>(lowerBound), timestampColumn, static_cast<int64_t>(upperBound));
+
+   TCHAR check[512];
+   _sntprintf(check, 512, _T("SELECT 1 FROM %s_") DATA_PARTITION_CATCH_ALL _T(" WHERE %s LIMIT 1"), table, range);
+   DB_RESULT hResult = DBSelect(hdb, check);
+   if (hResult == nullptr)
+      return false;
+   bool moveRows = (DBGetNumRows(hResult) > 0);
+   DBFreeResult(hResult);
+
+   if (!moveRows)
+      return DBQuery(hdb, query);
+
+   nxlog_debug_tag(DEBUG_TAG, 4, _T("Moving rows from catch-all partition of table %s to new partition %s"), table, name);
+   if (!DBBegin(hdb))
+      return false;
+
+   TCHAR detachQuery[256], moveQuery[512], deleteQuery[512], attachQuery[256];
+   _sntprintf(detachQuery, 256, _T("ALTER TABLE %s DETACH PARTITION %s_") DATA_PARTITION_CATCH_ALL, table, table);
+   _sntprintf(moveQuery, 512, _T("INSERT INTO %s_%s SELECT * FROM %s_") DATA_PARTITION_CATCH_ALL _T(" WHERE %s"), table, name, table, range);
+   _sntprintf(deleteQuery, 512, _T("DELETE FROM %s_") DATA_PARTITION_CATCH_ALL _T(" WHERE %s"), table, range);
+   _sntprintf(attachQuery, 256, _T("ALTER TABLE %s ATTACH PARTITION %s_") DATA_PARTITION_CATCH_ALL _T(" DEFAULT"), table, table);
+   bool success = DBQuery(hdb, detachQuery) && DBQuery(hdb, query) && DBQuery(hdb, moveQuery) && DBQuery(hdb, deleteQuery) && DBQuery(hdb, attachQuery);
+   if (success)
+      success = DBCommit(hdb);
+   else
+      DBRollback(hdb);
+   return success;
+}
+
+/**
+ * Create data partitions in advance for given table. Rows above upper bound of last daily partition
+ * are kept in catch-all partition, which is split when new daily partition is created.
+ */
+static void CreateDataPartitions(DB_HANDLE hdb, const TCHAR *table, const TCHAR *timestampColumn, time_t now)
+{
+   IntegerArray<int64_t> partitions;
+   bool hasCatchAll;
+   if (!GetDataPartitions(hdb, table, &partitions, &hasCatchAll))
+      return;
+
+   time_t upperBound = partitions.isEmpty() ? (now / DATA_PARTITION_INTERVAL) * DATA_PARTITION_INTERVAL : static_cast<time_t>(partitions.get(partitions.size() - 1));
+   time_t limit = now + DATA_PARTITION_ADVANCE_DAYS * 86400;
+   while(upperBound < limit)
+   {
+      time_t lowerBound = upperBound;
+      upperBound += DATA_PARTITION_INTERVAL;
+
+      TCHAR name[16], query[512];
+      BuildDataPartitionName(upperBound, name);
+      nxlog_debug_tag(DEBUG_TAG, 5, _T("Creating partition %s for table %s"), name, table);
+
+      bool success;
+      switch(g_dbSyntax)
+      {
+         case DB_SYNTAX_MYSQL:
+            if (hasCatchAll)
+               _sntprintf(query, 512, _T("ALTER TABLE %s REORGANIZE PARTITION ") DATA_PARTITION_CATCH_ALL _T(" INTO (PARTITION %s VALUES LESS THAN (") INT64_FMT _T("),PARTITION ") DATA_PARTITION_CATCH_ALL _T(" VALUES LESS THAN (MAXVALUE))"),
+                        table, name, static_cast<int64_t>(upperBound));
+            else
+               _sntprintf(query, 512, _T("ALTER TABLE %s ADD PARTITION (PARTITION %s VALUES LESS THAN (") INT64_FMT _T("))"),
+                        table, name, static_cast<int64_t>(upperBound));
+            success = DBQuery(hdb, query);
+            break;
+         case DB_SYNTAX_ORACLE:
+            if (hasCatchAll)
+               _sntprintf(query, 512, _T("ALTER TABLE %s SPLIT PARTITION ") DATA_PARTITION_CATCH_ALL _T(" AT (") INT64_FMT _T(") INTO (PARTITION %s,PARTITION ") DATA_PARTITION_CATCH_ALL _T(") UPDATE GLOBAL INDEXES"),
+                        table, static_cast<int64_t>(upperBound), name);
+            else
+               _sntprintf(query, 512, _T("ALTER TABLE %s ADD PARTITION %s VALUES LESS THAN (") INT64_FMT _T(")"),
+                        table, name, static_cast<int64_t>(upperBound));
+            success = DBQuery(hdb, query);
+            break;
+         default:
+            success = CreatePostgreSQLDataPartition(hdb, table, timestampColumn, name, lowerBound, upperBound, hasCatchAll);
+            break;
+      }
+      if (!success)
+         return;
+   }
+
+   // Tables converted by older versions of nxdbmgr do not have catch-all partition
+   if (!hasCatchAll)
+   {
+      TCHAR query[512];
+      switch(g_dbSyntax)
+      {
+         case DB_SYNTAX_MYSQL:
+            _sntprintf(query, 512, _T("ALTER TABLE %s ADD PARTITION (PARTITION ") DATA_PARTITION_CATCH_ALL _T(" VALUES LESS THAN (MAXVALUE))"), table);
+            break;
+         case DB_SYNTAX_ORACLE:
+            _sntprintf(query, 512, _T("ALTER TABLE %s ADD PARTITION ") DATA_PARTITION_CATCH_ALL _T(" VALUES LESS THAN (MAXVALUE)"), table);
+            break;
+         default:
+            _sntprintf(query, 512, _T("CREATE TABLE %s_") DATA_PARTITION_CATCH_ALL _T(" PARTITION OF %s DEFAULT"), table, table);
+            break;
+      }
+      nxlog_debug_tag(DEBUG_TAG, 5, _T("Creating catch-all partition for table %s"), table);
+      DBQuery(hdb, query);
+   }
+}
+
+/**
+ * Drop expired data partitions for given table
+ */
+static void DropDataPartitions(DB_HANDLE hdb, const TCHAR *table, time_t cutoffTime)
+{
+   IntegerArray<int64_t> partitions;
+   if (!GetDataPartitions(hdb, table, &partitions))
+      return;
+
+   // Last daily partition is never dropped, so that data table always has at least one partition
+   // besides catch-all partition
+   for(int i = 0; i < partitions.size() - 1; i++)
+   {
+      time_t upperBound = static_cast<time_t>(partitions.get(i));
+      if (upperBound > cutoffTime)
+         break;
+
+      TCHAR name[16], query[512];
+      BuildDataPartitionName(upperBound, name);
+      switch(g_dbSyntax)
+      {
+         case DB_SYNTAX_MYSQL:
+            _sntprintf(query, 512, _T("ALTER TABLE %s DROP PARTITION %s"), table, name);
+            break;
+         case DB_SYNTAX_ORACLE:
+            _sntprintf(query, 512, _T("ALTER TABLE %s DROP PARTITION %s UPDATE GLOBAL INDEXES"), table, name);
+            break;
+         default:
+            _sntprintf(query, 512, _T("DROP TABLE %s_%s"), table, name);
+            break;
+      }
+      nxlog_debug_tag(DEBUG_TAG, 5, _T("Dropping partition %s of table %s"), name, table);
+      if (!DBQuery(hdb, query))
+         break;
+      if (!ThrottleHousekeeper())
+         break;
+   }
+}
+
+/**
+ * Create data partitions in advance for all partitioned data tables
+ */
+static void CreateAllDataPartitions(DB_HANDLE hdb)
+{
+   time_t now = time(nullptr);
+   for(int c = static_cast<int>(DCObjectStorageClass::DEFAULT); c <= static_cast<int>(DCObjectStorageClass::OTHER); c++)
+   {
+      TCHAR table[64];
+      _sntprintf(table, 64, _T("idata_sc_%s"), DCObject::getStorageClassName(static_cast<DCObjectStorageClass>(c)));
+      CreateDataPartitions(hdb, table, _T("idata_timestamp"), now);
+      _sntprintf(table, 64, _T("tdata_sc_%s"), DCObject::getStorageClassName(static_cast<DCObjectStorageClass>(c)));
+      CreateDataPartitions(hdb, table, _T("tdata_timestamp"), now);
+   }
+}
+
+/**
+ * Clean collected data stored in partitioned tables. Partition is dropped when it is older than
+ * retention time of all DCIs in its storage class.
+ */
+static void CleanPartitionedData(DB_HANDLE hdb)
+{
+   CutoffTimes cutoffTimes;
+   CalculateCutoffTimes(&cutoffTimes);
+
+   // Always run on default storage class
+   time_t defaultCutoffTime = time(nullptr) - DCObject::m_defaultRetentionTime * 86400;
+   DropDataPartitions(hdb, _T("idata_sc_default"), defaultCutoffTime);
+   DropDataPartitions(hdb, _T("tdata_sc_default"), defaultCutoffTime);
+
+   for(int c = static_cast<int>(DCObjectStorageClass::BELOW_7); c <= static_cast<int>(DCObjectStorageClass::OTHER); c++)
+   {
+      TCHAR table[64];
+      if (cutoffTimes.cutoffTimeIData[c - 1] != 0)
+      {
+         _sntprintf(table, 64, _T("idata_sc_%s"), DCObject::getStorageClassName(static_cast<DCObjectStorageClass>(c)));
+         DropDataPartitions(hdb, table, cutoffTimes.cutoffTimeIData[c - 1]);
+      }
+      if (cutoffTimes.cutoffTimeTData[c - 1] != 0)
+      {
+         _sntprintf(table, 64, _T("tdata_sc_%s"), DCObject::getStorageClassName(static_cast<DCObjectStorageClass>(c)));
+         DropDataPartitions(hdb, table, cutoffTimes.cutoffTimeTData[c - 1]);
+      }
+   }
+}
+
 /**
  * Callback for validating template DCIs
  */
@@ -326,6 +652,14 @@ static void HouseKeeper()
    // Call policy validation for templates
    g_idxObjectById.forEach(InitiatePolicyValidation, nullptr);
 
+   // Make sure that partitions for incoming data exist (server could be down for a while)
+   if (g_flags & AF_PARTITIONED_PERF_DATA)
+   {
+      DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+      CreateAllDataPartitions(hdb);
+      DBConnectionPoolReleaseConnection(hdb);
+   }
+
    int sleepTime = GetSleepTime(hour, minute, 0);
    while(!s_shutdown)
    {
@@ -343,6 +677,8 @@ static void HouseKeeper()
       nxlog_debug_tag(DEBUG_TAG, 5, _T("Throttling high watermark = %d, low watermark= %d"), s_throttlingHighWatermark, s_throttlingLowWatermark);
 
 		DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+		if (g_flags & AF_PARTITIONED_PERF_DATA)
+		   CreateAllDataPartitions(hdb);
 		CleanAlarmHistory(hdb);
 
 		// Remove outdated event log records
@@ -422,6 +758,11 @@ static void HouseKeeper()
             break;
 		}
 
+      // Remove expired DCI rollup data
+      CleanDCIRollupData(hdb);
+      if (!ThrottleHousekeeper())
+         break;
+
       // Delete old user agent messages
       retentionTime = ConfigReadULong(_T("UserAgent.RetentionTime"), 30);
       if (retentionTime > 0)
@@ -450,6 +791,11 @@ static void HouseKeeper()
             nxlog_debug_tag(DEBUG_TAG, 4, _T("Using drop_chunks()"));
             CleanTimescaleData(hdb);
          }
+         else if (g_flags & AF_PARTITIONED_PERF_DATA)
+         {
+            nxlog_debug_tag(DEBUG_TAG, 4, _T("Using partition drop"));
+            CleanPartitionedData(hdb);
+         }
          else
          {
             nxlog_debug_tag(DEBUG_TAG, 4, _T("Using DELETE statements"));
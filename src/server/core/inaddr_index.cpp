@@ -228,3 +228,115 @@ void InetAddressIndex::forEach(void (*callback)(const InetAddress& addr, NetObj
    }
    RWLockUnlock(m_lock);
 }
+
+/**
+ * Constructor
+ */
+InetAddressPrefixIndex::InetAddressPrefixIndex()
+{
+   m_lock = RWLockCreate();
+}
+
+/**
+ * Callback for destroying index entries
+ */
+static void DestroyPrefixIndexEntry(const InetAddress& prefix, void *value, void *context)
+{
+   delete static_cast<shared_ptr<NetObj>*>(value);
+}
+
+/**
+ * Destructor
+ */
+InetAddressPrefixIndex::~InetAddressPrefixIndex()
+{
+   m_tree.forEach(DestroyPrefixIndexEntry, nullptr);
+   RWLockDestroy(m_lock);
+}
+
+/**
+ * Put object into index. Existing object with same prefix will be replaced.
+ *
+ * @param prefix address prefix (mask bits define prefix length)
+ * @param object object
+ */
+void InetAddressPrefixIndex::put(const InetAddress& prefix, const shared_ptr<NetObj>& object)
+{
+   if (!prefix.isValid())
+      return;
+
+   RWLockWriteLock(m_lock);
+   delete static_cast<shared_ptr<NetObj>*>(m_tree.put(prefix.getSubnetAddress(), new shared_ptr<NetObj>(object)));
+   RWLockUnlock(m_lock);
+}
+
+/**
+ * Remove object from index. Prefix is removed only if it is associated with given object, so
+ * removal of an object sharing prefix with another one will not affect index entry of other object.
+ *
+ * @param prefix address prefix (mask bits define prefix length)
+ * @param objectId object ID
+ */
+void InetAddressPrefixIndex::remove(const InetAddress& prefix, uint32_t objectId)
+{
+   if (!prefix.isValid())
+      return;
+
+   InetAddress key = prefix.getSubnetAddress();
+   RWLockWriteLock(m_lock);
+   auto object = static_cast<shared_ptr<NetObj>*>(m_tree.get(key));
+   if ((object != nullptr) && ((*object)->getId() == objectId))
+   {
+      m_tree.remove(key);
+      delete object;
+   }
+   RWLockUnlock(m_lock);
+}
+
+/**
+ * Find object with longest prefix containing given address
+ */
+shared_ptr<NetObj> InetAddressPrefixIndex::findLongestMatch(const InetAddress& addr) const
+{
+   shared_ptr<NetObj> object;
+   RWLockReadLock(m_lock);
+   auto entry = static_cast<shared_ptr<NetObj>*>(m_tree.findLongestMatch(addr));
+   if (entry != nullptr)
+      object = *entry;
+   RWLockUnlock(m_lock);
+   return object;
+}
+
+/**
+ * Callback for collecting overlapping objects
+ */
+static void CollectOverlappingObjects(const InetAddress& prefix, void *value, void *context)
+{
+   static_cast<SharedObjectArray<NetObj>*>(context)->add(*static_cast<shared_ptr<NetObj>*>(value));
+}
+
+/**
+ * Find all objects which prefix contains given prefix or is contained within it
+ */
+unique_ptr<SharedObjectArray<NetObj>> InetAddressPrefixIndex::findOverlapping(const InetAddress& prefix) const
+{
+   unique_ptr<SharedObjectArray<NetObj>> objects = make_unique<SharedObjectArray<NetObj>>();
+   if (prefix.isValid())
+   {
+      RWLockReadLock(m_lock);
+      m_tree.findOverlapping(prefix, CollectOverlappingObjects, objects.get());
+      RWLockUnlock(m_lock);
+   }
+   return objects;
+}
+
+/**
+ * Get index size
+ */
+int InetAddressPrefixIndex::size() const
+{
+   RWLockReadLock(m_lock);
+   int s = static_cast<int>(m_tree.size());
+   RWLockUnlock(m_lock);
+   return s;
+}
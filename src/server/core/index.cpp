@@ -158,6 +158,20 @@ static inline void ReleaseIndex(INDEX_HEAD *h)
    InterlockedDecrement(&h->readers);
 }
 
+/**
+ * Sort elements added while in startup mode. Index in startup mode is safe for concurrent
+ * lookups after this call and until next put().
+ */
+void AbstractIndexBase::sortStartupData()
+{
+   if (m_startupMode && m_dirty)
+   {
+      qsort(m_primary->elements, m_primary->size, sizeof(INDEX_ELEMENT), IndexCompare);
+      m_primary->maxKey = (m_primary->size > 0) ? m_primary->elements[m_primary->size - 1].key : 0;
+      m_dirty = false;
+   }
+}
+
 /**
  * Put element. If element with given key already exist, it will be replaced.
  *
@@ -259,12 +273,7 @@ void AbstractIndexBase::remove(UINT64 key)
 {
    if (m_startupMode)
    {
-      if (m_dirty)
-      {
-         qsort(m_primary->elements, m_primary->size, sizeof(INDEX_ELEMENT), IndexCompare);
-         m_primary->maxKey = (m_primary->size > 0) ? m_primary->elements[m_primary->size - 1].key : 0;
-         m_dirty = false;
-      }
+      sortStartupData();
       ssize_t pos = findElement(m_primary, key);
       if (pos != -1)
       {
@@ -375,12 +384,7 @@ ssize_t AbstractIndexBase::findElement(INDEX_HEAD *index, UINT64 key)
  */
 void *AbstractIndexBase::get(UINT64 key)
 {
-   if (m_startupMode && m_dirty)
-   {
-      qsort(m_primary->elements, m_primary->size, sizeof(INDEX_ELEMENT), IndexCompare);
-      m_primary->maxKey = (m_primary->size > 0) ? m_primary->elements[m_primary->size - 1].key : 0;
-      m_dirty = false;
-   }
+   sortStartupData();
    INDEX_HEAD *index = acquireIndex();
 	ssize_t pos = findElement(index, key);
 	void *object = (pos == -1) ? NULL : index->elements[pos].object;
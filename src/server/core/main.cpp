@@ -174,6 +174,8 @@ uint32_t g_requiredPolls = 1;
 int32_t g_instanceRetentionTime = 7; // Default instance retention time (in days)
 uint32_t g_snmpTrapStormCountThreshold = 0;
 uint32_t g_snmpTrapStormDurationThreshold = 15;
+uint32_t g_snmpMaxRequestsInFlight = 0;  // Default limit for concurrent SNMP requests to single device (0 = unlimited)
+uint32_t g_snmpRequestRateLimit = 0;    // Default limit for SNMP requests per second to single device (0 = unlimited)
 DB_DRIVER g_dbDriver = nullptr;
 NXCORE_EXPORTABLE_VAR(ThreadPool *g_mainThreadPool) = nullptr;
 int16_t g_defaultAgentCacheMode = AGENT_CACHE_OFF;
@@ -391,6 +393,19 @@ static void LoadGlobalConfig()
    {
       nxlog_debug_tag(_T("dc"), 1, _T("Using single table for performance data storage"));
       g_flags |= AF_SINGLE_TABLE_PERF_DATA;
+
+      if (MetaDataReadInt32(_T("PartitionedPerfData"), 0))
+      {
+         if ((g_dbSyntax == DB_SYNTAX_MYSQL) || (g_dbSyntax == DB_SYNTAX_ORACLE) || (g_dbSyntax == DB_SYNTAX_PGSQL))
+         {
+            nxlog_debug_tag(_T("dc"), 1, _T("Using time partitioned tables for performance data storage"));
+            g_flags |= AF_PARTITIONED_PERF_DATA;
+         }
+         else
+         {
+            nxlog_write_tag(NXLOG_WARNING, _T("dc"), _T("Partitioned performance data storage is not supported for this database type"));
+         }
+      }
    }
 
    g_conditionPollingInterval = ConfigReadInt(_T("ConditionPollingInterval"), 60);
@@ -517,6 +532,8 @@ static void LoadGlobalConfig()
    g_instanceRetentionTime = ConfigReadInt(_T("DataCollection.InstanceRetentionTime"), 7); // Config values are in days
    g_snmpTrapStormCountThreshold = ConfigReadInt(_T("SNMP.Traps.RateLimit.Threshold"), 0);
    g_snmpTrapStormDurationThreshold = ConfigReadInt(_T("SNMP.Traps.RateLimit.Duration"), 15);
+   g_snmpMaxRequestsInFlight = ConfigReadULong(_T("SNMP.RequestScheduler.MaxInFlight"), 0);
+   g_snmpRequestRateLimit = ConfigReadULong(_T("SNMP.RequestScheduler.RateLimit"), 0);
 
    switch(ConfigReadInt(_T("Objects.Nodes.ResolveDNSToIPOnStatusPoll"), static_cast<int>(PrimaryIPUpdateMode::NEVER)))
    {
@@ -985,10 +1002,11 @@ BOOL NXCORE_EXPORTABLE Initialize()
 	int maxSize = ConfigReadIntEx(hdbBootstrap, _T("DBConnectionPool.MaxSize"), 30);
 	int cooldownTime = ConfigReadIntEx(hdbBootstrap, _T("DBConnectionPool.CooldownTime"), 300);
 	int ttl = ConfigReadIntEx(hdbBootstrap, _T("DBConnectionPool.MaxLifetime"), 14400);
+	bool threadAffinity = ConfigReadIntEx(hdbBootstrap, _T("DBConnectionPool.ThreadAffinity"), 0) != 0;
 
    DBDisconnect(hdbBootstrap);
 
-	if (!DBConnectionPoolStartup(g_dbDriver, g_szDbServer, g_szDbName, g_szDbLogin, g_szDbPassword, g_szDbSchema, baseSize, maxSize, cooldownTime, ttl))
+	if (!DBConnectionPoolStartup(g_dbDriver, g_szDbServer, g_szDbName, g_szDbLogin, g_szDbPassword, g_szDbSchema, baseSize, maxSize, cooldownTime, ttl, threadAffinity))
 	{
       nxlog_write(NXLOG_ERROR, _T("Failed to initialize database connection pool"));
 	   return FALSE;
@@ -1233,6 +1251,8 @@ BOOL NXCORE_EXPORTABLE Initialize()
    s_pollManagerThread = ThreadCreateEx(PollManager, pollManagerInitialized);
 
    StartHouseKeeper();
+   StartDCIRollup();
+   StartDCICacheSnapshotWriter();
 
    // Start event processor
    s_eventProcessorThread = StartEventProcessor();
@@ -1360,6 +1380,7 @@ void NXCORE_EXPORTABLE Shutdown()
 
    ThreadJoin(s_statCollectorThread);
 
+   StopDCIRollup();
    StopHouseKeeper();
    ShutdownTaskScheduler();
 
@@ -1369,6 +1390,7 @@ void NXCORE_EXPORTABLE Shutdown()
 	ShutdownPredictionEngines();
    StopObjectMaintenanceThreads();
    StopDataCollection();
+   StopDCICacheSnapshotWriter();
 
    // Wait for critical threads
    ThreadJoin(s_pollManagerThread);
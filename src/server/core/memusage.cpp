@@ -0,0 +1,304 @@
+/*
+** NetXMS - Network Management System
+** Copyright (C) 2003-2021 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: memusage.cpp
+**
+**/
+
+#include "nxcore.h"
+
+/**
+ * Externals
+ */
+extern ObjectQueue<DiscoveredAddress> g_nodePollerQueue;
+extern ObjectQueue<SyslogMessage> g_syslogProcessingQueue;
+extern ObjectQueue<SyslogMessage> g_syslogWriteQueue;
+extern ObjectQueue<WindowsEvent> g_windowsEventProcessingQueue;
+extern ObjectQueue<WindowsEvent> g_windowsEventWriterQueue;
+
+/**
+ * Number of object class slots (all standard classes plus one slot for custom objects)
+ */
+#define OBJECT_CLASS_SLOTS    (OBJECT_SENSOR + 2)
+
+/**
+ * Memory accounting category names
+ */
+static const TCHAR *s_categoryNames[MEMORY_CATEGORY_COUNT] =
+{
+   _T("Data collection cache"),
+   _T("Events"),
+   _T("NXCP send queues"),
+   _T("Script VMs")
+};
+
+/**
+ * Memory usage counters (updated by constructors and destructors of accounted objects)
+ */
+static atomic<int64_t> s_memoryUsage[MEMORY_CATEGORY_COUNT];
+static atomic<int64_t> s_objectCount[MEMORY_CATEGORY_COUNT];
+
+/**
+ * Number of objects in index by object class
+ */
+static atomic<int64_t> s_objectClassCount[OBJECT_CLASS_SLOTS];
+
+/**
+ * Update memory usage counters for given category
+ */
+void NXCORE_EXPORTABLE UpdateMemoryUsage(MemoryCategory category, int64_t bytes, int64_t objects)
+{
+   s_memoryUsage[static_cast<int>(category)].fetch_add(bytes, std::memory_order_relaxed);
+   if (objects != 0)
+      s_objectCount[static_cast<int>(category)].fetch_add(objects, std::memory_order_relaxed);
+}
+
+/**
+ * Get memory usage for given category
+ */
+uint64_t GetMemoryUsage(MemoryCategory category)
+{
+   int64_t bytes = s_memoryUsage[static_cast<int>(category)].load(std::memory_order_relaxed);
+   return (bytes > 0) ? static_cast<uint64_t>(bytes) : 0;
+}
+
+/**
+ * Get number of accounted objects for given category
+ */
+int64_t GetMemoryUsageObjectCount(MemoryCategory category)
+{
+   return s_objectCount[static_cast<int>(category)].load(std::memory_order_relaxed);
+}
+
+/**
+ * Get counter slot for object class
+ */
+static inline int ObjectClassSlot(int objectClass)
+{
+   return ((objectClass >= 0) && (objectClass <= OBJECT_SENSOR)) ? objectClass : OBJECT_CLASS_SLOTS - 1;
+}
+
+/**
+ * Get size of object instance for given object class. Memory allocated by object
+ * for its members (interface lists, DCI lists, etc.) is not included.
+ */
+static size_t GetObjectInstanceSize(int objectClass)
+{
+   switch(objectClass)
+   {
+      case OBJECT_ACCESSPOINT:
+         return sizeof(AccessPoint);
+      case OBJECT_BUSINESSSERVICE:
+         return sizeof(BusinessService);
+      case OBJECT_BUSINESSSERVICEROOT:
+         return sizeof(BusinessServiceRoot);
+      case OBJECT_CHASSIS:
+         return sizeof(Chassis);
+      case OBJECT_CLUSTER:
+         return sizeof(Cluster);
+      case OBJECT_CONDITION:
+         return sizeof(ConditionObject);
+      case OBJECT_CONTAINER:
+         return sizeof(Container);
+      case OBJECT_DASHBOARD:
+         return sizeof(Dashboard);
+      case OBJECT_DASHBOARDGROUP:
+         return sizeof(DashboardGroup);
+      case OBJECT_DASHBOARDROOT:
+         return sizeof(DashboardRoot);
+      case OBJECT_INTERFACE:
+         return sizeof(Interface);
+      case OBJECT_MOBILEDEVICE:
+         return sizeof(MobileDevice);
+      case OBJECT_NETWORK:
+         return sizeof(Network);
+      case OBJECT_NETWORKMAP:
+         return sizeof(NetworkMap);
+      case OBJECT_NETWORKMAPGROUP:
+         return sizeof(NetworkMapGroup);
+      case OBJECT_NETWORKMAPROOT:
+         return sizeof(NetworkMapRoot);
+      case OBJECT_NETWORKSERVICE:
+         return sizeof(NetworkService);
+      case OBJECT_NODE:
+         return sizeof(Node);
+      case OBJECT_NODELINK:
+         return sizeof(NodeLink);
+      case OBJECT_RACK:
+         return sizeof(Rack);
+      case OBJECT_SENSOR:
+         return sizeof(Sensor);
+      case OBJECT_SERVICEROOT:
+         return sizeof(ServiceRoot);
+      case OBJECT_SLMCHECK:
+         return sizeof(SlmCheck);
+      case OBJECT_SUBNET:
+         return sizeof(Subnet);
+      case OBJECT_TEMPLATE:
+         return sizeof(Template);
+      case OBJECT_TEMPLATEGROUP:
+         return sizeof(TemplateGroup);
+      case OBJECT_TEMPLATEROOT:
+         return sizeof(TemplateRoot);
+      case OBJECT_VPNCONNECTOR:
+         return sizeof(VPNConnector);
+      case OBJECT_ZONE:
+         return sizeof(Zone);
+      default:
+         return sizeof(NetObj);
+   }
+}
+
+/**
+ * Update object counters when object is added to or removed from object index
+ */
+void UpdateObjectMemoryUsage(const NetObj& object, bool add)
+{
+   s_objectClassCount[ObjectClassSlot(object.getObjectClass())].fetch_add(add ? 1 : -1, std::memory_order_relaxed);
+}
+
+/**
+ * Get estimated memory usage by objects of given class
+ */
+static uint64_t GetObjectClassMemoryUsage(int slot)
+{
+   int64_t count = s_objectClassCount[slot].load(std::memory_order_relaxed);
+   return (count > 0) ? static_cast<uint64_t>(count) * GetObjectInstanceSize((slot < OBJECT_CLASS_SLOTS - 1) ? slot : OBJECT_CUSTOM) : 0;
+}
+
+/**
+ * Get estimated memory usage by all objects
+ */
+uint64_t GetObjectMemoryUsage()
+{
+   uint64_t total = 0;
+   for(int i = 0; i < OBJECT_CLASS_SLOTS; i++)
+      total += GetObjectClassMemoryUsage(i);
+   return total;
+}
+
+/**
+ * Get estimated memory usage by objects of given class for internal parameter (class name is the only argument)
+ */
+DataCollectionError GetObjectClassMemoryUsage(const TCHAR *param, TCHAR *value)
+{
+   TCHAR className[64];
+   if (!AgentGetParameterArg(param, 1, className, 64))
+      return DCE_NOT_SUPPORTED;
+
+   for(int i = 0; i <= OBJECT_SENSOR; i++)
+   {
+      if (!_tcsicmp(className, NetObj::getObjectClassName(i)))
+      {
+         ret_uint64(value, GetObjectClassMemoryUsage(i));
+         return DCE_SUCCESS;
+      }
+   }
+   if (!_tcsicmp(className, _T("custom")))
+   {
+      ret_uint64(value, GetObjectClassMemoryUsage(OBJECT_CLASS_SLOTS - 1));
+      return DCE_SUCCESS;
+   }
+   return DCE_NO_SUCH_INSTANCE;
+}
+
+/**
+ * Accounted internal queues
+ */
+static struct
+{
+   const TCHAR *name;
+   Queue *queue;
+   MPSCQueue *mpscQueue;
+} s_queues[] =
+{
+   { _T("DBWriter.Other"), &g_dbWriterQueue, nullptr },
+   { _T("DCICacheLoader"), &g_dciCacheLoaderQueue, nullptr },
+   { _T("EventQueue"), nullptr, &g_eventQueue },
+   { _T("NodeDiscoveryPoller"), &g_nodePollerQueue, nullptr },
+   { _T("SyslogProcessor"), &g_syslogProcessingQueue, nullptr },
+   { _T("SyslogWriter"), &g_syslogWriteQueue, nullptr },
+   { _T("TemplateUpdater"), &g_templateUpdateQueue, nullptr },
+   { _T("WindowsEventProcessor"), &g_windowsEventProcessingQueue, nullptr },
+   { _T("WindowsEventWriter"), &g_windowsEventWriterQueue, nullptr },
+   { nullptr, nullptr, nullptr }
+};
+
+/**
+ * Get number of elements in accounted queue
+ */
+static inline size_t GetAccountedQueueSize(int index)
+{
+   return (s_queues[index].queue != nullptr) ? s_queues[index].queue->size() : s_queues[index].mpscQueue->size();
+}
+
+/**
+ * Get memory used by accounted queue
+ */
+static inline uint64_t GetAccountedQueueMemoryUsage(int index)
+{
+   return (s_queues[index].queue != nullptr) ? s_queues[index].queue->getMemoryUsage() : s_queues[index].mpscQueue->getMemoryUsage();
+}
+
+/**
+ * Get memory used by internal queue buffers (queued elements are accounted in their own categories)
+ */
+uint64_t GetQueueMemoryUsage()
+{
+   uint64_t total = 0;
+   for(int i = 0; s_queues[i].name != nullptr; i++)
+      total += GetAccountedQueueMemoryUsage(i);
+   return total;
+}
+
+/**
+ * Show memory usage
+ */
+void ShowMemoryUsage(CONSOLE_CTX console)
+{
+   ConsolePrintf(console, _T("\x1b[1m%-32s %12s %12s\x1b[0m\n"), _T("Subsystem"), _T("Objects"), _T("Memory (MB)"));
+   for(int i = 0; i < MEMORY_CATEGORY_COUNT; i++)
+   {
+      int64_t count = GetMemoryUsageObjectCount(static_cast<MemoryCategory>(i));
+      ConsolePrintf(console, _T("%-32s ") UINT64_FMT_ARGS(_T("12")) _T(" %12.2f\n"), s_categoryNames[i],
+               static_cast<uint64_t>((count > 0) ? count : 0),
+               static_cast<double>(GetMemoryUsage(static_cast<MemoryCategory>(i))) / 1048576);
+   }
+   ConsolePrintf(console, _T("%-32s %12s %12.2f\n"), _T("Alarms"), _T("-"), static_cast<double>(GetAlarmMemoryUsage()) / 1048576);
+   ConsolePrintf(console, _T("%-32s %12s %12.2f\n"), _T("Raw DCI data write cache"), _T("-"), static_cast<double>(GetRawDataWriterMemoryUsage()) / 1048576);
+
+   ConsolePrintf(console, _T("\n\x1b[1m%-32s %12s %12s\x1b[0m\n"), _T("Queue"), _T("Elements"), _T("Memory (MB)"));
+   for(int i = 0; s_queues[i].name != nullptr; i++)
+   {
+      ConsolePrintf(console, _T("%-32s %12u %12.2f\n"), s_queues[i].name, static_cast<uint32_t>(GetAccountedQueueSize(i)),
+               static_cast<double>(GetAccountedQueueMemoryUsage(i)) / 1048576);
+   }
+
+   ConsolePrintf(console, _T("\n\x1b[1m%-32s %12s %12s\x1b[0m\n"), _T("Object class"), _T("Objects"), _T("Memory (MB)"));
+   for(int i = 0; i < OBJECT_CLASS_SLOTS; i++)
+   {
+      int64_t count = s_objectClassCount[i].load(std::memory_order_relaxed);
+      if (count <= 0)
+         continue;
+      ConsolePrintf(console, _T("%-32s ") UINT64_FMT_ARGS(_T("12")) _T(" %12.2f\n"),
+               (i < OBJECT_CLASS_SLOTS - 1) ? NetObj::getObjectClassName(i) : _T("custom"), static_cast<uint64_t>(count),
+               static_cast<double>(GetObjectClassMemoryUsage(i)) / 1048576);
+   }
+
+   ConsoleWrite(console, _T("\nObject memory usage includes object instances only\n\n"));
+}
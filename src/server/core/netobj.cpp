@@ -509,6 +509,16 @@ bool NetObj::deleteFromDatabase(DB_HANDLE hdb)
    return success;
 }
 
+/**
+ * Columns loaded from object_properties table
+ */
+#define OBJECT_PROPERTIES_COLUMNS \
+         _T("name,status,is_deleted,inherit_access_rights,last_modified,status_calc_alg,") \
+         _T("status_prop_alg,status_fixed_val,status_shift,status_translation,status_single_threshold,") \
+         _T("status_thresholds,comments,is_system,location_type,latitude,longitude,location_accuracy,") \
+         _T("location_timestamp,guid,map_image,submap_id,country,city,street_address,postcode,maint_event_id,") \
+         _T("state_before_maint,maint_initiator,state,flags,creation_time,alias,name_on_map,category")
+
 /**
  * Load common object properties from database
  */
@@ -516,127 +526,90 @@ bool NetObj::loadCommonProperties(DB_HANDLE hdb)
 {
    bool success = false;
 
-   // Load access options
-	DB_STATEMENT hStmt = DBPrepare(hdb,
-         _T("SELECT name,status,is_deleted,inherit_access_rights,last_modified,status_calc_alg,")
-         _T("status_prop_alg,status_fixed_val,status_shift,status_translation,status_single_threshold,")
-         _T("status_thresholds,comments,is_system,location_type,latitude,longitude,location_accuracy,")
-         _T("location_timestamp,guid,map_image,submap_id,country,city,street_address,postcode,maint_event_id,")
-         _T("state_before_maint,maint_initiator,state,flags,creation_time,alias,name_on_map,category ")
-         _T("FROM object_properties WHERE object_id=?"));
-	if (hStmt != nullptr)
-	{
-		DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-		DB_RESULT hResult = DBSelectPrepared(hStmt);
-		if (hResult != nullptr)
-		{
-			if (DBGetNumRows(hResult) > 0)
-			{
-				DBGetField(hResult, 0, 0, m_name, MAX_OBJECT_NAME);
-				m_status = m_savedStatus = DBGetFieldLong(hResult, 0, 1);
-				m_isDeleted = DBGetFieldLong(hResult, 0, 2) ? true : false;
-				m_inheritAccessRights = DBGetFieldLong(hResult, 0, 3) ? true : false;
-				m_timestamp = (time_t)DBGetFieldULong(hResult, 0, 4);
-				m_statusCalcAlg = DBGetFieldLong(hResult, 0, 5);
-				m_statusPropAlg = DBGetFieldLong(hResult, 0, 6);
-				m_fixedStatus = DBGetFieldLong(hResult, 0, 7);
-				m_statusShift = DBGetFieldLong(hResult, 0, 8);
-				DBGetFieldByteArray(hResult, 0, 9, m_statusTranslation, 4, STATUS_WARNING);
-				m_statusSingleThreshold = DBGetFieldLong(hResult, 0, 10);
-				DBGetFieldByteArray(hResult, 0, 11, m_statusThresholds, 4, 50);
-				m_comments = DBGetFieldAsSharedString(hResult, 0, 12);
-				m_isSystem = DBGetFieldLong(hResult, 0, 13) ? true : false;
-
-				int locType = DBGetFieldLong(hResult, 0, 14);
-				if (locType != GL_UNSET)
-				{
-					TCHAR lat[32], lon[32];
-
-					DBGetField(hResult, 0, 15, lat, 32);
-					DBGetField(hResult, 0, 16, lon, 32);
-					m_geoLocation = GeoLocation(locType, lat, lon, DBGetFieldLong(hResult, 0, 17), DBGetFieldULong(hResult, 0, 18));
-				}
-				else
-				{
-					m_geoLocation = GeoLocation();
-				}
-
-				m_guid = DBGetFieldGUID(hResult, 0, 19);
-				m_mapImage = DBGetFieldGUID(hResult, 0, 20);
-				m_submapId = DBGetFieldULong(hResult, 0, 21);
-
-            TCHAR buffer[256];
-            m_postalAddress.setCountry(DBGetField(hResult, 0, 22, buffer, 64));
-            m_postalAddress.setCity(DBGetField(hResult, 0, 23, buffer, 64));
-            m_postalAddress.setStreetAddress(DBGetField(hResult, 0, 24, buffer, 256));
-            m_postalAddress.setPostCode(DBGetField(hResult, 0, 25, buffer, 32));
-
-            m_maintenanceEventId = DBGetFieldUInt64(hResult, 0, 26);
-            m_stateBeforeMaintenance = DBGetFieldULong(hResult, 0, 27);
-            m_maintenanceInitiator = DBGetFieldULong(hResult, 0, 28);
-
-            m_state = m_savedState = DBGetFieldULong(hResult, 0, 29);
-            m_runtimeFlags = 0;
-            m_flags = DBGetFieldULong(hResult, 0, 30);
-            m_creationTime = static_cast<time_t>(DBGetFieldULong(hResult, 0, 31));
-            m_alias = DBGetFieldAsSharedString(hResult, 0, 32);
-            m_nameOnMap = DBGetFieldAsSharedString(hResult, 0, 33);
-            m_categoryId = DBGetFieldULong(hResult, 0, 34);
-
-				success = true;
-			}
-			DBFreeResult(hResult);
-		}
-		DBFreeStatement(hStmt);
-	}
+   // Load common properties
+   ObjectDataRows properties(hdb, StartupDataSet::OBJECT_PROPERTIES,
+         _T("SELECT ") OBJECT_PROPERTIES_COLUMNS _T(",object_id FROM object_properties ORDER BY object_id"),
+         _T("SELECT ") OBJECT_PROPERTIES_COLUMNS _T(" FROM object_properties WHERE object_id=?"), m_id);
+   if (properties.isValid() && (properties.getRowCount() > 0))
+   {
+      DB_RESULT hResult = properties.getResult();
+      int r = properties.getFirstRow();
+      DBGetField(hResult, r, 0, m_name, MAX_OBJECT_NAME);
+      m_status = m_savedStatus = DBGetFieldLong(hResult, r, 1);
+      m_isDeleted = DBGetFieldLong(hResult, r, 2) ? true : false;
+      m_inheritAccessRights = DBGetFieldLong(hResult, r, 3) ? true : false;
+      m_timestamp = (time_t)DBGetFieldULong(hResult, r, 4);
+      m_statusCalcAlg = DBGetFieldLong(hResult, r, 5);
+      m_statusPropAlg = DBGetFieldLong(hResult, r, 6);
+      m_fixedStatus = DBGetFieldLong(hResult, r, 7);
+      m_statusShift = DBGetFieldLong(hResult, r, 8);
+      DBGetFieldByteArray(hResult, r, 9, m_statusTranslation, 4, STATUS_WARNING);
+      m_statusSingleThreshold = DBGetFieldLong(hResult, r, 10);
+      DBGetFieldByteArray(hResult, r, 11, m_statusThresholds, 4, 50);
+      m_comments = DBGetFieldAsSharedString(hResult, r, 12);
+      m_isSystem = DBGetFieldLong(hResult, r, 13) ? true : false;
+
+      int locType = DBGetFieldLong(hResult, r, 14);
+      if (locType != GL_UNSET)
+      {
+         TCHAR lat[32], lon[32];
 
-	// Load custom attributes
-	if (success)
-	{
-		hStmt = DBPrepare(hdb, _T("SELECT attr_name,attr_value,flags FROM object_custom_attributes WHERE object_id=?"));
-		if (hStmt != nullptr)
-		{
-			DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-			DB_RESULT hResult = DBSelectPrepared(hStmt);
-			if (hResult != nullptr)
-			{
-			   setCustomAttributesFromDatabase(hResult);
-				DBFreeResult(hResult);
-			}
-			else
-			{
-				success = false;
-			}
-			DBFreeStatement(hStmt);
-		}
-		else
-		{
-			success = false;
-		}
-	}
+         DBGetField(hResult, r, 15, lat, 32);
+         DBGetField(hResult, r, 16, lon, 32);
+         m_geoLocation = GeoLocation(locType, lat, lon, DBGetFieldLong(hResult, r, 17), DBGetFieldULong(hResult, r, 18));
+      }
+      else
+      {
+         m_geoLocation = GeoLocation();
+      }
+
+      m_guid = DBGetFieldGUID(hResult, r, 19);
+      m_mapImage = DBGetFieldGUID(hResult, r, 20);
+      m_submapId = DBGetFieldULong(hResult, r, 21);
+
+      TCHAR buffer[256];
+      m_postalAddress.setCountry(DBGetField(hResult, r, 22, buffer, 64));
+      m_postalAddress.setCity(DBGetField(hResult, r, 23, buffer, 64));
+      m_postalAddress.setStreetAddress(DBGetField(hResult, r, 24, buffer, 256));
+      m_postalAddress.setPostCode(DBGetField(hResult, r, 25, buffer, 32));
+
+      m_maintenanceEventId = DBGetFieldUInt64(hResult, r, 26);
+      m_stateBeforeMaintenance = DBGetFieldULong(hResult, r, 27);
+      m_maintenanceInitiator = DBGetFieldULong(hResult, r, 28);
+
+      m_state = m_savedState = DBGetFieldULong(hResult, r, 29);
+      m_runtimeFlags = 0;
+      m_flags = DBGetFieldULong(hResult, r, 30);
+      m_creationTime = static_cast<time_t>(DBGetFieldULong(hResult, r, 31));
+      m_alias = DBGetFieldAsSharedString(hResult, r, 32);
+      m_nameOnMap = DBGetFieldAsSharedString(hResult, r, 33);
+      m_categoryId = DBGetFieldULong(hResult, r, 34);
+
+      success = true;
+   }
+
+   // Load custom attributes
+   if (success)
+   {
+      ObjectDataRows attributes(hdb, StartupDataSet::CUSTOM_ATTRIBUTES,
+               _T("SELECT attr_name,attr_value,flags,object_id FROM object_custom_attributes ORDER BY object_id"),
+               _T("SELECT attr_name,attr_value,flags FROM object_custom_attributes WHERE object_id=?"), m_id);
+      if (attributes.isValid())
+         setCustomAttributesFromDatabase(attributes.getResult(), attributes.getFirstRow(), attributes.getRowCount());
+      else
+         success = false;
+   }
 
    // Load associated dashboards
    if (success)
    {
-      hStmt = DBPrepare(hdb, _T("SELECT dashboard_id FROM dashboard_associations WHERE object_id=?"));
-      if (hStmt != nullptr)
+      ObjectDataRows dashboards(hdb, StartupDataSet::DASHBOARD_ASSOCIATIONS,
+               _T("SELECT dashboard_id,object_id FROM dashboard_associations ORDER BY object_id"),
+               _T("SELECT dashboard_id FROM dashboard_associations WHERE object_id=?"), m_id);
+      if (dashboards.isValid())
       {
-         DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-         DB_RESULT hResult = DBSelectPrepared(hStmt);
-         if (hResult != nullptr)
-         {
-            int count = DBGetNumRows(hResult);
-            for(int i = 0; i < count; i++)
-            {
-               m_dashboards.add(DBGetFieldULong(hResult, i, 0));
-            }
-            DBFreeResult(hResult);
-         }
-         else
-         {
-            success = false;
-         }
-         DBFreeStatement(hStmt);
+         for(int i = dashboards.getFirstRow(); i < dashboards.getEndRow(); i++)
+            m_dashboards.add(DBGetFieldULong(dashboards.getResult(), i, 0));
       }
       else
       {
@@ -647,25 +620,13 @@ bool NetObj::loadCommonProperties(DB_HANDLE hdb)
    // Load associated URLs
    if (success)
    {
-      hStmt = DBPrepare(hdb, _T("SELECT url_id,url,description FROM object_urls WHERE object_id=?"));
-      if (hStmt != nullptr)
+      ObjectDataRows urls(hdb, StartupDataSet::OBJECT_URLS,
+               _T("SELECT url_id,url,description,object_id FROM object_urls ORDER BY object_id"),
+               _T("SELECT url_id,url,description FROM object_urls WHERE object_id=?"), m_id);
+      if (urls.isValid())
       {
-         DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-         DB_RESULT hResult = DBSelectPrepared(hStmt);
-         if (hResult != nullptr)
-         {
-            int count = DBGetNumRows(hResult);
-            for(int i = 0; i < count; i++)
-            {
-               m_urls.add(new ObjectUrl(hResult, i));
-            }
-            DBFreeResult(hResult);
-         }
-         else
-         {
-            success = false;
-         }
-         DBFreeStatement(hStmt);
+         for(int i = urls.getFirstRow(); i < urls.getEndRow(); i++)
+            m_urls.add(new ObjectUrl(urls.getResult(), i));
       }
       else
       {
@@ -676,29 +637,20 @@ bool NetObj::loadCommonProperties(DB_HANDLE hdb)
 	if (success)
 		success = loadTrustedNodes(hdb);
 
-	if (success)
-	{
-      success = false;
-	   hStmt = DBPrepare(hdb, _T("SELECT user_id FROM responsible_users WHERE object_id=?"));
-	   if (hStmt != nullptr)
-	   {
-	      DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-	      DB_RESULT hResult = DBSelectPrepared(hStmt);
-	      if (hResult != nullptr)
-	      {
-	         success = true;
-	         int numRows = DBGetNumRows(hResult);
-	         if (numRows > 0)
-	         {
-	            m_responsibleUsers = new IntegerArray<uint32_t>(numRows, 16);
-               for(int i = 0; i < numRows; i++)
-                  m_responsibleUsers->add(DBGetFieldULong(hResult, i, 0));
-	         }
-	         DBFreeResult(hResult);
-	      }
-	      DBFreeStatement(hStmt);
-	   }
-	}
+   // Load responsible users
+   if (success)
+   {
+      ObjectDataRows users(hdb, StartupDataSet::RESPONSIBLE_USERS,
+               _T("SELECT user_id,object_id FROM responsible_users ORDER BY object_id"),
+               _T("SELECT user_id FROM responsible_users WHERE object_id=?"), m_id);
+      success = users.isValid();
+      if (success && (users.getRowCount() > 0))
+      {
+         m_responsibleUsers = new IntegerArray<uint32_t>(users.getRowCount(), 16);
+         for(int i = users.getFirstRow(); i < users.getEndRow(); i++)
+            m_responsibleUsers->add(DBGetFieldULong(users.getResult(), i, 0));
+      }
+   }
 
 	if (!success)
 		nxlog_debug_tag(DEBUG_TAG_OBJECT_LIFECYCLE, 4, _T("NetObj::loadCommonProperties() failed for object %s [%ld] class=%d"), m_name, (long)m_id, getObjectClass());
@@ -1086,24 +1038,15 @@ void NetObj::calculateCompoundStatus(BOOL bForcedRecalc)
  */
 bool NetObj::loadACLFromDB(DB_HANDLE hdb)
 {
-   bool success = false;
+   ObjectDataRows acl(hdb, StartupDataSet::ACL,
+            _T("SELECT user_id,access_rights,object_id FROM acl ORDER BY object_id"),
+            _T("SELECT user_id,access_rights FROM acl WHERE object_id=?"), m_id);
+   if (!acl.isValid())
+      return false;
 
-	DB_STATEMENT hStmt = DBPrepare(hdb, _T("SELECT user_id,access_rights FROM acl WHERE object_id=?"));
-	if (hStmt != NULL)
-	{
-		DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-		DB_RESULT hResult = DBSelectPrepared(hStmt);
-		if (hResult != NULL)
-		{
-			int count = DBGetNumRows(hResult);
-			for(int i = 0; i < count; i++)
-				m_accessList.addElement(DBGetFieldULong(hResult, i, 0), DBGetFieldULong(hResult, i, 1));
-			DBFreeResult(hResult);
-			success = true;
-		}
-		DBFreeStatement(hStmt);
-	}
-   return success;
+   for(int i = acl.getFirstRow(); i < acl.getEndRow(); i++)
+      m_accessList.addElement(DBGetFieldULong(acl.getResult(), i, 0), DBGetFieldULong(acl.getResult(), i, 1));
+   return true;
 }
 
 /**
@@ -1307,9 +1250,14 @@ void NetObj::setModified(uint32_t flags, bool notify)
    if (g_bModificationsLocked)
       return;
 
+   bool wasModified = (m_modified != 0);
    InterlockedOr(&m_modified, flags);
    m_timestamp = time(nullptr);
 
+   // Syncer only processes objects registered as modified
+   if (!wasModified && (m_id != 0))
+      RegisterModifiedObject(m_id);
+
    // Send event to all connected clients
    if (notify && !m_isHidden && !m_isSystem)
    {
@@ -1849,23 +1797,19 @@ void NetObj::commentsToMessage(NXCPMessage *pMsg)
  */
 bool NetObj::loadTrustedNodes(DB_HANDLE hdb)
 {
-	TCHAR query[256];
-	_sntprintf(query, 256, _T("SELECT target_node_id FROM trusted_nodes WHERE source_object_id=%d"), m_id);
-	DB_RESULT hResult = DBSelect(hdb, query);
-	if (hResult != NULL)
-	{
-		int count = DBGetNumRows(hResult);
-		if (count > 0)
-		{
-		   m_trustedNodes = new IntegerArray<uint32_t>(count);
-			for(int i = 0; i < count; i++)
-			{
-				m_trustedNodes->add(DBGetFieldULong(hResult, i, 0));
-			}
-		}
-		DBFreeResult(hResult);
-	}
-	return (hResult != nullptr);
+   ObjectDataRows nodes(hdb, StartupDataSet::TRUSTED_NODES,
+            _T("SELECT target_node_id,source_object_id FROM trusted_nodes ORDER BY source_object_id"),
+            _T("SELECT target_node_id FROM trusted_nodes WHERE source_object_id=?"), m_id);
+   if (!nodes.isValid())
+      return false;
+
+   if (nodes.getRowCount() > 0)
+   {
+      m_trustedNodes = new IntegerArray<uint32_t>(nodes.getRowCount());
+      for(int i = nodes.getFirstRow(); i < nodes.getEndRow(); i++)
+         m_trustedNodes->add(DBGetFieldULong(nodes.getResult(), i, 0));
+   }
+   return true;
 }
 
 /**
@@ -2558,32 +2502,36 @@ StringBuffer NetObj::expandText(const TCHAR *textTemplate, const Alarm *alarm, c
 {
    if (textTemplate == nullptr)
       return StringBuffer();
+   TextTemplate compiledTemplate(textTemplate);
+   return expandText(compiledTemplate, alarm, event, dci, userName, objectName, instance, inputFields, args);
+}
 
-   TCHAR buffer[256];
-   char entryPoint[MAX_IDENTIFIER_LENGTH];
-   int i;
+/**
+ * Expand precompiled text template
+ */
+StringBuffer NetObj::expandText(const TextTemplate& textTemplate, const Alarm *alarm, const Event *event, const shared_ptr<DCObjectInfo>& dci,
+         const TCHAR *userName, const TCHAR *objectName, const TCHAR *instance, const StringMap *inputFields, const StringList *args)
+{
+   if (textTemplate.isNull())
+      return StringBuffer();
 
    nxlog_debug_tag(_T("obj.macro"), 8, _T("NetObj::expandText(sourceObject=%u template='%s' alarm=%u event=") UINT64_FMT _T(" instance='%s')"),
-             m_id, CHECK_NULL(textTemplate), (alarm == nullptr) ? 0 : alarm->getAlarmId() , (event == nullptr) ? 0 : event->getId(),
+             m_id, textTemplate.getSource(), (alarm == nullptr) ? 0 : alarm->getAlarmId() , (event == nullptr) ? 0 : event->getId(),
              CHECK_NULL(instance));
 
    StringBuffer output;
-   for(const TCHAR *curr = textTemplate; *curr != 0; curr++)
+   TCHAR buffer[256];
+   for(int i = 0; i < textTemplate.size(); i++)
    {
-      switch(*curr)
+      const TextTemplateToken *token = textTemplate.get(i);
+      switch(token->type)
       {
-         case '%':   // Metacharacter
-            curr++;
-            if (*curr == 0)
-            {
-               curr--;
-               break;   // Abnormal loop termination
-            }
-            switch(*curr)
+         case TextTemplateTokenType::TEXT:
+            output.append(token->text, token->length);
+            break;
+         case TextTemplateTokenType::MACRO:
+            switch(token->macro)
             {
-               case '%':
-                  output.append(_T('%'));
-                  break;
                case 'a':   // IP address of event source
                   output.append(getPrimaryIpAddress().toString(buffer));
                   break;
@@ -2638,7 +2586,7 @@ StringBuffer NetObj::expandText(const TCHAR *textTemplate, const Alarm *alarm, c
                   }
                   break;
                case 'n':   // Name of event source
-                  output.append((objectName != NULL) ? objectName : getName());
+                  output.append((objectName != nullptr) ? objectName : getName());
                   break;
                case 'N':   // Event name
                   if (event != nullptr)
@@ -2713,228 +2661,111 @@ StringBuffer NetObj::expandText(const TCHAR *textTemplate, const Alarm *alarm, c
                      }
                   }
                   break;
-               case '0':
-               case '1':
-               case '2':
-               case '3':
-               case '4':
-               case '5':
-               case '6':
-               case '7':
-               case '8':
-               case '9':
-                  buffer[0] = *curr;
-                  if (isdigit(*(curr + 1)))
-                  {
-                     curr++;
-                     buffer[1] = *curr;
-                     buffer[2] = 0;
-                  }
-                  else
-                  {
-                     buffer[1] = 0;
-                  }
-                  if (event != nullptr)
-                     output.append(static_cast<TCHAR*>(event->getParameterList()->get(_tcstol(buffer, nullptr, 10) - 1)));
-                  else if (args != nullptr)
-                     output.append(args->get(_tcstol(buffer, nullptr, 10) - 1));
-                  break;
-               case '[':   // Script
-                  for(i = 0, curr++; (*curr != ']') && (*curr != 0) && (i < 255); curr++)
-                  {
-                     buffer[i++] = *curr;
-                  }
-                  if (*curr == 0)  // no terminating ]
-                  {
-                     curr--;
-                  }
-                  else
-                  {
-                     buffer[i] = 0;
-
-                     // Entry point can be given in form script/entry_point
-                     TCHAR *s = _tcschr(buffer, _T('/'));
-                     if (s != nullptr)
-                     {
-                        *s = 0;
-                        s++;
-                        Trim(s);
+            }
+            break;
+         case TextTemplateTokenType::PARAMETER:
+            if (event != nullptr)
+               output.append(static_cast<TCHAR*>(event->getParameterList()->get(token->index)));
+            else if (args != nullptr)
+               output.append(args->get(token->index));
+            break;
+         case TextTemplateTokenType::SCRIPT:
+            {
+               char entryPoint[MAX_IDENTIFIER_LENGTH];
+               if (token->extra != nullptr)
+               {
 #ifdef UNICODE
-                        WideCharToMultiByte(CP_UTF8, 0, s, -1, entryPoint, MAX_IDENTIFIER_LENGTH, NULL, NULL);
-                        entryPoint[MAX_IDENTIFIER_LENGTH - 1] = 0;
+                  WideCharToMultiByte(CP_UTF8, 0, token->extra, -1, entryPoint, MAX_IDENTIFIER_LENGTH, nullptr, nullptr);
+                  entryPoint[MAX_IDENTIFIER_LENGTH - 1] = 0;
 #else
-                        strlcpy(entryPoint, s, MAX_IDENTIFIER_LENGTH);
+                  strlcpy(entryPoint, token->extra, MAX_IDENTIFIER_LENGTH);
 #endif
-                     }
-                     else
-                     {
-                        entryPoint[0] = 0;
-                     }
-                     Trim(buffer);
-
-                     NXSL_VM *vm = CreateServerScriptVM(buffer, self(), dci);
-                     if (vm != nullptr)
-                     {
-                        if (event != nullptr)
-                           vm->setGlobalVariable("$event", vm->createValue(new NXSL_Object(vm, &g_nxslEventClass, event, true)));
-                        if (alarm != nullptr)
-                        {
-                           vm->setGlobalVariable("$alarm", vm->createValue(new NXSL_Object(vm, &g_nxslAlarmClass, alarm, true)));
-                           vm->setGlobalVariable("$alarmMessage", vm->createValue(alarm->getMessage()));
-                           vm->setGlobalVariable("$alarmKey", vm->createValue(alarm->getKey()));
-                        }
-
-                        if (vm->run(0, nullptr, nullptr, nullptr, nullptr, (entryPoint[0] != 0) ? entryPoint : nullptr))
-                        {
-                           NXSL_Value *result = vm->getResult();
-                           const TCHAR *temp = result->getValueAsCString();
-                           if (temp != nullptr)
-                           {
-                              output.append(temp);
-                              DbgPrintf(4, _T("NetObj::ExpandText(%d, \"%s\"): Script %s executed successfully"),
-                                 (int)((event != nullptr) ? event->getCode() : 0), textTemplate, buffer);
-                           }
-                        }
-                        else
-                        {
-                           DbgPrintf(4, _T("NetObj::ExpandText(%d, \"%s\"): Script %s execution error: %s"),
-                                     (int)((event != nullptr) ? event->getCode() : 0), textTemplate, buffer, vm->getErrorText());
-                           PostSystemEvent(EVENT_SCRIPT_ERROR, g_dwMgmtNode, "ssd", buffer, vm->getErrorText(), 0);
-                        }
-                        delete vm;
-                     }
-                     else
-                     {
-                        DbgPrintf(4, _T("NetObj::ExpandText(%d, \"%s\"): Cannot find script %s"),
-                           (int)((event != nullptr) ? event->getCode() : 0), textTemplate, buffer);
-                     }
-                  }
-                  break;
-               case '{':   // Custom attribute
-                  for(i = 0, curr++; (*curr != '}') && (*curr != 0) && (i < 255); curr++)
-                  {
-                     buffer[i++] = *curr;
-                  }
-                  if (*curr == 0)  // no terminating }
+               }
+               else
+               {
+                  entryPoint[0] = 0;
+               }
+
+               NXSL_VM *vm = CreateServerScriptVM(token->text, self(), dci);
+               if (vm != nullptr)
+               {
+                  if (event != nullptr)
+                     vm->setGlobalVariable("$event", vm->createValue(new NXSL_Object(vm, &g_nxslEventClass, event, true)));
+                  if (alarm != nullptr)
                   {
-                     curr--;
+                     vm->setGlobalVariable("$alarm", vm->createValue(new NXSL_Object(vm, &g_nxslAlarmClass, alarm, true)));
+                     vm->setGlobalVariable("$alarmMessage", vm->createValue(alarm->getMessage()));
+                     vm->setGlobalVariable("$alarmKey", vm->createValue(alarm->getKey()));
                   }
-                  else
+
+                  if (vm->run(0, nullptr, nullptr, nullptr, nullptr, (entryPoint[0] != 0) ? entryPoint : nullptr))
                   {
-                     buffer[i] = 0;
-                     TCHAR *defaultValue = _tcschr(buffer, _T(':'));
-                     if (defaultValue != nullptr)
-                     {
-                        *defaultValue = 0;
-                        defaultValue++;
-                     }
-                     Trim(buffer);
-                     TCHAR *v = nullptr;
-                     if (instance != nullptr)
+                     NXSL_Value *result = vm->getResult();
+                     const TCHAR *temp = result->getValueAsCString();
+                     if (temp != nullptr)
                      {
-                        TCHAR tmp[128];
-                        _sntprintf(tmp, 128, _T("%s::%s"), buffer, instance);
-                        v = getCustomAttributeCopy(tmp);
+                        output.append(temp);
+                        DbgPrintf(4, _T("NetObj::ExpandText(%d, \"%s\"): Script %s executed successfully"),
+                           (int)((event != nullptr) ? event->getCode() : 0), textTemplate.getSource(), token->text);
                      }
-                     else if (event != nullptr)
-                     {
-                        const StringList *names = event->getParameterNames();
-                        int index = names->indexOfIgnoreCase(_T("instance"));
-                        if (index != -1)
-                        {
-                           TCHAR tmp[128];
-                           _sntprintf(tmp, 128, _T("%s::%s"), buffer, event->getParameter(index));
-                           v = getCustomAttributeCopy(tmp);
-                        }
-                     }
-                     if (v == nullptr)
-                        v = getCustomAttributeCopy(buffer);
-                     if (v != nullptr)
-                        output.appendPreallocated(v);
-                     else if (defaultValue != nullptr)
-                        output.append(defaultValue);
-                  }
-                  break;
-               case '(':   // Input field
-                  for(i = 0, curr++; (*curr != ')') && (*curr != 0) && (i < 255); curr++)
-                  {
-                     buffer[i++] = *curr;
                   }
-                  if (*curr == 0)  // no terminating )
-                  {
-                     curr--;
-                  }
-                  else if (inputFields != nullptr)
-                  {
-                     buffer[i] = 0;
-                     Trim(buffer);
-                     output.append(inputFields->get(buffer));
-                  }
-                  break;
-               case '<':   // Named parameter
-                  if (event != nullptr)
+                  else
                   {
-                     for(i = 0, curr++; (*curr != '>') && (*curr != 0) && (i < 255); curr++)
-                     {
-                        buffer[i++] = *curr;
-                     }
-                     if (*curr == 0)  // no terminating >
-                     {
-                        curr--;
-                     }
-                     else
-                     {
-                        buffer[i] = 0;
-                        const StringList *names = event->getParameterNames();
-                        TCHAR *defaultValue = _tcschr(buffer, _T(':'));
-                        if (defaultValue != nullptr)
-                        {
-                           *defaultValue = 0;
-                           defaultValue++;
-                           Trim(buffer);
-                           int index = names->indexOfIgnoreCase(buffer);
-                           if (index != -1)
-                              output.append(event->getParameter(index));
-                           else
-                              output.append(defaultValue);
-                        }
-                        else
-                        {
-                           Trim(buffer);
-                           int index = names->indexOfIgnoreCase(buffer);
-                           if (index != -1)
-                              output.append(event->getParameter(index));
-                        }
-                     }
+                     DbgPrintf(4, _T("NetObj::ExpandText(%d, \"%s\"): Script %s execution error: %s"),
+                               (int)((event != nullptr) ? event->getCode() : 0), textTemplate.getSource(), token->text, vm->getErrorText());
+                     PostSystemEvent(EVENT_SCRIPT_ERROR, g_dwMgmtNode, "ssd", token->text, vm->getErrorText(), 0);
                   }
-                  break;
-               default:    // All other characters are invalid, ignore
-                  break;
+                  delete vm;
+               }
+               else
+               {
+                  DbgPrintf(4, _T("NetObj::ExpandText(%d, \"%s\"): Cannot find script %s"),
+                     (int)((event != nullptr) ? event->getCode() : 0), textTemplate.getSource(), token->text);
+               }
             }
             break;
-         case '\\':  // Escape character
-            curr++;
-            if (*curr == 0)
+         case TextTemplateTokenType::CUSTOM_ATTRIBUTE:
             {
-               curr--;
-               break;   // Abnormal loop termination
+               TCHAR *v = nullptr;
+               if (instance != nullptr)
+               {
+                  TCHAR tmp[128];
+                  _sntprintf(tmp, 128, _T("%s::%s"), token->text, instance);
+                  v = getCustomAttributeCopy(tmp);
+               }
+               else if (event != nullptr)
+               {
+                  const StringList *names = event->getParameterNames();
+                  int index = names->indexOfIgnoreCase(_T("instance"));
+                  if (index != -1)
+                  {
+                     TCHAR tmp[128];
+                     _sntprintf(tmp, 128, _T("%s::%s"), token->text, event->getParameter(index));
+                     v = getCustomAttributeCopy(tmp);
+                  }
+               }
+               if (v == nullptr)
+                  v = getCustomAttributeCopy(token->text);
+               if (v != nullptr)
+                  output.appendPreallocated(v);
+               else if (token->extra != nullptr)
+                  output.append(token->extra);
             }
-            switch(*curr)
+            break;
+         case TextTemplateTokenType::INPUT_FIELD:
+            if (inputFields != nullptr)
+               output.append(inputFields->get(token->text));
+            break;
+         case TextTemplateTokenType::NAMED_PARAMETER:
+            if (event != nullptr)
             {
-               case 't':
-                  output.append(_T('\t'));
-                  break;
-               case 'n':
-                  output.append(_T("\r\n"));
-                  break;
-               default:
-                  output.append(*curr);
-                  break;
+               int index = event->getParameterNames()->indexOfIgnoreCase(token->text);
+               if (index != -1)
+                  output.append(event->getParameter(index));
+               else if (token->extra != nullptr)
+                  output.append(token->extra);
             }
             break;
-         default:
-            output.append(*curr);
-            break;
       }
    }
    return output;
@@ -98,6 +98,7 @@ Node::Node() : super(), m_discoveryPollState(_T("discovery")),
    m_snmpVersion = SNMP_VERSION_2C;
    m_snmpPort = SNMP_DEFAULT_PORT;
    m_snmpSecurity = new SNMP_SecurityContext("public");
+   m_snmpRequestScheduler = make_shared<SNMP_RequestScheduler>();
    m_snmpObjectId = nullptr;
    m_downSince = 0;
    m_bootTime = 0;
@@ -214,6 +215,7 @@ Node::Node(const NewNodeData *newNodeData, UINT32 flags)  : super(), m_discovery
       m_snmpSecurity = new SNMP_SecurityContext(newNodeData->snmpSecurity);
    else
       m_snmpSecurity = new SNMP_SecurityContext("public");
+   m_snmpRequestScheduler = make_shared<SNMP_RequestScheduler>();
    if (newNodeData->name[0] != 0)
       _tcslcpy(m_name, newNodeData->name, MAX_OBJECT_NAME);
    else
@@ -5795,6 +5797,7 @@ DataCollectionError Node::getMetricFromSNMP(UINT16 port, SNMP_Version version, c
    SNMP_Transport *snmp = createSnmpTransport(port, version);
    if (snmp != nullptr)
    {
+      snmp->setPriority(SNMP_REQUEST_PRIORITY_HIGH);   // Data collection requests have priority over polls and discovery
       if (interpretRawValue == SNMP_RAWTYPE_NONE)
       {
          snmpResult = SnmpGetEx(snmp, name, nullptr, 0, buffer, size * sizeof(TCHAR), SG_PSTRING_RESULT, nullptr);
@@ -5926,6 +5929,7 @@ DataCollectionError Node::getTableFromSNMP(UINT16 port, SNMP_Version version, co
    SNMP_Transport *snmp = createSnmpTransport(port, version);
    if (snmp == nullptr)
       return DCE_COMM_ERROR;
+   snmp->setPriority(SNMP_REQUEST_PRIORITY_HIGH);
 
    ObjectArray<SNMP_ObjectId> oidList(64, 64, Ownership::True);
    uint32_t rc = SnmpWalk(snmp, oid, SNMPGetTableCallback, &oidList);
@@ -6627,6 +6631,10 @@ DataCollectionError Node::getInternalMetric(const TCHAR *name, TCHAR *buffer, si
          rc = DCE_NOT_SUPPORTED;
       }
    }
+   else if (!_tcsnicmp(name, _T("SNMP."), 5))
+   {
+      rc = getSnmpSchedulerMetric(&name[5], buffer, size);
+   }
    else if (!_tcsicmp(name, _T("PollTime.RoutingTable.Average")))
    {
       lockProperties();
@@ -6878,6 +6886,10 @@ DataCollectionError Node::getInternalMetric(const TCHAR *name, TCHAR *buffer, si
       {
          _sntprintf(buffer, size, UINT64_FMT, g_idataWriteRequests);
       }
+      else if (!_tcsicmp(name, _T("Server.DBWriter.Requests.TData")))
+      {
+         _sntprintf(buffer, size, UINT64_FMT, g_tdataWriteRequests);
+      }
       else if (!_tcsicmp(name, _T("Server.DBWriter.Requests.Other")))
       {
          _sntprintf(buffer, size, UINT64_FMT, g_otherWriteRequests);
@@ -6886,6 +6898,74 @@ DataCollectionError Node::getInternalMetric(const TCHAR *name, TCHAR *buffer, si
       {
          _sntprintf(buffer, size, UINT64_FMT, g_rawDataWriteRequests);
       }
+      else if (MatchString(_T("Server.DBWriter.WaitTimePercentile(*)"), name, false))
+      {
+         rc = GetLatencyPercentile(LatencySource::DB_WRITER_WAIT_TIME, name, buffer);
+      }
+      else if (MatchString(_T("Server.DBWriter.WriteTimePercentile(*)"), name, false))
+      {
+         rc = GetLatencyPercentile(LatencySource::DB_WRITER_WRITE_TIME, name, buffer);
+      }
+      else if (!_tcsicmp(name, _T("Server.EventLogWriter.AverageBatchTime")))
+      {
+         EventLogWriterStats stats;
+         GetEventLogWriterStats(&stats);
+         ret_uint64(buffer, (stats.batches > 0) ? stats.totalWriteTime / stats.batches : 0);
+      }
+      else if (!_tcsicmp(name, _T("Server.EventLogWriter.Batches")))
+      {
+         EventLogWriterStats stats;
+         GetEventLogWriterStats(&stats);
+         ret_uint64(buffer, stats.batches);
+      }
+      else if (!_tcsicmp(name, _T("Server.EventLogWriter.DroppedEvents")))
+      {
+         EventLogWriterStats stats;
+         GetEventLogWriterStats(&stats);
+         ret_uint64(buffer, stats.droppedEvents);
+      }
+      else if (!_tcsicmp(name, _T("Server.EventLogWriter.MaxBatchTime")))
+      {
+         EventLogWriterStats stats;
+         GetEventLogWriterStats(&stats);
+         ret_uint(buffer, stats.maxBatchWriteTime);
+      }
+      else if (!_tcsicmp(name, _T("Server.EventLogWriter.MaxQueueSize")))
+      {
+         EventLogWriterStats stats;
+         GetEventLogWriterStats(&stats);
+         ret_uint64(buffer, stats.maxQueueSize);
+      }
+      else if (!_tcsicmp(name, _T("Server.EventLogWriter.WrittenEvents")))
+      {
+         EventLogWriterStats stats;
+         GetEventLogWriterStats(&stats);
+         ret_uint64(buffer, stats.writtenEvents);
+      }
+      else if (!_tcsicmp(name, _T("Server.EventRateLimiter.SummaryEvents")))
+      {
+         EventRateLimiterStats stats;
+         GetEventRateLimiterStats(&stats);
+         ret_uint64(buffer, stats.summaryEvents);
+      }
+      else if (!_tcsicmp(name, _T("Server.EventRateLimiter.SuppressedEvents")))
+      {
+         EventRateLimiterStats stats;
+         GetEventRateLimiterStats(&stats);
+         ret_uint64(buffer, stats.suppressedBySource + stats.suppressedByEventCode);
+      }
+      else if (!_tcsicmp(name, _T("Server.EventRateLimiter.SuppressedEvents.ByEventCode")))
+      {
+         EventRateLimiterStats stats;
+         GetEventRateLimiterStats(&stats);
+         ret_uint64(buffer, stats.suppressedByEventCode);
+      }
+      else if (!_tcsicmp(name, _T("Server.EventRateLimiter.SuppressedEvents.BySource")))
+      {
+         EventRateLimiterStats stats;
+         GetEventRateLimiterStats(&stats);
+         ret_uint64(buffer, stats.suppressedBySource);
+      }
       else if (MatchString(_T("Server.EventProcessor.AverageWaitTime(*)"), name, false))
       {
          rc = GetEventProcessorStatistic(name, 'W', buffer);
@@ -6934,10 +7014,54 @@ DataCollectionError Node::getInternalMetric(const TCHAR *name, TCHAR *buffer, si
       {
          ret_uint64(buffer, GetDCICacheMemoryUsage());
       }
+      else if (!_tcsicmp(name, _T("Server.MemoryUsage.Events")))
+      {
+         ret_uint64(buffer, GetMemoryUsage(MemoryCategory::EVENTS));
+      }
+      else if (!_tcsicmp(name, _T("Server.MemoryUsage.NXCPSendQueues")))
+      {
+         ret_uint64(buffer, GetMemoryUsage(MemoryCategory::NXCP_SEND_QUEUES));
+      }
+      else if (MatchString(_T("Server.MemoryUsage.ObjectClass(*)"), name, false))
+      {
+         rc = GetObjectClassMemoryUsage(name, buffer);
+      }
+      else if (!_tcsicmp(name, _T("Server.MemoryUsage.Objects")))
+      {
+         ret_uint64(buffer, GetObjectMemoryUsage());
+      }
+      else if (!_tcsicmp(name, _T("Server.MemoryUsage.Queues")))
+      {
+         ret_uint64(buffer, GetQueueMemoryUsage());
+      }
       else if (!_tcsicmp(name, _T("Server.MemoryUsage.RawDataWriter")))
       {
          ret_uint64(buffer, GetRawDataWriterMemoryUsage());
       }
+      else if (!_tcsicmp(name, _T("Server.MemoryUsage.ScriptVMs")))
+      {
+         ret_uint64(buffer, GetMemoryUsage(MemoryCategory::SCRIPT_VMS));
+      }
+      else if (MatchString(_T("Server.NotificationChannel.AverageLatency(*)"), name, false))
+      {
+         rc = GetNotificationChannelStatistic(name, 'L', buffer);
+      }
+      else if (MatchString(_T("Server.NotificationChannel.MaxLatency(*)"), name, false))
+      {
+         rc = GetNotificationChannelStatistic(name, 'M', buffer);
+      }
+      else if (MatchString(_T("Server.NotificationChannel.MessagesFailed(*)"), name, false))
+      {
+         rc = GetNotificationChannelStatistic(name, 'F', buffer);
+      }
+      else if (MatchString(_T("Server.NotificationChannel.MessagesSent(*)"), name, false))
+      {
+         rc = GetNotificationChannelStatistic(name, 'S', buffer);
+      }
+      else if (MatchString(_T("Server.NotificationChannel.QueueSize(*)"), name, false))
+      {
+         rc = GetNotificationChannelStatistic(name, 'Q', buffer);
+      }
       else if (!_tcsicmp(name, _T("Server.ObjectCount.Clusters")))
       {
          ret_uint(buffer, static_cast<uint32_t>(g_idxClusterById.size()));
@@ -7010,6 +7134,10 @@ DataCollectionError Node::getInternalMetric(const TCHAR *name, TCHAR *buffer, si
       {
          rc = GetThreadPoolStat(THREAD_POOL_CURR_SIZE, name, buffer);
       }
+      else if (MatchString(_T("Server.ThreadPool.ExecutionTimePercentile(*)"), name, false))
+      {
+         rc = GetLatencyPercentile(LatencySource::THREAD_POOL_EXECUTION_TIME, name, buffer);
+      }
       else if (MatchString(_T("Server.ThreadPool.Load(*)"), name, false))
       {
          rc = GetThreadPoolStat(THREAD_POOL_LOAD, name, buffer);
@@ -7042,6 +7170,10 @@ DataCollectionError Node::getInternalMetric(const TCHAR *name, TCHAR *buffer, si
       {
          rc = GetThreadPoolStat(THREAD_POOL_USAGE, name, buffer);
       }
+      else if (MatchString(_T("Server.ThreadPool.WaitTimePercentile(*)"), name, false))
+      {
+         rc = GetLatencyPercentile(LatencySource::THREAD_POOL_WAIT_TIME, name, buffer);
+      }
       else if (!_tcsicmp(name, _T("Server.TotalEventsProcessed")))
       {
          _sntprintf(buffer, size, UINT64_FMT, g_totalEventsProcessed);
@@ -8678,9 +8810,14 @@ SNMP_Transport *Node::createSnmpTransport(UINT16 port, SNMP_Version version, con
       }
    }
 
-   // Set security
+   // Set security and request scheduler
    if (pTransport != nullptr)
    {
+      m_snmpRequestScheduler->setLimits(
+               getCustomAttributeAsUInt32(_T("snmp.maxinflight"), g_snmpMaxRequestsInFlight),
+               getCustomAttributeAsUInt32(_T("snmp.ratelimit"), g_snmpRequestRateLimit));
+      pTransport->setScheduler(m_snmpRequestScheduler);
+
       lockProperties();
       SNMP_Version effectiveVersion = (version != SNMP_VERSION_DEFAULT) ? version : m_snmpVersion;
       pTransport->setSnmpVersion(effectiveVersion);
@@ -8892,6 +9029,7 @@ void Node::topologyPollWorkerEntry(PollerInfo *poller)
 void Node::topologyPollWorkerEntry(PollerInfo *poller, ClientSession *session, UINT32 rqId)
 {
    poller->startExecution();
+   PerfScopedTimer perfTimer(PerfHotPath::TOPOLOGY_POLL, m_id);
    topologyPoll(poller, session, rqId);
    delete poller;
 }
@@ -10926,6 +11064,35 @@ StringList *Node::getIcmpStatCollectors() const
    return collectors;
 }
 
+/**
+ * Get SNMP request scheduler metric (name is given without "SNMP." prefix)
+ */
+DataCollectionError Node::getSnmpSchedulerMetric(const TCHAR *name, TCHAR *buffer, size_t size) const
+{
+   SNMP_RequestSchedulerStatistics stats;
+   m_snmpRequestScheduler->getStatistics(&stats);
+
+   if (!_tcsicmp(name, _T("Queue.Size")))
+      _sntprintf(buffer, size, _T("%u"), stats.queueSize);
+   else if (!_tcsicmp(name, _T("Queue.Timeouts")))
+      _sntprintf(buffer, size, UINT64_FMT, stats.queueTimeouts);
+   else if (!_tcsicmp(name, _T("Queue.WaitTime.Average")))
+      _sntprintf(buffer, size, _T("%u"), stats.averageWaitTime);
+   else if (!_tcsicmp(name, _T("Requests.InFlight")))
+      _sntprintf(buffer, size, _T("%u"), stats.inFlight);
+   else if (!_tcsicmp(name, _T("Requests.Timeouts")))
+      _sntprintf(buffer, size, UINT64_FMT, stats.timeouts);
+   else if (!_tcsicmp(name, _T("Requests.Total")))
+      _sntprintf(buffer, size, UINT64_FMT, stats.requests);
+   else if (!_tcsicmp(name, _T("ResponseTime.Average")))
+      _sntprintf(buffer, size, _T("%u"), stats.averageResponseTime);
+   else if (!_tcsicmp(name, _T("ResponseTime.Last")))
+      _sntprintf(buffer, size, _T("%u"), stats.lastResponseTime);
+   else
+      return DCE_NOT_SUPPORTED;
+   return DCE_SUCCESS;
+}
+
 /**
  * Get ICMP poll statistic for given target and function
  */
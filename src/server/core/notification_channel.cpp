@@ -39,6 +39,7 @@ class NotificationMessage
    TCHAR *m_recipient;
    TCHAR *m_subject;
    TCHAR *m_body;
+   int64_t m_queueTime;
 
 public:
    NotificationMessage(const TCHAR *recipient, const TCHAR *subject, const TCHAR *body);
@@ -47,8 +48,45 @@ class NotificationMessage
    const TCHAR *getRecipient() const { return m_recipient; }
    const TCHAR *getSubject() const { return m_subject; }
    const TCHAR *getBody() const { return m_body; }
+   int64_t getQueueTime() const { return m_queueTime; }
 };
 
+/**
+ * Notification log record
+ */
+struct NotificationLogRecord
+{
+   TCHAR channel[MAX_OBJECT_NAME];
+   time_t timestamp;
+   TCHAR *recipient;
+   TCHAR *subject;
+   TCHAR *body;
+   bool success;
+
+   NotificationLogRecord(const TCHAR *_channel, const NotificationMessage *message, bool _success)
+   {
+      _tcslcpy(channel, _channel, MAX_OBJECT_NAME);
+      timestamp = time(nullptr);
+      recipient = MemCopyString(message->getRecipient());
+      subject = MemCopyString(message->getSubject());
+      body = MemCopyString(message->getBody());
+      success = _success;
+   }
+
+   ~NotificationLogRecord()
+   {
+      MemFree(recipient);
+      MemFree(subject);
+      MemFree(body);
+   }
+};
+
+/**
+ * Notification log writer queue
+ */
+static ObjectQueue<NotificationLogRecord> s_notificationLogQueue(256, Ownership::True);
+static THREAD s_notificationLogWriterThread = INVALID_THREAD_HANDLE;
+
 /**
  * Storage manager for driver
  */
@@ -192,6 +230,18 @@ enum class NCSendStatus
    FAILED = 2
 };
 
+/**
+ * Notification channel statistics
+ */
+struct NotificationChannelStats
+{
+   uint64_t messagesSent;
+   uint64_t messagesFailed;
+   uint64_t batches;
+   uint32_t averageLatency;   // Exponential moving average of time spent in queue (milliseconds)
+   uint32_t maxLatency;
+};
+
 /**
  * Configured notification channel
  */
@@ -210,6 +260,15 @@ class NotificationChannel
    TCHAR m_errorMessage[MAX_NC_ERROR_MESSAGE];
    NCDriverServerStorageManager *m_storageManager;
    NCSendStatus m_lastStatus;
+   Condition m_shutdownCondition;
+   uint32_t m_batchWindow;
+   int m_maxBatchSize;
+   double m_rateLimit;     // Tokens per millisecond (0 if rate limiting is off)
+   double m_burstSize;
+   double m_tokens;
+   int64_t m_lastTokenUpdate;
+   NotificationChannelStats m_stats;
+   Mutex m_statsLock;
 
    void setError(const TCHAR *message)
    {
@@ -224,7 +283,11 @@ class NotificationChannel
    }
 
    void workerThread();
-   void writeNotificationLog(const TCHAR *recipient, const TCHAR *subject, const TCHAR *body, bool success);
+   bool collectBatch(ObjectArray<NotificationMessage> *batch);
+   bool acquireToken();
+   void sendMessages(const NotificationMessage * const *messages, int count, bool batchMode);
+   void updateStats(const NotificationMessage * const *messages, int count, bool success);
+   void writeNotificationLog(const NotificationMessage *message, bool success);
 
 public:
    NotificationChannel(NCDriver *driver, NCDriverServerStorageManager *storageManager, const TCHAR *name,
@@ -239,6 +302,15 @@ class NotificationChannel
    void update(const TCHAR *description, const TCHAR *driverName, const char *config);
    void updateName(const TCHAR *newName) { _tcslcpy(m_name, newName, MAX_OBJECT_NAME); }
    void saveToDatabase();
+
+   int64_t getQueueSize() const { return m_notificationQueue.size(); }
+   NotificationChannelStats getStats()
+   {
+      m_statsLock.lock();
+      NotificationChannelStats stats = m_stats;
+      m_statsLock.unlock();
+      return stats;
+   }
 };
 
 /**
@@ -263,6 +335,7 @@ NotificationMessage::NotificationMessage(const TCHAR *recipient, const TCHAR *su
    m_recipient = MemCopyString(recipient);
    m_subject = MemCopyString(subject);
    m_body = MemCopyString(body);
+   m_queueTime = GetCurrentTimeMs();
 }
 
 /**
@@ -280,7 +353,7 @@ NotificationMessage::~NotificationMessage()
  */
 NotificationChannel::NotificationChannel(NCDriver *driver, NCDriverServerStorageManager *storageManager, const TCHAR *name,
          const TCHAR *description, const TCHAR *driverName, char *config, const NCConfigurationTemplate *confTemplate, const TCHAR *errorMessage) :
-                  m_notificationQueue(64, Ownership::True)
+                  m_notificationQueue(64, Ownership::True), m_shutdownCondition(true)
 {
    m_driver = driver;
    m_storageManager = storageManager;
@@ -292,6 +365,18 @@ NotificationChannel::NotificationChannel(NCDriver *driver, NCDriverServerStorage
    m_driverLock = MutexCreate();
    _tcslcpy(m_errorMessage, errorMessage, MAX_NC_ERROR_MESSAGE);
    m_lastStatus = NCSendStatus::UNKNOWN;
+
+   m_batchWindow = ConfigReadULong(_T("NotificationChannels.BatchWindow"), 0);
+   m_maxBatchSize = ConfigReadInt(_T("NotificationChannels.MaxBatchSize"), 50);
+   if (m_maxBatchSize < 1)
+      m_maxBatchSize = 1;
+   int rateLimit = ConfigReadInt(_T("NotificationChannels.RateLimit"), 0);
+   m_rateLimit = (rateLimit > 0) ? static_cast<double>(rateLimit) / 60000.0 : 0;
+   m_burstSize = std::max(ConfigReadInt(_T("NotificationChannels.RateLimit.Burst"), 10), 1);
+   m_tokens = m_burstSize;
+   m_lastTokenUpdate = GetCurrentTimeMs();
+   memset(&m_stats, 0, sizeof(m_stats));
+
    m_workerThread = ThreadCreateEx(this, &NotificationChannel::workerThread);
 }
 
@@ -300,6 +385,7 @@ NotificationChannel::NotificationChannel(NCDriver *driver, NCDriverServerStorage
  */
 NotificationChannel::~NotificationChannel()
 {
+   m_shutdownCondition.set();
    m_notificationQueue.setShutdownMode();
    ThreadJoin(m_workerThread);
    MutexDestroy(m_driverLock);
@@ -308,42 +394,191 @@ NotificationChannel::~NotificationChannel()
    MemFree(m_configuration);
 }
 
+/**
+ * Collect messages for batch sending. Waits for batch window to expire (if set) and then takes all messages
+ * already in queue, up to maximum batch size. Returns false if channel is shutting down.
+ */
+bool NotificationChannel::collectBatch(ObjectArray<NotificationMessage> *batch)
+{
+   int64_t deadline = GetCurrentTimeMs() + m_batchWindow;
+   while(batch->size() < m_maxBatchSize)
+   {
+      int64_t now = GetCurrentTimeMs();
+      NotificationMessage *notification = (now < deadline) ?
+               m_notificationQueue.getOrBlock(static_cast<uint32_t>(deadline - now)) : m_notificationQueue.get();
+      if (notification == INVALID_POINTER_VALUE)
+         return false;
+      if (notification == nullptr)
+      {
+         if (GetCurrentTimeMs() >= deadline)
+            break;
+         continue;
+      }
+      batch->add(notification);
+   }
+   return true;
+}
+
+/**
+ * Take one token from channel's rate limiter, waiting for it if necessary. Returns false if channel is shutting down.
+ */
+bool NotificationChannel::acquireToken()
+{
+   if (m_rateLimit == 0)
+      return true;
+
+   while(true)
+   {
+      int64_t now = GetCurrentTimeMs();
+      m_tokens = std::min(m_burstSize, m_tokens + static_cast<double>(now - m_lastTokenUpdate) * m_rateLimit);
+      m_lastTokenUpdate = now;
+      if (m_tokens >= 1)
+      {
+         m_tokens -= 1;
+         return true;
+      }
+
+      uint32_t waitTime = static_cast<uint32_t>((1 - m_tokens) / m_rateLimit) + 1;
+      nxlog_debug_tag(DEBUG_TAG, 7, _T("Rate limit reached for channel %s, waiting %u milliseconds"), m_name, waitTime);
+      if (m_shutdownCondition.wait(waitTime))
+         return false;
+   }
+}
+
+/**
+ * Update channel statistics after sending messages
+ */
+void NotificationChannel::updateStats(const NotificationMessage * const *messages, int count, bool success)
+{
+   int64_t now = GetCurrentTimeMs();
+   m_statsLock.lock();
+   if (success)
+      m_stats.messagesSent += count;
+   else
+      m_stats.messagesFailed += count;
+   m_stats.batches++;
+   for(int i = 0; i < count; i++)
+   {
+      uint32_t latency = static_cast<uint32_t>(now - messages[i]->getQueueTime());
+      if (latency > m_stats.maxLatency)
+         m_stats.maxLatency = latency;
+      m_stats.averageLatency = (m_stats.averageLatency * 15 + latency) / 16;
+   }
+   m_statsLock.unlock();
+}
+
+/**
+ * Send messages to same recipient (as single batch if batch mode is on)
+ */
+void NotificationChannel::sendMessages(const NotificationMessage * const *messages, int count, bool batchMode)
+{
+   MutexLock(m_driverLock);
+   if (m_driver != nullptr)
+   {
+      bool success;
+      if (batchMode && (count > 1))
+      {
+         NCMessage *batch = MemAllocArrayNoInit<NCMessage>(count);
+         for(int i = 0; i < count; i++)
+         {
+            batch[i].subject = messages[i]->getSubject();
+            batch[i].body = messages[i]->getBody();
+         }
+         success = m_driver->sendBatch(messages[0]->getRecipient(), batch, count);
+         MemFree(batch);
+         nxlog_debug_tag(DEBUG_TAG, 6, _T("Batch of %d messages sent to %s via channel %s"), count, CHECK_NULL(messages[0]->getRecipient()), m_name);
+      }
+      else
+      {
+         success = true;
+         for(int i = 0; i < count; i++)
+         {
+            if (!m_driver->send(messages[i]->getRecipient(), messages[i]->getSubject(), messages[i]->getBody()))
+               success = false;
+         }
+      }
+
+      if (success)
+      {
+         clearError();
+      }
+      else
+      {
+         for(int i = 0; i < count; i++)
+         {
+            PostSystemEvent(EVENT_NOTIFICATION_FAILURE, g_dwMgmtNode, "ssss", m_name,
+                  messages[i]->getRecipient(), messages[i]->getSubject(), messages[i]->getBody());
+         }
+         nxlog_debug_tag(DEBUG_TAG, 4, _T("Driver error for channel %s, %d message(s) dropped"), m_name, count);
+         setError(_T("Driver error"));
+      }
+      for(int i = 0; i < count; i++)
+         writeNotificationLog(messages[i], success);
+      updateStats(messages, count, success);
+   }
+   else
+   {
+      nxlog_debug_tag(DEBUG_TAG, 4, _T("No driver for channel %s, %d message(s) dropped"), m_name, count);
+      setError(_T("Driver not initialized"));
+   }
+   MutexUnlock(m_driverLock);
+}
+
 /**
  * Notification sending thread
  */
 void NotificationChannel::workerThread()
 {
    nxlog_debug_tag(DEBUG_TAG, 2, _T("Worker thread for channel %s started"), m_name);
-   while(true)
+   ObjectArray<NotificationMessage> batch(64, 64, Ownership::True);
+   ObjectArray<NotificationMessage> group(64, 64, Ownership::False);
+   bool running = true;
+   while(running)
    {
       NotificationMessage *notification = m_notificationQueue.getOrBlock();
       if (notification == INVALID_POINTER_VALUE)
          break;
+      batch.add(notification);
 
       MutexLock(m_driverLock);
-      if (m_driver != nullptr)
+      bool batchMode = (m_driver != nullptr) && m_driver->isBatchSendSupported();
+      MutexUnlock(m_driverLock);
+      if (batchMode)
+         running = collectBatch(&batch);
+
+      // Send messages grouped by recipient, each group counts as one delivery for rate limiting
+      while(running && !batch.isEmpty())
       {
-         bool success = m_driver->send(notification->getRecipient(), notification->getSubject(), notification->getBody());
-         if (success)
+         const TCHAR *recipient = batch.get(0)->getRecipient();
+         group.clear();
+         group.add(batch.get(0));
+         if (batchMode)
          {
-            clearError();
+            for(int i = 1; i < batch.size(); i++)
+            {
+               NotificationMessage *m = batch.get(i);
+               if (((recipient == nullptr) && (m->getRecipient() == nullptr)) ||
+                   ((recipient != nullptr) && (m->getRecipient() != nullptr) && !_tcscmp(recipient, m->getRecipient())))
+                  group.add(m);
+            }
          }
-         else
+
+         if (!acquireToken())
          {
-            PostSystemEvent(EVENT_NOTIFICATION_FAILURE, g_dwMgmtNode, "ssss", m_name,
-                  notification->getRecipient(), notification->getSubject(), notification->getBody());
-            nxlog_debug_tag(DEBUG_TAG, 4, _T("Driver error for channel %s, message dropped"), m_name);
-            setError(_T("Driver error"));
+            running = false;
+            break;
          }
-         writeNotificationLog(notification->getRecipient(), notification->getSubject(), notification->getBody(), success);
+         sendMessages(group.getBuffer(), group.size(), batchMode);
+
+         for(int i = 0; i < group.size(); i++)
+            batch.remove(group.get(i));
       }
-      else
+
+      if (!batch.isEmpty())
       {
-         nxlog_debug_tag(DEBUG_TAG, 4, _T("No driver for channel %s, message dropped"), m_name);
-         setError(_T("Driver not initialized"));
+         nxlog_debug_tag(DEBUG_TAG, 4, _T("Channel %s is shutting down, %d pending message(s) dropped"), m_name, batch.size());
+         batch.clear();
       }
-      MutexUnlock(m_driverLock);
-      delete notification;
    }
    nxlog_debug_tag(DEBUG_TAG, 2, _T("Worker thread for channel %s stopped"), m_name);
 }
@@ -455,33 +690,84 @@ void NotificationChannel::saveToDatabase()
 }
 
 /**
- * Save notification log to database
+ * Queue notification log record for writing to database
  */
-void NotificationChannel::writeNotificationLog(const TCHAR *recipient, const TCHAR *subject, const TCHAR *body, bool success)
+void NotificationChannel::writeNotificationLog(const NotificationMessage *message, bool success)
 {
-   DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
-   DB_STATEMENT hStmt;
+   s_notificationLogQueue.put(new NotificationLogRecord(m_name, message, success));
+}
 
-   hStmt = DBPrepare(hdb,
-               _T("INSERT INTO notification_log (id,notification_channel,notification_timestamp,recipient,subject,message,success) VALUES (?,?,?,?,?,?,?)"));
+/**
+ * Notification log writer thread. Writes queued records in batches, one transaction per batch.
+ */
+static void NotificationLogWriter()
+{
+   ThreadSetName("NCLogWriter");
 
-   if (hStmt != nullptr)
+   int maxRecordsPerTxn = ConfigReadInt(_T("DBWriter.MaxRecordsPerTransaction"), 1000);
+   if (maxRecordsPerTxn < 1)
+      maxRecordsPerTxn = 1;
+
+   bool running = true;
+   while(running)
    {
-      DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, s_notificationId++);
-      DBBind(hStmt, 2, DB_SQLTYPE_VARCHAR, m_name, DB_BIND_STATIC);
-      DBBind(hStmt, 3, DB_SQLTYPE_INTEGER, (uint32_t)time(nullptr));
-      DBBind(hStmt, 4, DB_SQLTYPE_VARCHAR, recipient, DB_BIND_STATIC);
-      DBBind(hStmt, 5, DB_SQLTYPE_VARCHAR, subject, DB_BIND_STATIC);
-      DBBind(hStmt, 6, DB_SQLTYPE_VARCHAR, body, DB_BIND_STATIC);
-      DBBind(hStmt, 7, DB_SQLTYPE_INTEGER, success ? 1 : 0);
-      DBExecute(hStmt);
-      DBFreeStatement(hStmt);
-   }
+      NotificationLogRecord *record = s_notificationLogQueue.getOrBlock();
+      if (record == INVALID_POINTER_VALUE)
+         break;
 
-   DBConnectionPoolReleaseConnection(hdb);
+      DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+      DB_STATEMENT hStmt = DBPrepare(hdb,
+               _T("INSERT INTO notification_log (id,notification_channel,notification_timestamp,recipient,subject,message,success) VALUES (?,?,?,?,?,?,?)"),
+               true);
+      if (hStmt != nullptr)
+      {
+         DBBegin(hdb);
+         int count = 0;
+         while(true)
+         {
+            uint64_t id = s_notificationId++;
+            DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, id);
+            DBBind(hStmt, 2, DB_SQLTYPE_VARCHAR, record->channel, DB_BIND_STATIC);
+            DBBind(hStmt, 3, DB_SQLTYPE_INTEGER, static_cast<uint32_t>(record->timestamp));
+            DBBind(hStmt, 4, DB_SQLTYPE_VARCHAR, record->recipient, DB_BIND_STATIC);
+            DBBind(hStmt, 5, DB_SQLTYPE_VARCHAR, record->subject, DB_BIND_STATIC);
+            DBBind(hStmt, 6, DB_SQLTYPE_VARCHAR, record->body, DB_BIND_STATIC);
+            DBBind(hStmt, 7, DB_SQLTYPE_INTEGER, record->success ? 1 : 0);
+            DBExecute(hStmt);
+
+            nxlog_debug_tag(DEBUG_TAG, 5, _T("NotificationLog: id ") UINT64_FMT _T(", channel %s, timestamp %u, recipient %s, subject %s, message %s, success %s"),
+                     id, record->channel, static_cast<uint32_t>(record->timestamp), CHECK_NULL(record->recipient),
+                     CHECK_NULL(record->subject), CHECK_NULL(record->body), record->success ? _T("True") : _T("False"));
+            delete record;
+
+            if (++count >= maxRecordsPerTxn)
+               break;
+            record = s_notificationLogQueue.get();
+            if (record == nullptr)
+               break;
+            if (record == INVALID_POINTER_VALUE)
+            {
+               running = false;
+               break;
+            }
+         }
+         DBCommit(hdb);
+         DBFreeStatement(hStmt);
+      }
+      else
+      {
+         delete record;
+      }
+      DBConnectionPoolReleaseConnection(hdb);
+   }
+}
 
-   nxlog_debug_tag(DEBUG_TAG, 5, _T("NotificationLog: id %u, channel %s, timestamp %u, recipient %s, subject %s, message %s, success %s"),
-    s_notificationId - 1, m_name, time(nullptr), recipient, subject, body, success ? _T("True") : _T("False"));
+/**
+ * Get size of notification log writer queue
+ */
+int64_t GetNotificationLogWriterQueueSize()
+{
+   return s_notificationLogQueue.size();
 }
 
 /**
@@ -895,6 +1181,65 @@ void ShutdownNotificationChannels()
    s_channelListLock.lock();
    s_channelList.clear();  // This will delete all channels and destructors will handle correct shutdown
    s_channelListLock.unlock();
+
+   s_notificationLogQueue.put(INVALID_POINTER_VALUE);
+   ThreadJoin(s_notificationLogWriterThread);
+   s_notificationLogWriterThread = INVALID_THREAD_HANDLE;
+}
+
+/**
+ * Get total size of all notification channel queues
+ */
+int64_t GetNotificationChannelQueueSize()
+{
+   int64_t size = 0;
+   s_channelListLock.lock();
+   Iterator<std::pair<const TCHAR*, NotificationChannel*>> *it = s_channelList.iterator();
+   while(it->hasNext())
+      size += it->next()->second->getQueueSize();
+   delete it;
+   s_channelListLock.unlock();
+   return size;
+}
+
+/**
+ * Get notification channel statistic for internal parameter
+ */
+DataCollectionError GetNotificationChannelStatistic(const TCHAR *param, int type, TCHAR *value)
+{
+   TCHAR name[MAX_OBJECT_NAME];
+   if (!AgentGetParameterArg(param, 1, name, MAX_OBJECT_NAME))
+      return DCE_NOT_SUPPORTED;
+
+   s_channelListLock.lock();
+   NotificationChannel *nc = s_channelList.get(name);
+   if (nc == nullptr)
+   {
+      s_channelListLock.unlock();
+      return DCE_NO_SUCH_INSTANCE;
+   }
+
+   NotificationChannelStats stats = nc->getStats();
+   switch(type)
+   {
+      case 'F':
+         ret_uint64(value, stats.messagesFailed);
+         break;
+      case 'L':
+         ret_uint(value, stats.averageLatency);
+         break;
+      case 'M':
+         ret_uint(value, stats.maxLatency);
+         break;
+      case 'Q':
+         ret_int64(value, nc->getQueueSize());
+         break;
+      case 'S':
+         ret_uint64(value, stats.messagesSent);
+         break;
+   }
+   s_channelListLock.unlock();
+   return DCE_SUCCESS;
 }
 
 /**
@@ -914,4 +1259,6 @@ void InitNotificationLogs()
       DBFreeResult(hResult);
    }
    DBConnectionPoolReleaseConnection(hdb);
+
+   s_notificationLogWriterThread = ThreadCreateEx(NotificationLogWriter);
 }
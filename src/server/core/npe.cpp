@@ -97,18 +97,25 @@ bool PredictionEngine::getPredictedSeries(UINT32 nodeId, UINT32 dciId, DCObjectS
  */
 StructArray<DciValue> *PredictionEngine::getDciValues(UINT32 nodeId, UINT32 dciId, DCObjectStorageClass storageClass, int maxRows)
 {
+   // With partitioned tables read directly from storage class table instead of union view
+   TCHAR table[64];
+   if (g_flags & AF_PARTITIONED_PERF_DATA)
+      _sntprintf(table, 64, _T("idata_sc_%s"), DCObject::getStorageClassName(storageClass));
+   else
+      _tcscpy(table, _T("idata"));
+
    TCHAR query[1024];
    switch(g_dbSyntax)
    {
       case DB_SYNTAX_MSSQL:
          if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
-            _sntprintf(query, 1024, _T("SELECT TOP %d idata_timestamp,idata_value FROM idata WHERE node_id=%u AND item_id=%u ORDER BY idata_timestamp DESC"), maxRows, nodeId, dciId);
+            _sntprintf(query, 1024, _T("SELECT TOP %d idata_timestamp,idata_value FROM %s WHERE node_id=%u AND item_id=%u ORDER BY idata_timestamp DESC"), maxRows, table, nodeId, dciId);
          else
             _sntprintf(query, 1024, _T("SELECT TOP %d idata_timestamp,idata_value FROM idata_%u WHERE item_id=%u ORDER BY idata_timestamp DESC"), maxRows, nodeId, dciId);
          break;
       case DB_SYNTAX_ORACLE:
          if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
-            _sntprintf(query, 1024, _T("SELECT * FROM (SELECT idata_timestamp,idata_value FROM idata WHERE node_id=%u AND item_id=%u ORDER BY idata_timestamp DESC) WHERE ROWNUM<=%d"), nodeId, dciId, maxRows);
+            _sntprintf(query, 1024, _T("SELECT * FROM (SELECT idata_timestamp,idata_value FROM %s WHERE node_id=%u AND item_id=%u ORDER BY idata_timestamp DESC) WHERE ROWNUM<=%d"), table, nodeId, dciId, maxRows);
          else
             _sntprintf(query, 1024, _T("SELECT * FROM (SELECT idata_timestamp,idata_value FROM idata_%u WHERE item_id=%u ORDER BY idata_timestamp DESC) WHERE ROWNUM<=%d"), nodeId, dciId, maxRows);
          break;
@@ -116,7 +123,7 @@ StructArray<DciValue> *PredictionEngine::getDciValues(UINT32 nodeId, UINT32 dciI
       case DB_SYNTAX_PGSQL:
       case DB_SYNTAX_SQLITE:
          if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
-            _sntprintf(query, 1024, _T("SELECT idata_timestamp,idata_value FROM idata WHERE node_id=%u AND item_id=%u ORDER BY idata_timestamp DESC LIMIT %d"), nodeId, dciId, maxRows);
+            _sntprintf(query, 1024, _T("SELECT idata_timestamp,idata_value FROM %s WHERE node_id=%u AND item_id=%u ORDER BY idata_timestamp DESC LIMIT %d"), table, nodeId, dciId, maxRows);
          else
             _sntprintf(query, 1024, _T("SELECT idata_timestamp,idata_value FROM idata_%u WHERE item_id=%u ORDER BY idata_timestamp DESC LIMIT %d"), nodeId, dciId, maxRows);
          break;
@@ -129,7 +136,7 @@ StructArray<DciValue> *PredictionEngine::getDciValues(UINT32 nodeId, UINT32 dciI
          break;
       case DB_SYNTAX_DB2:
          if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
-            _sntprintf(query, 1024, _T("SELECT idata_timestamp,idata_value FROM idata WHERE node_id=%u AND item_id=%u ORDER BY idata_timestamp DESC FETCH FIRST %d ROWS ONLY"), nodeId, dciId, maxRows);
+            _sntprintf(query, 1024, _T("SELECT idata_timestamp,idata_value FROM %s WHERE node_id=%u AND item_id=%u ORDER BY idata_timestamp DESC FETCH FIRST %d ROWS ONLY"), table, nodeId, dciId, maxRows);
          else
             _sntprintf(query, 1024, _T("SELECT idata_timestamp,idata_value FROM idata_%u WHERE item_id=%u ORDER BY idata_timestamp DESC FETCH FIRST %d ROWS ONLY"), nodeId, dciId, maxRows);
          break;
@@ -301,6 +308,7 @@ bool GetPredictedData(ClientSession *session, const NXCPMessage *request, NXCPMe
    DCI_DATA_HEADER *pData = (DCI_DATA_HEADER *)malloc(count * s_rowSize[dataType] + sizeof(DCI_DATA_HEADER));
    pData->dataType = htonl((UINT32)dataType);
    pData->dciId = htonl(dci->getId());
+   pData->flags = 0;
 
    // Fill memory block with records
    double *series = MemAllocArray<double>(count);
@@ -2099,6 +2099,7 @@ static NXSL_ExtFunction m_nxslServerFunctionsForContainers[] =
 NXSL_ServerEnv::NXSL_ServerEnv() : NXSL_Environment()
 {
 	m_console = nullptr;
+   m_vmMemoryUsage = 0;
 	setLibrary(GetServerScriptLibrary());
 	registerFunctionSet(sizeof(m_nxslServerFunctions) / sizeof(NXSL_ExtFunction), m_nxslServerFunctions);
 	RegisterDCIFunctions(this);
@@ -2109,6 +2110,15 @@ NXSL_ServerEnv::NXSL_ServerEnv() : NXSL_Environment()
    CALL_ALL_MODULES(pfNXSLServerEnvConfig, (this));
 }
 
+/**
+ * Destructor for server default script environment
+ */
+NXSL_ServerEnv::~NXSL_ServerEnv()
+{
+   if (m_vmMemoryUsage != 0)
+      UpdateMemoryUsage(MemoryCategory::SCRIPT_VMS, -static_cast<int64_t>(m_vmMemoryUsage), -1);
+}
+
 /**
  * Script trace output
  */
@@ -2143,6 +2153,13 @@ void NXSL_ServerEnv::configureVM(NXSL_VM *vm)
 {
    NXSL_Environment::configureVM(vm);
 
+   // Environment is owned by VM, so VM is accounted once on first run and released in environment destructor
+   if (m_vmMemoryUsage == 0)
+   {
+      m_vmMemoryUsage = sizeof(NXSL_VM) + vm->getMemoryUsage();
+      UpdateMemoryUsage(MemoryCategory::SCRIPT_VMS, m_vmMemoryUsage, 1);
+   }
+
    vm->setStorage(&g_nxslPstorage);
 
    CALL_ALL_MODULES(pfNXSLServerVMConfig, (vm));
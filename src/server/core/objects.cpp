@@ -44,6 +44,7 @@ ObjectIndex g_idxObjectById;
 HashIndex<uuid> g_idxObjectByGUID;
 ObjectIndex g_idxSubnetById;
 InetAddressIndex g_idxSubnetByAddr;
+InetAddressPrefixIndex g_idxSubnetByPrefix;
 InetAddressIndex g_idxInterfaceByAddr;
 ObjectIndex g_idxZoneByUIN;
 ObjectIndex g_idxNodeById;
@@ -144,6 +145,8 @@ static THREAD_RESULT THREAD_CALL CacheLoadingThread(void *pArg)
    ThreadSetName("CacheLoader");
    DbgPrintf(1, _T("Started caching of DCI values"));
 
+   OpenDCICacheSnapshot();
+
 	UpdateDataCollectionCache(&g_idxNodeById);
 	UpdateDataCollectionCache(&g_idxClusterById);
 	UpdateDataCollectionCache(&g_idxMobileDeviceById);
@@ -151,6 +154,8 @@ static THREAD_RESULT THREAD_CALL CacheLoadingThread(void *pArg)
    UpdateDataCollectionCache(&g_idxChassisById);
    UpdateDataCollectionCache(&g_idxSensorById);
 
+   CloseDCICacheSnapshot();
+
    DbgPrintf(1, _T("Finished caching of DCI values"));
    return THREAD_OK;
 }
@@ -286,6 +291,11 @@ void NetObjInsert(const shared_ptr<NetObj>& object, bool newObject, bool importe
 
 	g_idxObjectById.put(object->getId(), object);
 	g_idxObjectByGUID.put(object->getGuid(), object);
+   UpdateObjectMemoryUsage(*object, true);
+
+	// Object could be modified before it was assigned an ID or inserted into index
+	if (object->isModified())
+	   RegisterModifiedObject(object->getId());
 
    if (!object->isDeleted())
    {
@@ -369,6 +379,7 @@ void NetObjInsert(const shared_ptr<NetObj>& object, bool newObject, bool importe
 					else
 					{
 						g_idxSubnetByAddr.put(static_cast<Subnet&>(*object).getIpAddress(), object);
+						g_idxSubnetByPrefix.put(static_cast<Subnet&>(*object).getIpAddress(), object);
 					}
                if (newObject)
                {
@@ -531,6 +542,7 @@ void NetObjDeleteFromIndexes(const NetObj& object)
 				else
 				{
 					g_idxSubnetByAddr.remove(static_cast<const Subnet&>(object).getIpAddress());
+					g_idxSubnetByPrefix.remove(static_cast<const Subnet&>(object).getIpAddress(), object.getId());
 				}
          }
          break;
@@ -976,59 +988,19 @@ shared_ptr<Subnet> NXCORE_EXPORTABLE FindSubnetByIP(int32_t zoneUIN, const InetA
 }
 
 /**
- * Subnet matching data
- */
-struct SubnetMatchingData
-{
-   InetAddress ipAddr; // IP address to find subnet for
-   int maskLen;        // Current match mask length
-   shared_ptr<Subnet> subnet;     // search result
-
-   SubnetMatchingData(const InetAddress& _ipAddr) : ipAddr(_ipAddr)
-   {
-      maskLen = -1;
-   }
-};
-
-/**
- * Subnet matching callback
- */
-static void SubnetMatchCallback(const InetAddress& addr, NetObj *object, void *context)
-{
-   SubnetMatchingData *data = static_cast<SubnetMatchingData*>(context);
-   if (static_cast<Subnet*>(object)->getIpAddress().contain(data->ipAddr))
-   {
-      int maskLen = static_cast<Subnet*>(object)->getIpAddress().getMaskBits();
-      if (maskLen > data->maskLen)
-      {
-         data->maskLen = maskLen;
-         data->subnet = static_cast<Subnet*>(object)->self();
-      }
-   }
-}
-
-/**
- * Find subnet for given IP address
+ * Find subnet for given IP address (subnet with longest prefix containing given address)
  */
 shared_ptr<Subnet> NXCORE_EXPORTABLE FindSubnetForNode(int32_t zoneUIN, const InetAddress& nodeAddr)
 {
    if (!nodeAddr.isValidUnicast())
       return shared_ptr<Subnet>();
 
-   SubnetMatchingData matchData(nodeAddr);
    if (IsZoningEnabled())
    {
       shared_ptr<Zone> zone = FindZoneByUIN(zoneUIN);
-      if (zone != nullptr)
-      {
-         zone->forEachSubnet(SubnetMatchCallback, &matchData);
-      }
-   }
-   else
-   {
-      g_idxSubnetByAddr.forEach(SubnetMatchCallback, &matchData);
+      return (zone != nullptr) ? zone->findSubnetForAddress(nodeAddr) : shared_ptr<Subnet>();
    }
-   return matchData.subnet;
+   return static_pointer_cast<Subnet>(g_idxSubnetByPrefix.findLongestMatch(nodeAddr));
 }
 
 /**
@@ -1374,6 +1346,502 @@ static void PruneCustomAttributes(NetObj *object, void *data)
    object->pruneCustomAttributes();
 }
 
+/**
+ * Debug tag for object loading
+ */
+#define DEBUG_TAG_OBJECT_INIT _T("obj.init")
+
+/**
+ * Minimal number of objects per loader thread
+ */
+#define MIN_OBJECTS_PER_LOADER_THREAD  64
+
+/**
+ * Bulk data sets loaded during object loading at startup
+ */
+static Mutex s_startupDataSetLock;
+static bool s_startupDataSetsEnabled = false;
+static BulkDataSet *s_startupDataSets[STARTUP_DATASET_COUNT];
+
+/**
+ * Get startup bulk data set. Data set is loaded on first access using provided query.
+ * Will return nullptr if startup data sets are not enabled or data set cannot be loaded.
+ */
+static BulkDataSet *GetStartupDataSet(StartupDataSet id, DB_HANDLE hdb, const TCHAR *query)
+{
+   BulkDataSet *dataSet = nullptr;
+   s_startupDataSetLock.lock();
+   if (s_startupDataSetsEnabled)
+   {
+      dataSet = s_startupDataSets[static_cast<int>(id)];
+      if (dataSet == nullptr)
+      {
+         int64_t startTime = GetCurrentTimeMs();
+         dataSet = new BulkDataSet(hdb, query);
+         s_startupDataSets[static_cast<int>(id)] = dataSet;
+         if (dataSet->isValid())
+            nxlog_debug_tag(DEBUG_TAG_OBJECT_INIT, 5, _T("Bulk data set %d loaded in %u ms (%d rows)"),
+                     static_cast<int>(id), static_cast<uint32_t>(GetCurrentTimeMs() - startTime), DBGetNumRows(dataSet->getResult()));
+         else
+            nxlog_debug_tag(DEBUG_TAG_OBJECT_INIT, 3, _T("Cannot load bulk data set %d, fallback to per-object queries"), static_cast<int>(id));
+      }
+      if (!dataSet->isValid())
+         dataSet = nullptr;
+   }
+   s_startupDataSetLock.unlock();
+   return dataSet;
+}
+
+/**
+ * Enable or disable startup bulk data sets. Disabling data sets also destroys all loaded data sets.
+ */
+static void EnableStartupDataSets(bool enable)
+{
+   s_startupDataSetLock.lock();
+   s_startupDataSetsEnabled = enable;
+   if (!enable)
+   {
+      for(int i = 0; i < STARTUP_DATASET_COUNT; i++)
+      {
+         delete s_startupDataSets[i];
+         s_startupDataSets[i] = nullptr;
+      }
+   }
+   s_startupDataSetLock.unlock();
+}
+
+/**
+ * Compare bulk data set index entries
+ */
+static int CompareBulkDataSetIndexEntries(const void *e1, const void *e2)
+{
+   uint32_t id1 = *static_cast<const uint32_t*>(e1);
+   uint32_t id2 = *static_cast<const uint32_t*>(e2);
+   return (id1 < id2) ? -1 : ((id1 > id2) ? 1 : 0);
+}
+
+/**
+ * Create bulk data set
+ */
+BulkDataSet::BulkDataSet(DB_HANDLE hdb, const TCHAR *query)
+{
+   m_index = nullptr;
+   m_indexSize = 0;
+   m_hResult = DBSelect(hdb, query);
+   if (m_hResult == nullptr)
+      return;
+
+   int rowCount = DBGetNumRows(m_hResult);
+   if (rowCount == 0)
+      return;
+
+   int idColumn = DBGetColumnCount(m_hResult) - 1;
+   m_index = MemAllocArrayNoInit<IndexEntry>(rowCount);
+   for(int i = 0; i < rowCount; i++)
+   {
+      uint32_t id = DBGetFieldULong(m_hResult, i, idColumn);
+      if ((m_indexSize > 0) && (m_index[m_indexSize - 1].id == id))
+      {
+         m_index[m_indexSize - 1].rowCount++;
+      }
+      else
+      {
+         m_index[m_indexSize].id = id;
+         m_index[m_indexSize].firstRow = i;
+         m_index[m_indexSize].rowCount = 1;
+         m_indexSize++;
+      }
+   }
+
+   // Result order may not match numeric order if ID column has character type (as in cache database)
+   qsort(m_index, m_indexSize, sizeof(IndexEntry), CompareBulkDataSetIndexEntries);
+}
+
+/**
+ * Destroy bulk data set
+ */
+BulkDataSet::~BulkDataSet()
+{
+   if (m_hResult != nullptr)
+      DBFreeResult(m_hResult);
+   MemFree(m_index);
+}
+
+/**
+ * Find rows for given object ID. Returns false if there are no rows for given object.
+ */
+bool BulkDataSet::find(uint32_t id, int *firstRow, int *rowCount) const
+{
+   IndexEntry *e = static_cast<IndexEntry*>(bsearch(&id, m_index, m_indexSize, sizeof(IndexEntry), CompareBulkDataSetIndexEntries));
+   if (e == nullptr)
+      return false;
+   *firstRow = e->firstRow;
+   *rowCount = e->rowCount;
+   return true;
+}
+
+/**
+ * Get rows for given object either from startup bulk data set or by executing per-object query.
+ * Per-object query should have single parameter for object ID.
+ */
+ObjectDataRows::ObjectDataRows(DB_HANDLE hdb, StartupDataSet dataSetId, const TCHAR *bulkQuery, const TCHAR *query, uint32_t objectId)
+{
+   m_firstRow = 0;
+   m_rowCount = 0;
+
+   BulkDataSet *dataSet = GetStartupDataSet(dataSetId, hdb, bulkQuery);
+   if (dataSet != nullptr)
+   {
+      m_hResult = dataSet->getResult();
+      m_ownResult = false;
+      dataSet->find(objectId, &m_firstRow, &m_rowCount);
+      return;
+   }
+
+   m_hResult = nullptr;
+   m_ownResult = true;
+   DB_STATEMENT hStmt = DBPrepare(hdb, query);
+   if (hStmt != nullptr)
+   {
+      DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, objectId);
+      m_hResult = DBSelectPrepared(hStmt);
+      if (m_hResult != nullptr)
+         m_rowCount = DBGetNumRows(m_hResult);
+      DBFreeStatement(hStmt);
+   }
+}
+
+/**
+ * Destructor
+ */
+ObjectDataRows::~ObjectDataRows()
+{
+   if (m_ownResult && (m_hResult != nullptr))
+      DBFreeResult(m_hResult);
+}
+
+/**
+ * Tables cached in memory database during startup
+ */
+static struct
+{
+   const TCHAR *name;
+   const TCHAR *indexColumn;
+   bool useIntColumns;
+} s_cachedTables[] =
+{
+   { _T("object_properties"), _T("object_id"), false },
+   { _T("object_custom_attributes"), _T("object_id,attr_name"), false },
+   { _T("object_urls"), _T("object_id,url_id"), false },
+   { _T("responsible_users"), _T("object_id,user_id"), false },
+   { _T("nodes"), _T("id"), false },
+   { _T("zones"), _T("id"), false },
+   { _T("zone_proxies"), _T("object_id,proxy_node"), false },
+   { _T("conditions"), _T("id"), false },
+   { _T("cond_dci_map"), _T("condition_id,sequence_number"), true },
+   { _T("subnets"), _T("id"), false },
+   { _T("nsmap"), _T("subnet_id,node_id"), false },
+   { _T("racks"), _T("id"), false },
+   { _T("rack_passive_elements"), _T("id"), false },
+   { _T("physical_links"), _T("id"), false },
+   { _T("chassis"), _T("id"), false },
+   { _T("mobile_devices"), _T("id"), false },
+   { _T("sensors"), _T("id"), false },
+   { _T("access_points"), _T("id"), false },
+   { _T("interfaces"), _T("id"), true },
+   { _T("interface_address_list"), _T("iface_id,ip_addr"), true },
+   { _T("interface_vlan_list"), _T("iface_id,vlan_id"), true },
+   { _T("network_services"), _T("id"), false },
+   { _T("vpn_connectors"), _T("id"), false },
+   { _T("vpn_connector_networks"), _T("vpn_id,ip_addr"), false },
+   { _T("clusters"), _T("id"), false },
+   { _T("cluster_members"), _T("cluster_id,node_id"), false },
+   { _T("cluster_sync_subnets"), _T("cluster_id,subnet_addr"), false },
+   { _T("cluster_resources"), _T("cluster_id,resource_id"), false },
+   { _T("templates"), _T("id"), false },
+   { _T("items"), _T("item_id"), false },
+   { _T("thresholds"), _T("threshold_id"), true },
+   { _T("raw_dci_values"), _T("item_id"), false },
+   { _T("dc_tables"), _T("item_id"), false },
+   { _T("dc_table_columns"), _T("table_id,column_name"), true },
+   { _T("dc_targets"), _T("id"), true },
+   { _T("dct_column_names"), _T("column_id"), false },
+   { _T("dct_thresholds"), _T("id"), true },
+   { _T("dct_threshold_conditions"), _T("threshold_id,group_id,sequence_number"), false },
+   { _T("dct_threshold_instances"), _T("threshold_id,instance_id"), false },
+   { _T("dct_node_map"), _T("template_id,node_id"), true },
+   { _T("dci_delete_list"), _T("node_id,dci_id"), false },
+   { _T("dci_schedules"), _T("item_id,schedule_id"), false },
+   { _T("dci_access"), _T("dci_id,user_id"), false },
+   { _T("ap_common"), _T("guid"), false },
+   { _T("network_maps"), _T("id"), false },
+   { _T("network_map_elements"), _T("map_id,element_id"), false },
+   { _T("network_map_links"), nullptr, false },
+   { _T("network_map_seed_nodes"), _T("map_id,seed_node_id"), false },
+   { _T("node_components"), _T("node_id,component_index"), false },
+   { _T("object_containers"), _T("id"), false },
+   { _T("container_members"), _T("container_id,object_id"), false },
+   { _T("dashboards"), _T("id"), false },
+   { _T("dashboard_elements"), _T("dashboard_id,element_id"), true },
+   { _T("dashboard_associations"), _T("object_id,dashboard_id"), false },
+   { _T("slm_checks"), _T("id"), false },
+   { _T("business_services"), _T("service_id"), false },
+   { _T("node_links"), _T("nodelink_id"), false },
+   { _T("acl"), _T("object_id,user_id"), false },
+   { _T("trusted_nodes"), _T("source_object_id,target_node_id"), false },
+   { _T("auto_bind_target"), _T("object_id"), false },
+   { _T("icmp_statistics"), _T("object_id,poll_target"), true },
+   { _T("icmp_target_address_list"), _T("node_id,ip_addr"), true },
+   { _T("software_inventory"), _T("node_id,name,version"), false },
+   { _T("hardware_inventory"), _T("node_id,category,component_index"), false },
+   { _T("versionable_object"), _T("object_id"), false }
+};
+
+/**
+ * Table caching context
+ */
+struct TableCachingContext
+{
+   DB_HANDLE cacheDB;
+   Mutex cacheLock;
+   VolatileCounter nextTable;
+   volatile bool success;
+};
+
+/**
+ * Table caching thread. Reads tables from main database in parallel; inserts into cache database are serialized.
+ */
+static void TableCachingThread(TableCachingContext *context)
+{
+   ThreadSetName("TableCache");
+
+   static const TCHAR *intColumns[] = { _T("condition_id"), _T("sequence_number"), _T("dci_id"), _T("node_id"), _T("dci_func"), _T("num_pols"),
+                                        _T("dashboard_id"), _T("element_id"), _T("element_type"), _T("threshold_id"), _T("item_id"),
+                                        _T("check_function"), _T("check_operation"), _T("sample_count"), _T("event_code"), _T("rearm_event_code"),
+                                        _T("repeat_interval"), _T("current_state"), _T("current_severity"), _T("match_count"),
+                                        _T("last_event_timestamp"), _T("table_id"), _T("flags"), _T("id"), _T("activation_event"),
+                                        _T("deactivation_event"), _T("group_id"), _T("iface_id"), _T("vlan_id"), _T("object_id"), nullptr };
+
+   DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+   while(context->success)
+   {
+      size_t index = static_cast<size_t>(InterlockedIncrement(&context->nextTable) - 1);
+      if (index >= sizeof(s_cachedTables) / sizeof(s_cachedTables[0]))
+         break;
+
+      int64_t startTime = GetCurrentTimeMs();
+      if (!DBCacheTable(context->cacheDB, &context->cacheLock, hdb, s_cachedTables[index].name, s_cachedTables[index].indexColumn,
+               _T("*"), s_cachedTables[index].useIntColumns ? intColumns : nullptr))
+      {
+         context->success = false;
+         break;
+      }
+      nxlog_debug_tag(DEBUG_TAG_OBJECT_INIT, 6, _T("Table %s cached in %u ms"), s_cachedTables[index].name,
+               static_cast<uint32_t>(GetCurrentTimeMs() - startTime));
+   }
+   DBConnectionPoolReleaseConnection(hdb);
+}
+
+/**
+ * Cache object configuration tables in memory database using given number of threads
+ */
+static bool CacheObjectTables(DB_HANDLE cacheDB, int numThreads)
+{
+   TableCachingContext context;
+   context.cacheDB = cacheDB;
+   context.nextTable = 0;
+   context.success = true;
+
+   THREAD *threads = MemAllocArrayNoInit<THREAD>(numThreads);
+   for(int i = 0; i < numThreads; i++)
+      threads[i] = ThreadCreateEx(TableCachingThread, &context);
+   for(int i = 0; i < numThreads; i++)
+      ThreadJoin(threads[i]);
+   MemFree(threads);
+
+   return context.success;
+}
+
+/**
+ * Object loader context
+ */
+template<typename T> struct ObjectLoaderContext
+{
+   DB_HANDLE hdb;    // Shared database handle or nullptr if each thread should acquire own connection
+   uint32_t *ids;
+   shared_ptr<T> *objects;
+   bool *loaded;
+   int count;
+   VolatileCounter next;
+};
+
+/**
+ * Object loader thread
+ */
+template<typename T> static void ObjectLoaderThread(ObjectLoaderContext<T> *context)
+{
+   DB_HANDLE hdb = (context->hdb != nullptr) ? context->hdb : DBConnectionPoolAcquireConnection();
+   while(true)
+   {
+      int index = static_cast<int>(InterlockedIncrement(&context->next)) - 1;
+      if (index >= context->count)
+         break;
+      context->objects[index] = make_shared<T>();
+      context->loaded[index] = context->objects[index]->loadFromDatabase(hdb, context->ids[index]);
+   }
+   if (context->hdb == nullptr)
+      DBConnectionPoolReleaseConnection(hdb);
+}
+
+/**
+ * Object loader configuration
+ */
+struct ObjectLoaderConfig
+{
+   DB_HANDLE hdb;
+   bool sharedHandle;   // true if all loader threads should use same database handle (in-memory cache database)
+   int numThreads;
+};
+
+/**
+ * Sort indexes in startup mode so they can be safely used by loader threads
+ */
+static void PrepareIndexesForLoaderThreads()
+{
+   g_idxObjectById.sortStartupData();
+   g_idxSubnetById.sortStartupData();
+   g_idxZoneByUIN.sortStartupData();
+   g_idxNodeById.sortStartupData();
+   g_idxClusterById.sortStartupData();
+   g_idxMobileDeviceById.sortStartupData();
+   g_idxAccessPointById.sortStartupData();
+   g_idxConditionById.sortStartupData();
+   g_idxServiceCheckById.sortStartupData();
+   g_idxNetMapById.sortStartupData();
+   g_idxChassisById.sortStartupData();
+   g_idxSensorById.sortStartupData();
+}
+
+/**
+ * Load all objects of given class. Objects are loaded from database by pool of threads and then inserted
+ * into indexes by calling thread in the same order as returned by ID query.
+ */
+template<typename T> static void LoadObjectClass(const ObjectLoaderConfig& config, const TCHAR *query, const TCHAR *pluralName,
+         const TCHAR *singularName, void (*callback)(const shared_ptr<T>&) = nullptr)
+{
+   nxlog_debug_tag(DEBUG_TAG_OBJECT_INIT, 2, _T("Loading %s..."), pluralName);
+   int64_t startTime = GetCurrentTimeMs();
+
+   DB_RESULT hResult = DBSelect(config.hdb, query);
+   if (hResult == nullptr)
+      return;
+
+   ObjectLoaderContext<T> context;
+   context.count = DBGetNumRows(hResult);
+   context.ids = MemAllocArrayNoInit<uint32_t>(context.count);
+   for(int i = 0; i < context.count; i++)
+      context.ids[i] = DBGetFieldULong(hResult, i, 0);
+   DBFreeResult(hResult);
+
+   context.objects = new shared_ptr<T>[context.count];
+   context.loaded = MemAllocArray<bool>(context.count);
+   context.next = 0;
+
+   int numThreads = std::min(config.numThreads, context.count / MIN_OBJECTS_PER_LOADER_THREAD);
+   if (numThreads > 1)
+   {
+      PrepareIndexesForLoaderThreads();
+      context.hdb = config.sharedHandle ? config.hdb : nullptr;
+      THREAD *threads = MemAllocArrayNoInit<THREAD>(numThreads);
+      for(int i = 0; i < numThreads; i++)
+         threads[i] = ThreadCreateEx(ObjectLoaderThread<T>, &context);
+      for(int i = 0; i < numThreads; i++)
+         ThreadJoin(threads[i]);
+      MemFree(threads);
+   }
+   else
+   {
+      context.hdb = config.hdb;
+      ObjectLoaderThread(&context);
+   }
+
+   // Indexes in startup mode are not thread safe for writing, so insert objects only from this thread
+   for(int i = 0; i < context.count; i++)
+   {
+      shared_ptr<T>& object = context.objects[i];
+      if (context.loaded[i])
+      {
+         NetObjInsert(object, false, false);  // Insert into indexes
+         if (callback != nullptr)
+            callback(object);
+      }
+      else     // Object load failed
+      {
+         object->destroy();
+         nxlog_write(NXLOG_ERROR, _T("Failed to load %s object with ID %u from database"), singularName, context.ids[i]);
+      }
+   }
+
+   nxlog_debug_tag(DEBUG_TAG_OBJECT_INIT, 2, _T("%d %s loaded in %u ms"), context.count, pluralName,
+            static_cast<uint32_t>(GetCurrentTimeMs() - startTime));
+
+   delete[] context.objects;
+   MemFree(context.loaded);
+   MemFree(context.ids);
+}
+
+/**
+ * Add loaded zone to entire network
+ */
+static void OnZoneLoad(const shared_ptr<Zone>& zone)
+{
+   if (!zone->isDeleted())
+      g_entireNetwork->addZone(zone);
+}
+
+/**
+ * Add loaded subnet to zone or entire network
+ */
+static void OnSubnetLoad(const shared_ptr<Subnet>& subnet)
+{
+   if (subnet->isDeleted())
+      return;
+
+   if (g_flags & AF_ENABLE_ZONING)
+   {
+      shared_ptr<Zone> zone = FindZoneByUIN(subnet->getZoneUIN());
+      if (zone != nullptr)
+         zone->addSubnet(subnet);
+   }
+   else
+   {
+      g_entireNetwork->addSubnet(subnet);
+   }
+}
+
+/**
+ * Update proxy status in zone for loaded node
+ */
+static void OnNodeLoad(const shared_ptr<Node>& node)
+{
+   if (IsZoningEnabled())
+   {
+      shared_ptr<Zone> zone = FindZoneByProxyId(node->getId());
+      if (zone != nullptr)
+      {
+         zone->updateProxyStatus(node, false);
+      }
+   }
+}
+
+/**
+ * Recalculate status for loaded template
+ */
+static void OnTemplateLoad(const shared_ptr<Template>& tmpl)
+{
+   tmpl->calculateCompoundStatus();	// Force status change to NORMAL
+}
+
 /**
  * Load objects from database at stratup
  */
@@ -1382,87 +1850,21 @@ BOOL LoadObjects()
    // Prevent objects to change it's modification flag
    g_bModificationsLocked = TRUE;
 
+   int64_t loadStartTime = GetCurrentTimeMs();
+   int numThreads = ConfigReadInt(_T("Objects.LoaderThreads"), 4);
+   if (numThreads < 1)
+      numThreads = 1;
+   else if (numThreads > 32)
+      numThreads = 32;
+
    DB_HANDLE mainDB = DBConnectionPoolAcquireConnection();
    DB_HANDLE hdb = mainDB;
    DB_HANDLE cachedb = (g_flags & AF_CACHE_DB_ON_STARTUP) ? DBOpenInMemoryDatabase() : nullptr;
    if (cachedb != nullptr)
    {
-      static const TCHAR *intColumns[] = { _T("condition_id"), _T("sequence_number"), _T("dci_id"), _T("node_id"), _T("dci_func"), _T("num_pols"),
-                                           _T("dashboard_id"), _T("element_id"), _T("element_type"), _T("threshold_id"), _T("item_id"),
-                                           _T("check_function"), _T("check_operation"), _T("sample_count"), _T("event_code"), _T("rearm_event_code"),
-                                           _T("repeat_interval"), _T("current_state"), _T("current_severity"), _T("match_count"),
-                                           _T("last_event_timestamp"), _T("table_id"), _T("flags"), _T("id"), _T("activation_event"),
-                                           _T("deactivation_event"), _T("group_id"), _T("iface_id"), _T("vlan_id"), _T("object_id"), nullptr };
-
       nxlog_debug(1, _T("Caching object configuration tables"));
-      bool success =
-               DBCacheTable(cachedb, mainDB, _T("object_properties"), _T("object_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("object_custom_attributes"), _T("object_id,attr_name"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("object_urls"), _T("object_id,url_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("responsible_users"), _T("object_id,user_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("nodes"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("zones"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("zone_proxies"), _T("object_id,proxy_node"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("conditions"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("cond_dci_map"), _T("condition_id,sequence_number"), _T("*"), intColumns) &&
-               DBCacheTable(cachedb, mainDB, _T("subnets"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("nsmap"), _T("subnet_id,node_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("racks"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("rack_passive_elements"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("physical_links"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("chassis"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("mobile_devices"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("sensors"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("access_points"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("interfaces"), _T("id"), _T("*"), intColumns) &&
-               DBCacheTable(cachedb, mainDB, _T("interface_address_list"), _T("iface_id,ip_addr"), _T("*"), intColumns) &&
-               DBCacheTable(cachedb, mainDB, _T("interface_vlan_list"), _T("iface_id,vlan_id"), _T("*"), intColumns) &&
-               DBCacheTable(cachedb, mainDB, _T("network_services"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("vpn_connectors"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("vpn_connector_networks"), _T("vpn_id,ip_addr"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("clusters"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("cluster_members"), _T("cluster_id,node_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("cluster_sync_subnets"), _T("cluster_id,subnet_addr"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("cluster_resources"), _T("cluster_id,resource_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("templates"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("items"), _T("item_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("thresholds"), _T("threshold_id"), _T("*"), intColumns) &&
-               DBCacheTable(cachedb, mainDB, _T("raw_dci_values"), _T("item_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("dc_tables"), _T("item_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("dc_table_columns"), _T("table_id,column_name"), _T("*"), intColumns) &&
-               DBCacheTable(cachedb, mainDB, _T("dc_targets"), _T("id"), _T("*"), intColumns) &&
-               DBCacheTable(cachedb, mainDB, _T("dct_column_names"), _T("column_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("dct_thresholds"), _T("id"), _T("*"), intColumns) &&
-               DBCacheTable(cachedb, mainDB, _T("dct_threshold_conditions"), _T("threshold_id,group_id,sequence_number"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("dct_threshold_instances"), _T("threshold_id,instance_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("dct_node_map"), _T("template_id,node_id"), _T("*"), intColumns) &&
-               DBCacheTable(cachedb, mainDB, _T("dci_delete_list"), _T("node_id,dci_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("dci_schedules"), _T("item_id,schedule_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("dci_access"), _T("dci_id,user_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("ap_common"), _T("guid"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("network_maps"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("network_map_elements"), _T("map_id,element_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("network_map_links"), nullptr, _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("network_map_seed_nodes"), _T("map_id,seed_node_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("node_components"), _T("node_id,component_index"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("object_containers"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("container_members"), _T("container_id,object_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("dashboards"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("dashboard_elements"), _T("dashboard_id,element_id"), _T("*"), intColumns) &&
-               DBCacheTable(cachedb, mainDB, _T("dashboard_associations"), _T("object_id,dashboard_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("slm_checks"), _T("id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("business_services"), _T("service_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("node_links"), _T("nodelink_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("acl"), _T("object_id,user_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("trusted_nodes"), _T("source_object_id,target_node_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("auto_bind_target"), _T("object_id"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("icmp_statistics"), _T("object_id,poll_target"), _T("*"), intColumns) &&
-               DBCacheTable(cachedb, mainDB, _T("icmp_target_address_list"), _T("node_id,ip_addr"), _T("*"), intColumns) &&
-               DBCacheTable(cachedb, mainDB, _T("software_inventory"), _T("node_id,name,version"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("hardware_inventory"), _T("node_id,category,component_index"), _T("*")) &&
-               DBCacheTable(cachedb, mainDB, _T("versionable_object"), _T("object_id"), _T("*"));
-
-      if (success)
+      int64_t startTime = GetCurrentTimeMs();
+      if (CacheObjectTables(cachedb, numThreads))
       {
          hdb = cachedb;
 
@@ -1472,8 +1874,18 @@ BOOL LoadObjects()
          DBQuery(cachedb, _T("CREATE INDEX idx_dc_tables_node_id ON dc_tables(node_id)"));
          DBQuery(cachedb, _T("CREATE INDEX idx_dct_thresholds_table_id ON dct_thresholds(table_id)"));
       }
+      nxlog_debug_tag(DEBUG_TAG_OBJECT_INIT, 1, _T("Object configuration tables cached in %u ms"), static_cast<uint32_t>(GetCurrentTimeMs() - startTime));
    }
 
+   // Loader threads share in-memory cache database handle (access to it is serialized anyway)
+   // or use separate connections from the pool
+   ObjectLoaderConfig loaderConfig;
+   loaderConfig.hdb = hdb;
+   loaderConfig.sharedHandle = (hdb == cachedb);
+   loaderConfig.numThreads = numThreads;
+
+   EnableStartupDataSets(true);
+
    // Load built-in object properties
    DbgPrintf(2, _T("Loading built-in object properties..."));
    g_entireNetwork->loadFromDatabase(hdb);
@@ -1500,8 +1912,6 @@ BOOL LoadObjects()
    // Load zones
    if (g_flags & AF_ENABLE_ZONING)
    {
-      DbgPrintf(2, _T("Loading zones..."));
-
       // Load (or create) default zone
       auto zone = make_shared<Zone>();
       zone->generateGuid();
@@ -1509,580 +1919,74 @@ BOOL LoadObjects()
       NetObjInsert(zone, false, false);
       g_entireNetwork->addZone(zone);
 
-      DB_RESULT hResult = DBSelect(hdb, _T("SELECT id FROM zones WHERE id<>4"));
-      if (hResult != nullptr)
-      {
-         int count = DBGetNumRows(hResult);
-         for(int i = 0; i < count; i++)
-         {
-            UINT32 id = DBGetFieldULong(hResult, i, 0);
-            zone = make_shared<Zone>();
-            if (zone->loadFromDatabase(hdb, id))
-            {
-               if (!zone->isDeleted())
-                  g_entireNetwork->addZone(zone);
-               NetObjInsert(zone, false, false);  // Insert into indexes
-            }
-            else     // Object load failed
-            {
-               zone->destroy();
-               nxlog_write(NXLOG_ERROR, _T("Failed to load zone object with ID %u from database"), id);
-            }
-         }
-         DBFreeResult(hResult);
-      }
+      LoadObjectClass<Zone>(loaderConfig, _T("SELECT id FROM zones WHERE id<>4"), _T("zones"), _T("zone"), OnZoneLoad);
    }
    g_idxZoneByUIN.setStartupMode(false);
 
    // Load conditions
    // We should load conditions before nodes because
    // DCI cache size calculation uses information from condition objects
-   DbgPrintf(2, _T("Loading conditions..."));
-   DB_RESULT hResult = DBSelect(hdb, _T("SELECT id FROM conditions"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto condition = make_shared<ConditionObject>();
-         if (condition->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(condition, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            condition->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load condition object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<ConditionObject>(loaderConfig, _T("SELECT id FROM conditions"), _T("conditions"), _T("condition"));
    g_idxConditionById.setStartupMode(false);
 
-   // Load subnets
-   DbgPrintf(2, _T("Loading subnets..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM subnets"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto subnet = make_shared<Subnet>();
-         if (subnet->loadFromDatabase(hdb, id))
-         {
-            if (!subnet->isDeleted())
-            {
-               if (g_flags & AF_ENABLE_ZONING)
-               {
-                  shared_ptr<Zone> zone = FindZoneByUIN(subnet->getZoneUIN());
-                  if (zone != nullptr)
-                     zone->addSubnet(subnet);
-               }
-               else
-               {
-                  g_entireNetwork->addSubnet(subnet);
-               }
-            }
-            NetObjInsert(subnet, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            subnet->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load subnet object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<Subnet>(loaderConfig, _T("SELECT id FROM subnets"), _T("subnets"), _T("subnet"), OnSubnetLoad);
    g_idxSubnetById.setStartupMode(false);
 
-   // Load racks
-   DbgPrintf(2, _T("Loading racks..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM racks"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto rack = make_shared<Rack>();
-         if (rack->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(rack, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            nxlog_write(NXLOG_ERROR, _T("Failed to load rack object with ID %u from database"), id);
-            rack->destroy();
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<Rack>(loaderConfig, _T("SELECT id FROM racks"), _T("racks"), _T("rack"));
 
-   // Load chassis
-   DbgPrintf(2, _T("Loading chassis..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM chassis"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto chassis = make_shared<Chassis>();
-         if (chassis->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(chassis, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            nxlog_write(NXLOG_ERROR, _T("Failed to load chassis object with ID %u from database"), id);
-            chassis->destroy();
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<Chassis>(loaderConfig, _T("SELECT id FROM chassis"), _T("chassis"), _T("chassis"));
    g_idxChassisById.setStartupMode(false);
 
-   // Load mobile devices
-   DbgPrintf(2, _T("Loading mobile devices..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM mobile_devices"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto md = make_shared<MobileDevice>();
-         if (md->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(md, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            md->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load mobile device object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<MobileDevice>(loaderConfig, _T("SELECT id FROM mobile_devices"), _T("mobile devices"), _T("mobile device"));
    g_idxMobileDeviceById.setStartupMode(false);
 
-   // Load sensors
-   DbgPrintf(2, _T("Loading sensors..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM sensors"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto sensor = make_shared<Sensor>();
-         if (sensor->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(sensor, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            sensor->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load sensor object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<Sensor>(loaderConfig, _T("SELECT id FROM sensors"), _T("sensors"), _T("sensor"));
    g_idxSensorById.setStartupMode(false);
 
-   // Load nodes
-   DbgPrintf(2, _T("Loading nodes..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM nodes"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto node = make_shared<Node>();
-         if (node->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(node, false, false);  // Insert into indexes
-            if (IsZoningEnabled())
-            {
-               shared_ptr<Zone> zone = FindZoneByProxyId(id);
-               if (zone != nullptr)
-               {
-                  zone->updateProxyStatus(node, false);
-               }
-            }
-         }
-         else     // Object load failed
-         {
-            node->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load node object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<Node>(loaderConfig, _T("SELECT id FROM nodes"), _T("nodes"), _T("node"), OnNodeLoad);
    g_idxNodeById.setStartupMode(false);
 
-   // Load access points
-   DbgPrintf(2, _T("Loading access points..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM access_points"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto ap = make_shared<AccessPoint>();
-         if (ap->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(ap, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            nxlog_write(NXLOG_ERROR, _T("Failed to load access point object with ID %u from database"), id);
-            ap->destroy();
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<AccessPoint>(loaderConfig, _T("SELECT id FROM access_points"), _T("access points"), _T("access point"));
    g_idxAccessPointById.setStartupMode(false);
 
-   // Load interfaces
-   DbgPrintf(2, _T("Loading interfaces..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM interfaces"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto iface = make_shared<Interface>();
-         if (iface->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(iface, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            nxlog_write(NXLOG_ERROR, _T("Failed to load interface object with ID %u from database"), id);
-            iface->destroy();
-         }
-      }
-      DBFreeResult(hResult);
-   }
-
-   // Load network services
-   DbgPrintf(2, _T("Loading network services..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM network_services"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto service = make_shared<NetworkService>();
-         if (service->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(service, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            service->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load network service object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<Interface>(loaderConfig, _T("SELECT id FROM interfaces"), _T("interfaces"), _T("interface"));
+   LoadObjectClass<NetworkService>(loaderConfig, _T("SELECT id FROM network_services"), _T("network services"), _T("network service"));
+   LoadObjectClass<VPNConnector>(loaderConfig, _T("SELECT id FROM vpn_connectors"), _T("VPN connectors"), _T("VPN connector"));
 
-   // Load VPN connectors
-   DbgPrintf(2, _T("Loading VPN connectors..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM vpn_connectors"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto connector = make_shared<VPNConnector>();
-         if (connector->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(connector, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            connector->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load VPN connector object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
-
-   // Load clusters
-   DbgPrintf(2, _T("Loading clusters..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM clusters"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto cluster = make_shared<Cluster>();
-         if (cluster->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(cluster, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            cluster->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load cluster object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<Cluster>(loaderConfig, _T("SELECT id FROM clusters"), _T("clusters"), _T("cluster"));
    g_idxClusterById.setStartupMode(false);
 
    // Start cache loading thread.
    // All data collection targets must be loaded at this point.
    ThreadCreate(CacheLoadingThread, 0, nullptr);
 
-   // Load templates
-   DbgPrintf(2, _T("Loading templates..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM templates"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto tmpl = make_shared<Template>();
-         if (tmpl->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(tmpl, false, false);  // Insert into indexes
-				tmpl->calculateCompoundStatus();	// Force status change to NORMAL
-         }
-         else     // Object load failed
-         {
-            tmpl->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load template object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<Template>(loaderConfig, _T("SELECT id FROM templates"), _T("templates"), _T("template"), OnTemplateLoad);
 
-   // Load network maps
-   DbgPrintf(2, _T("Loading network maps..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM network_maps"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto map = make_shared<NetworkMap>();
-         if (map->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(map, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            map->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load network map object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<NetworkMap>(loaderConfig, _T("SELECT id FROM network_maps"), _T("network maps"), _T("network map"));
    g_idxNetMapById.setStartupMode(false);
 
-   // Load container objects
-   DbgPrintf(2, _T("Loading containers..."));
    TCHAR query[256];
    _sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_CONTAINER);
-   hResult = DBSelect(hdb, query);
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto container = make_shared<Container>();
-         if (container->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(container, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            container->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load container object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<Container>(loaderConfig, query, _T("containers"), _T("container"));
 
-   // Load template group objects
-   DbgPrintf(2, _T("Loading template groups..."));
    _sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_TEMPLATEGROUP);
-   hResult = DBSelect(hdb, query);
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto group = make_shared<TemplateGroup>();
-         if (group->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(group, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            group->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load template group object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<TemplateGroup>(loaderConfig, query, _T("template groups"), _T("template group"));
 
-   // Load map group objects
-   DbgPrintf(2, _T("Loading map groups..."));
    _sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_NETWORKMAPGROUP);
-   hResult = DBSelect(hdb, query);
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto group = make_shared<NetworkMapGroup>();
-         if (group->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(group, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            group->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load network map group object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<NetworkMapGroup>(loaderConfig, query, _T("map groups"), _T("network map group"));
 
-   // Load dashboard objects
-   DbgPrintf(2, _T("Loading dashboards..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM dashboards"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto dashboard = make_shared<Dashboard>();
-         if (dashboard->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(dashboard, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            dashboard->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load dashboard object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<Dashboard>(loaderConfig, _T("SELECT id FROM dashboards"), _T("dashboards"), _T("dashboard"));
 
-   // Load dashboard group objects
-   DbgPrintf(2, _T("Loading dashboard groups..."));
    _sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_DASHBOARDGROUP);
-   hResult = DBSelect(hdb, query);
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto group = make_shared<DashboardGroup>();
-         if (group->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(group, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            group->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load dashboard group object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<DashboardGroup>(loaderConfig, query, _T("dashboard groups"), _T("dashboard group"));
 
-   // Loading business service objects
-   DbgPrintf(2, _T("Loading business services..."));
    _sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_BUSINESSSERVICE);
-   hResult = DBSelect(hdb, query);
-   if (hResult != nullptr)
-   {
-	   int count = DBGetNumRows(hResult);
-	   for(int i = 0; i < count; i++)
-	   {
-		   UINT32 id = DBGetFieldULong(hResult, i, 0);
-		   auto service = make_shared<BusinessService>();
-		   if (service->loadFromDatabase(hdb, id))
-		   {
-			   NetObjInsert(service, false, false);  // Insert into indexes
-		   }
-		   else     // Object load failed
-		   {
-			   service->destroy();
-			   nxlog_write(NXLOG_ERROR, _T("Failed to load business service object with ID %u from database"), id);
-		   }
-	   }
-	   DBFreeResult(hResult);
-   }
+   LoadObjectClass<BusinessService>(loaderConfig, query, _T("business services"), _T("business service"));
 
-   // Loading business service objects
-   DbgPrintf(2, _T("Loading node links..."));
    _sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_NODELINK);
-   hResult = DBSelect(hdb, query);
-   if (hResult != nullptr)
-   {
-	   int count = DBGetNumRows(hResult);
-	   for(int i = 0; i < count; i++)
-	   {
-		   UINT32 id = DBGetFieldULong(hResult, i, 0);
-		   auto nl = make_shared<NodeLink>();
-		   if (nl->loadFromDatabase(hdb, id))
-		   {
-			   NetObjInsert(nl, false, false);  // Insert into indexes
-		   }
-		   else     // Object load failed
-		   {
-			   nl->destroy();
-			   nxlog_write(NXLOG_ERROR, _T("Failed to load node link object with ID %u from database"), id);
-		   }
-	   }
-	   DBFreeResult(hResult);
-   }
+   LoadObjectClass<NodeLink>(loaderConfig, query, _T("node links"), _T("node link"));
 
-   // Load service check objects
-   DbgPrintf(2, _T("Loading service checks..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM slm_checks"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto check = make_shared<SlmCheck>();
-         if (check->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(check, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            check->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load service check object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   LoadObjectClass<SlmCheck>(loaderConfig, _T("SELECT id FROM slm_checks"), _T("service checks"), _T("service check"));
 
    g_idxObjectById.setStartupMode(false);
    g_idxServiceCheckById.setStartupMode(false);
@@ -2090,6 +1994,8 @@ BOOL LoadObjects()
 	// Load custom object classes provided by modules
    CALL_ALL_MODULES(pfLoadObjects, ());
 
+   EnableStartupDataSets(false);
+
    // Link children to container and template group objects
    DbgPrintf(2, _T("Linking objects..."));
 	g_idxObjectById.forEach(LinkObjects, nullptr);
@@ -2130,6 +2036,8 @@ BOOL LoadObjects()
    if (cachedb != nullptr)
       DBCloseInMemoryDatabase(cachedb);
 
+   nxlog_write_tag(NXLOG_INFO, DEBUG_TAG_OBJECT_INIT, _T("%d objects loaded from database in %u ms"),
+            static_cast<int>(g_idxObjectById.size()), static_cast<uint32_t>(GetCurrentTimeMs() - loadStartTime));
    return TRUE;
 }
 
@@ -0,0 +1,360 @@
+/*
+** NetXMS - Network Management System
+** Copyright (C) 2003-2021 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: perf.cpp
+**
+**/
+
+#include "nxcore.h"
+
+/**
+ * Per-thread counters are only possible if thread local objects can have destructors
+ */
+#if defined(_WIN32) || HAVE_THREAD_LOCAL_SPECIFIER
+#define WITH_THREAD_COUNTERS 1
+#endif
+
+/**
+ * Hot path names
+ */
+static const TCHAR *s_hotPathNames[PERF_HOT_PATH_COUNT] =
+{
+   _T("StatusPoll"),
+   _T("ConfigurationPoll"),
+   _T("TopologyPoll"),
+   _T("DataCollection"),
+   _T("EventProcessing"),
+   _T("ScriptExecution"),
+   _T("DBWriterBatch"),
+   _T("ClientRequest")
+};
+
+/**
+ * Slow object record
+ */
+struct PerfSlowObject
+{
+   uint32_t key;
+   uint64_t time;
+};
+
+/**
+ * Counters for single hot path
+ */
+struct PerfPathCounters
+{
+   uint64_t count;
+   uint64_t totalTime;
+   uint64_t maxTime;
+   int topCount;
+   PerfSlowObject top[PERF_TOP_OBJECTS];
+
+   /**
+    * Update list of slowest objects. Each object appears in the list once with its maximum time.
+    */
+   void updateTop(uint32_t key, uint64_t time)
+   {
+      int minIndex = 0;
+      for(int i = 0; i < topCount; i++)
+      {
+         if (top[i].key == key)
+         {
+            if (top[i].time < time)
+               top[i].time = time;
+            return;
+         }
+         if (top[i].time < top[minIndex].time)
+            minIndex = i;
+      }
+
+      if (topCount < PERF_TOP_OBJECTS)
+      {
+         top[topCount].key = key;
+         top[topCount].time = time;
+         topCount++;
+      }
+      else if (top[minIndex].time < time)
+      {
+         top[minIndex].key = key;
+         top[minIndex].time = time;
+      }
+   }
+
+   /**
+    * Update counters with new measurement
+    */
+   void update(uint32_t key, uint64_t time)
+   {
+      count++;
+      totalTime += time;
+      if (time > maxTime)
+         maxTime = time;
+      if (key != 0)
+         updateTop(key, time);
+   }
+
+   /**
+    * Merge counters from another set
+    */
+   void merge(const PerfPathCounters& src)
+   {
+      count += src.count;
+      totalTime += src.totalTime;
+      if (src.maxTime > maxTime)
+         maxTime = src.maxTime;
+      for(int i = 0; i < src.topCount; i++)
+         updateTop(src.top[i].key, src.top[i].time);
+   }
+};
+
+/**
+ * Profiler data block (one per thread)
+ */
+struct PerfThreadData
+{
+   Mutex mutex;
+   PerfPathCounters counters[PERF_HOT_PATH_COUNT];
+
+   PerfThreadData() : mutex(true)
+   {
+      memset(counters, 0, sizeof(counters));
+   }
+
+   void reset()
+   {
+      mutex.lock();
+      memset(counters, 0, sizeof(counters));
+      mutex.unlock();
+   }
+};
+
+/**
+ * Counters from exited threads (also used directly if thread local storage is not available)
+ */
+static PerfThreadData s_retiredData;
+
+#if WITH_THREAD_COUNTERS
+
+/**
+ * Registered thread data blocks
+ */
+static ObjectArray<PerfThreadData> s_threadData(64, 64, Ownership::False);
+static Mutex s_threadDataLock(true);
+
+/**
+ * Holder for thread's data block. Registers block on first use and merges
+ * collected counters into retired data on thread exit.
+ */
+class PerfThreadDataHolder
+{
+private:
+   PerfThreadData *m_data;
+
+public:
+   PerfThreadDataHolder()
+   {
+      m_data = nullptr;
+   }
+
+   ~PerfThreadDataHolder()
+   {
+      if (m_data == nullptr)
+         return;
+
+      s_threadDataLock.lock();
+      s_threadData.remove(m_data);
+      s_retiredData.mutex.lock();
+      for(int i = 0; i < PERF_HOT_PATH_COUNT; i++)
+         s_retiredData.counters[i].merge(m_data->counters[i]);
+      s_retiredData.mutex.unlock();
+      s_threadDataLock.unlock();
+
+      delete m_data;
+      m_data = nullptr;
+      s_destroyed = true;
+   }
+
+   PerfThreadData *get()
+   {
+      if (m_data == nullptr)
+      {
+         m_data = new PerfThreadData();
+         s_threadDataLock.lock();
+         s_threadData.add(m_data);
+         s_threadDataLock.unlock();
+      }
+      return m_data;
+   }
+
+   static thread_local bool s_destroyed;
+};
+
+/**
+ * Set to true when thread's data block is destroyed on thread exit (timers can still fire after that)
+ */
+thread_local bool PerfThreadDataHolder::s_destroyed = false;
+
+/**
+ * Data block holder for current thread
+ */
+static thread_local PerfThreadDataHolder s_localData;
+
+#endif /* WITH_THREAD_COUNTERS */
+
+/**
+ * Record execution time (in microseconds) for given hot path
+ */
+void NXCORE_EXPORTABLE PerfRecord(PerfHotPath path, uint32_t key, uint64_t elapsedTime)
+{
+#if WITH_THREAD_COUNTERS
+   PerfThreadData *data = !PerfThreadDataHolder::s_destroyed ? s_localData.get() : &s_retiredData;
+#else
+   PerfThreadData *data = &s_retiredData;
+#endif
+   data->mutex.lock();
+   data->counters[static_cast<int>(path)].update(key, elapsedTime);
+   data->mutex.unlock();
+}
+
+/**
+ * Collect counters from all threads
+ */
+static void CollectPerfStats(PerfPathCounters *counters)
+{
+   s_retiredData.mutex.lock();
+   memcpy(counters, s_retiredData.counters, sizeof(PerfPathCounters) * PERF_HOT_PATH_COUNT);
+   s_retiredData.mutex.unlock();
+
+#if WITH_THREAD_COUNTERS
+   s_threadDataLock.lock();
+   for(int i = 0; i < s_threadData.size(); i++)
+   {
+      PerfThreadData *data = s_threadData.get(i);
+      data->mutex.lock();
+      for(int j = 0; j < PERF_HOT_PATH_COUNT; j++)
+         counters[j].merge(data->counters[j]);
+      data->mutex.unlock();
+   }
+   s_threadDataLock.unlock();
+#endif
+}
+
+/**
+ * Reset all profiler counters
+ */
+void ResetPerfStats()
+{
+   s_retiredData.reset();
+#if WITH_THREAD_COUNTERS
+   s_threadDataLock.lock();
+   for(int i = 0; i < s_threadData.size(); i++)
+      s_threadData.get(i)->reset();
+   s_threadDataLock.unlock();
+#endif
+}
+
+/**
+ * Compare slow object records by time (descending)
+ */
+static int CompareSlowObjects(const void *e1, const void *e2)
+{
+   uint64_t t1 = static_cast<const PerfSlowObject*>(e1)->time;
+   uint64_t t2 = static_cast<const PerfSlowObject*>(e2)->time;
+   return (t1 < t2) ? 1 : ((t1 > t2) ? -1 : 0);
+}
+
+/**
+ * Get display name for slow object record
+ */
+static TCHAR *GetSlowObjectName(PerfHotPath path, uint32_t key, TCHAR *buffer)
+{
+   if (path == PerfHotPath::CLIENT_REQUEST)
+      return NXCPMessageCodeName(static_cast<uint16_t>(key), buffer);
+
+   shared_ptr<NetObj> object = FindObjectById(key);
+   if (object != nullptr)
+      _sntprintf(buffer, 256, _T("%s [%u]"), object->getName(), key);
+   else
+      _sntprintf(buffer, 256, _T("[%u]"), key);
+   return buffer;
+}
+
+/**
+ * Show profiler statistics on server console
+ */
+void ShowPerfStats(CONSOLE_CTX console)
+{
+   PerfPathCounters counters[PERF_HOT_PATH_COUNT];
+   CollectPerfStats(counters);
+
+   ConsolePrintf(console, _T("\x1b[1m%-20s %10s %12s %10s %10s\x1b[0m\n"), _T("Hot path"), _T("Count"), _T("Total"), _T("Average"), _T("Max"));
+   for(int i = 0; i < PERF_HOT_PATH_COUNT; i++)
+   {
+      PerfPathCounters *c = &counters[i];
+      ConsolePrintf(console, _T("%-20s ") UINT64_FMT_ARGS(_T("10")) _T(" %12.1f %10.3f %10.3f\n"), s_hotPathNames[i], c->count,
+               static_cast<double>(c->totalTime) / 1000.0,
+               (c->count > 0) ? static_cast<double>(c->totalTime) / static_cast<double>(c->count) / 1000.0 : 0.0,
+               static_cast<double>(c->maxTime) / 1000.0);
+   }
+
+   TCHAR name[256];
+   for(int i = 0; i < PERF_HOT_PATH_COUNT; i++)
+   {
+      PerfPathCounters *c = &counters[i];
+      if (c->topCount == 0)
+         continue;
+
+      qsort(c->top, c->topCount, sizeof(PerfSlowObject), CompareSlowObjects);
+      ConsolePrintf(console, _T("\n\x1b[1mSlowest objects for %s:\x1b[0m\n"), s_hotPathNames[i]);
+      for(int j = 0; j < c->topCount; j++)
+      {
+         ConsolePrintf(console, _T("   %10.3f  %s\n"), static_cast<double>(c->top[j].time) / 1000.0,
+                  GetSlowObjectName(static_cast<PerfHotPath>(i), c->top[j].key, name));
+      }
+   }
+
+   ConsoleWrite(console, _T("\nAll times are in milliseconds\n\n"));
+}
+
+/**
+ * Fill NXCP message with profiler statistics. All times are in microseconds.
+ */
+void FillPerfStatsMessage(NXCPMessage *msg)
+{
+   PerfPathCounters counters[PERF_HOT_PATH_COUNT];
+   CollectPerfStats(counters);
+
+   uint32_t fieldId = VID_ELEMENT_LIST_BASE;
+   for(int i = 0; i < PERF_HOT_PATH_COUNT; i++, fieldId += 50)
+   {
+      PerfPathCounters *c = &counters[i];
+      qsort(c->top, c->topCount, sizeof(PerfSlowObject), CompareSlowObjects);
+      msg->setField(fieldId, s_hotPathNames[i]);
+      msg->setField(fieldId + 1, c->count);
+      msg->setField(fieldId + 2, c->totalTime);
+      msg->setField(fieldId + 3, c->maxTime);
+      msg->setField(fieldId + 4, static_cast<uint32_t>(c->topCount));
+      uint32_t topFieldId = fieldId + 10;
+      for(int j = 0; j < c->topCount; j++, topFieldId += 2)
+      {
+         msg->setField(topFieldId, c->top[j].key);
+         msg->setField(topFieldId + 1, c->top[j].time);
+      }
+   }
+   msg->setField(VID_NUM_ELEMENTS, static_cast<uint32_t>(PERF_HOT_PATH_COUNT));
+}
@@ -0,0 +1,554 @@
+/*
+** NetXMS - Network Management System
+** Copyright (C) 2003-2021 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: rollup.cpp
+**
+**/
+
+#include "nxcore.h"
+
+#define DEBUG_TAG _T("dc.rollup")
+
+/**
+ * Throttle background database task if needed (defined in hk.cpp)
+ */
+bool ThrottleBackgroundDBTask(const TCHAR *name, CONDITION wakeupCondition, const bool *shutdown);
+
+/**
+ * Delay before period is rolled up, to allow late data (like offline agent data) to arrive
+ */
+#define ROLLUP_DELAY          900
+
+/**
+ * Maximum number of hourly periods processed in one run. Limits load caused by initial backfill.
+ */
+#define MAX_HOURLY_PERIODS    24
+
+/**
+ * Rollup engine wakeup interval (seconds)
+ */
+#define ROLLUP_INTERVAL       300
+
+/**
+ * Rollup resolution definition
+ */
+struct RollupResolutionInfo
+{
+   const TCHAR *table;
+   const TCHAR *watermarkVariable;
+   const TCHAR *retentionParameter;
+   time_t period;
+   int defaultRetentionTime;
+};
+
+/**
+ * Supported resolutions
+ */
+static const RollupResolutionInfo s_resolutions[] =
+{
+   { _T("dci_rollup_hourly"), _T("DCIRollupWatermark.Hourly"), _T("DataCollection.Rollup.HourlyRetentionTime"), 3600, 90 },
+   { _T("dci_rollup_daily"), _T("DCIRollupWatermark.Daily"), _T("DataCollection.Rollup.DailyRetentionTime"), 86400, 1825 }
+};
+
+/**
+ * Current watermarks (end of rolled up time range, exclusive)
+ */
+static time_t s_watermarks[2] = { 0, 0 };
+
+/**
+ * Rollup enabled flag
+ */
+static bool s_enabled = false;
+
+/**
+ * Shutdown flag and wakeup condition
+ */
+static bool s_shutdown = false;
+static CONDITION s_wakeupCondition = INVALID_CONDITION_HANDLE;
+static THREAD s_thread = INVALID_THREAD_HANDLE;
+
+/**
+ * DCI eligible for rollup
+ */
+struct RollupItem
+{
+   uint32_t id;
+   DCObjectStorageClass storageClass;
+};
+
+/**
+ * Get SQL expression for start of period for given integer timestamp column
+ */
+static String PeriodStartExpression(const TCHAR *column, time_t period)
+{
+   StringBuffer expr;
+   switch(g_dbSyntax)
+   {
+      case DB_SYNTAX_MYSQL:
+         expr.appendFormattedString(_T("(%s DIV %d)*%d"), column, static_cast<int>(period), static_cast<int>(period));
+         break;
+      case DB_SYNTAX_ORACLE:
+         expr.appendFormattedString(_T("floor(%s/%d)*%d"), column, static_cast<int>(period), static_cast<int>(period));
+         break;
+      default:
+         expr.appendFormattedString(_T("(%s/%d)*%d"), column, static_cast<int>(period), static_cast<int>(period));
+         break;
+   }
+   return expr;
+}
+
+/**
+ * Get SQL expressions for converting idata_value to number and for filtering out non-numeric values.
+ * Values that are not numbers are excluded from any aggregation done by database.
+ */
+void GetNumericDCIValueExpressions(const TCHAR **value, const TCHAR **filter)
+{
+   switch(g_dbSyntax)
+   {
+      case DB_SYNTAX_MSSQL:
+         *value = _T("cast(idata_value as float)");
+         *filter = _T(" AND idata_value LIKE '[0-9-]%' AND idata_value LIKE '%[0-9]' AND idata_value NOT LIKE '_%[^0-9.]%' AND idata_value NOT LIKE '%.%.%' AND idata_value NOT LIKE '-.%'");
+         break;
+      case DB_SYNTAX_MYSQL:
+         *value = _T("cast(idata_value as decimal(30,10))");
+         *filter = _T(" AND idata_value REGEXP '^-?[0-9]+([.][0-9]+)?$'");
+         break;
+      case DB_SYNTAX_ORACLE:
+         *value = _T("to_number(idata_value)");
+         *filter = _T(" AND REGEXP_LIKE(idata_value,'^-?[0-9]+([.][0-9]+)?$')");
+         break;
+      case DB_SYNTAX_PGSQL:
+      case DB_SYNTAX_TSDB:
+         *value = _T("idata_value::double precision");
+         *filter = _T(" AND idata_value~'^-?[0-9]+([.][0-9]+)?$'");
+         break;
+      case DB_SYNTAX_SQLITE:
+         *value = _T("cast(idata_value as double)");
+         *filter = _T(" AND idata_value GLOB '[0-9-]*' AND idata_value GLOB '*[0-9]' AND idata_value NOT GLOB '?*[^0-9.]*' AND idata_value NOT GLOB '*.*.*' AND idata_value NOT GLOB '-.*'");
+         break;
+      default:
+         *value = _T("cast(idata_value as double)");
+         *filter = _T("");
+         break;
+   }
+}
+
+/**
+ * Check if DCI value is a number in format accepted by filters from GetNumericDCIValueExpressions
+ * (optional minus sign followed by digits and optional fractional part).
+ */
+bool IsNumericDCIValue(const TCHAR *value)
+{
+   const TCHAR *p = value;
+   if (*p == _T('-'))
+      p++;
+   if (!_istdigit(*p))
+      return false;
+   while(_istdigit(*p))
+      p++;
+   if (*p == _T('.'))
+   {
+      p++;
+      if (!_istdigit(*p))
+         return false;
+      while(_istdigit(*p))
+         p++;
+   }
+   return *p == 0;
+}
+
+/**
+ * Build INSERT ... SELECT query for hourly rollup of single DCI
+ */
+static void BuildHourlyRollupQuery(StringBuffer *query, uint32_t nodeId, DCObjectStorageClass storageClass)
+{
+   query->append(_T("INSERT INTO dci_rollup_hourly (item_id,rollup_timestamp,min_value,max_value,avg_value,value_count) "));
+
+   if ((g_dbSyntax == DB_SYNTAX_TSDB) && (g_flags & AF_SINGLE_TABLE_PERF_DATA))
+   {
+      query->appendFormattedString(
+               _T("SELECT item_id,date_part('epoch',time_bucket('3600 seconds',idata_timestamp))::int,min(idata_value::double precision),max(idata_value::double precision),avg(idata_value::double precision),count(*) ")
+               _T("FROM idata_sc_%s WHERE item_id=? AND idata_timestamp>=to_timestamp(?) AND idata_timestamp<to_timestamp(?) AND idata_value~'^-?[0-9]+([.][0-9]+)?$' ")
+               _T("GROUP BY item_id,time_bucket('3600 seconds',idata_timestamp)"), DCObject::getStorageClassName(storageClass));
+      return;
+   }
+
+   const TCHAR *value, *filter;
+   GetNumericDCIValueExpressions(&value, &filter);
+
+   String periodStart = PeriodStartExpression(_T("idata_timestamp"), 3600);
+   query->appendFormattedString(_T("SELECT item_id,%s,min(%s),max(%s),avg(%s),count(*) FROM "), periodStart.cstr(), value, value, value);
+   if (g_flags & AF_PARTITIONED_PERF_DATA)
+      query->appendFormattedString(_T("idata_sc_%s"), DCObject::getStorageClassName(storageClass));
+   else if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
+      query->append(_T("idata"));
+   else
+      query->appendFormattedString(_T("idata_%u"), nodeId);
+   query->appendFormattedString(_T(" WHERE item_id=? AND idata_timestamp>=? AND idata_timestamp<?%s GROUP BY item_id,%s"), filter, periodStart.cstr());
+}
+
+/**
+ * Callback for collecting DCIs eligible for rollup
+ */
+static bool CollectRollupItems(const shared_ptr<DCObject>& object, uint32_t index, void *context)
+{
+   if ((object->getType() == DCO_TYPE_ITEM) && object->isDataStorageEnabled())
+   {
+      int dataType = static_cast<DCItem*>(object.get())->getDataType();
+      if ((dataType != DCI_DT_STRING) && (dataType != DCI_DT_NULL))
+      {
+         RollupItem item;
+         item.id = object->getId();
+         item.storageClass = object->getStorageClass();
+         static_cast<StructArray<RollupItem>*>(context)->add(item);
+      }
+   }
+   return true;
+}
+
+/**
+ * Rollup raw data of given data collection target for given time range
+ */
+static bool RollupTargetData(DB_HANDLE hdb, DataCollectionTarget *target, time_t from, time_t to)
+{
+   StructArray<RollupItem> items(0, 64);
+   target->enumDCObjects(CollectRollupItems, &items);
+   if (items.isEmpty())
+      return true;
+
+   DB_STATEMENT hDeleteStmt = DBPrepare(hdb, _T("DELETE FROM dci_rollup_hourly WHERE item_id=? AND rollup_timestamp>=? AND rollup_timestamp<?"), true);
+   if (hDeleteStmt == nullptr)
+      return false;
+
+   bool success = DBBegin(hdb);
+   DB_STATEMENT hInsertStmt = nullptr;
+   DCObjectStorageClass currentStorageClass = DCObjectStorageClass::DEFAULT;
+   for(int i = 0; (i < items.size()) && success; i++)
+   {
+      RollupItem *item = items.get(i);
+
+      // Re-delete period to make rollup idempotent if previous run was interrupted before watermark update
+      DBBind(hDeleteStmt, 1, DB_SQLTYPE_INTEGER, item->id);
+      DBBind(hDeleteStmt, 2, DB_SQLTYPE_INTEGER, static_cast<int32_t>(from));
+      DBBind(hDeleteStmt, 3, DB_SQLTYPE_INTEGER, static_cast<int32_t>(to));
+      success = DBExecute(hDeleteStmt);
+      if (!success)
+         break;
+
+      // Only TSDB and partitioned table queries depend on storage class
+      if ((hInsertStmt == nullptr) || (((g_dbSyntax == DB_SYNTAX_TSDB) || (g_flags & AF_PARTITIONED_PERF_DATA)) && (item->storageClass != currentStorageClass)))
+      {
+         if (hInsertStmt != nullptr)
+            DBFreeStatement(hInsertStmt);
+         StringBuffer query;
+         BuildHourlyRollupQuery(&query, target->getId(), item->storageClass);
+         hInsertStmt = DBPrepare(hdb, query, true);
+         currentStorageClass = item->storageClass;
+         if (hInsertStmt == nullptr)
+         {
+            success = false;
+            break;
+         }
+      }
+
+      DBBind(hInsertStmt, 1, DB_SQLTYPE_INTEGER, item->id);
+      DBBind(hInsertStmt, 2, DB_SQLTYPE_INTEGER, static_cast<int32_t>(from));
+      DBBind(hInsertStmt, 3, DB_SQLTYPE_INTEGER, static_cast<int32_t>(to));
+      success = DBExecute(hInsertStmt);
+   }
+
+   if (success)
+      DBCommit(hdb);
+   else
+      DBRollback(hdb);
+
+   if (hInsertStmt != nullptr)
+      DBFreeStatement(hInsertStmt);
+   DBFreeStatement(hDeleteStmt);
+   return success;
+}
+
+/**
+ * Advance hourly rollup. Returns true if watermark was advanced.
+ */
+static bool AdvanceHourlyRollup(DB_HANDLE hdb, time_t now)
+{
+   time_t from = s_watermarks[0];
+   time_t to = std::min(((now - ROLLUP_DELAY) / 3600) * 3600, from + MAX_HOURLY_PERIODS * 3600);
+   if (to <= from)
+      return false;
+
+   nxlog_debug_tag(DEBUG_TAG, 5, _T("Hourly rollup for range ") INT64_FMT _T(" - ") INT64_FMT, static_cast<int64_t>(from), static_cast<int64_t>(to));
+
+   SharedObjectArray<NetObj> objects(1024, 1024);
+   g_idxAccessPointById.getObjects(&objects);
+   g_idxChassisById.getObjects(&objects);
+   g_idxClusterById.getObjects(&objects);
+   g_idxMobileDeviceById.getObjects(&objects);
+   g_idxNodeById.getObjects(&objects);
+   g_idxSensorById.getObjects(&objects);
+
+   SharedObjectArray<NetObj> retryList;
+   int64_t startTime = GetCurrentTimeMs();
+   for(int i = 0; i < objects.size(); i++)
+   {
+      if (s_shutdown)
+         return false;
+
+      DataCollectionTarget *target = static_cast<DataCollectionTarget*>(objects.get(i));
+      if (!RollupTargetData(hdb, target, from, to))
+      {
+         nxlog_debug_tag(DEBUG_TAG, 4, _T("Hourly rollup failed for object %s [%u], will retry after other objects"), target->getName(), target->getId());
+         retryList.add(objects.getShared(i));
+      }
+
+      if (!ThrottleBackgroundDBTask(_T("DCI rollup"), s_wakeupCondition, &s_shutdown))
+         return false;
+   }
+
+   // Retry failed objects once (failure could be caused by transient condition like deadlock);
+   // objects that still fail are skipped so that one object cannot block rollup for all others
+   for(int i = 0; i < retryList.size(); i++)
+   {
+      if (s_shutdown)
+         return false;
+
+      DataCollectionTarget *target = static_cast<DataCollectionTarget*>(retryList.get(i));
+      if (!RollupTargetData(hdb, target, from, to))
+      {
+         nxlog_write_tag(NXLOG_WARNING, DEBUG_TAG, _T("Hourly rollup for range ") INT64_FMT _T(" - ") INT64_FMT _T(" failed for object %s [%u], object skipped"),
+                  static_cast<int64_t>(from), static_cast<int64_t>(to), target->getName(), target->getId());
+      }
+   }
+
+   s_watermarks[0] = to;
+   MetaDataWriteInt32(s_resolutions[0].watermarkVariable, static_cast<int32_t>(to));
+   nxlog_debug_tag(DEBUG_TAG, 5, _T("Hourly rollup completed in ") INT64_FMT _T(" ms for %d objects, new watermark is ") INT64_FMT,
+            GetCurrentTimeMs() - startTime, objects.size(), static_cast<int64_t>(to));
+   return true;
+}
+
+/**
+ * Advance daily rollup from hourly data
+ */
+static void AdvanceDailyRollup(DB_HANDLE hdb)
+{
+   time_t from = s_watermarks[1];
+   time_t to = (s_watermarks[0] / 86400) * 86400;
+   if (to <= from)
+      return;
+
+   nxlog_debug_tag(DEBUG_TAG, 5, _T("Daily rollup for range ") INT64_FMT _T(" - ") INT64_FMT, static_cast<int64_t>(from), static_cast<int64_t>(to));
+
+   String periodStart = PeriodStartExpression(_T("rollup_timestamp"), 86400);
+   TCHAR query[1024];
+   _sntprintf(query, 1024,
+            _T("INSERT INTO dci_rollup_daily (item_id,rollup_timestamp,min_value,max_value,avg_value,value_count) ")
+            _T("SELECT item_id,%s,min(min_value),max(max_value),sum(avg_value*value_count)/sum(value_count),sum(value_count) ")
+            _T("FROM dci_rollup_hourly WHERE rollup_timestamp>=? AND rollup_timestamp<? GROUP BY item_id,%s"),
+            periodStart.cstr(), periodStart.cstr());
+
+   bool success = false;
+   if (DBBegin(hdb))
+   {
+      DB_STATEMENT hStmt = DBPrepare(hdb, _T("DELETE FROM dci_rollup_daily WHERE rollup_timestamp>=? AND rollup_timestamp<?"));
+      if (hStmt != nullptr)
+      {
+         DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, static_cast<int32_t>(from));
+         DBBind(hStmt, 2, DB_SQLTYPE_INTEGER, static_cast<int32_t>(to));
+         success = DBExecute(hStmt);
+         DBFreeStatement(hStmt);
+      }
+
+      if (success)
+      {
+         hStmt = DBPrepare(hdb, query);
+         if (hStmt != nullptr)
+         {
+            DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, static_cast<int32_t>(from));
+            DBBind(hStmt, 2, DB_SQLTYPE_INTEGER, static_cast<int32_t>(to));
+            success = DBExecute(hStmt);
+            DBFreeStatement(hStmt);
+         }
+         else
+         {
+            success = false;
+         }
+      }
+
+      if (success)
+         DBCommit(hdb);
+      else
+         DBRollback(hdb);
+   }
+
+   if (success)
+   {
+      s_watermarks[1] = to;
+      MetaDataWriteInt32(s_resolutions[1].watermarkVariable, static_cast<int32_t>(to));
+      nxlog_debug_tag(DEBUG_TAG, 5, _T("Daily rollup completed, new watermark is ") INT64_FMT, static_cast<int64_t>(to));
+   }
+   else
+   {
+      nxlog_debug_tag(DEBUG_TAG, 4, _T("Daily rollup failed"));
+   }
+}
+
+/**
+ * Rollup engine thread
+ */
+static void RollupThread()
+{
+   ThreadSetName("DCIRollup");
+   nxlog_debug_tag(DEBUG_TAG, 2, _T("DCI rollup thread started (hourly watermark ") INT64_FMT _T(", daily watermark ") INT64_FMT _T(")"),
+            static_cast<int64_t>(s_watermarks[0]), static_cast<int64_t>(s_watermarks[1]));
+
+   while(!s_shutdown)
+   {
+      DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+      time_t now = time(nullptr);
+      if (AdvanceHourlyRollup(hdb, now))
+         AdvanceDailyRollup(hdb);
+      DBConnectionPoolReleaseConnection(hdb);
+
+      // Continue immediately if backfill is in progress
+      if ((s_watermarks[0] + MAX_HOURLY_PERIODS * 3600 < now - ROLLUP_DELAY) && !s_shutdown)
+         continue;
+
+      ConditionWait(s_wakeupCondition, ROLLUP_INTERVAL * 1000);
+   }
+
+   nxlog_debug_tag(DEBUG_TAG, 2, _T("DCI rollup thread stopped"));
+}
+
+/**
+ * Delete expired rollup data. Called by housekeeper.
+ */
+void CleanDCIRollupData(DB_HANDLE hdb)
+{
+   if (!s_enabled)
+      return;
+
+   time_t now = time(nullptr);
+   for(int i = 0; i < 2; i++)
+   {
+      int retentionTime = ConfigReadInt(s_resolutions[i].retentionParameter, s_resolutions[i].defaultRetentionTime);
+      if (retentionTime <= 0)
+         continue;
+
+      TCHAR query[256];
+      _sntprintf(query, 256, _T("DELETE FROM %s WHERE rollup_timestamp<") INT64_FMT, s_resolutions[i].table, static_cast<int64_t>(now - retentionTime * 86400));
+      nxlog_debug_tag(DEBUG_TAG, 4, _T("Clearing %s (retention time %d days)"), s_resolutions[i].table, retentionTime);
+      DBQuery(hdb, query);
+   }
+}
+
+/**
+ * Check if DCI data rollup is enabled
+ */
+bool IsDCIRollupEnabled()
+{
+   return s_enabled;
+}
+
+/**
+ * Get current watermark for given resolution. All data before watermark is available in rollup table.
+ */
+time_t GetDCIRollupWatermark(RollupResolution resolution)
+{
+   return s_watermarks[static_cast<int>(resolution)];
+}
+
+/**
+ * Get period for given resolution (in seconds)
+ */
+time_t GetDCIRollupPeriod(RollupResolution resolution)
+{
+   return s_resolutions[static_cast<int>(resolution)].period;
+}
+
+/**
+ * Get rollup table name for given resolution
+ */
+const TCHAR *GetDCIRollupTable(RollupResolution resolution)
+{
+   return s_resolutions[static_cast<int>(resolution)].table;
+}
+
+/**
+ * Select coarsest rollup resolution with period not exceeding given step and with data available
+ * starting at given time. Returns false if data should be read at raw resolution.
+ */
+bool SelectDCIRollupResolution(time_t step, time_t startTime, RollupResolution *resolution)
+{
+   if (!s_enabled)
+      return false;
+
+   for(int i = 1; i >= 0; i--)
+   {
+      if ((step >= s_resolutions[i].period) && (s_watermarks[i] > startTime))
+      {
+         *resolution = static_cast<RollupResolution>(i);
+         return true;
+      }
+   }
+   return false;
+}
+
+/**
+ * Start DCI data rollup engine
+ */
+void StartDCIRollup()
+{
+   s_enabled = ConfigReadBoolean(_T("DataCollection.Rollup.Enable"), true);
+   if (!s_enabled)
+   {
+      nxlog_debug_tag(DEBUG_TAG, 1, _T("DCI data rollup is disabled"));
+      return;
+   }
+
+   // Initial backfill starts at hourly retention boundary
+   time_t now = time(nullptr);
+   time_t initialWatermark = ((now - ConfigReadInt(s_resolutions[0].retentionParameter, s_resolutions[0].defaultRetentionTime) * 86400) / 86400) * 86400;
+   for(int i = 0; i < 2; i++)
+   {
+      s_watermarks[i] = MetaDataReadInt32(s_resolutions[i].watermarkVariable, 0);
+      if (s_watermarks[i] == 0)
+      {
+         s_watermarks[i] = initialWatermark;
+         MetaDataWriteInt32(s_resolutions[i].watermarkVariable, static_cast<int32_t>(initialWatermark));
+      }
+   }
+
+   s_wakeupCondition = ConditionCreate(false);
+   s_thread = ThreadCreateEx(RollupThread);
+}
+
+/**
+ * Stop DCI data rollup engine
+ */
+void StopDCIRollup()
+{
+   if (!s_enabled)
+      return;
+
+   s_shutdown = true;
+   ConditionSet(s_wakeupCondition);
+   ThreadJoin(s_thread);
+   ConditionDestroy(s_wakeupCondition);
+}
@@ -812,3 +812,88 @@ void ExecuteStartupScripts()
    }
    nxlog_debug_tag(DEBUG_TAG_BASE,  1, _T("%d startup scripts processed"), count);
 }
+
+/**
+ * Print collected script profile to server console
+ */
+void PrintScriptProfile(ServerConsole *console, const NXSL_VM *vm, bool byInstruction, int maxEntries)
+{
+   const NXSL_Profiler *profiler = vm->getProfiler();
+   if (profiler == nullptr)
+      return;
+
+   StructArray<NXSL_ProfileEntry> *profile = vm->getProfile(byInstruction);
+   uint64_t totalTime = 0;
+   for(int i = 0; i < profile->size(); i++)
+      totalTime += profile->get(i)->getEstimatedTime();
+
+   console->printf(_T("Run time: %.3f ms (%u run(s), ") UINT64_FMT _T(" instructions, sampling interval %u)\n\n"),
+            static_cast<double>(profiler->getRunTime()) / 1000000, profiler->getRunCount(), profiler->getTotalExecutions(), profiler->getSampleInterval());
+   if (byInstruction)
+   {
+      console->print(_T("\x1b[1mModule\x1b[0m               | \x1b[1mLine\x1b[0m  | \x1b[1mAddr\x1b[0m | \x1b[1mOpcode\x1b[0m | \x1b[1mExecutions\x1b[0m | \x1b[1mTime (ms)\x1b[0m  | \x1b[1mTime %\x1b[0m\n"));
+      console->print(_T("---------------------+-------+------+--------+------------+------------+-------\n"));
+   }
+   else
+   {
+      console->print(_T("\x1b[1mModule\x1b[0m               | \x1b[1mLine\x1b[0m  | \x1b[1mExecutions\x1b[0m | \x1b[1mTime (ms)\x1b[0m  | \x1b[1mTime %\x1b[0m\n"));
+      console->print(_T("---------------------+-------+------------+------------+-------\n"));
+   }
+
+   int count = std::min(profile->size(), maxEntries);
+   for(int i = 0; i < count; i++)
+   {
+      NXSL_ProfileEntry *e = profile->get(i);
+      uint64_t t = e->getEstimatedTime();
+      double share = (totalTime > 0) ? static_cast<double>(t) * 100.0 / static_cast<double>(totalTime) : 0;
+      if (byInstruction)
+      {
+         console->printf(_T("%-20s | %5d | %04X | %-6hs | ") UINT64_FMT_ARGS(_T("10")) _T(" | %10.3f | %5.1f\n"),
+                  (e->module != nullptr) ? e->module : _T("(main)"), e->line, e->addr, e->mnemonic, e->executions,
+                  static_cast<double>(t) / 1000000, share);
+      }
+      else
+      {
+         console->printf(_T("%-20s | %5d | ") UINT64_FMT_ARGS(_T("10")) _T(" | %10.3f | %5.1f\n"),
+                  (e->module != nullptr) ? e->module : _T("(main)"), e->line, e->executions,
+                  static_cast<double>(t) / 1000000, share);
+      }
+   }
+   if (profile->size() > count)
+      console->printf(_T("\n%d of %d entries shown\n"), count, profile->size());
+   console->print(_T("\n"));
+
+   delete profile;
+}
+
+/**
+ * Fill NXCP message with collected script profile
+ */
+void FillScriptProfileMessage(NXCPMessage *msg, const NXSL_VM *vm, bool byInstruction, int maxEntries)
+{
+   const NXSL_Profiler *profiler = vm->getProfiler();
+   if (profiler == nullptr)
+      return;
+
+   msg->setField(VID_EXECUTION_TIME, profiler->getRunTime());
+   msg->setField(VID_INSTRUCTION_COUNT, profiler->getTotalExecutions());
+   msg->setField(VID_SAMPLING_INTERVAL, profiler->getSampleInterval());
+
+   StructArray<NXSL_ProfileEntry> *profile = vm->getProfile(byInstruction);
+   int count = std::min(profile->size(), maxEntries);
+   uint32_t fieldId = VID_ELEMENT_LIST_BASE;
+   for(int i = 0; i < count; i++, fieldId += 10)
+   {
+      NXSL_ProfileEntry *e = profile->get(i);
+      msg->setField(fieldId, CHECK_NULL_EX(e->module));
+      msg->setField(fieldId + 1, e->line);
+      msg->setField(fieldId + 2, e->addr);
+      msg->setFieldFromMBString(fieldId + 3, CHECK_NULL_EX_A(e->mnemonic));
+      msg->setField(fieldId + 4, e->executions);
+      msg->setField(fieldId + 5, e->samples);
+      msg->setField(fieldId + 6, e->sampledTime);
+      msg->setField(fieldId + 7, e->getEstimatedTime());
+   }
+   msg->setField(VID_NUM_ELEMENTS, count);
+   delete profile;
+}
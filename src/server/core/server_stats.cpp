@@ -48,6 +48,8 @@ extern ThreadPool *g_schedulerThreadPool;
 
 int64_t GetEventLogWriterQueueSize();
 int64_t GetEventProcessorQueueSize();
+int64_t GetNotificationChannelQueueSize();
+int64_t GetNotificationLogWriterQueueSize();
 
 /**
  * Internal queue statistic
@@ -101,7 +103,7 @@ inline void AddQueueToCollector(const TCHAR *name, int64_t (*function)())
  */
 static int64_t GetTotalDBWriterQueueSize()
 {
-   return GetIDataWriterQueueSize() + GetRawDataWriterQueueSize() + g_dbWriterQueue.size();
+   return GetIDataWriterQueueSize() + GetTDataWriterQueueSize() + GetRawDataWriterQueueSize() + g_dbWriterQueue.size();
 }
 
 /**
@@ -137,12 +139,15 @@ void ServerStatCollector()
    s_queuesLock.lock();
    AddQueueToCollector(_T("DataCollector"), g_dataCollectorThreadPool);
    AddQueueToCollector(_T("DBWriter.IData"), GetIDataWriterQueueSize);
+   AddQueueToCollector(_T("DBWriter.TData"), GetTDataWriterQueueSize);
    AddQueueToCollector(_T("DBWriter.Other"), &g_dbWriterQueue);
    AddQueueToCollector(_T("DBWriter.RawData"), GetRawDataWriterQueueSize);
    AddQueueToCollector(_T("DBWriter.Total"), GetTotalDBWriterQueueSize);
    AddQueueToCollector(_T("EventLogWriter"), GetEventLogWriterQueueSize);
    AddQueueToCollector(_T("EventProcessor"), GetEventProcessorQueueSize);
    AddQueueToCollector(_T("NodeDiscoveryPoller"), GetDiscoveryPollerQueueSize);
+   AddQueueToCollector(_T("NotificationChannels"), GetNotificationChannelQueueSize);
+   AddQueueToCollector(_T("NotificationLogWriter"), GetNotificationLogWriterQueueSize);
    AddQueueToCollector(_T("Poller"), g_pollerThreadPool);
    AddQueueToCollector(_T("Scheduler"), g_schedulerThreadPool);
    AddQueueToCollector(_T("SyslogProcessor"), &g_syslogProcessingQueue);
@@ -212,23 +217,12 @@ DataCollectionError GetQueueStatistic(const TCHAR *parameter, StatisticType type
    return DCE_SUCCESS;
 }
 
-/**
- * DCI cache memory usage calculation callback
- */
-static void GetCacheMemoryUsage(NetObj *object, uint64_t *size)
-{
-   if (object->isDataCollectionTarget())
-      *size += static_cast<DataCollectionTarget*>(object)->getCacheMemoryUsage();
-}
-
 /**
  * Get amount of memory used by DCI cache
  */
 uint64_t GetDCICacheMemoryUsage()
 {
-   uint64_t dciCache = 0;
-   g_idxObjectById.forEach(GetCacheMemoryUsage, &dciCache);
-   return dciCache;
+   return GetMemoryUsage(MemoryCategory::DCI_CACHE);
 }
 
 /**
@@ -183,7 +183,8 @@ void ClientSession::terminate(ClientSession *session)
 /**
  * Client session class constructor
  */
-ClientSession::ClientSession(SOCKET hSocket, const InetAddress& addr) : m_downloadFileMap(Ownership::True), m_subscriptions(Ownership::True)
+ClientSession::ClientSession(SOCKET hSocket, const InetAddress& addr) : m_downloadFileMap(Ownership::True), m_subscriptions(Ownership::True),
+         m_lastValuesSubscriptions(Ownership::True)
 {
    m_id = -1;
    m_socket = hSocket;
@@ -225,6 +226,9 @@ ClientSession::ClientSession(SOCKET hSocket, const InetAddress& addr) : m_downlo
    m_objectNotificationScheduled = false;
    m_objectNotificationBatchSize = 500;
    m_objectNotificationDelay = 200;
+   m_lastValuesLock = MutexCreateFast();
+   m_lastValuesUpdateScheduled = false;
+   m_lastValuesUpdateInterval = 1000;
 }
 
 /**
@@ -268,6 +272,7 @@ ClientSession::~ClientSession()
    MutexDestroy(m_tcpProxyLock);
    delete m_pendingObjectNotifications;
    MutexDestroy(m_pendingObjectNotificationsLock);
+   MutexDestroy(m_lastValuesLock);
 
    delete m_loginInfo;
 
@@ -556,6 +561,10 @@ void ClientSession::finalize()
    // Mark as terminated (sendMessage calls will not work after that point)
    InterlockedOr(&m_flags, CSF_TERMINATED);
 
+   // Stop incremental last values updates (should be done before waiting for pending requests
+   // because change notifications can schedule new update task)
+   cancelLastValuesSubscription(0);
+
    // remove all pending file transfers from reporting server
    RemovePendingFileTransferRequests(this);
 
@@ -899,6 +908,7 @@ void ClientSession::processRequest(NXCPMessage *request)
       return;
    }
 
+   PerfScopedTimer perfTimer(PerfHotPath::CLIENT_REQUEST, code);
    switch(code)
    {
       case CMD_LOGIN:
@@ -1181,6 +1191,12 @@ void ClientSession::processRequest(NXCPMessage *request)
       case CMD_GET_DCI_VALUES:
          getLastValuesByDciId(request);
          break;
+      case CMD_SUBSCRIBE_LAST_VALUES:
+         subscribeLastValues(request);
+         break;
+      case CMD_UNSUBSCRIBE_LAST_VALUES:
+         unsubscribeLastValues(request);
+         break;
       case CMD_GET_TOOLTIP_LAST_VALUES:
          getTooltipLastValues(request);
          break;
@@ -1403,6 +1419,12 @@ void ClientSession::processRequest(NXCPMessage *request)
       case CMD_EXECUTE_LIBRARY_SCRIPT:
          executeLibraryScript(request);
          break;
+      case CMD_PROFILE_LIBRARY_SCRIPT:
+         profileLibraryScript(request);
+         break;
+      case CMD_GET_PERF_STATS:
+         getPerfStats(request);
+         break;
       case CMD_GET_JOB_LIST:
          sendJobList(request->getId());
          break;
@@ -1911,6 +1933,7 @@ void ClientSession::sendRawMessage(NXCP_MESSAGE *msg)
  */
 void ClientSession::sendRawMessageAndDelete(NXCP_MESSAGE *msg)
 {
+   UpdateMemoryUsage(MemoryCategory::NXCP_SEND_QUEUES, -static_cast<int64_t>(ntohl(msg->size)), -1);
    sendRawMessage(msg);
    MemFree(msg);
    decRefCount();
@@ -1923,6 +1946,7 @@ void ClientSession::postRawMessageAndDelete(NXCP_MESSAGE *msg)
 {
    TCHAR key[32];
    _sntprintf(key, 32, _T("POST/%u"), m_id);
+   UpdateMemoryUsage(MemoryCategory::NXCP_SEND_QUEUES, ntohl(msg->size), 1);
    incRefCount();
    ThreadPoolExecuteSerialized(g_clientThreadPool, key, this, &ClientSession::sendRawMessageAndDelete, msg);
 }
@@ -2374,6 +2398,7 @@ void ClientSession::finalizeLogin(const NXCPMessage& request, NXCPMessage *respo
       response->setField(VID_ALARM_LIST_DISP_LIMIT, ConfigReadULong(_T("Client.AlarmList.DisplayLimit"), 4096));
       response->setField(VID_SERVER_COMMAND_TIMEOUT, ConfigReadULong(_T("ServerCommandOutputTimeout"), 60));
       response->setField(VID_GRACE_LOGINS, m_loginInfo->graceLogins);
+      m_lastValuesUpdateInterval = ConfigReadULong(_T("Client.LastValuesUpdateInterval"), 1000);
 
       GetClientConfigurationHints(response);
       FillLicenseProblemsMessage(response);
@@ -3340,6 +3365,98 @@ void ClientSession::onObjectChange(const shared_ptr<NetObj>& object)
    }
 }
 
+/**
+ * Pending last values update for single object
+ */
+struct LastValuesUpdate
+{
+   uint32_t objectId;
+   bool objectTooltipOnly;
+   bool overviewOnly;
+   bool includeNoValueObjects;
+   HashSet<uint32_t> dciFilter;
+};
+
+/**
+ * Send pending last values updates
+ */
+void ClientSession::sendLastValuesUpdates()
+{
+   if ((m_flags & (CSF_TERMINATE_REQUESTED | CSF_TERMINATED)) != 0)
+   {
+      decRefCount();
+      return;
+   }
+
+   HashMap<uint32_t, LastValuesUpdate> updates(Ownership::True);
+
+   MutexLock(m_lastValuesLock);
+   auto it = m_pendingLastValues.iterator();
+   while(it->hasNext())
+   {
+      uint64_t key = *it->next();
+      uint32_t objectId = static_cast<uint32_t>(key >> 32);
+      LastValuesUpdate *update = updates.get(objectId);
+      if (update == nullptr)
+      {
+         LastValuesSubscription *subscription = m_lastValuesSubscriptions.get(objectId);
+         if (subscription == nullptr)
+            continue;   // Subscription was cancelled after change notification
+
+         update = new LastValuesUpdate();
+         update->objectId = objectId;
+         update->objectTooltipOnly = subscription->objectTooltipOnly;
+         update->overviewOnly = subscription->overviewOnly;
+         update->includeNoValueObjects = subscription->includeNoValueObjects;
+         updates.set(objectId, update);
+      }
+      update->dciFilter.put(static_cast<uint32_t>(key & 0xFFFFFFFF));
+   }
+   delete it;
+   m_pendingLastValues.clear();
+   m_lastValuesUpdateScheduled = false;
+   MutexUnlock(m_lastValuesLock);
+
+   auto uit = updates.iterator();
+   while(uit->hasNext())
+   {
+      LastValuesUpdate *update = uit->next();
+      shared_ptr<NetObj> object = FindObjectById(update->objectId);
+      if ((object == nullptr) || !object->isDataCollectionTarget() || !object->checkAccessRights(m_dwUserId, OBJECT_ACCESS_READ))
+         continue;
+
+      NXCPMessage msg(CMD_LAST_VALUES_UPDATE, 0);
+      msg.setField(VID_OBJECT_ID, update->objectId);
+      static_cast<DataCollectionTarget&>(*object).getLastValues(&msg, update->objectTooltipOnly, update->overviewOnly,
+               update->includeNoValueObjects, m_dwUserId, &update->dciFilter);
+      if (msg.getFieldAsUInt32(VID_NUM_ITEMS) > 0)
+         sendMessage(msg);
+   }
+   delete uit;
+
+   decRefCount();
+}
+
+/**
+ * Handler for DCI last value or status change (only called for objects this session is subscribed to)
+ */
+void ClientSession::onLastValueChange(uint32_t objectId, uint32_t dciId)
+{
+   MutexLock(m_lastValuesLock);
+   LastValuesSubscription *subscription = m_lastValuesSubscriptions.get(objectId);
+   if ((subscription != nullptr) && ((subscription->dciFilter.size() == 0) || subscription->dciFilter.contains(dciId)))
+   {
+      m_pendingLastValues.put((static_cast<uint64_t>(objectId) << 32) | dciId);
+      if (!m_lastValuesUpdateScheduled)
+      {
+         m_lastValuesUpdateScheduled = true;
+         incRefCount();
+         ThreadPoolScheduleRelative(g_clientThreadPool, m_lastValuesUpdateInterval, this, &ClientSession::sendLastValuesUpdates);
+      }
+   }
+   MutexUnlock(m_lastValuesLock);
+}
+
 /**
  * Send notification message to server
  */
@@ -4559,50 +4676,59 @@ void ClientSession::sendDCIThresholds(NXCPMessage *request)
    sendMessage(&msg);
 }
 
-#define SELECTION_COLUMNS (historicalDataType != DCO_TYPE_RAW) ? tablePrefix : _T(""), (historicalDataType == DCO_TYPE_BOTH) ? _T("_value,raw_value") : (historicalDataType == DCO_TYPE_PROCESSED) ?  _T("_value") : _T("raw_value")
+#define SELECTION_COLUMNS (historicalDataType != DCO_TYPE_RAW) ? tablePrefix : "", (historicalDataType == DCO_TYPE_BOTH) ? "_value,raw_value" : (historicalDataType == DCO_TYPE_PROCESSED) ?  "_value" : "raw_value"
 
 /**
- * Prepare statement for reading data from idata/tdata table
+ * Build query for reading data from idata/tdata table. Query is built as UTF-8 string with all
+ * values inlined (they are all integers), so it can be passed to driver without conversion.
  */
-static DB_STATEMENT PrepareDataSelect(DB_HANDLE hdb, UINT32 nodeId, int dciType, DCObjectStorageClass storageClass,
-         UINT32 maxRows, HistoricalDataType historicalDataType, const TCHAR *condition)
+static bool BuildDataSelectQuery(char *query, size_t size, uint32_t nodeId, uint32_t dciId, int dciType, DCObjectStorageClass storageClass,
+         uint32_t maxRows, HistoricalDataType historicalDataType, const char *condition)
 {
-   const TCHAR *tablePrefix = (dciType == DCO_TYPE_ITEM) ? _T("idata") : _T("tdata");
-	TCHAR query[512];
+   const char *tablePrefix = (dciType == DCO_TYPE_ITEM) ? "idata" : "tdata";
+   char storageClassName[32];
+   tchar_to_utf8(DCObject::getStorageClassName(storageClass), -1, storageClassName, 32);
 	if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
 	{
+	   // With partitioned tables read directly from storage class table instead of union view
+	   char table[64];
+	   if (g_flags & AF_PARTITIONED_PERF_DATA)
+	      snprintf(table, 64, "%s_sc_%s", tablePrefix, storageClassName);
+	   else
+	      strcpy(table, tablePrefix);
+
       switch(g_dbSyntax)
       {
          case DB_SYNTAX_MSSQL:
-            _sntprintf(query, 512, _T("SELECT TOP %d %s_timestamp,%s%s FROM %s WHERE item_id=?%s ORDER BY %s_timestamp DESC"),
+            snprintf(query, size, "SELECT TOP %d %s_timestamp,%s%s FROM %s WHERE item_id=%u%s ORDER BY %s_timestamp DESC",
                      (int)maxRows, tablePrefix, SELECTION_COLUMNS,
-                     tablePrefix, condition, tablePrefix);
+                     tablePrefix, dciId, condition, tablePrefix);
             break;
          case DB_SYNTAX_ORACLE:
-            _sntprintf(query, 512, _T("SELECT * FROM (SELECT %s_timestamp,%s%s FROM %s WHERE item_id=?%s ORDER BY %s_timestamp DESC) WHERE ROWNUM<=%d"),
+            snprintf(query, size, "SELECT * FROM (SELECT %s_timestamp,%s%s FROM %s WHERE item_id=%u%s ORDER BY %s_timestamp DESC) WHERE ROWNUM<=%d",
                      tablePrefix, SELECTION_COLUMNS,
-                     tablePrefix, condition, tablePrefix, (int)maxRows);
+                     table, dciId, condition, tablePrefix, (int)maxRows);
             break;
          case DB_SYNTAX_MYSQL:
          case DB_SYNTAX_PGSQL:
          case DB_SYNTAX_SQLITE:
-            _sntprintf(query, 512, _T("SELECT %s_timestamp,%s%s FROM %s WHERE item_id=?%s ORDER BY %s_timestamp DESC LIMIT %d"),
+            snprintf(query, size, "SELECT %s_timestamp,%s%s FROM %s WHERE item_id=%u%s ORDER BY %s_timestamp DESC LIMIT %d",
                      tablePrefix, SELECTION_COLUMNS,
-                     tablePrefix, condition, tablePrefix, (int)maxRows);
+                     table, dciId, condition, tablePrefix, (int)maxRows);
             break;
          case DB_SYNTAX_TSDB:
-            _sntprintf(query, 512, _T("SELECT date_part('epoch',%s_timestamp)::int,%s%s FROM %s_sc_%s WHERE item_id=?%s ORDER BY %s_timestamp DESC LIMIT %d"),
+            snprintf(query, size, "SELECT date_part('epoch',%s_timestamp)::int,%s%s FROM %s_sc_%s WHERE item_id=%u%s ORDER BY %s_timestamp DESC LIMIT %d",
                      tablePrefix, SELECTION_COLUMNS,
-                     tablePrefix, DCObject::getStorageClassName(storageClass), condition, tablePrefix, (int)maxRows);
+                     tablePrefix, storageClassName, dciId, condition, tablePrefix, (int)maxRows);
             break;
          case DB_SYNTAX_DB2:
-            _sntprintf(query, 512, _T("SELECT %s_timestamp,%s%s FROM %s WHERE item_id=?%s ORDER BY %s_timestamp DESC FETCH FIRST %d ROWS ONLY"),
+            snprintf(query, size, "SELECT %s_timestamp,%s%s FROM %s WHERE item_id=%u%s ORDER BY %s_timestamp DESC FETCH FIRST %d ROWS ONLY",
                      tablePrefix, SELECTION_COLUMNS,
-                     tablePrefix, condition, tablePrefix, (int)maxRows);
+                     tablePrefix, dciId, condition, tablePrefix, (int)maxRows);
             break;
          default:
-            DbgPrintf(1, _T("INTERNAL ERROR: unsupported database in PrepareDataSelect"));
-            return nullptr;   // Unsupported database
+            DbgPrintf(1, _T("INTERNAL ERROR: unsupported database in BuildDataSelectQuery"));
+            return false;   // Unsupported database
       }
 	}
 	else
@@ -4610,34 +4736,374 @@ static DB_STATEMENT PrepareDataSelect(DB_HANDLE hdb, UINT32 nodeId, int dciType,
       switch(g_dbSyntax)
       {
          case DB_SYNTAX_MSSQL:
-            _sntprintf(query, 512, _T("SELECT TOP %d %s_timestamp,%s%s FROM %s_%u WHERE item_id=?%s ORDER BY %s_timestamp DESC"),
+            snprintf(query, size, "SELECT TOP %d %s_timestamp,%s%s FROM %s_%u WHERE item_id=%u%s ORDER BY %s_timestamp DESC",
                      (int)maxRows, tablePrefix, SELECTION_COLUMNS,
-                     tablePrefix, nodeId, condition, tablePrefix);
+                     tablePrefix, nodeId, dciId, condition, tablePrefix);
             break;
          case DB_SYNTAX_ORACLE:
-            _sntprintf(query, 512, _T("SELECT * FROM (SELECT %s_timestamp,%s%s FROM %s_%u WHERE item_id=?%s ORDER BY %s_timestamp DESC) WHERE ROWNUM<=%d"),
+            snprintf(query, size, "SELECT * FROM (SELECT %s_timestamp,%s%s FROM %s_%u WHERE item_id=%u%s ORDER BY %s_timestamp DESC) WHERE ROWNUM<=%d",
                      tablePrefix, SELECTION_COLUMNS,
-                     tablePrefix, nodeId, condition, tablePrefix, (int)maxRows);
+                     tablePrefix, nodeId, dciId, condition, tablePrefix, (int)maxRows);
             break;
          case DB_SYNTAX_MYSQL:
          case DB_SYNTAX_PGSQL:
          case DB_SYNTAX_SQLITE:
          case DB_SYNTAX_TSDB:
-            _sntprintf(query, 512, _T("SELECT %s_timestamp,%s%s FROM %s_%u WHERE item_id=?%s ORDER BY %s_timestamp DESC LIMIT %d"),
+            snprintf(query, size, "SELECT %s_timestamp,%s%s FROM %s_%u WHERE item_id=%u%s ORDER BY %s_timestamp DESC LIMIT %d",
                      tablePrefix, SELECTION_COLUMNS,
-                     tablePrefix, nodeId, condition, tablePrefix, (int)maxRows);
+                     tablePrefix, nodeId, dciId, condition, tablePrefix, (int)maxRows);
             break;
          case DB_SYNTAX_DB2:
-            _sntprintf(query, 512, _T("SELECT %s_timestamp,%s%s FROM %s_%u WHERE item_id=?%s ORDER BY %s_timestamp DESC FETCH FIRST %d ROWS ONLY"),
+            snprintf(query, size, "SELECT %s_timestamp,%s%s FROM %s_%u WHERE item_id=%u%s ORDER BY %s_timestamp DESC FETCH FIRST %d ROWS ONLY",
                      tablePrefix, SELECTION_COLUMNS,
-                     tablePrefix, nodeId, condition, tablePrefix, (int)maxRows);
+                     tablePrefix, nodeId, dciId, condition, tablePrefix, (int)maxRows);
             break;
          default:
-            DbgPrintf(1, _T("INTERNAL ERROR: unsupported database in PrepareDataSelect"));
-            return nullptr;	// Unsupported database
+            DbgPrintf(1, _T("INTERNAL ERROR: unsupported database in BuildDataSelectQuery"));
+            return false;	// Unsupported database
       }
 	}
-	return DBPrepare(hdb, query);
+	return true;
+}
+
+/**
+ * Build query for reading data from idata table aggregated into fixed time buckets (as UTF-8 string).
+ * Returns false if aggregation is not supported by database backend.
+ */
+static bool BuildAggregatedDataSelectQuery(char *query, size_t size, uint32_t nodeId, uint32_t dciId, DCObjectStorageClass storageClass,
+         DownsamplingMethod method, uint32_t timeFrom, uint32_t timeTo, uint32_t bucketSize)
+{
+   static const char *functions[] = { "", "min", "max", "avg" };
+
+   char table[64];
+   if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
+   {
+      if ((g_dbSyntax == DB_SYNTAX_TSDB) || (g_flags & AF_PARTITIONED_PERF_DATA))
+      {
+         strcpy(table, "idata_sc_");
+         tchar_to_utf8(DCObject::getStorageClassName(storageClass), -1, &table[9], 55);
+      }
+      else
+      {
+         strcpy(table, "idata");
+      }
+   }
+   else
+   {
+      snprintf(table, 64, "idata_%u", nodeId);
+   }
+
+   // Non-numeric values are excluded from aggregation on all backends
+   const TCHAR *tvalue, *tfilter;
+   GetNumericDCIValueExpressions(&tvalue, &tfilter);
+   char value[128], filter[256];
+   tchar_to_utf8(tvalue, -1, value, 128);
+   tchar_to_utf8(tfilter, -1, filter, 256);
+
+   switch(g_dbSyntax)
+   {
+      case DB_SYNTAX_MSSQL:
+      case DB_SYNTAX_PGSQL:
+      case DB_SYNTAX_SQLITE:
+         snprintf(query, size, "SELECT min(idata_timestamp),%s(%s) FROM %s WHERE item_id=%u AND idata_timestamp BETWEEN %u AND %u%s GROUP BY (idata_timestamp-%u)/%u ORDER BY 1 DESC",
+                  functions[method], value, table, dciId, timeFrom, timeTo, filter, timeFrom, bucketSize);
+         break;
+      case DB_SYNTAX_MYSQL:
+         snprintf(query, size, "SELECT min(idata_timestamp),%s(%s) FROM %s WHERE item_id=%u AND idata_timestamp BETWEEN %u AND %u%s GROUP BY (idata_timestamp-%u) DIV %u ORDER BY 1 DESC",
+                  functions[method], value, table, dciId, timeFrom, timeTo, filter, timeFrom, bucketSize);
+         break;
+      case DB_SYNTAX_ORACLE:
+         snprintf(query, size, "SELECT min(idata_timestamp),%s(%s) FROM %s WHERE item_id=%u AND idata_timestamp BETWEEN %u AND %u%s GROUP BY floor((idata_timestamp-%u)/%u) ORDER BY 1 DESC",
+                  functions[method], value, table, dciId, timeFrom, timeTo, filter, timeFrom, bucketSize);
+         break;
+      case DB_SYNTAX_TSDB:
+         if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
+         {
+            snprintf(query, size, "SELECT date_part('epoch',min(idata_timestamp))::int,%s(%s) FROM %s WHERE item_id=%u AND idata_timestamp BETWEEN to_timestamp(%u) AND to_timestamp(%u)%s GROUP BY time_bucket('%u seconds',idata_timestamp) ORDER BY 1 DESC",
+                     functions[method], value, table, dciId, timeFrom, timeTo, filter, bucketSize);
+         }
+         else
+         {
+            snprintf(query, size, "SELECT min(idata_timestamp),%s(%s) FROM %s WHERE item_id=%u AND idata_timestamp BETWEEN %u AND %u%s GROUP BY (idata_timestamp-%u)/%u ORDER BY 1 DESC",
+                     functions[method], value, table, dciId, timeFrom, timeTo, filter, timeFrom, bucketSize);
+         }
+         break;
+      default:
+         return false;   // Aggregation will be done on server side
+   }
+   return true;
+}
+
+/**
+ * Size of DCI data row for each data type
+ */
+static const uint32_t s_dciDataRowSize[] = { 8, 8, 16, 16, 516, 16, 8, 8, 16 };
+
+/**
+ * Maximum size of single DCI data chunk (in bytes)
+ */
+#define DCI_DATA_CHUNK_SIZE   262144
+
+/**
+ * Writer for DCI data sent to client in CMD_DCI_DATA messages. In chunked mode data is sent
+ * in multiple messages, each except last one marked with DCI_DATA_MORE_CHUNKS flag.
+ */
+class DCIDataWriter
+{
+private:
+   ClientSession *m_session;
+   uint32_t m_requestId;
+   int m_dataType;
+   uint32_t m_rowSize;
+   uint32_t m_chunkCapacity;
+   DCI_DATA_HEADER *m_data;
+   uint32_t m_allocated;
+   uint32_t m_rows;
+
+   void send(bool last);
+
+public:
+   DCIDataWriter(ClientSession *session, uint32_t requestId, uint32_t dciId, int dataType, bool chunked);
+   ~DCIDataWriter()
+   {
+      MemFree(m_data);
+   }
+
+   DCI_DATA_ROW *allocateRows(uint32_t count);
+   void setValue(DCI_DATA_ROW *row, double value);
+   void finish()
+   {
+      send(true);
+   }
+
+   int getDataType() const { return m_dataType; }
+};
+
+/**
+ * DCI data writer constructor
+ */
+DCIDataWriter::DCIDataWriter(ClientSession *session, uint32_t requestId, uint32_t dciId, int dataType, bool chunked)
+{
+   m_session = session;
+   m_requestId = requestId;
+   m_dataType = dataType;
+   m_rowSize = s_dciDataRowSize[dataType];
+   m_chunkCapacity = chunked ? std::max(DCI_DATA_CHUNK_SIZE / m_rowSize, 2U) : 0;
+   m_allocated = chunked ? m_chunkCapacity : 256;
+   m_rows = 0;
+   m_data = static_cast<DCI_DATA_HEADER*>(MemAlloc(m_allocated * m_rowSize + sizeof(DCI_DATA_HEADER)));
+   m_data->dataType = htonl(static_cast<uint32_t>(dataType));
+   m_data->dciId = htonl(dciId);
+}
+
+/**
+ * Allocate given number of consecutive rows. Rows allocated by single call are guaranteed
+ * to be sent in same chunk.
+ */
+DCI_DATA_ROW *DCIDataWriter::allocateRows(uint32_t count)
+{
+   if (m_rows + count > m_allocated)
+   {
+      if ((m_chunkCapacity > 0) && (m_rows > 0))
+      {
+         send(false);
+         m_rows = 0;
+      }
+      if (m_rows + count > m_allocated)
+      {
+         m_allocated += std::max(count, std::min(m_allocated, 65536U));
+         m_data = static_cast<DCI_DATA_HEADER*>(MemRealloc(m_data, m_allocated * m_rowSize + sizeof(DCI_DATA_HEADER)));
+      }
+   }
+   DCI_DATA_ROW *row = reinterpret_cast<DCI_DATA_ROW*>(reinterpret_cast<char*>(m_data) + sizeof(DCI_DATA_HEADER) + m_rows * m_rowSize);
+   m_rows += count;
+   return row;
+}
+
+/**
+ * Set numeric value of data row converting it to writer's data type
+ */
+void DCIDataWriter::setValue(DCI_DATA_ROW *row, double value)
+{
+   switch(m_dataType)
+   {
+      case DCI_DT_INT:
+         row->value.int32 = htonl(static_cast<uint32_t>(static_cast<int32_t>(value)));
+         break;
+      case DCI_DT_UINT:
+      case DCI_DT_COUNTER32:
+         row->value.int32 = htonl((value > 0) ? static_cast<uint32_t>(value) : 0);
+         break;
+      case DCI_DT_INT64:
+         row->value.ext.v64.int64 = htonq(static_cast<uint64_t>(static_cast<int64_t>(value)));
+         break;
+      case DCI_DT_UINT64:
+      case DCI_DT_COUNTER64:
+         row->value.ext.v64.int64 = htonq((value > 0) ? static_cast<uint64_t>(value) : 0);
+         break;
+      case DCI_DT_FLOAT:
+         row->value.ext.v64.real = htond(value);
+         break;
+   }
+}
+
+/**
+ * Send current chunk to client
+ */
+void DCIDataWriter::send(bool last)
+{
+   m_data->numRows = htonl(m_rows);
+   m_data->flags = last ? 0 : htonl(DCI_DATA_MORE_CHUNKS);
+   NXCP_MESSAGE *msg = CreateRawNXCPMessage(CMD_DCI_DATA, m_requestId, 0,
+            m_data, m_rows * m_rowSize + sizeof(DCI_DATA_HEADER), nullptr, m_session->isCompressionEnabled());
+   m_session->sendRawMessage(msg);
+   MemFree(msg);
+}
+
+/**
+ * Downsampler sending resulting points to DCI data writer
+ */
+class DCIDataWriterDownsampler : public DCIDataDownsampler
+{
+private:
+   DCIDataWriter *m_writer;
+
+protected:
+   virtual void output(time_t timestamp, double value) override
+   {
+      DCI_DATA_ROW *row = m_writer->allocateRows(1);
+      row->timeStamp = htonl(static_cast<uint32_t>(timestamp));
+      m_writer->setValue(row, value);
+   }
+
+public:
+   DCIDataWriterDownsampler(DCIDataWriter *writer, DownsamplingMethod method, time_t timeFrom, time_t bucketSize) :
+            DCIDataDownsampler(method, timeFrom, bucketSize)
+   {
+      m_writer = writer;
+   }
+};
+
+/**
+ * Fill data row value from database field
+ */
+static void SetDataRowValue(DCI_DATA_ROW *row, int dataType, DB_UNBUFFERED_RESULT hResult, int column)
+{
+   switch(dataType)
+   {
+      case DCI_DT_INT:
+      case DCI_DT_UINT:
+      case DCI_DT_COUNTER32:
+         row->value.int32 = htonl(DBGetFieldULong(hResult, column));
+         break;
+      case DCI_DT_INT64:
+      case DCI_DT_UINT64:
+      case DCI_DT_COUNTER64:
+         row->value.ext.v64.int64 = htonq(DBGetFieldUInt64(hResult, column));
+         break;
+      case DCI_DT_FLOAT:
+         row->value.ext.v64.real = htond(DBGetFieldDouble(hResult, column));
+         break;
+      case DCI_DT_STRING:
+#ifdef UNICODE
+#ifdef UNICODE_UCS4
+         TCHAR buffer[MAX_DCI_STRING_VALUE];
+         DBGetField(hResult, column, buffer, MAX_DCI_STRING_VALUE);
+         ucs4_to_ucs2(buffer, -1, row->value.string, MAX_DCI_STRING_VALUE);
+#else
+         DBGetField(hResult, column, row->value.string, MAX_DCI_STRING_VALUE);
+#endif
+#else
+         TCHAR buffer[MAX_DCI_STRING_VALUE];
+         DBGetField(hResult, column, buffer, MAX_DCI_STRING_VALUE);
+         mb_to_ucs2(buffer, -1, row->value.string, MAX_DCI_STRING_VALUE);
+#endif
+         SwapUCS2String(row->value.string);
+         break;
+   }
+}
+
+/**
+ * Fill data row value from table cell
+ */
+static void SetDataRowValue(DCI_DATA_ROW *row, int dataType, const Table *table, int tableRow, int tableColumn)
+{
+   switch(dataType)
+   {
+      case DCI_DT_INT:
+         row->value.int32 = htonl(static_cast<uint32_t>(table->getAsInt(tableRow, tableColumn)));
+         break;
+      case DCI_DT_UINT:
+      case DCI_DT_COUNTER32:
+         row->value.int32 = htonl(table->getAsUInt(tableRow, tableColumn));
+         break;
+      case DCI_DT_INT64:
+         row->value.ext.v64.int64 = htonq(static_cast<uint64_t>(table->getAsInt64(tableRow, tableColumn)));
+         break;
+      case DCI_DT_UINT64:
+      case DCI_DT_COUNTER64:
+         row->value.ext.v64.int64 = htonq(table->getAsUInt64(tableRow, tableColumn));
+         break;
+      case DCI_DT_FLOAT:
+         row->value.ext.v64.real = htond(table->getAsDouble(tableRow, tableColumn));
+         break;
+      case DCI_DT_STRING:
+#ifdef UNICODE
+#ifdef UNICODE_UCS4
+         ucs4_to_ucs2(CHECK_NULL_EX(table->getAsString(tableRow, tableColumn)), -1, row->value.string, MAX_DCI_STRING_VALUE);
+#else
+         wcslcpy(row->value.string, CHECK_NULL_EX(table->getAsString(tableRow, tableColumn)), MAX_DCI_STRING_VALUE);
+#endif
+#else
+         mb_to_ucs2(CHECK_NULL_EX(table->getAsString(tableRow, tableColumn)), -1, row->value.string, MAX_DCI_STRING_VALUE);
+#endif
+         SwapUCS2String(row->value.string);
+         break;
+   }
+}
+
+/**
+ * Feed data from rollup table into downsampler. Rows are read in descending order, same as raw data.
+ */
+static bool ReadRollupData(DB_HANDLE hdb, DCIDataDownsampler *downsampler, DownsamplingMethod method, RollupResolution resolution,
+         uint32_t dciId, time_t timeFrom, time_t timeTo)
+{
+   TCHAR query[256];
+   _sntprintf(query, 256, _T("SELECT rollup_timestamp,min_value,max_value,avg_value,value_count FROM %s WHERE item_id=? AND rollup_timestamp>=? AND rollup_timestamp<? ORDER BY rollup_timestamp DESC"),
+            GetDCIRollupTable(resolution));
+   DB_STATEMENT hStmt = DBPrepare(hdb, query);
+   if (hStmt == nullptr)
+      return false;
+
+   DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, dciId);
+   DBBind(hStmt, 2, DB_SQLTYPE_INTEGER, static_cast<int32_t>(timeFrom));
+   DBBind(hStmt, 3, DB_SQLTYPE_INTEGER, static_cast<int32_t>(timeTo));
+   DB_UNBUFFERED_RESULT hResult = DBSelectPreparedUnbuffered(hStmt);
+   if (hResult != nullptr)
+   {
+      while(DBFetch(hResult))
+      {
+         time_t timestamp = DBGetFieldULong(hResult, 0);
+         switch(method)
+         {
+            case DCI_DOWNSAMPLING_MIN:
+               downsampler->add(timestamp, DBGetFieldDouble(hResult, 1));
+               break;
+            case DCI_DOWNSAMPLING_MAX:
+               downsampler->add(timestamp, DBGetFieldDouble(hResult, 2));
+               break;
+            case DCI_DOWNSAMPLING_AVG:
+               downsampler->add(timestamp, DBGetFieldDouble(hResult, 3), DBGetFieldULong(hResult, 4));
+               break;
+            default:
+               downsampler->add(timestamp, DBGetFieldDouble(hResult, 3));
+               break;
+         }
+      }
+      DBFreeResult(hResult);
+   }
+   DBFreeStatement(hStmt);
+   return hResult != nullptr;
 }
 
 /**
@@ -4645,8 +5111,6 @@ static DB_STATEMENT PrepareDataSelect(DB_HANDLE hdb, UINT32 nodeId, int dciType,
  */
 bool ClientSession::getCollectedDataFromDB(NXCPMessage *request, NXCPMessage *response, const DataCollectionTarget& dcTarget, int dciType, HistoricalDataType historicalDataType)
 {
-   static uint32_t s_rowSize[] = { 8, 8, 16, 16, 516, 16, 8, 8, 16 };
-
 	// Find DCI object
 	shared_ptr<DCObject> dci = dcTarget.getDCObjectById(request->getFieldAsUInt32(VID_DCI_ID), 0);
 	if (dci == nullptr)
@@ -4679,21 +5143,39 @@ bool ClientSession::getCollectedDataFromDB(NXCPMessage *request, NXCPMessage *re
 	uint32_t maxRows = request->getFieldAsUInt32(VID_MAX_ROWS);
 	uint32_t timeFrom = request->getFieldAsUInt32(VID_TIME_FROM);
 	uint32_t timeTo = request->getFieldAsUInt32(VID_TIME_TO);
+	bool chunked = request->getFieldAsBoolean(VID_ENABLE_CHUNKED_DATA);
 
 	if ((maxRows == 0) || (maxRows > MAX_DCI_DATA_RECORDS))
 		maxRows = MAX_DCI_DATA_RECORDS;
 
-   DCI_DATA_HEADER *pData = nullptr;
-   DCI_DATA_ROW *pCurr;
+   TCHAR dataColumn[MAX_COLUMN_NAME] = _T("");
+   TCHAR instance[256] = _T("");
+   if (dciType == DCO_TYPE_TABLE)
+   {
+      request->getFieldAsString(VID_DATA_COLUMN, dataColumn, MAX_COLUMN_NAME);
+      request->getFieldAsString(VID_INSTANCE, instance, 256);
+   }
+
+   int dataType;
+   switch(dciType)
+   {
+      case DCO_TYPE_ITEM:
+         dataType = static_cast<DCItem*>(dci.get())->getDataType();
+         break;
+      case DCO_TYPE_TABLE:
+         dataType = static_cast<DCTable*>(dci.get())->getColumnDataType(dataColumn);
+         break;
+      default:
+         dataType = DCI_DT_STRING;
+         break;
+   }
 
 	// If only last value requested, try to get it from cache first
 	if ((maxRows == 1) && (timeTo == 0) && (historicalDataType == DCO_TYPE_PROCESSED))
 	{
 	   debugPrintf(7, _T("getCollectedDataFromDB: maxRows set to 1, will try to read cached value"));
 
-      TCHAR dataColumn[MAX_COLUMN_NAME] = _T("");
       ItemValue value;
-
 	   if (dciType == DCO_TYPE_ITEM)
 	   {
 	      ItemValue *v = static_cast<DCItem&>(*dci).getInternalLastValue();
@@ -4704,7 +5186,6 @@ bool ClientSession::getCollectedDataFromDB(NXCPMessage *request, NXCPMessage *re
 	   }
 	   else
 	   {
-         request->getFieldAsString(VID_DATA_COLUMN, dataColumn, MAX_COLUMN_NAME);
          shared_ptr<Table> t = static_cast<DCTable&>(*dci).getLastValue();
          if (t == nullptr)
             goto read_from_db;
@@ -4713,11 +5194,8 @@ bool ClientSession::getCollectedDataFromDB(NXCPMessage *request, NXCPMessage *re
          if (column == -1)
             goto read_from_db;
 
-         TCHAR instance[256];
-         request->getFieldAsString(VID_INSTANCE, instance, 256);
          int row = t->findRowByInstance(instance);
-
-         switch(static_cast<DCTable*>(dci.get())->getColumnDataType(dataColumn))
+         switch(dataType)
          {
             case DCI_DT_INT:
                value = (row != -1) ? t->getAsInt(row, column) : (int32_t)0;
@@ -4748,300 +5226,216 @@ bool ClientSession::getCollectedDataFromDB(NXCPMessage *request, NXCPMessage *re
          static_cast<DCItem*>(dci.get())->fillMessageWithThresholds(response, false);
       sendMessage(response);
 
-      int dataType;
-      switch(dciType)
-      {
-         case DCO_TYPE_ITEM:
-            dataType = static_cast<DCItem*>(dci.get())->getDataType();
-            break;
-         case DCO_TYPE_TABLE:
-            dataType = static_cast<DCTable*>(dci.get())->getColumnDataType(dataColumn);
-            break;
-         default:
-            dataType = DCI_DT_STRING;
-            break;
-      }
-
-      // Allocate memory for data and prepare data header
-      pData = (DCI_DATA_HEADER *)MemAlloc(s_rowSize[dataType] + sizeof(DCI_DATA_HEADER));
-      pData->dataType = htonl((UINT32)dataType);
-      pData->dciId = htonl(dci->getId());
-
-      // Fill memory block with records
-      pCurr = (DCI_DATA_ROW *)(((char *)pData) + sizeof(DCI_DATA_HEADER));
-      pCurr->timeStamp = static_cast<uint32_t>(dci->getLastPollTime());
+      DCIDataWriter writer(this, request->getId(), dci->getId(), dataType, chunked);
+      DCI_DATA_ROW *row = writer.allocateRows(1);
+      row->timeStamp = htonl(static_cast<uint32_t>(dci->getLastPollTime()));
       switch(dataType)
       {
          case DCI_DT_INT:
          case DCI_DT_UINT:
          case DCI_DT_COUNTER32:
-            pCurr->value.int32 = htonl(value.getUInt32());
+            row->value.int32 = htonl(value.getUInt32());
             break;
          case DCI_DT_INT64:
          case DCI_DT_UINT64:
          case DCI_DT_COUNTER64:
-            pCurr->value.ext.v64.int64 = htonq(value.getUInt64());
+            row->value.ext.v64.int64 = htonq(value.getUInt64());
             break;
          case DCI_DT_FLOAT:
-            pCurr->value.ext.v64.real = htond(value.getDouble());
+            row->value.ext.v64.real = htond(value.getDouble());
             break;
          case DCI_DT_STRING:
 #ifdef UNICODE
 #ifdef UNICODE_UCS4
-            ucs4_to_ucs2(value.getString(), -1, pCurr->value.string, MAX_DCI_STRING_VALUE);
+            ucs4_to_ucs2(value.getString(), -1, row->value.string, MAX_DCI_STRING_VALUE);
 #else
-            wcslcpy(pCurr->value.string, value.getString(), MAX_DCI_STRING_VALUE);
+            wcslcpy(row->value.string, value.getString(), MAX_DCI_STRING_VALUE);
 #endif
 #else
-            mb_to_ucs2(value.getString(), -1, pCurr->value.string, MAX_DCI_STRING_VALUE);
+            mb_to_ucs2(value.getString(), -1, row->value.string, MAX_DCI_STRING_VALUE);
 #endif
-            SwapUCS2String(pCurr->value.string);
+            SwapUCS2String(row->value.string);
             break;
       }
-      pData->numRows = 1;
-
-      // Prepare and send raw message with fetched data
-      NXCP_MESSAGE *msg =
-         CreateRawNXCPMessage(CMD_DCI_DATA, request->getId(), 0,
-                              pData, s_rowSize[dataType] + sizeof(DCI_DATA_HEADER),
-                              nullptr, isCompressionEnabled());
-      MemFree(pData);
-      sendRawMessage(msg);
-      MemFree(msg);
-
+      writer.finish();
       return true;
 	}
 
 read_from_db:
-   debugPrintf(7, _T("getCollectedDataFromDB: will read from database (maxRows = %d)"), maxRows);
+   // Downsampling is only possible for numeric processed values within known time range
+   DownsamplingMethod downsamplingMethod = static_cast<DownsamplingMethod>(request->getFieldAsInt16(VID_DOWNSAMPLING_METHOD));
+   uint32_t targetPointCount = std::min(request->getFieldAsUInt32(VID_TARGET_POINT_COUNT), maxRows);
+   if (downsamplingMethod != DCI_DOWNSAMPLING_NONE)
+   {
+      if (timeTo == 0)
+         timeTo = static_cast<uint32_t>(time(nullptr));
+      if ((downsamplingMethod > DCI_DOWNSAMPLING_LTTB) || (targetPointCount < 3) || (timeFrom == 0) || (timeTo <= timeFrom) ||
+          (historicalDataType != DCO_TYPE_PROCESSED) || (dataType == DCI_DT_STRING))
+      {
+         debugPrintf(6, _T("getCollectedDataFromDB: downsampling method %d with %u points cannot be applied to this request"), downsamplingMethod, targetPointCount);
+         downsamplingMethod = DCI_DOWNSAMPLING_NONE;
+      }
+   }
+
+   uint32_t bucketSize = 0;
+   if (downsamplingMethod != DCI_DOWNSAMPLING_NONE)
+   {
+      bucketSize = std::max((timeTo - timeFrom) / ((downsamplingMethod == DCI_DOWNSAMPLING_LTTB) ? targetPointCount - 2 : targetPointCount), 1U);
+      debugPrintf(7, _T("getCollectedDataFromDB: will read from database (downsampling method %d, bucket size %u seconds)"), downsamplingMethod, bucketSize);
+   }
+   else
+   {
+      debugPrintf(7, _T("getCollectedDataFromDB: will read from database (maxRows = %d)"), maxRows);
+   }
 
-	TCHAR condition[256] = _T("");
+   // Use rollup data for part of requested range if bucket is not smaller than rollup period;
+   // only data after rollup watermark will be read from raw data table
+   RollupResolution rollupResolution = RollupResolution::HOURLY;
+   bool useRollup = (dciType == DCO_TYPE_ITEM) && (downsamplingMethod != DCI_DOWNSAMPLING_NONE) &&
+            SelectDCIRollupResolution(bucketSize, timeFrom, &rollupResolution);
+   uint32_t rawTimeFrom = timeFrom;
+   if (useRollup)
+   {
+      rawTimeFrom = std::max(timeFrom, static_cast<uint32_t>(GetDCIRollupWatermark(rollupResolution)));
+      debugPrintf(7, _T("getCollectedDataFromDB: using %s for range %u - %u"), GetDCIRollupTable(rollupResolution), timeFrom, rawTimeFrom);
+   }
+
+   // All values are integers, so they are inlined into query which is then passed to driver as UTF-8 string
+   const char *timestampColumn = (dciType == DCO_TYPE_TABLE) ? "tdata_timestamp" : "idata_timestamp";
+	char condition[256] = "";
 	if ((g_dbSyntax == DB_SYNTAX_TSDB) && (g_flags & AF_SINGLE_TABLE_PERF_DATA))
 	{
       if (timeFrom != 0)
-         _tcscpy(condition, (dciType == DCO_TYPE_TABLE) ? _T(" AND tdata_timestamp>=to_timestamp(?)") : _T(" AND idata_timestamp>=to_timestamp(?)"));
+         snprintf(condition, 256, " AND %s>=to_timestamp(%u)", timestampColumn, rawTimeFrom);
       if (timeTo != 0)
-         _tcscat(condition, (dciType == DCO_TYPE_TABLE) ? _T(" AND tdata_timestamp<=to_timestamp(?)") : _T(" AND idata_timestamp<=to_timestamp(?)"));
+         snprintf(&condition[strlen(condition)], 128, " AND %s<=to_timestamp(%u)", timestampColumn, timeTo);
 	}
 	else
 	{
       if (timeFrom != 0)
-         _tcscpy(condition, (dciType == DCO_TYPE_TABLE) ? _T(" AND tdata_timestamp>=?") : _T(" AND idata_timestamp>=?"));
+         snprintf(condition, 256, " AND %s>=%u", timestampColumn, rawTimeFrom);
       if (timeTo != 0)
-         _tcscat(condition, (dciType == DCO_TYPE_TABLE) ? _T(" AND tdata_timestamp<=?") : _T(" AND idata_timestamp<=?"));
+         snprintf(&condition[strlen(condition)], 128, " AND %s<=%u", timestampColumn, timeTo);
 	}
 
 	bool success = false;
 	DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
-	DB_STATEMENT hStmt = PrepareDataSelect(hdb, dcTarget.getId(), dciType, dci->getStorageClass(), maxRows, historicalDataType, condition);
-	if (hStmt != nullptr)
-	{
-		TCHAR dataColumn[MAX_COLUMN_NAME] = _T("");
-      TCHAR instance[256];
-
-		int pos = 1;
-		DBBind(hStmt, pos++, DB_SQLTYPE_INTEGER, dci->getId());
-		if (dciType == DCO_TYPE_TABLE)
-		{
-			request->getFieldAsString(VID_DATA_COLUMN, dataColumn, MAX_COLUMN_NAME);
-         request->getFieldAsString(VID_INSTANCE, instance, 256);
-		}
-		if (timeFrom != 0)
-			DBBind(hStmt, pos++, DB_SQLTYPE_INTEGER, timeFrom);
-		if (timeTo != 0)
-			DBBind(hStmt, pos++, DB_SQLTYPE_INTEGER, timeTo);
 
-		DB_UNBUFFERED_RESULT hResult = DBSelectPreparedUnbuffered(hStmt);
+	// Bucket aggregation for simple DCIs is done by database if possible, LTTB and aggregation
+	// of table DCI values is done while streaming rows from database
+	char query[1024];
+	bool aggregatedByDatabase = false;
+	if ((dciType == DCO_TYPE_ITEM) && (downsamplingMethod != DCI_DOWNSAMPLING_NONE) && (downsamplingMethod != DCI_DOWNSAMPLING_LTTB) && !useRollup)
+	{
+	   aggregatedByDatabase = BuildAggregatedDataSelectQuery(query, 1024, dcTarget.getId(), dci->getId(), dci->getStorageClass(),
+	            downsamplingMethod, rawTimeFrom, timeTo, bucketSize);
+	}
+	if (aggregatedByDatabase || BuildDataSelectQuery(query, 1024, dcTarget.getId(), dci->getId(), dciType, dci->getStorageClass(),
+	            (downsamplingMethod != DCI_DOWNSAMPLING_NONE) ? 0x7FFFFFFF : maxRows, historicalDataType, condition))
+	{
+		DB_UNBUFFERED_RESULT hResult = DBSelectUnbufferedUTF8(hdb, query);
 		if (hResult != nullptr)
 		{
-#if !defined(UNICODE) || defined(UNICODE_UCS4)
-			TCHAR szBuffer[MAX_DCI_STRING_VALUE];
-#endif
-
 			// Send CMD_REQUEST_COMPLETED message
 			response->setField(VID_RCC, RCC_SUCCESS);
 			if (dciType == DCO_TYPE_ITEM)
 			   static_cast<DCItem*>(dci.get())->fillMessageWithThresholds(response, false);
 			sendMessage(response);
 
-			int dataType;
-			switch(dciType)
+			// Averages are always sent as floating point values
+			DCIDataWriter writer(this, request->getId(), dci->getId(),
+			         (downsamplingMethod == DCI_DOWNSAMPLING_AVG) ? DCI_DT_FLOAT : dataType, chunked);
+			if (aggregatedByDatabase)
 			{
-				case DCO_TYPE_ITEM:
-					dataType = static_cast<DCItem*>(dci.get())->getDataType();
-					break;
-				case DCO_TYPE_TABLE:
-					dataType = static_cast<DCTable*>(dci.get())->getColumnDataType(dataColumn);
-					break;
-				default:
-					dataType = DCI_DT_STRING;
-					break;
+	         while(DBFetch(hResult))
+	         {
+	            DCI_DATA_ROW *row = writer.allocateRows(1);
+	            row->timeStamp = htonl(DBGetFieldULong(hResult, 0));
+	            writer.setValue(row, DBGetFieldDouble(hResult, 1));
+	         }
 			}
-
-			// Allocate memory for data and prepare data header
-			int allocated = 8192;
-			int rows = 0;
-			pData = (DCI_DATA_HEADER *)MemAlloc(allocated * s_rowSize[dataType] + sizeof(DCI_DATA_HEADER));
-			pData->dataType = htonl((UINT32)dataType);
-			pData->dciId = htonl(dci->getId());
-
-			// Fill memory block with records
-			pCurr = (DCI_DATA_ROW *)(((char *)pData) + sizeof(DCI_DATA_HEADER));
-			while(DBFetch(hResult))
+			else if (downsamplingMethod != DCI_DOWNSAMPLING_NONE)
 			{
-			   if (rows == allocated)
-			   {
-			      allocated += 8192;
-		         pData = MemRealloc(pData, allocated * s_rowSize[dataType] + sizeof(DCI_DATA_HEADER));
-		         pCurr = (DCI_DATA_ROW *)(((char *)pData + s_rowSize[dataType] * rows) + sizeof(DCI_DATA_HEADER));
-			   }
-            rows++;
-
-				pCurr->timeStamp = htonl(DBGetFieldULong(hResult, 0));
-				if (dciType == DCO_TYPE_ITEM)
-				{
-               switch(dataType)
+			   DCIDataWriterDownsampler downsampler(&writer, downsamplingMethod, timeFrom, bucketSize);
+            while(DBFetch(hResult))
+            {
+               time_t timestamp = DBGetFieldULong(hResult, 0);
+               if (dciType == DCO_TYPE_ITEM)
                {
-                  case DCI_DT_INT:
-                  case DCI_DT_UINT:
-                  case DCI_DT_COUNTER32:
-                     pCurr->value.int32 = htonl(DBGetFieldULong(hResult, 1));
-                     break;
-                  case DCI_DT_INT64:
-                  case DCI_DT_UINT64:
-                  case DCI_DT_COUNTER64:
-                     pCurr->value.ext.v64.int64 = htonq(DBGetFieldUInt64(hResult, 1));
-                     break;
-                  case DCI_DT_FLOAT:
-                     pCurr->value.ext.v64.real = htond(DBGetFieldDouble(hResult, 1));
-                     break;
-                  case DCI_DT_STRING:
-#ifdef UNICODE
-#ifdef UNICODE_UCS4
-                     DBGetField(hResult, 1, szBuffer, MAX_DCI_STRING_VALUE);
-                     ucs4_to_ucs2(szBuffer, -1, pCurr->value.string, MAX_DCI_STRING_VALUE);
-#else
-                     DBGetField(hResult, 1, pCurr->value.string, MAX_DCI_STRING_VALUE);
-#endif
-#else
-                     DBGetField(hResult, 1, szBuffer, MAX_DCI_STRING_VALUE);
-                     mb_to_ucs2(szBuffer, -1, pCurr->value.string, MAX_DCI_STRING_VALUE);
-#endif
-                     SwapUCS2String(pCurr->value.string);
-                     break;
+                  // Non-numeric values are skipped, same as in aggregation done by database
+                  TCHAR value[MAX_DCI_STRING_VALUE];
+                  DBGetField(hResult, 1, value, MAX_DCI_STRING_VALUE);
+                  if (IsNumericDCIValue(value))
+                     downsampler.add(timestamp, _tcstod(value, nullptr));
+                  continue;
                }
 
-               if (historicalDataType == DCO_TYPE_BOTH)
+               char *encodedTable = DBGetFieldUTF8(hResult, 1, nullptr, 0);
+               if (encodedTable != nullptr)
                {
-                  pCurr = (DCI_DATA_ROW *)(((char *)pCurr) + s_rowSize[dataType]);
-                  if (rows == allocated)
+                  Table *table = Table::createFromPackedData(encodedTable);
+                  if (table != nullptr)
                   {
-                     allocated += 8192;
-                     pData = (DCI_DATA_HEADER *)realloc(pData, allocated * s_rowSize[dataType] + sizeof(DCI_DATA_HEADER));
-                     pCurr = (DCI_DATA_ROW *)(((char *)pData + s_rowSize[dataType] * rows) + sizeof(DCI_DATA_HEADER));
+                     int row = table->findRowByInstance(instance);
+                     int col = table->getColumnIndex(dataColumn);
+                     if ((row != -1) && (col != -1))
+                        downsampler.add(timestamp, table->getAsDouble(row, col));
+                     delete table;
                   }
-                  rows++;
-
-                  pCurr->timeStamp = 0;   // raw value indicator
-                  switch(dataType)
+                  MemFree(encodedTable);
+               }
+            }
+            if (useRollup)
+            {
+               // Raw data result should be closed before reading rollup data over same connection
+               DBFreeResult(hResult);
+               hResult = nullptr;
+               ReadRollupData(hdb, &downsampler, downsamplingMethod, rollupResolution, dci->getId(), timeFrom, rawTimeFrom);
+            }
+            downsampler.finish();
+			}
+			else
+			{
+            while(DBFetch(hResult))
+            {
+               DCI_DATA_ROW *row = writer.allocateRows((historicalDataType == DCO_TYPE_BOTH) ? 2 : 1);
+               row->timeStamp = htonl(DBGetFieldULong(hResult, 0));
+               if (dciType == DCO_TYPE_ITEM)
+               {
+                  SetDataRowValue(row, dataType, hResult, 1);
+                  if (historicalDataType == DCO_TYPE_BOTH)
                   {
-                     case DCI_DT_INT:
-                     case DCI_DT_UINT:
-                     case DCI_DT_COUNTER32:
-                        pCurr->value.int32 = htonl(DBGetFieldULong(hResult, 2));
-                        break;
-                     case DCI_DT_INT64:
-                     case DCI_DT_UINT64:
-                     case DCI_DT_COUNTER64:
-                        pCurr->value.ext.v64.int64 = htonq(DBGetFieldUInt64(hResult, 2));
-                        break;
-                     case DCI_DT_FLOAT:
-                        pCurr->value.ext.v64.real = htond(DBGetFieldDouble(hResult, 2));
-                        break;
-                     case DCI_DT_STRING:
-   #ifdef UNICODE
-   #ifdef UNICODE_UCS4
-                        DBGetField(hResult, 2, szBuffer, MAX_DCI_STRING_VALUE);
-                        ucs4_to_ucs2(szBuffer, -1, pCurr->value.string, MAX_DCI_STRING_VALUE);
-   #else
-                        DBGetField(hResult, 2, pCurr->value.string, MAX_DCI_STRING_VALUE);
-   #endif
-   #else
-                        DBGetField(hResult, 2, szBuffer, MAX_DCI_STRING_VALUE);
-                        mb_to_ucs2(szBuffer, -1, pCurr->value.string, MAX_DCI_STRING_VALUE);
-   #endif
-                        SwapUCS2String(pCurr->value.string);
-                        break;
+                     row = reinterpret_cast<DCI_DATA_ROW*>(reinterpret_cast<char*>(row) + s_dciDataRowSize[dataType]);
+                     row->timeStamp = 0;   // raw value indicator
+                     SetDataRowValue(row, dataType, hResult, 2);
                   }
                }
-				}
-				else
-				{
-				   char *encodedTable = DBGetFieldUTF8(hResult, 1, nullptr, 0);
-				   if (encodedTable != nullptr)
-				   {
-				      Table *table = Table::createFromPackedXML(encodedTable);
-				      if (table != nullptr)
-				      {
-				         int row = table->findRowByInstance(instance);
-				         int col = table->getColumnIndex(dataColumn);
-		               switch(dataType)
-		               {
-		                  case DCI_DT_INT:
-                           pCurr->value.int32 = htonl((UINT32)table->getAsInt(row, col));
-                           break;
-		                  case DCI_DT_UINT:
-		                  case DCI_DT_COUNTER32:
-		                     pCurr->value.int32 = htonl(table->getAsUInt(row, col));
-		                     break;
-		                  case DCI_DT_INT64:
-                           pCurr->value.ext.v64.int64 = htonq((UINT64)table->getAsInt64(row, col));
-                           break;
-		                  case DCI_DT_UINT64:
-		                  case DCI_DT_COUNTER64:
-		                     pCurr->value.ext.v64.int64 = htonq(table->getAsUInt64(row, col));
-		                     break;
-		                  case DCI_DT_FLOAT:
-		                     pCurr->value.ext.v64.real = htond(table->getAsDouble(row, col));
-		                     break;
-		                  case DCI_DT_STRING:
-#ifdef UNICODE
-#ifdef UNICODE_UCS4
-		                     ucs4_to_ucs2(CHECK_NULL_EX(table->getAsString(row, col)), -1, pCurr->value.string, MAX_DCI_STRING_VALUE);
-#else
-		                     wcslcpy(pCurr->value.string, CHECK_NULL_EX(table->getAsString(row, col)), MAX_DCI_STRING_VALUE);
-#endif
-#else
-		                     mb_to_ucs2(CHECK_NULL_EX(table->getAsString(row, col)), -1, pCurr->value.string, MAX_DCI_STRING_VALUE);
-#endif
-		                     SwapUCS2String(pCurr->value.string);
-		                     break;
-		               }
-				         delete table;
-				      }
-				      MemFree(encodedTable);
-				   }
-				}
-				pCurr = (DCI_DATA_ROW *)(((char *)pCurr) + s_rowSize[dataType]);
+               else
+               {
+                  memset(&row->value, 0, s_dciDataRowSize[dataType] - sizeof(uint32_t));
+                  char *encodedTable = DBGetFieldUTF8(hResult, 1, nullptr, 0);
+                  if (encodedTable != nullptr)
+                  {
+                     Table *table = Table::createFromPackedData(encodedTable);
+                     if (table != nullptr)
+                     {
+                        SetDataRowValue(row, dataType, table, table->findRowByInstance(instance), table->getColumnIndex(dataColumn));
+                        delete table;
+                     }
+                     MemFree(encodedTable);
+                  }
+               }
+            }
 			}
-			DBFreeResult(hResult);
-			pData->numRows = htonl(rows);
-
-			// Prepare and send raw message with fetched data
-			NXCP_MESSAGE *msg =
-				CreateRawNXCPMessage(CMD_DCI_DATA, request->getId(), 0,
-											pData, rows * s_rowSize[dataType] + sizeof(DCI_DATA_HEADER),
-											nullptr, isCompressionEnabled());
-			MemFree(pData);
-			sendRawMessage(msg);
-			MemFree(msg);
+			if (hResult != nullptr)
+			   DBFreeResult(hResult);
+			writer.finish();
 			success = true;
 		}
 		else
 		{
 			response->setField(VID_RCC, RCC_DB_FAILURE);
 		}
-		DBFreeStatement(hStmt);
 	}
 	else
 	{
@@ -5271,6 +5665,115 @@ void ClientSession::getLastValuesByDciId(NXCPMessage *pRequest)
    sendMessage(&msg);
 }
 
+/**
+ * Subscribe to incremental last values updates for given object. Response contains current values
+ * of all matching DCIs (same format as for CMD_GET_LAST_VALUES). After that only DCIs with changed
+ * value or status are sent to client in CMD_LAST_VALUES_UPDATE messages.
+ */
+void ClientSession::subscribeLastValues(NXCPMessage *request)
+{
+   NXCPMessage msg(CMD_REQUEST_COMPLETED, request->getId());
+
+   uint32_t objectId = request->getFieldAsUInt32(VID_OBJECT_ID);
+   shared_ptr<NetObj> object = FindObjectById(objectId);
+   if (object != nullptr)
+   {
+      if (object->checkAccessRights(m_dwUserId, OBJECT_ACCESS_READ))
+      {
+         if (object->isDataCollectionTarget())
+         {
+            IntegerArray<uint32_t> dciList;
+            request->getFieldAsInt32Array(VID_ITEM_LIST, &dciList);
+            HashSet<uint32_t> dciFilter;
+            for(int i = 0; i < dciList.size(); i++)
+               dciFilter.put(dciList.get(i));
+
+            LastValuesSubscription *subscription = new LastValuesSubscription();
+            subscription->objectTooltipOnly = request->getFieldAsBoolean(VID_OBJECT_TOOLTIP_ONLY);
+            subscription->overviewOnly = request->getFieldAsBoolean(VID_OVERVIEW_ONLY);
+            subscription->includeNoValueObjects = request->getFieldAsBoolean(VID_INCLUDE_NOVALUE_OBJECTS);
+            for(int i = 0; i < dciList.size(); i++)
+               subscription->dciFilter.put(dciList.get(i));
+
+            // Subscription is registered before reading current values, so changes made in between
+            // will not be lost (they will be sent again with next update)
+            MutexLock(m_lastValuesLock);
+            m_lastValuesSubscriptions.set(objectId, subscription);
+            MutexUnlock(m_lastValuesLock);
+            RegisterLastValuesSubscription(objectId, m_id);
+
+            msg.setField(VID_RCC,
+               static_cast<DataCollectionTarget&>(*object).getLastValues(&msg,
+                  request->getFieldAsBoolean(VID_OBJECT_TOOLTIP_ONLY),
+                  request->getFieldAsBoolean(VID_OVERVIEW_ONLY),
+                  request->getFieldAsBoolean(VID_INCLUDE_NOVALUE_OBJECTS),
+                  m_dwUserId, dciList.isEmpty() ? nullptr : &dciFilter));
+            debugPrintf(5, _T("Subscribed to last values updates for object %s [%u] (%d DCIs in filter)"), object->getName(), objectId, dciList.size());
+         }
+         else
+         {
+            msg.setField(VID_RCC, RCC_INCOMPATIBLE_OPERATION);
+         }
+      }
+      else
+      {
+         msg.setField(VID_RCC, RCC_ACCESS_DENIED);
+      }
+   }
+   else  // No object with given ID
+   {
+      msg.setField(VID_RCC, RCC_INVALID_OBJECT_ID);
+   }
+
+   sendMessage(&msg);
+}
+
+/**
+ * Cancel last values updates subscription (all subscriptions will be cancelled if object ID is 0)
+ */
+void ClientSession::unsubscribeLastValues(NXCPMessage *request)
+{
+   NXCPMessage msg(CMD_REQUEST_COMPLETED, request->getId());
+   cancelLastValuesSubscription(request->getFieldAsUInt32(VID_OBJECT_ID));
+   msg.setField(VID_RCC, RCC_SUCCESS);
+   sendMessage(&msg);
+}
+
+/**
+ * Collect IDs of objects with last values subscription
+ */
+static EnumerationCallbackResult CollectLastValuesSubscriptions(const uint32_t& objectId, LastValuesSubscription *subscription, IntegerArray<uint32_t> *objects)
+{
+   objects->add(objectId);
+   return _CONTINUE;
+}
+
+/**
+ * Cancel last values updates subscription for given object (or all subscriptions if object ID is 0)
+ */
+void ClientSession::cancelLastValuesSubscription(uint32_t objectId)
+{
+   IntegerArray<uint32_t> objects;
+
+   MutexLock(m_lastValuesLock);
+   if (objectId == 0)
+   {
+      m_lastValuesSubscriptions.forEach(CollectLastValuesSubscriptions, &objects);
+      m_lastValuesSubscriptions.clear();
+   }
+   else if (m_lastValuesSubscriptions.contains(objectId))
+   {
+      m_lastValuesSubscriptions.remove(objectId);
+      objects.add(objectId);
+   }
+   MutexUnlock(m_lastValuesLock);
+
+   // Global subscription list should not be updated while session lock is held
+   // because change notification handler locks them in reverse order
+   for(int i = 0; i < objects.size(); i++)
+      UnregisterLastValuesSubscription(objects.get(i), m_id);
+}
+
 /**
  * Send tooltip visible latest collected values for all nodes
  * Error message will never be returned. Will be returned only
@@ -11303,6 +11806,107 @@ void ClientSession::executeLibraryScript(NXCPMessage *request)
    delete args;
 }
 
+/**
+ * Execute library script with profiling enabled and send collected profile to client.
+ * Script is executed synchronously, optionally in context of given object.
+ */
+void ClientSession::profileLibraryScript(NXCPMessage *request)
+{
+   NXCPMessage msg(CMD_REQUEST_COMPLETED, request->getId());
+
+   if (!(m_systemAccessRights & SYSTEM_ACCESS_MANAGE_SCRIPTS))
+   {
+      writeAuditLog(AUDIT_SYSCFG, false, 0, _T("Access denied on profiling library script"));
+      msg.setField(VID_RCC, RCC_ACCESS_DENIED);
+      sendMessage(&msg);
+      return;
+   }
+
+   shared_ptr<NetObj> object;
+   uint32_t objectId = request->getFieldAsUInt32(VID_OBJECT_ID);
+   if (objectId != 0)
+   {
+      object = FindObjectById(objectId);
+      if (object == nullptr)
+      {
+         msg.setField(VID_RCC, RCC_INVALID_OBJECT_ID);
+         sendMessage(&msg);
+         return;
+      }
+      if (!object->checkAccessRights(m_dwUserId, OBJECT_ACCESS_CONTROL))
+      {
+         writeAuditLog(AUDIT_OBJECTS, false, objectId, _T("Access denied on profiling library script on object %s [%u]"), object->getName(), objectId);
+         msg.setField(VID_RCC, RCC_ACCESS_DENIED);
+         sendMessage(&msg);
+         return;
+      }
+   }
+
+   TCHAR *script = request->getFieldAsString(VID_SCRIPT);
+   StringList *args = (script != nullptr) ? ParseCommandLine(script) : nullptr;
+   if ((args != nullptr) && (args->size() > 0))
+   {
+      NXSL_VM *vm = GetServerScriptLibrary()->createVM(args->get(0), new NXSL_ServerEnv());
+      if (vm != nullptr)
+      {
+         if (object != nullptr)
+            SetupServerScriptVM(vm, object, shared_ptr<DCObjectInfo>());
+         vm->enableProfiling(request->isFieldExist(VID_SAMPLING_INTERVAL) ? request->getFieldAsUInt32(VID_SAMPLING_INTERVAL) : 1);
+
+         ObjectRefArray<NXSL_Value> sargs(args->size() - 1, 1);
+         for(int i = 1; i < args->size(); i++)
+            sargs.add(vm->createValue(args->get(i)));
+
+         if (vm->run(sargs))
+         {
+            msg.setField(VID_EXECUTION_STATUS, true);
+            msg.setField(VID_EXECUTION_RESULT, vm->getResult()->getValueAsCString());
+         }
+         else
+         {
+            msg.setField(VID_EXECUTION_STATUS, false);
+            msg.setField(VID_ERROR_TEXT, vm->getErrorText());
+         }
+         FillScriptProfileMessage(&msg, vm, request->getFieldAsBoolean(VID_PROFILE_BY_INSTRUCTION), 1000);
+         msg.setField(VID_RCC, RCC_SUCCESS);
+         delete vm;
+
+         writeAuditLog(AUDIT_SYSCFG, true, objectId, _T("Library script \"%s\" executed with profiling"), script);
+      }
+      else
+      {
+         msg.setField(VID_RCC, RCC_INVALID_SCRIPT_NAME);
+      }
+   }
+   else
+   {
+      msg.setField(VID_RCC, RCC_INVALID_ARGUMENT);
+   }
+
+   sendMessage(&msg);
+   MemFree(script);
+   delete args;
+}
+
+/**
+ * Get built-in profiler statistics for server hot paths
+ */
+void ClientSession::getPerfStats(NXCPMessage *request)
+{
+   NXCPMessage msg(CMD_REQUEST_COMPLETED, request->getId());
+   if (m_systemAccessRights & SYSTEM_ACCESS_SERVER_CONSOLE)
+   {
+      FillPerfStatsMessage(&msg);
+      msg.setField(VID_RCC, RCC_SUCCESS);
+   }
+   else
+   {
+      writeAuditLog(AUDIT_SYSCFG, false, 0, _T("Access denied on reading profiler statistics"));
+      msg.setField(VID_RCC, RCC_ACCESS_DENIED);
+   }
+   sendMessage(&msg);
+}
+
 /**
  * Send list of server jobs
  */
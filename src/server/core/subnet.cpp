@@ -202,19 +202,27 @@ void Subnet::setCorrectMask(const InetAddress& addr)
       _sntprintf(m_name, MAX_OBJECT_NAME, _T("%s/%d"), addr.toString(szBuffer), addr.getMaskBits());
 	}
 
-	bool reAdd = !m_ipAddress.equals(addr);
-   if (reAdd)
-   {
-      g_idxSubnetByAddr.remove(m_ipAddress);
-   }
-
+	InetAddress oldAddr = m_ipAddress;
 	m_ipAddress = addr;
 	m_flags &= ~SF_SYNTETIC_MASK;
 
-	if (reAdd)
-   {
-      g_idxSubnetByAddr.put(m_ipAddress, self());
-   }
+	// Address indexes should be updated on mask change as well because prefix index depends on it
+	if (!oldAddr.equals(addr) || (oldAddr.getMaskBits() != addr.getMaskBits()))
+	{
+	   if (IsZoningEnabled())
+	   {
+	      shared_ptr<Zone> zone = FindZoneByUIN(m_zoneUIN);
+	      if (zone != nullptr)
+	         zone->updateSubnetIndex(oldAddr, addr, self());
+	   }
+	   else
+	   {
+	      g_idxSubnetByAddr.remove(oldAddr);
+	      g_idxSubnetByAddr.put(addr, self());
+	      g_idxSubnetByPrefix.remove(oldAddr, m_id);
+	      g_idxSubnetByPrefix.put(addr, self());
+	   }
+	}
 	setModified(MODIFY_OTHER);
 	unlockProperties();
 }
@@ -372,24 +380,17 @@ IntegerArray<uint32_t> CheckSubnetOverlap(const InetAddress &addr, int32_t uin)
    {
       auto zone = FindZoneByUIN(uin);
       if (zone != nullptr)
-         subnets = zone->getSubnets();
+         subnets = zone->findOverlappingSubnets(addr);
    }
    else
    {
-      subnets = g_idxSubnetByAddr.getObjects();
+      subnets = g_idxSubnetByPrefix.findOverlapping(addr);
    }
 
    if (subnets != nullptr)
    {
       for (int i = 0; i < subnets->size(); i++)
-      {
-         auto subnet = static_cast<Subnet *>(subnets->get(i));
-         auto subnetAddr = subnet->getIpAddress();
-         if (addr.contain(subnetAddr) || subnetAddr.contain(addr))
-         {
-            overlappingSubnet.add(subnet->getId());
-         }
-      }
+         overlappingSubnet.add(subnets->get(i)->getId());
    }
 
    return overlappingSubnet;
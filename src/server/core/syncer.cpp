@@ -48,6 +48,49 @@ static ManualGauge64 s_syncerRunTime(_T("Syncer"), 5, 900);
 static Mutex s_syncerGaugeLock(true);
 static time_t s_lastRunTime = 0;
 
+/**
+ * Per-class object save statistics
+ */
+struct ObjectSaveStats
+{
+   int objectClass;
+   uint64_t objectCount;
+   uint64_t batchCount;
+   uint64_t totalTime;
+   uint32_t maxBatchTime;
+};
+static StructArray<ObjectSaveStats> s_objectSaveStats(0, 16);
+static Mutex s_objectSaveStatsLock(true);
+
+/**
+ * Update object save statistics for given class
+ */
+static void UpdateObjectSaveStats(int objectClass, int objectCount, uint32_t elapsedTime)
+{
+   s_objectSaveStatsLock.lock();
+   ObjectSaveStats *stats = nullptr;
+   for(int i = 0; i < s_objectSaveStats.size(); i++)
+   {
+      if (s_objectSaveStats.get(i)->objectClass == objectClass)
+      {
+         stats = s_objectSaveStats.get(i);
+         break;
+      }
+   }
+   if (stats == nullptr)
+   {
+      stats = s_objectSaveStats.addPlaceholder();
+      memset(stats, 0, sizeof(ObjectSaveStats));
+      stats->objectClass = objectClass;
+   }
+   stats->objectCount += objectCount;
+   stats->batchCount++;
+   stats->totalTime += elapsedTime;
+   if (elapsedTime > stats->maxBatchTime)
+      stats->maxBatchTime = elapsedTime;
+   s_objectSaveStatsLock.unlock();
+}
+
 /**
  * Get syncer run time
  */
@@ -91,6 +134,22 @@ void ShowSyncerStats(ServerConsole *console)
             s_syncerRunTime.getCurrent(), static_cast<int>(s_syncerRunTime.getAverage()),
             s_syncerRunTime.getMax(), s_syncerRunTime.getMin());
    s_syncerGaugeLock.unlock();
+
+   s_objectSaveStatsLock.lock();
+   if (!s_objectSaveStats.isEmpty())
+   {
+      console->print(_T("Object class         | Objects saved | Batches  | Avg batch time | Max batch time\n"));
+      console->print(_T("---------------------+---------------+----------+----------------+---------------\n"));
+      for(int i = 0; i < s_objectSaveStats.size(); i++)
+      {
+         ObjectSaveStats *stats = s_objectSaveStats.get(i);
+         console->printf(_T("%-20s | %13u | %8u | %11u ms | %11u ms\n"), NetObj::getObjectClassName(stats->objectClass),
+                  static_cast<uint32_t>(stats->objectCount), static_cast<uint32_t>(stats->batchCount),
+                  static_cast<uint32_t>(stats->totalTime / stats->batchCount), stats->maxBatchTime);
+      }
+      console->print(_T("\n"));
+   }
+   s_objectSaveStatsLock.unlock();
 }
 
 /**
@@ -112,27 +171,154 @@ void NXCORE_EXPORTABLE ObjectTransactionEnd()
 }
 
 /**
- * Save object to database on separate thread
+ * Maximum number of objects saved in single transaction
  */
-static void SaveObject(NetObj *object)
+#define OBJECT_SAVE_BATCH_SIZE   64
+
+/**
+ * Objects modified since last sync
+ */
+static HashSet<uint32_t> s_modifiedObjects;
+static Mutex s_modifiedObjectsLock(true);
+
+/**
+ * Register object as modified. Only registered objects are checked by syncer on regular sync runs.
+ */
+void NXCORE_EXPORTABLE RegisterModifiedObject(uint32_t objectId)
 {
-   DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
-   DBBegin(hdb);
-   if (object->saveToDatabase(hdb))
+   s_modifiedObjectsLock.lock();
+   s_modifiedObjects.put(objectId);
+   s_modifiedObjectsLock.unlock();
+}
+
+/**
+ * Callback for copying modified object IDs
+ */
+static EnumerationCallbackResult CopyModifiedObjectId(const uint32_t *id, void *list)
+{
+   static_cast<IntegerArray<uint32_t>*>(list)->add(*id);
+   return _CONTINUE;
+}
+
+/**
+ * Compare objects for saving (groups objects by class)
+ */
+static int CompareObjectsForSave(const NetObj& o1, const NetObj& o2)
+{
+   int c1 = o1.getObjectClass();
+   int c2 = o2.getObjectClass();
+   if (c1 != c2)
+      return (c1 < c2) ? -1 : 1;
+   return (o1.getId() < o2.getId()) ? -1 : ((o1.getId() > o2.getId()) ? 1 : 0);
+}
+
+/**
+ * Batch of objects of same class
+ */
+struct ObjectSaveBatch
+{
+   NetObj *objects[OBJECT_SAVE_BATCH_SIZE];
+   int count;
+};
+
+/**
+ * Save batch of objects of same class. All objects are saved in single transaction; if it fails,
+ * objects are saved one by one so that single failing object will not prevent others from being saved.
+ */
+static void SaveObjectBatch(DB_HANDLE hdb, ObjectSaveBatch *batch)
+{
+   int64_t startTime = GetCurrentTimeMs();
+
+   bool success = DBBegin(hdb);
+   for(int i = 0; (i < batch->count) && success; i++)
+      success = batch->objects[i]->saveToDatabase(hdb);
+   if (success)
    {
       DBCommit(hdb);
-      object->markAsSaved();
+      for(int i = 0; i < batch->count; i++)
+         batch->objects[i]->markAsSaved();
    }
    else
    {
       DBRollback(hdb);
+      nxlog_debug_tag(DEBUG_TAG_OBJECT_SYNC, 5, _T("Batch save failed for %d objects of class %s, saving objects one by one"),
+               batch->count, batch->objects[0]->getObjectClassName());
+      for(int i = 0; i < batch->count; i++)
+      {
+         NetObj *object = batch->objects[i];
+         DBBegin(hdb);
+         if (object->saveToDatabase(hdb))
+         {
+            DBCommit(hdb);
+            object->markAsSaved();
+         }
+         else
+         {
+            DBRollback(hdb);
+            RegisterModifiedObject(object->getId());  // Retry on next sync
+         }
+      }
    }
+
+   UpdateObjectSaveStats(batch->objects[0]->getObjectClass(), batch->count, static_cast<uint32_t>(GetCurrentTimeMs() - startTime));
+}
+
+/**
+ * Save batch of objects to database on separate thread
+ */
+static void SaveObjectBatchOnThread(ObjectSaveBatch *batch)
+{
+   DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+   SaveObjectBatch(hdb, batch);
    DBConnectionPoolReleaseConnection(hdb);
+   delete batch;
    InterlockedDecrement(&s_outstandingSaveRequests);
 }
 
 /**
- * Save objects to database
+ * Save collected batch either directly or via syncer thread pool
+ */
+static void FlushObjectSaveBatch(DB_HANDLE hdb, ObjectSaveBatch *batch)
+{
+   if (g_syncerThreadPool != nullptr)
+   {
+      InterlockedIncrement(&s_outstandingSaveRequests);
+      ThreadPoolExecute(g_syncerThreadPool, SaveObjectBatchOnThread, batch);
+   }
+   else
+   {
+      SaveObjectBatch(hdb, batch);
+      delete batch;
+   }
+}
+
+/**
+ * Delete object from database
+ */
+static void DeleteObjectFromDatabase(DB_HANDLE hdb, NetObj *object)
+{
+   nxlog_debug_tag(DEBUG_TAG_OBJECT_SYNC, 5, _T("Object %s [%d] marked for deletion"), object->getName(), object->getId());
+   DBBegin(hdb);
+   if (object->deleteFromDatabase(hdb))
+   {
+      nxlog_debug_tag(DEBUG_TAG_OBJECT_SYNC, 4, _T("Object %d \"%s\" deleted from database"), object->getId(), object->getName());
+      DBCommit(hdb);
+
+      // Remove object from global object index by ID
+      g_idxObjectById.remove(object->getId());
+      UpdateObjectMemoryUsage(*object, false);
+   }
+   else
+   {
+      DBRollback(hdb);
+      RegisterModifiedObject(object->getId());  // Retry on next sync
+      nxlog_debug_tag(DEBUG_TAG_OBJECT_SYNC, 4, _T("Call to deleteFromDatabase() failed for object %s [%d], transaction rollback"), object->getName(), object->getId());
+   }
+}
+
+/**
+ * Save objects to database. On regular sync runs only objects registered as modified are processed.
+ * If runtime data should be saved, all objects are processed.
  */
 void SaveObjects(DB_HANDLE hdb, UINT32 watchdogId, bool saveRuntimeData)
 {
@@ -141,62 +327,76 @@ void SaveObjects(DB_HANDLE hdb, UINT32 watchdogId, bool saveRuntimeData)
    if (g_flags & AF_ENABLE_OBJECT_TRANSACTIONS)
       RWLockWriteLock(s_objectTxnLock);
 
-	unique_ptr<SharedObjectArray<NetObj>> objects = g_idxObjectById.getObjects();
-   nxlog_debug_tag(DEBUG_TAG_SYNC, 5, _T("%d objects to process"), objects->size());
-	for(int i = 0; i < objects->size(); i++)
+   IntegerArray<uint32_t> modifiedObjectIds(1024, 1024);
+   s_modifiedObjectsLock.lock();
+   s_modifiedObjects.forEach(CopyModifiedObjectId, &modifiedObjectIds);
+   s_modifiedObjects.clear();
+   s_modifiedObjectsLock.unlock();
+
+   SharedObjectArray<NetObj> objects(modifiedObjectIds.size(), 1024);
+   if (saveRuntimeData)
    {
-	   WatchdogNotify(watchdogId);
-   	NetObj *object = objects->get(i);
-   	nxlog_debug_tag(DEBUG_TAG_OBJECT_SYNC, 8, _T("Object %s [%d] at index %d"), object->getName(), object->getId(), i);
-      if (object->isDeleted())
+      unique_ptr<SharedObjectArray<NetObj>> allObjects = g_idxObjectById.getObjects();
+      nxlog_debug_tag(DEBUG_TAG_SYNC, 5, _T("Saving runtime data for %d objects"), allObjects->size());
+      for(int i = 0; i < allObjects->size(); i++)
       {
-         nxlog_debug_tag(DEBUG_TAG_OBJECT_SYNC, 5, _T("Object %s [%d] marked for deletion"), object->getName(), object->getId());
-         DBBegin(hdb);
-         if (object->deleteFromDatabase(hdb))
+         WatchdogNotify(watchdogId);
+         NetObj *object = allObjects->get(i);
+         if (object->isDeleted() || object->isModified())
          {
-            nxlog_debug_tag(DEBUG_TAG_OBJECT_SYNC, 4, _T("Object %d \"%s\" deleted from database"), object->getId(), object->getName());
-            DBCommit(hdb);
-
-            // Remove object from global object index by ID
-            g_idxObjectById.remove(object->getId());
+            objects.add(allObjects->getShared(i));
          }
          else
          {
-            DBRollback(hdb);
-            nxlog_debug_tag(DEBUG_TAG_OBJECT_SYNC, 4, _T("Call to deleteFromDatabase() failed for object %s [%d], transaction rollback"), object->getName(), object->getId());
+            object->saveRuntimeData(hdb);
          }
       }
-		else if (object->isModified())
-		{
-         if (saveRuntimeData)
-         {
-            object->markAsModified(MODIFY_COMMON_PROPERTIES); //save runtime data as well
-         }
-		   nxlog_debug_tag(DEBUG_TAG_OBJECT_SYNC, 5, _T("Object %s [%d] modified"), object->getName(), object->getId());
-		   if (g_syncerThreadPool != nullptr)
-		   {
-		      InterlockedIncrement(&s_outstandingSaveRequests);
-		      ThreadPoolExecute(g_syncerThreadPool, SaveObject, object);
-		   }
-		   else
-		   {
-            DBBegin(hdb);
-            if (object->saveToDatabase(hdb))
-            {
-               DBCommit(hdb);
-               object->markAsSaved();
-            }
-            else
-            {
-               DBRollback(hdb);
-            }
-		   }
-		}
-		else if (saveRuntimeData)
-		{
-         object->saveRuntimeData(hdb);
-		}
    }
+   else
+   {
+      for(int i = 0; i < modifiedObjectIds.size(); i++)
+      {
+         shared_ptr<NetObj> object = FindObjectById(modifiedObjectIds.get(i));
+         if ((object != nullptr) && (object->isDeleted() || object->isModified()))
+            objects.add(object);
+      }
+   }
+   nxlog_debug_tag(DEBUG_TAG_SYNC, 5, _T("%d objects to process (%d registered as modified)"), objects.size(), modifiedObjectIds.size());
+
+   objects.sort(CompareObjectsForSave);
+
+   ObjectSaveBatch *batch = nullptr;
+   for(int i = 0; i < objects.size(); i++)
+   {
+      WatchdogNotify(watchdogId);
+      NetObj *object = objects.get(i);
+      nxlog_debug_tag(DEBUG_TAG_OBJECT_SYNC, 8, _T("Object %s [%d] at index %d"), object->getName(), object->getId(), i);
+      if (object->isDeleted())
+      {
+         DeleteObjectFromDatabase(hdb, object);
+         continue;
+      }
+
+      if (saveRuntimeData)
+      {
+         object->markAsModified(MODIFY_COMMON_PROPERTIES); //save runtime data as well
+      }
+      nxlog_debug_tag(DEBUG_TAG_OBJECT_SYNC, 5, _T("Object %s [%d] modified"), object->getName(), object->getId());
+
+      if ((batch != nullptr) && ((batch->count == OBJECT_SAVE_BATCH_SIZE) || (batch->objects[0]->getObjectClass() != object->getObjectClass())))
+      {
+         FlushObjectSaveBatch(hdb, batch);
+         batch = nullptr;
+      }
+      if (batch == nullptr)
+      {
+         batch = new ObjectSaveBatch();
+         batch->count = 0;
+      }
+      batch->objects[batch->count++] = object;
+   }
+   if (batch != nullptr)
+      FlushObjectSaveBatch(hdb, batch);
 
 	if (g_syncerThreadPool != nullptr)
 	{
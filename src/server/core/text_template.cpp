@@ -0,0 +1,311 @@
+/*
+** NetXMS - Network Management System
+** Copyright (C) 2003-2021 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: text_template.cpp
+**
+**/
+
+#include "nxcore.h"
+
+/**
+ * Maximum length of macro element name (script name, attribute name, etc.)
+ */
+#define MAX_ELEMENT_LENGTH 255
+
+/**
+ * Text template compiler state
+ */
+struct TextTemplateCompiler
+{
+   StructArray<TextTemplateToken> *tokens;
+   TCHAR *pool;
+   int textToken;
+
+   /**
+    * Append character to current literal text token (creating new token if needed)
+    */
+   void appendText(TCHAR ch)
+   {
+      if (textToken == -1)
+      {
+         TextTemplateToken *t = tokens->addPlaceholder();
+         memset(t, 0, sizeof(TextTemplateToken));
+         t->type = TextTemplateTokenType::TEXT;
+         t->text = pool;
+         textToken = tokens->size() - 1;
+      }
+      *pool++ = ch;
+      tokens->get(textToken)->length++;
+   }
+
+   /**
+    * Add new non-text token (terminates current literal text token)
+    */
+   TextTemplateToken *addToken(TextTemplateTokenType type)
+   {
+      if (textToken != -1)
+      {
+         *pool++ = 0;
+         textToken = -1;
+      }
+      TextTemplateToken *t = tokens->addPlaceholder();
+      memset(t, 0, sizeof(TextTemplateToken));
+      t->type = type;
+      return t;
+   }
+
+   /**
+    * Read element name enclosed into brackets into string pool. On entry curr should point to opening
+    * bracket, on exit it will point to closing bracket or to last character if closing bracket is missing.
+    * Returns pointer to name in pool or nullptr if closing bracket is missing.
+    */
+   TCHAR *readElement(const TCHAR *&curr, TCHAR closingBracket)
+   {
+      if (textToken != -1)
+      {
+         *pool++ = 0;
+         textToken = -1;
+      }
+
+      TCHAR *element = pool;
+      int i;
+      for(i = 0, curr++; (*curr != closingBracket) && (*curr != 0) && (i < MAX_ELEMENT_LENGTH); curr++, i++)
+         *pool++ = *curr;
+      if (*curr == 0)  // no closing bracket
+      {
+         curr--;
+         pool = element;
+         return nullptr;
+      }
+      *pool++ = 0;
+      return element;
+   }
+};
+
+/**
+ * Compile text template
+ */
+TextTemplate::TextTemplate(const TCHAR *source) : m_tokens(0, 16)
+{
+   m_static = true;
+   if (source == nullptr)
+   {
+      m_source = nullptr;
+      m_pool = nullptr;
+      return;
+   }
+
+   m_source = MemCopyString(source);
+
+   // Each source character produces at most one pool character and one terminating zero
+   m_pool = MemAllocArrayNoInit<TCHAR>(_tcslen(source) * 2 + 2);
+
+   TextTemplateCompiler compiler;
+   compiler.tokens = &m_tokens;
+   compiler.pool = m_pool;
+   compiler.textToken = -1;
+
+   for(const TCHAR *curr = m_source; *curr != 0; curr++)
+   {
+      switch(*curr)
+      {
+         case '%':   // Metacharacter
+            curr++;
+            if (*curr == 0)
+            {
+               curr--;
+               break;   // Abnormal loop termination
+            }
+            switch(*curr)
+            {
+               case '%':
+                  compiler.appendText(_T('%'));
+                  break;
+               case 'a':
+               case 'A':
+               case 'c':
+               case 'E':
+               case 'g':
+               case 'i':
+               case 'I':
+               case 'K':
+               case 'm':
+               case 'M':
+               case 'n':
+               case 'N':
+               case 's':
+               case 'S':
+               case 't':
+               case 'T':
+               case 'u':
+               case 'U':
+               case 'v':
+               case 'y':
+               case 'Y':
+               case 'z':
+               case 'Z':
+                  compiler.addToken(TextTemplateTokenType::MACRO)->macro = *curr;
+                  m_static = false;
+                  break;
+               case '0':
+               case '1':
+               case '2':
+               case '3':
+               case '4':
+               case '5':
+               case '6':
+               case '7':
+               case '8':
+               case '9':
+                  {
+                     int index = *curr - '0';
+                     if (isdigit(*(curr + 1)))
+                     {
+                        curr++;
+                        index = index * 10 + (*curr - '0');
+                     }
+                     compiler.addToken(TextTemplateTokenType::PARAMETER)->index = index - 1;
+                     m_static = false;
+                  }
+                  break;
+               case '[':   // Script
+                  {
+                     TCHAR *name = compiler.readElement(curr, _T(']'));
+                     if (name != nullptr)
+                     {
+                        // Entry point can be given in form script/entry_point
+                        TCHAR *entryPoint = _tcschr(name, _T('/'));
+                        if (entryPoint != nullptr)
+                        {
+                           *entryPoint = 0;
+                           entryPoint++;
+                           Trim(entryPoint);
+                           if (*entryPoint == 0)
+                              entryPoint = nullptr;
+                        }
+                        TextTemplateToken *t = compiler.addToken(TextTemplateTokenType::SCRIPT);
+                        t->text = Trim(name);
+                        t->extra = entryPoint;
+                        m_static = false;
+                     }
+                  }
+                  break;
+               case '{':   // Custom attribute
+               case '<':   // Named parameter
+                  {
+                     TextTemplateTokenType type = (*curr == '{') ? TextTemplateTokenType::CUSTOM_ATTRIBUTE : TextTemplateTokenType::NAMED_PARAMETER;
+                     TCHAR *name = compiler.readElement(curr, (type == TextTemplateTokenType::CUSTOM_ATTRIBUTE) ? _T('}') : _T('>'));
+                     if (name != nullptr)
+                     {
+                        TCHAR *defaultValue = _tcschr(name, _T(':'));
+                        if (defaultValue != nullptr)
+                        {
+                           *defaultValue = 0;
+                           defaultValue++;
+                        }
+                        TextTemplateToken *t = compiler.addToken(type);
+                        t->text = Trim(name);
+                        t->extra = defaultValue;
+                        m_static = false;
+                     }
+                  }
+                  break;
+               case '(':   // Input field
+                  {
+                     TCHAR *name = compiler.readElement(curr, _T(')'));
+                     if (name != nullptr)
+                     {
+                        compiler.addToken(TextTemplateTokenType::INPUT_FIELD)->text = Trim(name);
+                        m_static = false;
+                     }
+                  }
+                  break;
+               default:    // All other characters are invalid, ignore
+                  break;
+            }
+            break;
+         case '\\':  // Escape character
+            curr++;
+            if (*curr == 0)
+            {
+               curr--;
+               break;   // Abnormal loop termination
+            }
+            switch(*curr)
+            {
+               case 't':
+                  compiler.appendText(_T('\t'));
+                  break;
+               case 'n':
+                  compiler.appendText(_T('\r'));
+                  compiler.appendText(_T('\n'));
+                  break;
+               default:
+                  compiler.appendText(*curr);
+                  break;
+            }
+            break;
+         default:
+            compiler.appendText(*curr);
+            break;
+      }
+   }
+   if (compiler.textToken != -1)
+      *compiler.pool = 0;
+}
+
+/**
+ * Text template destructor
+ */
+TextTemplate::~TextTemplate()
+{
+   MemFree(m_source);
+   MemFree(m_pool);
+}
+
+/**
+ * Run text expansion benchmark (compare on-the-fly template parsing and precompiled template)
+ */
+void BenchmarkTextTemplate(ServerConsole *console, const TCHAR *text, int iterations)
+{
+   Event event;
+   event.addParameter(_T("param1"), _T("value1"));
+   event.addParameter(_T("param2"), _T("value2"));
+
+   int64_t startTime = GetCurrentTimeMs();
+   for(int i = 0; i < iterations; i++)
+      TextTemplate t(text);
+   int64_t compileTime = GetCurrentTimeMs() - startTime;
+
+   startTime = GetCurrentTimeMs();
+   for(int i = 0; i < iterations; i++)
+      event.expandText(text);
+   int64_t parseTime = GetCurrentTimeMs() - startTime;
+
+   TextTemplate compiled(text);
+   startTime = GetCurrentTimeMs();
+   for(int i = 0; i < iterations; i++)
+      event.expandText(compiled);
+   int64_t precompiledTime = GetCurrentTimeMs() - startTime;
+
+   console->printf(_T("Template: %s\nTokens: %d\nExpanded text: %s\n"), text, compiled.size(), event.expandText(compiled).cstr());
+   console->printf(_T("Iterations .........: %d\n"), iterations);
+   console->printf(_T("Compilation ........: ") INT64_FMT _T(" ms\n"), compileTime);
+   console->printf(_T("Parse and expand ...: ") INT64_FMT _T(" ms\n"), parseTime);
+   console->printf(_T("Precompiled expand .: ") INT64_FMT _T(" ms\n"), precompiledTime);
+}
@@ -42,6 +42,7 @@ Zone::Zone() : super()
 	m_idxNodeByAddr = new InetAddressIndex;
 	m_idxInterfaceByAddr = new InetAddressIndex;
 	m_idxSubnetByAddr = new InetAddressIndex;
+	m_idxSubnetByPrefix = new InetAddressPrefixIndex;
    m_lastHealthCheck = TIMESTAMP_NEVER;
    m_lockedForHealthCheck = false;
 }
@@ -59,6 +60,7 @@ Zone::Zone(int32_t uin, const TCHAR *name) : super()
 	m_idxNodeByAddr = new InetAddressIndex;
 	m_idxInterfaceByAddr = new InetAddressIndex;
 	m_idxSubnetByAddr = new InetAddressIndex;
+	m_idxSubnetByPrefix = new InetAddressPrefixIndex;
    m_lastHealthCheck = TIMESTAMP_NEVER;
    m_lockedForHealthCheck = false;
    setCreationTime();
@@ -73,6 +75,7 @@ Zone::~Zone()
 	delete m_idxNodeByAddr;
 	delete m_idxInterfaceByAddr;
 	delete m_idxSubnetByAddr;
+	delete m_idxSubnetByPrefix;
 }
 
 /**
@@ -319,6 +322,37 @@ void Zone::updateNodeIndex(const InetAddress& oldIp, const InetAddress& newIp, c
    m_idxNodeByAddr->put(newIp, node);
 }
 
+/**
+ * Add subnet to index
+ */
+void Zone::addToIndex(const shared_ptr<Subnet>& subnet)
+{
+   InetAddress addr = subnet->getIpAddress();
+   m_idxSubnetByAddr->put(addr, subnet);
+   m_idxSubnetByPrefix->put(addr, subnet);
+}
+
+/**
+ * Remove subnet from index
+ */
+void Zone::removeFromIndex(const Subnet& subnet)
+{
+   InetAddress addr = subnet.getIpAddress();
+   m_idxSubnetByAddr->remove(addr);
+   m_idxSubnetByPrefix->remove(addr, subnet.getId());
+}
+
+/**
+ * Update subnet index (old and new address may differ only by mask)
+ */
+void Zone::updateSubnetIndex(const InetAddress& oldAddr, const InetAddress& newAddr, const shared_ptr<Subnet>& subnet)
+{
+   m_idxSubnetByAddr->remove(oldAddr);
+   m_idxSubnetByAddr->put(newAddr, subnet);
+   m_idxSubnetByPrefix->remove(oldAddr, subnet->getId());
+   m_idxSubnetByPrefix->put(newAddr, subnet);
+}
+
 /**
  * Called by client session handler to check if threshold summary should be shown for this object.
  */
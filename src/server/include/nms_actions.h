@@ -37,6 +37,9 @@ struct Action
    TCHAR emailSubject[MAX_EMAIL_SUBJECT_LEN];
    TCHAR *data;
    TCHAR channelName[MAX_OBJECT_NAME];
+   TextTemplate *dataTemplate;
+   TextTemplate *rcptAddrTemplate;
+   TextTemplate *emailSubjectTemplate;
 
    Action(const TCHAR *name);
    Action(DB_RESULT hResult, int row);
@@ -45,6 +48,7 @@ struct Action
 
    void fillMessage(NXCPMessage *msg) const;
    void saveToDatabase() const;
+   void compileTemplates();
 };
 
 //
@@ -492,10 +492,23 @@ struct AgentFileTransfer
    }
 };
 
+/**
+ * Subscription for incremental DCI last values updates
+ */
+struct LastValuesSubscription
+{
+   bool objectTooltipOnly;
+   bool overviewOnly;
+   bool includeNoValueObjects;
+   HashSet<uint32_t> dciFilter;   // Empty set means all DCIs of the object
+};
+
 // Explicit instantiation of template classes
 #ifdef _WIN32
+template class NXCORE_EXPORTABLE HashMap<uint32_t, LastValuesSubscription>;
 template class NXCORE_EXPORTABLE HashMap<uint32_t, ServerDownloadFileInfo>;
 template class NXCORE_EXPORTABLE HashSet<uint32_t>;
+template class NXCORE_EXPORTABLE HashSet<uint64_t>;
 template class NXCORE_EXPORTABLE SharedPointerIndex<AgentFileTransfer>;
 template class NXCORE_EXPORTABLE SharedPointerIndex<ProcessExecutor>;
 template class NXCORE_EXPORTABLE StringObjectMap<uint32_t>;
@@ -566,6 +579,11 @@ class NXCORE_EXPORTABLE ClientSession
    bool m_objectNotificationScheduled;
    uint32_t m_objectNotificationDelay;
    size_t m_objectNotificationBatchSize;
+   HashMap<uint32_t, LastValuesSubscription> m_lastValuesSubscriptions;
+   HashSet<uint64_t> m_pendingLastValues;    // Changed DCIs encoded as (object ID << 32) | DCI ID
+   MUTEX m_lastValuesLock;
+   bool m_lastValuesUpdateScheduled;
+   uint32_t m_lastValuesUpdateInterval;
    
 
    static void socketPollerCallback(BackgroundSocketPollResult pollResult, SOCKET hSocket, ClientSession *session);
@@ -654,6 +672,8 @@ class NXCORE_EXPORTABLE ClientSession
    void changeDCIStatus(NXCPMessage *pRequest);
    void getLastValues(NXCPMessage *pRequest);
    void getLastValuesByDciId(NXCPMessage *pRequest);
+   void subscribeLastValues(NXCPMessage *request);
+   void unsubscribeLastValues(NXCPMessage *request);
    void getTooltipLastValues(NXCPMessage *request);
    void getTableLastValue(NXCPMessage *request);
    void getLastValue(NXCPMessage *request);
@@ -824,6 +844,8 @@ class NXCORE_EXPORTABLE ClientSession
    void getScreenshot(NXCPMessage *request);
 	void executeScript(NXCPMessage *request);
    void executeLibraryScript(NXCPMessage *request);
+   void profileLibraryScript(NXCPMessage *request);
+   void getPerfStats(NXCPMessage *request);
    void compileScript(NXCPMessage *request);
 	void resyncAgentDciConfiguration(NXCPMessage *request);
    void cleanAgentDciConfiguration(NXCPMessage *request);
@@ -895,6 +917,8 @@ class NXCORE_EXPORTABLE ClientSession
    void alarmUpdateWorker(Alarm *alarm);
    void sendActionDBUpdateMessage(NXCP_MESSAGE *msg);
    void sendObjectUpdates();
+   void sendLastValuesUpdates();
+   void cancelLastValuesSubscription(uint32_t objectId);
 
    void finalizeFileTransferToAgent(shared_ptr<AgentConnection> conn, uint32_t requestId);
    uint32_t resolveDCIName(uint32_t nodeId, uint32_t dciId, TCHAR *name);
@@ -970,6 +994,7 @@ class NXCORE_EXPORTABLE ClientSession
    void onSyslogMessage(const SyslogMessage *sm);
    void onNewSNMPTrap(NXCPMessage *pMsg);
    void onObjectChange(const shared_ptr<NetObj>& object);
+   void onLastValueChange(uint32_t objectId, uint32_t dciId);
    void onAlarmUpdate(UINT32 dwCode, const Alarm *alarm);
    void onActionDBUpdate(UINT32 dwCode, const Action *action);
    void onLibraryImageChange(const uuid& guid, bool removed = false);
@@ -1007,6 +1032,93 @@ enum ThreadPoolStat
    THREAD_POOL_AVERAGE_WAIT_TIME
 };
 
+/**
+ * Latency histogram sources for internal parameters
+ */
+enum class LatencySource
+{
+   THREAD_POOL_WAIT_TIME,
+   THREAD_POOL_EXECUTION_TIME,
+   DB_WRITER_WAIT_TIME,
+   DB_WRITER_WRITE_TIME
+};
+
+/**
+ * Memory accounting categories
+ */
+enum class MemoryCategory
+{
+   DCI_CACHE = 0,
+   EVENTS = 1,
+   NXCP_SEND_QUEUES = 2,
+   SCRIPT_VMS = 3
+};
+
+/**
+ * Number of memory accounting categories
+ */
+#define MEMORY_CATEGORY_COUNT    4
+
+void NXCORE_EXPORTABLE UpdateMemoryUsage(MemoryCategory category, int64_t bytes, int64_t objects);
+void UpdateObjectMemoryUsage(const NetObj& object, bool add);
+uint64_t GetMemoryUsage(MemoryCategory category);
+int64_t GetMemoryUsageObjectCount(MemoryCategory category);
+uint64_t GetObjectMemoryUsage();
+uint64_t GetQueueMemoryUsage();
+DataCollectionError GetObjectClassMemoryUsage(const TCHAR *param, TCHAR *value);
+
+/**
+ * Server hot paths measured by built-in profiler
+ */
+enum class PerfHotPath
+{
+   STATUS_POLL = 0,
+   CONFIGURATION_POLL = 1,
+   TOPOLOGY_POLL = 2,
+   DATA_COLLECTION = 3,
+   EVENT_PROCESSING = 4,
+   SCRIPT_EXECUTION = 5,
+   DB_WRITER_BATCH = 6,
+   CLIENT_REQUEST = 7
+};
+
+/**
+ * Number of hot paths measured by built-in profiler
+ */
+#define PERF_HOT_PATH_COUNT   8
+
+/**
+ * Maximum number of slowest objects tracked per hot path
+ */
+#define PERF_TOP_OBJECTS      10
+
+void NXCORE_EXPORTABLE PerfRecord(PerfHotPath path, uint32_t key, uint64_t elapsedTime);
+
+/**
+ * Scoped timer for built-in profiler. Records time spent between construction and
+ * destruction for given hot path. Key is object ID for most hot paths and
+ * message code for client requests.
+ */
+class PerfScopedTimer
+{
+private:
+   PerfHotPath m_path;
+   uint32_t m_key;
+   int64_t m_startTime;
+
+public:
+   PerfScopedTimer(PerfHotPath path, uint32_t key)
+   {
+      m_path = path;
+      m_key = key;
+      m_startTime = GetMonotonicClockTimeNs();
+   }
+   ~PerfScopedTimer()
+   {
+      PerfRecord(m_path, m_key, (GetMonotonicClockTimeNs() - m_startTime) / 1000);
+   }
+};
+
 /**
  * Server command execution data
  */
@@ -1223,15 +1335,19 @@ void NXCORE_EXPORTABLE InitiateShutdown(ShutdownReason reason);
 int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx);
 
 void SaveObjects(DB_HANDLE hdb, UINT32 watchdogId, bool saveRuntimeData);
+void NXCORE_EXPORTABLE RegisterModifiedObject(uint32_t objectId);
 
 void NXCORE_EXPORTABLE QueueSQLRequest(const TCHAR *query);
 void NXCORE_EXPORTABLE QueueSQLRequest(const TCHAR *query, int bindCount, int *sqlTypes, const TCHAR **values);
 void QueueIDataInsert(time_t timestamp, uint32_t nodeId, uint32_t dciId, const TCHAR *rawValue, const TCHAR *transformedValue, DCObjectStorageClass storageClass);
+void QueueTDataInsert(time_t timestamp, uint32_t nodeId, uint32_t tableId, DCObjectStorageClass storageClass, const char *value);
 void QueueRawDciDataUpdate(time_t timestamp, uint32_t dciId, const TCHAR *rawValue, const TCHAR *transformedValue, time_t cacheTimestamp);
 void QueueRawDciDataDelete(uint32_t dciId);
 int64_t GetIDataWriterQueueSize();
+int64_t GetTDataWriterQueueSize();
 int64_t GetRawDataWriterQueueSize();
 uint64_t GetRawDataWriterMemoryUsage();
+bool GetDBWriterLatencyHistograms(const TCHAR *writer, LatencyHistogram *waitTime, LatencyHistogram *writeTime);
 void StartDBWriter();
 void StopDBWriter();
 void OnDBWriterMaxQueueSizeChange();
@@ -1263,6 +1379,7 @@ void LoadNotificationChannelDrivers();
 void LoadNotificationChannels();
 void ShutdownNotificationChannels();
 void SendNotification(const TCHAR *name, TCHAR *recipient, const TCHAR *subject, const TCHAR *message);
+DataCollectionError GetNotificationChannelStatistic(const TCHAR *param, int type, TCHAR *value);
 void GetNotificationChannels(NXCPMessage *msg);
 void GetNotificationDrivers(NXCPMessage *msg);
 char *GetNotificationChannelConfiguration(const TCHAR *name);
@@ -1306,6 +1423,10 @@ void NotifyClientsOnPolicyDelete(uuid guid, const Template& object);
 void NotifyClientsOnDCIUpdate(const DataCollectionOwner& object, DCObject *dco);
 void NotifyClientsOnDCIDelete(const DataCollectionOwner& object, uint32_t dcoId);
 void NotifyClientsOnDCIStatusChange(const DataCollectionOwner& object, uint32_t dcoId, int status);
+void NotifyClientsOnLastValueChange(uint32_t objectId, uint32_t dciId);
+void RegisterLastValuesSubscription(uint32_t objectId, session_id_t sessionId);
+void UnregisterLastValuesSubscription(uint32_t objectId, session_id_t sessionId);
+bool HasLastValuesSubscription(uint32_t objectId);
 void NotifyClientsOnDCIUpdate(const NXCPMessage& msg, const NetObj& object);
 void NotifyClientsOnThresholdChange(UINT32 objectId, UINT32 dciId, UINT32 thresholdId, const TCHAR *instance, ThresholdCheckResult change);
 int GetSessionCount(bool includeSystemAccount, bool includeNonAuthenticated, int typeFilter, const TCHAR *loginFilter);
@@ -1422,6 +1543,12 @@ void ShowQueueStats(CONSOLE_CTX console, int64_t size, const TCHAR *name);
 void ShowThreadPoolPendingQueue(CONSOLE_CTX console, ThreadPool *p, const TCHAR *name);
 void ShowThreadPool(CONSOLE_CTX console, const TCHAR *p);
 DataCollectionError GetThreadPoolStat(ThreadPoolStat stat, const TCHAR *param, TCHAR *value);
+void ShowLatencyHistograms(CONSOLE_CTX console);
+DataCollectionError GetLatencyPercentile(LatencySource source, const TCHAR *param, TCHAR *value);
+void ShowMemoryUsage(CONSOLE_CTX console);
+void ShowPerfStats(CONSOLE_CTX console);
+void ResetPerfStats();
+void FillPerfStatsMessage(NXCPMessage *msg);
 void DumpProcess(CONSOLE_CTX console);
 
 #define GRAPH_FLAG_TEMPLATE 1
@@ -1470,6 +1597,10 @@ void WatchdogGetThreads(StringList *out);
  */
 void StartHouseKeeper();
 void StopHouseKeeper();
+void StartDCIRollup();
+void StopDCIRollup();
+void StartDCICacheSnapshotWriter();
+void StopDCICacheSnapshotWriter();
 void RunHouseKeeper();
 
 /**
@@ -1619,6 +1750,8 @@ extern uint32_t g_offlineDataRelevanceTime;
 extern int32_t g_instanceRetentionTime;
 extern uint32_t g_snmpTrapStormCountThreshold;
 extern uint32_t g_snmpTrapStormDurationThreshold;
+extern uint32_t g_snmpMaxRequestsInFlight;
+extern uint32_t g_snmpRequestRateLimit;
 extern uint32_t g_pollsBetweenPrimaryIpUpdate;
 extern PrimaryIPUpdateMode g_primaryIpUpdateMode;
 
@@ -1631,6 +1764,7 @@ extern TCHAR g_szDbName[];
 extern TCHAR g_szDbSchema[];
 extern DB_DRIVER g_dbDriver;
 extern VolatileCounter64 g_idataWriteRequests;
+extern VolatileCounter64 g_tdataWriteRequests;
 extern uint64_t g_rawDataWriteRequests;
 extern VolatileCounter64 g_otherWriteRequests;
 
@@ -120,6 +120,49 @@ class NXCORE_EXPORTABLE ItemValue
 
 class DCItem;
 class DataCollectionTarget;
+class Threshold;
+class DCICacheSnapshotWriter;
+
+/**
+ * Running aggregates over window of cached DCI values. Window for sample count N
+ * covers N - 1 most recent cached values (current value is not yet in cache when
+ * thresholds are checked).
+ */
+struct ThresholdWindow
+{
+   int sampleCount;
+   int placeholders;       // Number of placeholder values (inserted by cache loader) in window
+   uint64_t sum;           // Sum of integer values in window (wraps around the same way as sum in value's own type)
+   bool sumReady;          // Following fields are valid for current check only
+   bool deviationReady;
+   double doubleSum;       // Sum of floating point values, including current value
+   double doubleDeviation;
+   uint64_t deviation;
+};
+
+/**
+ * Running aggregates shared by DCI thresholds with same sample count
+ */
+class NXCORE_EXPORTABLE ThresholdAggregates
+{
+private:
+   StructArray<ThresholdWindow> m_windows;
+   uint32_t m_cacheSize;
+   int m_dataType;
+   bool m_valid;
+
+public:
+   ThresholdAggregates() : m_windows(0, 4) { m_cacheSize = 0; m_dataType = -1; m_valid = false; }
+   ThresholdAggregates(const ThresholdAggregates& src) : m_windows(&src.m_windows) { m_cacheSize = src.m_cacheSize; m_dataType = src.m_dataType; m_valid = src.m_valid; }
+
+   bool isValid(int dataType, uint32_t cacheSize) const { return m_valid && (m_dataType == dataType) && (m_cacheSize == cacheSize); }
+   void invalidate() { m_valid = false; }
+   void rebuild(ObjectArray<Threshold> *thresholds, ItemValue **cache, uint32_t cacheSize, int dataType);
+   void shift(ItemValue **cache, uint32_t cacheSize, const ItemValue *value);
+   void startCheck();
+
+   ThresholdWindow *find(int sampleCount, int dataType);
+};
 
 /**
  * Threshold definition class
@@ -150,9 +193,9 @@ class NXCORE_EXPORTABLE Threshold
 	time_t m_lastEventTimestamp;
 
    const ItemValue& value() { return m_value; }
-   void calculateAverageValue(ItemValue *pResult, ItemValue &lastValue, ItemValue **ppPrevValues);
-   void calculateSumValue(ItemValue *pResult, ItemValue &lastValue, ItemValue **ppPrevValues);
-   void calculateMDValue(ItemValue *pResult, ItemValue &lastValue, ItemValue **ppPrevValues);
+   void calculateAverageValue(ItemValue *pResult, ItemValue &lastValue, ItemValue **ppPrevValues, ThresholdWindow *window);
+   void calculateSumValue(ItemValue *pResult, ItemValue &lastValue, ItemValue **ppPrevValues, ThresholdWindow *window);
+   void calculateMDValue(ItemValue *pResult, ItemValue &lastValue, ItemValue **ppPrevValues, ThresholdWindow *window);
    void calculateDiff(ItemValue *pResult, ItemValue &lastValue, ItemValue **ppPrevValues);
    void setScript(TCHAR *script);
 
@@ -186,7 +229,7 @@ class NXCORE_EXPORTABLE Threshold
    void setLastCheckedValue(const ItemValue &value) { m_lastCheckValue = value; }
 
    BOOL saveToDB(DB_HANDLE hdb, UINT32 dwIndex);
-   ThresholdCheckResult check(ItemValue &value, ItemValue **ppPrevValues, ItemValue &fvalue, ItemValue &tvalue, shared_ptr<NetObj> target, DCItem *dci);
+   ThresholdCheckResult check(ItemValue &value, ItemValue **ppPrevValues, ItemValue &fvalue, ItemValue &tvalue, shared_ptr<NetObj> target, DCItem *dci, ThresholdAggregates *aggregates = nullptr);
    ThresholdCheckResult checkError(UINT32 dwErrorCount);
 
    void fillMessage(NXCPMessage *msg, UINT32 baseId) const;
@@ -222,6 +265,15 @@ enum class DCObjectStorageClass
    OTHER = 5
 };
 
+/**
+ * DCI data rollup resolution
+ */
+enum class RollupResolution
+{
+   HOURLY = 0,
+   DAILY = 1
+};
+
 /**
  * Data collection object poll schedule types
  */
@@ -454,6 +506,7 @@ class NXCORE_EXPORTABLE DCItem : public DCObject
    uint32_t m_cacheSize;          // Number of items in cache
    uint32_t m_requiredCacheSize;
    ItemValue **m_ppValueCache;
+   ThresholdAggregates m_thresholdAggregates;
    ItemValue m_prevRawValue;     // Previous raw value (used for delta calculation)
    time_t m_tPrevValueTimeStamp;
    bool m_bCacheLoaded;
@@ -466,7 +519,10 @@ class NXCORE_EXPORTABLE DCItem : public DCObject
    bool transform(ItemValue &value, time_t nElapsedTime);
    void checkThresholds(ItemValue &value);
    void updateCacheSizeInternal(bool allowLoad, uint32_t conditionId = 0);
+   void setCacheSize(uint32_t size);
    void clearCache();
+   bool restoreCacheFromSnapshot();
+   uint32_t getCacheConfigHash() const;
 
    bool hasScriptThresholds() const;
    Threshold *getThresholdById(UINT32 id) const;
@@ -497,6 +553,7 @@ class NXCORE_EXPORTABLE DCItem : public DCObject
 
    void updateCacheSize(UINT32 conditionId = 0) { lock(); updateCacheSizeInternal(true, conditionId); unlock(); }
    void reloadCache(bool forceReload);
+   void writeCacheSnapshot(DCICacheSnapshotWriter *writer);
 
    int getDataType() const { return m_dataType; }
    int getNXSLDataType() const;
@@ -863,6 +920,63 @@ class DCObjectInfo
    UINT32 getRelatedObject() const { return m_relatedObject; }
 };
 
+/**
+ * Data point for downsampling
+ */
+struct DownsamplingPoint
+{
+   time_t timestamp;
+   double value;
+};
+
+/**
+ * Streaming downsampler for numeric DCI data. Points are expected in descending timestamp order
+ * (as they are read from database) and grouped into fixed size time buckets. Only two buckets
+ * are kept in memory at any time. Resulting points are passed to output().
+ */
+class NXCORE_EXPORTABLE DCIDataDownsampler
+{
+private:
+   DownsamplingMethod m_method;
+   time_t m_timeFrom;
+   time_t m_bucketSize;
+
+   // State for min/max/avg
+   int64_t m_bucket;
+   int m_count;
+   time_t m_timestamp;
+   double m_value;
+   double m_weight;
+
+   // State for LTTB
+   bool m_hasSelected;
+   DownsamplingPoint m_selected;
+   StructArray<DownsamplingPoint> *m_current;
+   StructArray<DownsamplingPoint> *m_next;
+   int64_t m_currentBucket;
+   int64_t m_nextBucket;
+
+   int64_t bucketIndex(time_t timestamp) const
+   {
+      return (timestamp - m_timeFrom) / m_bucketSize;
+   }
+
+   void flushBucket();
+   void selectPoint(StructArray<DownsamplingPoint> *bucket, double cx, double cy);
+   void addLTTB(time_t timestamp, double value);
+   void finishLTTB();
+
+protected:
+   virtual void output(time_t timestamp, double value) = 0;
+
+public:
+   DCIDataDownsampler(DownsamplingMethod method, time_t timeFrom, time_t bucketSize);
+   virtual ~DCIDataDownsampler();
+
+   void add(time_t timestamp, double value, double weight = 1);
+   void finish();
+};
+
 /**
  * Functions
  */
@@ -882,6 +996,23 @@ DataCollectionError GetQueueStatistic(const TCHAR *parameter, StatisticType type
 
 uint64_t GetDCICacheMemoryUsage();
 
+bool IsDCIRollupEnabled();
+time_t GetDCIRollupWatermark(RollupResolution resolution);
+time_t GetDCIRollupPeriod(RollupResolution resolution);
+const TCHAR *GetDCIRollupTable(RollupResolution resolution);
+bool SelectDCIRollupResolution(time_t step, time_t startTime, RollupResolution *resolution);
+void GetNumericDCIValueExpressions(const TCHAR **value, const TCHAR **filter);
+bool IsNumericDCIValue(const TCHAR *value);
+void CleanDCIRollupData(DB_HANDLE hdb);
+
+void OpenDCICacheSnapshot();
+void CloseDCICacheSnapshot();
+bool SaveDCICacheSnapshot();
+void WriteDCICacheSnapshotRecord(DCICacheSnapshotWriter *writer, uint32_t dciId, uint32_t ownerId, int dataType, uint32_t configHash,
+         ItemValue * const *values, uint32_t count);
+bool RestoreDCICacheFromSnapshot(uint32_t dciId, uint32_t ownerId, int dataType, uint32_t configHash, time_t lastValueTimestamp,
+         ItemValue **values, uint32_t count);
+
 /**
  * DCI cache loader queue
  */
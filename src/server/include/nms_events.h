@@ -56,6 +56,7 @@ class EventTemplate
    int m_severity;
    uint32_t m_flags;
    TCHAR *m_messageTemplate;
+   shared_ptr<TextTemplate> m_compiledMessageTemplate;
    TCHAR *m_description;
 
 public:
@@ -69,6 +70,7 @@ class EventTemplate
    int getSeverity() const { return m_severity; }
    uint32_t getFlags() const { return m_flags; }
    const TCHAR *getMessageTemplate() const { return m_messageTemplate; }
+   shared_ptr<TextTemplate> getCompiledMessageTemplate() const { return m_compiledMessageTemplate; }
    const TCHAR *getDescription() const { return m_description; }
    const TCHAR *getTags() const { return m_tags; }
 
@@ -102,6 +104,7 @@ class NXCORE_EXPORTABLE Event
 	TCHAR m_name[MAX_EVENT_NAME];
    TCHAR *m_messageText;
    TCHAR *m_messageTemplate;
+   shared_ptr<TextTemplate> m_compiledMessageTemplate;
    time_t m_timestamp;
    time_t m_originTimestamp;
    StringSet m_tags;
@@ -110,7 +113,7 @@ class NXCORE_EXPORTABLE Event
 	StringList m_parameterNames;
 	MutableString m_lastAlarmKey;
 	MutableString m_lastAlarmMessage;
-	int64_t m_queueTime;
+	int64_t m_queueTime;   // Time when event was placed into processing queue (microseconds, monotonic clock)
 	EventQueueBinding *m_queueBinding;
 
 	void init(const EventTemplate *eventTemplate, EventOrigin origin, time_t originTimestamp, uint32_t sourceId, uint32_t dciId);
@@ -160,6 +163,7 @@ class NXCORE_EXPORTABLE Event
 
    void expandMessageText();
    StringBuffer expandText(const TCHAR *textTemplate, const Alarm *alarm = nullptr) const;
+   StringBuffer expandText(const TextTemplate& textTemplate, const Alarm *alarm = nullptr) const;
    void setMessage(const TCHAR *text) { MemFree(m_messageText); m_messageText = MemCopyString(text); }
 
    bool hasTag(const TCHAR *tag) const { return m_tags.contains(tag); }
@@ -290,12 +294,17 @@ class EPRule
 	StringMap m_pstorageSetActions;
 	StringList m_pstorageDeleteActions;
 
+   TextTemplate *m_alarmMessageTemplate;
+   TextTemplate *m_alarmImpactTemplate;
+   TextTemplate *m_alarmKeyTemplate;
+
    bool matchSource(uint32_t objectId) const;
    bool matchEvent(uint32_t eventCode) const;
    bool matchSeverity(uint32_t severity) const;
    bool matchScript(Event *event) const;
 
    uint32_t generateAlarm(Event *event) const;
+   void compileTemplates();
 
 public:
    EPRule(uint32_t id);
@@ -365,6 +374,35 @@ struct EventProcessingThreadStats
    uint32_t bindings;
 };
 
+/**
+ * Event log writer statistics
+ */
+struct EventLogWriterStats
+{
+   uint64_t writtenEvents;
+   uint64_t droppedEvents;
+   uint64_t batches;
+   uint64_t totalWriteTime;
+   uint64_t maxQueueSize;
+   uint32_t maxBatchWriteTime;
+   uint32_t queueSize;
+   int writerThreads;
+};
+
+/**
+ * Event rate limiter statistics
+ */
+struct EventRateLimiterStats
+{
+   uint64_t suppressedBySource;
+   uint64_t suppressedByEventCode;
+   uint64_t summaryEvents;
+   uint32_t sourceBuckets;
+   uint32_t eventCodeBuckets;
+   uint32_t sourceRate;
+   uint32_t eventCodeRate;
+};
+
 /**
  * Functions
  */
@@ -380,6 +418,13 @@ void CorrelateEvent(Event *event);
 Event *LoadEventFromDatabase(uint64_t eventId);
 Event *FindEventInLoggerQueue(uint64_t eventId);
 StructArray<EventProcessingThreadStats> *GetEventProcessingThreadStats();
+bool GetEventProcessorLatencyHistogram(int queue, LatencyHistogram *waitTime);
+void GetEventLogWriterStats(EventLogWriterStats *stats);
+
+void InitEventRateLimiter();
+bool CheckEventRateLimit(uint32_t eventCode, uint32_t sourceId);
+void GetEventRateLimiterStats(EventRateLimiterStats *stats);
+void OnEventRateLimitConfigurationChange(const TCHAR *name, const TCHAR *value);
 
 bool EventNameFromCode(UINT32 eventCode, TCHAR *buffer);
 uint32_t NXCORE_EXPORTABLE EventCodeFromName(const TCHAR *name, uint32_t defaultValue = 0);
@@ -414,7 +459,7 @@ const TCHAR NXCORE_EXPORTABLE *GetStatusAsText(int status, bool allCaps);
 /**
  * Global variables
  */
-extern ObjectQueue<Event> g_eventQueue;
+extern ObjectMPSCQueue<Event> g_eventQueue;
 extern EventPolicy *g_pEventPolicy;
 extern VolatileCounter64 g_totalEventsProcessed;
 
@@ -314,6 +314,80 @@ struct TemplateUpdateTask
    }
 };
 
+/**
+ * Bulk data sets used during object loading at server startup
+ */
+enum class StartupDataSet
+{
+   OBJECT_PROPERTIES = 0,
+   CUSTOM_ATTRIBUTES = 1,
+   DASHBOARD_ASSOCIATIONS = 2,
+   OBJECT_URLS = 3,
+   TRUSTED_NODES = 4,
+   RESPONSIBLE_USERS = 5,
+   ACL = 6,
+   RAW_DCI_VALUES = 7,
+   DCI_THRESHOLDS = 8,
+   DCI_ACCESS = 9,
+   DCI_SCHEDULES = 10
+};
+
+#define STARTUP_DATASET_COUNT 11
+
+/**
+ * Result of bulk query indexed by object ID. Object ID must be returned in last column
+ * and result must be ordered by it.
+ */
+class NXCORE_EXPORTABLE BulkDataSet
+{
+   DISABLE_COPY_CTOR(BulkDataSet)
+
+private:
+   struct IndexEntry
+   {
+      uint32_t id;
+      int firstRow;
+      int rowCount;
+   };
+
+   DB_RESULT m_hResult;
+   IndexEntry *m_index;
+   int m_indexSize;
+
+public:
+   BulkDataSet(DB_HANDLE hdb, const TCHAR *query);
+   ~BulkDataSet();
+
+   bool isValid() const { return m_hResult != nullptr; }
+   DB_RESULT getResult() const { return m_hResult; }
+   bool find(uint32_t id, int *firstRow, int *rowCount) const;
+};
+
+/**
+ * Database rows related to single object. Rows are taken from startup bulk data set if it is available,
+ * otherwise per-object query is executed.
+ */
+class NXCORE_EXPORTABLE ObjectDataRows
+{
+   DISABLE_COPY_CTOR(ObjectDataRows)
+
+private:
+   DB_RESULT m_hResult;
+   bool m_ownResult;
+   int m_firstRow;
+   int m_rowCount;
+
+public:
+   ObjectDataRows(DB_HANDLE hdb, StartupDataSet dataSetId, const TCHAR *bulkQuery, const TCHAR *query, uint32_t objectId);
+   ~ObjectDataRows();
+
+   bool isValid() const { return m_hResult != nullptr; }
+   DB_RESULT getResult() const { return m_hResult; }
+   int getFirstRow() const { return m_firstRow; }
+   int getRowCount() const { return m_rowCount; }
+   int getEndRow() const { return m_firstRow + m_rowCount; }
+};
+
 /**
  * Index head
  */
@@ -372,6 +446,7 @@ class NXCORE_EXPORTABLE AbstractIndexBase
    }
 
    void setStartupMode(bool startupMode);
+   void sortStartupData();
 };
 
 /**
@@ -590,6 +665,27 @@ class NXCORE_EXPORTABLE InetAddressIndex
    void forEach(void (*callback)(const InetAddress&, NetObj *, void *), void *context) const;
 };
 
+/**
+ * Index of network objects by address prefix (used for longest prefix match lookup of subnets)
+ */
+class NXCORE_EXPORTABLE InetAddressPrefixIndex
+{
+private:
+   InetAddressPrefixTree m_tree;
+   RWLOCK m_lock;
+
+public:
+   InetAddressPrefixIndex();
+   ~InetAddressPrefixIndex();
+
+   void put(const InetAddress& prefix, const shared_ptr<NetObj>& object);
+   void remove(const InetAddress& prefix, uint32_t objectId);
+   shared_ptr<NetObj> findLongestMatch(const InetAddress& addr) const;
+   unique_ptr<SharedObjectArray<NetObj>> findOverlapping(const InetAddress& prefix) const;
+
+   int size() const;
+};
+
 struct HashIndexHead;
 
 /**
@@ -926,6 +1022,69 @@ class ObjectCategory
    void fillMessage(NXCPMessage *msg, uint32_t baseId);
 };
 
+/**
+ * Text template token type
+ */
+enum class TextTemplateTokenType : int16_t
+{
+   TEXT = 0,               // Literal text
+   MACRO = 1,              // Single character macro (%a, %n, etc.)
+   PARAMETER = 2,          // Event parameter or argument by index (%1 .. %99)
+   SCRIPT = 3,             // Script call %[script/entry]
+   CUSTOM_ATTRIBUTE = 4,   // Custom attribute %{name:default}
+   INPUT_FIELD = 5,        // Input field %(name)
+   NAMED_PARAMETER = 6     // Named event parameter %<name:default>
+};
+
+/**
+ * Text template token. Strings are stored in template's string pool.
+ */
+struct TextTemplateToken
+{
+   TextTemplateTokenType type;
+   TCHAR macro;            // Macro character for MACRO token
+   int index;              // Zero-based parameter index for PARAMETER token
+   size_t length;          // Text length for TEXT token
+   const TCHAR *text;      // Literal text or element name
+   const TCHAR *extra;     // Default value or script entry point (can be null)
+};
+
+#ifdef _WIN32
+template class NXCORE_EXPORTABLE StructArray<TextTemplateToken>;
+#endif
+
+/**
+ * Text template with macros compiled into token list. Compiled template is immutable
+ * and can be shared between threads.
+ */
+class NXCORE_EXPORTABLE TextTemplate
+{
+private:
+   TCHAR *m_source;
+   TCHAR *m_pool;
+   StructArray<TextTemplateToken> m_tokens;
+   bool m_static;
+
+public:
+   TextTemplate(const TCHAR *source);
+   TextTemplate(const TextTemplate& src) = delete;
+   ~TextTemplate();
+
+   const TCHAR *getSource() const { return m_source; }
+   int size() const { return m_tokens.size(); }
+   const TextTemplateToken *get(int index) const { return m_tokens.get(index); }
+
+   /**
+    * Returns true if template was created from null string
+    */
+   bool isNull() const { return m_source == nullptr; }
+
+   /**
+    * Returns true if template contains only literal text
+    */
+   bool isStatic() const { return m_static; }
+};
+
 #ifdef _WIN32
 template class NXCORE_EXPORTABLE ObjectArray<ObjectUrl>;
 #endif
@@ -1183,6 +1342,8 @@ class NXCORE_EXPORTABLE NetObj : public NObject
 
    StringBuffer expandText(const TCHAR *textTemplate, const Alarm *alarm, const Event *event, const shared_ptr<DCObjectInfo>& dci,
             const TCHAR *userName, const TCHAR *objectName, const TCHAR *instance, const StringMap *inputFields, const StringList *args);
+   StringBuffer expandText(const TextTemplate& textTemplate, const Alarm *alarm, const Event *event, const shared_ptr<DCObjectInfo>& dci,
+            const TCHAR *userName, const TCHAR *objectName, const TCHAR *instance, const StringMap *inputFields, const StringList *args);
 
    void updateGeoLocationHistory(GeoLocation location);
 
@@ -2171,11 +2332,12 @@ class NXCORE_EXPORTABLE DataCollectionTarget : public DataCollectionOwner
    UINT32 getThresholdSummary(NXCPMessage *msg, UINT32 baseId, UINT32 userId);
    UINT32 getPerfTabDCIList(NXCPMessage *pMsg, UINT32 userId);
    void getDciValuesSummary(SummaryTable *tableDefinition, Table *tableData, UINT32 userId);
-   UINT32 getLastValues(NXCPMessage *msg, bool objectTooltipOnly, bool overviewOnly, bool includeNoValueObjects, UINT32 userId);
+   UINT32 getLastValues(NXCPMessage *msg, bool objectTooltipOnly, bool overviewOnly, bool includeNoValueObjects, UINT32 userId, const HashSet<uint32_t> *dciFilter = nullptr);
    double getProxyLoadFactor() const { return m_proxyLoadFactor.load(); }
    void getTooltipLastValues(NXCPMessage &msg, uint32_t userId, uint32_t *index);
 
    void updateDciCache();
+   void writeDciCacheSnapshot(DCICacheSnapshotWriter *writer);
    void updateDCItemCacheSize(UINT32 dciId, UINT32 conditionId = 0);
    void reloadDCItemCache(UINT32 dciId);
    void cleanDCIData(DB_HANDLE hdb);
@@ -2971,6 +3133,7 @@ class NXCORE_EXPORTABLE Node : public DataCollectionTarget
    uint16_t m_snmpPort;
    uint16_t m_nUseIfXTable;
    SNMP_SecurityContext *m_snmpSecurity;
+   shared_ptr<SNMP_RequestScheduler> m_snmpRequestScheduler;
    uuid m_agentId;
    TCHAR *m_agentCertSubject;
    TCHAR m_agentVersion[MAX_AGENT_VERSION_LEN];
@@ -3444,6 +3607,7 @@ class NXCORE_EXPORTABLE Node : public DataCollectionTarget
    bool getIcmpStatistics(const TCHAR *target, UINT32 *last, UINT32 *min, UINT32 *max, UINT32 *avg, UINT32 *loss) const;
    DataCollectionError getIcmpStatistic(const TCHAR *param, IcmpStatFunction function, TCHAR *value) const;
    StringList *getIcmpStatCollectors() const;
+   DataCollectionError getSnmpSchedulerMetric(const TCHAR *name, TCHAR *buffer, size_t size) const;
 
    NetworkDeviceDriver *getDriver() const { return m_driver; }
    DriverData *getDriverData() { return m_driverData; }
@@ -3937,6 +4101,7 @@ class NXCORE_EXPORTABLE Zone : public NetObj
    InetAddressIndex *m_idxNodeByAddr;
    InetAddressIndex *m_idxInterfaceByAddr;
    InetAddressIndex *m_idxSubnetByAddr;
+   InetAddressPrefixIndex *m_idxSubnetByPrefix;
    time_t m_lastHealthCheck;
    bool m_lockedForHealthCheck;
 
@@ -3984,21 +4149,24 @@ class NXCORE_EXPORTABLE Zone : public NetObj
    void healthCheck(PollerInfo *poller);
 
    void addSubnet(const shared_ptr<Subnet>& subnet) { addChild(subnet); subnet->addParent(self()); }
-   void addToIndex(const shared_ptr<Subnet>& subnet) { m_idxSubnetByAddr->put(subnet->getIpAddress(), subnet); }
+   void addToIndex(const shared_ptr<Subnet>& subnet);
    void addToIndex(const shared_ptr<Interface>& iface) { m_idxInterfaceByAddr->put(iface->getIpAddressList(), iface); }
    void addToIndex(const InetAddress& addr, const shared_ptr<Interface>& iface) { m_idxInterfaceByAddr->put(addr, iface); }
    void addToIndex(const shared_ptr<Node>& node) { m_idxNodeByAddr->put(node->getIpAddress(), node); }
    void addToIndex(const InetAddress& addr, const shared_ptr<Node>& node) { m_idxNodeByAddr->put(addr, node); }
-   void removeFromIndex(const Subnet& subnet) { m_idxSubnetByAddr->remove(subnet.getIpAddress()); }
+   void removeFromIndex(const Subnet& subnet);
    void removeFromIndex(const Interface& iface);
    void removeFromInterfaceIndex(const InetAddress& addr) { m_idxInterfaceByAddr->remove(addr); }
    void removeFromIndex(const Node& node) { m_idxNodeByAddr->remove(node.getIpAddress()); }
    void removeFromNodeIndex(const InetAddress& addr) { m_idxNodeByAddr->remove(addr); }
    void updateInterfaceIndex(const InetAddress& oldIp, const InetAddress& newIp, const shared_ptr<Interface>& iface);
    void updateNodeIndex(const InetAddress& oldIp, const InetAddress& newIp, const shared_ptr<Node>& node);
+   void updateSubnetIndex(const InetAddress& oldAddr, const InetAddress& newAddr, const shared_ptr<Subnet>& subnet);
    shared_ptr<Subnet> getSubnetByAddr(const InetAddress& ipAddr) const { return static_pointer_cast<Subnet>(m_idxSubnetByAddr->get(ipAddr)); }
    shared_ptr<Interface> getInterfaceByAddr(const InetAddress& ipAddr) const { return static_pointer_cast<Interface>(m_idxInterfaceByAddr->get(ipAddr)); }
    shared_ptr<Node> getNodeByAddr(const InetAddress& ipAddr) const { return static_pointer_cast<Node>(m_idxNodeByAddr->get(ipAddr)); }
+   shared_ptr<Subnet> findSubnetForAddress(const InetAddress& addr) const { return static_pointer_cast<Subnet>(m_idxSubnetByPrefix->findLongestMatch(addr)); }
+   unique_ptr<SharedObjectArray<NetObj>> findOverlappingSubnets(const InetAddress& prefix) const { return m_idxSubnetByPrefix->findOverlapping(prefix); }
    shared_ptr<Subnet> findSubnet(bool (*comparator)(NetObj *, void *), void *context) const { return static_pointer_cast<Subnet>(m_idxSubnetByAddr->find(comparator, context)); }
    shared_ptr<Interface> findInterface(bool (*comparator)(NetObj *, void *), void *context) const { return static_pointer_cast<Interface>(m_idxInterfaceByAddr->find(comparator, context)); }
    shared_ptr<Node> findNode(bool (*comparator)(NetObj *, void *), void *context) const { return static_pointer_cast<Node>(m_idxNodeByAddr->find(comparator, context)); }
@@ -4750,6 +4918,7 @@ extern ObjectQueue<TemplateUpdateTask> g_templateUpdateQueue;
 extern ObjectIndex NXCORE_EXPORTABLE g_idxObjectById;
 extern HashIndex<uuid> g_idxObjectByGUID;
 extern InetAddressIndex NXCORE_EXPORTABLE g_idxSubnetByAddr;
+extern InetAddressPrefixIndex NXCORE_EXPORTABLE g_idxSubnetByPrefix;
 extern InetAddressIndex NXCORE_EXPORTABLE g_idxInterfaceByAddr;
 extern InetAddressIndex NXCORE_EXPORTABLE g_idxNodeByAddr;
 extern ObjectIndex NXCORE_EXPORTABLE g_idxZoneByUIN;
@@ -260,9 +260,11 @@ class NXSL_ServerEnv : public NXSL_Environment
 {
 protected:
    CONSOLE_CTX m_console;
+   uint64_t m_vmMemoryUsage;  // Memory usage of configured VM at the time of configuration (for memory accounting)
 
 public:
    NXSL_ServerEnv();
+   virtual ~NXSL_ServerEnv();
 
    virtual void print(NXSL_Value *value) override;
    virtual void trace(int level, const TCHAR *text) override;
@@ -439,6 +441,8 @@ void CreateScriptExportRecord(StringBuffer &xml, uint32_t id);
 void ImportScript(ConfigEntry *config, bool overwrite);
 NXSL_VM *FindHookScript(const TCHAR *hookName, shared_ptr<NetObj> object);
 bool ParseValueList(NXSL_VM *vm, TCHAR **start, ObjectRefArray<NXSL_Value> &args, bool hasBrackets);
+void PrintScriptProfile(ServerConsole *console, const NXSL_VM *vm, bool byInstruction, int maxEntries);
+void FillScriptProfileMessage(NXCPMessage *msg, const NXSL_VM *vm, bool byInstruction, int maxEntries);
 
 /**
  * Global variables
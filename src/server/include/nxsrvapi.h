@@ -56,6 +56,7 @@
 #define DDIR_BACKGROUNDS      _T("\\backgrounds")
 #define DFILE_KEYS            _T("\\server_key")
 #define DFILE_COMPILED_MIB    _T("\\netxms.mib")
+#define DFILE_DCI_CACHE       _T("\\dci_cache.snapshot")
 #define DDIR_IMAGES           _T("\\images")
 #define DDIR_FILES            _T("\\files")
 #define DDIR_CRL              _T("\\crl")
@@ -93,6 +94,7 @@
 #define DDIR_BACKGROUNDS      _T("/backgrounds")
 #define DFILE_KEYS            _T("/.server_key")
 #define DFILE_COMPILED_MIB    _T("/netxms.mib")
+#define DFILE_DCI_CACHE       _T("/dci_cache.snapshot")
 #define DDIR_IMAGES           _T("/images")
 #define DDIR_FILES            _T("/files")
 #define DDIR_CRL              _T("/crl")
@@ -162,6 +164,7 @@
 #define AF_LOG_ALL_SNMP_TRAPS                  _ULL(0x0008000000000000)
 #define AF_ALLOW_TRAP_VARBIND_CONVERSION       _ULL(0x0010000000000000)
 #define AF_TSDB_DROP_CHUNKS_V2                 _ULL(0x0020000000000000)
+#define AF_PARTITIONED_PERF_DATA               _ULL(0x0040000000000000)
 #define AF_SERVER_INITIALIZED                  _ULL(0x4000000000000000)
 #define AF_SHUTDOWN                            _ULL(0x8000000000000000)
 
@@ -627,7 +630,7 @@ class LIBNXSRV_EXPORTABLE NObject : public enable_shared_from_this<NObject>
    void setCustomAttribute(const TCHAR *key, uint64_t value);
 
    void setCustomAttributesFromMessage(const NXCPMessage *msg);
-   void setCustomAttributesFromDatabase(DB_RESULT hResult);
+   void setCustomAttributesFromDatabase(DB_RESULT hResult, int firstRow = 0, int rowCount = -1);
    void deleteCustomAttribute(const TCHAR *name);
    void updateOrDeleteCustomAttributeOnParentRemove(const TCHAR *name);
    NXSL_Value *getCustomAttributeForNXSL(NXSL_VM *vm, const TCHAR *name) const;
@@ -458,12 +458,12 @@ void NObject::populateRemove(const TCHAR *name)
 }
 
 /**
- * Set custom attributes from database query
+ * Set custom attributes from database query. If row count is negative, all rows starting from given one will be used.
  */
-void NObject::setCustomAttributesFromDatabase(DB_RESULT hResult)
+void NObject::setCustomAttributesFromDatabase(DB_RESULT hResult, int firstRow, int rowCount)
 {
-   int count = DBGetNumRows(hResult);
-   for(int i = 0; i < count; i++)
+   int endRow = (rowCount >= 0) ? firstRow + rowCount : DBGetNumRows(hResult);
+   for(int i = firstRow; i < endRow; i++)
    {
       TCHAR *name = DBGetField(hResult, i, 0, nullptr, 0);
       if (name != nullptr)
@@ -368,6 +368,7 @@ int main(int argc, char *argv[])
                      _T("   import <file>        : Import database from file\n")
                      _T("   init [<type>]        : Initialize database. If type is not provided it will be deduced from driver name.\n")
                      _T("   migrate <source>     : Migrate database from given source\n")
+                     _T("   partition-data       : Convert collected data tables to time partitioned tables\n")
                      _T("   reset-system-account : Unlock user \"system\" and reset it's password to default\n")
                      _T("   set <name> <value>   : Set value of server configuration variable\n")
                      _T("   unlock               : Forced database unlock\n")
@@ -587,6 +588,7 @@ int main(int argc, char *argv[])
        strcmp(argv[optind], "init") &&
        strcmp(argv[optind], "migrate") &&
        strcmp(argv[optind], "online-upgrade") &&   // synonym for "background-upgrade" for compatibility
+       strcmp(argv[optind], "partition-data") &&
        strcmp(argv[optind], "reset-system-account") &&
        strcmp(argv[optind], "set") &&
        strcmp(argv[optind], "unlock") &&
@@ -824,6 +826,10 @@ int main(int argc, char *argv[])
          MemFree(sourceConfig);
 #endif
 		}
+      else if (!strcmp(argv[optind], "partition-data"))
+      {
+         ConvertDataTablesToPartitioned();
+      }
       else if (!strcmp(argv[optind], "get"))
 		{
 #ifdef UNICODE
@@ -55,6 +55,7 @@ void MigrateDatabase(const TCHAR *sourceConfig, TCHAR *destConfFields, const Str
 void UpgradeDatabase();
 void UnlockDatabase();
 void ReindexIData();
+void ConvertDataTablesToPartitioned();
 
 bool ExecSQLBatch(const char *pszFile, bool showOutput);
 bool ValidateDatabase();
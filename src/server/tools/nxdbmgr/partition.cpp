@@ -0,0 +1,215 @@
+/*
+** nxdbmgr - NetXMS database manager
+** Copyright (C) 2004-2021 Victor Kirhenshtein
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: partition.cpp
+**
+**/
+
+#include "nxdbmgr.h"
+
+/**
+ * Storage classes (should match server's DCObjectStorageClass)
+ */
+static const TCHAR *s_storageClasses[] = { _T("default"), _T("7"), _T("30"), _T("90"), _T("180"), _T("other") };
+
+/**
+ * Selection conditions for DCIs in each storage class
+ */
+static const TCHAR *s_storageClassConditions[] =
+{
+   _T("(o.retention_type<>'1' OR o.retention_time=0)"),
+   _T("(o.retention_type='1' AND o.retention_time>0 AND o.retention_time<=7)"),
+   _T("(o.retention_type='1' AND o.retention_time>7 AND o.retention_time<=30)"),
+   _T("(o.retention_type='1' AND o.retention_time>30 AND o.retention_time<=90)"),
+   _T("(o.retention_type='1' AND o.retention_time>90 AND o.retention_time<=180)"),
+   _T("(o.retention_type='1' AND o.retention_time>180)")
+};
+
+/**
+ * Daily partitions are created for this number of days in advance (should match server's housekeeper)
+ */
+#define DATA_PARTITION_ADVANCE_DAYS    7
+
+/**
+ * Build name of daily partition with given upper bound
+ */
+static void BuildPartitionName(time_t upperBound, TCHAR *buffer)
+{
+   struct tm tmbuff;
+   _tcsftime(buffer, 16, _T("p%Y%m%d"), gmtime_r(&upperBound, &tmbuff));
+}
+
+/**
+ * Create partitioned table for given storage class. Initial partition covers all existing data,
+ * followed by daily partitions for next few days and catch-all partition for any rows above them.
+ * Server's housekeeper will create further daily partitions by splitting catch-all partition.
+ */
+static bool CreatePartitionedTable(const TCHAR *prefix, const TCHAR *columns, const TCHAR *storageClass, time_t upperBound)
+{
+   TCHAR table[64], partition[16];
+   _sntprintf(table, 64, _T("%s_sc_%s"), prefix, storageClass);
+   BuildPartitionName(upperBound, partition);
+
+   TCHAR query[1024];
+   switch(g_dbSyntax)
+   {
+      case DB_SYNTAX_MYSQL:
+      case DB_SYNTAX_ORACLE:
+         {
+            StringBuffer partitions;
+            partitions.appendFormattedString(_T("PARTITION %s VALUES LESS THAN (") INT64_FMT _T(")"), partition, static_cast<int64_t>(upperBound));
+            for(int i = 1; i <= DATA_PARTITION_ADVANCE_DAYS; i++)
+            {
+               time_t bound = upperBound + i * 86400;
+               BuildPartitionName(bound, partition);
+               partitions.appendFormattedString(_T(",PARTITION %s VALUES LESS THAN (") INT64_FMT _T(")"), partition, static_cast<int64_t>(bound));
+            }
+            partitions.append(_T(",PARTITION pmax VALUES LESS THAN (MAXVALUE)"));
+
+            if (g_dbSyntax == DB_SYNTAX_MYSQL)
+            {
+               _sntprintf(query, 1024, _T("CREATE TABLE %s (%s,PRIMARY KEY(item_id,%s_timestamp))"), table, columns, prefix);
+               CHK_EXEC_NO_SP(CreateTable(query));
+               StringBuffer alter;
+               alter.appendFormattedString(_T("ALTER TABLE %s PARTITION BY RANGE(%s_timestamp) ("), table, prefix);
+               alter.append(partitions);
+               alter.append(_T(")"));
+               CHK_EXEC_NO_SP(SQLQuery(alter));
+            }
+            else
+            {
+               StringBuffer create;
+               create.appendFormattedString(_T("CREATE TABLE %s (%s,PRIMARY KEY(item_id,%s_timestamp)) PARTITION BY RANGE(%s_timestamp) ("),
+                        table, columns, prefix, prefix);
+               create.append(partitions);
+               create.append(_T(")"));
+               CHK_EXEC_NO_SP(SQLQuery(create));
+            }
+         }
+         break;
+      default:
+         _sntprintf(query, 1024, _T("CREATE TABLE %s (%s,PRIMARY KEY(item_id,%s_timestamp)) PARTITION BY RANGE(%s_timestamp)"),
+                  table, columns, prefix, prefix);
+         CHK_EXEC_NO_SP(SQLQuery(query));
+         _sntprintf(query, 1024, _T("CREATE TABLE %s_%s PARTITION OF %s FOR VALUES FROM (MINVALUE) TO (") INT64_FMT _T(")"),
+                  table, partition, table, static_cast<int64_t>(upperBound));
+         CHK_EXEC_NO_SP(SQLQuery(query));
+         for(int i = 1; i <= DATA_PARTITION_ADVANCE_DAYS; i++)
+         {
+            time_t bound = upperBound + i * 86400;
+            BuildPartitionName(bound, partition);
+            _sntprintf(query, 1024, _T("CREATE TABLE %s_%s PARTITION OF %s FOR VALUES FROM (") INT64_FMT _T(") TO (") INT64_FMT _T(")"),
+                     table, partition, table, static_cast<int64_t>(bound - 86400), static_cast<int64_t>(bound));
+            CHK_EXEC_NO_SP(SQLQuery(query));
+         }
+         _sntprintf(query, 1024, _T("CREATE TABLE %s_pmax PARTITION OF %s DEFAULT"), table, table);
+         CHK_EXEC_NO_SP(SQLQuery(query));
+         break;
+   }
+   return true;
+}
+
+/**
+ * Convert single data table (idata or tdata) to set of partitioned tables
+ */
+static bool ConvertDataTable(const TCHAR *prefix, const TCHAR *columns, const TCHAR *columnList, const TCHAR *selectList, const TCHAR *configTable, time_t upperBound)
+{
+   WriteToTerminalEx(_T("Converting table \x1b[1m%s\x1b[0m\n"), prefix);
+
+   TCHAR query[1024];
+   if (g_dbSyntax == DB_SYNTAX_MYSQL)
+      _sntprintf(query, 1024, _T("RENAME TABLE %s TO %s_old"), prefix, prefix);
+   else
+      _sntprintf(query, 1024, _T("ALTER TABLE %s RENAME TO %s_old"), prefix, prefix);
+   CHK_EXEC_NO_SP(SQLQuery(query));
+
+   for(int i = 0; i < 6; i++)
+   {
+      CHK_EXEC_NO_SP(CreatePartitionedTable(prefix, columns, s_storageClasses[i], upperBound));
+
+      // Data for DCIs that no longer exist is not copied
+      WriteToTerminalEx(_T("   Copying data for storage class %s\n"), s_storageClasses[i]);
+      _sntprintf(query, 1024, _T("INSERT INTO %s_sc_%s (%s) SELECT %s FROM %s_old d INNER JOIN %s o ON o.item_id=d.item_id WHERE %s"),
+               prefix, s_storageClasses[i], columnList, selectList, prefix, configTable, s_storageClassConditions[i]);
+      CHK_EXEC_NO_SP(SQLQuery(query));
+   }
+
+   _sntprintf(query, 1024, _T("DROP TABLE %s_old"), prefix);
+   CHK_EXEC_NO_SP(SQLQuery(query));
+
+   StringBuffer view(_T("CREATE VIEW "));
+   view.append(prefix);
+   view.append(_T(" AS"));
+   for(int i = 0; i < 6; i++)
+   {
+      if (i > 0)
+         view.append(_T(" UNION ALL"));
+      view.append(_T(" SELECT * FROM "));
+      view.append(prefix);
+      view.append(_T("_sc_"));
+      view.append(s_storageClasses[i]);
+   }
+   CHK_EXEC_NO_SP(SQLQuery(view));
+   return true;
+}
+
+/**
+ * Convert collected data tables to time partitioned tables (one table per storage class)
+ */
+void ConvertDataTablesToPartitioned()
+{
+   if ((g_dbSyntax != DB_SYNTAX_MYSQL) && (g_dbSyntax != DB_SYNTAX_ORACLE) && (g_dbSyntax != DB_SYNTAX_PGSQL))
+   {
+      _tprintf(_T("Partitioned data tables are supported only for MySQL, Oracle, and PostgreSQL (without TimescaleDB extension)\n"));
+      return;
+   }
+
+   if (DBMgrMetaDataReadInt32(_T("SingeTablePerfData"), 0) == 0)
+   {
+      _tprintf(_T("Partitioned data tables can be used only with single table performance data storage\n"));
+      return;
+   }
+
+   if (DBMgrMetaDataReadInt32(_T("PartitionedPerfData"), 0) != 0)
+   {
+      _tprintf(_T("Data tables already partitioned\n"));
+      return;
+   }
+
+   if (!GetYesNo(_T("Collected data will be moved to partitioned tables. This may take long time and server should not be running.\nContinue?")))
+      return;
+
+   // Initial partition covers all existing data up to the end of current day (UTC)
+   time_t upperBound = (time(nullptr) / 86400 + 1) * 86400;
+
+   bool success =
+      ConvertDataTable(_T("idata"),
+               _T("item_id integer not null,idata_timestamp integer not null,idata_value varchar(255) null,raw_value varchar(255) null"),
+               _T("item_id,idata_timestamp,idata_value,raw_value"),
+               _T("d.item_id,d.idata_timestamp,d.idata_value,d.raw_value"), _T("items"), upperBound) &&
+      ConvertDataTable(_T("tdata"),
+               _T("item_id integer not null,tdata_timestamp integer not null,tdata_value $SQL:TEXT null"),
+               _T("item_id,tdata_timestamp,tdata_value"),
+               _T("d.item_id,d.tdata_timestamp,d.tdata_value"), _T("dc_tables"), upperBound) &&
+      DBMgrMetaDataWriteInt32(_T("PartitionedPerfData"), 1);
+
+   if (success)
+      _tprintf(_T("Data tables converted successfully\n"));
+   else
+      _tprintf(_T("Data tables conversion failed\n"));
+}
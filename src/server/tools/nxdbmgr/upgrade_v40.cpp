@@ -23,6 +23,211 @@
 #include "nxdbmgr.h"
 #include <nxevent.h>
 
+/**
+ * Upgrade from 40.73 to 40.74
+ */
+static bool H_UpgradeFromV73()
+{
+   CHK_EXEC(CreateConfigParam(_T("Events.RateLimit.BurstSize"),
+         _T("50"),
+         _T("Number of events from single source or with single event code that can be accepted in a burst above configured rate limit."),
+         _T("events"), 'I', true, false, false, false));
+   CHK_EXEC(CreateConfigParam(_T("Events.RateLimit.PerEventCode"),
+         _T("0"),
+         _T("Maximum sustained rate of events with same event code (0 to disable). Excessive events are suppressed and reported by periodic SYS_EVENTS_SUPPRESSED events."),
+         _T("events/second"), 'I', true, false, false, false));
+   CHK_EXEC(CreateConfigParam(_T("Events.RateLimit.PerSource"),
+         _T("0"),
+         _T("Maximum sustained rate of events from single source object (0 to disable). Excessive events are suppressed and reported by periodic SYS_EVENTS_SUPPRESSED events."),
+         _T("events/second"), 'I', true, false, false, false));
+   CHK_EXEC(CreateConfigParam(_T("Events.RateLimit.SummaryInterval"),
+         _T("60"),
+         _T("Interval for generating SYS_EVENTS_SUPPRESSED events for events suppressed by rate limiter."),
+         _T("seconds"), 'I', true, false, false, false));
+
+   CHK_EXEC(CreateEventTemplate(EVENT_EVENTS_SUPPRESSED, _T("SYS_EVENTS_SUPPRESSED"),
+         EVENT_SEVERITY_WARNING, EF_LOG, _T("a5d7f4e0-2b1c-4d8e-9f3a-6c0e7b91d245"),
+         _T("%<count> events %<eventName> suppressed by rate limiter in last %<period> seconds"),
+         _T("Generated periodically when events from this object were suppressed by event rate limiter.\r\n")
+         _T("Parameters:\r\n")
+         _T("   1) Code of suppressed events (eventCode)\r\n")
+         _T("   2) Name of suppressed events (eventName)\r\n")
+         _T("   3) Number of suppressed events (count)\r\n")
+         _T("   4) Reporting period in seconds (period)")
+         ));
+
+   CHK_EXEC(SetMinorSchemaVersion(74));
+   return true;
+}
+
+/**
+ * Upgrade from 40.72 to 40.73
+ */
+static bool H_UpgradeFromV72()
+{
+   CHK_EXEC(CreateConfigParam(_T("Client.LastValuesUpdateInterval"),
+         _T("1000"),
+         _T("Interval between incremental last values updates sent to subscribed clients."),
+         _T("milliseconds"), 'I', true, false, false, false));
+   CHK_EXEC(SetMinorSchemaVersion(73));
+   return true;
+}
+
+/**
+ * Upgrade from 40.71 to 40.72
+ */
+static bool H_UpgradeFromV71()
+{
+   CHK_EXEC(CreateConfigParam(_T("NotificationChannels.BatchWindow"),
+         _T("0"),
+         _T("Time to wait for additional messages before sending notifications as a batch (0 to send immediately). Only used by notification channel drivers that support batch sending."),
+         _T("milliseconds"), 'I', true, true, false, false));
+   CHK_EXEC(CreateConfigParam(_T("NotificationChannels.MaxBatchSize"),
+         _T("50"),
+         _T("Maximum number of messages in one notification batch."),
+         nullptr, 'I', true, true, false, false));
+   CHK_EXEC(CreateConfigParam(_T("NotificationChannels.RateLimit"),
+         _T("0"),
+         _T("Maximum number of messages (or message batches) sent via single notification channel per minute (0 to disable rate limiting)."),
+         _T("messages/minute"), 'I', true, true, false, false));
+   CHK_EXEC(CreateConfigParam(_T("NotificationChannels.RateLimit.Burst"),
+         _T("10"),
+         _T("Number of messages that can be sent via notification channel at once before rate limit is applied."),
+         nullptr, 'I', true, true, false, false));
+   CHK_EXEC(SetMinorSchemaVersion(72));
+   return true;
+}
+
+/**
+ * Upgrade from 40.70 to 40.71
+ */
+static bool H_UpgradeFromV70()
+{
+   CHK_EXEC(CreateConfigParam(_T("Events.LogWriter.Threads"),
+         _T("1"),
+         _T("Number of threads writing events to event log."),
+         _T("threads"), 'I', true, true, false, false));
+   CHK_EXEC(SetMinorSchemaVersion(71));
+   return true;
+}
+
+/**
+ * Upgrade from 40.69 to 40.70
+ */
+static bool H_UpgradeFromV69()
+{
+   CHK_EXEC(CreateConfigParam(_T("Objects.LoaderThreads"),
+         _T("4"),
+         _T("Number of threads used for loading objects from database at server startup."),
+         nullptr, 'I', true, true, false, false));
+   CHK_EXEC(SetMinorSchemaVersion(70));
+   return true;
+}
+
+/**
+ * Upgrade from 40.68 to 40.69
+ */
+static bool H_UpgradeFromV68()
+{
+   CHK_EXEC(CreateConfigParam(_T("DataCollection.CacheSnapshot.Enable"),
+         _T("1"),
+         _T("Enable/disable saving of DCI value cache snapshot on shutdown and periodically, and using it to restore DCI caches on server startup."),
+         nullptr, 'B', true, true, false, false));
+   CHK_EXEC(CreateConfigParam(_T("DataCollection.CacheSnapshot.Interval"),
+         _T("900"),
+         _T("Interval between periodic saves of DCI value cache snapshot (0 to save snapshot only on server shutdown)."),
+         _T("seconds"), 'I', true, true, false, false));
+   CHK_EXEC(SetMinorSchemaVersion(69));
+   return true;
+}
+
+/**
+ * Upgrade from 40.67 to 40.68
+ */
+static bool H_UpgradeFromV67()
+{
+   CHK_EXEC(CreateTable(
+      _T("CREATE TABLE dci_rollup_hourly (")
+      _T("   item_id integer not null,")
+      _T("   rollup_timestamp integer not null,")
+      _T("   min_value float(53) null,")
+      _T("   max_value float(53) null,")
+      _T("   avg_value float(53) null,")
+      _T("   value_count integer not null,")
+      _T("PRIMARY KEY(item_id,rollup_timestamp))")));
+   CHK_EXEC(SQLQuery(_T("CREATE INDEX idx_dci_rollup_hourly_timestamp ON dci_rollup_hourly(rollup_timestamp)")));
+
+   CHK_EXEC(CreateTable(
+      _T("CREATE TABLE dci_rollup_daily (")
+      _T("   item_id integer not null,")
+      _T("   rollup_timestamp integer not null,")
+      _T("   min_value float(53) null,")
+      _T("   max_value float(53) null,")
+      _T("   avg_value float(53) null,")
+      _T("   value_count integer not null,")
+      _T("PRIMARY KEY(item_id,rollup_timestamp))")));
+   CHK_EXEC(SQLQuery(_T("CREATE INDEX idx_dci_rollup_daily_timestamp ON dci_rollup_daily(rollup_timestamp)")));
+
+   CHK_EXEC(CreateConfigParam(_T("DataCollection.Rollup.Enable"),
+         _T("1"),
+         _T("Enable/disable background calculation of hourly and daily rollup of collected DCI data."),
+         nullptr, 'B', true, true, false, false));
+   CHK_EXEC(CreateConfigParam(_T("DataCollection.Rollup.HourlyRetentionTime"),
+         _T("90"),
+         _T("Retention time for hourly rollup of collected DCI data."),
+         _T("days"), 'I', true, false, false, false));
+   CHK_EXEC(CreateConfigParam(_T("DataCollection.Rollup.DailyRetentionTime"),
+         _T("1825"),
+         _T("Retention time for daily rollup of collected DCI data."),
+         _T("days"), 'I', true, false, false, false));
+
+   CHK_EXEC(SetMinorSchemaVersion(68));
+   return true;
+}
+
+/**
+ * Upgrade from 40.66 to 40.67
+ */
+static bool H_UpgradeFromV66()
+{
+   CHK_EXEC(CreateConfigParam(_T("DBWriter.TableDataQueues"),
+         _T("1"),
+         _T("Number of queues for DCI table data writer."),
+         nullptr, 'I', true, true, false, false));
+   CHK_EXEC(SetMinorSchemaVersion(67));
+   return true;
+}
+
+/**
+ * Upgrade from 40.65 to 40.66
+ */
+static bool H_UpgradeFromV65()
+{
+   CHK_EXEC(CreateConfigParam(_T("DBConnectionPool.ThreadAffinity"),
+         _T("0"),
+         _T("If enabled, connection pool will try to give thread the same connection it released last time, so prepared statements and session caches stay warm."),
+         nullptr, 'B', true, true, false, false));
+   CHK_EXEC(SetMinorSchemaVersion(66));
+   return true;
+}
+
+/**
+ * Upgrade from 40.64 to 40.65
+ */
+static bool H_UpgradeFromV64()
+{
+   CHK_EXEC(CreateConfigParam(_T("SNMP.RequestScheduler.MaxInFlight"),
+         _T("0"),
+         _T("Default maximum number of concurrent SNMP requests to single device. Can be overridden for individual node by custom attribute snmp.maxinflight. Limit is disabled if 0 is set."),
+         _T("requests"), 'I', true, false, false, false));
+   CHK_EXEC(CreateConfigParam(_T("SNMP.RequestScheduler.RateLimit"),
+         _T("0"),
+         _T("Default maximum number of SNMP requests per second to single device. Can be overridden for individual node by custom attribute snmp.ratelimit. Limit is disabled if 0 is set."),
+         _T("requests/second"), 'I', true, false, false, false));
+   CHK_EXEC(SetMinorSchemaVersion(65));
+   return true;
+}
+
 /**
  * Upgrade from 40.63 to 40.64
  */
@@ -1698,6 +1903,16 @@ static struct
    bool (*upgradeProc)();
 } s_dbUpgradeMap[] =
 {
+   { 73, 40, 74, H_UpgradeFromV73 },
+   { 72, 40, 73, H_UpgradeFromV72 },
+   { 71, 40, 72, H_UpgradeFromV71 },
+   { 70, 40, 71, H_UpgradeFromV70 },
+   { 69, 40, 70, H_UpgradeFromV69 },
+   { 68, 40, 69, H_UpgradeFromV68 },
+   { 67, 40, 68, H_UpgradeFromV67 },
+   { 66, 40, 67, H_UpgradeFromV66 },
+   { 65, 40, 66, H_UpgradeFromV65 },
+   { 64, 40, 65, H_UpgradeFromV64 },
    { 63, 40, 64, H_UpgradeFromV63 },
    { 62, 40, 63, H_UpgradeFromV62 },
    { 61, 40, 62, H_UpgradeFromV61 },
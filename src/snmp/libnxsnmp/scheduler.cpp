@@ -0,0 +1,279 @@
+/*
+** NetXMS - Network Management System
+** SNMP support library
+** Copyright (C) 2003-2021 Victor Kirhenshtein
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation; either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: scheduler.cpp
+**
+**/
+
+#include "libnxsnmp.h"
+
+/**
+ * Request waiting for free slot in scheduler
+ */
+struct SNMP_RequestSchedulerWaiter
+{
+   SNMP_RequestSchedulerWaiter *next;
+   CONDITION condition;
+   bool granted;
+};
+
+/**
+ * Update exponential moving average stored as fixed point value with 4 bits for fraction
+ */
+static inline uint32_t UpdateMovingAverage(uint32_t average, uint32_t value)
+{
+   return static_cast<uint32_t>((static_cast<uint64_t>(average) * 7 + static_cast<uint64_t>(value) * 16) / 8);
+}
+
+/**
+ * Create request scheduler
+ */
+SNMP_RequestScheduler::SNMP_RequestScheduler(uint32_t maxInFlight, uint32_t rateLimit) : m_mutex(true)
+{
+   m_maxInFlight = maxInFlight;
+   m_rateLimit = rateLimit;
+   m_inFlight = 0;
+   m_tokens = static_cast<int64_t>(rateLimit) * 1000;
+   m_lastRefillTime = GetCurrentTimeMs();
+   m_head[0] = m_head[1] = nullptr;
+   m_tail[0] = m_tail[1] = nullptr;
+   m_queueSize = 0;
+   m_requests = 0;
+   m_timeouts = 0;
+   m_queueTimeouts = 0;
+   m_lastResponseTime = 0;
+   m_averageResponseTime = 0;
+   m_averageWaitTime = 0;
+}
+
+/**
+ * Destroy request scheduler. Scheduler is shared between transports, so there could not be any waiters at this point.
+ */
+SNMP_RequestScheduler::~SNMP_RequestScheduler()
+{
+}
+
+/**
+ * Set new limits. Waiting requests will be granted immediately if new limits allow that.
+ */
+void SNMP_RequestScheduler::setLimits(uint32_t maxInFlight, uint32_t rateLimit)
+{
+   m_mutex.lock();
+   if ((maxInFlight != m_maxInFlight) || (rateLimit != m_rateLimit))
+   {
+      int64_t now = GetCurrentTimeMs();
+      refillTokens(now);
+      if (m_rateLimit == 0)
+         m_tokens = static_cast<int64_t>(rateLimit) * 1000;
+      m_maxInFlight = maxInFlight;
+      m_rateLimit = rateLimit;
+      grantWaiters();
+   }
+   m_mutex.unlock();
+}
+
+/**
+ * Refill rate limiter tokens. Up to one second worth of requests can be accumulated.
+ */
+void SNMP_RequestScheduler::refillTokens(int64_t now)
+{
+   int64_t elapsed = now - m_lastRefillTime;
+   m_lastRefillTime = now;
+   if ((m_rateLimit == 0) || (elapsed <= 0))
+      return;
+
+   int64_t capacity = std::max(static_cast<int64_t>(m_rateLimit) * 1000, static_cast<int64_t>(1000));
+   m_tokens = std::min(m_tokens + elapsed * m_rateLimit, capacity);
+}
+
+/**
+ * Check if new request can be sent now
+ */
+bool SNMP_RequestScheduler::canGrant() const
+{
+   if ((m_maxInFlight != 0) && (m_inFlight >= m_maxInFlight))
+      return false;
+   return (m_rateLimit == 0) || (m_tokens >= 1000);
+}
+
+/**
+ * Grant as many waiting requests as allowed by limits, higher priority first
+ */
+void SNMP_RequestScheduler::grantWaiters()
+{
+   for(int p = SNMP_REQUEST_PRIORITY_HIGH; p >= SNMP_REQUEST_PRIORITY_NORMAL; p--)
+   {
+      while((m_head[p] != nullptr) && canGrant())
+      {
+         SNMP_RequestSchedulerWaiter *waiter = m_head[p];
+         m_head[p] = waiter->next;
+         if (m_head[p] == nullptr)
+            m_tail[p] = nullptr;
+
+         m_inFlight++;
+         if (m_rateLimit != 0)
+            m_tokens -= 1000;
+         waiter->granted = true;
+         ConditionSet(waiter->condition);
+      }
+   }
+}
+
+/**
+ * Remove waiter from queue
+ */
+void SNMP_RequestScheduler::removeWaiter(SNMP_RequestSchedulerWaiter *waiter)
+{
+   for(int p = SNMP_REQUEST_PRIORITY_NORMAL; p <= SNMP_REQUEST_PRIORITY_HIGH; p++)
+   {
+      SNMP_RequestSchedulerWaiter *prev = nullptr;
+      for(SNMP_RequestSchedulerWaiter *curr = m_head[p]; curr != nullptr; prev = curr, curr = curr->next)
+      {
+         if (curr != waiter)
+            continue;
+
+         if (prev != nullptr)
+            prev->next = curr->next;
+         else
+            m_head[p] = curr->next;
+         if (m_tail[p] == curr)
+            m_tail[p] = prev;
+         return;
+      }
+   }
+}
+
+/**
+ * Update average time spent in queue
+ */
+void SNMP_RequestScheduler::updateWaitTime(uint32_t waitTime)
+{
+   m_averageWaitTime = UpdateMovingAverage(m_averageWaitTime, waitTime);
+}
+
+/**
+ * Acquire slot for sending request. Will wait up to given timeout for free slot.
+ * Returns true if request can be sent and false on timeout. Each successful call
+ * to acquire() should be followed by call to release() when request is completed.
+ */
+bool SNMP_RequestScheduler::acquire(SNMP_RequestPriority priority, uint32_t timeout)
+{
+   int64_t startTime = GetCurrentTimeMs();
+
+   m_mutex.lock();
+   refillTokens(startTime);
+
+   // Fast path - nobody with same or higher priority is waiting and limits are not reached
+   if ((m_head[SNMP_REQUEST_PRIORITY_HIGH] == nullptr) &&
+       ((priority == SNMP_REQUEST_PRIORITY_HIGH) || (m_head[SNMP_REQUEST_PRIORITY_NORMAL] == nullptr)) &&
+       canGrant())
+   {
+      m_inFlight++;
+      if (m_rateLimit != 0)
+         m_tokens -= 1000;
+      updateWaitTime(0);
+      m_mutex.unlock();
+      return true;
+   }
+
+   SNMP_RequestSchedulerWaiter waiter;
+   waiter.next = nullptr;
+   waiter.condition = ConditionCreate(false);
+   waiter.granted = false;
+   if (m_tail[priority] != nullptr)
+      m_tail[priority]->next = &waiter;
+   else
+      m_head[priority] = &waiter;
+   m_tail[priority] = &waiter;
+   m_queueSize++;
+
+   int64_t now = startTime;
+   while(true)
+   {
+      // When rate limit is in effect, wake up when next token becomes available
+      uint32_t waitTime = (timeout == INFINITE) ? INFINITE : static_cast<uint32_t>(std::max(static_cast<int64_t>(timeout) - (now - startTime), static_cast<int64_t>(0)));
+      if ((m_rateLimit != 0) && (m_tokens < 1000))
+         waitTime = std::min(waitTime, static_cast<uint32_t>((1000 - m_tokens + m_rateLimit - 1) / m_rateLimit));
+
+      m_mutex.unlock();
+      ConditionWait(waiter.condition, waitTime);
+      m_mutex.lock();
+
+      if (waiter.granted)
+         break;
+
+      now = GetCurrentTimeMs();
+      refillTokens(now);
+      grantWaiters();
+      if (waiter.granted)
+         break;
+
+      if ((timeout != INFINITE) && (now - startTime >= static_cast<int64_t>(timeout)))
+      {
+         removeWaiter(&waiter);
+         m_queueTimeouts++;
+         break;
+      }
+   }
+
+   m_queueSize--;
+   if (waiter.granted)
+      updateWaitTime(static_cast<uint32_t>(GetCurrentTimeMs() - startTime));
+   m_mutex.unlock();
+
+   ConditionDestroy(waiter.condition);
+   return waiter.granted;
+}
+
+/**
+ * Release slot acquired by acquire() and update statistics
+ */
+void SNMP_RequestScheduler::release(uint32_t rcode, uint32_t responseTime)
+{
+   m_mutex.lock();
+   if (m_inFlight > 0)
+      m_inFlight--;
+   m_requests++;
+   if (rcode == SNMP_ERR_TIMEOUT)
+      m_timeouts++;
+   m_lastResponseTime = responseTime;
+   m_averageResponseTime = (m_requests == 1) ? responseTime * 16 : UpdateMovingAverage(m_averageResponseTime, responseTime);
+
+   int64_t now = GetCurrentTimeMs();
+   refillTokens(now);
+   grantWaiters();
+   m_mutex.unlock();
+}
+
+/**
+ * Get scheduler statistics
+ */
+void SNMP_RequestScheduler::getStatistics(SNMP_RequestSchedulerStatistics *statistics)
+{
+   m_mutex.lock();
+   statistics->requests = m_requests;
+   statistics->timeouts = m_timeouts;
+   statistics->queueTimeouts = m_queueTimeouts;
+   statistics->inFlight = m_inFlight;
+   statistics->queueSize = m_queueSize;
+   statistics->lastResponseTime = m_lastResponseTime;
+   statistics->averageResponseTime = m_averageResponseTime >> 4;
+   statistics->averageWaitTime = m_averageWaitTime >> 4;
+   m_mutex.unlock();
+}
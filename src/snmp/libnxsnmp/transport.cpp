@@ -56,6 +56,7 @@ SNMP_Transport::SNMP_Transport()
 	m_updatePeerOnRecv = false;
 	m_reliable = false;
 	m_snmpVersion = SNMP_VERSION_2C;
+	m_priority = SNMP_REQUEST_PRIORITY_NORMAL;
 }
 
 /**
@@ -93,7 +94,7 @@ uint32_t SNMP_Transport::doEngineIdDiscovery(SNMP_PDU *originalRequest, uint32_t
    SNMP_PDU discoveryRequest(SNMP_GET_REQUEST, originalRequest->getRequestId(), SNMP_VERSION_3);
    discoveryRequest.bindVariable(new SNMP_Variable(_T(".1.3.6.1.6.3.10.2.1.1.0")));    // snmpEngineID
    SNMP_PDU *response = nullptr;
-   uint32_t rc = doRequest(&discoveryRequest, &response, timeout, numRetries, true);
+   uint32_t rc = doRequestInternal(&discoveryRequest, &response, timeout, numRetries, true);
    if (rc != SNMP_ERR_SUCCESS)
       return rc;
 
@@ -107,9 +108,32 @@ uint32_t SNMP_Transport::doEngineIdDiscovery(SNMP_PDU *originalRequest, uint32_t
 }
 
 /**
- * Send a request and wait for response with respect for timeouts and retransmissions
+ * Send a request and wait for response with respect for timeouts and retransmissions.
+ * If request scheduler is set, request will wait for free slot in scheduler queue
+ * for up to one request timeout.
  */
 uint32_t SNMP_Transport::doRequest(SNMP_PDU *request, SNMP_PDU **response, uint32_t timeout, int numRetries, bool engineIdDiscoveryOnly)
+{
+   if ((request == nullptr) || (response == nullptr) || (numRetries <= 0))
+      return SNMP_ERR_PARAM;
+
+   if (m_scheduler == nullptr)
+      return doRequestInternal(request, response, timeout, numRetries, engineIdDiscoveryOnly);
+
+   *response = nullptr;
+   if (!m_scheduler->acquire(m_priority, timeout))
+      return SNMP_ERR_TIMEOUT;
+
+   int64_t startTime = GetCurrentTimeMs();
+   uint32_t rc = doRequestInternal(request, response, timeout, numRetries, engineIdDiscoveryOnly);
+   m_scheduler->release(rc, static_cast<uint32_t>(GetCurrentTimeMs() - startTime));
+   return rc;
+}
+
+/**
+ * Send a request and wait for response with respect for timeouts and retransmissions (without scheduling)
+ */
+uint32_t SNMP_Transport::doRequestInternal(SNMP_PDU *request, SNMP_PDU **response, uint32_t timeout, int numRetries, bool engineIdDiscoveryOnly)
 {
    if ((request == nullptr) || (response == nullptr) || (numRetries <= 0))
       return SNMP_ERR_PARAM;
@@ -0,0 +1,45 @@
+#include <nms_common.h>
+#include <nms_util.h>
+#include <testtools.h>
+
+/**
+ * Test latency histogram
+ */
+void TestLatencyHistogram()
+{
+   StartTest(_T("LatencyHistogram: bucket boundaries"));
+   for(uint64_t v = 0; v < 100000; v++)
+   {
+      int index = LatencyHistogram::bucketIndex(v);
+      AssertTrue(LatencyHistogram::bucketLowerBound(index) <= v);
+      AssertTrue(LatencyHistogram::bucketUpperBound(index) >= v);
+   }
+   AssertEquals(LatencyHistogram::bucketIndex(_ULL(0xFFFFFFFFFF)), LATENCY_HISTOGRAM_BUCKETS - 1);
+   EndTest();
+
+   StartTest(_T("LatencyHistogram: percentiles"));
+   LatencyHistogram h;
+   AssertEquals(h.getPercentile(99), _ULL(0));
+   for(int i = 1; i <= 1000; i++)
+      h.update(i);
+   AssertEquals(h.getCount(), _ULL(1000));
+   AssertEquals(h.getMax(), 1000);
+   AssertEquals(h.getPercentile(100), _ULL(1000));
+   uint64_t p50 = h.getPercentile(50);
+   AssertTrue((p50 >= 500) && (p50 < 500 * 9 / 8 + 1));
+   uint64_t p99 = h.getPercentile(99);
+   AssertTrue((p99 >= 990) && (p99 <= 1000));
+   AssertTrue((h.getMean() > 450) && (h.getMean() < 550));
+   EndTest();
+
+   StartTest(_T("LatencyHistogram: merge"));
+   LatencyHistogram h2;
+   h2.update(5000);
+   LatencyHistogram snapshot(h);
+   snapshot.merge(h2);
+   AssertEquals(snapshot.getCount(), _ULL(1001));
+   AssertEquals(snapshot.getMax(), 5000);
+   AssertEquals(snapshot.getPercentile(100), _ULL(5000));
+   AssertEquals(h.getCount(), _ULL(1000));
+   EndTest();
+}
@@ -109,5 +109,18 @@ void TestObjectMemoryPool()
    AssertEquals(pool.allocate(), o3);
    AssertEquals(pool.allocate(), o2);
 
+   AssertEquals(pool.getElementCount(), 200);
+   AssertEquals(pool.getRegionCount(), 4);
+   pool.clear();
+   AssertEquals(pool.getElementCount(), 0);
+   AssertEquals(pool.getRegionCount(), 1);
+   for(int i = 0; i < 100; i++)
+   {
+      o = new (pool.allocate()) TestClass(i);
+      AssertEquals(o->index, i);
+   }
+   AssertEquals(pool.getElementCount(), 100);
+   AssertEquals(pool.getRegionCount(), 2);
+
    EndTest();
 }
@@ -32,6 +32,21 @@ void TestQueue()
    AssertEquals(q->size(), 0);
    EndTest();
 
+   StartTest(_T("Queue: putAll/getAll"));
+   void *elements[40];
+   for(int i = 0; i < 40; i++)
+      elements[i] = CAST_TO_POINTER(i + 1, void *);
+   q->putAll(elements, 40);
+   AssertEquals(q->size(), 40);
+   memset(elements, 0, sizeof(elements));
+   AssertEquals(q->getAll(elements, 25), 25);
+   AssertEquals(q->getAll(&elements[25], 25), 15);
+   for(int i = 0; i < 40; i++)
+      AssertEquals(CAST_FROM_POINTER(elements[i], int), i + 1);
+   AssertEquals(q->size(), 0);
+   AssertEquals(q->getAll(elements, 25), 0);
+   EndTest();
+
    StartTest(_T("Queue: insert"));
    for (int i = 0; i < 20; i++)
       q->put((void*)"LowPriority");
@@ -62,10 +77,12 @@ void TestQueue()
    EndTest();
 
    StartTest(_T("Queue: shrink"));
+   uint64_t memoryUsage = q->getMemoryUsage();
    for(int i = 0; i < 60; i++)
       q->put(CAST_TO_POINTER(i + 1, void *));
    AssertEquals(q->size(), 60);
    AssertEquals(q->allocated(), 64);
+   AssertTrue(q->getMemoryUsage() > memoryUsage + 48 * sizeof(void*));
    for(int i = 0; i < 55; i++)
    {
       void *p = q->get();
@@ -74,6 +91,29 @@ void TestQueue()
    }
    AssertEquals(q->size(), 5);
    AssertEquals(q->allocated(), 16);
+   AssertEquals(q->getMemoryUsage(), memoryUsage);
+   EndTest();
+
+   StartTest(_T("Queue: wait time histogram"));
+   q->clear();
+   q->enableWaitTimeHistogram();
+   AssertNotNull(q->getWaitTimeHistogram());
+   uint64_t putStartTime = GetMonotonicClockTimeNs() / 1000;
+   for(int i = 0; i < 40; i++)
+      q->put(CAST_TO_POINTER(i + 1, void *));
+   uint64_t putCompletionTime = GetMonotonicClockTimeNs() / 1000;
+   ThreadSleepMs(20);
+   uint64_t getStartTime = GetMonotonicClockTimeNs() / 1000;
+   for(int i = 0; i < 40; i++)
+      AssertNotNull(q->get());
+   uint64_t getCompletionTime = GetMonotonicClockTimeNs() / 1000;
+   AssertEquals(q->getWaitTimeHistogram()->getCount(), _ULL(40));
+   // Each element waited at least from last put to first get and at most for the whole test,
+   // so median is within these bounds regardless of actual sleep duration
+   uint64_t p50 = q->getWaitTimeHistogram()->getPercentile(50);
+   AssertTrue(p50 >= getStartTime - putCompletionTime);
+   AssertTrue(p50 <= getCompletionTime - putStartTime);
+   AssertTrue(q->getWaitTimeHistogram()->getMax() <= getCompletionTime - putStartTime);
    EndTest();
 
 #if !WITH_ADDRESS_SANITIZER
@@ -98,6 +138,229 @@ void TestQueue()
    delete q;
 }
 
+/**
+ * Number of producers and elements per producer for queue benchmarks
+ */
+#define BENCHMARK_PRODUCERS   32
+#define BENCHMARK_ELEMENTS    20000
+
+/**
+ * Producer context for queue benchmarks
+ */
+struct QueueProducerContext
+{
+   Queue *queue;
+   MPSCQueue *mpscQueue;
+   int id;
+   bool batch;
+};
+
+/**
+ * Producer thread for queue benchmarks. Element value encodes producer ID and sequence number.
+ */
+static void QueueProducerThread(QueueProducerContext *context)
+{
+   void *batch[16];
+   size_t batchSize = 0;
+   for(int i = 1; i <= BENCHMARK_ELEMENTS; i++)
+   {
+      void *element = CAST_TO_POINTER((context->id << 24) | i, void*);
+      if (context->queue != nullptr)
+      {
+         context->queue->put(element);
+      }
+      else if (context->batch)
+      {
+         batch[batchSize++] = element;
+         if (batchSize == 16)
+         {
+            context->mpscQueue->putAll(batch, batchSize);
+            batchSize = 0;
+         }
+      }
+      else
+      {
+         context->mpscQueue->put(element);
+      }
+   }
+   if (batchSize > 0)
+      context->mpscQueue->putAll(batch, batchSize);
+}
+
+/**
+ * Run multi-producer queue benchmark. Returns false if elements were lost or order of elements
+ * from single producer was broken.
+ */
+static bool RunQueueBenchmark(Queue *queue, MPSCQueue *mpscQueue, bool batch)
+{
+   QueueProducerContext context[BENCHMARK_PRODUCERS];
+   THREAD threads[BENCHMARK_PRODUCERS];
+   for(int i = 0; i < BENCHMARK_PRODUCERS; i++)
+   {
+      context[i].queue = queue;
+      context[i].mpscQueue = mpscQueue;
+      context[i].id = i;
+      context[i].batch = batch;
+      threads[i] = ThreadCreateEx(QueueProducerThread, &context[i]);
+   }
+
+   int lastSequence[BENCHMARK_PRODUCERS];
+   memset(lastSequence, 0, sizeof(lastSequence));
+   bool success = true;
+   void *elements[256];
+   for(int received = 0; received < BENCHMARK_PRODUCERS * BENCHMARK_ELEMENTS;)
+   {
+      size_t count;
+      if (queue != nullptr)
+      {
+         elements[0] = queue->getOrBlock(2000);
+         count = (elements[0] != nullptr) ? 1 : 0;
+      }
+      else
+      {
+         count = mpscQueue->getAllOrBlock(elements, 256, 2000);
+      }
+      if (count == 0)
+      {
+         success = false;
+         break;
+      }
+      for(size_t i = 0; i < count; i++)
+      {
+         int value = CAST_FROM_POINTER(elements[i], int);
+         int id = value >> 24;
+         int sequence = value & 0xFFFFFF;
+         if (sequence != lastSequence[id] + 1)
+            success = false;
+         lastSequence[id] = sequence;
+      }
+      received += static_cast<int>(count);
+   }
+
+   for(int i = 0; i < BENCHMARK_PRODUCERS; i++)
+      ThreadJoin(threads[i]);
+   return success;
+}
+
+/**
+ * Test MPSC queue
+ */
+void TestMPSCQueue()
+{
+   MPSCQueue *q = new MPSCQueue(16, Ownership::False);
+
+   StartTest(_T("MPSCQueue: put/get"));
+   AssertEquals(q->capacity(), 16);
+   AssertNull(q->get());
+   for(int i = 0; i < 10; i++)
+      q->put(CAST_TO_POINTER(i + 1, void *));
+   AssertEquals(q->size(), 10);
+   for(int i = 0; i < 10; i++)
+   {
+      void *p = q->get();
+      AssertNotNull(p);
+      AssertEquals(CAST_FROM_POINTER(p, int), i + 1);
+   }
+   AssertEquals(q->size(), 0);
+   AssertNull(q->get());
+   EndTest();
+
+   StartTest(_T("MPSCQueue: putAll/getAll"));
+   void *elements[64];
+   for(int i = 0; i < 12; i++)
+      elements[i] = CAST_TO_POINTER(i + 1, void *);
+   q->putAll(elements, 12);
+   AssertEquals(q->size(), 12);
+   AssertEquals(q->getOverflowCount(), _ULL(0));
+   memset(elements, 0, sizeof(elements));
+   AssertEquals(q->getAll(elements, 5), 5);
+   AssertEquals(q->getAll(&elements[5], 64), 7);
+   for(int i = 0; i < 12; i++)
+      AssertEquals(CAST_FROM_POINTER(elements[i], int), i + 1);
+   AssertEquals(q->size(), 0);
+   EndTest();
+
+   StartTest(_T("MPSCQueue: overflow"));
+   for(int i = 0; i < 40; i++)
+      elements[i] = CAST_TO_POINTER(i + 1, void *);
+   q->putAll(elements, 10);
+   q->putAll(&elements[10], 10);
+   for(int i = 20; i < 40; i++)
+      q->put(elements[i]);
+   AssertEquals(q->size(), 40);
+   AssertTrue(q->getMemoryUsage() > 16 * sizeof(void*));
+   memset(elements, 0, sizeof(elements));
+   AssertEquals(q->getAll(elements, 64), 40);
+   AssertEquals(q->getOverflowCount(), _ULL(24));
+   for(int i = 0; i < 40; i++)
+      AssertEquals(CAST_FROM_POINTER(elements[i], int), i + 1);
+   AssertEquals(q->size(), 0);
+   q->put(CAST_TO_POINTER(100, void *));
+   AssertEquals(q->getOverflowCount(), _ULL(24));
+   AssertEquals(CAST_FROM_POINTER(q->get(), int), 100);
+   EndTest();
+
+   StartTest(_T("MPSCQueue: getOrBlock"));
+   int64_t startTime = GetCurrentTimeMs();
+   AssertNull(q->getOrBlock(200));
+   AssertTrue(GetCurrentTimeMs() - startTime >= 190);
+   QueueProducerContext context;
+   context.queue = nullptr;
+   context.mpscQueue = q;
+   context.id = 1;
+   context.batch = false;
+   THREAD thread = ThreadCreateEx(QueueProducerThread, &context);
+   for(int i = 1; i <= BENCHMARK_ELEMENTS; i++)
+   {
+      void *p = q->getOrBlock(2000);
+      AssertNotNull(p);
+      AssertEquals(CAST_FROM_POINTER(p, int), (1 << 24) | i);
+   }
+   ThreadJoin(thread);
+   AssertEquals(q->size(), 0);
+   EndTest();
+
+   delete q;
+
+   StartTest(_T("MPSCQueue: ownership"));
+   auto oq = new ObjectMPSCQueue<String>(16, Ownership::True);
+   for(int i = 0; i < 30; i++)
+      oq->put(new String(_T("test")));
+   String *s = oq->get();
+   AssertNotNull(s);
+   AssertTrue(!_tcscmp(s->cstr(), _T("test")));
+   delete s;
+   AssertEquals(oq->size(), 29);
+   delete oq;   // Remaining elements should be destroyed (checked by memory leak detector)
+   EndTest();
+
+#if !WITH_ADDRESS_SANITIZER
+   StartTest(_T("Queue: performance (32 producers)"));
+   Queue *lq = new Queue();
+   startTime = GetCurrentTimeMs();
+   AssertTrue(RunQueueBenchmark(lq, nullptr, false));
+   AssertEquals(lq->size(), 0);
+   EndTest(GetCurrentTimeMs() - startTime);
+   delete lq;
+
+   StartTest(_T("MPSCQueue: performance (32 producers)"));
+   q = new MPSCQueue();
+   startTime = GetCurrentTimeMs();
+   AssertTrue(RunQueueBenchmark(nullptr, q, false));
+   AssertEquals(q->size(), 0);
+   EndTest(GetCurrentTimeMs() - startTime);
+   delete q;
+
+   StartTest(_T("MPSCQueue: performance (32 producers, batch)"));
+   q = new MPSCQueue();
+   startTime = GetCurrentTimeMs();
+   AssertTrue(RunQueueBenchmark(nullptr, q, true));
+   AssertEquals(q->size(), 0);
+   EndTest(GetCurrentTimeMs() - startTime);
+   delete q;
+#endif
+}
+
 struct TestObject
 {
    uint32_t id;
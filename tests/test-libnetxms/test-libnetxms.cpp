@@ -12,10 +12,12 @@
 NETXMS_EXECUTABLE_HEADER(test-libnetxms)
 
 void TestGauge64();
+void TestLatencyHistogram();
 void TestMemoryPool();
 void TestObjectMemoryPool();
 void TestThreadPool();
 void TestQueue();
+void TestMPSCQueue();
 void TestSharedObjectQueue();
 void TestMsgWaitQueue();
 void TestMessageClass();
@@ -710,6 +712,223 @@ static void TestInetAddress()
    EndTest();
 }
 
+/**
+ * Create prefix from address and mask length
+ */
+static InetAddress MakePrefix(const char *addr, int maskBits)
+{
+   InetAddress a = InetAddress::parse(addr);
+   a.setMaskBits(maskBits);
+   return a;
+}
+
+/**
+ * Test prefix
+ */
+struct TestPrefix
+{
+   InetAddress prefix;
+   void *value;
+};
+
+/**
+ * Find longest matching prefix by linear scan
+ */
+static void *LinearPrefixMatch(const StructArray<TestPrefix>& prefixes, const InetAddress& addr)
+{
+   void *value = nullptr;
+   int maskBits = -1;
+   for(int i = 0; i < prefixes.size(); i++)
+   {
+      const TestPrefix *p = prefixes.get(i);
+      if (p->prefix.contain(addr) && (p->prefix.getMaskBits() > maskBits))
+      {
+         maskBits = p->prefix.getMaskBits();
+         value = p->value;
+      }
+   }
+   return value;
+}
+
+/**
+ * Random IPv4 prefix
+ */
+static InetAddress RandomPrefix(int minBits, int maxBits)
+{
+   InetAddress a((static_cast<uint32_t>(rand()) << 16) ^ static_cast<uint32_t>(rand()));
+   a.setMaskBits(minBits + rand() % (maxBits - minBits + 1));
+   return a.getSubnetAddress();
+}
+
+/**
+ * Random IPv4 address
+ */
+static InetAddress RandomAddress()
+{
+   return InetAddress((static_cast<uint32_t>(rand()) << 16) ^ static_cast<uint32_t>(rand()));
+}
+
+/**
+ * Callback for counting prefixes
+ */
+static void CountPrefixes(const InetAddress& prefix, void *value, void *context)
+{
+   (*static_cast<int*>(context))++;
+}
+
+/**
+ * Test IP address prefix tree
+ */
+static void TestInetAddressPrefixTree()
+{
+   InetAddressPrefixTree tree;
+
+   StartTest(_T("InetAddressPrefixTree - put/get"));
+   AssertNull(tree.put(MakePrefix("10.0.0.0", 8), CAST_TO_POINTER(1, void*)));
+   AssertNull(tree.put(MakePrefix("10.1.0.0", 16), CAST_TO_POINTER(2, void*)));
+   AssertNull(tree.put(MakePrefix("10.1.2.0", 24), CAST_TO_POINTER(3, void*)));
+   AssertNull(tree.put(MakePrefix("10.1.2.128", 25), CAST_TO_POINTER(4, void*)));
+   AssertNull(tree.put(MakePrefix("192.168.1.0", 24), CAST_TO_POINTER(5, void*)));
+   AssertNull(tree.put(MakePrefix("10.0.0.0", 24), CAST_TO_POINTER(6, void*)));
+   AssertNull(tree.put(MakePrefix("2001:db8::", 32), CAST_TO_POINTER(7, void*)));
+   AssertNull(tree.put(MakePrefix("2001:db8:1::", 48), CAST_TO_POINTER(8, void*)));
+   AssertEquals(tree.size(), 8);
+   AssertEquals(CAST_FROM_POINTER(tree.get(MakePrefix("10.0.0.0", 8)), int), 1);
+   AssertEquals(CAST_FROM_POINTER(tree.get(MakePrefix("10.0.0.0", 24)), int), 6);
+   AssertEquals(CAST_FROM_POINTER(tree.get(MakePrefix("2001:db8:1::", 48)), int), 8);
+   AssertNull(tree.get(MakePrefix("10.0.0.0", 16)));
+   AssertNull(tree.get(MakePrefix("10.1.3.0", 24)));
+   AssertEquals(CAST_FROM_POINTER(tree.put(MakePrefix("192.168.1.0", 24), CAST_TO_POINTER(9, void*)), int), 5);
+   AssertEquals(CAST_FROM_POINTER(tree.get(MakePrefix("192.168.1.0", 24)), int), 9);
+   AssertEquals(tree.size(), 8);
+   EndTest();
+
+   StartTest(_T("InetAddressPrefixTree - longest prefix match"));
+   AssertEquals(CAST_FROM_POINTER(tree.findLongestMatch(InetAddress::parse("10.1.2.200")), int), 4);
+   AssertEquals(CAST_FROM_POINTER(tree.findLongestMatch(InetAddress::parse("10.1.2.5")), int), 3);
+   AssertEquals(CAST_FROM_POINTER(tree.findLongestMatch(InetAddress::parse("10.1.3.1")), int), 2);
+   AssertEquals(CAST_FROM_POINTER(tree.findLongestMatch(InetAddress::parse("10.2.0.1")), int), 1);
+   AssertEquals(CAST_FROM_POINTER(tree.findLongestMatch(InetAddress::parse("10.0.0.5")), int), 6);
+   AssertEquals(CAST_FROM_POINTER(tree.findLongestMatch(InetAddress::parse("192.168.1.17")), int), 9);
+   AssertNull(tree.findLongestMatch(InetAddress::parse("11.0.0.1")));
+   AssertNull(tree.findLongestMatch(InetAddress::parse("192.168.2.1")));
+   AssertEquals(CAST_FROM_POINTER(tree.findLongestMatch(InetAddress::parse("2001:db8:1::5")), int), 8);
+   AssertEquals(CAST_FROM_POINTER(tree.findLongestMatch(InetAddress::parse("2001:db8:2::1")), int), 7);
+   AssertNull(tree.findLongestMatch(InetAddress::parse("2002::1")));
+   EndTest();
+
+   StartTest(_T("InetAddressPrefixTree - overlapping prefixes"));
+   int count = 0;
+   tree.findOverlapping(MakePrefix("10.1.0.0", 16), CountPrefixes, &count);
+   AssertEquals(count, 4);
+   count = 0;
+   tree.findOverlapping(MakePrefix("10.1.2.0", 23), CountPrefixes, &count);
+   AssertEquals(count, 4);
+   count = 0;
+   tree.findOverlapping(MakePrefix("10.1.2.64", 26), CountPrefixes, &count);
+   AssertEquals(count, 3);
+   count = 0;
+   tree.findOverlapping(MakePrefix("172.16.0.0", 12), CountPrefixes, &count);
+   AssertEquals(count, 0);
+   count = 0;
+   tree.forEach(CountPrefixes, &count);
+   AssertEquals(count, 8);
+   EndTest();
+
+   StartTest(_T("InetAddressPrefixTree - remove"));
+   AssertEquals(CAST_FROM_POINTER(tree.remove(MakePrefix("10.1.2.0", 24)), int), 3);
+   AssertNull(tree.remove(MakePrefix("10.1.2.0", 24)));
+   AssertNull(tree.remove(MakePrefix("10.1.0.0", 15)));
+   AssertEquals(tree.size(), 7);
+   AssertEquals(CAST_FROM_POINTER(tree.findLongestMatch(InetAddress::parse("10.1.2.5")), int), 2);
+   AssertEquals(CAST_FROM_POINTER(tree.findLongestMatch(InetAddress::parse("10.1.2.200")), int), 4);
+   AssertEquals(CAST_FROM_POINTER(tree.remove(MakePrefix("10.1.0.0", 16)), int), 2);
+   AssertEquals(CAST_FROM_POINTER(tree.findLongestMatch(InetAddress::parse("10.1.2.5")), int), 1);
+   AssertEquals(CAST_FROM_POINTER(tree.findLongestMatch(InetAddress::parse("10.1.2.200")), int), 4);
+   AssertEquals(CAST_FROM_POINTER(tree.remove(MakePrefix("2001:db8::", 32)), int), 7);
+   AssertNull(tree.findLongestMatch(InetAddress::parse("2001:db8:2::1")));
+   AssertEquals(tree.size(), 5);
+   tree.clear();
+   AssertEquals(tree.size(), 0);
+   AssertNull(tree.findLongestMatch(InetAddress::parse("10.1.2.200")));
+   EndTest();
+
+   StartTest(_T("InetAddressPrefixTree - compare with linear scan"));
+   srand(1);
+   StructArray<TestPrefix> prefixes(0, 1024);
+   for(int i = 0; i < 2000; i++)
+   {
+      TestPrefix p;
+      p.prefix = RandomPrefix(4, 30);
+      p.value = CAST_TO_POINTER(i + 1, void*);
+      if (tree.put(p.prefix, p.value) != nullptr)
+      {
+         for(int j = 0; j < prefixes.size(); j++)
+            if (prefixes.get(j)->prefix.equals(p.prefix) && (prefixes.get(j)->prefix.getMaskBits() == p.prefix.getMaskBits()))
+            {
+               prefixes.get(j)->value = p.value;
+               break;
+            }
+      }
+      else
+      {
+         prefixes.add(&p);
+      }
+   }
+   AssertEquals(tree.size(), static_cast<size_t>(prefixes.size()));
+   for(int i = 0; i < 10000; i++)
+   {
+      InetAddress addr = RandomAddress();
+      AssertTrue(tree.findLongestMatch(addr) == LinearPrefixMatch(prefixes, addr));
+   }
+   for(int i = prefixes.size() - 1; i >= 0; i -= 2)
+   {
+      AssertTrue(tree.remove(prefixes.get(i)->prefix) == prefixes.get(i)->value);
+      prefixes.remove(i);
+   }
+   AssertEquals(tree.size(), static_cast<size_t>(prefixes.size()));
+   for(int i = 0; i < 10000; i++)
+   {
+      InetAddress addr = RandomAddress();
+      AssertTrue(tree.findLongestMatch(addr) == LinearPrefixMatch(prefixes, addr));
+   }
+   tree.clear();
+   EndTest();
+
+#if !WITH_ADDRESS_SANITIZER
+   prefixes.clear();
+   for(uint32_t i = 0; i < 40000; i++)
+   {
+      TestPrefix p;
+      p.prefix = InetAddress(0x0A000000 | (i << 8));
+      p.prefix.setMaskBits(24);
+      p.value = CAST_TO_POINTER(i + 1, void*);
+      prefixes.add(&p);
+      tree.put(p.prefix, p.value);
+   }
+
+   StartTest(_T("Subnet lookup - linear scan (40000 subnets)"));
+   srand(2);
+   int64_t startTime = GetCurrentTimeMs();
+   for(int i = 0; i < 2000; i++)
+   {
+      InetAddress addr(0x0A000000 | (rand() % (40000 << 8)));
+      AssertNotNull(LinearPrefixMatch(prefixes, addr));
+   }
+   EndTest(GetCurrentTimeMs() - startTime);
+
+   StartTest(_T("Subnet lookup - prefix tree (40000 subnets)"));
+   srand(2);
+   startTime = GetCurrentTimeMs();
+   for(int i = 0; i < 2000; i++)
+   {
+      InetAddress addr(0x0A000000 | (rand() % (40000 << 8)));
+      AssertNotNull(tree.findLongestMatch(addr));
+   }
+   EndTest(GetCurrentTimeMs() - startTime);
+#endif
+}
+
 /**
  * Test itoa/itow
  */
@@ -1311,6 +1530,48 @@ static void TestTable()
    AssertTrue(!_tcscmp(table2->getAsString(15, 0), table->getAsString(15, 0)));
    EndTest(GetCurrentTimeMs() - start);
 
+   StartTest(_T("Table: unpack packed XML as packed data"));
+   packedTable = table->createPackedXML();
+   Table *table5 = Table::createFromPackedData(packedTable);
+   MemFree(packedTable);
+   AssertNotNull(table5);
+   AssertEquals(table5->getNumRows(), table->getNumRows());
+   AssertTrue(!_tcscmp(table5->getAsString(15, 0), table->getAsString(15, 0)));
+   delete table5;
+   EndTest();
+
+   table->setTitle(_T("Process table"));
+   table->getColumnDefinitions()->get(0)->setInstanceColumn(true);
+   table->setAt(3, 3, _T("-17"));
+   table->setAt(4, 3, _T("007"));
+   table->setAt(5, 4, _T("\x0422\x0435\x0441\x0442"));
+   table->setStatusAt(6, 1, 3);
+   table->setObjectIdAt(7, 42);
+
+   StartTest(_T("Table: pack binary"));
+   start = GetCurrentTimeMs();
+   packedTable = table->createPackedBinary();
+   AssertNotNull(packedTable);
+   EndTest(GetCurrentTimeMs() - start);
+
+   StartTest(_T("Table: unpack binary"));
+   start = GetCurrentTimeMs();
+   table5 = Table::createFromPackedData(packedTable);
+   MemFree(packedTable);
+   AssertNotNull(table5);
+   AssertTrue(!_tcscmp(table5->getTitle(), _T("Process table")));
+   AssertEquals(table5->getNumColumns(), table->getNumColumns());
+   AssertEquals(table5->getNumRows(), table->getNumRows());
+   AssertTrue(table5->getColumnDefinition(0)->isInstanceColumn());
+   for(int i = 0; i < table->getNumRows(); i++)
+      for(int j = 0; j < table->getNumColumns(); j++)
+         AssertTrue(!_tcscmp(table5->getAsString(i, j, _T("")), table->getAsString(i, j, _T(""))));
+   AssertEquals(table5->getStatus(6, 1), 3);
+   AssertEquals(table5->getStatus(6, 2), -1);
+   AssertEquals(table5->getObjectId(7), 42);
+   delete table5;
+   EndTest(GetCurrentTimeMs() - start);
+
    StartTest(_T("Table: merge"));
    Table *table3 = new Table();
    table3->addColumn(_T("NAME"));
@@ -1771,6 +2032,7 @@ int main(int argc, char *argv[])
 #endif
 
    TestGauge64();
+   TestLatencyHistogram();
    TestMemoryPool();
    TestObjectMemoryPool();
    TestString();
@@ -1785,8 +2047,10 @@ int main(int argc, char *argv[])
    TestMsgWaitQueue();
    TestMacAddress();
    TestInetAddress();
+   TestInetAddressPrefixTree();
    TestItoa();
    TestQueue();
+   TestMPSCQueue();
    TestSharedObjectQueue();
    TestHashMap();
    TestSharedHashMap();
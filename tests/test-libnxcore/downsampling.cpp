@@ -0,0 +1,89 @@
+#include <nms_core.h>
+#include <testtools.h>
+
+/**
+ * Downsampler collecting resulting points
+ */
+class TestDownsampler : public DCIDataDownsampler
+{
+protected:
+   virtual void output(time_t timestamp, double value) override
+   {
+      DownsamplingPoint p;
+      p.timestamp = timestamp;
+      p.value = value;
+      points.add(p);
+   }
+
+public:
+   StructArray<DownsamplingPoint> points;
+
+   TestDownsampler(DownsamplingMethod method, time_t timeFrom, time_t bucketSize) : DCIDataDownsampler(method, timeFrom, bucketSize) { }
+};
+
+/**
+ * Check downsampler output against expected points
+ */
+static void CheckPoints(const StructArray<DownsamplingPoint>& points, const DownsamplingPoint *expected, int count)
+{
+   AssertEquals(points.size(), count);
+   for(int i = 0; i < count; i++)
+   {
+      AssertEquals(points.get(i)->timestamp, expected[i].timestamp);
+      AssertEquals(points.get(i)->value, expected[i].value);
+   }
+}
+
+/**
+ * Test DCI data downsampling
+ */
+void TestDownsampling()
+{
+   StartTest(_T("LTTB downsampling"));
+   static const DownsamplingPoint lttbInput[] = { { 40, 0 }, { 35, 1 }, { 32, 10 }, { 25, 3 }, { 22, -4 }, { 15, 2 }, { 11, 2 }, { 1, 5 } };
+   static const DownsamplingPoint lttbExpected[] = { { 40, 0 }, { 32, 10 }, { 22, -4 }, { 15, 2 }, { 1, 5 } };
+   TestDownsampler lttb(DCI_DOWNSAMPLING_LTTB, 0, 10);
+   for(int i = 0; i < 8; i++)
+      lttb.add(lttbInput[i].timestamp, lttbInput[i].value);
+   lttb.finish();
+   CheckPoints(lttb.points, lttbExpected, 5);
+   EndTest();
+
+   StartTest(_T("Bucket aggregation"));
+   static const DownsamplingPoint input[] = { { 25, 4 }, { 21, 2 }, { 12, 10 }, { 5, 1 }, { 3, 3 } };
+   static const double weights[] = { 1, 3, 1, 1, 1 };
+   static const DownsamplingPoint avgExpected[] = { { 21, 2.5 }, { 12, 10 }, { 3, 2 } };
+   static const DownsamplingPoint minExpected[] = { { 21, 2 }, { 12, 10 }, { 3, 1 } };
+   static const DownsamplingPoint maxExpected[] = { { 21, 4 }, { 12, 10 }, { 3, 3 } };
+   TestDownsampler avg(DCI_DOWNSAMPLING_AVG, 0, 10);
+   TestDownsampler min(DCI_DOWNSAMPLING_MIN, 0, 10);
+   TestDownsampler max(DCI_DOWNSAMPLING_MAX, 0, 10);
+   for(int i = 0; i < 5; i++)
+   {
+      avg.add(input[i].timestamp, input[i].value, weights[i]);
+      min.add(input[i].timestamp, input[i].value);
+      max.add(input[i].timestamp, input[i].value);
+   }
+   avg.finish();
+   min.finish();
+   max.finish();
+   CheckPoints(avg.points, avgExpected, 3);
+   CheckPoints(min.points, minExpected, 3);
+   CheckPoints(max.points, maxExpected, 3);
+   EndTest();
+
+   StartTest(_T("Numeric value check"));
+   AssertTrue(IsNumericDCIValue(_T("42")));
+   AssertTrue(IsNumericDCIValue(_T("-3.25")));
+   AssertFalse(IsNumericDCIValue(_T("")));
+   AssertFalse(IsNumericDCIValue(_T("-")));
+   AssertFalse(IsNumericDCIValue(_T("1.")));
+   AssertFalse(IsNumericDCIValue(_T("12abc")));
+   AssertFalse(IsNumericDCIValue(_T("text")));
+   AssertFalse(IsNumericDCIValue(_T("1.2.3")));
+   AssertFalse(IsNumericDCIValue(_T("10.0.0.1")));
+   AssertFalse(IsNumericDCIValue(_T("1..2")));
+   AssertFalse(IsNumericDCIValue(_T("-.5")));
+   AssertFalse(IsNumericDCIValue(_T(".5")));
+   EndTest();
+}
@@ -0,0 +1,51 @@
+#include <nms_core.h>
+#include <testtools.h>
+#include <netxms-version.h>
+
+NETXMS_EXECUTABLE_HEADER(test-libnxcore)
+
+void TestDownsampling();
+void TestTextTemplates();
+void TestThresholdAggregates();
+
+/**
+ * Test event rate limiter
+ */
+static void TestEventRateLimiter()
+{
+   StartTest(_T("Event rate limiter"));
+   OnEventRateLimitConfigurationChange(_T("Events.RateLimit.BurstSize"), _T("2"));
+   OnEventRateLimitConfigurationChange(_T("Events.RateLimit.PerSource"), _T("1"));
+   OnEventRateLimitConfigurationChange(_T("Events.RateLimit.PerEventCode"), _T("1"));
+
+   // Drain bucket for event code 100001
+   AssertTrue(CheckEventRateLimit(100001, 1));
+   AssertTrue(CheckEventRateLimit(100001, 1));
+   AssertFalse(CheckEventRateLimit(100001, 1));
+
+   // Event rejected by event code limit should not take token from source 2
+   AssertFalse(CheckEventRateLimit(100001, 2));
+   AssertTrue(CheckEventRateLimit(100002, 2));
+   AssertTrue(CheckEventRateLimit(100003, 2));
+   AssertFalse(CheckEventRateLimit(100004, 2));
+
+   OnEventRateLimitConfigurationChange(_T("Events.RateLimit.PerSource"), _T("0"));
+   OnEventRateLimitConfigurationChange(_T("Events.RateLimit.PerEventCode"), _T("0"));
+   AssertTrue(CheckEventRateLimit(100001, 1));
+   EndTest();
+}
+
+/**
+ * main()
+ */
+int main(int argc, char *argv[])
+{
+   InitNetXMSProcess(true);
+
+   TestThresholdAggregates();
+   TestDownsampling();
+   TestTextTemplates();
+   TestEventRateLimiter();
+
+   return 0;
+}
@@ -0,0 +1,364 @@
+#include <nms_core.h>
+#include <nms_objects.h>
+#include <nms_events.h>
+#include <testtools.h>
+#include <netxms-version.h>
+
+/**
+ * Reference implementation - on-the-fly template parser used by NetObj::expandText before
+ * introduction of compiled templates. Script macros are consumed but not executed.
+ * Named parameters without event are consumed and expanded to empty string (original
+ * parser emitted raw element text in that case).
+ */
+static StringBuffer ReferenceExpandText(const NetObj *object, const TCHAR *textTemplate, const Event *event,
+         const TCHAR *userName, const TCHAR *objectName, const TCHAR *instance, const StringMap *inputFields, const StringList *args)
+{
+   TCHAR buffer[256];
+   int i;
+
+   StringBuffer output;
+   for(const TCHAR *curr = textTemplate; *curr != 0; curr++)
+   {
+      switch(*curr)
+      {
+         case '%':   // Metacharacter
+            curr++;
+            if (*curr == 0)
+            {
+               curr--;
+               break;   // Abnormal loop termination
+            }
+            switch(*curr)
+            {
+               case '%':
+                  output.append(_T('%'));
+                  break;
+               case 'a':
+                  output.append(object->getPrimaryIpAddress().toString(buffer));
+                  break;
+               case 'A':
+               case 'K':
+                  if (event != nullptr)
+                     output.append((*curr == 'A') ? event->getLastAlarmMessage() : event->getLastAlarmKey());
+                  break;
+               case 'c':
+                  output.append((event != nullptr) ? event->getCode() : 0);
+                  break;
+               case 'E':
+                  if (event != nullptr)
+                     event->getTagsAsList(&output);
+                  break;
+               case 'g':
+                  output.append(object->getGuid());
+                  break;
+               case 'i':
+                  output.append(object->getId(), _T("0x%08X"));
+                  break;
+               case 'I':
+                  output.append(object->getId());
+                  break;
+               case 'm':
+                  if (event != nullptr)
+                     output.append(event->getMessage());
+                  break;
+               case 'M':
+                  if (event != nullptr)
+                     output.append(event->getCustomMessage());
+                  break;
+               case 'n':
+                  output.append((objectName != nullptr) ? objectName : object->getName());
+                  break;
+               case 'N':
+                  if (event != nullptr)
+                     output.append(event->getName());
+                  break;
+               case 's':
+                  if (event != nullptr)
+                     output.append(static_cast<int32_t>(event->getSeverity()));
+                  break;
+               case 'S':
+                  if (event != nullptr)
+                     output.append(GetStatusAsText(event->getSeverity(), false));
+                  break;
+               case 't':
+                  output.append(FormatTimestamp((event != nullptr) ? event->getTimestamp() : time(nullptr), buffer));
+                  break;
+               case 'T':
+                  output.append(static_cast<int64_t>((event != nullptr) ? event->getTimestamp() : time(nullptr)));
+                  break;
+               case 'u':
+                  if (object->getPrimaryIpAddress().getFamily() == AF_INET6)
+                  {
+                     output.append(_T('['));
+                     output.append(object->getPrimaryIpAddress().toString(buffer));
+                     output.append(_T(']'));
+                  }
+                  else
+                  {
+                     output.append(object->getPrimaryIpAddress().toString(buffer));
+                  }
+                  break;
+               case 'U':
+                  output.append(userName);
+                  break;
+               case 'v':
+                  output.append(NETXMS_VERSION_STRING);
+                  break;
+               case 'y':
+               case 'Y':
+                  break;   // No alarm
+               case 'z':
+                  output.append(object->getZoneUIN());
+                  break;
+               case 'Z':
+                  break;   // Zone UIN is always 0 in tests
+               case '0':
+               case '1':
+               case '2':
+               case '3':
+               case '4':
+               case '5':
+               case '6':
+               case '7':
+               case '8':
+               case '9':
+                  buffer[0] = *curr;
+                  if (isdigit(*(curr + 1)))
+                  {
+                     curr++;
+                     buffer[1] = *curr;
+                     buffer[2] = 0;
+                  }
+                  else
+                  {
+                     buffer[1] = 0;
+                  }
+                  if (event != nullptr)
+                     output.append(static_cast<TCHAR*>(event->getParameterList()->get(_tcstol(buffer, nullptr, 10) - 1)));
+                  else if (args != nullptr)
+                     output.append(args->get(_tcstol(buffer, nullptr, 10) - 1));
+                  break;
+               case '[':
+               case '{':
+               case '(':
+               case '<':
+                  {
+                     TCHAR closingBracket = (*curr == '[') ? _T(']') : ((*curr == '{') ? _T('}') : ((*curr == '(') ? _T(')') : _T('>')));
+                     TCHAR type = *curr;
+                     for(i = 0, curr++; (*curr != closingBracket) && (*curr != 0) && (i < 255); curr++)
+                     {
+                        buffer[i++] = *curr;
+                     }
+                     if (*curr == 0)
+                     {
+                        curr--;
+                        break;
+                     }
+                     buffer[i] = 0;
+                     if (type == '[')
+                        break;
+
+                     TCHAR *defaultValue = (type != '(') ? _tcschr(buffer, _T(':')) : nullptr;
+                     if (defaultValue != nullptr)
+                     {
+                        *defaultValue = 0;
+                        defaultValue++;
+                     }
+                     Trim(buffer);
+                     if (type == '{')
+                     {
+                        TCHAR *v = nullptr;
+                        if (instance != nullptr)
+                        {
+                           TCHAR tmp[128];
+                           _sntprintf(tmp, 128, _T("%s::%s"), buffer, instance);
+                           v = object->getCustomAttributeCopy(tmp);
+                        }
+                        else if (event != nullptr)
+                        {
+                           int index = event->getParameterNames()->indexOfIgnoreCase(_T("instance"));
+                           if (index != -1)
+                           {
+                              TCHAR tmp[128];
+                              _sntprintf(tmp, 128, _T("%s::%s"), buffer, event->getParameter(index));
+                              v = object->getCustomAttributeCopy(tmp);
+                           }
+                        }
+                        if (v == nullptr)
+                           v = object->getCustomAttributeCopy(buffer);
+                        if (v != nullptr)
+                           output.appendPreallocated(v);
+                        else if (defaultValue != nullptr)
+                           output.append(defaultValue);
+                     }
+                     else if (type == '(')
+                     {
+                        if (inputFields != nullptr)
+                           output.append(inputFields->get(buffer));
+                     }
+                     else if (event != nullptr)
+                     {
+                        int index = event->getParameterNames()->indexOfIgnoreCase(buffer);
+                        if (index != -1)
+                           output.append(event->getParameter(index));
+                        else if (defaultValue != nullptr)
+                           output.append(defaultValue);
+                     }
+                  }
+                  break;
+               default:    // All other characters are invalid, ignore
+                  break;
+            }
+            break;
+         case '\\':  // Escape character
+            curr++;
+            if (*curr == 0)
+            {
+               curr--;
+               break;   // Abnormal loop termination
+            }
+            switch(*curr)
+            {
+               case 't':
+                  output.append(_T('\t'));
+                  break;
+               case 'n':
+                  output.append(_T("\r\n"));
+                  break;
+               default:
+                  output.append(*curr);
+                  break;
+            }
+            break;
+         default:
+            output.append(*curr);
+            break;
+      }
+   }
+   return output;
+}
+
+/**
+ * Templates used for equivalence tests
+ */
+static const TCHAR *s_templates[] =
+{
+   _T(""),
+   _T("Plain text without macros"),
+   _T("100%% done"),
+   _T("Trailing percent %"),
+   _T("Trailing backslash \\"),
+   _T("%a|%A|%c|%E|%g|%i|%I|%K|%m|%M|%n|%N|%s|%S|%t|%T|%u|%U|%v|%y|%Y|%z|%Z"),
+   _T("%1 %2 %3 %0 %10 %99 %12x %1%2"),
+   _T("Escapes: \\t \\n \\\\ \\% \\x \\%1"),
+   _T("Unknown: %q %- %! %\\n %\\"),
+   _T("%{attr} %{ attr :default} %{missing:default value} %{missing} %{instattr}"),
+   _T("%{attr}%{unterminated"),
+   _T("%(field) %( field2 ) %(missing) %(unterminated"),
+   _T("%<param1> %< PARAM2 > %<missing:default> %<missing> %<param1:default>"),
+   _T("text %<unterminated"),
+   _T("%[script] %[script/entry] %[ script / entry ] %[unterminated"),
+   _T("Mixed %n (%a): %<param1> %1 %(field) %{attr:x} 100%%\\n"),
+   nullptr
+};
+
+/**
+ * Compare compiled and reference expansion for all test templates
+ */
+static void CheckEquivalence(const shared_ptr<NetObj>& object, const Event *event, const TCHAR *userName, const TCHAR *objectName,
+         const TCHAR *instance, const StringMap *inputFields, const StringList *args)
+{
+   for(int i = 0; s_templates[i] != nullptr; i++)
+   {
+      TextTemplate compiled(s_templates[i]);
+      StringBuffer expected = ReferenceExpandText(object.get(), s_templates[i], event, userName, objectName, instance, inputFields, args);
+      StringBuffer actual = object->expandText(compiled, nullptr, event, shared_ptr<DCObjectInfo>(), userName, objectName, instance, inputFields, args);
+      if (_tcscmp(expected, actual))
+      {
+         _tprintf(_T("\n   Template: \"%s\"\n   Expected: \"%s\"\n   Actual:   \"%s\"\n"), s_templates[i], expected.cstr(), actual.cstr());
+         AssertTrue(false);
+      }
+   }
+}
+
+/**
+ * Test text template compilation and expansion
+ */
+void TestTextTemplates()
+{
+   StartTest(_T("Text template compilation"));
+   TextTemplate nullTemplate(nullptr);
+   AssertTrue(nullTemplate.isNull());
+   AssertEquals(nullTemplate.size(), 0);
+
+   TextTemplate staticTemplate(_T("Static\\ttext 100%% \\n"));
+   AssertTrue(staticTemplate.isStatic());
+   AssertEquals(staticTemplate.size(), 1);
+   AssertTrue(!_tcscmp(staticTemplate.get(0)->text, _T("Static\ttext 100% \r\n")));
+   AssertEquals(staticTemplate.get(0)->length, _tcslen(_T("Static\ttext 100% \r\n")));
+
+   TextTemplate script(_T("A%[ script / entry ]B%[other/ ]"));
+   AssertFalse(script.isStatic());
+   AssertEquals(script.size(), 4);
+   AssertEquals(static_cast<int>(script.get(1)->type), static_cast<int>(TextTemplateTokenType::SCRIPT));
+   AssertTrue(!_tcscmp(script.get(1)->text, _T("script")));
+   AssertTrue(!_tcscmp(script.get(1)->extra, _T("entry")));
+   AssertTrue(!_tcscmp(script.get(2)->text, _T("B")));
+   AssertEquals(script.get(2)->length, static_cast<size_t>(1));
+   AssertTrue(!_tcscmp(script.get(3)->text, _T("other")));
+   AssertNull(script.get(3)->extra);
+
+   TextTemplate parameters(_T("%1%23%4x"));
+   AssertEquals(parameters.size(), 4);
+   AssertEquals(parameters.get(0)->index, 0);
+   AssertEquals(parameters.get(1)->index, 22);
+   AssertEquals(parameters.get(2)->index, 3);
+   AssertTrue(!_tcscmp(parameters.get(3)->text, _T("x")));
+   EndTest();
+
+   shared_ptr<Subnet> object = make_shared<Subnet>(_T("Test Object"), InetAddress::parse("10.1.2.0"), 0);
+   object->setCustomAttribute(_T("attr"), _T("attribute value"), StateChange::IGNORE);
+   object->setCustomAttribute(_T("instattr::eth0"), _T("instance value"), StateChange::IGNORE);
+   object->setCustomAttribute(_T("instattr"), _T("common value"), StateChange::IGNORE);
+
+   Event event;
+   event.setSeverity(SEVERITY_MAJOR);
+   event.setMessage(_T("Event message"));
+   event.setCustomMessage(_T("Custom message"));
+   event.setLastAlarmKey(_T("Alarm key"));
+   event.setLastAlarmMessage(_T("Alarm message"));
+   event.addTag(_T("tag1"));
+   event.addTag(_T("tag2"));
+   event.addParameter(_T("param1"), _T("value1"));
+   event.addParameter(_T("param2"), _T("value2"));
+   event.addParameter(_T("param3"), _T("value3"));
+
+   Event instanceEvent(&event);
+   instanceEvent.addParameter(_T("instance"), _T("eth0"));
+
+   StringMap inputFields;
+   inputFields.set(_T("field"), _T("field value"));
+   inputFields.set(_T("field2"), _T("field2 value"));
+
+   StringList args;
+   args.add(_T("arg1"));
+   args.add(_T("arg2"));
+
+   StartTest(_T("Text template expansion with event"));
+   CheckEquivalence(object, &event, _T("user"), nullptr, nullptr, &inputFields, nullptr);
+   CheckEquivalence(object, &event, nullptr, _T("Object name"), _T("eth0"), nullptr, &args);
+   CheckEquivalence(object, &instanceEvent, nullptr, nullptr, nullptr, nullptr, nullptr);
+   EndTest();
+
+   StartTest(_T("Text template expansion without event"));
+   CheckEquivalence(object, nullptr, _T("user"), nullptr, _T("eth0"), &inputFields, &args);
+   CheckEquivalence(object, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+   AssertTrue(!_tcscmp(object->expandText(_T("[%<param1:default>]"), nullptr, nullptr, shared_ptr<DCObjectInfo>(), nullptr, nullptr, nullptr, nullptr, nullptr), _T("[]")));
+   EndTest();
+
+   StartTest(_T("Text template expansion for IPv6 address"));
+   shared_ptr<Subnet> object6 = make_shared<Subnet>(_T("IPv6 Object"), InetAddress::parse("fd00::"), 0);
+   CheckEquivalence(object6, &event, nullptr, nullptr, nullptr, nullptr, nullptr);
+   AssertTrue(!_tcscmp(object6->expandText(_T("%u"), nullptr, nullptr, shared_ptr<DCObjectInfo>(), nullptr, nullptr, nullptr, nullptr, nullptr), _T("[fd00::]")));
+   EndTest();
+}
@@ -0,0 +1,162 @@
+#include <nms_core.h>
+#include <testtools.h>
+
+/**
+ * Data types covered by running aggregates
+ */
+static const int s_dataTypes[] = { DCI_DT_INT, DCI_DT_UINT, DCI_DT_COUNTER32, DCI_DT_INT64, DCI_DT_UINT64, DCI_DT_COUNTER64, DCI_DT_FLOAT };
+
+/**
+ * Threshold functions to test
+ */
+static const int s_functions[] = { F_AVERAGE, F_SUM, F_DEVIATION, F_DIFF, F_LAST };
+
+/**
+ * Sample counts to test
+ */
+static const int s_sampleCounts[] = { 1, 2, 3, 5, 10, 32 };
+
+/**
+ * Create threshold with given function, sample count and data type
+ */
+static Threshold *CreateThreshold(int function, int sampleCount, int dataType)
+{
+   NXCPMessage msg;
+   msg.setField(VID_DCI_THRESHOLD_BASE + 1, static_cast<uint32_t>(EVENT_THRESHOLD_REACHED));
+   msg.setField(VID_DCI_THRESHOLD_BASE + 2, static_cast<uint32_t>(EVENT_THRESHOLD_REARMED));
+   msg.setField(VID_DCI_THRESHOLD_BASE + 3, static_cast<uint16_t>(function));
+   msg.setField(VID_DCI_THRESHOLD_BASE + 4, static_cast<uint16_t>(OP_GT));
+   msg.setField(VID_DCI_THRESHOLD_BASE + 5, static_cast<uint32_t>(sampleCount));
+   msg.setField(VID_DCI_THRESHOLD_BASE + 7, static_cast<uint32_t>(0));
+   msg.setField(VID_DCI_THRESHOLD_BASE + 8, _T("0"));
+
+   Threshold *t = new Threshold();
+   t->updateFromMessage(msg, VID_DCI_THRESHOLD_BASE);
+   t->setDataType(static_cast<BYTE>(dataType));
+   return t;
+}
+
+/**
+ * Create random value of given type. Integer values cover whole range of the type, so
+ * sums overflow and wrap around.
+ */
+static ItemValue *CreateRandomValue(int dataType, time_t timestamp)
+{
+   TCHAR text[64];
+   uint64_t r = (static_cast<uint64_t>(rand()) << 48) ^ (static_cast<uint64_t>(rand()) << 32) ^ (static_cast<uint64_t>(rand()) << 16) ^ static_cast<uint64_t>(rand());
+   bool small = (rand() % 4) != 0;
+   switch(dataType)
+   {
+      case DCI_DT_INT:
+         _sntprintf(text, 64, _T("%d"), small ? static_cast<int32_t>(r % 2001) - 1000 : static_cast<int32_t>(r));
+         break;
+      case DCI_DT_UINT:
+      case DCI_DT_COUNTER32:
+         _sntprintf(text, 64, _T("%u"), small ? static_cast<uint32_t>(r % 1000) : static_cast<uint32_t>(r));
+         break;
+      case DCI_DT_INT64:
+         _sntprintf(text, 64, INT64_FMT, small ? static_cast<int64_t>(r % 2001) - 1000 : static_cast<int64_t>(r));
+         break;
+      case DCI_DT_UINT64:
+      case DCI_DT_COUNTER64:
+         _sntprintf(text, 64, UINT64_FMT, small ? r % 1000 : r);
+         break;
+      default:
+         _sntprintf(text, 64, _T("%f"), static_cast<double>(static_cast<int64_t>(r % 2000001) - 1000000) / 1000.0);
+         break;
+   }
+   return new ItemValue(text, timestamp);
+}
+
+/**
+ * Fill value cache with random values. Placeholder values (timestamp 1) are inserted
+ * at the end of cache if requested, same way as cache loader does.
+ */
+static void FillCache(ItemValue **cache, uint32_t cacheSize, int dataType, uint32_t placeholders, time_t timestamp)
+{
+   for(uint32_t i = 0; i < cacheSize; i++)
+   {
+      delete cache[i];
+      cache[i] = CreateRandomValue(dataType, (i >= cacheSize - placeholders) ? 1 : timestamp - i);
+   }
+}
+
+/**
+ * Check thresholds for given data type using running aggregates and using full recalculation
+ * and compare results. Cache is updated the same way as DCItem::processNewValue does it.
+ */
+static void CompareThresholdAggregates(int dataType)
+{
+   ObjectArray<Threshold> thresholds(0, 16, Ownership::True);
+   ObjectArray<Threshold> reference(0, 16, Ownership::True);
+   uint32_t cacheSize = 0;
+   for(size_t i = 0; i < sizeof(s_functions) / sizeof(int); i++)
+   {
+      for(size_t j = 0; j < sizeof(s_sampleCounts) / sizeof(int); j++)
+      {
+         thresholds.add(CreateThreshold(s_functions[i], s_sampleCounts[j], dataType));
+         reference.add(CreateThreshold(s_functions[i], s_sampleCounts[j], dataType));
+         cacheSize = std::max(cacheSize, thresholds.get(thresholds.size() - 1)->getRequiredCacheSize());
+      }
+   }
+
+   ItemValue **cache = MemAllocArray<ItemValue*>(cacheSize);
+   time_t timestamp = 1000000;
+   FillCache(cache, cacheSize, dataType, cacheSize / 2, timestamp);
+
+   ThresholdAggregates aggregates;
+   for(int i = 0; i < 2000; i++)
+   {
+      timestamp++;
+
+      // Simulate cache reload with placeholders
+      if ((i % 250) == 249)
+      {
+         FillCache(cache, cacheSize, dataType, rand() % cacheSize, timestamp);
+         aggregates.invalidate();
+      }
+
+      ItemValue *value = CreateRandomValue(dataType, timestamp);
+
+      if (!aggregates.isValid(dataType, cacheSize))
+         aggregates.rebuild(&thresholds, cache, cacheSize, dataType);
+      aggregates.startCheck();
+
+      for(int j = 0; j < thresholds.size(); j++)
+      {
+         ItemValue fvalue, tvalue, refFValue, refTValue;
+         ThresholdCheckResult result = thresholds.get(j)->check(*value, cache, fvalue, tvalue, shared_ptr<NetObj>(), nullptr, &aggregates);
+         ThresholdCheckResult refResult = reference.get(j)->check(*value, cache, refFValue, refTValue, shared_ptr<NetObj>(), nullptr, nullptr);
+         AssertTrue(result == refResult);
+         AssertTrue(!_tcscmp(fvalue.getString(), refFValue.getString()));
+         AssertEquals(fvalue.getInt64(), refFValue.getInt64());
+         AssertEquals(fvalue.getUInt64(), refFValue.getUInt64());
+         AssertTrue(fvalue.getDouble() == refFValue.getDouble());
+      }
+
+      aggregates.shift(cache, cacheSize, value);
+      delete cache[cacheSize - 1];
+      memmove(&cache[1], cache, sizeof(ItemValue*) * (cacheSize - 1));
+      cache[0] = value;
+   }
+
+   for(uint32_t i = 0; i < cacheSize; i++)
+      delete cache[i];
+   MemFree(cache);
+}
+
+/**
+ * Test that running threshold aggregates give same results as full recalculation
+ */
+void TestThresholdAggregates()
+{
+   srand(1);
+   for(size_t i = 0; i < sizeof(s_dataTypes) / sizeof(int); i++)
+   {
+      TCHAR name[128];
+      _sntprintf(name, 128, _T("Threshold aggregates (data type %d)"), s_dataTypes[i]);
+      StartTest(name);
+      CompareThresholdAggregates(s_dataTypes[i]);
+      EndTest();
+   }
+}
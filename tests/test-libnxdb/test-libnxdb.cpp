@@ -23,6 +23,54 @@ NETXMS_EXECUTABLE_HEADER(test-libnxdb)
 
 void TestOracleBatch(const TCHAR *server, const TCHAR *login, const TCHAR *password);
 
+/**
+ * Connection pool test worker
+ */
+static THREAD_RESULT THREAD_CALL ConnectionPoolWorker(void *arg)
+{
+   for(int i = 0; i < 200; i++)
+   {
+      DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+      if (DBBegin(hdb))
+         DBCommit(hdb);
+      else
+         InterlockedIncrement(static_cast<VolatileCounter*>(arg));
+      DBConnectionPoolReleaseConnection(hdb);
+   }
+   return THREAD_OK;
+}
+
+/**
+ * UTF-8 query tests (expects test table filled with rows 1..1000)
+ */
+static void UTF8QueryTests(DB_HANDLE session, int id, int expectedCount)
+{
+   TCHAR buffer[DBDRV_MAX_ERROR_TEXT];
+   char query[256];
+   snprintf(query, 256, "INSERT INTO nx_test (id,value1,value2_new) VALUES (%d,'\xD0\xA2\xD0\xB5\xD1\x81\xD1\x82',%d)", id, id);
+   AssertTrueEx(DBQueryUTF8Ex(session, query, buffer), buffer);
+
+   snprintf(query, 256, "SELECT value1,value2_new FROM nx_test WHERE id=%d", id);
+   DB_RESULT hResult = DBSelectUTF8Ex(session, query, buffer);
+   AssertNotNullEx(hResult, buffer);
+   AssertEquals(DBGetNumRows(hResult), 1);
+   char utf8buffer[64];
+   AssertTrue(!strcmp(DBGetFieldUTF8(hResult, 0, 0, utf8buffer, 64), "\xD0\xA2\xD0\xB5\xD1\x81\xD1\x82"));
+   AssertEquals(DBGetFieldULong(hResult, 0, 1), static_cast<uint32_t>(id));
+   DBFreeResult(hResult);
+
+   DB_UNBUFFERED_RESULT hResult2 = DBSelectUnbufferedUTF8Ex(session, "SELECT id FROM nx_test WHERE value2_new>990", buffer);
+   AssertNotNullEx(hResult2, buffer);
+   int count = 0;
+   while(DBFetch(hResult2))
+   {
+      count++;
+      AssertTrue(DBGetFieldInt64(hResult2, 0) > 990);
+   }
+   DBFreeResult(hResult2);
+   AssertEquals(count, expectedCount);
+}
+
 /**
  * Common tests
  */
@@ -124,6 +172,75 @@ static void CommonTests(const TCHAR *prefix, const TCHAR *driver, const TCHAR *s
    AssertEquals(count, 200);
    EndTest();
 
+   /*** UTF-8 queries ***/
+   StartTest(prefix, _T("UTF-8 queries"));
+   UTF8QueryTests(session, 2000, 11);
+   EndTest();
+
+   /*** UTF-8 queries via wide character entry points ***/
+   StartTest(prefix, _T("UTF-8 queries (fallback)"));
+   DBEnableUTF8Queries(drv, false);
+   UTF8QueryTests(session, 2001, 12);
+   DBEnableUTF8Queries(drv, true);
+   EndTest();
+
+   /*** cache table (source table is larger than single insert chunk) ***/
+   StartTest(prefix, _T("cache table"));
+   AssertTrue(DBBegin(session));
+   hStmt = DBPrepareEx(session, _T("INSERT INTO nx_test (id,value1,value2_new) VALUES (?,?,?)"), true, buffer);
+   AssertNotNullEx(hStmt, buffer);
+   for(int i = 3000; i < 4500; i++)
+   {
+      DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, i);
+      DBBind(hStmt, 2, DB_SQLTYPE_VARCHAR, _T("cached"), DB_BIND_STATIC);
+      DBBind(hStmt, 3, DB_SQLTYPE_INTEGER, i);
+      AssertTrueEx(DBExecuteEx(hStmt, buffer), buffer);
+   }
+   DBFreeStatement(hStmt);
+   AssertTrue(DBCommit(session));
+   DB_HANDLE cacheDB = DBOpenInMemoryDatabase();
+   AssertNotNull(cacheDB);
+   Mutex cacheLock;
+   AssertTrue(DBCacheTable(cacheDB, &cacheLock, session, _T("nx_test"), _T("id"), _T("id,value1,value2_new")));
+   hResult = DBSelect(cacheDB, _T("SELECT count(*),sum(value2_new) FROM nx_test"));
+   AssertNotNull(hResult);
+   AssertTrue(DBGetFieldLong(hResult, 0, 0) > 2500);
+   hResult2 = DBSelectUnbufferedEx(session, _T("SELECT count(*),sum(value2_new) FROM nx_test"), buffer);
+   AssertNotNullEx(hResult2, buffer);
+   AssertTrue(DBFetch(hResult2));
+   AssertEquals(DBGetFieldLong(hResult, 0, 0), DBGetFieldLong(hResult2, 0));
+   AssertEquals(DBGetFieldInt64(hResult, 0, 1), DBGetFieldInt64(hResult2, 1));
+   DBFreeResult(hResult2);
+   DBFreeResult(hResult);
+   DBCloseInMemoryDatabase(cacheDB);
+   EndTest();
+
+   /*** connection pool ***/
+   StartTest(prefix, _T("connection pool"));
+   AssertTrue(DBConnectionPoolStartup(drv, server, dbName, login, password, NULL, 2, 4, 300, 0, true));
+   AssertEquals(DBConnectionPoolGetSize(), 2);
+   DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+   AssertNotNull(hdb);
+   ObjectArray<PoolConnectionInfo> *connections = DBConnectionPoolGetConnectionList();
+   AssertEquals(connections->size(), 1);
+   AssertTrue(connections->get(0)->handle == hdb);
+   AssertEquals(connections->get(0)->acquireHistogram[0], 1);
+   delete connections;
+   DBConnectionPoolReleaseConnection(hdb);
+   AssertTrue(DBConnectionPoolAcquireConnection() == hdb);  // thread affinity
+   DBConnectionPoolReleaseConnection(hdb);
+   VolatileCounter errors = 0;
+   THREAD workers[16];
+   for(int i = 0; i < 16; i++)
+      workers[i] = ThreadCreateEx(ConnectionPoolWorker, 0, (void *)&errors);
+   for(int i = 0; i < 16; i++)
+      ThreadJoin(workers[i]);
+   AssertEquals(errors, 0);
+   AssertEquals(DBConnectionPoolGetAcquiredCount(), 0);
+   AssertTrue(DBConnectionPoolGetSize() <= 4);
+   DBConnectionPoolShutdown();
+   EndTest();
+
    /*** drop test table ***/
    StartTest(prefix, _T("drop test table"));
    AssertTrue(DBQuery(session, _T("DROP TABLE nx_test")));
@@ -0,0 +1,365 @@
+#include <nms_common.h>
+#include <nms_util.h>
+#include <nxsl.h>
+#include <netxms-version.h>
+#include <netxms_getopt.h>
+
+/**
+ * Allocation counting is only possible when we can interpose malloc family of functions
+ */
+#if defined(__GLIBC__) && !defined(WITH_ADDRESS_SANITIZER) && !defined(WITH_JEMALLOC)
+#define COUNT_ALLOCATIONS 1
+#endif
+
+#if COUNT_ALLOCATIONS
+
+static VolatileCounter64 s_allocations = 0;
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t n, size_t size);
+extern "C" void *__libc_realloc(void *p, size_t size);
+
+extern "C" __attribute__ ((visibility("default"))) void *malloc(size_t size)
+{
+   InterlockedIncrement64(&s_allocations);
+   return __libc_malloc(size);
+}
+
+extern "C" __attribute__ ((visibility("default"))) void *calloc(size_t n, size_t size)
+{
+   InterlockedIncrement64(&s_allocations);
+   return __libc_calloc(n, size);
+}
+
+extern "C" __attribute__ ((visibility("default"))) void *realloc(void *p, size_t size)
+{
+   InterlockedIncrement64(&s_allocations);
+   return __libc_realloc(p, size);
+}
+
+#endif
+
+/**
+ * Benchmark workload. Script gets number of iterations as first argument.
+ */
+struct Workload
+{
+   const TCHAR *name;
+   const TCHAR *source;
+};
+
+/**
+ * Workloads
+ */
+static Workload s_workloads[] =
+{
+   { _T("loop"),
+     _T("c = 0;\n")
+     _T("for(i = 0; i < $1; i++)\n")
+     _T("   c += i % 7;\n")
+     _T("return c;\n") },
+   { _T("strings"),
+     _T("l = 0;\n")
+     _T("for(i = 0; i < $1; i++)\n")
+     _T("{\n")
+     _T("   s = \"Interface \" .. i .. \" status\";\n")
+     _T("   t = upper(s);\n")
+     _T("   l += length(t) + index(t, \"STATUS\");\n")
+     _T("   s = substr(trim(t), 11, 5);\n")
+     _T("}\n")
+     _T("return l;\n") },
+   { _T("arrays"),
+     _T("a = %();\n")
+     _T("for(i = 0; i < $1; i++)\n")
+     _T("   a[i % 1000] = i;\n")
+     _T("c = 0;\n")
+     _T("for(v : a)\n")
+     _T("   c += v;\n")
+     _T("return c;\n") },
+   { _T("hashmaps"),
+     _T("h = %{};\n")
+     _T("c = 0;\n")
+     _T("for(i = 0; i < $1; i++)\n")
+     _T("{\n")
+     _T("   h[\"key\" .. (i % 100)] = i;\n")
+     _T("   v = h[\"key\" .. (i % 50)];\n")
+     _T("   if (v != null)\n")
+     _T("      c++;\n")
+     _T("}\n")
+     _T("return c;\n") },
+   { _T("regexp"),
+     _T("c = 0;\n")
+     _T("for(i = 0; i < $1; i++)\n")
+     _T("{\n")
+     _T("   if ((\"Error: \" .. i .. \" (test error)\") ~= \"^Error: ([0-9]+) (.*)\")\n")
+     _T("      c += length($2);\n")
+     _T("}\n")
+     _T("return c;\n") },
+   { _T("attributes"),
+     _T("t = new TIME();\n")
+     _T("c = 0;\n")
+     _T("for(i = 0; i < $1; i++)\n")
+     _T("   c += t->year + t->mon + t->mday;\n")
+     _T("return c;\n") },
+   { _T("functions"),
+     _T("c = 0;\n")
+     _T("for(i = 0; i < $1; i++)\n")
+     _T("   c = add(c, i % 3);\n")
+     _T("return c;\n")
+     _T("sub add(a, b)\n")
+     _T("{\n")
+     _T("   return a + b;\n")
+     _T("}\n") },
+   { nullptr, nullptr }
+};
+
+/**
+ * Print profile collected for workload
+ */
+static void PrintProfile(NXSL_VM *vm)
+{
+   StructArray<NXSL_ProfileEntry> *profile = vm->getProfile(false);
+   uint64_t total = 0;
+   for(int i = 0; i < profile->size(); i++)
+      total += profile->get(i)->getEstimatedTime();
+   for(int i = 0; i < profile->size(); i++)
+   {
+      NXSL_ProfileEntry *e = profile->get(i);
+      uint64_t t = e->getEstimatedTime();
+      _tprintf(_T("      line %4d  %12") UINT64_FMT_ARGS(_T("")) _T(" executions  %5.1f%%\n"), e->line, e->executions,
+               (total > 0) ? static_cast<double>(t) * 100.0 / static_cast<double>(total) : 0.0);
+   }
+   delete profile;
+}
+
+/**
+ * Run single workload
+ */
+static bool RunWorkload(const Workload *w, int iterations, bool profile)
+{
+   TCHAR errorMessage[256];
+   NXSL_Program *program = NXSLCompile(w->source, errorMessage, 256, nullptr);
+   if (program == nullptr)
+   {
+      _tprintf(_T("%-12s compilation error: %s\n"), w->name, errorMessage);
+      return false;
+   }
+
+   NXSL_Environment *env = new NXSL_Environment();
+   NXSL_VM *vm = new NXSL_VM(env);
+   if (!vm->load(program))
+   {
+      _tprintf(_T("%-12s cannot load program\n"), w->name);
+      delete vm;
+      delete program;
+      return false;
+   }
+   delete program;
+
+   if (profile)
+      vm->enableProfiling();
+
+   NXSL_Value *argv[1];
+   argv[0] = vm->createValue(static_cast<int32_t>(iterations));
+
+#if COUNT_ALLOCATIONS
+   int64_t allocations = s_allocations;
+#endif
+   uint64_t startTime = GetMonotonicClockTimeNs();
+   bool success = vm->run(1, argv);
+   uint64_t elapsed = GetMonotonicClockTimeNs() - startTime;
+#if COUNT_ALLOCATIONS
+   allocations = s_allocations - allocations;
+#endif
+
+   if (success)
+   {
+#if COUNT_ALLOCATIONS
+      _tprintf(_T("%-12s %10.1f ns/op  %8.2f allocs/op  (%d iterations, %") UINT64_FMT_ARGS(_T("")) _T(" ms)\n"), w->name,
+               static_cast<double>(elapsed) / iterations, static_cast<double>(allocations) / iterations, iterations, elapsed / _ULL(1000000));
+#else
+      _tprintf(_T("%-12s %10.1f ns/op  (%d iterations, %") UINT64_FMT_ARGS(_T("")) _T(" ms)\n"), w->name,
+               static_cast<double>(elapsed) / iterations, iterations, elapsed / _ULL(1000000));
+#endif
+      if (profile)
+         PrintProfile(vm);
+   }
+   else
+   {
+      _tprintf(_T("%-12s execution error: %s\n"), w->name, vm->getErrorText());
+   }
+
+   delete vm;
+   return success;
+}
+
+/**
+ * Get resident set size of current process in kilobytes (0 if not available)
+ */
+static uint64_t GetResidentSetSize()
+{
+#ifdef __linux__
+   FILE *f = fopen("/proc/self/statm", "r");
+   if (f == nullptr)
+      return 0;
+   unsigned long size = 0, resident = 0;
+   if (fscanf(f, "%lu %lu", &size, &resident) != 2)
+      resident = 0;
+   fclose(f);
+   return static_cast<uint64_t>(resident) * sysconf(_SC_PAGESIZE) / 1024;
+#else
+   return 0;
+#endif
+}
+
+/**
+ * Event processing policy filter script
+ */
+static const TCHAR *s_filterScript =
+   _T("if ($1 < 2)\n")
+   _T("   return false;\n")
+   _T("tags = SplitString($2, \",\");\n")
+   _T("for(t : tags)\n")
+   _T("   if (t == \"critical\")\n")
+   _T("      return true;\n")
+   _T("return $3 like \"*failure*\";\n");
+
+/**
+ * Run EPP filter benchmark - new VM is created for each run, like for event processing policy filters
+ */
+static bool RunFilterBenchmark(int iterations)
+{
+   TCHAR errorMessage[256];
+   NXSL_Program *program = NXSLCompile(s_filterScript, errorMessage, 256, nullptr);
+   if (program == nullptr)
+   {
+      _tprintf(_T("%-12s compilation error: %s\n"), _T("epp-filter"), errorMessage);
+      return false;
+   }
+
+   uint64_t rssBefore = GetResidentSetSize();
+#if COUNT_ALLOCATIONS
+   int64_t allocations = s_allocations;
+#endif
+   uint64_t startTime = GetMonotonicClockTimeNs();
+   bool success = true;
+   for(int i = 0; (i < iterations) && success; i++)
+   {
+      NXSL_VM *vm = new NXSL_VM(new NXSL_Environment());
+      if (vm->load(program))
+      {
+         NXSL_Value *argv[3];
+         argv[0] = vm->createValue(static_cast<int32_t>(i % 5));
+         argv[1] = vm->createValue(_T("network,interface,link"));
+         argv[2] = vm->createValue(_T("Interface eth0 link failure"));
+         if (!vm->run(3, argv))
+         {
+            _tprintf(_T("%-12s execution error: %s\n"), _T("epp-filter"), vm->getErrorText());
+            success = false;
+         }
+      }
+      else
+      {
+         _tprintf(_T("%-12s cannot load program\n"), _T("epp-filter"));
+         success = false;
+      }
+      delete vm;
+   }
+   uint64_t elapsed = GetMonotonicClockTimeNs() - startTime;
+#if COUNT_ALLOCATIONS
+   allocations = s_allocations - allocations;
+#endif
+   uint64_t rssAfter = GetResidentSetSize();
+   delete program;
+
+   if (success)
+   {
+#if COUNT_ALLOCATIONS
+      _tprintf(_T("%-12s %10.1f ns/run %8.2f allocs/run (%d runs, RSS ") UINT64_FMT_ARGS(_T("")) _T(" KB -> ") UINT64_FMT_ARGS(_T("")) _T(" KB)\n"),
+               _T("epp-filter"), static_cast<double>(elapsed) / iterations, static_cast<double>(allocations) / iterations, iterations, rssBefore, rssAfter);
+#else
+      _tprintf(_T("%-12s %10.1f ns/run (%d runs, RSS ") UINT64_FMT_ARGS(_T("")) _T(" KB -> ") UINT64_FMT_ARGS(_T("")) _T(" KB)\n"),
+               _T("epp-filter"), static_cast<double>(elapsed) / iterations, iterations, rssBefore, rssAfter);
+#endif
+   }
+   return success;
+}
+
+/**
+ * Show usage
+ */
+static void ShowUsage()
+{
+   _tprintf(_T("Usage: bench-libnxsl [-n iterations] [-p] [workload ...]\n\nAvailable workloads:\n"));
+   for(int i = 0; s_workloads[i].name != nullptr; i++)
+      _tprintf(_T("   %s\n"), s_workloads[i].name);
+   _tprintf(_T("   epp-filter\n"));
+}
+
+/**
+ * Check if workload with given name is selected on command line
+ */
+static bool IsWorkloadSelected(const TCHAR *workload, int argc, char *argv[])
+{
+   if (optind >= argc)
+      return true;
+
+   for(int i = optind; i < argc; i++)
+   {
+#ifdef UNICODE
+      WCHAR name[64];
+      mb_to_wchar(argv[i], -1, name, 64);
+      name[63] = 0;
+#else
+      const char *name = argv[i];
+#endif
+      if (!_tcsicmp(name, workload))
+         return true;
+   }
+   return false;
+}
+
+/**
+ * main()
+ */
+int main(int argc, char *argv[])
+{
+   InitNetXMSProcess(true);
+
+   int iterations = 1000000;
+   bool profile = false;
+   int ch;
+   while((ch = getopt(argc, argv, "hn:p")) != -1)
+   {
+      switch(ch)
+      {
+         case 'n':
+            iterations = strtol(optarg, nullptr, 0);
+            if (iterations <= 0)
+            {
+               _tprintf(_T("Invalid number of iterations\n"));
+               return 1;
+            }
+            break;
+         case 'p':
+            profile = true;
+            break;
+         default:
+            ShowUsage();
+            return (ch == 'h') ? 0 : 1;
+      }
+   }
+
+   _tprintf(_T("NXSL interpreter benchmark (NetXMS version ") NETXMS_VERSION_STRING _T(")\n\n"));
+
+   bool success = true;
+   for(int i = 0; s_workloads[i].name != nullptr; i++)
+   {
+      if (IsWorkloadSelected(s_workloads[i].name, argc, argv) && !RunWorkload(&s_workloads[i], iterations, profile))
+         success = false;
+   }
+   if (IsWorkloadSelected(_T("epp-filter"), argc, argv) && !RunFilterBenchmark(std::max(iterations / 10, 1)))
+      success = false;
+
+   return success ? 0 : 1;
+}
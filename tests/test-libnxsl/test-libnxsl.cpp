@@ -70,6 +70,69 @@ static void TestStop()
    EndTest();
 }
 
+/**
+ * Test NXSL profiler
+ */
+static void TestProfiler()
+{
+   StartTest(_T("NXSL_VM profiler"));
+
+   TCHAR errorMessage[256];
+   NXSL_VM *vm = NXSLCompileAndCreateVM(_T("c = 0;\nfor(i = 0; i < 1000; i++)\n   c += i;\nreturn c;\n"), errorMessage, 256, new NXSL_Environment());
+   AssertNotNull(vm);
+   AssertFalse(vm->isProfilingEnabled());
+   AssertNull(vm->getProfile());
+
+   vm->enableProfiling(10);
+   AssertTrue(vm->isProfilingEnabled());
+   AssertTrue(vm->run());
+   AssertEquals(vm->getResult()->getValueAsInt32(), 499500);
+   AssertEquals(vm->getProfiler()->getRunCount(), 1);
+
+   uint64_t total = vm->getProfiler()->getTotalExecutions();
+   AssertTrue(total > 1000);
+
+   StructArray<NXSL_ProfileEntry> *profile = vm->getProfile(false);
+   AssertNotNull(profile);
+   uint64_t executions = 0;
+   bool line3found = false;
+   for(int i = 0; i < profile->size(); i++)
+   {
+      NXSL_ProfileEntry *e = profile->get(i);
+      AssertTrue((e->line >= 1) && (e->line <= 4));
+      AssertEquals(e->addr, INVALID_ADDRESS);
+      if (i > 0)
+         AssertTrue(profile->get(i - 1)->getEstimatedTime() >= e->getEstimatedTime());
+      if (e->line == 3)
+      {
+         AssertTrue(e->executions >= 1000);
+         line3found = true;
+      }
+      executions += e->executions;
+   }
+   AssertTrue(line3found);
+   AssertEquals(executions, total);
+   delete profile;
+
+   profile = vm->getProfile(true);
+   AssertNotNull(profile);
+   executions = 0;
+   for(int i = 0; i < profile->size(); i++)
+   {
+      AssertNotNull(profile->get(i)->mnemonic);
+      executions += profile->get(i)->executions;
+   }
+   AssertEquals(executions, total);
+   delete profile;
+
+   vm->disableProfiling();
+   AssertFalse(vm->isProfilingEnabled());
+   AssertTrue(vm->run());
+   delete vm;
+
+   EndTest();
+}
+
 /**
  * Run test NXSL script
  */
@@ -138,6 +201,7 @@ int main(int argc, char *argv[])
 
    TestCompiler();
    TestStop();
+   TestProfiler();
    RunTestScript(_T("addr.nxsl"));
    RunTestScript(_T("arrays.nxsl"));
    RunTestScript(_T("base64.nxsl"));
@@ -143,6 +143,82 @@ static void TestVariableClass()
    EndTest();
 }
 
+/**
+ * Scheduler test context
+ */
+struct SchedulerTestContext
+{
+   SNMP_RequestScheduler *scheduler;
+   SNMP_RequestPriority priority;
+   VolatileCounter *order;
+   int position;
+};
+
+/**
+ * Scheduler test worker
+ */
+static void SchedulerTestWorker(SchedulerTestContext *context)
+{
+   if (context->scheduler->acquire(context->priority, 5000))
+   {
+      context->position = InterlockedIncrement(context->order);
+      context->scheduler->release(SNMP_ERR_SUCCESS, 0);
+   }
+}
+
+/**
+ * Test SNMP request scheduler
+ */
+static void TestRequestScheduler()
+{
+   StartTest(_T("SNMP_RequestScheduler - concurrency limit"));
+   SNMP_RequestScheduler scheduler(1, 0);
+   AssertTrue(scheduler.acquire(SNMP_REQUEST_PRIORITY_NORMAL, 0));
+   AssertFalse(scheduler.acquire(SNMP_REQUEST_PRIORITY_HIGH, 50));
+   scheduler.release(SNMP_ERR_SUCCESS, 10);
+   AssertTrue(scheduler.acquire(SNMP_REQUEST_PRIORITY_HIGH, 0));
+   scheduler.release(SNMP_ERR_TIMEOUT, 30);
+   SNMP_RequestSchedulerStatistics stats;
+   scheduler.getStatistics(&stats);
+   AssertEquals(stats.requests, _ULL(2));
+   AssertEquals(stats.timeouts, _ULL(1));
+   AssertEquals(stats.queueTimeouts, _ULL(1));
+   AssertEquals(stats.inFlight, 0);
+   AssertEquals(stats.queueSize, 0);
+   AssertEquals(stats.lastResponseTime, 30);
+   EndTest();
+
+   StartTest(_T("SNMP_RequestScheduler - priority"));
+   VolatileCounter order = 0;
+   SchedulerTestContext normal = { &scheduler, SNMP_REQUEST_PRIORITY_NORMAL, &order, 0 };
+   SchedulerTestContext high = { &scheduler, SNMP_REQUEST_PRIORITY_HIGH, &order, 0 };
+   AssertTrue(scheduler.acquire(SNMP_REQUEST_PRIORITY_NORMAL, 0));
+   THREAD t1 = ThreadCreateEx(SchedulerTestWorker, &normal);
+   ThreadSleepMs(100);
+   THREAD t2 = ThreadCreateEx(SchedulerTestWorker, &high);
+   ThreadSleepMs(100);
+   scheduler.getStatistics(&stats);
+   AssertEquals(stats.queueSize, 2);
+   scheduler.release(SNMP_ERR_SUCCESS, 0);
+   ThreadJoin(t1);
+   ThreadJoin(t2);
+   AssertEquals(high.position, 1);
+   AssertEquals(normal.position, 2);
+   EndTest();
+
+   StartTest(_T("SNMP_RequestScheduler - rate limit"));
+   scheduler.setLimits(0, 20);
+   int64_t startTime = GetCurrentTimeMs();
+   for(int i = 0; i < 30; i++)
+   {
+      AssertTrue(scheduler.acquire(SNMP_REQUEST_PRIORITY_NORMAL, 2000));
+      scheduler.release(SNMP_ERR_SUCCESS, 0);
+   }
+   int64_t elapsed = GetCurrentTimeMs() - startTime;
+   AssertTrue(elapsed >= 400);
+   EndTest();
+}
+
 /**
  * main()
  */
@@ -153,5 +229,6 @@ int main(int argc, char *argv[])
    TestOidConversion();
    TestOidClass();
    TestVariableClass();
+   TestRequestScheduler();
    return 0;
 }